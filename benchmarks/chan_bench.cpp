@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+#include <gocxx/base/chan.h>
+#include <gocxx/base/select.h>
+#include <gocxx/sync/pool.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace gocxx::base;
+
+// A value bounced between two threads over a pair of channels: the cost of
+// one hand-off each way, by buffer size (0 = unbuffered)
+static void BM_ChanPingPong(benchmark::State& state) {
+    const auto buffer = static_cast<std::size_t>(state.range(0));
+    Chan<int> ping(buffer), pong(buffer);
+    std::thread echo([&] {
+        while (auto v = ping.recv()) pong.send(*v);
+        pong.close();
+    });
+    for (auto _ : state) {
+        ping.send(1);
+        benchmark::DoNotOptimize(pong.recv());
+    }
+    ping.close();
+    echo.join();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_ChanPingPong)->ArgName("buffer")->Arg(0)->Arg(1)->Arg(64)->UseRealTime();
+
+// `producers` threads each sending 10000 values, drained by as many
+// receivers, on each backend; one iteration moves every value
+static void BM_ChanThroughput(benchmark::State& state) {
+    constexpr int kPerProducer = 10000;
+    const auto buffer = static_cast<std::size_t>(state.range(0));
+    const int producers = static_cast<int>(state.range(1));
+    const auto backend = static_cast<ChanBackend>(state.range(2));
+    if (backend == ChanBackend::SPSC && producers > 1) {
+        state.SkipWithError("SPSC takes one producer and one consumer");
+        return;
+    }
+    for (auto _ : state) {
+        Chan<int> ch(buffer, backend);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < kPerProducer; ++i) ch.send(i);
+            });
+        }
+        std::vector<std::thread> consumers;
+        for (int c = 0; c < producers; ++c) {
+            consumers.emplace_back([&] {
+                while (auto v = ch.recv()) benchmark::DoNotOptimize(*v);
+            });
+        }
+        for (auto& t : threads) t.join();
+        ch.close();
+        for (auto& t : consumers) t.join();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * producers * kPerProducer);
+}
+BENCHMARK(BM_ChanThroughput)
+    ->ArgNames({"buffer", "producers", "backend"})
+    ->ArgsProduct({{1, 64, 1024}, {1, 4}, {static_cast<int64_t>(ChanBackend::Locked),
+                                           static_cast<int64_t>(ChanBackend::SPSC),
+                                           static_cast<int64_t>(ChanBackend::MPMC)}})
+    ->UseRealTime();
+
+// One receiver selecting over four channels, each fed by its own thread.
+// Items are select() calls that received a value.
+static void BM_SelectFanIn(benchmark::State& state) {
+    constexpr int kSources = 4;
+    std::vector<std::unique_ptr<Chan<int>>> chans;
+    for (int i = 0; i < kSources; ++i) chans.push_back(std::make_unique<Chan<int>>(64));
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> feeders;
+    for (auto& ch : chans) {
+        feeders.emplace_back([&stop, c = ch.get()] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (c->trySend(1).Failed()) std::this_thread::yield();
+            }
+        });
+    }
+    int sum = 0;
+    auto add = [&sum](std::optional<int> v) { sum += v.value_or(0); };
+    for (auto _ : state) {
+        select(recvCase(*chans[0], add), recvCase(*chans[1], add), recvCase(*chans[2], add),
+               recvCase(*chans[3], add));
+    }
+    stop = true;
+    for (auto& t : feeders) t.join();
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_SelectFanIn)->UseRealTime();
+
+// Get and Put of a 4 KiB buffer, from one thread per benchmark thread
+static void BM_PoolGetPut(benchmark::State& state) {
+    static gocxx::sync::Pool<std::vector<uint8_t>> pool(
+        [] { return std::make_shared<std::vector<uint8_t>>(4096); });
+    for (auto _ : state) {
+        auto buf = pool.Get();
+        benchmark::DoNotOptimize(buf->data());
+        pool.Put(std::move(buf));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_PoolGetPut)->Threads(1)->Threads(4)->Threads(16);
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include <gocxx/encoding/base32.h>
+#include <gocxx/encoding/base64.h>
+#include <gocxx/encoding/hex.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace gocxx::encoding;
+
+// The benchmarks take a kernel index into this list and skip those this CPU lacks
+static const char* const kKernels[] = {"avx2", "ssse3", "neon", "scalar"};
+
+static std::string randomBytes(std::size_t n) {
+    std::mt19937 rng(42);
+    std::string s(n, '\0');
+    for (auto& c : s) c = static_cast<char>(rng());
+    return s;
+}
+
+static bool useKernel(benchmark::State& state, bool (*set)(std::string_view)) {
+    const char* name = kKernels[state.range(1)];
+    if (!set(name)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return false;
+    }
+    state.SetLabel(name);
+    return true;
+}
+
+static void BM_Base64Encode(benchmark::State& state) {
+    if (!useKernel(state, base64::detail::SetBase64Kernel)) return;
+    const std::string data = randomBytes(static_cast<std::size_t>(state.range(0)));
+    std::vector<uint8_t> out(base64::StdEncoding.EncodedLen(data.size()));
+    for (auto _ : state) {
+        base64::StdEncoding.Encode(out.data(), reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_Base64Encode)->ArgsProduct({{64, 64 << 10}, {0, 1, 2, 3}});
+
+static void BM_Base64Decode(benchmark::State& state) {
+    if (!useKernel(state, base64::detail::SetBase64Kernel)) return;
+    const std::string text = base64::StdEncoding.EncodeToString(randomBytes(static_cast<std::size_t>(state.range(0))));
+    std::vector<uint8_t> out(base64::StdEncoding.DecodedLen(text.size()));
+    for (auto _ : state) {
+        auto n = base64::StdEncoding.Decode(out.data(), reinterpret_cast<const uint8_t*>(text.data()), text.size());
+        benchmark::DoNotOptimize(n.value);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_Base64Decode)->ArgsProduct({{64, 64 << 10}, {0, 1, 2, 3}});
+
+// MIME bodies break lines every 76 characters, which sends each line end through the scalar code
+static void BM_Base64DecodeMIME(benchmark::State& state) {
+    if (!useKernel(state, base64::detail::SetBase64Kernel)) return;
+    const std::string plain = base64::StdEncoding.EncodeToString(randomBytes(static_cast<std::size_t>(state.range(0))));
+    std::string text;
+    for (std::size_t i = 0; i < plain.size(); i += 76) text += plain.substr(i, 76) + "\r\n";
+    std::vector<uint8_t> out(base64::StdEncoding.DecodedLen(text.size()));
+    for (auto _ : state) {
+        auto n = base64::StdEncoding.Decode(out.data(), reinterpret_cast<const uint8_t*>(text.data()), text.size());
+        benchmark::DoNotOptimize(n.value);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_Base64DecodeMIME)->ArgsProduct({{64 << 10}, {0, 1, 2, 3}});
+
+static void BM_HexEncode(benchmark::State& state) {
+    if (!useKernel(state, hex::detail::SetHexKernel)) return;
+    const std::string data = randomBytes(static_cast<std::size_t>(state.range(0)));
+    std::vector<uint8_t> out(hex::EncodedLen(data.size()));
+    for (auto _ : state) {
+        hex::Encode(out.data(), reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_HexEncode)->ArgsProduct({{64, 64 << 10}, {0, 1, 2, 3}});
+
+static void BM_HexDecode(benchmark::State& state) {
+    if (!useKernel(state, hex::detail::SetHexKernel)) return;
+    const std::string text = hex::EncodeToString(randomBytes(static_cast<std::size_t>(state.range(0))));
+    std::vector<uint8_t> out(hex::DecodedLen(text.size()));
+    for (auto _ : state) {
+        auto n = hex::Decode(out.data(), reinterpret_cast<const uint8_t*>(text.data()), text.size());
+        benchmark::DoNotOptimize(n.value);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_HexDecode)->ArgsProduct({{64, 64 << 10}, {0, 1, 2, 3}});
+
+static void BM_Base32Encode(benchmark::State& state) {
+    const std::string data = randomBytes(static_cast<std::size_t>(state.range(0)));
+    std::vector<uint8_t> out(base32::StdEncoding.EncodedLen(data.size()));
+    for (auto _ : state) {
+        base32::StdEncoding.Encode(out.data(), reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_Base32Encode)->Arg(64 << 10);
+
+static void BM_Base32Decode(benchmark::State& state) {
+    const std::string text = base32::StdEncoding.EncodeToString(randomBytes(static_cast<std::size_t>(state.range(0))));
+    std::vector<uint8_t> out(base32::StdEncoding.DecodedLen(text.size()));
+    for (auto _ : state) {
+        auto n = base32::StdEncoding.Decode(out.data(), reinterpret_cast<const uint8_t*>(text.data()), text.size());
+        benchmark::DoNotOptimize(n.value);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_Base32Decode)->Arg(64 << 10);
@@ -0,0 +1,202 @@
+#include <benchmark/benchmark.h>
+#include <gocxx/net/http.h>
+#include <gocxx/net/http_metrics.h>
+#include <gocxx/net/http_parser.h>
+#include <gocxx/os/file.h>
+#include <gocxx/runtime/runtime.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace gocxx::net;
+using namespace gocxx::net::http;
+
+// One connection per request, fired by `clients` threads at once, against
+// a server with no limits (one task per accepted connection, the previous
+// behaviour) or with max_conns / max_handlers set. Reports connections per
+// second, the p99 request latency and the runtime's worker threads. With
+// shards > 1 the server accepts from that many SO_REUSEPORT sockets.
+static void runServer(benchmark::State& state, std::size_t maxConns, std::size_t maxHandlers,
+                      std::size_t shards = 1) {
+    const int clients = static_cast<int>(state.range(0));
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/", [](ResponseWriter& w, const Request&) { w.Write("ok"); });
+
+    Server server("", mux);
+    server.max_conns = maxConns;
+    server.max_handlers = maxHandlers;
+    auto listeners = ListenConfig{1024}.ListenShards("tcp", "127.0.0.1:0", shards).value;
+    const std::string url = "http://" + listeners[0]->Address()->String() + "/";
+    std::thread serving([&] {
+        if (shards > 1) {
+            server.ServeShards(listeners);
+        } else {
+            server.Serve(listeners[0]);
+        }
+    });
+
+    Client client;
+    client.transport = std::make_shared<Transport>();
+    client.transport->max_idle_conns_per_host = 0;
+
+    std::vector<double> latencies;
+    std::vector<std::thread> threads;
+    std::vector<std::vector<double>> perClient(clients);
+    for (auto _ : state) {
+        threads.clear();
+        for (int c = 0; c < clients; ++c) {
+            threads.emplace_back([&, c] {
+                auto start = std::chrono::steady_clock::now();
+                auto resp = client.Get(url);
+                benchmark::DoNotOptimize(resp);
+                perClient[c].push_back(
+                    std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+
+    server.Shutdown(nullptr);
+    serving.join();
+
+    for (auto& l : perClient) latencies.insert(latencies.end(), l.begin(), l.end());
+    std::sort(latencies.begin(), latencies.end());
+    state.SetItemsProcessed(static_cast<int64_t>(latencies.size()));
+    if (!latencies.empty()) {
+        state.counters["p99_us"] = latencies[latencies.size() * 99 / 100];
+    }
+    state.counters["threads"] = gocxx::runtime::Stats().threads;
+}
+
+static void BM_HTTPServerUnbounded(benchmark::State& state) {
+    runServer(state, 0, 0);
+}
+BENCHMARK(BM_HTTPServerUnbounded)->Arg(16)->Arg(256)->UseRealTime();
+
+static void BM_HTTPServerBounded(benchmark::State& state) {
+    const std::size_t procs = std::max(1u, std::thread::hardware_concurrency());
+    runServer(state, 64, procs);
+}
+BENCHMARK(BM_HTTPServerBounded)->Arg(16)->Arg(256)->UseRealTime();
+
+static void BM_HTTPServerSharded(benchmark::State& state) {
+    runServer(state, 0, 0, static_cast<std::size_t>(state.range(1)));
+}
+BENCHMARK(BM_HTTPServerSharded)->ArgNames({"clients", "shards"})->Args({256, 1})->Args({256, 4})->UseRealTime();
+
+// Sequential GETs against a local server: a dial per request (no idle
+// connections kept) versus a Transport reusing one pooled connection.
+static void BM_HTTPClient(benchmark::State& state) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/", [](ResponseWriter& w, const Request&) { w.Write("ok"); });
+
+    Server server("", mux);
+    auto listener = ListenConfig{1024}.Listen("tcp", "127.0.0.1:0").value;
+    const std::string url = "http://" + listener->Address()->String() + "/";
+    std::thread serving([&] { server.Serve(listener); });
+
+    Client client;
+    client.transport = std::make_shared<Transport>();
+    client.transport->max_idle_conns_per_host = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        auto resp = client.Get(url);
+        benchmark::DoNotOptimize(resp);
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    client.transport->CloseIdleConnections();
+    server.Shutdown(nullptr);
+    serving.join();
+}
+BENCHMARK(BM_HTTPClient)->ArgName("max_idle")->Arg(0)->Arg(2)->UseRealTime();
+
+// Parsing a browser-like request head with 20 header fields in place
+static void BM_HTTPRequestParser(benchmark::State& state) {
+    std::string head = "GET /static/app.js?v=42 HTTP/1.1\r\nHost: www.example.com\r\n";
+    for (int i = 0; i < 19; ++i) {
+        head += "X-Header-" + std::to_string(i) + ": some/value; q=0.9, other/value\r\n";
+    }
+    head += "\r\n";
+    for (auto _ : state) {
+        RequestParser parser;
+        auto status = parser.Parse(head);
+        benchmark::DoNotOptimize(status);
+        benchmark::DoNotOptimize(parser.Header("x-header-18"));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * head.size()));
+}
+BENCHMARK(BM_HTTPRequestParser);
+
+namespace {
+
+class DiscardWriter : public ResponseWriter {
+public:
+    HeaderMap& Header() override { return header_; }
+    gocxx::base::Result<std::size_t> Write(const std::string& data) override { return {data.size(), nullptr}; }
+    void WriteHeader(int) override {}
+
+private:
+    HeaderMap header_;
+};
+
+} // namespace
+
+// Routing one request through a ServeMux holding 400 parameterised routes
+static void BM_ServeMuxRoute(benchmark::State& state) {
+    ServeMux mux;
+    for (int i = 0; i < 400; ++i) {
+        mux.HandleFunc("GET /api/v1/service" + std::to_string(i) + "/items/{id}",
+                       [](ResponseWriter&, const Request& req) { benchmark::DoNotOptimize(req.PathValue("id")); });
+    }
+    Request req;
+    req.method = "GET";
+    req.url = "/api/v1/service" + std::to_string(state.range(0)) + "/items/12345";
+    DiscardWriter w;
+    for (auto _ : state) {
+        mux.ServeHTTP(w, req);
+    }
+}
+BENCHMARK(BM_ServeMuxRoute)->Arg(0)->Arg(399);
+
+// GETs of a 1 MiB file through FileServer over one pooled connection
+static void BM_FileServer(benchmark::State& state) {
+    const std::string root = gocxx::os::TempDir() + "/gocxx_bench_files";
+    gocxx::os::MkdirAll(root, 0755);
+    gocxx::os::WriteFile(root + "/blob.bin", std::string(1 << 20, 'x'), 0644);
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/", FileServer(root));
+
+    Server server("", mux);
+    auto listener = ListenConfig{1024}.Listen("tcp", "127.0.0.1:0").value;
+    const std::string url = "http://" + listener->Address()->String() + "/blob.bin";
+    std::thread serving([&] { server.Serve(listener); });
+
+    Client client;
+    client.transport = std::make_shared<Transport>();
+    for (auto _ : state) {
+        auto resp = client.Get(url);
+        benchmark::DoNotOptimize(resp);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) << 20);
+
+    client.transport->CloseIdleConnections();
+    server.Shutdown(nullptr);
+    serving.join();
+    gocxx::os::RemoveAll(root);
+}
+BENCHMARK(BM_FileServer)->UseRealTime();
+
+// The bookkeeping Server::metrics adds to each request, from 1 or 4
+// threads recording into one ServerMetrics
+static void BM_ServerMetricsRecord(benchmark::State& state) {
+    static ServerMetrics metrics;
+    const std::string route = "GET /api/v1/items/{id}";
+    std::int64_t i = 0;
+    for (auto _ : state) {
+        metrics.RequestStarted();
+        metrics.RequestFinished(route, 200, 0, 512, std::chrono::microseconds(100 + (++i & 1023)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ServerMetricsRecord)->Threads(1)->Threads(4);
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <gocxx/io/io.h>
+#include <gocxx/io/io_errors.h>
+#include <gocxx/os/file.h>
+#include <gocxx/os/os.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gocxx;
+
+namespace {
+
+// Hands out `remaining` zero bytes, then EOF
+class ZeroReader : public io::Reader {
+public:
+    explicit ZeroReader(std::size_t n) : remaining_(n) {}
+
+    base::Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override {
+        if (remaining_ == 0) return base::Result<std::size_t>(0, io::ErrEOF);
+        const std::size_t n = std::min(size, remaining_);
+        std::memset(buffer, 0, n);
+        remaining_ -= n;
+        return base::Result<std::size_t>(n);
+    }
+
+private:
+    std::size_t remaining_;
+};
+
+// Accepts and drops everything, like Go's io.Discard
+class NullWriter : public io::Writer {
+public:
+    base::Result<std::size_t> Write(const uint8_t*, std::size_t size) override {
+        return base::Result<std::size_t>(size);
+    }
+};
+
+} // namespace
+
+// Bytes from one thread to another through io::Pipe, in writes of
+// `chunk` bytes, with the default ring and with none (Go's io.Pipe)
+static void BM_PipeBandwidth(benchmark::State& state) {
+    constexpr std::size_t kTotal = 8 << 20;
+    const auto chunk = static_cast<std::size_t>(state.range(0));
+    const auto ring = static_cast<std::size_t>(state.range(1));
+    const std::vector<uint8_t> data(chunk);
+    for (auto _ : state) {
+        auto [r, w] = io::Pipe(ring);
+        std::thread writer([&, w = w] {
+            for (std::size_t sent = 0; sent < kTotal; sent += chunk) w->Write(data.data(), data.size());
+            w->Close();
+        });
+        std::vector<uint8_t> buf(32 << 10);
+        while (r->Read(buf.data(), buf.size()).Ok()) {}
+        writer.join();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kTotal));
+}
+BENCHMARK(BM_PipeBandwidth)
+    ->ArgNames({"chunk", "ring"})
+    ->ArgsProduct({{512, 32 << 10}, {0, static_cast<int64_t>(io::kDefaultPipeBufferSize)}})
+    ->UseRealTime();
+
+// io::Copy through its user-space buffer: neither side offers a fast path
+static void BM_CopyGeneric(benchmark::State& state) {
+    constexpr std::size_t kTotal = 8 << 20;
+    auto dst = std::make_shared<NullWriter>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::Copy(dst, std::make_shared<ZeroReader>(kTotal)));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kTotal));
+}
+BENCHMARK(BM_CopyGeneric);
+
+// io::Copy between two files, which stays in the kernel
+static void BM_CopyFileToFile(benchmark::State& state) {
+    constexpr std::size_t kTotal = 8 << 20;
+    const std::string dir = os::MkdirTemp("", "gocxx_bench_copy").value;
+    os::WriteFile(dir + "/src", std::string(kTotal, 'x'), 0644);
+    for (auto _ : state) {
+        auto src = os::Open(dir + "/src").value;
+        auto dst = os::Create(dir + "/dst").value;
+        benchmark::DoNotOptimize(io::Copy(dst, src));
+        src->close();
+        dst->close();
+    }
+    os::RemoveAll(dir);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kTotal));
+}
+BENCHMARK(BM_CopyFileToFile)->UseRealTime();
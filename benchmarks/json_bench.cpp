@@ -0,0 +1,241 @@
+#include <benchmark/benchmark.h>
+#include <gocxx/encoding/json.h>
+#include <gocxx/encoding/json_document.h>
+#include <gocxx/encoding/json_struct.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace gocxx::encoding::json;
+
+// An API response with `records` user records, about 200 bytes each; the
+// benchmarks read the "id" and "name" of the first one, as most callers do.
+static std::string payload(int records) {
+    std::string s = R"({"status":"ok","page":{"next":"c3VyZS4=","total":)" + std::to_string(records) +
+                    R"(},"items":[)";
+    for (int i = 0; i < records; ++i) {
+        s += R"({"id":)" + std::to_string(100000 + i) + R"(,"name":"user )" + std::to_string(i) +
+             R"(","email":"user)" + std::to_string(i) +
+             R"(@example.com","active":true,"score":)" + std::to_string(i % 97) +
+             R"(.25,"tags":["alpha","beta","gamma"],"bio":"Likes \"quotes\" and cafés","manager":null})";
+        s += i + 1 < records ? "," : "";
+    }
+    return s + "]}";
+}
+
+static void BM_JsonUnmarshalFields(benchmark::State& state) {
+    const std::string text = payload(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        JsonValue v;
+        UnmarshalString(text, v);
+        const auto& first = v["items"][0];
+        benchmark::DoNotOptimize(first["id"].get<int64_t>());
+        benchmark::DoNotOptimize(first["name"].get_ref<const std::string&>().size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_JsonUnmarshalFields)->Arg(5)->Arg(1000);
+
+static void BM_JsonDocumentFields(benchmark::State& state) {
+    const std::string text = payload(static_cast<int>(state.range(0)));
+    Document doc;
+    for (auto _ : state) {
+        doc.Parse(text);
+        Element first = doc.Root().Get("items").value.At(0).value;
+        benchmark::DoNotOptimize(first.Get("id").value.GetInt().value);
+        benchmark::DoNotOptimize(first.Get("name").value.GetString().value.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+    state.SetLabel(gocxx::encoding::json::detail::JsonKernel());
+}
+BENCHMARK(BM_JsonDocumentFields)->Arg(5)->Arg(1000);
+
+// Reads every scalar of every record
+static void BM_JsonDocumentTraverse(benchmark::State& state) {
+    const std::string text = payload(static_cast<int>(state.range(0)));
+    Document doc;
+    for (auto _ : state) {
+        doc.Parse(text);
+        std::size_t total = 0;
+        for (Element item : doc.Root().Get("items").value.Elements()) {
+            for (const Member& m : item.Members()) {
+                switch (m.value.Type()) {
+                    case Kind::String: total += m.value.GetString().value.size(); break;
+                    case Kind::Number: total += static_cast<std::size_t>(m.value.GetFloat().value); break;
+                    case Kind::Array: total += m.value.Size().value; break;
+                    default: ++total;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_JsonDocumentTraverse)->Arg(1000);
+
+// Stage one alone, for each classifier this CPU has
+static void BM_JsonDocumentKernel(benchmark::State& state, const char* kernel) {
+    if (!gocxx::encoding::json::detail::SetJsonKernel(kernel)) {
+        state.SkipWithError("kernel not supported");
+        return;
+    }
+    const std::string text = payload(1000);
+    Document doc;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(doc.Parse(text).Ok());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+    gocxx::encoding::json::detail::SetJsonKernel("avx2") || gocxx::encoding::json::detail::SetJsonKernel("sse2") ||
+        gocxx::encoding::json::detail::SetJsonKernel("neon");
+}
+BENCHMARK_CAPTURE(BM_JsonDocumentKernel, avx2, "avx2");
+BENCHMARK_CAPTURE(BM_JsonDocumentKernel, sse2, "sse2");
+BENCHMARK_CAPTURE(BM_JsonDocumentKernel, scalar, "scalar");
+
+// Hands out a string in 4KB reads
+class StringReader : public gocxx::io::Reader {
+    const std::string& data_;
+    std::size_t pos_ = 0;
+
+public:
+    explicit StringReader(const std::string& data) : data_(data) {}
+
+    gocxx::base::Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override {
+        const std::size_t n = std::min({size, std::size_t{4096}, data_.size() - pos_});
+        std::memcpy(buffer, data_.data() + pos_, n);
+        pos_ += n;
+        return gocxx::base::Result<std::size_t>(n);
+    }
+};
+
+// Streams the records one at a time through Token, More and Decode
+static void BM_JsonDecoderElements(benchmark::State& state) {
+    const std::string text = payload(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        Decoder decoder(std::make_shared<StringReader>(text));
+        decoder.Token();  // '{'
+        for (auto key = decoder.Token(); key.Ok() && key.value.value != "items"; key = decoder.Token()) {
+            JsonValue skipped;
+            decoder.Decode(skipped);
+        }
+        decoder.Token();  // '['
+        std::size_t n = 0;
+        while (decoder.More()) {
+            JsonValue item;
+            decoder.Decode(item);
+            ++n;
+        }
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_JsonDecoderElements)->Arg(1000)->Arg(10000);
+
+namespace bench {
+
+struct Record {
+    int64_t id = 0;
+    std::string name;
+    std::string email;
+    bool active = false;
+    double score = 0;
+    std::vector<std::string> tags;
+    std::string bio;
+    std::optional<std::string> manager;
+};
+GOCXX_JSON_FIELDS(Record, id, name, email, active, score, tags, bio, manager)
+
+struct Page {
+    std::string status;
+    std::vector<Record> items;
+};
+GOCXX_JSON_FIELDS(Page, status, items)
+
+} // namespace bench
+
+// Typed records the old way: a JsonValue, then the Get* helpers
+static void BM_JsonStructViaDOM(benchmark::State& state) {
+    const std::string text = payload(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        JsonValue v;
+        UnmarshalString(text, v);
+        bench::Page page;
+        page.status = GetString(v["status"]);
+        for (const auto& item : GetArray(v["items"])) {
+            bench::Record r;
+            r.id = GetInt(item["id"]);
+            r.name = GetString(item["name"]);
+            r.email = GetString(item["email"]);
+            r.active = GetBool(item["active"]);
+            r.score = GetFloat(item["score"]);
+            for (const auto& t : GetArray(item["tags"])) r.tags.push_back(GetString(t));
+            r.bio = GetString(item["bio"]);
+            page.items.push_back(std::move(r));
+        }
+        benchmark::DoNotOptimize(page.items.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_JsonStructViaDOM)->Arg(5)->Arg(1000);
+
+static void BM_JsonStructUnmarshal(benchmark::State& state) {
+    const std::string text = payload(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        bench::Page page;
+        UnmarshalString(text, page);
+        benchmark::DoNotOptimize(page.items.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_JsonStructUnmarshal)->Arg(5)->Arg(1000);
+
+static void BM_JsonStructMarshal(benchmark::State& state) {
+    bench::Page page;
+    UnmarshalString(payload(static_cast<int>(state.range(0))), page);
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        auto out = MarshalString(page);
+        bytes = out.value.size();
+        benchmark::DoNotOptimize(out.value.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+BENCHMARK(BM_JsonStructMarshal)->Arg(1000);
+
+class DiscardWriter : public gocxx::io::Writer {
+public:
+    gocxx::base::Result<std::size_t> Write(const uint8_t*, std::size_t size) override {
+        return gocxx::base::Result<std::size_t>(size);
+    }
+};
+
+// What Encode used to do: dump to a string, copy it, write it
+static void BM_JsonDumpAndWrite(benchmark::State& state) {
+    JsonValue v;
+    UnmarshalString(payload(1000), v);
+    DiscardWriter w;
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        std::string s = v.dump();
+        std::vector<uint8_t> copy(s.begin(), s.end());
+        copy.push_back('\n');
+        w.Write(copy.data(), copy.size());
+        bytes = copy.size();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+BENCHMARK(BM_JsonDumpAndWrite);
+
+static void BM_JsonEncoderEncode(benchmark::State& state) {
+    JsonValue v;
+    UnmarshalString(payload(1000), v);
+    auto w = std::make_shared<DiscardWriter>();
+    Encoder encoder(w);
+    encoder.SetEscapeHTML(state.range(0) != 0);
+    const std::size_t bytes = v.dump().size() + 1;
+    for (auto _ : state) {
+        encoder.Encode(v);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+BENCHMARK(BM_JsonEncoderEncode)->Arg(0)->Arg(1);
@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+#include <gocxx/net/resolver.h>
+#include <gocxx/net/tcp.h>
+#include <gocxx/net/udp.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace gocxx::net;
+
+namespace {
+
+// A socket sending 64-byte datagrams to a bound socket nobody reads: the
+// kernel drops what overflows, so this measures the sending side only
+struct UDPPair {
+    std::shared_ptr<UDPConn> receiver = ListenUDPSimple("127.0.0.1:0").value;
+    std::shared_ptr<UDPConn> sender = ListenUDPSimple("127.0.0.1:0").value;
+    std::shared_ptr<UDPAddr> to = std::static_pointer_cast<UDPAddr>(receiver->LocalAddr());
+    uint8_t payload[64] = {};
+
+    ~UDPPair() {
+        receiver->close();
+        sender->close();
+    }
+};
+
+} // namespace
+
+// One sendto per datagram
+static void BM_UDPWriteToUDP(benchmark::State& state) {
+    UDPPair pair;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < UDPConn::kMaxBatch; ++i) {
+            benchmark::DoNotOptimize(pair.sender->WriteToUDP(pair.payload, sizeof(pair.payload), pair.to));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * UDPConn::kMaxBatch));
+}
+BENCHMARK(BM_UDPWriteToUDP);
+
+// kMaxBatch datagrams per sendmmsg, with the destination held by value
+static void BM_UDPWriteBatch(benchmark::State& state) {
+    UDPPair pair;
+    std::vector<UDPMessage> msgs(UDPConn::kMaxBatch);
+    for (auto& msg : msgs) {
+        msg.buffer = pair.payload;
+        msg.size = sizeof(pair.payload);
+        msg.addr = AddrPort::From(*pair.to);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pair.sender->WriteBatch(msgs.data(), msgs.size()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * UDPConn::kMaxBatch));
+}
+BENCHMARK(BM_UDPWriteBatch);
+
+// Looking up "localhost" through a Resolver that caches nothing (a
+// getaddrinfo call every time) versus one with the default cache
+static void BM_ResolverLookupHost(benchmark::State& state) {
+    Resolver resolver;
+    if (state.range(0) == 0) {
+        resolver.ttl = std::chrono::nanoseconds(0);
+    }
+    for (auto _ : state) {
+        auto ips = resolver.LookupHost(nullptr, "localhost");
+        benchmark::DoNotOptimize(ips);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ResolverLookupHost)->ArgName("cached")->Arg(0)->Arg(1)->UseRealTime();
+
+// A 64-byte message to a loopback echo server and back over one TCP connection
+static void BM_TCPRoundTrip(benchmark::State& state) {
+    auto listener = ListenTCP("tcp", "127.0.0.1:0").value;
+    std::thread echo([&] {
+        auto conn = listener->Accept().value;
+        uint8_t buf[64];
+        while (true) {
+            auto n = conn->Read(buf, sizeof(buf));
+            if (n.Failed() || conn->Write(buf, n.value).Failed()) break;
+        }
+        conn->close();
+    });
+    auto conn = DialTCP("tcp", listener->Address()->String()).value;
+    uint8_t payload[64] = {};
+    for (auto _ : state) {
+        conn->Write(payload, sizeof(payload));
+        for (std::size_t got = 0; got < sizeof(payload);) {
+            auto n = conn->Read(payload + got, sizeof(payload) - got);
+            if (n.Failed()) {
+                state.SkipWithError(n.err->error().c_str());
+                break;
+            }
+            got += n.value;
+        }
+    }
+    conn->close();
+    echo.join();
+    listener->Close();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TCPRoundTrip)->UseRealTime();
+
+// A 64-byte datagram to a loopback echo socket and back
+static void BM_UDPRoundTrip(benchmark::State& state) {
+    UDPPair pair;
+    std::thread echo([&] {
+        uint8_t buf[64];
+        std::shared_ptr<UDPAddr> from;
+        while (true) {
+            auto n = pair.receiver->ReadFromUDP(buf, sizeof(buf), from);
+            if (n.Failed() || n.value == 0) break;
+            pair.receiver->WriteToUDP(buf, n.value, from);
+        }
+    });
+    std::shared_ptr<UDPAddr> from;
+    for (auto _ : state) {
+        pair.sender->WriteToUDP(pair.payload, sizeof(pair.payload), pair.to);
+        benchmark::DoNotOptimize(pair.sender->ReadFromUDP(pair.payload, sizeof(pair.payload), from));
+    }
+    // An empty datagram tells the echo loop to stop
+    pair.sender->WriteToUDP(pair.payload, 0, pair.to);
+    echo.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UDPRoundTrip)->UseRealTime();
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include <gocxx/context/context.h>
+#include <gocxx/time/time.h>
+#include <gocxx/time/timer.h>
+#include <chrono>
+
+using namespace gocxx::time;
+
+// Time::Now() before it carried a monotonic reading: system_clock only.
+static void BM_WallClockOnly(benchmark::State& state) {
+    for (auto _ : state) {
+        auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+        int64_t sec = std::chrono::duration_cast<std::chrono::seconds>(since_epoch).count();
+        auto nsec = static_cast<int32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count() % 1'000'000'000);
+        benchmark::DoNotOptimize(Time(sec, nsec));
+    }
+}
+BENCHMARK(BM_WallClockOnly);
+
+static void BM_TimeNow(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Time::Now());
+    }
+}
+BENCHMARK(BM_TimeNow);
+
+static void BM_CoarseNow(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CoarseNow());
+    }
+}
+BENCHMARK(BM_CoarseNow);
+
+static void BM_Since(benchmark::State& state) {
+    Time start = Time::Now();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Since(start));
+    }
+}
+BENCHMARK(BM_Since);
+
+static void BM_DeadlineCheckCoarse(benchmark::State& state) {
+    Time deadline = CoarseNow().Add(Hours(int64_t(1)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CoarseNow().Before(deadline));
+    }
+}
+BENCHMARK(BM_DeadlineCheckCoarse);
+
+// A timer that never fires: arming it and stopping it again
+static void BM_TimerNewStop(benchmark::State& state) {
+    for (auto _ : state) {
+        auto t = NewTimer(Hours(int64_t(1)));
+        benchmark::DoNotOptimize(t->Stop());
+    }
+}
+BENCHMARK(BM_TimerNewStop);
+
+static void BM_AfterFuncStop(benchmark::State& state) {
+    for (auto _ : state) {
+        auto t = AfterFunc(Hours(int64_t(1)), [] {});
+        benchmark::DoNotOptimize(t->Stop());
+    }
+}
+BENCHMARK(BM_AfterFuncStop);
+
+// Deriving a context from Background and cancelling it
+static void BM_ContextWithCancel(benchmark::State& state) {
+    auto parent = gocxx::context::Background();
+    for (auto _ : state) {
+        auto [ctx, cancel] = gocxx::context::WithCancel(parent).value;
+        cancel();
+        benchmark::DoNotOptimize(ctx);
+    }
+}
+BENCHMARK(BM_ContextWithCancel);
+
+static void BM_ContextWithTimeout(benchmark::State& state) {
+    auto parent = gocxx::context::Background();
+    for (auto _ : state) {
+        auto [ctx, cancel] = gocxx::context::WithTimeout(parent, Hours(int64_t(1))).value;
+        cancel();
+        benchmark::DoNotOptimize(ctx);
+    }
+}
+BENCHMARK(BM_ContextWithTimeout);
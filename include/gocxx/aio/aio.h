@@ -0,0 +1,154 @@
+/**
+ * @file aio.h
+ * @brief Asynchronous file and socket I/O on io_uring, with a thread-pool fallback
+ *
+ * An Engine accepts read, write and fsync operations on raw descriptors and
+ * completes each one on its own channel, so a handful of threads can keep
+ * many operations in flight instead of parking one thread per blocking call.
+ *
+ * - Linux: operations go into an io_uring submission queue; a batch costs a
+ *   single io_uring_enter, and one reaper thread turns completion-queue
+ *   entries into channel sends. Registered buffers and files map to
+ *   IORING_OP_READ_FIXED/WRITE_FIXED and IOSQE_FIXED_FILE.
+ * - Elsewhere, or when io_uring is unavailable (old kernel, seccomp), the
+ *   same operations run as pread/pwrite/fsync on a small pool of threads.
+ *
+ * Buffers must stay alive and untouched until the operation's completion
+ * has been received.
+ *
+ * @code
+ * aio::Engine& eng = aio::Engine::Default();
+ * auto done = eng.Read(file->Fd(), buf.data(), buf.size(), 0);
+ * auto n = *done->recv();      // or: co_await done
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gocxx/base/chan.h>
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/io/io.h>
+
+namespace gocxx::aio {
+
+    /// Receives exactly one value: bytes transferred (0 at end of file), or the error.
+    using Completion = std::shared_ptr<base::Chan<base::Result<std::size_t>>>;
+
+    enum class OpKind { Read, Write, Fsync };
+
+    /**
+     * @brief One operation for Engine::Submit.
+     */
+    struct Op {
+        OpKind kind = OpKind::Read;
+        int fd = -1;             ///< descriptor, or registered-file index when fixedFile is set
+        uint8_t* buf = nullptr;
+        std::size_t len = 0;
+        int64_t offset = -1;     ///< -1: at the current file position (sockets, pipes)
+        bool fixedFile = false;  ///< fd indexes the table given to RegisterFiles()
+        int bufIndex = -1;       ///< registered buffer that holds [buf, buf + len), or -1
+
+        static Op Read(int fd, uint8_t* buf, std::size_t len, int64_t offset = -1) {
+            Op op;
+            op.kind = OpKind::Read;
+            op.fd = fd;
+            op.buf = buf;
+            op.len = len;
+            op.offset = offset;
+            return op;
+        }
+
+        static Op Write(int fd, const uint8_t* buf, std::size_t len, int64_t offset = -1) {
+            Op op = Read(fd, const_cast<uint8_t*>(buf), len, offset);
+            op.kind = OpKind::Write;
+            return op;
+        }
+
+        static Op Fsync(int fd) {
+            Op op;
+            op.kind = OpKind::Fsync;
+            op.fd = fd;
+            return op;
+        }
+
+        /// Same operation on registered file @p index.
+        Op& Fixed(int index) {
+            fd = index;
+            fixedFile = true;
+            return *this;
+        }
+
+        /// Same operation through registered buffer @p index.
+        Op& Registered(int index) {
+            bufIndex = index;
+            return *this;
+        }
+    };
+
+    namespace detail {
+        class Backend;
+    }
+
+    struct Options {
+        unsigned entries = 256;       ///< submission queue size (io_uring)
+        std::size_t threads = 4;      ///< worker threads (fallback)
+        bool forceThreadPool = false; ///< skip io_uring even where it works
+    };
+
+    /**
+     * @brief Submits operations and completes them asynchronously.
+     *
+     * Thread-safe. Destroying the Engine waits for operations in flight.
+     */
+    class Engine {
+    public:
+        explicit Engine(Options opts = {});
+        ~Engine();
+
+        Engine(const Engine&) = delete;
+        Engine& operator=(const Engine&) = delete;
+
+        /// Process-wide engine with default options, created on first use.
+        static Engine& Default();
+
+        Completion Submit(const Op& op);
+
+        /// Submits @p ops together (one io_uring_enter); completions are in the same order.
+        std::vector<Completion> Submit(const std::vector<Op>& ops);
+
+        Completion Read(int fd, uint8_t* buf, std::size_t len, int64_t offset = -1) {
+            return Submit(Op::Read(fd, buf, len, offset));
+        }
+        Completion Write(int fd, const uint8_t* buf, std::size_t len, int64_t offset = -1) {
+            return Submit(Op::Write(fd, buf, len, offset));
+        }
+        Completion Fsync(int fd) {
+            return Submit(Op::Fsync(fd));
+        }
+
+        /**
+         * @brief Pins @p bufs for Op::Registered(); replaces any earlier set.
+         *
+         * The kernel maps them once instead of on every operation.
+         */
+        base::Result<void> RegisterBuffers(const io::MutableBuffers& bufs);
+        base::Result<void> UnregisterBuffers();
+
+        /// Installs the descriptor table Op::Fixed() indexes; replaces any earlier one.
+        base::Result<void> RegisterFiles(const std::vector<int>& fds);
+        base::Result<void> UnregisterFiles();
+
+        /// true when operations go through io_uring rather than the thread pool.
+        bool UsesIoUring() const;
+
+    private:
+        std::unique_ptr<detail::Backend> impl_;
+    };
+
+} // namespace gocxx::aio
@@ -0,0 +1,93 @@
+/**
+ * @file arena.h
+ * @brief Monotonic arena allocator, in the spirit of Go's experimental arena package
+ *
+ * An Arena is a std::pmr::memory_resource that hands out memory by bumping a
+ * pointer through large blocks and never frees individual allocations.
+ * Everything is dropped at once by Reset(), which keeps the blocks, so an
+ * arena reused for many similar units of work (one per HTTP request, say)
+ * stops calling malloc once it has grown to their size.
+ *
+ * @code
+ * arena::Arena a;
+ * std::pmr::vector<std::pmr::string> names(&a);
+ * names.emplace_back("scratch space");
+ * // ...
+ * names.clear();
+ * a.Reset();  // names must not be used with the old memory again
+ * @endcode
+ *
+ * An Arena is not safe for concurrent use, and objects allocated from it
+ * must not be touched after Reset().
+ */
+
+// gocxx/arena/arena.h
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+namespace gocxx::arena {
+
+    class Arena : public std::pmr::memory_resource {
+    public:
+        /// Size of the first block; later ones double, up to 64 times this.
+        static constexpr std::size_t kDefaultBlockSize = 4096;
+
+        /// Reset() gives blocks beyond this many bytes back to the upstream resource.
+        static constexpr std::size_t kDefaultMaxRetained = 256 * 1024;
+
+        explicit Arena(std::size_t blockSize = kDefaultBlockSize,
+                       std::pmr::memory_resource* upstream = std::pmr::new_delete_resource(),
+                       std::size_t maxRetained = kDefaultMaxRetained);
+        ~Arena() override;
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief Drops every allocation, keeping the memory for reuse
+         *
+         * When the last cycle spilled into more than one block, they are
+         * replaced by a single block of their combined size (capped at
+         * maxRetained), so the next cycle fits without growing.
+         */
+        void Reset();
+
+        /// Drops every allocation and gives all memory back to the upstream resource.
+        void Release();
+
+        /// Bytes handed out since the last Reset(), alignment padding included.
+        std::size_t Used() const noexcept { return used_ + static_cast<std::size_t>(cur_ - begin_); }
+
+        /// Bytes held in blocks, in use or not.
+        std::size_t Capacity() const noexcept { return capacity_; }
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    private:
+        struct Block {
+            Block* next;
+            std::size_t size;  // usable bytes after the header
+        };
+
+        void* grow(std::size_t bytes, std::size_t alignment);
+        Block* newBlock(std::size_t size);
+        void freeBlocks(Block* b);
+        void enter(Block* b);
+
+        std::pmr::memory_resource* upstream_;
+        std::size_t blockSize_;
+        std::size_t maxRetained_;
+        std::size_t nextSize_;
+        Block* head_ = nullptr;  // current block, then the ones filled before it
+        char* begin_ = nullptr;
+        char* cur_ = nullptr;
+        char* end_ = nullptr;
+        std::size_t used_ = 0;      // bytes in blocks filled before the current one
+        std::size_t capacity_ = 0;
+    };
+
+} // namespace gocxx::arena
@@ -20,6 +20,18 @@
 #include <algorithm>
 #include <gocxx/errors/errors.h>
 #include <gocxx/base/result.h>
+#include <gocxx/base/detail/ring_buffer.h>
+#include <gocxx/base/wait_policy.h>
+#include <gocxx/base/detail/wait_queue.h>
+#include <gocxx/base/chan_stats.h>
+#include <thread>
+
+#if defined(GOCXX_HAS_COROUTINES)
+namespace gocxx::coro {
+    template<typename T> class RecvAwaitable;
+    template<typename T> class SendAwaitable;
+}
+#endif
 
 /**
  * @namespace gocxx
@@ -36,6 +48,18 @@ namespace gocxx {
  */
 namespace base {
 
+    /// trySend found no room: the buffer is full or no receiver is waiting.
+    inline const std::shared_ptr<gocxx::errors::Error> ErrChanFull =
+        gocxx::errors::Sentinel("buffer full");
+
+    /// tryRecv found nothing to receive on an open channel.
+    inline const std::shared_ptr<gocxx::errors::Error> ErrChanEmpty =
+        gocxx::errors::Sentinel("buffer empty");
+
+    /// The channel is closed and, for a receive, drained.
+    inline const std::shared_ptr<gocxx::errors::Error> ErrChanClosed =
+        gocxx::errors::Sentinel("channel closed");
+
     /**
      * @interface IChan
      * @brief Interface for channel operations
@@ -45,7 +69,7 @@ namespace base {
      * providing both blocking and non-blocking send/receive operations.
      */
     template<typename T>
-    class IChan {
+    class IChan : public detail::WaitSource {
     public:
         /**
          * @brief Send a value to the channel (blocking)
@@ -88,25 +112,19 @@ namespace base {
         virtual bool isClosed() const = 0;
         
         /**
-         * @brief Register a condition variable for receive waiting (internal use)
+         * @brief Link a select/coroutine wait node into this channel (internal use)
+         *
+         * Idempotent: a node that is still queued stays where it is.
+         * The node's Waiter is woken (at most once) when the side named by
+         * node->side may be able to proceed, or when the channel closes.
          */
-        virtual void registerRecvWaiter(std::condition_variable* cv, bool* ready) = 0;
-        
-        /**
-         * @brief Unregister a condition variable for receive waiting (internal use)
-         */
-        virtual void unregisterRecvWaiter(std::condition_variable* cv) = 0;
-        
-        /**
-         * @brief Register a condition variable for send waiting (internal use)
-         */
-        virtual void registerSendWaiter(std::condition_variable* cv, bool* ready) = 0;
-        
+        virtual void enqueueWaiter(detail::WaitNode* node) = 0;
+
         /**
-         * @brief Unregister a condition variable for send waiting (internal use)
+         * @brief Unlink a wait node in O(1); harmless if it was already woken (internal use)
          */
-        virtual void unregisterSendWaiter(std::condition_variable* cv) = 0;
-        
+        virtual void dequeueWaiter(detail::WaitNode* node) = 0;
+
         /**
          * @brief Check if the channel can accept a send operation
          * @return true if send won't block, false otherwise
@@ -118,8 +136,120 @@ namespace base {
          * @return true if receive won't block, false otherwise
          */
         virtual bool canRecv() const = 0;
-        
-        virtual ~IChan() = default;
+
+        /**
+         * @brief Send @p count values, moving them out of @p items (blocking)
+         *
+         * Equivalent to calling send() for each element in order, but
+         * implementations move as many elements as fit per lock acquisition
+         * and wake receivers once per chunk instead of once per element.
+         * @throws std::runtime_error if the channel is closed; elements sent
+         *         before the close stay in the channel
+         */
+        virtual void sendBatch(T* items, std::size_t count) {
+            for (std::size_t i = 0; i < count; ++i) {
+                send(std::move(items[i]));
+            }
+        }
+
+        /**
+         * @brief Receive up to @p max values into @p out
+         *
+         * Blocks until at least one value is available (or the channel is
+         * closed), then takes whatever else is already buffered without
+         * blocking again.
+         * @return Number of values appended; 0 means closed and drained
+         */
+        virtual std::size_t recvBatch(std::vector<T>& out, std::size_t max) {
+            if (max == 0) return 0;
+            auto first = recv();
+            if (!first) return 0;
+            out.push_back(std::move(*first));
+            return 1 + drainUpTo(out, max - 1);
+        }
+
+        /**
+         * @brief Move every value that is buffered right now into @p out
+         * @return Number of values appended (never blocks)
+         */
+        virtual std::size_t drain(std::vector<T>& out) {
+            return drainUpTo(out, static_cast<std::size_t>(-1));
+        }
+
+        /**
+         * @brief Override the spin/yield budget used before blocking
+         *
+         * Channels without an explicit policy follow SetDefaultWaitPolicy().
+         */
+        virtual void setWaitPolicy(const WaitPolicy& policy) { (void)policy; }
+
+        /**
+         * @brief Buffer size of the channel (0 for unbuffered)
+         */
+        virtual std::size_t capacity() const { return 0; }
+
+        /**
+         * @brief Start collecting statistics and list the channel in ListChannels()
+         *
+         * Until this is called the instrumentation costs one pointer load per
+         * operation. Calling it again only renames the channel.
+         */
+        void enableStats(std::string name) {
+            auto owned = std::make_shared<detail::ChanCounters>(name, capacity());
+            detail::ChanCounters* expected = nullptr;
+            if (!counters_.compare_exchange_strong(expected, owned.get(), std::memory_order_acq_rel)) {
+                expected->rename(std::move(name));
+                return;
+            }
+            countersOwner_ = owned;
+            detail::ChanRegistry::instance().add(owned);
+        }
+
+        /**
+         * @brief Snapshot of the counters; all zero unless enableStats() was called
+         */
+        ChanStats stats() const {
+            if (detail::ChanCounters* c = counters()) return c->snapshot();
+            ChanStats s;
+            s.capacity = capacity();
+            return s;
+        }
+
+        virtual ~IChan() {
+            if (countersOwner_) detail::ChanRegistry::instance().remove(countersOwner_.get());
+        }
+
+    protected:
+        detail::ChanCounters* counters() const noexcept {
+            return counters_.load(std::memory_order_acquire);
+        }
+
+        void noteSent(std::size_t n = 1) const {
+            if (detail::ChanCounters* c = counters()) c->recordSend(n);
+        }
+
+        void noteReceived(std::size_t n = 1) const {
+            if (detail::ChanCounters* c = counters()) c->recordRecv(n);
+        }
+
+        void noteClosed() const {
+            if (detail::ChanCounters* c = counters()) c->recordClose();
+        }
+
+    private:
+        std::atomic<detail::ChanCounters*> counters_{nullptr};
+        std::shared_ptr<detail::ChanCounters> countersOwner_;
+
+        std::size_t drainUpTo(std::vector<T>& out, std::size_t max) {
+            std::size_t n = 0;
+            while (n < max) {
+                auto r = tryRecv();
+                if (!r.Ok()) break;
+                out.push_back(std::move(r.value));
+                ++n;
+            }
+            return n;
+        }
     };
 
     template<typename T>
@@ -138,30 +268,28 @@ namespace base {
                 // Unbuffered channel - synchronous send/receive
                 sendValue_ = std::move(value);
                 hasSendValue_ = true;
+                this->noteSent();
                 
                 // Notify any waiting receivers
-                cond_recv_.NotifyOne();
-                notifySelectWaiters(recvWaiters_);
+                signal(cond_recv_);
+                recvQueue_.wake();
                 
                 // Wait for receiver to pick up the value
-                while (!closed_ && hasSendValue_) {
-                    cond_send_.Wait(lock);
-                }
+                waitUntil(lock, cond_send_, [&] { return closed_ || !hasSendValue_; });
                 if (closed_) {
                     throw std::runtime_error("send on closed channel");
                 }
             } else {
                 // Buffered channel
-                while (!closed_ && queue_.size() >= bufferSize_) {
-                    cond_send_.Wait(lock);
-                }
+                waitUntil(lock, cond_send_, [&] { return closed_ || queue_.size() < bufferSize_; });
                 if (closed_) {
                     throw std::runtime_error("send on closed channel");
                 }
 
                 queue_.push(std::move(value));
-                cond_recv_.NotifyOne();
-                notifySelectWaiters(recvWaiters_);
+                this->noteSent();
+                signal(cond_recv_);
+                recvQueue_.wake();
             }
         }
 
@@ -170,9 +298,7 @@ namespace base {
 
             if (bufferSize_ == 0) {
                 // Unbuffered channel - wait for sender
-                while (!closed_ && !hasSendValue_) {
-                    cond_recv_.Wait(lock);
-                }
+                waitUntil(lock, cond_recv_, [&] { return closed_ || hasSendValue_; });
 
                 if (!hasSendValue_ && closed_) {
                     return std::nullopt;
@@ -182,16 +308,16 @@ namespace base {
                     auto val = std::move(sendValue_.value());
                     sendValue_.reset();
                     hasSendValue_ = false;
-                    cond_send_.NotifyOne(); // Wake up the sender
+                    this->noteReceived();
+                    signal(cond_send_); // Wake up the sender
+                    sendQueue_.wake();
                     return val;
                 }
                 
                 return std::nullopt;
             } else {
                 // Buffered channel
-                while (!closed_ && queue_.empty()) {
-                    cond_recv_.Wait(lock);
-                }
+                waitUntil(lock, cond_recv_, [&] { return closed_ || !queue_.empty(); });
 
                 if (queue_.empty() && closed_) {
                     return std::nullopt;
@@ -199,7 +325,9 @@ namespace base {
 
                 auto val = std::move(queue_.front());
                 queue_.pop();
-                cond_send_.NotifyOne(); // Wake up any waiting senders
+                this->noteReceived();
+                signal(cond_send_); // Wake up any waiting senders
+                sendQueue_.wake();
                 return val;
             }
         }
@@ -207,30 +335,32 @@ namespace base {
         Result<void> trySend(T&& value) override {
             gocxx::sync::UniqueLock lock(mutex_);
             if (closed_) {
-                return Result<void>(gocxx::errors::New("trySend on closed channel"));
+                return Result<void>(ErrChanClosed);
             }
 
             if (bufferSize_ == 0) {
                 // Unbuffered channel - need immediate receiver ready
                 // For non-blocking, we can't wait - just check if receiver is waiting
                 if (hasSendValue_) {
-                    return Result<void>(gocxx::errors::New("channel busy"));
+                    return Result<void>(ErrChanFull);
                 }
 
                 sendValue_ = std::move(value);
                 hasSendValue_ = true;
-                cond_recv_.NotifyOne();
-                notifySelectWaiters(recvWaiters_);
+                this->noteSent();
+                signal(cond_recv_);
+                recvQueue_.wake();
                 return Result<void>();
             } else {
                 // Buffered channel
                 if (queue_.size() >= bufferSize_) {
-                    return Result<void>(gocxx::errors::New("buffer full"));
+                    return Result<void>(ErrChanFull);
                 }
 
                 queue_.push(std::move(value));
-                cond_recv_.NotifyOne();
-                notifySelectWaiters(recvWaiters_);
+                this->noteSent();
+                signal(cond_recv_);
+                recvQueue_.wake();
                 return Result<void>();
             }
         }
@@ -242,28 +372,32 @@ namespace base {
                 // Unbuffered channel
                 if (!hasSendValue_) {
                     if (closed_) {
-                        return Result<T>(gocxx::errors::New("channel closed"));
+                        return Result<T>(ErrChanClosed);
                     }
-                    return Result<T>(gocxx::errors::New("no data to receive"));
+                    return Result<T>(ErrChanEmpty);
                 }
 
                 auto val = std::move(sendValue_.value());
                 sendValue_.reset();
                 hasSendValue_ = false;
-                cond_send_.NotifyOne();
+                this->noteReceived();
+                signal(cond_send_);
+                sendQueue_.wake();
                 return Result<T>(std::move(val));
             } else {
                 // Buffered channel
                 if (queue_.empty()) {
                     if (closed_) {
-                        return Result<T>(gocxx::errors::New("channel closed"));
+                        return Result<T>(ErrChanClosed);
                     }
-                    return Result<T>(gocxx::errors::New("buffer empty"));
+                    return Result<T>(ErrChanEmpty);
                 }
 
                 auto val = std::move(queue_.front());
                 queue_.pop();
-                cond_send_.NotifyOne();
+                this->noteReceived();
+                signal(cond_send_);
+                sendQueue_.wake();
                 return Result<T>(std::move(val));
             }
         }
@@ -273,12 +407,13 @@ namespace base {
             if (closed_) return;  // Already closed
 
             closed_ = true;
-            cond_recv_.NotifyAll();
-            cond_send_.NotifyAll();
+            this->noteClosed();
+            signal(cond_recv_, true);
+            signal(cond_send_, true);
             
             // Notify all select statements waiting on this channel
-            notifySelectWaiters(recvWaiters_);
-            notifySelectWaiters(sendWaiters_);
+            recvQueue_.wakeAll();
+            sendQueue_.wakeAll();
         }
 
         bool isClosed() const override {
@@ -286,36 +421,21 @@ namespace base {
             return closed_;
         }
 
-        void registerRecvWaiter(std::condition_variable* cv, bool* ready) override {
-            if (!cv) return;
+        void enqueueWaiter(detail::WaitNode* node) override {
             gocxx::sync::Lock lock(mutex_);
-            recvWaiters_.emplace_back(cv, ready);
+            if (node->queued) return;
+            node->source = this;
+            queueFor(node->side).push(node);
         }
 
-        void unregisterRecvWaiter(std::condition_variable* cv) override {
-            if (!cv) return;
+        void dequeueWaiter(detail::WaitNode* node) override {
             gocxx::sync::Lock lock(mutex_);
-            recvWaiters_.erase(
-                std::remove_if(recvWaiters_.begin(), recvWaiters_.end(),
-                    [cv](const auto& pair) { return pair.first == cv; }),
-                recvWaiters_.end()
-            );
+            queueFor(node->side).remove(node);
         }
 
-        void registerSendWaiter(std::condition_variable* cv, bool* ready) override {
-            if (!cv) return;
+        void passWake(detail::WaitSide side) override {
             gocxx::sync::Lock lock(mutex_);
-            sendWaiters_.emplace_back(cv, ready);
-        }
-
-        void unregisterSendWaiter(std::condition_variable* cv) override {
-            if (!cv) return;
-            gocxx::sync::Lock lock(mutex_);
-            sendWaiters_.erase(
-                std::remove_if(sendWaiters_.begin(), sendWaiters_.end(),
-                    [cv](const auto& pair) { return pair.first == cv; }),
-                sendWaiters_.end()
-            );
+            queueFor(side).wake();
         }
 
         bool canSend() const override {
@@ -342,12 +462,111 @@ namespace base {
             }
         }
 
+        void sendBatch(T* items, std::size_t count) override {
+            if (bufferSize_ == 0) {
+                // Every unbuffered send is its own rendezvous
+                IChan<T>::sendBatch(items, count);
+                return;
+            }
+
+            gocxx::sync::UniqueLock lock(mutex_);
+            std::size_t sent = 0;
+            while (sent < count) {
+                waitUntil(lock, cond_send_, [&] { return closed_ || queue_.size() < bufferSize_; });
+                if (closed_) {
+                    throw std::runtime_error("send on closed channel");
+                }
+
+                std::size_t room = bufferSize_ - queue_.size();
+                std::size_t chunk = std::min(room, count - sent);
+                for (std::size_t i = 0; i < chunk; ++i) {
+                    queue_.push(std::move(items[sent + i]));
+                }
+                sent += chunk;
+                this->noteSent(chunk);
+
+                if (chunk == 1) signal(cond_recv_);
+                else signal(cond_recv_, true);
+                recvQueue_.wake();
+            }
+        }
+
+        std::size_t recvBatch(std::vector<T>& out, std::size_t max) override {
+            if (max == 0) return 0;
+            if (bufferSize_ == 0) {
+                auto val = recv();
+                if (!val) return 0;
+                out.push_back(std::move(*val));
+                return 1;
+            }
+
+            gocxx::sync::UniqueLock lock(mutex_);
+            waitUntil(lock, cond_recv_, [&] { return closed_ || !queue_.empty(); });
+            return takeBuffered(out, max);
+        }
+
+        std::size_t drain(std::vector<T>& out) override {
+            gocxx::sync::UniqueLock lock(mutex_);
+            if (bufferSize_ == 0) {
+                if (!hasSendValue_) return 0;
+                out.push_back(std::move(sendValue_.value()));
+                sendValue_.reset();
+                hasSendValue_ = false;
+                this->noteReceived();
+                signal(cond_send_);
+                sendQueue_.wake();
+                return 1;
+            }
+            return takeBuffered(out, queue_.size());
+        }
+
+        void setWaitPolicy(const WaitPolicy& policy) override {
+            policy_.set(policy);
+        }
+
+        std::size_t capacity() const override { return bufferSize_; }
+
     private:
-        void notifySelectWaiters(const std::vector<std::pair<std::condition_variable*, bool*>>& waiters) {
-            for (const auto& [cv, ready] : waiters) {
-                if (ready) *ready = true;
-                if (cv) cv->notify_one();
+        // Caller holds mutex_. Publishes a state change to spinning waiters
+        // (via version_) and to parked ones (via the condition).
+        void signal(gocxx::sync::Cond& cond, bool all = false) {
+            version_.fetch_add(1, std::memory_order_release);
+            if (all) cond.NotifyAll();
+            else cond.NotifyOne();
+        }
+
+        template<typename Pred>
+        void waitUntil(gocxx::sync::UniqueLock& lock, gocxx::sync::Cond& cond, Pred&& ready) {
+            const auto reason = &cond == &cond_send_ ? gocxx::runtime::WaitReason::ChanSend
+                                                     : gocxx::runtime::WaitReason::ChanRecv;
+            // Only operations that actually wait are timed.
+            if (detail::ChanCounters* stats = this->counters(); stats && !ready()) {
+                detail::BlockScope blocked(stats, &cond == &cond_send_ ? detail::WaitSide::Send
+                                                                       : detail::WaitSide::Recv);
+                detail::adaptiveWait(lock, cond, version_, policy_.get(), std::forward<Pred>(ready), reason);
+                return;
+            }
+            detail::adaptiveWait(lock, cond, version_, policy_.get(), std::forward<Pred>(ready), reason);
+        }
+
+        // Caller holds mutex_. Moves up to max queued values into out and
+        // wakes the senders that the freed slots can now admit.
+        std::size_t takeBuffered(std::vector<T>& out, std::size_t max) {
+            std::size_t n = std::min(max, queue_.size());
+            out.reserve(out.size() + n);
+            for (std::size_t i = 0; i < n; ++i) {
+                out.push_back(std::move(queue_.front()));
+                queue_.pop();
             }
+            if (n > 0) this->noteReceived(n);
+            if (n == 1) signal(cond_send_);
+            else if (n > 1) signal(cond_send_, true);
+            if (n > 0) sendQueue_.wake(n);
+            return n;
+        }
+
+        detail::WaitQueue& queueFor(detail::WaitSide side) {
+            return side == detail::WaitSide::Recv ? recvQueue_ : sendQueue_;
         }
 
         std::size_t bufferSize_;
@@ -355,6 +574,8 @@ namespace base {
 
         mutable gocxx::sync::Mutex mutex_;
         gocxx::sync::Cond cond_recv_, cond_send_;
+        std::atomic<std::uint64_t> version_{0};
+        detail::WaitPolicySlot policy_;
 
         // Unbuffered channel state
         std::optional<T> sendValue_;
@@ -364,10 +585,372 @@ namespace base {
         std::queue<T> queue_;
 
         // Select statement waiters
-        std::vector<std::pair<std::condition_variable*, bool*>> recvWaiters_;
-        std::vector<std::pair<std::condition_variable*, bool*>> sendWaiters_;
+        detail::WaitQueue recvQueue_;
+        detail::WaitQueue sendQueue_;
+    };
+
+    /**
+     * @class RingChanImpl
+     * @brief Buffered channel backed by a lock-free ring
+     * @tparam T The type of data transmitted through the channel
+     * @tparam Ring detail::MpmcRing<T> or detail::SpscRing<T>
+     *
+     * Sends and receives that find room (or data) in the ring complete with
+     * a handful of atomic operations and never touch a mutex. Threads only
+     * park on the internal mutex/condition pair when the ring is truly full
+     * or empty; the opposite side checks an atomic waiter count after every
+     * operation and takes the lock only when somebody is actually parked.
+     */
+    template<typename T, typename Ring>
+    class RingChanImpl : public IChan<T> {
+    public:
+        explicit RingChanImpl(std::size_t bufferSize) : ring_(bufferSize) {}
+
+        void send(T&& value) override {
+            InflightGuard guard(inflightSends_);
+            detail::BlockScope blocked;
+            for (;;) {
+                if (closed_.load(std::memory_order_acquire)) {
+                    throw std::runtime_error("send on closed channel");
+                }
+                if (ring_.tryPush(value)) {
+                    this->noteSent();
+                    wakeReceivers();
+                    return;
+                }
+
+                blocked.start(this->counters(), detail::WaitSide::Send);
+                if (detail::spinUntil(policy_.get(), [this] { return closed_.load(std::memory_order_acquire) || !ring_.fullApprox(); })) {
+                    continue;
+                }
+                detail::waitStats().parked.fetch_add(1, std::memory_order_relaxed);
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::ChanSend);
+                gocxx::sync::UniqueLock lock(parkMutex_);
+                parkedSenders_.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                // Re-check after announcing ourselves so a receiver that
+                // freed a slot either sees the counter or we see the slot.
+                while (!closed_.load(std::memory_order_acquire) && ring_.fullApprox()) {
+                    cond_send_.Wait(lock);
+                }
+                parkedSenders_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        std::optional<T> recv() override {
+            std::optional<T> out;
+            detail::BlockScope blocked;
+            for (;;) {
+                if (ring_.tryPop(out)) {
+                    this->noteReceived();
+                    wakeSenders();
+                    return out;
+                }
+                if (closed_.load(std::memory_order_acquire)) {
+                    return drainAfterClose();
+                }
+
+                blocked.start(this->counters(), detail::WaitSide::Recv);
+                if (detail::spinUntil(policy_.get(), [this] { return closed_.load(std::memory_order_acquire) || !ring_.emptyApprox(); })) {
+                    continue;
+                }
+                detail::waitStats().parked.fetch_add(1, std::memory_order_relaxed);
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::ChanRecv);
+                gocxx::sync::UniqueLock lock(parkMutex_);
+                parkedReceivers_.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while (!closed_.load(std::memory_order_acquire) && ring_.emptyApprox()) {
+                    cond_recv_.Wait(lock);
+                }
+                parkedReceivers_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        Result<void> trySend(T&& value) override {
+            InflightGuard guard(inflightSends_);
+            if (closed_.load(std::memory_order_acquire)) {
+                return Result<void>(ErrChanClosed);
+            }
+            if (!ring_.tryPush(value)) {
+                return Result<void>(ErrChanFull);
+            }
+            this->noteSent();
+            wakeReceivers();
+            return Result<void>();
+        }
+
+        Result<T> tryRecv() override {
+            std::optional<T> out;
+            if (ring_.tryPop(out)) {
+                this->noteReceived();
+                wakeSenders();
+                return Result<T>(std::move(*out));
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                out = drainAfterClose();
+                if (out) return Result<T>(std::move(*out));
+                return Result<T>(ErrChanClosed);
+            }
+            return Result<T>(ErrChanEmpty);
+        }
+
+        void close() override {
+            {
+                gocxx::sync::Lock lock(parkMutex_);
+                if (closed_.exchange(true, std::memory_order_acq_rel)) return;
+                this->noteClosed();
+                cond_recv_.NotifyAll();
+                cond_send_.NotifyAll();
+            }
+            gocxx::sync::Lock lock(waiterMutex_);
+            recvQueue_.wakeAll();
+            sendQueue_.wakeAll();
+            queuedWaiters_.store(0, std::memory_order_relaxed);
+        }
+
+        bool isClosed() const override {
+            return closed_.load(std::memory_order_acquire);
+        }
+
+        void enqueueWaiter(detail::WaitNode* node) override {
+            {
+                gocxx::sync::Lock lock(waiterMutex_);
+                if (node->queued) return;
+                node->source = this;
+                queueFor(node->side).push(node);
+                queuedWaiters_.fetch_add(1, std::memory_order_seq_cst);
+            }
+            // Pairs with the fence in wakeReceivers()/wakeSenders(): either the
+            // ring operation sees our node or the caller's re-poll sees the ring.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        void dequeueWaiter(detail::WaitNode* node) override {
+            gocxx::sync::Lock lock(waiterMutex_);
+            if (!node->queued) return;
+            queueFor(node->side).remove(node);
+            queuedWaiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void passWake(detail::WaitSide side) override {
+            wakeQueued(side, 1);
+        }
+
+        void setWaitPolicy(const WaitPolicy& policy) override {
+            policy_.set(policy);
+        }
+
+        bool canSend() const override {
+            return !closed_.load(std::memory_order_acquire) && !ring_.fullApprox();
+        }
+
+        std::size_t capacity() const override { return ring_.capacity(); }
+
+        bool canRecv() const override {
+            return !ring_.emptyApprox() || closed_.load(std::memory_order_acquire);
+        }
+
+        void sendBatch(T* items, std::size_t count) override {
+            InflightGuard guard(inflightSends_);
+            detail::BlockScope blocked;
+            std::size_t sent = 0;
+            while (sent < count) {
+                if (closed_.load(std::memory_order_acquire)) {
+                    throw std::runtime_error("send on closed channel");
+                }
+                std::size_t before = sent;
+                while (sent < count && ring_.tryPush(items[sent])) {
+                    ++sent;
+                }
+                if (sent != before) {
+                    this->noteSent(sent - before);
+                    wakeReceivers(sent - before);
+                    continue;
+                }
+
+                blocked.start(this->counters(), detail::WaitSide::Send);
+                if (detail::spinUntil(policy_.get(), [this] { return closed_.load(std::memory_order_acquire) || !ring_.fullApprox(); })) {
+                    continue;
+                }
+                detail::waitStats().parked.fetch_add(1, std::memory_order_relaxed);
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::ChanSend);
+                gocxx::sync::UniqueLock lock(parkMutex_);
+                parkedSenders_.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while (!closed_.load(std::memory_order_acquire) && ring_.fullApprox()) {
+                    cond_send_.Wait(lock);
+                }
+                parkedSenders_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        std::size_t recvBatch(std::vector<T>& out, std::size_t max) override {
+            if (max == 0) return 0;
+            detail::BlockScope blocked;
+            for (;;) {
+                std::size_t n = popInto(out, max);
+                if (n > 0) return n;
+                if (closed_.load(std::memory_order_acquire)) {
+                    auto last = drainAfterClose();
+                    if (!last) return 0;
+                    out.push_back(std::move(*last));
+                    return 1 + popInto(out, max - 1);
+                }
+
+                blocked.start(this->counters(), detail::WaitSide::Recv);
+                if (detail::spinUntil(policy_.get(), [this] { return closed_.load(std::memory_order_acquire) || !ring_.emptyApprox(); })) {
+                    continue;
+                }
+                detail::waitStats().parked.fetch_add(1, std::memory_order_relaxed);
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::ChanRecv);
+                gocxx::sync::UniqueLock lock(parkMutex_);
+                parkedReceivers_.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while (!closed_.load(std::memory_order_acquire) && ring_.emptyApprox()) {
+                    cond_recv_.Wait(lock);
+                }
+                parkedReceivers_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        std::size_t drain(std::vector<T>& out) override {
+            return popInto(out, static_cast<std::size_t>(-1));
+        }
+
+    private:
+        std::size_t popInto(std::vector<T>& out, std::size_t max) {
+            std::size_t n = 0;
+            std::optional<T> slot;
+            while (n < max && ring_.tryPop(slot)) {
+                out.push_back(std::move(*slot));
+                ++n;
+            }
+            if (n > 0) {
+                this->noteReceived(n);
+                wakeSenders(n);
+            }
+            return n;
+        }
+
+        // Counts senders between their closed-check and their push so that
+        // receivers observing "closed and empty" do not miss a value that
+        // is still being published.
+        struct InflightGuard {
+            explicit InflightGuard(std::atomic<int>& c) : c_(c) { c_.fetch_add(1, std::memory_order_seq_cst); }
+            ~InflightGuard() { c_.fetch_sub(1, std::memory_order_release); }
+            std::atomic<int>& c_;
+        };
+
+        std::optional<T> drainAfterClose() {
+            std::optional<T> out;
+            while (inflightSends_.load(std::memory_order_acquire) > 0) {
+                if (ring_.tryPop(out)) break;
+                std::this_thread::yield();
+            }
+            if (out || ring_.tryPop(out)) this->noteReceived();
+            return out;
+        }
+
+        // Wakes one parked thread per transferred element (all of them for
+        // a batch) and any select statements waiting on this side.
+        void wakeReceivers(std::size_t transferred = 1) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (parkedReceivers_.load(std::memory_order_relaxed) > 0) {
+                gocxx::sync::Lock lock(parkMutex_);
+                if (transferred == 1) cond_recv_.NotifyOne();
+                else cond_recv_.NotifyAll();
+            }
+            if (queuedWaiters_.load(std::memory_order_relaxed) > 0) {
+                wakeQueued(detail::WaitSide::Recv, transferred);
+            }
+        }
+
+        // Wakes one parked thread per transferred element (all of them for
+        // a batch) and any select statements waiting on this side.
+        void wakeSenders(std::size_t transferred = 1) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (parkedSenders_.load(std::memory_order_relaxed) > 0) {
+                gocxx::sync::Lock lock(parkMutex_);
+                if (transferred == 1) cond_send_.NotifyOne();
+                else cond_send_.NotifyAll();
+            }
+            if (queuedWaiters_.load(std::memory_order_relaxed) > 0) {
+                wakeQueued(detail::WaitSide::Send, transferred);
+            }
+        }
+
+        detail::WaitQueue& queueFor(detail::WaitSide side) {
+            return side == detail::WaitSide::Recv ? recvQueue_ : sendQueue_;
+        }
+
+        void wakeQueued(detail::WaitSide side, std::size_t count) {
+            gocxx::sync::Lock lock(waiterMutex_);
+            auto& queue = queueFor(side);
+            std::size_t before = queue.size();
+            queue.wake(count);
+            queuedWaiters_.fetch_sub(static_cast<int>(before - queue.size()), std::memory_order_relaxed);
+        }
+
+        Ring ring_;
+        detail::WaitPolicySlot policy_;
+        std::atomic<bool> closed_{false};
+        std::atomic<int> inflightSends_{0};
+
+        // Slow path: parked senders/receivers.
+        alignas(detail::kCacheLineSize) std::atomic<int> parkedSenders_{0};
+        std::atomic<int> parkedReceivers_{0};
+        std::atomic<int> queuedWaiters_{0};
+        gocxx::sync::Mutex parkMutex_;
+        gocxx::sync::Cond cond_recv_, cond_send_;
+
+        // Select statement waiters
+        gocxx::sync::Mutex waiterMutex_;
+        detail::WaitQueue recvQueue_;
+        detail::WaitQueue sendQueue_;
+    };
+
+    /**
+     * @brief Storage strategy used by a channel.
+     *
+     * - Locked: mutex-protected queue; works for every buffer size.
+     * - SPSC:   lock-free ring for exactly one sender and one receiver thread.
+     * - MPMC:   lock-free ring for any number of senders and receivers.
+     * - Auto:   MPMC ring for buffers of two or more elements, Locked otherwise.
+     *
+     * Ring backends need a buffer (SPSC >= 1, MPMC >= 2 slots); requests that
+     * cannot be honoured fall back to Locked.
+     */
+    enum class ChanBackend {
+        Auto,
+        Locked,
+        SPSC,
+        MPMC
     };
 
+    namespace detail {
+        template<typename T>
+        std::shared_ptr<IChan<T>> makeChanImpl(std::size_t bufferSize, ChanBackend backend) {
+            if constexpr (std::is_move_constructible_v<T>) {
+                switch (backend) {
+                case ChanBackend::Auto:
+                case ChanBackend::MPMC:
+                    if (bufferSize >= 2) {
+                        return std::make_shared<RingChanImpl<T, MpmcRing<T>>>(bufferSize);
+                    }
+                    break;
+                case ChanBackend::SPSC:
+                    if (bufferSize >= 1) {
+                        return std::make_shared<RingChanImpl<T, SpscRing<T>>>(bufferSize);
+                    }
+                    break;
+                case ChanBackend::Locked:
+                    break;
+                }
+            }
+            return std::make_shared<ChanImpl<T>>(bufferSize);
+        }
+    } // namespace detail
+
     /**
      * @class Chan
      * @brief Thread-safe channel for communication between threads
@@ -397,7 +980,14 @@ namespace base {
      * 
      * // Create a buffered channel
      * Chan<std::string> buffered_ch(5);
+     *
+     * // Single producer, single consumer: pick the SPSC ring explicitly
+     * Chan<int> pipe(1024, ChanBackend::SPSC);
      * @endcode
+     *
+     * @par Backends
+     * Buffered channels default to a lock-free MPMC ring (see ChanBackend);
+     * unbuffered channels always use the mutex-based rendezvous.
      * 
      * @par Thread Safety
      * All operations on Chan are thread-safe and can be called concurrently
@@ -406,12 +996,13 @@ namespace base {
     template<typename T>
     class Chan {
     public:
-        explicit Chan(std::size_t bufferSize = 0)
-            : impl_(std::make_shared<ChanImpl<T>>(bufferSize)) {}
+        explicit Chan(std::size_t bufferSize = 0, ChanBackend backend = ChanBackend::Auto)
+            : impl_(detail::makeChanImpl<T>(bufferSize, backend)) {}
 
         // Static factory method for Go-like syntax
-        static std::shared_ptr<Chan<T>> Make(std::size_t bufferSize = 0) {
-            return std::make_shared<Chan<T>>(bufferSize);
+        static std::shared_ptr<Chan<T>> Make(std::size_t bufferSize = 0,
+                                             ChanBackend backend = ChanBackend::Auto) {
+            return std::make_shared<Chan<T>>(bufferSize, backend);
         }
 
         void send(T&& value) { 
@@ -456,14 +1047,98 @@ namespace base {
             return impl_->canSend(); 
         }
 
-        bool canRecv() const { 
-            return impl_->canRecv(); 
+        bool canRecv() const {
+            return impl_->canRecv();
+        }
+
+        /**
+         * @brief Send a contiguous run of values, moving them out of @p items
+         * @throws std::runtime_error if the channel is closed
+         */
+        void sendBatch(T* items, std::size_t count) {
+            impl_->sendBatch(items, count);
+        }
+
+        /**
+         * @brief Send every value in [first, last), moving from the range
+         *
+         * Contiguous ranges (raw pointers, std::vector iterators) are handed to
+         * the channel directly; other ranges are gathered into a temporary
+         * vector first.
+         */
+        template<typename It>
+        void sendBatch(It first, It last) {
+            if constexpr (std::is_same_v<It, T*> ||
+                          std::is_same_v<It, typename std::vector<T>::iterator>) {
+                if (first != last) {
+                    impl_->sendBatch(&*first, static_cast<std::size_t>(last - first));
+                }
+            } else {
+                std::vector<T> items(std::make_move_iterator(first), std::make_move_iterator(last));
+                impl_->sendBatch(items.data(), items.size());
+            }
+        }
+
+        void sendBatch(std::vector<T>&& items) {
+            impl_->sendBatch(items.data(), items.size());
+        }
+
+        /**
+         * @brief Receive between 1 and @p max values, blocking only for the first
+         * @return Number of values appended to @p out; 0 once closed and drained
+         */
+        std::size_t recvBatch(std::vector<T>& out, std::size_t max) {
+            return impl_->recvBatch(out, max);
+        }
+
+        /**
+         * @brief Move all currently buffered values into @p out without blocking
+         * @return Number of values appended
+         */
+        std::size_t drain(std::vector<T>& out) {
+            return impl_->drain(out);
+        }
+
+        /**
+         * @brief Set how long blocked operations on this channel spin and
+         *        yield before parking (shared by all copies of the channel)
+         */
+        void setWaitPolicy(const WaitPolicy& policy) {
+            impl_->setWaitPolicy(policy);
+        }
+
+        /**
+         * @brief Start collecting statistics under @p name (see IChan::enableStats)
+         *
+         * Shared by all copies of the channel; the channel then shows up in
+         * ListChannels() until its last copy is destroyed.
+         */
+        void enableStats(std::string name) {
+            impl_->enableStats(std::move(name));
+        }
+
+        /// Counters of this channel; all zero unless enableStats() was called.
+        ChanStats stats() const {
+            return impl_->stats();
         }
 
         std::shared_ptr<IChan<T>> impl() const { 
             return impl_; 
         }
 
+        /// Borrow the backend without touching the shared_ptr refcount.
+        IChan<T>& implRef() const noexcept {
+            return *impl_;
+        }
+
+#if defined(GOCXX_HAS_COROUTINES)
+        /// `co_await ch.recvAsync()`: receive without blocking the thread (gocxx/coro).
+        coro::RecvAwaitable<T> recvAsync() const;
+
+        /// `co_await ch.sendAsync(v)`: send without blocking the thread (gocxx/coro).
+        coro::SendAwaitable<T> sendAsync(T value) const;
+#endif
+
     private:
         std::shared_ptr<IChan<T>> impl_;
     };
@@ -500,3 +1175,7 @@ namespace base {
 
 } // namespace base
 } // namespace gocxx
+
+#if defined(GOCXX_HAS_COROUTINES)
+#include <gocxx/coro/chan_awaitable.h>
+#endif
@@ -0,0 +1,246 @@
+/**
+ * @file chan_stats.h
+ * @brief Opt-in per-channel statistics and a registry of named channels
+ *
+ * Instrumentation is off by default; a channel only pays for one pointer
+ * load per operation until enableStats() is called on it. Enabled channels
+ * count traffic with relaxed atomics, track how long senders and receivers
+ * stay blocked (the equivalent of Go's block profile), and appear in
+ * ListChannels() under the name they were given.
+ */
+
+// gocxx/base/chan_stats.h
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <gocxx/base/detail/wait_queue.h>
+
+namespace gocxx::base {
+
+    /// Number of buckets in ChanStats::blockHistogram.
+    inline constexpr std::size_t kBlockHistogramBuckets = 24;
+
+    /**
+     * @brief Snapshot of one channel's counters.
+     *
+     * Blocking is measured from the moment an operation could not complete
+     * immediately until it did (spinning included), so it reflects what the
+     * caller experienced.
+     */
+    struct ChanStats {
+        std::string name;
+        std::size_t capacity = 0;            ///< Buffer size (0 = unbuffered)
+        std::size_t length = 0;              ///< Values sent but not yet received
+        std::size_t highWater = 0;           ///< Largest length observed
+        std::uint64_t sends = 0;             ///< Values sent
+        std::uint64_t recvs = 0;             ///< Values received
+        std::int64_t blockedSenders = 0;     ///< Senders blocked right now
+        std::int64_t blockedReceivers = 0;   ///< Receivers blocked right now
+        std::uint64_t sendBlocks = 0;        ///< Sends that had to wait
+        std::uint64_t recvBlocks = 0;        ///< Receives that had to wait
+        std::uint64_t sendBlockedNs = 0;     ///< Total time senders spent waiting
+        std::uint64_t recvBlockedNs = 0;     ///< Total time receivers spent waiting
+        bool closed = false;
+
+        /**
+         * @brief Wait-time distribution over both sides.
+         *
+         * Bucket 0 counts waits under 1us, bucket i waits in [2^(i-1), 2^i)
+         * microseconds; the last bucket also holds everything longer.
+         */
+        std::array<std::uint64_t, kBlockHistogramBuckets> blockHistogram{};
+
+        /// Exclusive upper bound of histogram bucket @p i in nanoseconds.
+        static std::uint64_t bucketUpperBoundNs(std::size_t i) {
+            return std::uint64_t{1000} << i;
+        }
+    };
+
+    namespace detail {
+
+        /**
+         * @brief Live counters behind ChanStats; shared with the registry.
+         */
+        class ChanCounters {
+        public:
+            ChanCounters(std::string name, std::size_t capacity)
+                : name_(std::move(name)), capacity_(capacity) {}
+
+            void recordSend(std::size_t n) {
+                sends_.fetch_add(n, std::memory_order_relaxed);
+                std::int64_t len = length_.fetch_add(static_cast<std::int64_t>(n), std::memory_order_relaxed) +
+                                   static_cast<std::int64_t>(n);
+                std::int64_t high = highWater_.load(std::memory_order_relaxed);
+                while (len > high &&
+                       !highWater_.compare_exchange_weak(high, len, std::memory_order_relaxed)) {
+                }
+            }
+
+            void recordRecv(std::size_t n) {
+                recvs_.fetch_add(n, std::memory_order_relaxed);
+                length_.fetch_sub(static_cast<std::int64_t>(n), std::memory_order_relaxed);
+            }
+
+            void recordClose() { closed_.store(true, std::memory_order_relaxed); }
+
+            void beginBlock(WaitSide side) {
+                blocked_[index(side)].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void endBlock(WaitSide side, std::chrono::nanoseconds waited) {
+                const std::size_t s = index(side);
+                const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(waited.count(), 0));
+                blocked_[s].fetch_sub(1, std::memory_order_relaxed);
+                blocks_[s].fetch_add(1, std::memory_order_relaxed);
+                blockedNs_[s].fetch_add(ns, std::memory_order_relaxed);
+                histogram_[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void rename(std::string name) {
+                std::lock_guard<std::mutex> lock(nameMutex_);
+                name_ = std::move(name);
+            }
+
+            ChanStats snapshot() const {
+                ChanStats s;
+                {
+                    std::lock_guard<std::mutex> lock(nameMutex_);
+                    s.name = name_;
+                }
+                s.capacity = capacity_;
+                s.length = static_cast<std::size_t>(std::max<std::int64_t>(length_.load(std::memory_order_relaxed), 0));
+                s.highWater = static_cast<std::size_t>(highWater_.load(std::memory_order_relaxed));
+                s.sends = sends_.load(std::memory_order_relaxed);
+                s.recvs = recvs_.load(std::memory_order_relaxed);
+                s.blockedSenders = blocked_[index(WaitSide::Send)].load(std::memory_order_relaxed);
+                s.blockedReceivers = blocked_[index(WaitSide::Recv)].load(std::memory_order_relaxed);
+                s.sendBlocks = blocks_[index(WaitSide::Send)].load(std::memory_order_relaxed);
+                s.recvBlocks = blocks_[index(WaitSide::Recv)].load(std::memory_order_relaxed);
+                s.sendBlockedNs = blockedNs_[index(WaitSide::Send)].load(std::memory_order_relaxed);
+                s.recvBlockedNs = blockedNs_[index(WaitSide::Recv)].load(std::memory_order_relaxed);
+                s.closed = closed_.load(std::memory_order_relaxed);
+                for (std::size_t i = 0; i < kBlockHistogramBuckets; ++i) {
+                    s.blockHistogram[i] = histogram_[i].load(std::memory_order_relaxed);
+                }
+                return s;
+            }
+
+            static std::size_t bucketFor(std::uint64_t ns) {
+                std::uint64_t us = ns / 1000;
+                std::size_t b = 0;
+                while (us) {
+                    ++b;
+                    us >>= 1;
+                }
+                return std::min(b, kBlockHistogramBuckets - 1);
+            }
+
+        private:
+            static std::size_t index(WaitSide side) { return side == WaitSide::Send ? 0 : 1; }
+
+            mutable std::mutex nameMutex_;
+            std::string name_;
+            const std::size_t capacity_;
+            std::atomic<std::uint64_t> sends_{0};
+            std::atomic<std::uint64_t> recvs_{0};
+            std::atomic<std::int64_t> length_{0};
+            std::atomic<std::int64_t> highWater_{0};
+            std::atomic<bool> closed_{false};
+            std::atomic<std::int64_t> blocked_[2] = {};
+            std::atomic<std::uint64_t> blocks_[2] = {};
+            std::atomic<std::uint64_t> blockedNs_[2] = {};
+            std::atomic<std::uint64_t> histogram_[kBlockHistogramBuckets] = {};
+        };
+
+        /**
+         * @brief Times one blocked operation; inert when stats are disabled.
+         *
+         * start() may be called on every retry; only the first call counts.
+         */
+        class BlockScope {
+        public:
+            BlockScope() = default;
+            BlockScope(ChanCounters* counters, WaitSide side) { start(counters, side); }
+
+            void start(ChanCounters* counters, WaitSide side) {
+                if (counters_ || !counters) return;
+                counters_ = counters;
+                side_ = side;
+                begin_ = std::chrono::steady_clock::now();
+                counters_->beginBlock(side_);
+            }
+
+            ~BlockScope() {
+                if (counters_) {
+                    counters_->endBlock(side_, std::chrono::steady_clock::now() - begin_);
+                }
+            }
+
+            BlockScope(const BlockScope&) = delete;
+            BlockScope& operator=(const BlockScope&) = delete;
+
+        private:
+            ChanCounters* counters_ = nullptr;
+            WaitSide side_ = WaitSide::Recv;
+            std::chrono::steady_clock::time_point begin_;
+        };
+
+        /**
+         * @brief Process-wide list of channels with statistics enabled.
+         */
+        class ChanRegistry {
+        public:
+            static ChanRegistry& instance() {
+                static ChanRegistry registry;
+                return registry;
+            }
+
+            void add(const std::shared_ptr<ChanCounters>& c) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                entries_.push_back(c);
+            }
+
+            void remove(const ChanCounters* c) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                              [c](const std::shared_ptr<ChanCounters>& e) { return e.get() == c; }),
+                               entries_.end());
+            }
+
+            std::vector<ChanStats> list() const {
+                std::vector<std::shared_ptr<ChanCounters>> copy;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    copy = entries_;
+                }
+                std::vector<ChanStats> out;
+                out.reserve(copy.size());
+                for (const auto& c : copy) out.push_back(c->snapshot());
+                std::stable_sort(out.begin(), out.end(),
+                                 [](const ChanStats& a, const ChanStats& b) { return a.name < b.name; });
+                return out;
+            }
+
+        private:
+            mutable std::mutex mutex_;
+            std::vector<std::shared_ptr<ChanCounters>> entries_;
+        };
+
+    } // namespace detail
+
+    /**
+     * @brief Statistics of every live channel that called enableStats(), sorted by name.
+     */
+    inline std::vector<ChanStats> ListChannels() {
+        return detail::ChanRegistry::instance().list();
+    }
+
+} // namespace gocxx::base
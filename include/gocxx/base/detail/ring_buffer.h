@@ -0,0 +1,215 @@
+/**
+ * @file ring_buffer.h
+ * @brief Bounded lock-free ring buffers backing buffered channels
+ *
+ * Two queues are provided: a Vyukov-style multi-producer/multi-consumer
+ * ring with per-slot sequence numbers, and a single-producer/single-consumer
+ * ring that only needs acquire/release ordering on its two indices. Both
+ * keep producer and consumer state on separate cache lines so a sender and
+ * a receiver never write to the same line on the fast path.
+ */
+
+// gocxx/base/detail/ring_buffer.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace gocxx::base::detail {
+
+    /// Assumed size of a destructive-interference region (cache line).
+    inline constexpr std::size_t kCacheLineSize = 64;
+
+    /**
+     * @brief Bounded MPMC queue (Dmitry Vyukov's sequence-number ring).
+     *
+     * Every slot carries a sequence number that tells producers and
+     * consumers whether the slot is free for the current lap. A push or pop
+     * is a single CAS on the shared index followed by a release store on the
+     * slot, so contended operations never lock. Requires capacity >= 2.
+     */
+    template<typename T>
+    class MpmcRing {
+    public:
+        explicit MpmcRing(std::size_t capacity)
+            : capacity_(capacity),
+              mask_(isPowerOfTwo(capacity) ? capacity - 1 : 0),
+              cells_(new Cell[capacity]) {
+            for (std::size_t i = 0; i < capacity_; ++i) {
+                cells_[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~MpmcRing() {
+            std::size_t head = dequeuePos_.load(std::memory_order_relaxed);
+            std::size_t tail = enqueuePos_.load(std::memory_order_relaxed);
+            for (; head != tail; ++head) {
+                std::launder(reinterpret_cast<T*>(cells_[index(head)].storage))->~T();
+            }
+        }
+
+        MpmcRing(const MpmcRing&) = delete;
+        MpmcRing& operator=(const MpmcRing&) = delete;
+
+        /**
+         * @brief Move @p value into the ring if a slot is free.
+         * @return false (leaving @p value untouched) when the ring is full
+         */
+        bool tryPush(T& value) {
+            std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells_[index(pos)];
+                std::size_t seq = cell.seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        ::new (static_cast<void*>(cell.storage)) T(std::move(value));
+                        cell.seq.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueuePos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Move the oldest element into @p out.
+         * @return false when the ring is empty
+         */
+        bool tryPop(std::optional<T>& out) {
+            std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells_[index(pos)];
+                std::size_t seq = cell.seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0) {
+                    if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        T* slot = std::launder(reinterpret_cast<T*>(cell.storage));
+                        out.emplace(std::move(*slot));
+                        slot->~T();
+                        cell.seq.store(pos + capacity_, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = dequeuePos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /// Approximate number of queued elements (exact when quiescent).
+        std::size_t sizeApprox() const {
+            std::size_t tail = enqueuePos_.load(std::memory_order_acquire);
+            std::size_t head = dequeuePos_.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+
+        bool emptyApprox() const { return sizeApprox() == 0; }
+        bool fullApprox() const { return sizeApprox() >= capacity_; }
+        std::size_t capacity() const { return capacity_; }
+
+    private:
+        // Cells stay dense: only the two indices get lines of their own.
+        // Neighbouring slots may share a line, but a producer and a consumer
+        // touch the same slot only when the ring is nearly empty or full.
+        struct Cell {
+            std::atomic<std::size_t> seq{0};
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        static bool isPowerOfTwo(std::size_t n) { return n != 0 && (n & (n - 1)) == 0; }
+
+        std::size_t index(std::size_t pos) const {
+            return mask_ ? (pos & mask_) : (pos % capacity_);
+        }
+
+        const std::size_t capacity_;
+        const std::size_t mask_;
+        std::unique_ptr<Cell[]> cells_;
+        alignas(kCacheLineSize) std::atomic<std::size_t> enqueuePos_{0};
+        alignas(kCacheLineSize) std::atomic<std::size_t> dequeuePos_{0};
+    };
+
+    /**
+     * @brief Bounded SPSC queue (Lamport ring with cached indices).
+     *
+     * Only one thread may push and only one thread may pop at a time. Each
+     * side keeps a private copy of the other side's index and refreshes it
+     * only when the ring looks full (or empty), so steady-state traffic
+     * touches shared state once per wrap instead of once per element.
+     */
+    template<typename T>
+    class SpscRing {
+    public:
+        explicit SpscRing(std::size_t capacity)
+            : capacity_(capacity), slots_(new Slot[capacity]) {}
+
+        ~SpscRing() {
+            std::size_t head = head_.load(std::memory_order_relaxed);
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            for (; head != tail; ++head) {
+                std::launder(reinterpret_cast<T*>(slots_[head % capacity_].storage))->~T();
+            }
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        bool tryPush(T& value) {
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cachedHead_ >= capacity_) {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                if (tail - cachedHead_ >= capacity_) return false;
+            }
+            ::new (static_cast<void*>(slots_[tail % capacity_].storage)) T(std::move(value));
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool tryPop(std::optional<T>& out) {
+            std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cachedTail_) {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                if (head == cachedTail_) return false;
+            }
+            T* slot = std::launder(reinterpret_cast<T*>(slots_[head % capacity_].storage));
+            out.emplace(std::move(*slot));
+            slot->~T();
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::size_t sizeApprox() const {
+            std::size_t tail = tail_.load(std::memory_order_acquire);
+            std::size_t head = head_.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+
+        bool emptyApprox() const { return sizeApprox() == 0; }
+        bool fullApprox() const { return sizeApprox() >= capacity_; }
+        std::size_t capacity() const { return capacity_; }
+
+    private:
+        struct Slot {
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        const std::size_t capacity_;
+        std::unique_ptr<Slot[]> slots_;
+        // Consumer-owned line: head plus the consumer's view of tail.
+        alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+        std::size_t cachedTail_ = 0;
+        // Producer-owned line: tail plus the producer's view of head.
+        alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+        std::size_t cachedHead_ = 0;
+    };
+
+} // namespace gocxx::base::detail
@@ -0,0 +1,188 @@
+/**
+ * @file wait_queue.h
+ * @brief Intrusive wait queues linking select statements to channels
+ *
+ * Modelled on Go's sudog: a select that has to block links one WaitNode per
+ * case into the corresponding channel's queue. All nodes of one select share
+ * a Waiter. When a channel makes progress it pops nodes until one Waiter
+ * accepts the wakeup, so exactly one select is woken per value instead of
+ * every registered waiter. Nodes live in the selecting frame and unlink in
+ * O(1), so no memory is allocated and nothing is scanned.
+ */
+
+// gocxx/base/detail/wait_queue.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <gocxx/base/wait_policy.h>
+
+namespace gocxx::base::detail {
+
+    struct WaitNode;
+
+    /// Which side of a channel a node waits for.
+    enum class WaitSide { Recv, Send };
+
+    /**
+     * @brief Something a WaitNode can be queued on (a channel backend).
+     *
+     * passWake() hands a wakeup that its recipient decided not to use on to
+     * the next waiter on the same side, so progress is never lost.
+     */
+    class WaitSource {
+    public:
+        virtual void passWake(WaitSide side) = 0;
+    protected:
+        ~WaitSource() = default;
+    };
+
+    /**
+     * @brief The party that blocks on one or more WaitNodes.
+     *
+     * The first channel to claim the waiter (tryWake) wins; later attempts
+     * fail until the owner calls rearm(). Subclasses decide what waking
+     * means — signal a thread, resume a coroutine, ...
+     */
+    class Waiter {
+    public:
+        /**
+         * @brief Claim this waiter for @p node (called with the channel's lock held).
+         * @return false if another node already woke it
+         */
+        bool tryWake(WaitNode* node) {
+            WaitNode* expected = nullptr;
+            if (!fired_.compare_exchange_strong(expected, node, std::memory_order_acq_rel)) {
+                return false;
+            }
+            onWake();
+            return true;
+        }
+
+        /// Node that woke this waiter, or nullptr.
+        WaitNode* fired() const { return fired_.load(std::memory_order_acquire); }
+
+        /// Allow the next wakeup (owner only, before re-registering).
+        void rearm() { fired_.store(nullptr, std::memory_order_release); }
+
+    protected:
+        ~Waiter() = default;
+        virtual void onWake() = 0;
+
+    private:
+        std::atomic<WaitNode*> fired_{nullptr};
+    };
+
+    /**
+     * @brief Waiter that blocks the calling thread (spin, yield, then park).
+     */
+    class ThreadWaiter final : public Waiter {
+    public:
+        /// Block until some node claims this waiter; returns that node.
+        WaitNode* wait(const WaitPolicy& policy,
+                       gocxx::runtime::WaitReason reason = gocxx::runtime::WaitReason::Select) {
+            if (WaitNode* n = fired()) return n;
+            if (spinUntil(policy, [this] { return fired() != nullptr; })) return fired();
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (fired() == nullptr) {
+                waitStats().parked.fetch_add(1, std::memory_order_relaxed);
+                gocxx::runtime::BlockingRegion blocking(reason);
+                cv_.wait(lock, [this] { return fired() != nullptr; });
+            }
+            return fired();
+        }
+
+    private:
+        void onWake() override {
+            // Taking the mutex orders this notify after the waiter's final
+            // check, which is what makes the handshake lossless.
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_one();
+        }
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+    };
+
+    /**
+     * @brief One case's entry in a channel wait queue.
+     *
+     * prev/next/queued are guarded by the lock of the channel the node is
+     * queued on.
+     */
+    struct WaitNode {
+        WaitNode* prev = nullptr;
+        WaitNode* next = nullptr;
+        bool queued = false;
+        Waiter* waiter = nullptr;
+        WaitSource* source = nullptr;
+        WaitSide side = WaitSide::Recv;
+        std::size_t caseIndex = 0;
+    };
+
+    /**
+     * @brief Intrusive FIFO of WaitNodes; the owner provides the locking.
+     */
+    class WaitQueue {
+    public:
+        bool empty() const { return head_ == nullptr; }
+        std::size_t size() const { return size_; }
+
+        void push(WaitNode* n) {
+            n->prev = tail_;
+            n->next = nullptr;
+            if (tail_) tail_->next = n;
+            else head_ = n;
+            tail_ = n;
+            n->queued = true;
+            ++size_;
+        }
+
+        /// O(1) removal; a no-op if @p n is not queued.
+        void remove(WaitNode* n) {
+            if (!n->queued) return;
+            if (n->prev) n->prev->next = n->next;
+            else head_ = n->next;
+            if (n->next) n->next->prev = n->prev;
+            else tail_ = n->prev;
+            n->prev = n->next = nullptr;
+            n->queued = false;
+            --size_;
+        }
+
+        WaitNode* pop() {
+            WaitNode* n = head_;
+            if (n) remove(n);
+            return n;
+        }
+
+        /**
+         * @brief Wake up to @p count waiters, skipping ones already claimed elsewhere.
+         * @return Number of waiters actually woken
+         */
+        std::size_t wake(std::size_t count = 1) {
+            std::size_t woken = 0;
+            while (woken < count) {
+                WaitNode* n = pop();
+                if (!n) break;
+                if (n->waiter->tryWake(n)) ++woken;
+            }
+            return woken;
+        }
+
+        /// Wake every queued waiter (channel close).
+        void wakeAll() {
+            while (WaitNode* n = pop()) {
+                n->waiter->tryWake(n);
+            }
+        }
+
+    private:
+        WaitNode* head_ = nullptr;
+        WaitNode* tail_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+} // namespace gocxx::base::detail
@@ -22,7 +22,9 @@ namespace gocxx::base {
 template <typename T>
 struct Result {
     T value{};  ///< The result value (may be default-initialized).
-    std::shared_ptr<gocxx::errors::Error> err;  ///< Error, if any.
+    /// Error, if any. Null on success; sentinel errors (errors::Sentinel) are
+    /// non-owning, so copying a Result that carries one does no atomic work.
+    std::shared_ptr<gocxx::errors::Error> err;
 
     /// @brief Constructs a Result with a value and no error.
     /// This is the success case, similar to Go's `return value, nil`.
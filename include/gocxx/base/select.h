@@ -9,6 +9,9 @@
 #include <functional>
 #include <optional>
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <gocxx/base/chan.h>
 #include <gocxx/base/defer.h>
 
@@ -17,6 +20,18 @@ namespace base {
 
     class Select;
 
+    namespace detail {
+        /// xorshift64 per thread; only used to randomise case polling order.
+        inline std::uint32_t fastRand() {
+            thread_local std::uint64_t state =
+                0x9E3779B97F4A7C15ull ^ reinterpret_cast<std::uintptr_t>(&state);
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return static_cast<std::uint32_t>(state >> 32);
+        }
+    } // namespace detail
+
     /**
      * Abstract base class for select cases.
      * Each case represents a channel operation that can be selected.
@@ -44,8 +59,22 @@ namespace base {
          */
         virtual void execute() = 0;
 
+        /**
+         * Execute the case only if it can complete without blocking.
+         * Unlike execute(), a case that lost a race for its channel returns
+         * false instead of blocking, so the select can go back to waiting.
+         * @return true if the case ran
+         */
+        virtual bool tryExecute() {
+            if (!isReady()) return false;
+            execute();
+            return true;
+        }
+
         /**
          * Register this case with a Select instance.
+         * Links the case's wait node into its channel; calling it again while
+         * the node is still queued is a no-op.
          * @param sel The Select instance to register with
          */
         virtual void registerWith(Select* sel) = 0;
@@ -67,20 +96,30 @@ namespace base {
          */
         size_t getCaseId() const { return caseId_; }
 
+        /**
+         * Position of this case in its Select (set by Select::addCase).
+         */
+        size_t getIndex() const { return index_; }
+        void setIndex(size_t index) { index_ = index; }
+
     private:
+        size_t index_ = 0;
         size_t caseId_;
-        static std::atomic<size_t> nextCaseId_;
+        inline static std::atomic<size_t> nextCaseId_{1};
     };
 
-    std::atomic<size_t> SelectCase::nextCaseId_{1};
-
     /**
      * Select implementation that mirrors Go's select statement.
      * Allows waiting on multiple channel operations simultaneously.
+     *
+     * While blocked, each case has one node linked into its channel's wait
+     * queue. A channel wakes exactly one waiting select per unit of progress;
+     * a select that was woken for a case it ends up not taking hands the
+     * wakeup on to the next waiter on that channel.
      */
     class Select {
     public:
-        Select() : done_(false), ready_(false), selectId_(nextSelectId_.fetch_add(1, std::memory_order_relaxed)) {}
+        Select() : selectId_(nextSelectId_.fetch_add(1, std::memory_order_relaxed)) {}
 
         ~Select() {
             // Ensure cleanup happens even if run() wasn't called
@@ -99,6 +138,7 @@ namespace base {
          */
         void addCase(std::unique_ptr<SelectCase> sc) {
             if (sc) {
+                sc->setIndex(cases_.size());
                 cases_.push_back(std::move(sc));
             }
         }
@@ -108,139 +148,176 @@ namespace base {
          * This will block until one of the cases can proceed.
          */
         void run() {
-            std::unique_lock<std::mutex> lock(mutex_);
-
-            // Register all cases with their respective channels
-            for (auto& c : cases_) {
-                c->registerWith(this);
-            }
-
             // Use RAII to ensure cleanup
             auto cleanup_guard = [this]() { this->cleanup(); };
             defer(cleanup_guard);
 
-            while (true) {
-                // Check for immediately ready cases
-                std::vector<size_t> readyIndices;
-                bool hasDefaultCase = false;
-                size_t defaultCaseIndex = 0;
-                
-                for (size_t i = 0; i < cases_.size(); ++i) {
-                    if (cases_[i]->getType() == "DefaultCase") {
-                        hasDefaultCase = true;
-                        defaultCaseIndex = i;
-                    } else if (cases_[i]->isReady()) {
-                        readyIndices.push_back(i);
-                    }
-                }
+            prepare();
+            while (!pollOnce()) {
+                // Block until a channel claims us (spinning first, per policy)
+                waiter_.wait(policy_.get());
+                if (tryFired()) return;
+                // Lost the race (or woken by notify()); re-evaluate all cases
+            }
+        }
 
-                // If non-default cases are ready, execute one randomly and return
-                if (!readyIndices.empty()) {
-                    executeRandomCase(readyIndices);
-                    return;
-                }
+        /**
+         * Wake the select so it re-evaluates its cases.
+         * Channels wake selects through their wait queues; this is only
+         * needed for external conditions.
+         */
+        void notify() {
+            activeWaiter_->tryWake(&externalNode_);
+        }
 
-                // If no cases are ready and we have a default case, execute it
-                if (hasDefaultCase) {
-                    cases_[defaultCaseIndex]->execute();
-                    return;
-                }
+        /**
+         * Get the waiter shared by this select's channel wait nodes.
+         * @return Pointer to the waiter cases register (internal use)
+         */
+        detail::Waiter* waiter() { return activeWaiter_; }
+
+        /**
+         * Get the unique select ID.
+         * @return The unique identifier for this select instance
+         */
+        size_t getSelectId() const { return selectId_; }
 
-                // Reset flags before waiting
-                ready_ = false;
-                done_.store(false, std::memory_order_release);
+        /**
+         * Override the spin/yield budget used before the select parks.
+         * @param policy Policy to use instead of DefaultWaitPolicy()
+         */
+        void setWaitPolicy(const WaitPolicy& policy) { policy_.set(policy); }
 
-                // Wait for notification with proper spurious wakeup protection
-                cv_.wait(lock, [this] { 
-                    return done_.load(std::memory_order_acquire) || ready_; 
-                });
+        /**
+         * @name Stepwise execution (internal use)
+         * run() is built from these; coroutine awaitables drive the same
+         * steps with their own Waiter instead of blocking the thread.
+         * @{
+         */
 
-                // After waking up, check again for ready cases
-                // The loop will continue and re-evaluate all cases
+        /// Locate the default case and route wakeups to @p w (the thread waiter by default).
+        void prepare(detail::Waiter* w = nullptr) {
+            activeWaiter_ = w ? w : &waiter_;
+            hasDefaultCase_ = false;
+            for (size_t i = 0; i < cases_.size(); ++i) {
+                if (cases_[i]->getType() == "DefaultCase") {
+                    hasDefaultCase_ = true;
+                    defaultCaseIndex_ = i;
+                }
             }
+            readyIndices_.reserve(cases_.size());
         }
 
         /**
-         * Notify the select that a case may be ready.
-         * This is called by channels when they become available.
+         * Arm, register and poll once.
+         * @return true if a case (or the default) ran
          */
-        void notify() {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (!done_.load(std::memory_order_relaxed)) {
-                ready_ = true;
-                done_.store(true, std::memory_order_release);
-                cv_.notify_one();
+        bool pollOnce() {
+            // Arm before polling: progress made after the poll is then
+            // guaranteed to find our nodes in the channel queues.
+            activeWaiter_->rearm();
+            if (!hasDefaultCase_) {
+                for (auto& c : cases_) {
+                    c->registerWith(this);
+                }
+            }
+
+            // Check for immediately ready cases
+            readyIndices_.clear();
+            for (size_t i = 0; i < cases_.size(); ++i) {
+                if ((!hasDefaultCase_ || i != defaultCaseIndex_) && cases_[i]->isReady()) {
+                    readyIndices_.push_back(i);
+                }
+            }
+
+            // If non-default cases are ready, execute one randomly
+            if (!readyIndices_.empty() && executeRandomCase(readyIndices_)) {
+                return true;
+            }
+
+            // If no cases are ready and we have a default case, execute it
+            if (hasDefaultCase_) {
+                cases_[defaultCaseIndex_]->execute();
+                return true;
             }
+            return false;
         }
 
         /**
-         * Get the condition variable for channel registration.
-         * @return Pointer to the internal condition variable
+         * After a wakeup, try the case whose channel woke us.
+         * @return true if it ran
          */
-        std::condition_variable* cv() { return &cv_; }
+        bool tryFired() {
+            detail::WaitNode* fired = activeWaiter_->fired();
+            if (fired && fired->source && fired->caseIndex < cases_.size()) {
+                if (cases_[fired->caseIndex]->tryExecute()) {
+                    executed_ = fired->caseIndex;
+                    return true;
+                }
+            }
+            return false;
+        }
 
-        /**
-         * Get the ready flag for channel registration.
-         * @return Pointer to the internal ready flag
-         */
-        bool* readyFlag() { return &ready_; }
+        /// Unregister every case and pass on an unused wakeup.
+        void finish() { cleanup(); }
 
-        /**
-         * Get the unique select ID.
-         * @return The unique identifier for this select instance
-         */
-        size_t getSelectId() const { return selectId_; }
+        /** @} */
 
     private:
+        static constexpr size_t kNone = static_cast<size_t>(-1);
+
         /**
          * Clean up all cases by unregistering them.
          */
         void cleanup() {
-            // Signal that select is done to prevent further notifications
-            done_.store(true, std::memory_order_release);
-            
             for (auto& c : cases_) {
                 if (c) {
                     c->unregister();
                 }
             }
+
+            // A wakeup we were handed but did not use belongs to somebody else
+            detail::WaitNode* fired = activeWaiter_->fired();
+            if (fired && fired->source && fired->caseIndex != executed_) {
+                fired->source->passWake(fired->side);
+            }
+            activeWaiter_->rearm();
+            activeWaiter_ = &waiter_;
+            executed_ = kNone;
         }
 
         /**
          * Execute a randomly selected case from the ready cases.
          * @param readyIndices Vector of indices of ready cases
+         * @return false if every ready case lost its race
          */
-        void executeRandomCase(const std::vector<size_t>& readyIndices) {
-            if (readyIndices.empty()) return;
-
-            size_t selectedIndex;
-            if (readyIndices.size() == 1) {
-                selectedIndex = readyIndices[0];
-            } else {
-                // Use thread-local random number generator for performance
-                static thread_local std::random_device rd;
-                static thread_local std::mt19937 gen(rd());
-                std::uniform_int_distribution<size_t> dist(0, readyIndices.size() - 1);
-                size_t randomIdx = dist(gen);
-                selectedIndex = readyIndices[randomIdx];
-            }
-
-            if (selectedIndex < cases_.size() && cases_[selectedIndex]) {
-                cases_[selectedIndex]->execute();
+        bool executeRandomCase(std::vector<size_t>& readyIndices) {
+            while (!readyIndices.empty()) {
+                size_t pick = readyIndices.size() == 1
+                    ? 0 : detail::fastRand() % readyIndices.size();
+                size_t selectedIndex = readyIndices[pick];
+                if (cases_[selectedIndex]->tryExecute()) {
+                    executed_ = selectedIndex;
+                    return true;
+                }
+                readyIndices.erase(readyIndices.begin() + static_cast<std::ptrdiff_t>(pick));
             }
+            return false;
         }
 
         std::vector<std::unique_ptr<SelectCase>> cases_;
-        std::atomic<bool> done_;
-        std::mutex mutex_;
-        std::condition_variable cv_;
-        bool ready_;
+        detail::ThreadWaiter waiter_;
+        detail::Waiter* activeWaiter_ = &waiter_;
+        detail::WaitNode externalNode_;
+        size_t executed_ = kNone;
+        bool hasDefaultCase_ = false;
+        size_t defaultCaseIndex_ = 0;
+        std::vector<size_t> readyIndices_;
+        detail::WaitPolicySlot policy_;
         size_t selectId_;
-        static std::atomic<size_t> nextSelectId_;
+        inline static std::atomic<size_t> nextSelectId_{1};
     };
 
-    std::atomic<size_t> Select::nextSelectId_{1};
-
     /**
      * Case for receiving from a channel.
      */
@@ -280,15 +357,17 @@ namespace base {
         }
 
         void registerWith(Select* sel) override {
+            if (!sel) return;
             sel_ = sel;
-            if (sel && sel->cv()) {
-                chan_.impl()->registerRecvWaiter(sel->cv(), sel->readyFlag());
-            }
+            node_.waiter = sel->waiter();
+            node_.side = detail::WaitSide::Recv;
+            node_.caseIndex = getIndex();
+            chan_.implRef().enqueueWaiter(&node_);
         }
 
         void unregister() override {
-            if (sel_ && sel_->cv()) {
-                chan_.impl()->unregisterRecvWaiter(sel_->cv());
+            if (sel_) {
+                chan_.implRef().dequeueWaiter(&node_);
                 sel_ = nullptr;
             }
         }
@@ -297,10 +376,24 @@ namespace base {
             return "RecvCase";
         }
 
+        bool tryExecute() override {
+            auto result = chan_.tryRecv();
+            if (result.Ok()) {
+                fn_(std::move(result.value));
+                return true;
+            }
+            if (chan_.isClosed()) {
+                fn_(std::nullopt);
+                return true;
+            }
+            return false;
+        }
+
     private:
         Chan<T>& chan_;
         std::function<void(std::optional<T>)> fn_;
         Select* sel_;
+        detail::WaitNode node_;
     };
 
     /**
@@ -328,15 +421,17 @@ namespace base {
         }
 
         void registerWith(Select* sel) override {
+            if (!sel) return;
             sel_ = sel;
-            if (sel && sel->cv()) {
-                chan_.impl()->registerSendWaiter(sel->cv(), sel->readyFlag());
-            }
+            node_.waiter = sel->waiter();
+            node_.side = detail::WaitSide::Send;
+            node_.caseIndex = getIndex();
+            chan_.implRef().enqueueWaiter(&node_);
         }
 
         void unregister() override {
-            if (sel_ && sel_->cv()) {
-                chan_.impl()->unregisterSendWaiter(sel_->cv());
+            if (sel_) {
+                chan_.implRef().dequeueWaiter(&node_);
                 sel_ = nullptr;
             }
         }
@@ -345,11 +440,25 @@ namespace base {
             return "SendCase";
         }
 
+        bool tryExecute() override {
+            T valueCopy = value_;
+            if (chan_.trySend(std::move(valueCopy)).Ok()) {
+                fn_(true);
+                return true;
+            }
+            if (chan_.isClosed()) {
+                fn_(false);
+                return true;
+            }
+            return false;
+        }
+
     private:
         Chan<T>& chan_;
         T value_;
         std::function<void(bool)> fn_;
         Select* sel_;
+        detail::WaitNode node_;
     };
 
     /**
@@ -408,26 +517,263 @@ namespace base {
         return std::make_unique<SendCase<T>>(ch, std::move(val), std::move(fn));
     }
 
+    // =================== STATIC (ALLOCATION-FREE) SELECT ===================
+
+    /**
+     * Receive case for the compile-time select; created by recvCase().
+     * Holds the channel by reference and the callback by value, so the whole
+     * case lives on the caller's stack.
+     */
+    template<typename T, typename F>
+    struct RecvOp {
+        Chan<T>& chan;
+        F fn;
+
+        bool ready() const { return chan.canRecv(); }
+
+        // Returns false if another receiver won the race for the value.
+        bool tryExecute() {
+            auto result = chan.tryRecv();
+            if (result.Ok()) {
+                fn(std::optional<T>(std::move(result.value)));
+                return true;
+            }
+            if (chan.isClosed()) {
+                fn(std::optional<T>());
+                return true;
+            }
+            return false;
+        }
+
+        static constexpr detail::WaitSide side = detail::WaitSide::Recv;
+        void arm(detail::WaitNode& node) { chan.implRef().enqueueWaiter(&node); }
+        void disarm(detail::WaitNode& node) { chan.implRef().dequeueWaiter(&node); }
+    };
+
+    /**
+     * Send case for the compile-time select; created by sendCase().
+     * The callback receives true on success and false if the channel was
+     * closed.
+     */
+    template<typename T, typename F>
+    struct SendOp {
+        Chan<T>& chan;
+        T value;
+        F fn;
+
+        bool ready() const { return chan.canSend() || chan.isClosed(); }
+
+        bool tryExecute() {
+            if (chan.isClosed()) {
+                fn(false);
+                return true;
+            }
+            // Channel backends only move from the argument on success
+            if (chan.trySend(std::move(value)).Ok()) {
+                fn(true);
+                return true;
+            }
+            return false;
+        }
+
+        static constexpr detail::WaitSide side = detail::WaitSide::Send;
+        void arm(detail::WaitNode& node) { chan.implRef().enqueueWaiter(&node); }
+        void disarm(detail::WaitNode& node) { chan.implRef().dequeueWaiter(&node); }
+    };
+
+    /**
+     * Default case; created by defaultCase().
+     * Also converts to a heap-allocated DefaultCase so it can be passed to
+     * the dynamic Select alongside recv()/send() cases.
+     */
+    template<typename F>
+    struct DefaultOp {
+        F fn;
+
+        operator std::unique_ptr<SelectCase>() && {
+            return std::make_unique<DefaultCase>(std::function<void()>(std::move(fn)));
+        }
+
+        operator std::unique_ptr<DefaultCase>() && {
+            return std::make_unique<DefaultCase>(std::function<void()>(std::move(fn)));
+        }
+    };
+
+    namespace detail {
+
+        template<typename C> struct IsRecvOp : std::false_type {};
+        template<typename T, typename F> struct IsRecvOp<RecvOp<T, F>> : std::true_type {};
+        template<typename C> struct IsSendOp : std::false_type {};
+        template<typename T, typename F> struct IsSendOp<SendOp<T, F>> : std::true_type {};
+        template<typename C> struct IsDefaultOp : std::false_type {};
+        template<typename F> struct IsDefaultOp<DefaultOp<F>> : std::true_type {};
+
+        template<typename C>
+        inline constexpr bool isStaticCase =
+            IsRecvOp<C>::value || IsSendOp<C>::value || IsDefaultOp<C>::value;
+
+        // Like defer, but without std::function so it cannot allocate.
+        template<typename F>
+        struct ScopeExit {
+            F& fn;
+            ~ScopeExit() { fn(); }
+        };
+
+        template<typename... Cs>
+        bool tryExecuteAt(std::size_t index, Cs&... cs) {
+            std::size_t i = 0;
+            bool done = false;
+            auto visit = [&](auto& c) {
+                if constexpr (!IsDefaultOp<std::decay_t<decltype(c)>>::value) {
+                    if (i == index) done = c.tryExecute();
+                }
+                ++i;
+            };
+            (visit(cs), ...);
+            return done;
+        }
+
+        template<typename... Cs>
+        void runStaticSelect(const WaitPolicy& policy, Cs&... cs) {
+            constexpr std::size_t N = sizeof...(Cs);
+            constexpr std::size_t defaults = (std::size_t{0} + ... + IsDefaultOp<Cs>::value);
+            static_assert(defaults <= 1, "select: at most one default case");
+
+            // Random permutation of the channel cases (Go's pollorder): the
+            // first ready case in this order is uniform among ready cases.
+            std::array<std::uint8_t, N> order{};
+            std::size_t count = 0;
+            {
+                std::size_t i = 0;
+                auto add = [&](auto& c) {
+                    if constexpr (!IsDefaultOp<std::decay_t<decltype(c)>>::value) {
+                        order[count++] = static_cast<std::uint8_t>(i);
+                    }
+                    ++i;
+                };
+                (add(cs), ...);
+            }
+            for (std::size_t i = count; i > 1; --i) {
+                std::swap(order[i - 1], order[fastRand() % i]);
+            }
+
+            auto pollOnce = [&]() {
+                for (std::size_t k = 0; k < count; ++k) {
+                    if (tryExecuteAt(order[k], cs...)) return true;
+                }
+                return false;
+            };
+
+            if (pollOnce()) return;
+
+            if constexpr (defaults == 1) {
+                auto runDefault = [](auto& c) {
+                    if constexpr (IsDefaultOp<std::decay_t<decltype(c)>>::value) c.fn();
+                };
+                (runDefault(cs), ...);
+                return;
+            } else {
+                ThreadWaiter waiter;
+                std::array<WaitNode, N> nodes{};
+                {
+                    std::size_t i = 0;
+                    auto init = [&](auto& c) {
+                        nodes[i].waiter = &waiter;
+                        nodes[i].side = std::decay_t<decltype(c)>::side;
+                        nodes[i].caseIndex = i;
+                        ++i;
+                    };
+                    (init(cs), ...);
+                }
+
+                std::size_t executed = N;
+                auto armAll = [&] {
+                    std::size_t i = 0;
+                    ((cs.arm(nodes[i++])), ...);
+                };
+                auto finish = [&] {
+                    std::size_t i = 0;
+                    ((cs.disarm(nodes[i++])), ...);
+                    // Hand on a wakeup that was meant for a case we did not take
+                    WaitNode* fired = waiter.fired();
+                    if (fired && fired->caseIndex != executed) {
+                        fired->source->passWake(fired->side);
+                    }
+                };
+                ScopeExit<decltype(finish)> guard{finish};
+
+                for (;;) {
+                    waiter.rearm();
+                    armAll();
+                    for (std::size_t k = 0; k < count; ++k) {
+                        if (tryExecuteAt(order[k], cs...)) {
+                            executed = order[k];
+                            return;
+                        }
+                    }
+                    WaitNode* fired = waiter.wait(policy);
+                    if (tryExecuteAt(fired->caseIndex, cs...)) {
+                        executed = fired->caseIndex;
+                        return;
+                    }
+                }
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * Receive case for the allocation-free select.
+     * @param ch The channel to receive from
+     * @param fn Callable invoked with std::optional<T> (nullopt if closed)
+     */
+    template<typename T, typename F>
+    RecvOp<T, std::decay_t<F>> recvCase(Chan<T>& ch, F&& fn) {
+        return RecvOp<T, std::decay_t<F>>{ch, std::forward<F>(fn)};
+    }
+
+    /**
+     * Send case for the allocation-free select.
+     * @param ch The channel to send to
+     * @param val The value to send
+     * @param fn Callable invoked with true on success, false if the channel is closed
+     */
+    template<typename T, typename U, typename F>
+    SendOp<T, std::decay_t<F>> sendCase(Chan<T>& ch, U&& val, F&& fn) {
+        return SendOp<T, std::decay_t<F>>{ch, T(std::forward<U>(val)), std::forward<F>(fn)};
+    }
+
     /**
      * Create a default case for a select statement.
+     * Works with both the allocation-free select (recvCase/sendCase) and the
+     * dynamic one (recv/send), where it converts to a DefaultCase.
      * @param fn Function to call if no other cases are ready
-     * @return Unique pointer to the created case
      */
-    inline std::unique_ptr<DefaultCase> defaultCase(std::function<void()> fn) {
-        return std::make_unique<DefaultCase>(std::move(fn));
+    template<typename F>
+    DefaultOp<std::decay_t<F>> defaultCase(F&& fn) {
+        return DefaultOp<std::decay_t<F>>{std::forward<F>(fn)};
     }
 
     /**
      * Execute a select statement with the given cases.
      * This is the main entry point that mimics Go's select statement.
+     *
+     * When every argument comes from recvCase(), sendCase() or defaultCase(),
+     * the cases stay on the stack, polling order comes from a fixed-size
+     * array and a thread-local PRNG, and nothing is heap allocated. Otherwise
+     * the cases are collected into a dynamic Select.
      * @param cs Variable number of case arguments
      */
     template<typename... Cases>
     void select(Cases&&... cs) {
-        Select sel;
-        (sel.addCase(std::forward<Cases>(cs)), ...);
-        sel.run();
+        if constexpr (sizeof...(Cases) > 0 && (detail::isStaticCase<std::decay_t<Cases>> && ...)) {
+            detail::runStaticSelect(DefaultWaitPolicy(), cs...);
+        } else {
+            Select sel;
+            (sel.addCase(std::forward<Cases>(cs)), ...);
+            sel.run();
+        }
     }
 
 } // namespace base
-} // namespace gocxx
\ No newline at end of file
+} // namespace gocxx
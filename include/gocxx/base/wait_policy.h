@@ -0,0 +1,217 @@
+/**
+ * @file wait_policy.h
+ * @brief Adaptive spin-then-yield-then-park waiting for channels and select
+ *
+ * A blocked channel operation or select first spins for a bounded number of
+ * iterations (issuing a CPU pause hint), then yields its time slice a few
+ * times, and only then parks on a condition variable. When both sides of a
+ * handoff are running on different cores the wait usually resolves during
+ * the spin phase and the futex round trip is avoided entirely.
+ */
+
+// gocxx/base/wait_policy.h
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <gocxx/runtime/blocking.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace gocxx::base {
+
+    /**
+     * @brief How long a blocked operation busy-waits before parking.
+     *
+     * Setting both counts to zero restores pure blocking behaviour.
+     */
+    struct WaitPolicy {
+        std::uint32_t spinIterations = 0;   ///< Pause-loop iterations before yielding
+        std::uint32_t yieldIterations = 0;  ///< std::this_thread::yield() calls before parking
+
+        /// Park immediately; never spin or yield.
+        static constexpr WaitPolicy Park() { return WaitPolicy{0, 0}; }
+
+        /// Built-in default: spin only when there is more than one hardware thread.
+        static WaitPolicy Adaptive() {
+            static const bool multiCore = std::thread::hardware_concurrency() > 1;
+            return multiCore ? WaitPolicy{256, 8} : WaitPolicy{0, 2};
+        }
+
+        bool operator==(const WaitPolicy& o) const {
+            return spinIterations == o.spinIterations && yieldIterations == o.yieldIterations;
+        }
+    };
+
+    /**
+     * @brief Snapshot of how blocked waits were resolved, process wide.
+     */
+    struct WaitCounters {
+        std::uint64_t spinResolved = 0;   ///< Condition became true while spinning
+        std::uint64_t yieldResolved = 0;  ///< Condition became true while yielding
+        std::uint64_t parked = 0;         ///< Had to sleep on a condition variable
+    };
+
+    namespace detail {
+
+        inline std::uint64_t packPolicy(const WaitPolicy& p) {
+            return (static_cast<std::uint64_t>(p.spinIterations) << 32) | p.yieldIterations;
+        }
+
+        inline WaitPolicy unpackPolicy(std::uint64_t v) {
+            return WaitPolicy{static_cast<std::uint32_t>(v >> 32), static_cast<std::uint32_t>(v)};
+        }
+
+        inline std::atomic<std::uint64_t>& defaultPolicyWord() {
+            static std::atomic<std::uint64_t> word{packPolicy(WaitPolicy::Adaptive())};
+            return word;
+        }
+
+        struct WaitStats {
+            std::atomic<std::uint64_t> spinResolved{0};
+            std::atomic<std::uint64_t> yieldResolved{0};
+            std::atomic<std::uint64_t> parked{0};
+        };
+
+        inline WaitStats& waitStats() {
+            static WaitStats stats;
+            return stats;
+        }
+
+        /// CPU hint that we are in a spin loop (x86 PAUSE / ARM YIELD).
+        inline void cpuRelax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+            __asm__ __volatile__("yield");
+#endif
+        }
+
+        /**
+         * @brief Spin, then yield, polling @p ready; never blocks.
+         * @return true if @p ready became true (the resolving phase is counted)
+         */
+        template<typename Pred>
+        bool spinUntil(const WaitPolicy& policy, Pred&& ready) {
+            for (std::uint32_t i = 0; i < policy.spinIterations; ++i) {
+                cpuRelax();
+                if (ready()) {
+                    waitStats().spinResolved.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            for (std::uint32_t i = 0; i < policy.yieldIterations; ++i) {
+                std::this_thread::yield();
+                if (ready()) {
+                    waitStats().yieldResolved.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Wait on @p cond until @p ready() holds, spinning first.
+         *
+         * @p lock must be held on entry and is held on return. While spinning
+         * the lock is released and only @p version (bumped by the other side
+         * on every state change) is polled, so spinners never contend for the
+         * mutex; @p ready is re-evaluated under the lock whenever it moves.
+         */
+        template<typename Lock, typename Cond, typename Pred>
+        void adaptiveWait(Lock& lock, Cond& cond, const std::atomic<std::uint64_t>& version,
+                          const WaitPolicy& policy, Pred&& ready,
+                          gocxx::runtime::WaitReason reason = gocxx::runtime::WaitReason::Unknown) {
+            if (ready()) return;
+
+            if (policy.spinIterations || policy.yieldIterations) {
+                std::uint64_t seen = version.load(std::memory_order_acquire);
+                lock.unlock();
+                // Returns true with the lock held once ready() is observed.
+                auto phase = [&](std::uint32_t iterations, bool yield,
+                                 std::atomic<std::uint64_t>& counter) {
+                    for (std::uint32_t i = 0; i < iterations; ++i) {
+                        if (yield) std::this_thread::yield();
+                        else cpuRelax();
+                        if (version.load(std::memory_order_acquire) == seen) continue;
+                        lock.lock();
+                        if (ready()) {
+                            counter.fetch_add(1, std::memory_order_relaxed);
+                            return true;
+                        }
+                        seen = version.load(std::memory_order_acquire);
+                        lock.unlock();
+                    }
+                    return false;
+                };
+                if (phase(policy.spinIterations, false, waitStats().spinResolved)) return;
+                if (phase(policy.yieldIterations, true, waitStats().yieldResolved)) return;
+                lock.lock();
+                if (ready()) {
+                    waitStats().yieldResolved.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+
+            waitStats().parked.fetch_add(1, std::memory_order_relaxed);
+            gocxx::runtime::BlockingRegion blocking(reason);
+            while (!ready()) {
+                cond.Wait(lock);
+            }
+        }
+
+        /**
+         * @brief Per-object policy that falls back to the global default.
+         */
+        class WaitPolicySlot {
+        public:
+            WaitPolicy get() const {
+                std::uint64_t v = word_.load(std::memory_order_relaxed);
+                if (v == kUseDefault) {
+                    return unpackPolicy(defaultPolicyWord().load(std::memory_order_relaxed));
+                }
+                return unpackPolicy(v);
+            }
+
+            void set(const WaitPolicy& p) { word_.store(packPolicy(p), std::memory_order_relaxed); }
+            void reset() { word_.store(kUseDefault, std::memory_order_relaxed); }
+
+        private:
+            static constexpr std::uint64_t kUseDefault = ~std::uint64_t{0};
+            std::atomic<std::uint64_t> word_{kUseDefault};
+        };
+
+    } // namespace detail
+
+    /// Set the policy used by channels and selects that have none of their own.
+    inline void SetDefaultWaitPolicy(const WaitPolicy& policy) {
+        detail::defaultPolicyWord().store(detail::packPolicy(policy), std::memory_order_relaxed);
+    }
+
+    /// Current process-wide default wait policy.
+    inline WaitPolicy DefaultWaitPolicy() {
+        return detail::unpackPolicy(detail::defaultPolicyWord().load(std::memory_order_relaxed));
+    }
+
+    /// Read the process-wide spin/yield/park counters.
+    inline WaitCounters GetWaitCounters() {
+        auto& s = detail::waitStats();
+        return WaitCounters{
+            s.spinResolved.load(std::memory_order_relaxed),
+            s.yieldResolved.load(std::memory_order_relaxed),
+            s.parked.load(std::memory_order_relaxed)};
+    }
+
+    /// Zero the process-wide wait counters.
+    inline void ResetWaitCounters() {
+        auto& s = detail::waitStats();
+        s.spinResolved.store(0, std::memory_order_relaxed);
+        s.yieldResolved.store(0, std::memory_order_relaxed);
+        s.parked.store(0, std::memory_order_relaxed);
+    }
+
+} // namespace gocxx::base
@@ -0,0 +1,255 @@
+/**
+ * @file bufio.h
+ * @brief Buffered I/O over io::Reader and io::Writer, like Go's bufio
+ *
+ * - Reader: Peek, ReadSlice and ReadLine return views into the internal
+ *   buffer, so line-oriented parsers do not copy or rescan what they read
+ * - Writer: coalesces small writes into one call on the underlying Writer
+ * - Scanner: splits a stream into tokens with a pluggable SplitFunc
+ *
+ * Views returned by Reader and Scanner stay valid only until the next call
+ * that reads from the same object.
+ *
+ * Underlying readers may report end of stream either as io::ErrEOF or, like
+ * os::File and net::TCPConn, as a read of zero bytes; both are seen as EOF.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/io/io.h>
+#include <gocxx/io/io_errors.h>
+
+namespace gocxx::bufio {
+
+    /// Buffer size used when none is given.
+    constexpr std::size_t kDefaultBufSize = 4096;
+
+    /// Largest token a Scanner accepts unless Buffer() raises it.
+    constexpr std::size_t kMaxScanTokenSize = 64 * 1024;
+
+    inline const std::shared_ptr<errors::Error> ErrBufferFull =
+        errors::Sentinel("bufio: buffer full");
+
+    inline const std::shared_ptr<errors::Error> ErrNegativeCount =
+        errors::Sentinel("bufio: negative count");
+
+    inline const std::shared_ptr<errors::Error> ErrInvalidUnreadByte =
+        errors::Sentinel("bufio: invalid use of UnreadByte");
+
+    inline const std::shared_ptr<errors::Error> ErrTooLong =
+        errors::Sentinel("bufio.Scanner: token too long");
+
+    inline const std::shared_ptr<errors::Error> ErrAdvanceTooFar =
+        errors::Sentinel("bufio.Scanner: SplitFunc returns advance count beyond input");
+
+    /// Returned by a SplitFunc to deliver its token and stop scanning without an error.
+    inline const std::shared_ptr<errors::Error> ErrFinalToken =
+        errors::Sentinel("final token");
+
+    /**
+     * @brief Buffered reader, like Go's `bufio.Reader`.
+     *
+     * @code
+     * bufio::Reader br(conn);
+     * for (;;) {
+     *     auto line = br.ReadLine();
+     *     if (line.Failed() || line.value.empty()) break;
+     *     parseHeader(line.value);  // a view into br's buffer
+     * }
+     * @endcode
+     */
+    class Reader : public io::Reader, public io::ByteReader, public io::WriterTo {
+    public:
+        explicit Reader(std::shared_ptr<io::Reader> rd, std::size_t size = kDefaultBufSize);
+
+        /// Reads into @p buffer, straight from the source when the buffer is empty and @p size is large.
+        base::Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override;
+        using io::Reader::Read;
+
+        base::Result<std::size_t> ReadByte(uint8_t& outByte) override;
+
+        /// Steps back over the last byte read; only valid right after a read.
+        base::Result<void> UnreadByte();
+
+        /**
+         * @brief The next @p n bytes without consuming them.
+         *
+         * Fewer bytes come with an error: ErrBufferFull if @p n exceeds the
+         * buffer size, otherwise the read error (io::ErrEOF at the end).
+         */
+        base::Result<std::string_view> Peek(std::size_t n);
+
+        /**
+         * @brief Reads through the first @p delim, returning a view into the buffer.
+         *
+         * If the buffer fills up first the whole buffer comes back with
+         * ErrBufferFull; at the end of input the remaining bytes come back
+         * with io::ErrEOF.
+         */
+        base::Result<std::string_view> ReadSlice(char delim);
+
+        /**
+         * @brief Reads one line, without its "\n" or "\r\n", as a view into the buffer.
+         *
+         * A line longer than the buffer is returned in pieces with
+         * @p isPrefix set on all but the last one. Only returns an error
+         * when no bytes were read.
+         */
+        base::Result<std::string_view> ReadLine(bool* isPrefix = nullptr);
+
+        /// Reads through the first @p delim into a new string, however long the line.
+        base::Result<std::string> ReadString(char delim);
+
+        /**
+         * @brief Writes the buffered bytes and then the rest of the source to @p w.
+         *
+         * Hands the remainder to the source's WriterTo or @p w's ReaderFrom
+         * when there is one, so the kernel fast paths still apply.
+         */
+        base::Result<std::size_t> WriteTo(std::shared_ptr<io::Writer> w) override;
+
+        /// Skips @p n bytes; fewer only if the input ends (with the read error).
+        base::Result<std::size_t> Discard(std::size_t n);
+
+        /// Bytes that can be read from the buffer without touching the source.
+        std::size_t Buffered() const { return w_ - r_; }
+        std::size_t Size() const { return buf_.size(); }
+
+        /// Drops buffered data and reads from @p rd from now on.
+        void Reset(std::shared_ptr<io::Reader> rd);
+
+    private:
+        void fill();
+        std::shared_ptr<errors::Error> takeError();
+        std::string_view view(std::size_t from, std::size_t to) const {
+            return std::string_view(reinterpret_cast<const char*>(buf_.data()) + from, to - from);
+        }
+
+        std::shared_ptr<io::Reader> rd_;
+        std::vector<uint8_t> buf_;
+        std::size_t r_ = 0;  // read position
+        std::size_t w_ = 0;  // write position
+        std::shared_ptr<errors::Error> err_;
+        int lastByte_ = -1;
+    };
+
+    /**
+     * @brief Buffered writer, like Go's `bufio.Writer`.
+     *
+     * Errors are sticky: after a failed write every later call returns the
+     * same error. Remember to Flush() before dropping the Writer.
+     */
+    class Writer : public io::Writer, public io::ByteWriter, public io::ReaderFrom {
+    public:
+        explicit Writer(std::shared_ptr<io::Writer> wr, std::size_t size = kDefaultBufSize);
+
+        base::Result<std::size_t> Write(const uint8_t* buffer, std::size_t size) override;
+        using io::Writer::Write;
+
+        base::Result<std::size_t> WriteByte(uint8_t byte) override;
+        base::Result<std::size_t> WriteString(std::string_view s);
+
+        /// Writes everything buffered to the underlying Writer.
+        base::Result<void> Flush();
+
+        /**
+         * @brief Copies @p src to the writer until EOF, reading straight into the buffer.
+         *
+         * With nothing buffered, defers to the underlying Writer's ReaderFrom.
+         * @return bytes read from @p src
+         */
+        base::Result<std::size_t> ReadFrom(std::shared_ptr<io::Reader> src) override;
+
+        /// Free space in the buffer.
+        std::size_t Available() const { return buf_.size() - n_; }
+        /// Bytes written into the buffer but not flushed yet.
+        std::size_t Buffered() const { return n_; }
+        std::size_t Size() const { return buf_.size(); }
+
+        /// Drops buffered data and any error, and writes to @p wr from now on.
+        void Reset(std::shared_ptr<io::Writer> wr);
+
+    private:
+        std::shared_ptr<io::Writer> wr_;
+        std::vector<uint8_t> buf_;
+        std::size_t n_ = 0;
+        std::shared_ptr<errors::Error> err_;
+    };
+
+    /**
+     * @brief Tokenizer callback for Scanner, like Go's `bufio.SplitFunc`.
+     *
+     * Gets the unconsumed input @p data and whether the source is exhausted.
+     * Returns how many bytes to consume, and sets @p token to deliver one; an
+     * empty optional asks for more data. An error stops the scan; ErrFinalToken
+     * stops it cleanly after delivering @p token.
+     */
+    using SplitFunc = std::function<base::Result<std::size_t>(
+        std::string_view data, bool atEOF, std::optional<std::string_view>& token)>;
+
+    /// Lines without their "\n" or "\r\n"; the last line need not end in a newline.
+    base::Result<std::size_t> ScanLines(std::string_view data, bool atEOF, std::optional<std::string_view>& token);
+    /// Single bytes.
+    base::Result<std::size_t> ScanBytes(std::string_view data, bool atEOF, std::optional<std::string_view>& token);
+    /// UTF-8 encoded code points; invalid bytes come through one at a time.
+    base::Result<std::size_t> ScanRunes(std::string_view data, bool atEOF, std::optional<std::string_view>& token);
+    /// Words separated by ASCII white space.
+    base::Result<std::size_t> ScanWords(std::string_view data, bool atEOF, std::optional<std::string_view>& token);
+
+    /**
+     * @brief Reads a stream token by token, like Go's `bufio.Scanner`.
+     *
+     * @code
+     * bufio::Scanner sc(file);
+     * while (sc.Scan()) handle(sc.Bytes());
+     * if (sc.Err()) return sc.Err();
+     * @endcode
+     */
+    class Scanner {
+    public:
+        explicit Scanner(std::shared_ptr<io::Reader> rd);
+
+        /// Sets the tokenizer; ScanLines by default. Must be called before Scan().
+        void Split(SplitFunc split);
+
+        /// Sets the initial buffer size and the largest token allowed. Must be called before Scan().
+        void Buffer(std::size_t initialSize, std::size_t maxTokenSize);
+
+        /// Advances to the next token; false at the end of input or on error.
+        bool Scan();
+
+        /// The current token, as a view into the scanner's buffer.
+        std::string_view Bytes() const { return token_; }
+        /// The current token, copied.
+        std::string Text() const { return std::string(token_); }
+
+        /// The first error other than io::ErrEOF, or nullptr.
+        std::shared_ptr<errors::Error> Err() const { return err_; }
+
+    private:
+        std::shared_ptr<io::Reader> rd_;
+        SplitFunc split_;
+        std::vector<uint8_t> buf_;
+        std::size_t maxTokenSize_ = kMaxScanTokenSize;
+        std::size_t start_ = 0;
+        std::size_t end_ = 0;
+        std::string_view token_;
+        std::shared_ptr<errors::Error> err_;
+        bool eof_ = false;
+        bool done_ = false;
+        bool scanCalled_ = false;
+        int emptyTokens_ = 0;
+    };
+
+} // namespace gocxx::bufio
@@ -0,0 +1,137 @@
+/**
+ * @file bytes.h
+ * @brief Growable byte buffer, like Go's bytes.Buffer
+ *
+ * Buffer storage is taken from process-wide size-class pools (powers of two
+ * from 64 bytes to 1 MiB) and handed back when the Buffer is destroyed or
+ * Release()d, so short-lived per-request buffers reuse memory instead of
+ * going to malloc every time. Larger blocks are allocated directly.
+ *
+ * Views returned by Bytes() and Next() stay valid only until the next call
+ * that modifies the Buffer.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/io/io.h>
+#include <gocxx/io/io_errors.h>
+
+namespace gocxx::bytes {
+
+    /// Smallest read ReadFrom makes room for before each call to the source.
+    constexpr std::size_t kMinRead = 512;
+
+    inline const std::shared_ptr<errors::Error> ErrUnreadByte =
+        std::make_shared<errors::simpleError>("bytes.Buffer: UnreadByte: previous operation was not a successful read");
+
+    /**
+     * @brief A variable-sized buffer of bytes, like Go's `bytes.Buffer`.
+     *
+     * Written at the end, read from the front. Capacity grows geometrically
+     * and is kept across Reset(), so a Buffer reused for many messages stops
+     * allocating once it has reached their size.
+     *
+     * @code
+     * bytes::Buffer buf;
+     * buf.WriteString("HTTP/1.1 200 OK\r\n");
+     * buf.WriteString(headers);
+     * buf.WriteTo(conn);
+     * @endcode
+     */
+    class Buffer : public io::Reader, public io::Writer,
+                   public io::ByteReader, public io::ByteWriter,
+                   public io::WriterTo, public io::ReaderFrom {
+    public:
+        Buffer() = default;
+        explicit Buffer(std::string_view initial);
+        ~Buffer() override;
+
+        Buffer(Buffer&& other) noexcept;
+        Buffer& operator=(Buffer&& other) noexcept;
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        /// The unread bytes.
+        std::string_view Bytes() const {
+            return std::string_view(reinterpret_cast<const char*>(buf_) + off_, end_ - off_);
+        }
+        /// The unread bytes, copied.
+        std::string String() const { return std::string(Bytes()); }
+
+        /// Number of unread bytes.
+        std::size_t Len() const { return end_ - off_; }
+        /// Total storage, read and unread.
+        std::size_t Cap() const { return cap_; }
+        /// Bytes that can be written without growing.
+        std::size_t Available() const { return cap_ - end_; }
+
+        /// Keeps the first @p n unread bytes; throws std::out_of_range if @p n > Len().
+        void Truncate(std::size_t n);
+
+        /// Empties the buffer but keeps its storage.
+        void Reset() { Truncate(0); }
+
+        /// Empties the buffer and returns its storage to the pool.
+        void Release();
+
+        /// Makes room for at least @p n more bytes without another allocation.
+        void Grow(std::size_t n);
+
+        base::Result<std::size_t> Write(const uint8_t* buffer, std::size_t size) override;
+        using io::Writer::Write;
+        base::Result<std::size_t> WriteByte(uint8_t byte) override;
+        base::Result<std::size_t> WriteString(std::string_view s);
+
+        /// Reads from the front; io::ErrEOF once the buffer is empty.
+        base::Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override;
+        using io::Reader::Read;
+        base::Result<std::size_t> ReadByte(uint8_t& outByte) override;
+
+        /// Steps back over the last byte read; only valid right after a read.
+        base::Result<void> UnreadByte();
+
+        /// Consumes up to @p n bytes and returns them as a view into the buffer.
+        std::string_view Next(std::size_t n);
+
+        /// Reads through the first @p delim; without one, the rest comes back with io::ErrEOF.
+        base::Result<std::string> ReadString(char delim);
+
+        /// Drains the buffer into @p w.
+        base::Result<std::size_t> WriteTo(std::shared_ptr<io::Writer> w) override;
+
+        /**
+         * @brief Appends everything @p r produces until EOF, reading straight into the buffer.
+         *
+         * Treats io::ErrEOF and a zero-byte read as the end.
+         * @return bytes read from @p r
+         */
+        base::Result<std::size_t> ReadFrom(std::shared_ptr<io::Reader> r) override;
+
+    private:
+        // Writable tail with room for at least n bytes.
+        uint8_t* grow(std::size_t n);
+
+        uint8_t* buf_ = nullptr;
+        std::size_t cap_ = 0;
+        std::size_t off_ = 0;  // read position
+        std::size_t end_ = 0;  // write position
+        bool canUnread_ = false;
+    };
+
+    namespace detail {
+        // The size-class pools behind Buffer, for other packages that need
+        // scratch blocks: at least n bytes, with cap set to the real size.
+        // Blocks go back with the cap they were handed out with.
+        uint8_t* allocateBlock(std::size_t n, std::size_t& cap);
+        void releaseBlock(uint8_t* p, std::size_t cap);
+    }
+
+} // namespace gocxx::bytes
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <chrono>
@@ -34,8 +36,10 @@
 #include <atomic>
 
 #include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
 #include <gocxx/base/chan.h>
 #include <gocxx/time/time.h>
+#include <gocxx/time/detail/timer_service.h>
 #include <condition_variable>
 #include <atomic>
 #include <any>
@@ -51,8 +55,68 @@ namespace context {
 
 // Forward declarations
 class Context;
+class CancelContext;
 using ContextPtr = std::shared_ptr<Context>;
 
+namespace detail {
+
+/// Identifier for the next ContextKey; fixed for the lifetime of the key.
+std::size_t nextContextKeyId();
+
+/**
+ * @brief Immutable map from key ID to value shared by all contexts below a typed WithValue().
+ *
+ * A flat vector sorted by ID: a lookup is a binary search over a handful of
+ * entries and adding a value copies the (small) vector once.
+ */
+class ValueMap {
+public:
+    const void* find(std::size_t id) const;
+
+    static std::shared_ptr<const ValueMap> with(const std::shared_ptr<const ValueMap>& base, std::size_t id,
+                                                std::shared_ptr<const void> value);
+
+private:
+    struct Entry {
+        std::size_t id;
+        std::shared_ptr<const void> value;
+    };
+    std::vector<Entry> entries_;
+};
+
+template <typename T>
+struct TypeIdentity {
+    using type = T;
+};
+
+} // namespace detail
+
+/**
+ * @brief Typed key for context values (not in Go, which uses unexported key types).
+ *
+ * Each key gets its own ID when it is defined, so two keys never collide
+ * even if they share a name or value type. Define keys once, typically at
+ * namespace scope:
+ *
+ * @code
+ * inline const ContextKey<std::string> RequestID("request-id");
+ * auto ctx = WithValue(parent, RequestID, "abc123").value;
+ * if (const std::string* id = Value(ctx, RequestID)) { ... }
+ * @endcode
+ */
+template <typename T>
+class ContextKey {
+public:
+    explicit ContextKey(const char* name = "") : id_(detail::nextContextKeyId()), name_(name) {}
+
+    std::size_t id() const { return id_; }
+    const char* name() const { return name_; }
+
+private:
+    std::size_t id_;
+    const char* name_;
+};
+
 /**
  * @brief Context interface matching Go's context.Context exactly
  * 
@@ -76,6 +140,16 @@ public:
      * @return Channel that receives cancellation signal
      */
     virtual gocxx::base::Chan<bool> Done() const = 0;
+
+#if defined(GOCXX_HAS_COROUTINES)
+    /**
+     * @brief Awaitable that completes once Done() is closed (gocxx/coro)
+     * Usage: co_await ctx->DoneAsync();
+     */
+    gocxx::coro::RecvAwaitable<bool> DoneAsync() const {
+        return gocxx::coro::RecvAwaitable<bool>(Done());
+    }
+#endif
     
     /**
      * @brief Returns error explaining why context was canceled
@@ -91,6 +165,34 @@ public:
      * @return Result containing value if found, error if not found
      */
     virtual gocxx::base::Result<std::any> Value(const std::any& key) const = 0;
+
+    /**
+     * @brief Block until the context is done or @p timeout elapses (convenience method, not in Go)
+     *
+     * The default selects on Done() and a timer; the built-in contexts wait
+     * on their cancellation state directly.
+     * @return true if the context is done
+     */
+    virtual bool WaitFor(gocxx::time::Duration timeout) const;
+
+    /// Values stored under ContextKeys, shared with every context derived from this one.
+    const std::shared_ptr<const detail::ValueMap>& TypedValues() const { return typed_values_; }
+
+protected:
+    /// Derived contexts call this with their parent so typed values and cancellation stay visible.
+    void InheritValues(const ContextPtr& parent) {
+        if (parent) {
+            typed_values_ = parent->typed_values_;
+            cancel_ancestor_ = parent->cancel_ancestor_;
+        }
+    }
+
+    std::shared_ptr<const detail::ValueMap> typed_values_;
+    // Nearest CancelContext up the chain (this one, for a CancelContext); kept
+    // alive by the parent references. Lets children link to it directly.
+    CancelContext* cancel_ancestor_ = nullptr;
+
+    friend std::function<bool()> AfterCancel(const ContextPtr& ctx, std::function<void()> fn);
 };
 
 /**
@@ -106,18 +208,41 @@ class CancelContext : public Context {
 private:
     ContextPtr parent_;
     mutable std::mutex mutex_;
+    mutable std::condition_variable cancel_cv_;  // signaled by Cancel() for WaitFor()
     std::atomic<bool> canceled_;
     std::string err_;
-    mutable gocxx::base::Chan<bool> done_chan_;
-    std::vector<std::weak_ptr<CancelContext>> children_;
-    
+    // Created by the first Done() call; most contexts are never selected on.
+    mutable std::unique_ptr<gocxx::base::Chan<bool>> done_chan_;
+    mutable std::atomic<gocxx::base::Chan<bool>*> done_{nullptr};
+
+    // Children form an intrusive list guarded by mutex_, so a child that is
+    // canceled or destroyed unlinks itself in O(1).
+    CancelContext* first_child_ = nullptr;
+    // Link in link_parent_'s list; guarded by link_parent_->mutex_
+    CancelContext* link_parent_ = nullptr;
+    CancelContext* prev_sibling_ = nullptr;
+    CancelContext* next_sibling_ = nullptr;
+    bool linked_ = false;
+
+    // Callbacks registered with AfterCancel(), by registration id
+    std::unordered_map<std::uint64_t, std::function<void()>> after_cancel_;
+    std::uint64_t next_after_cancel_id_ = 0;
+
+    void cancel(const std::string& reason, bool unlink);
+    void linkChildLocked(CancelContext* child);
+    void unlinkFromParent();
+
+    friend std::function<bool()> AfterCancel(const ContextPtr& ctx, std::function<void()> fn);
+
 public:
     explicit CancelContext(ContextPtr parent = nullptr);
+    ~CancelContext() override;
     
     gocxx::base::Result<gocxx::time::Time> Deadline() const override;
     gocxx::base::Chan<bool> Done() const override;
     gocxx::base::Result<void> Err() const override;
     gocxx::base::Result<std::any> Value(const std::any& key) const override;
+    bool WaitFor(gocxx::time::Duration timeout) const override;
     
     /**
      * @brief Cancel this context and all its children
@@ -127,6 +252,10 @@ public:
     
     /**
      * @brief Add a child context
+     *
+     * Contexts created from this one are linked automatically; this only
+     * matters for a child built on an unrelated parent. No-op if @p child is
+     * already linked.
      * @param child Child context to add
      */
     void AddChild(std::shared_ptr<CancelContext> child);
@@ -144,7 +273,7 @@ public:
 class TimerContext : public CancelContext {
 private:
     gocxx::time::Time deadline_;
-    std::unique_ptr<std::thread> timer_thread_;
+    std::shared_ptr<gocxx::time::detail::TimerNode> timer_;
     
 public:
     explicit TimerContext(ContextPtr parent, gocxx::time::Time deadline);
@@ -173,6 +302,24 @@ public:
     gocxx::base::Chan<bool> Done() const override;
     gocxx::base::Result<void> Err() const override;
     gocxx::base::Result<std::any> Value(const std::any& key) const override;
+    bool WaitFor(gocxx::time::Duration timeout) const override;
+};
+
+/**
+ * @brief Context adding one typed value; see ContextKey
+ */
+class TypedValueContext : public Context {
+private:
+    ContextPtr parent_;
+
+public:
+    TypedValueContext(ContextPtr parent, std::size_t key_id, std::shared_ptr<const void> value);
+
+    gocxx::base::Result<gocxx::time::Time> Deadline() const override;
+    gocxx::base::Chan<bool> Done() const override;
+    gocxx::base::Result<void> Err() const override;
+    gocxx::base::Result<std::any> Value(const std::any& key) const override;
+    bool WaitFor(gocxx::time::Duration timeout) const override;
 };
 
 /**
@@ -184,6 +331,7 @@ public:
     gocxx::base::Chan<bool> Done() const override;
     gocxx::base::Result<void> Err() const override;
     gocxx::base::Result<std::any> Value(const std::any& key) const override;
+    bool WaitFor(gocxx::time::Duration timeout) const override;
 };
 
 /**
@@ -255,6 +403,48 @@ gocxx::base::Result<ContextPtr> WithValue(
     const std::any& value
 );
 
+/**
+ * @brief Returns a copy of parent in which @p key maps to @p value
+ *
+ * Typed counterpart of WithValue(parent, std::any, std::any). Every context
+ * derived from the result shares its value map, so lookups never walk the
+ * parent chain.
+ */
+template <typename T>
+gocxx::base::Result<ContextPtr> WithValue(ContextPtr parent, const ContextKey<T>& key,
+                                          typename detail::TypeIdentity<T>::type value) {
+    if (!parent) {
+        return gocxx::base::Result<ContextPtr>(gocxx::errors::New("parent context is nil"));
+    }
+    return gocxx::base::Result<ContextPtr>(std::make_shared<TypedValueContext>(
+        std::move(parent), key.id(), std::make_shared<const T>(std::move(value))));
+}
+
+/**
+ * @brief Looks up @p key in @p ctx without copying the value
+ * @return Pointer to the value, valid while @p ctx is alive, or nullptr if not set
+ */
+template <typename T>
+const T* Value(const ContextPtr& ctx, const ContextKey<T>& key) {
+    if (!ctx || !ctx->TypedValues()) {
+        return nullptr;
+    }
+    return static_cast<const T*>(ctx->TypedValues()->find(key.id()));
+}
+
+/**
+ * @brief Arrange for @p fn to run once @p ctx is canceled
+ * Go equivalent: context.AfterFunc(ctx Context, f func()) (stop func() bool)
+ *
+ * @p fn runs on the task runtime (gocxx::go), so cleanup does not need a
+ * thread parked on Done(). It runs at once if @p ctx is already canceled, and
+ * never for a context that cannot be canceled (Background, TODO). An empty
+ * @p fn is a no-op.
+ * @return stop function: unregisters @p fn and returns true if that kept it
+ *         from running; false if it has already been started or stopped
+ */
+std::function<bool()> AfterCancel(const ContextPtr& ctx, std::function<void()> fn);
+
 // Error constants - exact Go equivalents
 extern const std::string Canceled;        // "context canceled"
 extern const std::string DeadlineExceeded; // "context deadline exceeded"
@@ -263,6 +453,8 @@ extern const std::string DeadlineExceeded; // "context deadline exceeded"
 
 /**
  * @brief Sleep that respects context cancellation
+ *
+ * Returns as soon as either the duration elapses or the context is done.
  * @param ctx Context to check for cancellation
  * @param duration Duration to sleep
  * @return Result indicating success or cancellation
@@ -0,0 +1,241 @@
+/**
+ * @file chan_awaitable.h
+ * @brief co_await support for channel send and receive
+ *
+ * A suspended coroutine is represented by a Waiter linked into the
+ * channel's wait queue, the same intrusive node a blocked select uses, so a
+ * parked coroutine costs one small object inside its frame and no thread.
+ * When the channel makes progress the coroutine is posted to its executor,
+ * retries the operation, and re-registers if another party got there first.
+ */
+
+// gocxx/coro/chan_awaitable.h
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <gocxx/base/chan.h>
+#include <gocxx/base/detail/wait_queue.h>
+#include <gocxx/coro/executor.h>
+
+namespace gocxx::coro {
+
+    namespace detail {
+
+        /**
+         * @brief Waiter that resumes a coroutine instead of waking a thread.
+         *
+         * Registration and wakeup race: whichever of parkOrComplete() and
+         * onWake() runs second continues the operation, so a wakeup that lands
+         * before the coroutine finished suspending is never lost and the
+         * coroutine is never resumed twice.
+         */
+        class AsyncWaiter : public base::detail::Waiter {
+        protected:
+            ~AsyncWaiter() = default;
+
+            /**
+             * @brief Re-run the operation after a wakeup, re-registering on failure.
+             * @return true once the operation completed
+             */
+            virtual bool retry() = 0;
+
+            void bind(std::coroutine_handle<> h, Executor* executor) {
+                handle_ = h;
+                executor_ = executor;
+            }
+
+            /**
+             * @brief Commit to suspending; call with the nodes registered.
+             * @return false if the operation completed instead (do not suspend)
+             */
+            bool parkOrComplete() {
+                for (;;) {
+                    if (state_.exchange(kParked, std::memory_order_acq_rel) != kWoken) {
+                        return true;  // onWake() now owns the continuation
+                    }
+                    state_.store(kIdle, std::memory_order_relaxed);
+                    if (retry()) return false;
+                }
+            }
+
+        private:
+            void onWake() override {
+                if (state_.exchange(kWoken, std::memory_order_acq_rel) == kParked) {
+                    executor_->post([this] { resumeAfterWake(); });
+                }
+            }
+
+            void resumeAfterWake() {
+                state_.store(kIdle, std::memory_order_relaxed);
+                if (retry() || !parkOrComplete()) {
+                    handle_.resume();  // may destroy *this
+                }
+            }
+
+            enum : int { kIdle, kParked, kWoken };
+            std::atomic<int> state_{kIdle};
+            std::coroutine_handle<> handle_;
+            Executor* executor_ = nullptr;
+        };
+
+        /// Shared registration logic for single-channel awaitables.
+        template<typename Derived, typename T, base::detail::WaitSide Side>
+        class ChanAwaitableBase : protected AsyncWaiter {
+        public:
+            explicit ChanAwaitableBase(base::Chan<T> ch) : chan_(std::move(ch)) {
+                node_.waiter = this;
+                node_.side = Side;
+            }
+
+            ~ChanAwaitableBase() {
+                // Only reached with the node still queued if the frame is destroyed while suspended.
+                if (node_.queued) chan_.implRef().dequeueWaiter(&node_);
+            }
+
+            ChanAwaitableBase(const ChanAwaitableBase&) = delete;
+            ChanAwaitableBase& operator=(const ChanAwaitableBase&) = delete;
+
+            bool await_ready() { return self().attempt(); }
+
+            template<typename Promise>
+            bool await_suspend(std::coroutine_handle<Promise> h) {
+                bind(h, executorOf(h));
+                return !registerAndAttempt() && parkOrComplete();
+            }
+
+        protected:
+            bool retry() override {
+                return self().attempt() || registerAndAttempt();
+            }
+
+            base::Chan<T> chan_;
+
+        private:
+            Derived& self() { return static_cast<Derived&>(*this); }
+
+            // Link the node, then poll again: progress made before the node
+            // was visible would otherwise go unnoticed.
+            bool registerAndAttempt() {
+                rearm();
+                chan_.implRef().enqueueWaiter(&node_);
+                if (!self().attempt()) return false;
+                chan_.implRef().dequeueWaiter(&node_);
+                if (base::detail::WaitNode* n = fired()) {
+                    n->source->passWake(n->side);
+                }
+                return true;
+            }
+
+            base::detail::WaitNode node_;
+        };
+
+    } // namespace detail
+
+    /**
+     * @brief Awaitable receive; resumes with the value or std::nullopt once closed.
+     */
+    template<typename T>
+    class RecvAwaitable final
+        : public detail::ChanAwaitableBase<RecvAwaitable<T>, T, base::detail::WaitSide::Recv> {
+        using Base = detail::ChanAwaitableBase<RecvAwaitable<T>, T, base::detail::WaitSide::Recv>;
+        friend Base;
+
+    public:
+        explicit RecvAwaitable(base::Chan<T> ch) : Base(std::move(ch)) {}
+
+        std::optional<T> await_resume() { return std::move(result_); }
+
+    private:
+        bool attempt() {
+            if (take()) return true;
+            if (!this->chan_.isClosed()) return false;
+            take();  // catches a send that raced the close
+            return true;
+        }
+
+        bool take() {
+            auto r = this->chan_.tryRecv();
+            if (!r.Ok()) return false;
+            result_.emplace(std::move(r.value));
+            return true;
+        }
+
+        std::optional<T> result_;
+    };
+
+    /**
+     * @brief Awaitable send; throws std::runtime_error on a closed channel like Chan::send.
+     *
+     * Copyable values are copied for each attempt; move-only values rely on
+     * the backends leaving the argument intact when trySend fails.
+     */
+    template<typename T>
+    class SendAwaitable final
+        : public detail::ChanAwaitableBase<SendAwaitable<T>, T, base::detail::WaitSide::Send> {
+        using Base = detail::ChanAwaitableBase<SendAwaitable<T>, T, base::detail::WaitSide::Send>;
+        friend Base;
+
+    public:
+        SendAwaitable(base::Chan<T> ch, T value) : Base(std::move(ch)), value_(std::move(value)) {}
+
+        void await_resume() {
+            if (closed_) throw std::runtime_error("send on closed channel");
+        }
+
+    private:
+        bool attempt() {
+            if (this->chan_.isClosed()) {
+                closed_ = true;
+                return true;
+            }
+            bool sent;
+            if constexpr (std::is_copy_constructible_v<T>) {
+                T copy(value_);
+                sent = this->chan_.trySend(std::move(copy)).Ok();
+            } else {
+                sent = this->chan_.trySend(std::move(value_)).Ok();
+            }
+            if (sent) return true;
+            if (this->chan_.isClosed()) {
+                closed_ = true;
+                return true;
+            }
+            return false;
+        }
+
+        T value_;
+        bool closed_ = false;
+    };
+
+} // namespace gocxx::coro
+
+namespace gocxx::base {
+
+    template<typename T>
+    coro::RecvAwaitable<T> Chan<T>::recvAsync() const {
+        return coro::RecvAwaitable<T>(*this);
+    }
+
+    template<typename T>
+    coro::SendAwaitable<T> Chan<T>::sendAsync(T value) const {
+        return coro::SendAwaitable<T>(*this, std::move(value));
+    }
+
+    /// `co_await ch` receives from @p ch.
+    template<typename T>
+    coro::RecvAwaitable<T> operator co_await(const Chan<T>& ch) {
+        return coro::RecvAwaitable<T>(ch);
+    }
+
+    /// `co_await timer->C()` and other channels held by shared_ptr.
+    template<typename T>
+    coro::RecvAwaitable<T> operator co_await(const std::shared_ptr<Chan<T>>& ch) {
+        return coro::RecvAwaitable<T>(*ch);
+    }
+
+} // namespace gocxx::base
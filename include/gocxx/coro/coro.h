@@ -0,0 +1,93 @@
+/**
+ * @file coro.h
+ * @brief C++20 coroutine support: Task, executors and awaitables
+ *
+ * Only available when the library is configured with
+ * -DGOCXX_ENABLE_COROUTINES=ON (which builds everything as C++20 and
+ * defines GOCXX_HAS_COROUTINES). Everything a blocking call can wait on
+ * has an awaitable counterpart:
+ *
+ * - `co_await ch.recvAsync()` / `co_await ch` / `co_await ch.sendAsync(v)`
+ * - `co_await sel` for a populated base::Select
+ * - `co_await timer->C()` for time::Timer and time::Ticker channels
+ * - `co_await ctx->DoneAsync()` for context::Context
+ *
+ * Suspended coroutines are resumed on their executor, which defaults to
+ * the task runtime shared with gocxx::go().
+ *
+ * @example
+ * ```cpp
+ * gocxx::coro::Task<int> sum(gocxx::base::Chan<int> ch) {
+ *     int total = 0;
+ *     while (auto v = co_await ch.recvAsync()) total += *v;
+ *     co_return total;
+ * }
+ *
+ * int total = gocxx::coro::SyncWait(sum(ch));
+ * ```
+ */
+
+// gocxx/coro/coro.h
+#pragma once
+#include <coroutine>
+#include <gocxx/coro/executor.h>
+#include <gocxx/coro/task.h>
+#include <gocxx/coro/chan_awaitable.h>
+#include <gocxx/base/select.h>
+#include <gocxx/context/context.h>
+
+namespace gocxx::coro {
+
+    /**
+     * @brief Awaitable that runs a Select without blocking the thread.
+     *
+     * Cases register with this awaitable's waiter instead of the select's
+     * thread waiter; the select must outlive the co_await.
+     */
+    class SelectAwaitable final : private detail::AsyncWaiter {
+    public:
+        explicit SelectAwaitable(base::Select& sel) : sel_(sel) {}
+
+        ~SelectAwaitable() {
+            if (active_) sel_.finish();
+        }
+
+        SelectAwaitable(const SelectAwaitable&) = delete;
+        SelectAwaitable& operator=(const SelectAwaitable&) = delete;
+
+        bool await_ready() {
+            sel_.prepare(this);
+            active_ = true;
+            return retry();
+        }
+
+        template<typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> h) {
+            bind(h, detail::executorOf(h));
+            return parkOrComplete();
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        bool retry() override {
+            if (!sel_.tryFired() && !sel_.pollOnce()) return false;
+            sel_.finish();
+            active_ = false;
+            return true;
+        }
+
+        base::Select& sel_;
+        bool active_ = false;
+    };
+
+} // namespace gocxx::coro
+
+namespace gocxx::base {
+
+    /// `co_await sel` runs @p sel without blocking the calling thread.
+    inline coro::SelectAwaitable operator co_await(Select& sel) {
+        return coro::SelectAwaitable(sel);
+    }
+
+} // namespace gocxx::base
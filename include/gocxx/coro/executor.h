@@ -0,0 +1,134 @@
+/**
+ * @file executor.h
+ * @brief Where suspended gocxx coroutines are resumed
+ *
+ * Awaitables never resume a coroutine from inside the channel operation
+ * that woke it; they post the continuation to an Executor instead. The
+ * default executor hands continuations to the task runtime (gocxx::go), so
+ * coroutines and ordinary tasks share the same worker pool. ManualExecutor
+ * runs everything on a thread of the caller's choosing, which is handy for
+ * event loops and deterministic tests.
+ */
+
+// gocxx/coro/executor.h
+#pragma once
+
+#if !defined(__cpp_impl_coroutine) && !defined(__cpp_coroutines)
+#error "gocxx/coro requires C++20 coroutines; configure with -DGOCXX_ENABLE_COROUTINES=ON"
+#endif
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <gocxx/runtime/runtime.h>
+
+namespace gocxx::coro {
+
+    /**
+     * @brief Something that runs posted continuations.
+     */
+    class Executor {
+    public:
+        virtual ~Executor() = default;
+
+        /// Run @p fn at some later point; must be thread-safe.
+        virtual void post(std::function<void()> fn) = 0;
+
+        /// Resume @p h on this executor.
+        void resume(std::coroutine_handle<> h) {
+            post([h] { h.resume(); });
+        }
+    };
+
+    /**
+     * @brief Executor backed by the work-stealing task runtime.
+     */
+    class RuntimeExecutor final : public Executor {
+    public:
+        void post(std::function<void()> fn) override {
+            gocxx::go(std::move(fn));
+        }
+    };
+
+    /// Process-wide default executor (the task runtime).
+    inline Executor& DefaultExecutor() {
+        static RuntimeExecutor executor;
+        return executor;
+    }
+
+    /**
+     * @brief Executor whose queue is drained explicitly by its owner.
+     */
+    class ManualExecutor final : public Executor {
+    public:
+        void post(std::function<void()> fn) override {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.push_back(std::move(fn));
+            }
+            cv_.notify_one();
+        }
+
+        /// Run one queued continuation, if any.
+        bool runOne() {
+            std::function<void()> fn;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (queue_.empty()) return false;
+                fn = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            fn();
+            return true;
+        }
+
+        /// Run continuations until the queue is empty; returns how many ran.
+        std::size_t runPending() {
+            std::size_t n = 0;
+            while (runOne()) ++n;
+            return n;
+        }
+
+        /// Run continuations, sleeping while idle, until @p done() holds.
+        template<typename Pred>
+        void runUntil(Pred done) {
+            while (!done()) {
+                if (runOne()) continue;
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (!queue_.empty() || done()) continue;
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::Coroutine);
+                cv_.wait_for(lock, std::chrono::milliseconds(10));
+            }
+        }
+
+        std::size_t pending() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return queue_.size();
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<std::function<void()>> queue_;
+    };
+
+    namespace detail {
+
+        /// Executor of the awaiting coroutine, or the default one.
+        template<typename Promise>
+        Executor* executorOf(std::coroutine_handle<Promise> h) {
+            if constexpr (requires { h.promise().executor(); }) {
+                return h.promise().executor();
+            } else {
+                return &DefaultExecutor();
+            }
+        }
+
+    } // namespace detail
+
+} // namespace gocxx::coro
@@ -0,0 +1,264 @@
+/**
+ * @file task.h
+ * @brief Lazily started coroutine type and helpers to run it
+ *
+ * Task<T> does nothing until it is awaited (or handed to Spawn/SyncWait);
+ * awaiting it transfers control symmetrically, so deep chains of tasks
+ * neither grow the stack nor round-trip through the executor. An awaited
+ * task inherits the executor of the coroutine awaiting it.
+ */
+
+// gocxx/coro/task.h
+#pragma once
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <gocxx/coro/executor.h>
+
+namespace gocxx::coro {
+
+    template<typename T = void>
+    class Task;
+
+    namespace detail {
+
+        class PromiseBase {
+        public:
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+                    auto next = h.promise().continuation_;
+                    return next ? next : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            void unhandled_exception() noexcept { error_ = std::current_exception(); }
+
+            Executor* executor() const noexcept {
+                return executor_ ? executor_ : &DefaultExecutor();
+            }
+
+            std::coroutine_handle<> continuation_;
+            Executor* executor_ = nullptr;
+
+        protected:
+            void rethrowIfFailed() {
+                if (error_) std::rethrow_exception(error_);
+            }
+
+        private:
+            std::exception_ptr error_;
+        };
+
+        template<typename T>
+        class Promise final : public PromiseBase {
+        public:
+            Task<T> get_return_object() noexcept;
+
+            template<typename U>
+            void return_value(U&& value) {
+                value_.emplace(std::forward<U>(value));
+            }
+
+            T take() {
+                rethrowIfFailed();
+                return std::move(*value_);
+            }
+
+        private:
+            std::optional<T> value_;
+        };
+
+        template<>
+        class Promise<void> final : public PromiseBase {
+        public:
+            Task<void> get_return_object() noexcept;
+            void return_void() noexcept {}
+            void take() { rethrowIfFailed(); }
+        };
+
+    } // namespace detail
+
+    /**
+     * @brief Lazily started coroutine producing a T; move-only.
+     *
+     * Exceptions thrown in the body are rethrown to whoever awaits the task.
+     */
+    template<typename T>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = detail::Promise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                if (handle_) handle_.destroy();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task() {
+            if (handle_) handle_.destroy();
+        }
+
+        /// True once the body has run to completion.
+        bool done() const noexcept { return !handle_ || handle_.done(); }
+
+        bool await_ready() const noexcept { return done(); }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+            handle_.promise().continuation_ = awaiting;
+            handle_.promise().executor_ = detail::executorOf(awaiting);
+            return handle_;
+        }
+
+        T await_resume() { return handle_.promise().take(); }
+
+    private:
+        friend promise_type;
+        explicit Task(Handle h) noexcept : handle_(h) {}
+
+        Handle handle_;
+    };
+
+    namespace detail {
+
+        template<typename T>
+        Task<T> Promise<T>::get_return_object() noexcept {
+            return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> Promise<void>::get_return_object() noexcept {
+            return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+        }
+
+        /// Fire-and-forget coroutine that owns the task it runs.
+        struct Detached {
+            struct promise_type {
+                promise_type(Task<void>&, Executor& ex) noexcept : executor_(&ex) {}
+
+                Detached get_return_object() noexcept { return {}; }
+                // The body's first step posts itself to the executor.
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() noexcept {}
+                // Like a panic escaping a goroutine.
+                void unhandled_exception() noexcept { std::terminate(); }
+                Executor* executor() const noexcept { return executor_; }
+
+                Executor* executor_;
+            };
+        };
+
+        struct StartOn {
+            Executor& executor;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { executor.resume(h); }
+            void await_resume() const noexcept {}
+        };
+
+        inline Detached runDetached(Task<void> task, Executor& ex) {
+            co_await StartOn{ex};
+            co_await task;
+        }
+
+        class Latch {
+        public:
+            void countDown() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_ = true;
+                cv_.notify_all();
+            }
+
+            void wait() {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (done_) return;
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::Coroutine);
+                cv_.wait(lock, [this] { return done_; });
+            }
+
+        private:
+            std::mutex mutex_;
+            std::condition_variable cv_;
+            bool done_ = false;
+        };
+
+        template<typename T>
+        Task<void> completeInto(Task<T>& task, std::optional<T>& out,
+                                std::exception_ptr& error, Latch& latch) {
+            try {
+                out.emplace(co_await task);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            latch.countDown();
+        }
+
+        inline Task<void> completeInto(Task<void>& task, std::exception_ptr& error, Latch& latch) {
+            try {
+                co_await task;
+            } catch (...) {
+                error = std::current_exception();
+            }
+            latch.countDown();
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Start @p task on @p executor and forget about it.
+     *
+     * The task's frame is freed when it finishes; an exception escaping it
+     * terminates the process.
+     */
+    inline void Spawn(Task<void> task, Executor& executor = DefaultExecutor()) {
+        detail::runDetached(std::move(task), executor);
+    }
+
+    /**
+     * @brief Run @p task on @p executor and block the calling thread until it finishes.
+     *
+     * Do not call this from a ManualExecutor's own thread: nobody would drain it.
+     */
+    template<typename T>
+    T SyncWait(Task<T> task, Executor& executor = DefaultExecutor()) {
+        detail::Latch latch;
+        std::exception_ptr error;
+        if constexpr (std::is_void_v<T>) {
+            Spawn(detail::completeInto(task, error, latch), executor);
+            latch.wait();
+            if (error) std::rethrow_exception(error);
+        } else {
+            std::optional<T> out;
+            Spawn(detail::completeInto(task, out, error, latch), executor);
+            latch.wait();
+            if (error) std::rethrow_exception(error);
+            return std::move(*out);
+        }
+    }
+
+    /// `co_await Schedule(ex)` moves the rest of the coroutine onto @p ex.
+    inline detail::StartOn Schedule(Executor& executor) {
+        return detail::StartOn{executor};
+    }
+
+} // namespace gocxx::coro
@@ -0,0 +1,164 @@
+/**
+ * @file profile_builder.h
+ * @brief Encoder for the pprof profile.proto format
+ *
+ * Writes the protobuf wire format by hand (no protobuf dependency), the
+ * subset of github.com/google/pprof/proto/profile.proto that `go tool pprof`
+ * needs: value types, samples, mappings, locations, functions and the
+ * string table. The output is not gzipped; pprof accepts both.
+ */
+
+// gocxx/debug/detail/profile_builder.h
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace gocxx::debug::detail {
+
+    class ProfileBuilder {
+    public:
+        ProfileBuilder() { str(""); }  // index 0 must be the empty string
+
+        /// Index of @p s in the string table, adding it if needed.
+        std::int64_t str(std::string_view s) {
+            auto it = strings_.find(std::string(s));
+            if (it != strings_.end()) return it->second;
+            const auto id = static_cast<std::int64_t>(table_.size());
+            table_.emplace_back(s);
+            strings_.emplace(table_.back(), id);
+            return id;
+        }
+
+        /// Adds one value column; every sample carries one value per column, in this order.
+        void sampleType(std::string_view type, std::string_view unit) {
+            message(body_, 1, valueType(type, unit));
+        }
+
+        void periodType(std::string_view type, std::string_view unit, std::int64_t period) {
+            message(body_, 11, valueType(type, unit));
+            varintField(body_, 12, static_cast<std::uint64_t>(period));
+        }
+
+        /// The column `go tool pprof` shows unless told otherwise.
+        void defaultSampleType(std::string_view type) {
+            varintField(body_, 14, static_cast<std::uint64_t>(str(type)));
+        }
+
+        void timeNanos(std::int64_t ns) { varintField(body_, 9, static_cast<std::uint64_t>(ns)); }
+        void durationNanos(std::int64_t ns) { varintField(body_, 10, static_cast<std::uint64_t>(ns)); }
+
+        /// A loaded object's executable range; returns its id.
+        std::uint64_t mapping(std::uint64_t start, std::uint64_t limit, std::uint64_t offset,
+                              std::string_view filename, bool hasFunctions) {
+            const std::uint64_t id = ++mappings_;
+            std::string m;
+            varintField(m, 1, id);
+            varintField(m, 2, start);
+            varintField(m, 3, limit);
+            varintField(m, 4, offset);
+            varintField(m, 5, static_cast<std::uint64_t>(str(filename)));
+            if (hasFunctions) varintField(m, 7, 1);
+            message(body_, 3, m);
+            return id;
+        }
+
+        /// Id of the function named @p name in @p filename, adding it on first use.
+        std::uint64_t function(std::string_view name, std::string_view filename = {}) {
+            const std::int64_t n = str(name);
+            const std::int64_t f = str(filename);
+            auto [it, added] = functions_.try_emplace({n, f}, functions_.size() + 1);
+            if (added) {
+                std::string fn;
+                varintField(fn, 1, it->second);
+                varintField(fn, 2, static_cast<std::uint64_t>(n));
+                varintField(fn, 3, static_cast<std::uint64_t>(n));
+                varintField(fn, 4, static_cast<std::uint64_t>(f));
+                message(body_, 5, fn);
+            }
+            return it->second;
+        }
+
+        /**
+         * @brief A code location; returns its id
+         *
+         * @param functionId 0 to leave the location unsymbolized, for pprof
+         *        to resolve from the mapping's binary
+         */
+        std::uint64_t location(std::uint64_t address, std::uint64_t mappingId, std::uint64_t functionId,
+                               std::int64_t line = 0) {
+            const std::uint64_t id = ++locations_;
+            std::string loc;
+            varintField(loc, 1, id);
+            if (mappingId) varintField(loc, 2, mappingId);
+            if (address) varintField(loc, 3, address);
+            if (functionId) {
+                std::string ln;
+                varintField(ln, 1, functionId);
+                if (line) varintField(ln, 2, static_cast<std::uint64_t>(line));
+                message(loc, 4, ln);
+            }
+            message(body_, 4, loc);
+            return id;
+        }
+
+        /// A stack, leaf first, with one value per sampleType().
+        void sample(const std::vector<std::uint64_t>& locationIds, const std::vector<std::int64_t>& values) {
+            std::string s, packed;
+            for (std::uint64_t id : locationIds) varint(packed, id);
+            bytesField(s, 1, packed);
+            packed.clear();
+            for (std::int64_t v : values) varint(packed, static_cast<std::uint64_t>(v));
+            bytesField(s, 2, packed);
+            message(body_, 2, s);
+        }
+
+        /// The serialized profile.
+        std::string finish() const {
+            std::string out = body_;
+            for (const auto& s : table_) bytesField(out, 6, s);
+            return out;
+        }
+
+    private:
+        static void varint(std::string& out, std::uint64_t v) {
+            while (v >= 0x80) {
+                out.push_back(static_cast<char>(v | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<char>(v));
+        }
+
+        static void varintField(std::string& out, std::uint32_t field, std::uint64_t v) {
+            varint(out, static_cast<std::uint64_t>(field) << 3);
+            varint(out, v);
+        }
+
+        static void bytesField(std::string& out, std::uint32_t field, std::string_view data) {
+            varint(out, (static_cast<std::uint64_t>(field) << 3) | 2);
+            varint(out, data.size());
+            out.append(data);
+        }
+
+        static void message(std::string& out, std::uint32_t field, const std::string& m) { bytesField(out, field, m); }
+
+        std::string valueType(std::string_view type, std::string_view unit) {
+            std::string vt;
+            varintField(vt, 1, static_cast<std::uint64_t>(str(type)));
+            varintField(vt, 2, static_cast<std::uint64_t>(str(unit)));
+            return vt;
+        }
+
+        std::string body_;
+        std::vector<std::string> table_;
+        std::unordered_map<std::string, std::int64_t> strings_;
+        std::map<std::tuple<std::int64_t, std::int64_t>, std::uint64_t> functions_;
+        std::uint64_t mappings_ = 0;
+        std::uint64_t locations_ = 0;
+    };
+
+} // namespace gocxx::debug::detail
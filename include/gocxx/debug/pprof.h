@@ -0,0 +1,79 @@
+/**
+ * @file pprof.h
+ * @brief Runtime introspection over HTTP, like Go's net/http/pprof
+ *
+ * RegisterHandlers() adds a /debug/pprof/ tree to a ServeMux:
+ *
+ * | Path        | Contents                                                        |
+ * |-------------|-----------------------------------------------------------------|
+ * | `threads`   | every tracked thread, its task and what it is blocked on         |
+ * | `runtime`   | scheduler counters and the timer heap's depth                    |
+ * | `channels`  | channels that called enableStats(), see base::ListChannels()    |
+ * | `pools`     | sync::Pool hit rates, see sync::ListPools()                     |
+ * | `mutex`     | ProfiledMutex contention as a pprof profile (`?debug=1`: text)  |
+ * | `profile`   | a CPU profile over `?seconds=` (default 30), in pprof format     |
+ *
+ * The profiles open with the standard tooling:
+ *
+ * @code
+ * debug::RegisterHandlers(*mux);
+ * // go tool pprof http://localhost:6060/debug/pprof/profile?seconds=10
+ * // go tool pprof http://localhost:6060/debug/pprof/mutex
+ * @endcode
+ *
+ * The handlers expose internals and should only be reachable by operators.
+ */
+
+// gocxx/debug/pprof.h
+#pragma once
+#include <memory>
+#include <string>
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/io/io.h>
+
+namespace gocxx::net::http {
+class ServeMux;
+}
+
+namespace gocxx::debug {
+
+    /// StartCPUProfile() while a profile is already running.
+    extern std::shared_ptr<gocxx::errors::Error> ErrProfilingInUse;
+
+    /// CPU profiling needs SIGPROF and setitimer, which this platform lacks.
+    extern std::shared_ptr<gocxx::errors::Error> ErrProfilingUnsupported;
+
+    /**
+     * @brief Start sampling the stacks of running threads @p hz times per CPU second
+     *
+     * Like Go's pprof.StartCPUProfile. Samples come from SIGPROF, so only
+     * threads using CPU are seen; blocked ones show up in the thread list
+     * instead. Stacks are unwound with backtrace(), which is not strictly
+     * async-signal-safe: a sample that lands while a thread holds the
+     * dynamic loader's lock (dlopen, a first throw) can deadlock it, the
+     * same trade every in-process C++ sampler makes.
+     *
+     * @return ErrProfilingInUse if a profile is running already
+     */
+    gocxx::base::Result<void> StartCPUProfile(std::shared_ptr<gocxx::io::Writer> w, int hz = 100);
+
+    /// Stop the running CPU profile and write it to the writer given to StartCPUProfile().
+    gocxx::base::Result<void> StopCPUProfile();
+
+    /// Mutex contention recorded by ProfiledMutex, in pprof format (see sync::SetMutexProfileFraction).
+    gocxx::base::Result<void> WriteMutexProfile(gocxx::io::Writer& w);
+
+    /// Plain-text reports served by the handlers, for logging on demand.
+    std::string ThreadsReport();
+    std::string RuntimeReport();
+    std::string ChannelsReport();
+    std::string PoolsReport();
+    std::string MutexReport();
+
+    /**
+     * @brief Register the handlers under @p prefix, which should end in '/'
+     */
+    void RegisterHandlers(gocxx::net::http::ServeMux& mux, const std::string& prefix = "/debug/pprof/");
+
+} // namespace gocxx::debug
@@ -0,0 +1,134 @@
+/**
+ * @file base32.h
+ * @brief Base32 encoding as specified by RFC 4648, like Go's encoding/base32
+ *
+ * StdEncoding and HexEncoding ("extended hex") are provided, and
+ * NewEncoding() builds others. Groups of 5 bytes are packed into a 64-bit
+ * word and written as 8 characters at once; there is no vector kernel, as
+ * the 5-bit fields straddle bytes too unevenly for shuffles to pay.
+ *
+ * @code
+ * std::string s = base32::StdEncoding.EncodeToString("foobar");  // "MZXW6YTBOI======"
+ * auto data = base32::StdEncoding.DecodeString(s);
+ * @endcode
+ */
+
+#pragma once
+
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/io/io.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gocxx {
+namespace encoding {
+namespace base32 {
+
+/// Padding characters for WithPadding
+constexpr int32_t StdPadding = '=';
+constexpr int32_t NoPadding = -1;
+
+/**
+ * @brief Malformed input, at the byte offset given (newlines not counted)
+ *
+ * Go equivalent: base32.CorruptInputError
+ */
+class CorruptInputError : public gocxx::errors::Error {
+    int64_t offset_;
+
+public:
+    explicit CorruptInputError(int64_t offset) : offset_(offset) {}
+
+    std::string error() const noexcept override;
+    int64_t Offset() const { return offset_; }
+};
+
+/**
+ * @brief A radix 32 encoding/decoding scheme, defined by a 32-character alphabet
+ *
+ * Decoding ignores '\r' and '\n' anywhere in the input, as Go's does. An
+ * Encoding is an immutable value and safe to use from several threads.
+ */
+class Encoding {
+public:
+    /**
+     * @brief Builds an encoding from a 32-byte alphabet, padded with '='
+     *
+     * @throws std::invalid_argument if the alphabet is not 32 bytes long,
+     *         repeats a byte or contains '\r' or '\n'
+     */
+    explicit Encoding(std::string_view alphabet);
+
+    /**
+     * @brief The same encoding with another padding character, or NoPadding
+     *
+     * @throws std::invalid_argument if @p padding is '\r', '\n', above 0xff
+     *         or in the alphabet
+     */
+    Encoding WithPadding(int32_t padding) const;
+
+    /// The length of the encoding of @p n bytes.
+    std::size_t EncodedLen(std::size_t n) const;
+    /// The most bytes @p n bytes of encoded input can decode to.
+    std::size_t DecodedLen(std::size_t n) const;
+
+    /// Writes the EncodedLen(n) bytes encoding @p src to @p dst.
+    void Encode(uint8_t* dst, const uint8_t* src, std::size_t n) const;
+    std::string EncodeToString(const uint8_t* src, std::size_t n) const;
+    std::string EncodeToString(std::string_view src) const {
+        return EncodeToString(reinterpret_cast<const uint8_t*>(src.data()), src.size());
+    }
+    std::string EncodeToString(const std::vector<uint8_t>& src) const {
+        return EncodeToString(src.data(), src.size());
+    }
+    /// Appends the encoding of @p src to @p dst.
+    void AppendEncode(std::string& dst, std::string_view src) const;
+
+    /**
+     * @brief Decodes @p n bytes of @p src into @p dst, which must hold DecodedLen(n)
+     *
+     * @return The bytes written; on a CorruptInputError, those decoded
+     *         before the bad input
+     */
+    gocxx::base::Result<std::size_t> Decode(uint8_t* dst, const uint8_t* src, std::size_t n) const;
+    gocxx::base::Result<std::vector<uint8_t>> DecodeString(std::string_view s) const;
+    /// Appends the decoding of @p src to @p dst; on error, only what decoded before the bad input.
+    gocxx::base::Result<void> AppendDecode(std::string& dst, std::string_view src) const;
+
+private:
+    gocxx::base::Result<std::size_t> decode(uint8_t* dst, const uint8_t* src, std::size_t n) const;
+
+    char encode_[32];
+    uint8_t decode_[256];  // 0xff for bytes not in the alphabet
+    int32_t pad_ = StdPadding;
+};
+
+/// The standard encoding of RFC 4648
+extern const Encoding StdEncoding;
+/// The "Extended Hex Alphabet" of RFC 4648, which sorts as the data does
+extern const Encoding HexEncoding;
+
+/// Builds an encoding; see Encoding(std::string_view).
+inline Encoding NewEncoding(std::string_view alphabet) {
+    return Encoding(alphabet);
+}
+
+/**
+ * @brief A stream encoder writing base32 to @p w
+ *
+ * Partial groups are held back until more data arrives, so close() must be
+ * called to write the last one and its padding; it does not close @p w.
+ */
+std::shared_ptr<gocxx::io::WriteCloser> NewEncoder(const Encoding& enc, std::shared_ptr<gocxx::io::Writer> w);
+
+/// A stream decoder reading base32 from @p r.
+std::shared_ptr<gocxx::io::Reader> NewDecoder(const Encoding& enc, std::shared_ptr<gocxx::io::Reader> r);
+
+} // namespace base32
+} // namespace encoding
+} // namespace gocxx
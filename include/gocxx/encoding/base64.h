@@ -0,0 +1,161 @@
+/**
+ * @file base64.h
+ * @brief Base64 encoding as specified by RFC 4648, like Go's encoding/base64
+ *
+ * The four standard encodings are provided (StdEncoding, URLEncoding and
+ * their unpadded Raw forms) and NewEncoding() builds others. Encoding and
+ * decoding run 24 or 12 input bytes at a time with AVX2 or SSSE3 on
+ * x86-64, and 48 at a time with NEON on AArch64, wherever the input allows;
+ * the rest, and any block holding newlines, padding or bad bytes, takes
+ * the scalar path that reports errors exactly as Go does.
+ *
+ * @code
+ * std::string s = base64::StdEncoding.EncodeToString("hello");  // "aGVsbG8="
+ * auto data = base64::StdEncoding.DecodeString(s);
+ * @endcode
+ */
+
+#pragma once
+
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/io/io.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gocxx {
+namespace encoding {
+namespace base64 {
+
+/// Padding characters for WithPadding
+constexpr int32_t StdPadding = '=';
+constexpr int32_t NoPadding = -1;
+
+/**
+ * @brief Malformed input, at the byte offset given
+ *
+ * Go equivalent: base64.CorruptInputError
+ */
+class CorruptInputError : public gocxx::errors::Error {
+    int64_t offset_;
+
+public:
+    explicit CorruptInputError(int64_t offset) : offset_(offset) {}
+
+    std::string error() const noexcept override;
+    int64_t Offset() const { return offset_; }
+};
+
+namespace detail {
+/// The block kernel encoding and decoding use: "avx2", "ssse3", "neon" or "scalar".
+const char* Base64Kernel();
+/// Switches to the named kernel, for tests and benchmarks; false if this CPU lacks it.
+bool SetBase64Kernel(std::string_view name);
+} // namespace detail
+
+/**
+ * @brief A radix 64 encoding/decoding scheme, defined by a 64-character alphabet
+ *
+ * Decoding ignores '\r' and '\n' anywhere in the input, as Go's does. An
+ * Encoding is an immutable value and safe to use from several threads.
+ */
+class Encoding {
+public:
+    /**
+     * @brief Builds an encoding from a 64-byte alphabet, padded with '='
+     *
+     * @throws std::invalid_argument if the alphabet is not 64 bytes long,
+     *         repeats a byte or contains '\r' or '\n'
+     */
+    explicit Encoding(std::string_view alphabet);
+
+    /**
+     * @brief The same encoding with another padding character, or NoPadding
+     *
+     * @throws std::invalid_argument if @p padding is '\r', '\n', above 0xff
+     *         or in the alphabet
+     */
+    Encoding WithPadding(int32_t padding) const;
+
+    /**
+     * @brief The same encoding, but decoding rejects non-zero padding bits
+     *
+     * See RFC 4648 section 3.5.
+     */
+    Encoding Strict() const;
+
+    /// The length of the encoding of @p n bytes.
+    std::size_t EncodedLen(std::size_t n) const;
+    /// The most bytes @p n bytes of encoded input can decode to.
+    std::size_t DecodedLen(std::size_t n) const;
+
+    /// Writes the EncodedLen(n) bytes encoding @p src to @p dst.
+    void Encode(uint8_t* dst, const uint8_t* src, std::size_t n) const;
+    std::string EncodeToString(const uint8_t* src, std::size_t n) const;
+    std::string EncodeToString(std::string_view src) const {
+        return EncodeToString(reinterpret_cast<const uint8_t*>(src.data()), src.size());
+    }
+    std::string EncodeToString(const std::vector<uint8_t>& src) const {
+        return EncodeToString(src.data(), src.size());
+    }
+    /// Appends the encoding of @p src to @p dst.
+    void AppendEncode(std::string& dst, std::string_view src) const;
+
+    /**
+     * @brief Decodes @p n bytes of @p src into @p dst, which must hold DecodedLen(n)
+     *
+     * @return The bytes written; on a CorruptInputError, those decoded
+     *         before the bad input
+     */
+    gocxx::base::Result<std::size_t> Decode(uint8_t* dst, const uint8_t* src, std::size_t n) const;
+    gocxx::base::Result<std::vector<uint8_t>> DecodeString(std::string_view s) const;
+    /// Appends the decoding of @p src to @p dst; on error, only what decoded before the bad input.
+    gocxx::base::Result<void> AppendDecode(std::string& dst, std::string_view src) const;
+
+private:
+    std::size_t decodeQuantum(uint8_t* dst, const uint8_t* src, std::size_t n, std::size_t& si,
+                              std::shared_ptr<gocxx::errors::Error>& err) const;
+
+    char encode_[64];
+    uint8_t decode_[256];  // 0xff for bytes not in the alphabet
+    int32_t pad_ = StdPadding;
+    bool strict_ = false;
+    bool standard_ = false;  // A-Z, a-z and 0-9 come first, which the x86 kernels assume
+};
+
+/// The standard encoding of RFC 4648
+extern const Encoding StdEncoding;
+/// The alternate encoding of RFC 4648, for URLs and file names
+extern const Encoding URLEncoding;
+/// StdEncoding without padding, as in RFC 4648 section 3.2
+extern const Encoding RawStdEncoding;
+/// URLEncoding without padding
+extern const Encoding RawURLEncoding;
+
+/// Builds an encoding; see Encoding(std::string_view).
+inline Encoding NewEncoding(std::string_view alphabet) {
+    return Encoding(alphabet);
+}
+
+/**
+ * @brief A stream encoder writing base64 to @p w
+ *
+ * Partial groups are held back until more data arrives, so close() must be
+ * called to write the last one and its padding; it does not close @p w.
+ */
+std::shared_ptr<gocxx::io::WriteCloser> NewEncoder(const Encoding& enc, std::shared_ptr<gocxx::io::Writer> w);
+
+/**
+ * @brief A stream decoder reading base64 from @p r
+ *
+ * Error offsets count from the start of the stream.
+ */
+std::shared_ptr<gocxx::io::Reader> NewDecoder(const Encoding& enc, std::shared_ptr<gocxx::io::Reader> r);
+
+} // namespace base64
+} // namespace encoding
+} // namespace gocxx
@@ -0,0 +1,95 @@
+/**
+ * @file hex.h
+ * @brief Hexadecimal encoding and decoding, like Go's encoding/hex
+ *
+ * Encoding writes lower-case digits; decoding takes either case. Both run
+ * 32 input bytes at a time with AVX2, 16 with SSSE3 or NEON, and fall back
+ * to a table per byte for what is left and for blocks holding a bad byte,
+ * so errors name the same byte Go's would.
+ *
+ * @code
+ * std::string s = hex::EncodeToString("Hello");  // "48656c6c6f"
+ * auto data = hex::DecodeString(s);
+ * @endcode
+ */
+
+#pragma once
+
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/io/io.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gocxx {
+namespace encoding {
+namespace hex {
+
+/// Decoding stopped at the last byte of an odd-length input
+extern std::shared_ptr<gocxx::errors::Error> ErrLength;
+
+/**
+ * @brief A byte that is not a hexadecimal digit
+ *
+ * Go equivalent: hex.InvalidByteError
+ */
+class InvalidByteError : public gocxx::errors::Error {
+    uint8_t byte_;
+
+public:
+    explicit InvalidByteError(uint8_t b) : byte_(b) {}
+
+    std::string error() const noexcept override;
+    uint8_t Byte() const { return byte_; }
+};
+
+namespace detail {
+/// The block kernel encoding and decoding use: "avx2", "ssse3", "neon" or "scalar".
+const char* HexKernel();
+/// Switches to the named kernel, for tests and benchmarks; false if this CPU lacks it.
+bool SetHexKernel(std::string_view name);
+} // namespace detail
+
+inline std::size_t EncodedLen(std::size_t n) { return n * 2; }
+inline std::size_t DecodedLen(std::size_t n) { return n / 2; }
+
+/// Writes the EncodedLen(n) digits of @p src to @p dst.
+void Encode(uint8_t* dst, const uint8_t* src, std::size_t n);
+std::string EncodeToString(const uint8_t* src, std::size_t n);
+inline std::string EncodeToString(std::string_view src) {
+    return EncodeToString(reinterpret_cast<const uint8_t*>(src.data()), src.size());
+}
+inline std::string EncodeToString(const std::vector<uint8_t>& src) {
+    return EncodeToString(src.data(), src.size());
+}
+/// Appends the digits of @p src to @p dst.
+void AppendEncode(std::string& dst, std::string_view src);
+
+/**
+ * @brief Decodes the @p n digits of @p src into @p dst, which must hold DecodedLen(n)
+ *
+ * @return The bytes written; on an InvalidByteError or ErrLength, those
+ *         decoded before the bad input
+ */
+gocxx::base::Result<std::size_t> Decode(uint8_t* dst, const uint8_t* src, std::size_t n);
+gocxx::base::Result<std::vector<uint8_t>> DecodeString(std::string_view s);
+/// Appends the decoding of @p src to @p dst; on error, only what decoded before the bad input.
+gocxx::base::Result<void> AppendDecode(std::string& dst, std::string_view src);
+
+/// A stream encoder writing the digits of what is written to it to @p w.
+std::shared_ptr<gocxx::io::Writer> NewEncoder(std::shared_ptr<gocxx::io::Writer> w);
+
+/**
+ * @brief A stream decoder reading digits from @p r
+ *
+ * An odd number of digits ends in io::ErrUnexpectedEOF.
+ */
+std::shared_ptr<gocxx::io::Reader> NewDecoder(std::shared_ptr<gocxx::io::Reader> r);
+
+} // namespace hex
+} // namespace encoding
+} // namespace gocxx
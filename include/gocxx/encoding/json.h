@@ -26,10 +26,13 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <functional>
 #include <map>
 #include <sstream>
 #include <istream>
 #include <ostream>
+#include <string_view>
+#include <type_traits>
 
 #include <nlohmann/json.hpp>
 #include <gocxx/base/result.h>
@@ -48,6 +51,31 @@ using JsonObject = std::map<std::string, JsonValue>;
 class Encoder;
 class Decoder;
 
+namespace detail {
+struct WriteState;
+
+/// Whether T has a field table, from GOCXX_JSON_FIELDS (see json_struct.h)
+template <typename T, typename = void>
+struct HasJsonFields : std::false_type {};
+template <typename T>
+struct HasJsonFields<T, std::void_t<decltype(gocxxJsonFields(static_cast<const T*>(nullptr)))>>
+    : std::true_type {};
+} // namespace detail
+
+/**
+ * @brief One token of a JSON stream, as Decoder::Token returns it
+ * Go equivalent: encoding/json.Token, with Delim for the delimiters
+ *
+ * Either a delimiter ('[', ']', '{' or '}') or a value: a string (object
+ * keys included), number, bool or null. Commas and colons are not tokens.
+ */
+struct JsonToken {
+    char delim = 0;   ///< The delimiter, or 0 when this is a value
+    JsonValue value;  ///< The value, when delim is 0
+
+    bool IsDelim() const { return delim != 0; }
+};
+
 // Core JSON functions - exact Go API
 
 /**
@@ -143,6 +171,13 @@ std::unique_ptr<Decoder> NewDecoder(std::shared_ptr<gocxx::io::Reader> reader);
 /**
  * @brief JSON Encoder for streaming JSON output
  * Go equivalent: encoding/json.Encoder
+ *
+ * Serializes straight into a buffer it keeps between calls and hands the
+ * writer a chunk whenever 32KB have built up, so a large value is never
+ * held whole and a small one costs a single Write. Output follows Go:
+ * shortest round-trip floats, sorted object keys, and <, >, & escaped
+ * unless SetEscapeHTML(false). An error partway through a value larger
+ * than a chunk leaves what was already flushed written.
  */
 class Encoder {
 private:
@@ -150,7 +185,11 @@ private:
     std::string indent_;
     std::string prefix_;
     bool escape_html_;
-    
+    std::string buf_;
+    std::string compact_;  // a value before indenting
+
+    gocxx::base::Result<void> encodeWith(const std::function<void(detail::WriteState&)>& write);
+
 public:
     explicit Encoder(std::shared_ptr<gocxx::io::Writer> writer);
     
@@ -161,10 +200,21 @@ public:
      * @return Result indicating success or error
      */
     gocxx::base::Result<void> Encode(const JsonValue& value);
+
+    /**
+     * @brief Encode writes a struct declared with GOCXX_JSON_FIELDS, without building a JsonValue
+     *
+     * Defined in json_struct.h.
+     */
+    template <typename T, std::enable_if_t<detail::HasJsonFields<T>::value, int> = 0>
+    gocxx::base::Result<void> Encode(const T& value);
     
     /**
      * @brief SetIndent instructs the encoder to format each JSON element on a new line
      * Go equivalent: func (enc *Encoder) SetIndent(prefix, indent string)
+     *
+     * An indented value is serialized whole, then indented and written in chunks.
+     *
      * @param prefix String to prefix each line with
      * @param indent String to use for each level of indentation
      */
@@ -179,25 +229,69 @@ public:
 };
 
 /**
- * @brief JSON Decoder for streaming JSON input  
+ * @brief JSON Decoder for streaming JSON input
  * Go equivalent: encoding/json.Decoder
+ *
+ * Reads through an internal buffer that holds only the value being decoded
+ * and what the last read brought in after it, so a stream of any length
+ * (several values in a row, NDJSON, or one huge array walked with Token()
+ * and More()) is decoded in memory proportional to its largest element.
+ * Each value is scanned once as its bytes arrive; bytes after it stay
+ * buffered for the next call.
  */
 class Decoder {
 private:
+    enum class TokenState : uint8_t {
+        TopValue, ArrayStart, ArrayValue, ArrayComma,
+        ObjectStart, ObjectKey, ObjectColon, ObjectValue, ObjectComma,
+    };
+
     std::shared_ptr<gocxx::io::Reader> reader_;
     bool use_number_;
     bool disable_unknown_fields_;
-    
+
+    std::vector<uint8_t> buf_;
+    std::size_t scanp_ = 0;   // first unread byte in buf_
+    std::size_t len_ = 0;     // bytes of buf_ holding data
+    std::size_t dropped_ = 0; // bytes of input compacted out of buf_
+    std::shared_ptr<gocxx::errors::Error> err_;  // sticky: the read or syntax error that ended the stream
+
+    TokenState token_state_ = TokenState::TopValue;
+    std::vector<TokenState> token_stack_;
+
+    gocxx::base::Result<void> refill();
+    gocxx::base::Result<uint8_t> peek();
+    gocxx::base::Result<std::size_t> readValue();
+    gocxx::base::Result<std::string_view> nextValue();
+    void valueDone(std::size_t n);
+    gocxx::base::Result<void> tokenPrepareForDecode();
+    bool tokenValueAllowed() const;
+    void tokenValueEnd();
+    std::shared_ptr<gocxx::errors::Error> tokenError(uint8_t c) const;
+
 public:
     explicit Decoder(std::shared_ptr<gocxx::io::Reader> reader);
     
     /**
      * @brief Decode reads the next JSON-encoded value from its input and stores it in value
      * Go equivalent: func (dec *Decoder) Decode(v interface{}) error
+     *
+     * Inside an array or object opened with Token(), reads its next element.
+     *
      * @param value Reference to store decoded value
-     * @return Result indicating success or error
+     * @return Result indicating success or error; io::ErrEOF at the end of
+     *         the input, io::ErrUnexpectedEOF if it ends inside a value
      */
     gocxx::base::Result<void> Decode(JsonValue& value);
+
+    /**
+     * @brief Decode reads the next value straight into a struct declared with GOCXX_JSON_FIELDS
+     *
+     * No JsonValue is built. With DisallowUnknownFields, an object key
+     * matching no field is an error. Defined in json_struct.h.
+     */
+    template <typename T, std::enable_if_t<detail::HasJsonFields<T>::value, int> = 0>
+    gocxx::base::Result<void> Decode(T& value);
     
     /**
      * @brief More reports whether there is another element in the current array or object
@@ -209,9 +303,19 @@ public:
     /**
      * @brief Token returns the next JSON token in the input stream
      * Go equivalent: func (dec *Decoder) Token() (Token, error)
-     * @return Result containing next token or error
+     *
+     * Commas and colons are checked and skipped. Token and Decode can be
+     * mixed: Decode reads a whole value wherever Token would return one.
+     *
+     * @return Result containing next token or error; io::ErrEOF at the end of the input
+     */
+    gocxx::base::Result<JsonToken> Token();
+
+    /**
+     * @brief InputOffset returns the offset in the input of the next byte to read
+     * Go equivalent: func (dec *Decoder) InputOffset() int64
      */
-    gocxx::base::Result<JsonValue> Token();
+    std::size_t InputOffset() const { return dropped_ + scanp_; }
     
     /**
      * @brief UseNumber causes Decoder to unmarshal numbers as strings instead of floats
@@ -222,6 +326,9 @@ public:
     /**
      * @brief DisallowUnknownFields causes Decoder to return an error when encountering unknown fields
      * Go equivalent: func (dec *Decoder) DisallowUnknownFields()
+     *
+     * Applies when decoding into structs declared with GOCXX_JSON_FIELDS;
+     * a JsonValue takes any field.
      */
     void DisallowUnknownFields();
 };
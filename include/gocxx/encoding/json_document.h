@@ -0,0 +1,236 @@
+/**
+ * @file json_document.h
+ * @brief On-demand JSON parsing without building a DOM
+ *
+ * Document::Parse validates a JSON text and indexes where its tokens are,
+ * using SIMD (AVX2 or SSE2 on x86-64, NEON on AArch64) to classify 64
+ * bytes at a time in the manner of simdjson. Nothing is materialised:
+ * an Element is a position in that index, and its value is read only when
+ * asked for. Strings come back as views into the input unless they contain
+ * escapes, and skipping an array or object is a single jump.
+ *
+ * @code
+ * json::Document doc;
+ * if (doc.Parse(body).Ok()) {
+ *     auto id = doc.Root().Get("user").value.Get("id").value.GetInt();
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <gocxx/encoding/json.h>
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gocxx {
+namespace encoding {
+namespace json {
+
+/// The element is not of the type asked for
+extern std::shared_ptr<gocxx::errors::Error> ErrIncorrectType;
+/// The object has no member with the given key
+extern std::shared_ptr<gocxx::errors::Error> ErrNoSuchField;
+/// An array index past the end, or a number that does not fit the requested type
+extern std::shared_ptr<gocxx::errors::Error> ErrOutOfRange;
+
+namespace detail {
+/// The block classifier Document::Parse uses: "avx2", "sse2", "neon" or "scalar".
+const char* JsonKernel();
+/// Switches to the named classifier, for tests and benchmarks; false if this CPU lacks it.
+bool SetJsonKernel(std::string_view name);
+} // namespace detail
+
+/// The kind of JSON value an Element holds
+enum class Kind { Null, Bool, Number, String, Array, Object };
+
+class Document;
+struct Member;
+
+/**
+ * @brief A value inside a Document, read on demand
+ *
+ * A small handle, cheap to copy; it is valid while its Document is alive,
+ * unchanged and not parsed again.
+ */
+class Element {
+public:
+    class ArrayRange;
+    class ObjectRange;
+
+    Element() = default;
+
+    Kind Type() const;
+    bool IsNull() const { return Type() == Kind::Null; }
+
+    gocxx::base::Result<bool> GetBool() const;
+
+    /// The number as an integer; ErrIncorrectType if it has a fraction or exponent, ErrOutOfRange if it overflows
+    gocxx::base::Result<int64_t> GetInt() const;
+    gocxx::base::Result<uint64_t> GetUint() const;
+    gocxx::base::Result<double> GetFloat() const;
+
+    /**
+     * @brief The string's contents
+     *
+     * A view into the input when the string has no escapes, otherwise into
+     * storage the Document owns; either way it lives as long as the Document.
+     */
+    gocxx::base::Result<std::string_view> GetString() const;
+
+    /// The element's JSON text, as it appears in the input.
+    std::string_view Raw() const;
+
+    /// The value of the object member named @p key (the first one, if repeated).
+    gocxx::base::Result<Element> Get(std::string_view key) const;
+
+    /// The array element at @p index.
+    gocxx::base::Result<Element> At(std::size_t index) const;
+
+    /// The number of elements of an array or members of an object.
+    gocxx::base::Result<std::size_t> Size() const;
+
+    /// The array's elements, in order; empty if this is not an array.
+    ArrayRange Elements() const;
+
+    /// The object's members, in order; empty if this is not an object.
+    ObjectRange Members() const;
+
+    /// Builds the nlohmann value, like Unmarshal would have.
+    gocxx::base::Result<JsonValue> Value() const;
+
+private:
+    friend class Document;
+    Element(const Document* doc, uint32_t index) : doc_(doc), index_(index) {}
+
+    uint32_t next() const;       // index just past this value
+    uint32_t following() const;  // index of the next sibling, or of the closing bracket
+
+    const Document* doc_ = nullptr;
+    uint32_t index_ = 0;  // into the Document's structural index
+};
+
+/// One object member: its key (unescaped) and value
+struct Member {
+    std::string_view key;
+    Element value;
+};
+
+class Element::ArrayRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Element;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Element*;
+        using reference = Element;
+
+        Element operator*() const { return Element(doc_, index_); }
+        iterator& operator++();
+        bool operator==(const iterator& o) const { return index_ == o.index_; }
+        bool operator!=(const iterator& o) const { return index_ != o.index_; }
+
+    private:
+        friend class ArrayRange;
+        iterator(const Document* doc, uint32_t index) : doc_(doc), index_(index) {}
+        const Document* doc_;
+        uint32_t index_;
+    };
+
+    iterator begin() const { return iterator(doc_, begin_); }
+    iterator end() const { return iterator(doc_, end_); }
+
+private:
+    friend class Element;
+    ArrayRange(const Document* doc, uint32_t begin, uint32_t end) : doc_(doc), begin_(begin), end_(end) {}
+    const Document* doc_;
+    uint32_t begin_;
+    uint32_t end_;
+};
+
+class Element::ObjectRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Member;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Member*;
+        using reference = Member;
+
+        Member operator*() const;
+        iterator& operator++();
+        bool operator==(const iterator& o) const { return index_ == o.index_; }
+        bool operator!=(const iterator& o) const { return index_ != o.index_; }
+
+    private:
+        friend class ObjectRange;
+        iterator(const Document* doc, uint32_t index) : doc_(doc), index_(index) {}
+        const Document* doc_;
+        uint32_t index_;  // at the key
+    };
+
+    iterator begin() const { return iterator(doc_, begin_); }
+    iterator end() const { return iterator(doc_, end_); }
+
+private:
+    friend class Element;
+    ObjectRange(const Document* doc, uint32_t begin, uint32_t end) : doc_(doc), begin_(begin), end_(end) {}
+    const Document* doc_;
+    uint32_t begin_;
+    uint32_t end_;
+};
+
+/**
+ * @brief A parsed JSON text, indexed for on-demand access
+ *
+ * Parse checks the whole text against the JSON grammar, including string
+ * escapes and UTF-8, so element accessors fail only on a type or range
+ * mismatch. The input is not copied and must outlive the Document and its
+ * Elements. A Document can be parsed again to reuse its buffers. Reading
+ * from several threads at once is safe, except for strings and keys that
+ * contain escapes, which are unescaped into storage the Document owns.
+ */
+class Document {
+public:
+    /// Nesting deeper than this is rejected, as Go's decoder does.
+    static constexpr std::size_t kMaxDepth = 10000;
+
+    Document() = default;
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    /**
+     * @brief Validates and indexes @p json
+     *
+     * @return An error describing the first problem and its byte offset
+     */
+    gocxx::base::Result<void> Parse(std::string_view json);
+
+    /// The top-level value; a default Element before a successful Parse.
+    Element Root() const;
+
+private:
+    friend class Element;
+
+    std::string_view unescape(std::size_t quote, std::size_t end) const;
+
+    std::string_view input_;
+    std::vector<uint32_t> index_;  // offset of each token: brackets, ':' and ',', opening quotes, scalars; may have spare entries past the last
+    std::vector<uint32_t> ends_;   // for an opening bracket, the index of its closing one
+    bool parsed_ = false;
+    mutable std::deque<std::string> unescaped_;
+};
+
+} // namespace json
+} // namespace encoding
+} // namespace gocxx
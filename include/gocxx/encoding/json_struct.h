@@ -0,0 +1,493 @@
+/**
+ * @file json_struct.h
+ * @brief Compile-time binding of structs to JSON, without a DOM
+ *
+ * GOCXX_JSON_FIELDS(Type, a, b, c) gives Type a constexpr table of its
+ * fields. Marshal then writes a Type straight to JSON text, and Unmarshal
+ * and Decoder::Decode read one straight from a json::Document's token
+ * index, one pass each with no JsonValue in between.
+ *
+ * Fields may be bool, integers, floating point, std::string, JsonValue,
+ * std::optional, std::vector, std::map or std::unordered_map keyed by
+ * std::string, or other types with a field table. As in Go, object keys
+ * match fields exactly or else ignoring ASCII case, keys with no field are
+ * skipped (unless the Decoder disallows them), null leaves a field as it
+ * is, and map keys are written sorted.
+ *
+ * @code
+ * struct User {
+ *     int64_t id = 0;
+ *     std::string name;
+ *     std::vector<std::string> tags;
+ * };
+ * GOCXX_JSON_FIELDS(User, id, name, tags)
+ *
+ * User u;
+ * auto err = json::UnmarshalString(body, u);
+ * auto out = json::MarshalString(u);
+ * @endcode
+ *
+ * Where a key differs from the member's name, write the table out instead,
+ * in the type's namespace:
+ *
+ * @code
+ * constexpr auto gocxxJsonFields(const User*) {
+ *     return std::make_tuple(json::Field("user_id", &User::id), json::Field("name", &User::name));
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <gocxx/encoding/json.h>
+#include <gocxx/encoding/json_document.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace gocxx {
+namespace encoding {
+namespace json {
+
+/**
+ * @brief One entry of a field table: the JSON key and the member it maps to
+ */
+template <typename T, typename M>
+struct Field {
+    using member_type = M;
+
+    std::string_view name;
+    M T::*member;
+
+    constexpr Field(std::string_view name, M T::*member) : name(name), member(member) {}
+};
+
+namespace detail {
+
+/// Where a value being read sits: the chain of field names from the top
+struct ReadContext {
+    bool disallow_unknown = false;
+    std::string_view field;
+    const ReadContext* parent = nullptr;
+};
+
+void AppendQuoted(std::string& out, std::string_view s, bool escape_html = false);
+bool AppendFloat(std::string& out, double v);  // false for NaN and infinities
+bool AppendFloat(std::string& out, float v);
+bool EqualFold(std::string_view a, std::string_view b);
+std::shared_ptr<gocxx::errors::Error> TypeError(const Element& e, std::string_view want, const ReadContext& ctx);
+std::shared_ptr<gocxx::errors::Error> UnknownFieldError(std::string_view key, const ReadContext& ctx);
+std::shared_ptr<gocxx::errors::Error> UnsupportedValueError(double v);
+Document& ScratchDocument();  // per thread, so its buffers are reused
+
+/// Where a value is written to, and how
+struct WriteState {
+    static constexpr std::size_t kFlushAt = 32 * 1024;
+
+    explicit WriteState(std::string& out) : out(out) {}
+
+    std::string& out;
+    bool escape_html = false;
+    gocxx::io::Writer* sink = nullptr;  // when set, out is handed to it each time it passes kFlushAt
+    std::shared_ptr<gocxx::errors::Error> err;
+
+    void quote(std::string_view s) { AppendQuoted(out, s, escape_html); }
+    void flushIfFull() {
+        if (sink && out.size() >= kFlushAt) flush();
+    }
+    void flush();
+};
+
+/// Writes any JsonValue the way Go's encoder would write the same value
+void WriteValue(WriteState& w, const JsonValue& v);
+
+/// Go's json.Indent over compact JSON, except that the first line gets the prefix too
+void AppendIndented(std::string& out, std::string_view compact, std::string_view prefix, std::string_view indent);
+
+/// How one C++ type is written and read; there is none for unsupported types
+template <typename T, typename = void>
+struct Codec;
+
+template <>
+struct Codec<bool> {
+    static void write(WriteState& w, bool v) { w.out += v ? "true" : "false"; }
+    static gocxx::base::Result<void> read(const Element& e, bool& v, const ReadContext& ctx) {
+        auto b = e.GetBool();
+        if (b.Ok()) {
+            v = b.value;
+            return {};
+        }
+        return e.IsNull() ? gocxx::base::Result<void>() : gocxx::base::Result<void>(TypeError(e, "bool", ctx));
+    }
+};
+
+template <typename T>
+struct Codec<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static constexpr std::string_view name() {
+        constexpr std::string_view kSigned[] = {"int8", "int16", "int32", "int32", "int64"};
+        constexpr std::string_view kUnsigned[] = {"uint8", "uint16", "uint32", "uint32", "uint64"};
+        constexpr std::size_t i = sizeof(T) == 8 ? 4 : sizeof(T) - 1;
+        return std::is_signed_v<T> ? kSigned[i] : kUnsigned[i];
+    }
+
+    static void write(WriteState& w, T v) {
+        char buf[24];
+        auto res = std::to_chars(buf, buf + sizeof(buf), v);
+        w.out.append(buf, res.ptr);
+    }
+
+    static gocxx::base::Result<void> read(const Element& e, T& v, const ReadContext& ctx) {
+        if (e.IsNull()) {
+            return {};
+        }
+        if constexpr (std::is_signed_v<T>) {
+            auto n = e.GetInt();
+            if (n.Ok() && n.value >= std::numeric_limits<T>::min() && n.value <= std::numeric_limits<T>::max()) {
+                v = static_cast<T>(n.value);
+                return {};
+            }
+        } else {
+            auto n = e.GetUint();
+            if (n.Ok() && n.value <= std::numeric_limits<T>::max()) {
+                v = static_cast<T>(n.value);
+                return {};
+            }
+        }
+        return {TypeError(e, name(), ctx)};
+    }
+};
+
+template <typename T>
+struct Codec<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static void write(WriteState& w, T v) {
+        if (!AppendFloat(w.out, v) && !w.err) {
+            w.err = UnsupportedValueError(static_cast<double>(v));
+        }
+    }
+
+    static gocxx::base::Result<void> read(const Element& e, T& v, const ReadContext& ctx) {
+        if (e.IsNull()) {
+            return {};
+        }
+        auto f = e.GetFloat();
+        if (f.Ok() && std::fabs(f.value) <= std::numeric_limits<T>::max()) {
+            v = static_cast<T>(f.value);
+            return {};
+        }
+        return {TypeError(e, sizeof(T) == 4 ? "float32" : "float64", ctx)};
+    }
+};
+
+template <>
+struct Codec<std::string> {
+    static void write(WriteState& w, const std::string& v) { w.quote(v); }
+    static gocxx::base::Result<void> read(const Element& e, std::string& v, const ReadContext& ctx) {
+        auto s = e.GetString();
+        if (s.Ok()) {
+            v.assign(s.value);
+            return {};
+        }
+        return e.IsNull() ? gocxx::base::Result<void>() : gocxx::base::Result<void>(TypeError(e, "string", ctx));
+    }
+};
+
+template <>
+struct Codec<JsonValue> {
+    static void write(WriteState& w, const JsonValue& v) { WriteValue(w, v); }
+    static gocxx::base::Result<void> read(const Element& e, JsonValue& v, const ReadContext&) {
+        auto value = e.Value();
+        if (value.Failed()) {
+            return {value.err};
+        }
+        v = std::move(value.value);
+        return {};
+    }
+};
+
+template <typename U>
+struct Codec<std::optional<U>> {
+    static void write(WriteState& w, const std::optional<U>& v) {
+        if (v) {
+            Codec<U>::write(w, *v);
+        } else {
+            w.out += "null";
+        }
+    }
+    static gocxx::base::Result<void> read(const Element& e, std::optional<U>& v, const ReadContext& ctx) {
+        if (e.IsNull()) {
+            v.reset();
+            return {};
+        }
+        if (!v) {
+            v.emplace();
+        }
+        return Codec<U>::read(e, *v, ctx);
+    }
+};
+
+template <typename U, typename A>
+struct Codec<std::vector<U, A>> {
+    static void write(WriteState& w, const std::vector<U, A>& v) {
+        w.out += '[';
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            if (i) w.out += ',';
+            Codec<U>::write(w, v[i]);
+            w.flushIfFull();
+        }
+        w.out += ']';
+    }
+    static gocxx::base::Result<void> read(const Element& e, std::vector<U, A>& v, const ReadContext& ctx) {
+        if (e.Type() != Kind::Array) {
+            return e.IsNull() ? gocxx::base::Result<void>() : gocxx::base::Result<void>(TypeError(e, "array", ctx));
+        }
+        v.clear();
+        v.reserve(e.Size().value);  // counting skips over the elements, so it is cheap
+        for (Element item : e.Elements()) {
+            U value{};
+            auto r = Codec<U>::read(item, value, ctx);
+            if (r.Failed()) {
+                return r;
+            }
+            v.push_back(std::move(value));
+        }
+        return {};
+    }
+};
+
+/// Both kinds of string-keyed map; Sorted when iteration already follows key order
+template <typename Map, bool Sorted>
+struct MapCodec {
+    using U = typename Map::mapped_type;
+
+    static void write(WriteState& w, const Map& v) {
+        std::vector<const typename Map::value_type*> entries;
+        entries.reserve(v.size());
+        for (const auto& kv : v) entries.push_back(&kv);
+        if constexpr (!Sorted) {
+            std::sort(entries.begin(), entries.end(), [](auto* a, auto* b) { return a->first < b->first; });
+        }
+        w.out += '{';
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (i) w.out += ',';
+            w.quote(entries[i]->first);
+            w.out += ':';
+            Codec<U>::write(w, entries[i]->second);
+            w.flushIfFull();
+        }
+        w.out += '}';
+    }
+
+    static gocxx::base::Result<void> read(const Element& e, Map& v, const ReadContext& ctx) {
+        if (e.Type() != Kind::Object) {
+            return e.IsNull() ? gocxx::base::Result<void>() : gocxx::base::Result<void>(TypeError(e, "object", ctx));
+        }
+        for (const Member& m : e.Members()) {
+            U value{};
+            const ReadContext child{ctx.disallow_unknown, m.key, &ctx};
+            auto r = Codec<U>::read(m.value, value, child);
+            if (r.Failed()) {
+                return r;
+            }
+            v.insert_or_assign(std::string(m.key), std::move(value));
+        }
+        return {};
+    }
+};
+
+template <typename U, typename C, typename A>
+struct Codec<std::map<std::string, U, C, A>>
+    : MapCodec<std::map<std::string, U, C, A>, std::is_same_v<C, std::less<std::string>> || std::is_same_v<C, std::less<>>> {};
+
+template <typename U, typename H, typename E, typename A>
+struct Codec<std::unordered_map<std::string, U, H, E, A>> : MapCodec<std::unordered_map<std::string, U, H, E, A>, false> {};
+
+template <typename T>
+struct Codec<T, std::enable_if_t<HasJsonFields<T>::value>> {
+    static constexpr auto kFields = gocxxJsonFields(static_cast<const T*>(nullptr));
+
+    static void write(WriteState& w, const T& v) {
+        w.out += '{';
+        bool first = true;
+        std::apply(
+            [&](const auto&... f) {
+                ((w.out += first ? "" : ",", first = false, w.quote(f.name), w.out += ':',
+                  Codec<typename std::decay_t<decltype(f)>::member_type>::write(w, v.*(f.member)),
+                  w.flushIfFull()),
+                 ...);
+            },
+            kFields);
+        w.out += '}';
+    }
+
+    static gocxx::base::Result<void> read(const Element& e, T& v, const ReadContext& ctx) {
+        if (e.Type() != Kind::Object) {
+            return e.IsNull() ? gocxx::base::Result<void>() : gocxx::base::Result<void>(TypeError(e, "object", ctx));
+        }
+        for (const Member& m : e.Members()) {
+            gocxx::base::Result<void> r;
+            bool found = false;
+            auto bind = [&](const auto& f, bool fold) {
+                if (found || !(fold ? EqualFold(f.name, m.key) : f.name == m.key)) {
+                    return;
+                }
+                found = true;
+                const ReadContext child{ctx.disallow_unknown, f.name, &ctx};
+                r = Codec<typename std::decay_t<decltype(f)>::member_type>::read(m.value, v.*(f.member), child);
+            };
+            std::apply([&](const auto&... f) { (bind(f, false), ...); }, kFields);
+            if (!found) {
+                std::apply([&](const auto&... f) { (bind(f, true), ...); }, kFields);
+            }
+            if (!found && ctx.disallow_unknown) {
+                return {UnknownFieldError(m.key, ctx)};
+            }
+            if (r.Failed()) {
+                return r;
+            }
+        }
+        return {};
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Marshal returns the JSON encoding of a struct declared with GOCXX_JSON_FIELDS
+ * Go equivalent: json.Marshal(v interface{}) ([]byte, error)
+ */
+template <typename T, std::enable_if_t<detail::HasJsonFields<T>::value, int> = 0>
+gocxx::base::Result<std::string> MarshalString(const T& value) {
+    std::string out;
+    detail::WriteState w(out);
+    detail::Codec<T>::write(w, value);
+    if (w.err) {
+        return {w.err};
+    }
+    return {std::move(out)};
+}
+
+template <typename T, std::enable_if_t<detail::HasJsonFields<T>::value, int> = 0>
+gocxx::base::Result<std::vector<uint8_t>> Marshal(const T& value) {
+    auto text = MarshalString(value);
+    if (text.Failed()) {
+        return {text.err};
+    }
+    return {std::vector<uint8_t>(text.value.begin(), text.value.end())};
+}
+
+/**
+ * @brief Unmarshal parses JSON into a struct declared with GOCXX_JSON_FIELDS
+ * Go equivalent: json.Unmarshal(data []byte, v interface{}) error
+ *
+ * Fields the input does not mention keep their values.
+ */
+template <typename T, std::enable_if_t<detail::HasJsonFields<T>::value, int> = 0>
+gocxx::base::Result<void> UnmarshalString(std::string_view data, T& value) {
+    Document& doc = detail::ScratchDocument();
+    auto parsed = doc.Parse(data);
+    if (parsed.Failed()) {
+        return parsed;
+    }
+    return detail::Codec<T>::read(doc.Root(), value, detail::ReadContext{});
+}
+
+template <typename T, std::enable_if_t<detail::HasJsonFields<T>::value, int> = 0>
+gocxx::base::Result<void> Unmarshal(const std::vector<uint8_t>& data, T& value) {
+    return UnmarshalString(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()), value);
+}
+
+template <typename T, std::enable_if_t<detail::HasJsonFields<T>::value, int>>
+gocxx::base::Result<void> Encoder::Encode(const T& value) {
+    return encodeWith([&value](detail::WriteState& w) { detail::Codec<T>::write(w, value); });
+}
+
+template <typename T, std::enable_if_t<detail::HasJsonFields<T>::value, int>>
+gocxx::base::Result<void> Decoder::Decode(T& value) {
+    auto next = nextValue();
+    if (next.Failed()) {
+        return {next.err};
+    }
+    Document& doc = detail::ScratchDocument();
+    auto parsed = doc.Parse(next.value);
+    if (parsed.Failed()) {
+        err_ = parsed.err;
+        return parsed;
+    }
+    // A value that does not fit is still consumed, so the stream goes on
+    auto read = detail::Codec<T>::read(doc.Root(), value, detail::ReadContext{disable_unknown_fields_, {}, nullptr});
+    valueDone(next.value.size());
+    return read;
+}
+
+} // namespace json
+} // namespace encoding
+} // namespace gocxx
+
+/**
+ * @brief Declares the JSON field table of Type, listing members whose names are their keys
+ *
+ * Goes at namespace scope, in Type's namespace; up to 40 fields.
+ */
+#define GOCXX_JSON_FIELDS(Type, ...)                                                                  \
+    [[maybe_unused]] constexpr auto gocxxJsonFields(const Type*) {                                    \
+        return std::make_tuple(GOCXX_JSON_EXPAND_(                                                    \
+            GOCXX_JSON_CAT_(GOCXX_JSON_MAP_, GOCXX_JSON_CAT_(GOCXX_JSON_NARGS_(__VA_ARGS__), _))(     \
+                GOCXX_JSON_FIELD_, Type, __VA_ARGS__)));                                              \
+    }
+
+#define GOCXX_JSON_FIELD_(Type, member) \
+    ::gocxx::encoding::json::Field<Type, decltype(Type::member)>(#member, &Type::member)
+
+#define GOCXX_JSON_EXPAND_(x) x
+#define GOCXX_JSON_NARGS_(...) GOCXX_JSON_EXPAND_(GOCXX_JSON_NARGS_N_(__VA_ARGS__, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define GOCXX_JSON_NARGS_N_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, _40, N, ...) N
+#define GOCXX_JSON_CAT_(a, b) GOCXX_JSON_CAT2_(a, b)
+#define GOCXX_JSON_CAT2_(a, b) a##b
+#define GOCXX_JSON_MAP_1_(m, T, x) m(T, x)
+#define GOCXX_JSON_MAP_2_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_1_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_3_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_2_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_4_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_3_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_5_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_4_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_6_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_5_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_7_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_6_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_8_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_7_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_9_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_8_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_10_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_9_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_11_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_10_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_12_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_11_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_13_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_12_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_14_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_13_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_15_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_14_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_16_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_15_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_17_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_16_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_18_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_17_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_19_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_18_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_20_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_19_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_21_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_20_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_22_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_21_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_23_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_22_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_24_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_23_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_25_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_24_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_26_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_25_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_27_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_26_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_28_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_27_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_29_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_28_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_30_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_29_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_31_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_30_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_32_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_31_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_33_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_32_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_34_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_33_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_35_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_34_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_36_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_35_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_37_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_36_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_38_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_37_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_39_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_38_(m, T, __VA_ARGS__))
+#define GOCXX_JSON_MAP_40_(m, T, x, ...) m(T, x), GOCXX_JSON_EXPAND_(GOCXX_JSON_MAP_39_(m, T, __VA_ARGS__))
@@ -84,6 +84,21 @@ namespace gocxx::errors {
         return std::make_shared<simpleError>(msg);
     }
 
+    /**
+     * @brief Creates a sentinel error, a package-level value callers match with Is.
+     *
+     * The error is never freed and the pointer returned owns nothing (it has
+     * no control block), so copying it, as every Result that returns it
+     * does, touches no reference count; it stays valid through static
+     * destruction. Use it only for errors that live as long as the program.
+     *
+     * @param msg The error message.
+     * @return std::shared_ptr<Error> A non-owning pointer to the new error.
+     */
+    [[nodiscard]] inline std::shared_ptr<Error> Sentinel(const std::string& msg) {
+        return std::shared_ptr<Error>(std::shared_ptr<Error>(), new simpleError(msg));
+    }
+
     // ---------- wrappedError ----------
 
     /**
@@ -34,6 +34,14 @@
 #include <gocxx/base/chan.h>
 #include <gocxx/base/select.h>
 
+// runtime
+#include <gocxx/runtime/runtime.h>
+
+// coroutines (C++20, -DGOCXX_ENABLE_COROUTINES=ON)
+#if defined(GOCXX_HAS_COROUTINES)
+#include <gocxx/coro/coro.h>
+#endif
+
 
 // sync
 #include <gocxx/sync/sync.h>
@@ -41,10 +49,23 @@
 // os
 #include <gocxx/os/os.h>
 #include <gocxx/os/file.h>
+#include <gocxx/os/mmap.h>
+#include <gocxx/os/walk.h>
+#include <gocxx/os/exec.h>
 
 // io
 #include <gocxx/io/io.h>
 #include <gocxx/io/io_errors.h>
+#include <gocxx/io/parallel.h>
+#include <gocxx/bufio/bufio.h>
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/arena/arena.h>
+
+// hash
+#include <gocxx/hash/crc32.h>
+
+// aio
+#include <gocxx/aio/aio.h>
 
 // errors
 #include <gocxx/errors/errors.h>
@@ -57,15 +78,33 @@
 
 // context
 #include <gocxx/context/context.h>
+#include <gocxx/sync/errgroup.h>
+#include <gocxx/sync/semaphore.h>
+#include <gocxx/sync/singleflight.h>
+
+// pipeline
+#include <gocxx/pipeline/pipeline.h>
 
 // encoding
+#include <gocxx/encoding/base32.h>
+#include <gocxx/encoding/base64.h>
+#include <gocxx/encoding/hex.h>
 #include <gocxx/encoding/json.h>
+#include <gocxx/encoding/json_document.h>
+#include <gocxx/encoding/json_struct.h>
 
 // net
 #include <gocxx/net/net.h>
 #include <gocxx/net/tcp.h>
 #include <gocxx/net/udp.h>
+#include <gocxx/net/resolver.h>
 #include <gocxx/net/http.h>
+#include <gocxx/net/http_metrics.h>
+#include <gocxx/net/http2.h>
+#include <gocxx/net/hpack.h>
+
+// debug
+#include <gocxx/debug/pprof.h>
 
 namespace gocxx {
     void anchor();  
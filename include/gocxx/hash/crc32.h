@@ -0,0 +1,64 @@
+/**
+ * @file crc32.h
+ * @brief 32-bit cyclic redundancy checks, like Go's hash/crc32
+ *
+ * Checksums are computed slicing-by-8 (eight table lookups per eight input
+ * bytes). Combine() joins the checksums of two adjacent ranges without
+ * rereading either, which is what lets io::ParallelCRC32 checksum chunks
+ * on separate threads.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <gocxx/base/result.h>
+#include <gocxx/io/io.h>
+
+namespace gocxx::hash::crc32 {
+
+    /// Reversed polynomials.
+    enum class Polynomial : uint32_t {
+        IEEE = 0xedb88320,        ///< Ethernet, zip, gzip, PNG
+        Castagnoli = 0x82f63b78,  ///< iSCSI, ext4, SCTP
+    };
+
+    /// Returns @p crc extended with @p n bytes of @p data.
+    uint32_t Update(uint32_t crc, const uint8_t* data, std::size_t n, Polynomial poly = Polynomial::IEEE);
+
+    uint32_t Checksum(const uint8_t* data, std::size_t n, Polynomial poly = Polynomial::IEEE);
+
+    inline uint32_t Checksum(std::string_view data, Polynomial poly = Polynomial::IEEE) {
+        return Checksum(reinterpret_cast<const uint8_t*>(data.data()), data.size(), poly);
+    }
+
+    /**
+     * @brief Checksum of A followed by B, given the checksums of A and B and B's length.
+     *
+     * O(log len2); neither range is read again.
+     */
+    uint32_t Combine(uint32_t crc1, uint32_t crc2, uint64_t len2, Polynomial poly = Polynomial::IEEE);
+
+    /**
+     * @brief Running checksum that is an io::Writer, like Go's hash.Hash32.
+     */
+    class Hash : public io::Writer {
+    public:
+        explicit Hash(Polynomial poly = Polynomial::IEEE) : poly_(poly) {}
+
+        base::Result<std::size_t> Write(const uint8_t* buffer, std::size_t size) override {
+            crc_ = Update(crc_, buffer, size, poly_);
+            return {size, nullptr};
+        }
+
+        uint32_t Sum32() const { return crc_; }
+        void Reset() { crc_ = 0; }
+
+    private:
+        Polynomial poly_;
+        uint32_t crc_ = 0;
+    };
+
+} // namespace gocxx::hash::crc32
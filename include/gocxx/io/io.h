@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <cstdio>
 #include <vector>
@@ -100,6 +101,82 @@ namespace gocxx::io {
         virtual gocxx::base::Result<std::size_t> WriteByte(uint8_t byte) = 0;
     };
 
+    // Implemented by sources that can write themselves to `w` more efficiently
+    // than a read/write loop (Go's io.WriterTo). Copy prefers it.
+    class WriterTo {
+    public:
+        virtual ~WriterTo() = default;
+        virtual gocxx::base::Result<std::size_t> WriteTo(std::shared_ptr<Writer> w) = 0;
+    };
+
+    // Implemented by destinations that can pull from `r` more efficiently
+    // than a read/write loop (Go's io.ReaderFrom). Copy uses it when the
+    // source is not a WriterTo.
+    class ReaderFrom {
+    public:
+        virtual ~ReaderFrom() = default;
+        virtual gocxx::base::Result<std::size_t> ReadFrom(std::shared_ptr<Reader> r) = 0;
+    };
+
+    // Implemented by readers and writers backed by a kernel file descriptor,
+    // so that data between two of them can be moved without a user-space
+    // copy (sendfile, splice, copy_file_range).
+    class FileDescriptor {
+    public:
+        virtual ~FileDescriptor() = default;
+        virtual int Fd() const = 0;
+
+        // Called by the kernel copy loops when Fd() is non-blocking and a
+        // call reported EAGAIN: waits until it may be readable (or, with
+        // `write`, writable) and returns null, or returns the error that
+        // ends the copy (a deadline, a close). Descriptors that are never
+        // non-blocking keep the default, which gives up.
+        virtual std::shared_ptr<gocxx::errors::Error> WaitFd(bool write);
+    };
+
+    // One contiguous region of a scatter/gather list.
+    struct Span {
+        const uint8_t* data = nullptr;
+        std::size_t size = 0;
+
+        Span() = default;
+        Span(const uint8_t* d, std::size_t n) : data(d), size(n) {}
+        Span(std::string_view s) : data(reinterpret_cast<const uint8_t*>(s.data())), size(s.size()) {}
+        Span(const std::string& s) : Span(std::string_view(s)) {}
+        Span(const std::vector<uint8_t>& v) : data(v.data()), size(v.size()) {}
+    };
+
+    struct MutableSpan {
+        uint8_t* data = nullptr;
+        std::size_t size = 0;
+
+        MutableSpan() = default;
+        MutableSpan(uint8_t* d, std::size_t n) : data(d), size(n) {}
+        MutableSpan(std::vector<uint8_t>& v) : data(v.data()), size(v.size()) {}
+    };
+
+    // Regions written, or filled, in order by one vectored call (Go's net.Buffers).
+    using Buffers = std::vector<Span>;
+    using MutableBuffers = std::vector<MutableSpan>;
+
+    // Implemented by writers that can send several buffers with one system
+    // call (writev, sendmsg, WSASend), so a header and a body go out together
+    // without being concatenated first. Writes everything, or returns the
+    // bytes written so far with an error.
+    class BuffersWriter {
+    public:
+        virtual ~BuffersWriter() = default;
+        virtual gocxx::base::Result<std::size_t> WriteBuffers(const Buffers& bufs) = 0;
+    };
+
+    // Counterpart of BuffersWriter (readv): one read that fills `bufs` in
+    // order, returning as soon as any bytes arrived, like Read.
+    class BuffersReader {
+    public:
+        virtual ~BuffersReader() = default;
+        virtual gocxx::base::Result<std::size_t> ReadBuffers(const MutableBuffers& bufs) = 0;
+    };
+
     class PipeReader : public Reader {
     public:
         virtual gocxx::base::Result<std::size_t> Close() = 0;
@@ -113,6 +190,10 @@ namespace gocxx::io {
     };
 
     // Function declarations
+
+    // Copies src to dst until EOF. Uses src's WriterTo or else dst's
+    // ReaderFrom when available, so copies between files and sockets stay in
+    // the kernel; otherwise reads through an 8 KiB buffer.
     gocxx::base::Result<std::size_t> Copy(std::shared_ptr<Writer> dst, std::shared_ptr<Reader> src);
     gocxx::base::Result<std::size_t> CopyBuffer(std::shared_ptr<Writer> dst, std::shared_ptr<Reader> src, uint8_t* buf, std::size_t size);
     gocxx::base::Result<std::size_t> CopyN(std::shared_ptr<Writer> dst, std::shared_ptr<Reader> src, std::size_t n);
@@ -121,17 +202,79 @@ namespace gocxx::io {
     gocxx::base::Result<std::size_t> ReadFull(std::shared_ptr<Reader> r, std::vector<uint8_t>& buf);
     gocxx::base::Result<std::size_t> WriteString(std::shared_ptr<Writer> w, const std::string& s);
 
+    // Writes every buffer in order: one WriteBuffers call when w is a
+    // BuffersWriter, otherwise one Write per non-empty buffer.
+    gocxx::base::Result<std::size_t> WriteBuffers(std::shared_ptr<Writer> w, const Buffers& bufs);
+
+    namespace detail {
+        // Copy loop through a user-space buffer; never delegates to WriterTo/ReaderFrom.
+        gocxx::base::Result<std::size_t> genericCopy(Writer& dst, Reader& src);
+
+        // WriteTo/ReaderFrom bodies for types backed by a file descriptor. They
+        // move data in the kernel when the other side is a FileDescriptor
+        // (looking through a LimitedReader or SectionReader) and fall back to genericCopy.
+        gocxx::base::Result<std::size_t> fdWriteTo(int srcFd, Reader& self, std::shared_ptr<Writer> dst);
+        gocxx::base::Result<std::size_t> fdReadFrom(int dstFd, Writer& self, std::shared_ptr<Reader> src);
+
+        // writev (sendmsg with MSG_NOSIGNAL for sockets) until every byte of
+        // `bufs` is written or a call fails, batching IOV_MAX regions at a
+        // time. Returns the bytes written; `err` is the errno of the failed
+        // call or 0. POSIX only.
+        std::size_t fdWriteBuffers(int fd, const Buffers& bufs, bool socket, int& err);
+
+        // One readv (recvmsg for sockets): bytes read, 0 at end of stream,
+        // or -1 with `err` set. POSIX only.
+        long fdReadBuffers(int fd, const MutableBuffers& bufs, bool socket, int& err);
+
+        std::size_t totalSize(const Buffers& bufs);
+    }
+
     class LimitedReader : public Reader {
     public:
         LimitedReader(std::shared_ptr<Reader> base, std::size_t n);
         gocxx::base::Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override;
 
     private:
+        friend gocxx::base::Result<std::size_t> detail::fdReadFrom(int, Writer&, std::shared_ptr<Reader>);
+
         std::shared_ptr<Reader> r;
         std::size_t remaining;
         std::size_t totalRead = 0;
     };
 
+    // Reads the n bytes of r starting at off, like Go's io.SectionReader.
+    // Position is kept here and reads go through ReadAt, so several
+    // sections of one file can be read at once. Copied to a socket or file,
+    // a section of a file stays in the kernel (sendfile/copy_file_range at
+    // the section's offset, leaving the file offset alone).
+    class SectionReader : public Reader, public ReaderAt, public Seeker {
+    public:
+        SectionReader(std::shared_ptr<ReaderAt> r, std::size_t off, std::size_t n);
+        gocxx::base::Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override;
+        // offset is relative to the start of the section
+        gocxx::base::Result<std::size_t> ReadAt(uint8_t* buffer, std::size_t size, std::size_t offset) override;
+        gocxx::base::Result<std::size_t> Seek(std::size_t offset, whence whence) override;
+        std::size_t Size() const { return limit - base; }
+
+    private:
+        friend gocxx::base::Result<std::size_t> detail::fdReadFrom(int, Writer&, std::shared_ptr<Reader>);
+
+        std::shared_ptr<ReaderAt> r;
+        std::size_t base;
+        std::size_t off;
+        std::size_t limit;
+    };
+
+    /// Ring size used by Pipe().
+    constexpr std::size_t kDefaultPipeBufferSize = 64 * 1024;
+
+    // Synchronous in-memory pipe over a bounded ring of kDefaultPipeBufferSize
+    // bytes: Write blocks while the ring is full, Read while it is empty.
     std::pair<std::shared_ptr<PipeReader>, std::shared_ptr<PipeWriter>> Pipe();
 
+    // Pipe with a ring of `bufferSize` bytes. Zero means no ring at all, as in
+    // Go's io.Pipe: Write blocks until readers have copied every byte straight
+    // out of its buffer.
+    std::pair<std::shared_ptr<PipeReader>, std::shared_ptr<PipeWriter>> Pipe(std::size_t bufferSize);
+
 } // namespace gocxx::io
\ No newline at end of file
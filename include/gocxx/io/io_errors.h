@@ -8,32 +8,37 @@ namespace gocxx::io {
 
     // ------------------ IO Errors (inline shared constants) ------------------
 
+    // Sentinels: returning one copies a pointer without touching a reference count
+
     inline const std::shared_ptr<errors::Error> ErrEOF =
-        std::make_shared<errors::simpleError>("EOF");
+        errors::Sentinel("EOF");
 
     inline const std::shared_ptr<errors::Error> ErrUnexpectedEOF =
-        std::make_shared<errors::simpleError>("unexpected EOF");
+        errors::Sentinel("unexpected EOF");
+
+    inline const std::shared_ptr<errors::Error> ErrClosedPipe =
+        errors::Sentinel("io: read/write on closed pipe");
 
     inline const std::shared_ptr<errors::Error> ErrShortWrite =
-        std::make_shared<errors::simpleError>("short write");
+        errors::Sentinel("short write");
 
     inline const std::shared_ptr<errors::Error> ErrShortBuffer =
-        std::make_shared<errors::simpleError>("short buffer");
+        errors::Sentinel("short buffer");
 
     inline const std::shared_ptr<errors::Error> ErrNoProgress =
-        std::make_shared<errors::simpleError>("multiple Read calls return no data");
+        errors::Sentinel("multiple Read calls return no data");
 
     inline const std::shared_ptr<errors::Error> ErrTimeout =
-        std::make_shared<errors::simpleError>("I/O timeout");
+        errors::Sentinel("I/O timeout");
 
     inline const std::shared_ptr<errors::Error> ErrInterrupted =
-        std::make_shared<errors::simpleError>("I/O interrupted");
+        errors::Sentinel("I/O interrupted");
 
     inline const std::shared_ptr<errors::Error> ErrBufferTooSmall =
-        std::make_shared<errors::simpleError>("buffer too small");
+        errors::Sentinel("buffer too small");
 
     inline const std::shared_ptr<errors::Error> ErrUnknownIO =
-        std::make_shared<errors::simpleError>("unknown I/O error");
+        errors::Sentinel("unknown I/O error");
 
     // ------------------ For dynamic/custom errors ------------------
 
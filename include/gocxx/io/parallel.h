@@ -0,0 +1,80 @@
+/**
+ * @file parallel.h
+ * @brief Chunked copies and checksums over ReaderAt/WriterAt on several threads
+ *
+ * One sequential stream rarely keeps a fast SSD busy. These helpers split
+ * [0, size) into fixed-size chunks that worker threads claim in order, each
+ * reading (and writing) its chunk at its own offset through a buffer taken
+ * from the bytes size-class pools. Sources and destinations must therefore
+ * allow concurrent ReadAt/WriteAt calls, as os::File and os::MappedFile do.
+ *
+ * Progress, when asked for, is reported on a channel as the running total
+ * of bytes finished. Reports are offered with trySend: a report that finds
+ * the channel full is dropped rather than stalling the copy, so a buffered
+ * channel sees every report only if it is drained fast enough. The return
+ * value is always authoritative.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <gocxx/base/chan.h>
+#include <gocxx/base/result.h>
+#include <gocxx/hash/crc32.h>
+#include <gocxx/io/io.h>
+
+namespace gocxx::io {
+
+    constexpr std::size_t kDefaultParallelChunk = 1 << 20;
+    constexpr std::size_t kDefaultParallelWorkers = 4;
+
+    struct Progress {
+        std::size_t done = 0;   ///< bytes finished so far
+        std::size_t total = 0;  ///< bytes in the whole range
+    };
+
+    using ProgressChan = std::shared_ptr<base::Chan<Progress>>;
+
+    /// Called for one chunk; may run on any worker, concurrently with other chunks.
+    using ChunkFunc = std::function<base::Result<void>(std::size_t index, std::size_t offset,
+                                                       const uint8_t* data, std::size_t n)>;
+
+    /**
+     * @brief Copies bytes [0, size) of @p src to the same offsets of @p dst.
+     *
+     * @param chunk   bytes per ReadAt/WriteAt pair (0: kDefaultParallelChunk)
+     * @param workers threads (0: kDefaultParallelWorkers); never more than there are chunks
+     * @return bytes copied. On the first failure the remaining chunks are
+     *         abandoned and the error returned; chunks other workers had
+     *         already written stay written. A source shorter than @p size
+     *         fails with ErrUnexpectedEOF.
+     */
+    base::Result<std::size_t> ParallelCopy(std::shared_ptr<WriterAt> dst, std::shared_ptr<ReaderAt> src,
+                                           std::size_t size, std::size_t chunk = kDefaultParallelChunk,
+                                           std::size_t workers = 0, ProgressChan progress = nullptr);
+
+    /**
+     * @brief Reads [0, size) of @p src in parallel chunks and hands each to @p fn.
+     *
+     * Chunk i covers [i * chunk, min((i + 1) * chunk, size)). An error from
+     * @p fn stops the read like a read error does.
+     */
+    base::Result<std::size_t> ParallelRead(std::shared_ptr<ReaderAt> src, std::size_t size, std::size_t chunk,
+                                           std::size_t workers, const ChunkFunc& fn,
+                                           ProgressChan progress = nullptr);
+
+    /**
+     * @brief CRC-32 of [0, size) of @p src, checksumming chunks in parallel.
+     *
+     * Equal to hash::crc32::Checksum over the same bytes.
+     */
+    base::Result<uint32_t> ParallelCRC32(std::shared_ptr<ReaderAt> src, std::size_t size,
+                                         std::size_t chunk = kDefaultParallelChunk, std::size_t workers = 0,
+                                         ProgressChan progress = nullptr,
+                                         hash::crc32::Polynomial poly = hash::crc32::Polynomial::IEEE);
+
+} // namespace gocxx::io
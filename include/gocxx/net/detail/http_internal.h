@@ -0,0 +1,39 @@
+/**
+ * @file http_internal.h
+ * @brief What the HTTP/1 (http.cpp) and HTTP/2 (http2.cpp) halves of the server and client share
+ *
+ * Not part of the public API.
+ */
+
+// gocxx/net/detail/http_internal.h
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <gocxx/base/result.h>
+#include <gocxx/context/context.h>
+#include <gocxx/net/http.h>
+
+namespace gocxx::net::http::detail {
+
+/// "date: <IMF-fixdate>\r\n" for the current second, formatted once per second per thread.
+std::string_view DateHeader();
+
+/// Whether a response with this status carries a body.
+inline bool BodyAllowed(int status) {
+    return status >= 200 && status != 204 && status != 304;
+}
+
+/// The Transport's HTTP/2 connections, per host.
+std::shared_ptr<Transport::H2Pool> NewH2Pool();
+
+/// Sends @p req over an HTTP/2 connection to @p address from @p pool, dialing one if none has room.
+gocxx::base::Result<Response> RoundTripH2(const Transport& transport, const std::shared_ptr<Transport::H2Pool>& pool,
+                                          context::ContextPtr ctx, const Request& req,
+                                          const std::string& address, const std::string& path);
+
+/// Closes the HTTP/2 connections of @p pool that have no streams open.
+void CloseIdleH2(Transport::H2Pool& pool);
+
+} // namespace gocxx::net::http::detail
@@ -0,0 +1,171 @@
+/**
+ * @file netpoll.h
+ * @brief Readiness poller behind the net package's non-blocking sockets
+ *
+ * Modelled on Go's runtime netpoller. Every socket is switched to
+ * non-blocking mode and registered once, edge-triggered, with a process-wide
+ * epoll (Linux) or kqueue (BSD, macOS) instance, served by one poller
+ * thread. An operation first tries the system call; on EAGAIN the caller
+ * parks on the socket's PollDesc (inside a BlockingRegion, so a runtime
+ * worker hands its processor to another task) until the poller reports
+ * readiness, the deadline timer fires, or the socket is closed.
+ *
+ * Deadlines are timers on the shared time::detail::TimerService: setting one
+ * costs a heap push rather than a thread, and an expired deadline wakes the
+ * parked caller with ErrTimeout ("i/o timeout").
+ *
+ * Where no poller is available (Windows, or epoll/kqueue creation failed)
+ * sockets stay blocking and deadlines fall back to SO_RCVTIMEO/SO_SNDTIMEO.
+ *
+ * A PollDesc also counts the operations in progress on its descriptor, so
+ * Close() can wake them and the descriptor itself is closed only once the
+ * last one has returned; a racing operation never touches a reused fd.
+ */
+
+// gocxx/net/detail/netpoll.h
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <gocxx/errors/errors.h>
+#include <gocxx/runtime/blocking.h>
+#include <gocxx/time/detail/timer_service.h>
+
+namespace gocxx::net::detail {
+
+    class PollDesc : public std::enable_shared_from_this<PollDesc> {
+    public:
+        enum Mode { Read = 0, Write = 1 };
+
+        /// Takes ownership of @p fd: makes it non-blocking and registers it with the poller.
+        static std::shared_ptr<PollDesc> Open(int fd);
+
+        ~PollDesc();
+
+        PollDesc(const PollDesc&) = delete;
+        PollDesc& operator=(const PollDesc&) = delete;
+
+        int Fd() const { return fd_; }
+
+        /// true when EAGAIN means "wait for the poller" rather than "timed out".
+        bool Pollable() const { return token_ != 0; }
+
+        /**
+         * @brief Runs @p call until it stops failing with EAGAIN, parking in between.
+         *
+         * @p call returns a byte count or -1 with errno set, like the system
+         * call it wraps. Returns what @p call returned last; -1 with @p err
+         * set for a deadline (ErrTimeout) or close (ErrClosed), -1 with
+         * @p err null and errno intact for a failed system call.
+         */
+        template <typename Call>
+        long Io(Mode mode, Call&& call, std::shared_ptr<errors::Error>& err) {
+            Op op(*this);
+            if (!op) {
+                err = closedError();
+                return -1;
+            }
+            if ((err = Prepare(mode))) return -1;
+
+            if (!Pollable()) {
+                // Blocking socket: the call itself waits, bounded by SO_RCVTIMEO/SO_SNDTIMEO
+                long n;
+#ifdef _WIN32
+                {
+                    gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+                    n = call();
+                }
+#else
+                do {
+                    gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+                    n = call();
+                } while (n < 0 && errno == EINTR);
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) err = timeoutError();
+#endif
+                return n;
+            }
+
+            for (;;) {
+                long n = call();
+                if (n >= 0) return n;
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+                if ((err = Wait(mode))) return -1;
+            }
+        }
+
+        /// ErrClosed once closing, ErrTimeout once the deadline has passed, else null.
+        std::shared_ptr<errors::Error> Prepare(Mode mode);
+
+        /// Parks until the poller reports @p mode ready since the last Wait, or Prepare would fail.
+        std::shared_ptr<errors::Error> Wait(Mode mode);
+
+        /**
+         * @brief Sets the deadline for @p mode; time_point::max() or a default-constructed one clears it.
+         *
+         * Wakes callers already parked when the new deadline has passed.
+         */
+        void SetDeadline(Mode mode, std::chrono::system_clock::time_point deadline);
+
+        /**
+         * @brief Wakes every parked operation with ErrClosed and closes the descriptor
+         * once the last operation in progress has returned.
+         * @return false if already closed
+         */
+        bool Close();
+
+        /// Holds the descriptor open for the duration of one operation.
+        class Op {
+        public:
+            explicit Op(PollDesc& pd) : pd_(pd.incRef() ? &pd : nullptr) {}
+            ~Op() {
+                if (pd_) pd_->decRef();
+            }
+            Op(const Op&) = delete;
+            Op& operator=(const Op&) = delete;
+            explicit operator bool() const { return pd_ != nullptr; }
+
+        private:
+            PollDesc* pd_;
+        };
+
+        // Called by the poller thread.
+        void notify(bool readable, bool writable);
+
+    private:
+        struct Direction {
+            std::condition_variable cv;
+            bool ready = false;
+            bool expired = false;
+            std::int64_t when = 0;  // monotonic deadline; 0 = none
+            std::shared_ptr<time::detail::TimerNode> timer;
+            std::chrono::system_clock::time_point deadline = std::chrono::system_clock::time_point::max();
+        };
+
+        explicit PollDesc(int fd) : fd_(fd) {}
+
+        static std::shared_ptr<errors::Error> closedError();
+        static std::shared_ptr<errors::Error> timeoutError();
+
+        bool incRef();
+        void decRef();
+        void closeFd();
+        void expire(Mode mode);
+
+        static constexpr std::uint32_t kClosing = 1u << 31;
+
+        const int fd_;
+        std::uint64_t token_ = 0;  // poller registration; 0 when not pollable
+        std::atomic<std::uint32_t> refs_{0};
+        std::mutex mtx_;
+        bool closing_ = false;
+        Direction dirs_[2];
+    };
+
+} // namespace gocxx::net::detail
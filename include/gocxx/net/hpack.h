@@ -0,0 +1,173 @@
+#pragma once
+
+/**
+ * @file hpack.h
+ * @brief HPACK header compression for HTTP/2 (RFC 7541), like Go's x/net/http2/hpack
+ *
+ * An Encoder and a Decoder each keep one side of a connection's dynamic
+ * table, so every header block of a connection must go through the same
+ * pair, in order. String literals are Huffman-coded with the static code
+ * of RFC 7541 Appendix B whenever that is shorter.
+ *
+ * @code
+ * hpack::Encoder enc;
+ * std::string block;
+ * enc.Encode(block, ":status", "200");
+ * enc.Encode(block, "content-type", "text/plain");
+ *
+ * hpack::Decoder dec;
+ * auto fields = dec.Decode(block);  // [{":status", "200"}, {"content-type", "text/plain"}]
+ * @endcode
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+
+namespace gocxx::net::hpack {
+
+/// A header block that cannot be decoded: the connection must be closed with COMPRESSION_ERROR.
+extern std::shared_ptr<gocxx::errors::Error> ErrDecoding;
+
+/// Invalid Huffman-coded data (bad padding, or the EOS symbol).
+extern std::shared_ptr<gocxx::errors::Error> ErrInvalidHuffman;
+
+/// A decoded header list longer than Decoder::SetMaxHeaderListSize() allows.
+extern std::shared_ptr<gocxx::errors::Error> ErrStringLength;
+
+/// Bytes added to an entry's name and value to give its size in the dynamic table.
+constexpr std::uint32_t kEntryOverhead = 32;
+
+/// The dynamic table size both sides start with (SETTINGS_HEADER_TABLE_SIZE).
+constexpr std::uint32_t kDefaultTableSize = 4096;
+
+/**
+ * @brief One header field
+ *
+ * Sensitive fields are encoded as "never indexed", so neither end nor any
+ * intermediary keeps them in a table (credentials, cookies with secrets).
+ */
+struct HeaderField {
+    std::string name;
+    std::string value;
+    bool sensitive = false;
+
+    /// Size in the dynamic table: name and value lengths plus kEntryOverhead.
+    std::uint32_t Size() const { return static_cast<std::uint32_t>(name.size() + value.size()) + kEntryOverhead; }
+};
+
+/// Length of @p s after Huffman coding, in bytes.
+std::size_t HuffmanEncodeLength(std::string_view s);
+
+/// Appends the Huffman coding of @p s to @p dst.
+void AppendHuffmanString(std::string& dst, std::string_view s);
+
+/// Decodes Huffman-coded @p s; ErrInvalidHuffman if it is malformed.
+gocxx::base::Result<std::string> HuffmanDecode(std::string_view s);
+
+namespace detail {
+
+/// The entries a Decoder or Encoder added, newest first, evicted to stay within a size.
+class DynamicTable {
+public:
+    explicit DynamicTable(std::uint32_t maxSize) : max_size_(maxSize) {}
+
+    void Add(HeaderField f);
+    void SetMaxSize(std::uint32_t maxSize);
+    std::uint32_t MaxSize() const { return max_size_; }
+    std::uint32_t Size() const { return size_; }
+    std::size_t Len() const { return entries_.size(); }
+
+    /// Entry @p i, 0 being the newest.
+    const HeaderField& At(std::size_t i) const { return entries_[i]; }
+
+private:
+    void evict();
+
+    std::deque<HeaderField> entries_;
+    std::uint32_t size_ = 0;
+    std::uint32_t max_size_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Encodes header blocks for one direction of a connection
+ *
+ * Every field that is not sensitive is added to the dynamic table, so
+ * repeated fields shrink to an index or two on later requests.
+ */
+class Encoder {
+public:
+    explicit Encoder(std::uint32_t maxTableSize = kDefaultTableSize);
+
+    /**
+     * @brief Appends one field to the block being built in @p dst
+     *
+     * The first call after SetMaxDynamicTableSize() starts with the table
+     * size update the peer must see, so call that only between blocks.
+     */
+    void Encode(std::string& dst, std::string_view name, std::string_view value, bool sensitive = false);
+
+    /**
+     * @brief Sets the dynamic table size, capped by the peer's SETTINGS_HEADER_TABLE_SIZE
+     *
+     * @see SetMaxDynamicTableSizeLimit
+     */
+    void SetMaxDynamicTableSize(std::uint32_t size);
+
+    /// Records the limit the peer advertised; the table shrinks to fit it.
+    void SetMaxDynamicTableSizeLimit(std::uint32_t limit);
+
+    std::uint32_t MaxDynamicTableSize() const { return table_.MaxSize(); }
+
+private:
+    // 1-based HPACK index of an entry matching name (and value, when exact), or 0
+    std::size_t search(std::string_view name, std::string_view value, bool& exact) const;
+
+    detail::DynamicTable table_;
+    std::uint32_t limit_;
+    std::uint32_t min_size_;     // smallest size set since the last block
+    bool size_update_ = false;
+};
+
+/**
+ * @brief Decodes header blocks for one direction of a connection
+ */
+class Decoder {
+public:
+    explicit Decoder(std::uint32_t maxTableSize = kDefaultTableSize);
+
+    /// The largest table the peer may ask for, which we advertise as SETTINGS_HEADER_TABLE_SIZE.
+    void SetAllowedMaxDynamicTableSize(std::uint32_t size) { allowed_ = size; }
+
+    /// Limit on the decoded list (names, values and kEntryOverhead per field); 0 = none.
+    void SetMaxHeaderListSize(std::uint32_t size) { max_list_ = size; }
+
+    /**
+     * @brief Decodes one complete header block (HEADERS plus CONTINUATION payloads)
+     *
+     * @return ErrDecoding or ErrInvalidHuffman on bad input, after which the
+     *         table is out of step and the connection unusable; ErrStringLength
+     *         when the list exceeds SetMaxHeaderListSize(), with the table
+     *         still in step, so only the stream need be refused
+     */
+    gocxx::base::Result<std::vector<HeaderField>> Decode(std::string_view block);
+
+    std::uint32_t DynamicTableSize() const { return table_.Size(); }
+
+private:
+    std::shared_ptr<gocxx::errors::Error> field(std::size_t index, HeaderField& out) const;
+
+    detail::DynamicTable table_;
+    std::uint32_t allowed_;
+    std::uint32_t max_list_ = 0;
+};
+
+} // namespace gocxx::net::hpack
@@ -13,19 +13,36 @@
 
 #include <gocxx/net/net.h>
 #include <gocxx/net/tcp.h>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <map>
+#include <memory_resource>
+#include <vector>
 #include <memory>
+#include <chrono>
 #include <functional>
+#include <mutex>
+#include <unordered_map>
 #include <gocxx/base/chan.h>
+#include <gocxx/context/context.h>
+#include <gocxx/sync/semaphore.h>
+
+namespace gocxx::bufio {
+class Reader;
+}
 
 namespace gocxx::net::http {
 
+/// Returned by Server::Serve and ListenAndServe after Shutdown or Close
+extern std::shared_ptr<gocxx::errors::Error> ErrServerClosed;
+
 // Forward declarations
 class Request;
 class Response;
 class ResponseWriter;
 class ServeMux;
+class ServerMetrics;
 
 /**
  * @brief HTTP handler function type
@@ -34,6 +51,15 @@ class ServeMux;
  */
 using HandlerFunc = std::function<void(ResponseWriter&, const Request&)>;
 
+/**
+ * @brief Header fields, name to value
+ * 
+ * The server allocates the map's nodes from the connection's arena (see
+ * Request::Arena()); names and values are ordinary strings. A copied map,
+ * as in a copied Request, uses the default resource and may be kept.
+ */
+using HeaderMap = std::pmr::map<std::string, std::string>;
+
 /**
  * @brief HTTP request
  */
@@ -42,16 +68,73 @@ public:
     std::string method;          ///< HTTP method (GET, POST, etc.)
     std::string url;             ///< Request URL/path
     std::string proto;           ///< Protocol version (HTTP/1.0, HTTP/1.1)
-    std::map<std::string, std::string> header;  ///< HTTP headers
+    HeaderMap header;            ///< HTTP headers
     std::string body;            ///< Request body
     std::string remote_addr;     ///< Remote address
     
     Request() = default;
+
+    /// A request whose header map, and Arena(), allocate from @p arena.
+    explicit Request(std::pmr::memory_resource* arena) : header(arena), arena_(arena) {}
     
     /**
      * @brief Gets a header value
      */
     std::string Header(const std::string& key) const;
+    
+    /**
+     * @brief Value of the {name} or {name...} segment ServeMux matched, like Go's Request.PathValue
+     * 
+     * A view into url, not percent-decoded; empty when the matched pattern
+     * has no such segment.
+     */
+    std::string_view PathValue(std::string_view name) const;
+
+    /**
+     * @brief The ServeMux pattern that matched, like Go's Request.Pattern
+     * 
+     * Empty before routing and when no pattern matched.
+     */
+    std::string_view Pattern() const { return pattern_ ? std::string_view(*pattern_) : std::string_view(); }
+
+    /**
+     * @brief Scratch memory for the handler, released when the response is done
+     * 
+     * The server gives each connection a monotonic arena that is reset
+     * between requests; the request's header map and the response writer's
+     * buffers live there too. Allocating from it is a pointer bump, and
+     * freeing is a no-op:
+     * 
+     * @code
+     * std::pmr::vector<std::string_view> parts(req.Arena());
+     * std::pmr::string reply(req.Arena());
+     * @endcode
+     * 
+     * Nothing allocated from it may outlive the handler, or be used from
+     * another thread; a copy of the Request shares it. Without an arena
+     * (a Request built by hand) this is the default resource.
+     */
+    std::pmr::memory_resource* Arena() const { return arena_ ? arena_ : std::pmr::get_default_resource(); }
+
+    /// Path segments one pattern can capture.
+    static constexpr std::size_t kMaxPathValues = 8;
+
+private:
+    friend class ServeMux;
+    friend class Server;
+    friend HandlerFunc StripPrefix(const std::string& prefix, HandlerFunc handler);
+    struct PathSpan {
+        std::uint32_t off = 0;
+        std::uint32_t len = 0;
+    };
+    // Set by ServeMux while routing: offsets into url, names owned by the matched pattern
+    mutable const std::vector<std::string>* path_names_ = nullptr;
+    mutable PathSpan path_values_[kMaxPathValues];
+    mutable const std::string* pattern_ = nullptr;  // owned by the ServeMux
+    std::pmr::memory_resource* arena_ = nullptr;
+
+    // Ready for the connection's next request; keeps capacity and remote_addr
+    void reset();
 };
 
 /**
@@ -64,7 +147,7 @@ public:
     /**
      * @brief Gets the header map for modification
      */
-    virtual std::map<std::string, std::string>& Header() = 0;
+    virtual HeaderMap& Header() = 0;
     
     /**
      * @brief Writes data to the response body
@@ -77,6 +160,28 @@ public:
     virtual void WriteHeader(int statusCode) = 0;
 };
 
+/**
+ * @brief Implemented by ResponseWriters that can send buffered data early
+ * 
+ * Like Go's http.Flusher. The server's writer coalesces small writes;
+ * handlers that stream (server-sent events, long polling) call Flush() to
+ * push what they have written so far to the client. The first Flush()
+ * sends the header, so a response without a Content-Length goes out
+ * chunked.
+ * 
+ * @code
+ * if (auto* f = dynamic_cast<http::Flusher*>(&w)) f->Flush();
+ * @endcode
+ */
+class Flusher {
+public:
+    virtual ~Flusher() = default;
+    virtual void Flush() = 0;
+};
+
+/// Reason phrase for an HTTP status code ("Not Found"); empty if unknown, like Go's http.StatusText.
+const std::string& StatusText(int code);
+
 /**
  * @brief HTTP response (for client)
  */
@@ -86,7 +191,11 @@ public:
     int status_code;             ///< HTTP status code
     std::string status;          ///< Status text
     std::map<std::string, std::string> header;  ///< HTTP headers
-    std::string body;            ///< Response body
+    std::string body;            ///< Response body (Get, Post)
+    
+    /// Response body as it arrives (Client::Do). Read it to the end, or
+    /// close it, so the connection can go back to the pool.
+    std::shared_ptr<gocxx::io::ReadCloser> body_stream;
     
     Response() : status_code(0) {}
     
@@ -96,18 +205,51 @@ public:
     std::string Header(const std::string& key) const;
 };
 
+namespace detail {
+struct RouteNode;
+class H2ServerConn;
+}
+
 /**
  * @brief HTTP server multiplexer (router)
+ * 
+ * Patterns follow Go 1.22's ServeMux: "[METHOD ]/path", where the path is
+ * made of segments that are literal, "{name}" (one segment), "{name...}"
+ * (the rest of the path, last segment only) or "{$}" (the end of the path,
+ * after a trailing slash). A path ending in "/" matches every path below
+ * it, so "/" is the catch-all. A pattern with a method also serves HEAD
+ * when the method is GET; one without serves every method.
+ * 
+ * @code
+ * mux->HandleFunc("GET /users/{id}", getUser);      // req.PathValue("id")
+ * mux->HandleFunc("/static/", serveStatic);          // /static/ and below
+ * mux->HandleFunc("GET /files/{path...}", getFile);
+ * @endcode
+ * 
+ * Routes live in a compressed radix tree keyed by the literal bytes, with
+ * a parameter and a wildcard edge per node, so a lookup costs time
+ * proportional to the path length, whatever the number of routes, and
+ * allocates nothing. Literal segments take precedence over {name}, and
+ * {name} over {name...} and trailing slashes; for the same path a pattern
+ * naming the method is preferred. A path matched only by patterns for other
+ * methods gets 405 with an Allow header; no match at all gets 404.
+ * 
+ * Routing ignores the query string. Register every pattern before serving.
  */
 class ServeMux {
 public:
-    ServeMux() = default;
+    ServeMux();
+    ~ServeMux();
+    
+    ServeMux(const ServeMux&) = delete;
+    ServeMux& operator=(const ServeMux&) = delete;
     
     /**
      * @brief Registers a handler for a pattern
      * 
      * @param pattern URL pattern to match
      * @param handler Handler function
+     * @throws std::invalid_argument if the pattern is malformed or already registered
      */
     void HandleFunc(const std::string& pattern, HandlerFunc handler);
     
@@ -117,28 +259,135 @@ public:
     void ServeHTTP(ResponseWriter& w, const Request& req);
 
 private:
-    std::map<std::string, HandlerFunc> handlers_;
+    std::unique_ptr<detail::RouteNode> root_;
+};
+
+/**
+ * @brief States a server connection goes through, like Go's http.ConnState
+ */
+enum class ConnState {
+    New,     ///< Accepted; no request read yet
+    Active,  ///< Serving a request
+    Idle,    ///< Kept alive between requests
+    Closed,  ///< Closed; reported last, once
 };
 
 /**
  * @brief HTTP server
+ * 
+ * Each connection is served by a runtime task (gocxx::go). max_conns bounds
+ * how many are served at once: when it is reached the server stops calling
+ * Accept, and further connections wait in the kernel's listen backlog
+ * instead of each costing a task and, while blocked, a thread.
+ * 
+ * Connections are persistent (HTTP/1.1 keep-alive): requests are read one
+ * after another from the same connection, including pipelined ones that
+ * arrive together, and answered in order. Request bodies are framed by
+ * Content-Length or chunked transfer encoding. A response is buffered up to
+ * 4KB so it can carry a Content-Length; a longer one without that header is
+ * sent chunked, or delimited by closing the connection for HTTP/1.0 clients.
+ * After the header, small writes keep coalescing into 4KB sends (one chunk
+ * each); the writer implements Flusher for handlers that stream.
+ * 
+ * With h2c set, a connection that opens with the HTTP/2 client preface
+ * (prior knowledge, RFC 9113 section 3.3) is served as HTTP/2 instead:
+ * its streams are handled concurrently, each on a task of its own, and
+ * their responses interleave on the connection by stream weight.
+ * max_requests_per_conn counts streams; idle_timeout applies while no
+ * stream is open. TLS, and so ALPN "h2", is not supported.
+ * 
+ * A handler that throws costs only its connection, closed without a
+ * response (HTTP/2: its stream, reset with INTERNAL_ERROR), as a panic
+ * does in Go.
+ * 
+ * The limits are read when Serve starts; set them before.
  */
 class Server {
 public:
     std::string addr;                    ///< Server address
     std::shared_ptr<ServeMux> handler;   ///< Request multiplexer
+    std::size_t max_conns = 0;           ///< Connections served at once; 0 = unlimited
+    std::size_t max_handlers = 0;        ///< Handler calls running at once; 0 = unlimited
+    int backlog = 128;                   ///< Listen backlog used by ListenAndServe
+    std::size_t max_requests_per_conn = 0;  ///< Requests served per connection; 0 = unlimited
+    std::size_t max_header_bytes = 1 << 20; ///< Request line plus headers; more gets 431
+    std::size_t max_body_bytes = 32 << 20;  ///< Request body; more gets 413 and the connection (HTTP/2: the stream) is closed; 0 = unlimited
+    std::chrono::nanoseconds read_header_timeout{0};  ///< Time to read a request's headers; 0 = none
+    std::chrono::nanoseconds idle_timeout{0};  ///< Wait for the next request on a kept-alive connection; 0 = read_header_timeout
+    std::size_t listen_shards = 0;       ///< SO_REUSEPORT sockets ListenAndServe opens, one accept loop each; 0 = one socket
+    bool pin_accept_loops = false;       ///< Pins shard i's accept loop to CPU i, with an SO_INCOMING_CPU hint (Linux)
+    std::shared_ptr<ServerMetrics> metrics;  ///< Records requests and connections (http_metrics.h); null = none
+    bool h2c = false;                    ///< Also serve HTTP/2 to clients that open with its preface
+    std::uint32_t h2_max_concurrent_streams = 250;  ///< HTTP/2 streams a client may have open per connection
+
+    /// Called as each connection changes state, like Go's Server.ConnState; it runs on the connection's task, so keep it short.
+    std::function<void(const std::shared_ptr<TCPConn>& conn, ConnState state)> conn_state;
     
     Server(const std::string& addr, std::shared_ptr<ServeMux> mux)
         : addr(addr), handler(mux) {}
     
     /**
      * @brief Starts the server and listens for requests
+     * 
+     * @return ErrServerClosed after Shutdown or Close, else the listen error
      */
     gocxx::base::Result<void> ListenAndServe();
 
+    /**
+     * @brief Serves connections accepted from @p listener until Shutdown or Close
+     * 
+     * @return ErrServerClosed after Shutdown or Close, else the accept error
+     */
+    gocxx::base::Result<void> Serve(std::shared_ptr<TCPListener> listener);
+
+    /**
+     * @brief Serves @p listeners, such as those from ListenConfig::ListenShards, with one accept loop each
+     * 
+     * Each loop runs on its own thread (pinned to CPU i for listener i when
+     * pin_accept_loops is set) so accepts proceed in parallel; connections
+     * are served as with Serve. Returns once every loop has ended.
+     * 
+     * @throws std::invalid_argument if @p listeners is empty
+     * @return ErrServerClosed after Shutdown or Close, else the first accept error
+     */
+    gocxx::base::Result<void> ServeShards(std::vector<std::shared_ptr<TCPListener>> listeners);
+
+    /**
+     * @brief Stops the server gracefully
+     * 
+     * Like Go's Server.Shutdown: closes the listener and every idle
+     * connection, then waits until the requests in flight have been
+     * answered. Returns ctx->Err() if @p ctx ends first; those connections
+     * are left to finish on their own. A null @p ctx waits indefinitely.
+     */
+    gocxx::base::Result<void> Shutdown(context::ContextPtr ctx);
+
+    /**
+     * @brief Closes the listener and every connection, without waiting
+     */
+    gocxx::base::Result<void> Close();
+
 private:
+    friend class detail::H2ServerConn;
+
     void handleConnection(std::shared_ptr<TCPConn> conn);
-    gocxx::base::Result<Request> parseRequest(const std::string& raw_request);
+    void serveH2(const std::shared_ptr<TCPConn>& conn, gocxx::bufio::Reader& reader);  // http2.cpp
+    gocxx::base::Result<void> readRequest(gocxx::bufio::Reader& reader, TCPConn& conn, Request& req);
+    bool shuttingDown();
+
+    bool trackConn(const std::shared_ptr<TCPConn>& conn);
+    bool setState(const std::shared_ptr<TCPConn>& conn, ConnState state);
+    void untrackConn(const std::shared_ptr<TCPConn>& conn);
+    void beginShutdown(bool closeActive);
+
+    std::mutex mu_;
+    bool shutting_down_ = false;
+    std::vector<std::shared_ptr<TCPListener>> listeners_;
+    std::vector<context::CancelFunc> stop_accepting_;
+    std::unordered_map<TCPConn*, ConnState> conns_;  ///< Tracked connection -> its state
+    gocxx::base::Chan<bool> drained_;            ///< Closed once shut down with no connections left
+    std::unique_ptr<gocxx::sync::Semaphore> conn_slots_;
+    std::unique_ptr<gocxx::sync::Semaphore> handler_slots_;
 };
 
 /**
@@ -169,10 +418,120 @@ void HandleFunc(const std::string& pattern, HandlerFunc handler);
  */
 std::shared_ptr<ServeMux> DefaultServeMux();
 
+/**
+ * @brief Handler serving the file tree under root, like Go's http.FileServer(http.Dir(root))
+ * 
+ * The request path is percent-decoded and cleaned, so ".." never reaches
+ * above root. A directory is redirected to its path with a trailing slash
+ * and answered with its index.html, or else with a listing. Only GET and
+ * HEAD are served.
+ * 
+ * Responses carry Last-Modified, an ETag derived from the size and
+ * modification time, and Accept-Ranges; If-None-Match and If-Modified-Since
+ * can give 304, and a single Range (honouring If-Range) gives 206 or 416.
+ * Requests for several ranges get the whole file. Bodies go out with
+ * sendfile(2) where the connection allows.
+ * 
+ * Open descriptors and stat results are cached per handler for the most
+ * recently served files and revalidated with a stat() once they are a
+ * second old, so a changed file is noticed within about a second.
+ */
+HandlerFunc FileServer(const std::string& root);
+
+/**
+ * @brief Serves the named file or directory, like Go's http.ServeFile
+ * 
+ * Behaves as FileServer for a single path, without the trailing-slash
+ * redirect; requests whose path contains a ".." segment are rejected with 400.
+ */
+void ServeFile(ResponseWriter& w, const Request& req, const std::string& name);
+
+/**
+ * @brief Handler serving requests by removing prefix from the URL, like Go's http.StripPrefix
+ * 
+ * Requests whose URL does not start with prefix get 404.
+ */
+HandlerFunc StripPrefix(const std::string& prefix, HandlerFunc handler);
+
+/**
+ * @brief HTTP/1.1 transport with per-host pools of idle keep-alive connections
+ * 
+ * Similar to Go's http.Transport. A connection goes back to its host's pool
+ * once its response body has been read to the end; the next request to
+ * that host reuses it instead of dialing. Safe for concurrent use.
+ * 
+ * With h2c set, requests go over HTTP/2 without TLS, assuming the server
+ * speaks it (prior knowledge): a host gets one connection that carries
+ * many requests at once, and another only when the server's
+ * SETTINGS_MAX_CONCURRENT_STREAMS is reached. Requests the server refused
+ * or never processed (REFUSED_STREAM, GOAWAY) are retried on a new
+ * connection. max_idle_conns_per_host and idle_conn_timeout do not apply.
+ */
+class Transport {
+public:
+    std::size_t max_idle_conns_per_host = 2;  ///< Idle connections kept per host; 0 = no pooling
+    std::chrono::nanoseconds idle_conn_timeout = std::chrono::seconds(90);  ///< Idle connections older than this are dropped
+    std::chrono::nanoseconds dial_timeout = std::chrono::seconds(30);       ///< Limit on connecting; 0 = none
+    std::chrono::nanoseconds response_header_timeout{0};  ///< Wait for the response headers after the request is sent; 0 = none
+    bool h2c = false;  ///< Speak HTTP/2 to every host, over cleartext
+
+    Transport();
+    ~Transport();
+
+    Transport(const Transport&) = delete;
+    Transport& operator=(const Transport&) = delete;
+
+    /**
+     * @brief Sends @p req and returns once the response headers have arrived
+     * 
+     * req.url is absolute ("http://host[:port]/path"). The body streams from
+     * Response::body_stream. Cancelling @p ctx aborts the exchange, body
+     * included; a request on a pooled connection that the server had
+     * already closed is retried once on a new one when it is idempotent.
+     */
+    gocxx::base::Result<Response> RoundTrip(context::ContextPtr ctx, const Request& req);
+
+    /// Closes every idle connection.
+    void CloseIdleConnections();
+
+    struct Pool;
+    struct H2Pool;
+
+private:
+    std::shared_ptr<Pool> pool_;
+    std::shared_ptr<H2Pool> h2_pool_;
+};
+
+/**
+ * @brief Shared transport used by Client instances without their own and by Get/Post
+ */
+std::shared_ptr<Transport> DefaultTransport();
+
+/**
+ * @brief HTTP client
+ * 
+ * Similar to Go's http.Client
+ */
+class Client {
+public:
+    std::shared_ptr<Transport> transport;  ///< null = DefaultTransport()
+
+    /**
+     * @brief Sends @p req; the response body streams from Response::body_stream
+     */
+    gocxx::base::Result<Response> Do(context::ContextPtr ctx, const Request& req);
+
+    /// GET @p url, with the whole body read into Response::body.
+    gocxx::base::Result<Response> Get(const std::string& url);
+
+    /// POST @p body to @p url, with the whole response body read into Response::body.
+    gocxx::base::Result<Response> Post(const std::string& url, const std::string& content_type, const std::string& body);
+};
+
 /**
  * @brief Performs an HTTP GET request
  * 
- * Similar to Go's http.Get(url)
+ * Similar to Go's http.Get(url); reuses connections through DefaultTransport()
  * 
  * @param url URL to fetch
  * @return Result containing Response or an error
@@ -182,7 +541,8 @@ gocxx::base::Result<Response> Get(const std::string& url);
 /**
  * @brief Performs an HTTP POST request
  * 
- * Similar to Go's http.Post(url, contentType, body)
+ * Similar to Go's http.Post(url, contentType, body); reuses connections
+ * through DefaultTransport()
  * 
  * @param url URL to post to
  * @param content_type Content-Type header value
@@ -199,6 +559,7 @@ const int StatusOK = 200;
 const int StatusCreated = 201;
 const int StatusBadRequest = 400;
 const int StatusNotFound = 404;
+const int StatusMethodNotAllowed = 405;
 const int StatusInternalServerError = 500;
 
 } // namespace gocxx::net::http
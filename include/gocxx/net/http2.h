@@ -0,0 +1,240 @@
+#pragma once
+
+/**
+ * @file http2.h
+ * @brief HTTP/2 framing (RFC 9113), like Go's x/net/http2 Framer
+ *
+ * The HTTP/2 server and client are reached through http::Server and
+ * http::Transport (set their h2c fields); this header holds the wire
+ * format they share: frame types, settings, error codes and a Framer that
+ * reads and writes frames on a connection.
+ *
+ * @code
+ * http2::Framer fr(reader, *conn);
+ * fr.WriteSettings({{http2::SettingID::MaxConcurrentStreams, 100}});
+ * fr.Flush();
+ * auto frame = fr.ReadFrame();
+ * if (frame.value.header.type == http2::FrameType::Settings) ...
+ * @endcode
+ */
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/io/io.h>
+
+namespace gocxx::net::http2 {
+
+/// What a client sends first on an HTTP/2 connection, before its SETTINGS.
+constexpr std::string_view ClientPreface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+constexpr std::uint32_t kFrameHeaderLen = 9;
+constexpr std::uint32_t kDefaultMaxFrameSize = 16384;        ///< Until the peer's SETTINGS_MAX_FRAME_SIZE says otherwise
+constexpr std::uint32_t kMaxFrameSizeLimit = (1u << 24) - 1;
+constexpr std::int64_t kDefaultWindowSize = 65535;           ///< Initial stream and connection flow-control window
+constexpr std::int64_t kMaxWindowSize = (std::int64_t(1) << 31) - 1;
+
+enum class FrameType : std::uint8_t {
+    Data = 0x0,
+    Headers = 0x1,
+    Priority = 0x2,
+    RSTStream = 0x3,
+    Settings = 0x4,
+    PushPromise = 0x5,
+    Ping = 0x6,
+    GoAway = 0x7,
+    WindowUpdate = 0x8,
+    Continuation = 0x9,
+};
+
+/// Frame flags; which apply depends on the frame type.
+constexpr std::uint8_t FlagEndStream = 0x1;   ///< DATA, HEADERS
+constexpr std::uint8_t FlagAck = 0x1;         ///< SETTINGS, PING
+constexpr std::uint8_t FlagEndHeaders = 0x4;  ///< HEADERS, CONTINUATION
+constexpr std::uint8_t FlagPadded = 0x8;      ///< DATA, HEADERS
+constexpr std::uint8_t FlagPriority = 0x20;   ///< HEADERS
+
+/// Error codes of RST_STREAM and GOAWAY (RFC 9113 section 7).
+enum class ErrCode : std::uint32_t {
+    NoError = 0x0,
+    Protocol = 0x1,
+    Internal = 0x2,
+    FlowControl = 0x3,
+    SettingsTimeout = 0x4,
+    StreamClosed = 0x5,
+    FrameSize = 0x6,
+    RefusedStream = 0x7,
+    Cancel = 0x8,
+    Compression = 0x9,
+    Connect = 0xa,
+    EnhanceYourCalm = 0xb,
+    InadequateSecurity = 0xc,
+    HTTP11Required = 0xd,
+};
+
+/// "PROTOCOL_ERROR" and so on, as RFC 9113 names them.
+const char* ErrCodeName(ErrCode code) noexcept;
+
+enum class SettingID : std::uint16_t {
+    HeaderTableSize = 0x1,
+    EnablePush = 0x2,
+    MaxConcurrentStreams = 0x3,
+    InitialWindowSize = 0x4,
+    MaxFrameSize = 0x5,
+    MaxHeaderListSize = 0x6,
+};
+
+struct Setting {
+    SettingID id;
+    std::uint32_t value;
+};
+
+/**
+ * @brief A stream's priority (RFC 7540 section 5.3): a parent and a weight
+ *
+ * Weight is stored as on the wire, 0-255 for a weight of 1-256.
+ */
+struct PriorityParam {
+    std::uint32_t stream_dep = 0;
+    bool exclusive = false;
+    std::uint8_t weight = 15;
+};
+
+struct FrameHeader {
+    std::uint32_t length = 0;
+    FrameType type = FrameType::Data;
+    std::uint8_t flags = 0;
+    std::uint32_t stream_id = 0;
+
+    bool Has(std::uint8_t flag) const { return (flags & flag) != 0; }
+};
+
+/**
+ * @brief A frame as read by Framer::ReadFrame()
+ *
+ * For DATA and HEADERS, payload is the data or header block with padding
+ * and the priority fields removed, and a HEADERS frame already carries the
+ * fragments of its CONTINUATION frames; header.length stays the length
+ * on the wire, which is what flow control counts.
+ */
+struct Frame {
+    FrameHeader header;
+    std::string payload;
+    bool has_priority = false;  ///< PRIORITY, or HEADERS with FlagPriority
+    PriorityParam priority;
+
+    /// SETTINGS parameters, in order.
+    std::vector<Setting> Settings() const;
+    /// WINDOW_UPDATE increment.
+    std::uint32_t WindowIncrement() const;
+    /// RST_STREAM or GOAWAY error code.
+    ErrCode Code() const;
+    /// GOAWAY: the last stream the sender may have processed.
+    std::uint32_t LastStreamID() const;
+    /// GOAWAY: the debug data after the error code.
+    std::string_view DebugData() const;
+    /// PING: the opaque data.
+    std::array<std::uint8_t, 8> PingData() const;
+};
+
+/**
+ * @brief A violation that ends the connection: send GOAWAY with Code() and close
+ */
+class ConnectionError : public gocxx::errors::Error {
+public:
+    ConnectionError(ErrCode code, std::string reason) : code_(code), reason_(std::move(reason)) {}
+
+    std::string error() const noexcept override;
+    ErrCode Code() const { return code_; }
+
+private:
+    ErrCode code_;
+    std::string reason_;
+};
+
+/**
+ * @brief A problem confined to one stream: send RST_STREAM with Code()
+ *
+ * Also what a client gets for a stream the server reset.
+ */
+class StreamError : public gocxx::errors::Error {
+public:
+    StreamError(std::uint32_t streamID, ErrCode code) : stream_id_(streamID), code_(code) {}
+
+    std::string error() const noexcept override;
+    std::uint32_t StreamID() const { return stream_id_; }
+    ErrCode Code() const { return code_; }
+
+private:
+    std::uint32_t stream_id_;
+    ErrCode code_;
+};
+
+/**
+ * @brief Reads and writes frames on one connection
+ *
+ * Reading validates each frame's size, stream and flags, and joins a
+ * header block's CONTINUATION frames onto its HEADERS. Writes are appended
+ * to an internal buffer and sent together by Flush(), so a burst of frames
+ * costs one write. One thread may read while another writes; neither side
+ * is safe for concurrent use by itself.
+ */
+class Framer {
+public:
+    Framer(gocxx::io::Reader& r, gocxx::io::Writer& w) : r_(r), w_(w) {}
+
+    /// Frames longer than this are a FRAME_SIZE_ERROR; what we advertise as SETTINGS_MAX_FRAME_SIZE.
+    void SetMaxReadFrameSize(std::uint32_t size) { max_read_ = size; }
+    /// The peer's SETTINGS_MAX_FRAME_SIZE; WriteHeaders() splits blocks to fit it.
+    void SetMaxWriteFrameSize(std::uint32_t size) { max_write_ = size; }
+    std::uint32_t MaxWriteFrameSize() const { return max_write_; }
+    /// Limit on a header block joined from CONTINUATION frames.
+    void SetMaxHeaderBlockSize(std::size_t size) { max_header_block_ = size; }
+
+    /**
+     * @brief Reads the next frame
+     *
+     * @return ConnectionError or StreamError for a frame that breaks the
+     *         protocol (a StreamError frame has been consumed, and the
+     *         connection may go on), or the reader's error
+     */
+    gocxx::base::Result<Frame> ReadFrame();
+
+    void WriteData(std::uint32_t streamID, bool endStream, std::string_view data);
+    /// HEADERS, then CONTINUATION frames for a block longer than MaxWriteFrameSize().
+    void WriteHeaders(std::uint32_t streamID, bool endStream, std::string_view block,
+                      const PriorityParam* priority = nullptr);
+    void WritePriority(std::uint32_t streamID, const PriorityParam& priority);
+    void WriteRSTStream(std::uint32_t streamID, ErrCode code);
+    void WriteSettings(const std::vector<Setting>& settings);
+    void WriteSettingsAck();
+    void WritePing(bool ack, const std::array<std::uint8_t, 8>& data);
+    void WriteGoAway(std::uint32_t lastStreamID, ErrCode code, std::string_view debug = {});
+    void WriteWindowUpdate(std::uint32_t streamID, std::uint32_t increment);
+
+    /// Sends everything written since the last Flush().
+    gocxx::base::Result<void> Flush();
+
+    /// Bytes written but not yet flushed.
+    std::size_t Buffered() const { return out_.size(); }
+
+private:
+    gocxx::base::Result<FrameHeader> readHeader();
+    std::shared_ptr<gocxx::errors::Error> readFull(char* dst, std::size_t n, std::size_t& got);
+    std::shared_ptr<gocxx::errors::Error> readPayload(std::uint32_t length, std::string& out);
+    void header(std::uint32_t length, FrameType type, std::uint8_t flags, std::uint32_t streamID);
+
+    gocxx::io::Reader& r_;
+    gocxx::io::Writer& w_;
+    std::uint32_t max_read_ = kDefaultMaxFrameSize;
+    std::uint32_t max_write_ = kDefaultMaxFrameSize;
+    std::size_t max_header_block_ = 1 << 20;
+    std::string out_;
+};
+
+} // namespace gocxx::net::http2
@@ -0,0 +1,153 @@
+#pragma once
+
+/**
+ * @file http_metrics.h
+ * @brief Request and connection metrics for http::Server
+ *
+ * Provides ServerMetrics, which a Server fills in when its metrics field is
+ * set: per-route request counts, body bytes and latency histograms, requests
+ * in flight and connections by state, exported in the Prometheus text
+ * format by MetricsHandler().
+ */
+
+#include <gocxx/net/http.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gocxx::net::http {
+
+namespace detail {
+struct MetricsShard;
+}
+
+/**
+ * @brief Latency histogram with log-linear buckets, in the manner of HdrHistogram
+ *
+ * Values are microseconds. Below 16 each value has its own bucket; above,
+ * every power of two is split into 8 equal buckets, so a bucket's bounds
+ * are within 12.5% of each other from 16µs up to 2^32µs (about 71 minutes),
+ * where the last bucket takes everything longer.
+ */
+struct LatencyHistogram {
+    static constexpr std::size_t kSubBuckets = 8;
+    static constexpr std::size_t kBuckets = 2 * kSubBuckets + (32 - 4) * kSubBuckets;
+
+    std::array<std::uint64_t, kBuckets> counts{};
+
+    /// The bucket holding @p micros.
+    static std::size_t BucketFor(std::uint64_t micros) noexcept;
+
+    /// The smallest value, in microseconds, past bucket @p i.
+    static std::uint64_t UpperBound(std::size_t i) noexcept;
+
+    void Record(std::chrono::nanoseconds latency) noexcept { ++counts[BucketFor(toMicros(latency))]; }
+    std::uint64_t Count() const noexcept;
+
+    /// The latency below which a fraction @p q of the recorded ones fall, to the histogram's precision.
+    std::chrono::microseconds Quantile(double q) const noexcept;
+
+    /// Values recorded below @p micros; exact when @p micros is a power of two.
+    std::uint64_t CountBelow(std::uint64_t micros) const noexcept;
+
+private:
+    static std::uint64_t toMicros(std::chrono::nanoseconds d) noexcept {
+        return d.count() <= 0 ? 0 : static_cast<std::uint64_t>(d.count()) / 1000;
+    }
+};
+
+/**
+ * @brief What ServerMetrics recorded for one route
+ */
+struct RouteStats {
+    std::string route;                      ///< The ServeMux pattern; empty for requests no pattern matched
+    std::uint64_t requests = 0;
+    std::array<std::uint64_t, 5> by_class{};  ///< Responses by status class: 1xx at index 0 through 5xx at index 4
+    std::uint64_t request_bytes = 0;        ///< Request body bytes read
+    std::uint64_t response_bytes = 0;       ///< Response body bytes sent
+    std::chrono::nanoseconds latency_sum{0};
+    LatencyHistogram latency;
+};
+
+/**
+ * @brief What ServerMetrics recorded for a whole server
+ */
+struct ServerStats {
+    std::vector<RouteStats> routes;  ///< Sorted by route
+    std::int64_t in_flight = 0;      ///< Requests whose handler is running
+    std::uint64_t accepted = 0;      ///< Connections accepted
+    std::int64_t conns_new = 0;      ///< Open connections that have not sent a request yet
+    std::int64_t conns_active = 0;   ///< Open connections with a request being served
+    std::int64_t conns_idle = 0;     ///< Open connections between requests
+};
+
+/**
+ * @brief Per-route request metrics for one or more Servers
+ *
+ * Set it as Server::metrics; each request is then recorded under the
+ * pattern ServeMux matched (Request::Pattern()): its status class, body
+ * bytes each way and the time from the request being read to the response
+ * being sent. Connection counts follow the states Server::conn_state
+ * reports.
+ *
+ * Each thread records into a shard of its own with plain loads and stores,
+ * so recording takes a few tens of nanoseconds and never waits on another
+ * thread; Snapshot() and the export add the shards up, taking each one's
+ * lock only to walk its route table.
+ *
+ * @code
+ * auto metrics = std::make_shared<http::ServerMetrics>();
+ * mux->HandleFunc("GET /metrics", http::MetricsHandler(metrics));
+ * server.metrics = metrics;
+ * @endcode
+ */
+class ServerMetrics {
+public:
+    ServerMetrics();
+    ~ServerMetrics();
+
+    ServerMetrics(const ServerMetrics&) = delete;
+    ServerMetrics& operator=(const ServerMetrics&) = delete;
+
+    /// Everything recorded so far, summed over threads.
+    ServerStats Snapshot() const;
+
+    /**
+     * @brief Appends the metrics to @p out in the Prometheus text exposition format (version 0.0.4)
+     *
+     * Latency buckets are the histogram's powers of two from 16µs to about
+     * a minute, so each `le` count is exact.
+     */
+    void WritePrometheus(std::string& out) const;
+
+    /// Counts a request in flight; Server calls it before the handler.
+    void RequestStarted();
+
+    /// Records a request RequestStarted() counted, once its response is sent.
+    void RequestFinished(std::string_view route, int status, std::size_t request_bytes,
+                         std::size_t response_bytes, std::chrono::nanoseconds latency);
+
+private:
+    friend class Server;
+
+    void connOpened();
+    void connStateChanged(ConnState from, ConnState to);
+
+    detail::MetricsShard& localShard();
+
+    const std::uint64_t id_;  // tells this instance's shards apart in thread-local caches
+    mutable std::mutex mu_;   // guards shards_, which only grows
+    std::vector<std::unique_ptr<detail::MetricsShard>> shards_;
+};
+
+/**
+ * @brief Handler answering with @p metrics in the Prometheus text format, like promhttp.Handler()
+ */
+HandlerFunc MetricsHandler(std::shared_ptr<const ServerMetrics> metrics);
+
+} // namespace gocxx::net::http
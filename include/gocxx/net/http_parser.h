@@ -0,0 +1,119 @@
+#pragma once
+
+/**
+ * @file http_parser.h
+ * @brief Incremental, allocation-free HTTP/1.x request head parser
+ *
+ * RequestParser works over a caller-owned buffer in the manner of
+ * picohttpparser: it returns the method, request target and header fields
+ * as std::string_view slices of that buffer, never copies them, and can be
+ * fed the same buffer again as more bytes arrive without rescanning what
+ * it has already seen. Lines are scanned 16 bytes at a time with SSE2 where
+ * available.
+ *
+ * @code
+ * http::RequestParser parser;
+ * for (;;) {
+ *     auto head = reader.Peek(reader.Buffered() + 1);
+ *     auto status = parser.Parse(head.value);
+ *     if (status == http::RequestParser::Status::Complete) break;
+ *     if (status != http::RequestParser::Status::Incomplete || head.Failed()) return errBadRequest;
+ * }
+ * auto host = parser.Header("host");  // case-insensitive, no copy
+ * @endcode
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace gocxx::net::http {
+
+/// One header field as views into the parsed buffer; the value has surrounding whitespace trimmed.
+struct HeaderField {
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * @brief Request line and header fields, parsed in place
+ *
+ * Parse() is given the buffer holding the request so far. The buffer may
+ * be moved or grown between calls (as bufio::Reader does when it fills) as
+ * long as the bytes already passed stay the same: the parser keeps offsets,
+ * not pointers. The views returned by the accessors point into the buffer
+ * given to the last Parse() call.
+ *
+ * Malformed input is rejected as soon as the offending line is complete, or
+ * as soon as a control character shows up in it: folded header lines,
+ * whitespace before a colon, a method or field name that is not a token,
+ * and versions other than HTTP/1.0 and HTTP/1.1 (RFC 9112 sections 2-5).
+ */
+class RequestParser {
+public:
+    /// Header fields beyond this make Parse() return TooManyHeaders.
+    static constexpr std::size_t kMaxHeaders = 100;
+
+    enum class Status {
+        Complete,        ///< The head ends at Consumed(); any bytes after it belong to the body
+        Incomplete,      ///< Call again once the buffer holds more bytes
+        Malformed,       ///< Not a valid request head; answer 400
+        TooManyHeaders,  ///< More than kMaxHeaders fields; answer 431
+    };
+
+    RequestParser() = default;
+
+    /// Resumes parsing @p buf, which starts with every byte given to earlier calls.
+    Status Parse(std::string_view buf);
+
+    /// Starts over for the next request.
+    void Reset() { *this = RequestParser(); }
+
+    /// Bytes of the head including the empty line that ends it; valid once Complete.
+    std::size_t Consumed() const { return pos_; }
+
+    std::string_view Method() const { return slice(method_); }
+    std::string_view Target() const { return slice(target_); }
+    /// 0 or 1, as in HTTP/1.x.
+    int MinorVersion() const { return minor_version_; }
+
+    std::size_t NumHeaders() const { return num_headers_; }
+    HeaderField Field(std::size_t i) const { return { slice(headers_[i].name), slice(headers_[i].value) }; }
+
+    /// Value of the first field named @p name, compared case-insensitively; empty when absent.
+    std::string_view Header(std::string_view name) const;
+
+    /// Whether a field named @p name is present.
+    bool HasHeader(std::string_view name) const;
+
+    /// ASCII case-insensitive equality, as field names compare.
+    static bool EqualFold(std::string_view a, std::string_view b);
+
+private:
+    struct Span {
+        std::uint32_t off = 0;
+        std::uint32_t len = 0;
+    };
+    struct FieldSpan {
+        Span name;
+        Span value;
+    };
+    enum class Stage { RequestLine, Headers, Done };
+
+    std::string_view slice(Span s) const { return std::string_view(base_ + s.off, s.len); }
+    const FieldSpan* find(std::string_view name) const;
+    Status parseRequestLine(std::size_t begin, std::size_t end);
+    Status parseHeaderLine(std::size_t begin, std::size_t end);
+
+    const char* base_ = nullptr;
+    Stage stage_ = Stage::RequestLine;
+    std::size_t pos_ = 0;   // start of the line being parsed
+    std::size_t scan_ = 0;  // bytes of that line already searched for its end
+    Span method_;
+    Span target_;
+    int minor_version_ = 1;
+    std::size_t num_headers_ = 0;
+    FieldSpan headers_[kMaxHeaders];
+};
+
+} // namespace gocxx::net::http
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file resolver.h
+ * @brief Caching host name resolver (Go-style)
+ *
+ * Provides Resolver, which looks host names up off the calling thread,
+ * shares concurrent lookups of one name and caches the answers, and
+ * DefaultResolver(), the one ResolveTCPAddr, ResolveUDPAddr and Dialer use.
+ */
+
+#include <gocxx/net/net.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gocxx::net {
+
+namespace detail {
+struct ResolverState;
+}
+
+/**
+ * @brief Counters describing a Resolver's cache
+ */
+struct ResolverStats {
+    std::uint64_t hits = 0;       ///< Lookups answered from the cache, failures included
+    std::uint64_t misses = 0;     ///< Lookups that had to wait for an answer
+    std::uint64_t shared = 0;     ///< Misses answered by a lookup that other callers waited on too
+    std::uint64_t refreshes = 0;  ///< Answers looked up again in the background before they expired
+    std::size_t entries = 0;      ///< Names cached now
+};
+
+/**
+ * @brief Looks up host names, like Go's net.Resolver, with a cache in front
+ *
+ * A lookup runs on the task runtime; the caller waits for it or for its
+ * context, whichever ends first, and a lookup its caller gave up on still
+ * completes and fills the cache. Concurrent lookups of one name share a
+ * single query. Answers are kept for their TTL and failures for
+ * negative_ttl; a hit within refresh_ahead of its expiry is served from
+ * the cache while a background lookup renews it, so names in steady use
+ * are never waited on again.
+ *
+ * The system resolver (getaddrinfo) reports no TTLs, so its answers are
+ * kept for ttl. A custom lookup may return its own.
+ *
+ * Set the fields before the first lookup.
+ *
+ * @code
+ * auto ips = net::DefaultResolver()->LookupHost(ctx, "example.com");
+ * @endcode
+ */
+class Resolver {
+public:
+    /// What a lookup found, and how long it may be cached; ttl 0 = the Resolver's ttl
+    struct Answer {
+        std::vector<std::string> addrs;
+        std::chrono::nanoseconds ttl{0};
+    };
+
+    /// Looks up one host name; it runs on the task runtime, so it should block only through runtime-aware waits
+    using LookupFunc = std::function<gocxx::base::Result<Answer>(const std::string& host)>;
+
+    std::chrono::nanoseconds ttl{std::chrono::seconds(30)};           ///< Lifetime of an answer that carries no TTL; 0 = no caching
+    std::chrono::nanoseconds negative_ttl{std::chrono::seconds(5)};   ///< Lifetime of a failed lookup; 0 = no caching
+    std::chrono::nanoseconds refresh_ahead{std::chrono::seconds(5)};  ///< Hits this close to expiry renew the entry in the background; 0 = never
+    std::size_t max_entries = 4096;                                   ///< Names cached at most; the least recently used go first
+    LookupFunc lookup;                                                ///< null = the system resolver
+
+    Resolver();
+    ~Resolver();
+
+    Resolver(const Resolver&) = delete;
+    Resolver& operator=(const Resolver&) = delete;
+
+    /**
+     * @brief Returns the host's addresses as IP literals, in order of preference
+     *
+     * An IP literal is returned as it is, without a lookup.
+     *
+     * @param ctx Context bounding the wait; null for none
+     * @return The addresses, ctx->Err() if the context ended first, or the lookup's error
+     */
+    gocxx::base::Result<std::vector<std::string>> LookupHost(
+        context::ContextPtr ctx, const std::string& host);
+
+    /**
+     * @brief Like LookupHost, keeping only the addresses network allows
+     *
+     * @param network "ip" for any family, "ip4" or "ip6"; "tcp", "udp"
+     *                and their 4/6 forms map to the same families
+     */
+    gocxx::base::Result<std::vector<std::string>> LookupIP(
+        context::ContextPtr ctx, const std::string& network, const std::string& host);
+
+    /**
+     * @brief Drops the cached answer for host, so the next lookup asks again
+     */
+    void Forget(const std::string& host);
+
+    /**
+     * @brief Drops every cached answer
+     */
+    void Clear();
+
+    ResolverStats Stats() const;
+
+private:
+    std::shared_ptr<detail::ResolverState> state_;
+};
+
+/**
+ * @brief The process-wide Resolver, which ResolveTCPAddr, ResolveUDPAddr
+ *        and Dialer fall back to
+ */
+std::shared_ptr<Resolver> DefaultResolver();
+
+} // namespace gocxx::net
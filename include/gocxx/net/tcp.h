@@ -13,10 +13,16 @@
 
 #include <gocxx/net/net.h>
 #include <string>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace gocxx::net {
 
+namespace detail {
+class PollDesc;
+}
+
 /**
  * @brief TCP network address
  */
@@ -36,10 +42,19 @@ public:
  * @brief TCP connection
  * 
  * Implements a TCP network connection with Reader, Writer, and Closer interfaces.
+ * The socket is non-blocking and served by the netpoller: a Read or Write
+ * that would block parks until the socket is ready, its deadline passes
+ * (ErrTimeout) or close() is called from another thread (ErrClosed).
  */
-class TCPConn : public Conn {
+class TCPConn : public Conn,
+                public gocxx::io::WriterTo,
+                public gocxx::io::ReaderFrom,
+                public gocxx::io::BuffersWriter,
+                public gocxx::io::BuffersReader,
+                public gocxx::io::FileDescriptor {
 public:
     TCPConn(int socket_fd, std::shared_ptr<TCPAddr> local, std::shared_ptr<TCPAddr> remote);
+    TCPConn(std::shared_ptr<detail::PollDesc> pd, std::shared_ptr<TCPAddr> local, std::shared_ptr<TCPAddr> remote);
     virtual ~TCPConn();
     
     // io::Reader interface
@@ -50,6 +65,22 @@ public:
     
     // io::Closer interface
     void close() override;
+
+    // io::WriterTo interface: splice when w is a socket, pipe or file
+    gocxx::base::Result<std::size_t> WriteTo(std::shared_ptr<gocxx::io::Writer> w) override;
+
+    // io::ReaderFrom interface: sendfile from a file, splice from a socket or pipe
+    gocxx::base::Result<std::size_t> ReadFrom(std::shared_ptr<gocxx::io::Reader> r) override;
+
+    // io::BuffersWriter interface: one sendmsg/WSASend for all of bufs
+    gocxx::base::Result<std::size_t> WriteBuffers(const gocxx::io::Buffers& bufs) override;
+
+    // io::BuffersReader interface: recvmsg/WSARecv into bufs; ErrClosed on peer close, like Read
+    gocxx::base::Result<std::size_t> ReadBuffers(const gocxx::io::MutableBuffers& bufs) override;
+
+    // io::FileDescriptor interface
+    int Fd() const override { return socket_fd_; }
+    std::shared_ptr<gocxx::errors::Error> WaitFd(bool write) override;
     
     // Conn interface
     std::shared_ptr<Addr> LocalAddr() override;
@@ -76,16 +107,14 @@ private:
     int socket_fd_;
     std::shared_ptr<TCPAddr> local_addr_;
     std::shared_ptr<TCPAddr> remote_addr_;
-    bool closed_;
-    
-    std::chrono::system_clock::time_point read_deadline_;
-    std::chrono::system_clock::time_point write_deadline_;
+    std::shared_ptr<detail::PollDesc> pd_;
 };
 
 /**
  * @brief TCP listener
  * 
- * Accepts incoming TCP connections.
+ * Accepts incoming TCP connections. Close() from another thread wakes a
+ * pending Accept with ErrClosed.
  */
 class TCPListener : public Listener {
 public:
@@ -96,15 +125,22 @@ public:
     gocxx::base::Result<void> Close() override;
     std::shared_ptr<Addr> Address() override;
 
+    /**
+     * @brief Sets the deadline for Accept; time_point::max() clears it
+     */
+    gocxx::base::Result<void> SetDeadline(std::chrono::system_clock::time_point deadline);
+
 private:
     int socket_fd_;
     std::shared_ptr<TCPAddr> local_addr_;
-    bool closed_;
+    std::shared_ptr<detail::PollDesc> pd_;
 };
 
 /**
  * @brief Resolves a TCP address from a string
  * 
+ * Host names are looked up through DefaultResolver(), which caches them.
+ * 
  * @param network Network type ("tcp", "tcp4", "tcp6")
  * @param address Address string (e.g., "localhost:8080", "192.168.1.1:80")
  * @return Result containing TCPAddr or an error
@@ -126,6 +162,49 @@ gocxx::base::Result<std::shared_ptr<TCPConn>> DialTCP(
     const std::string& network,
     const std::string& address);
 
+/**
+ * @brief Options for dialing TCP connections
+ * 
+ * Similar to Go's net.Dialer. Sockets get TCP_NODELAY and keep-alive
+ * probes by default. When a host has both IPv4 and IPv6 addresses, the
+ * family the resolver lists first is dialled first and the other joins
+ * the race after fallback_delay (Happy Eyeballs, RFC 8305); the first
+ * connection to complete wins.
+ */
+struct Dialer {
+    std::chrono::nanoseconds timeout{0};         ///< Limit on connecting, across every address tried; 0 = the system's own
+    std::chrono::nanoseconds keep_alive{0};      ///< Keep-alive probe period; 0 = 15s, negative = off
+    std::chrono::nanoseconds fallback_delay{0};  ///< Head start of the preferred address family; 0 = 300ms, negative = dial addresses in order
+    bool no_delay = true;                        ///< TCP_NODELAY: send small writes at once rather than wait on Nagle's algorithm
+    int send_buffer = 0;                         ///< SO_SNDBUF in bytes; 0 = the system's default
+    int recv_buffer = 0;                         ///< SO_RCVBUF in bytes; 0 = the system's default
+    bool fast_open = false;                      ///< TCP_FASTOPEN_CONNECT (Linux): the first write rides on the SYN once the server has issued a cookie
+
+    /**
+     * Called with each socket before it connects, like Go's Dialer.Control;
+     * network is "tcp4" or "tcp6" and address the one being dialled. A
+     * non-null error abandons that address.
+     */
+    std::function<std::shared_ptr<gocxx::errors::Error>(
+        const std::string& network, const std::string& address, int fd)> control;
+
+    /// Looks up a host's IP addresses in order of preference; null = DefaultResolver(), which caches them.
+    std::function<gocxx::base::Result<std::vector<std::string>>(
+        context::ContextPtr ctx, const std::string& network, const std::string& host)> resolver;
+
+    /**
+     * @brief Dials the address, giving up when @p ctx is done or the timeout passes
+     * 
+     * @param ctx Context bounding the connect; null for none
+     * @return The connection, ctx->Err() if the context ended first, or
+     *         ErrTimeout when the timeout passed
+     */
+    gocxx::base::Result<std::shared_ptr<TCPConn>> DialContext(
+        context::ContextPtr ctx,
+        const std::string& network,
+        const std::string& address) const;
+};
+
 /**
  * @brief Convenience function to dial a TCP connection
  * 
@@ -134,6 +213,42 @@ gocxx::base::Result<std::shared_ptr<TCPConn>> DialTCP(
  */
 gocxx::base::Result<std::shared_ptr<Conn>> Dial(const std::string& address);
 
+/**
+ * @brief Options for creating a TCP listener
+ * 
+ * Similar to Go's net.ListenConfig
+ */
+struct ListenConfig {
+    int backlog = 128;         ///< Connections the kernel queues before they are accepted
+    bool reuse_port = false;   ///< Sets SO_REUSEPORT, so several sockets can listen on the address
+    int incoming_cpu = -1;     ///< SO_INCOMING_CPU hint (Linux); -1 = none
+
+    /**
+     * @brief Listens on the address with these options
+     */
+    gocxx::base::Result<std::shared_ptr<TCPListener>> Listen(
+        const std::string& network,
+        const std::string& address) const;
+
+    /**
+     * @brief Opens @p shards SO_REUSEPORT listeners on the same address
+     * 
+     * The kernel spreads incoming connections across the sockets by a hash
+     * of the connection's addresses, so each can have its own accept loop
+     * (Server::ServeShards) instead of every accept going through one.
+     * For ":0" the first socket picks the port and the rest join it. With
+     * incoming_cpu >= 0, shard i is hinted to CPU incoming_cpu + i.
+     * 
+     * @throws std::invalid_argument if @p shards is 0
+     * @return The listeners, or the first error (none is left open); fails
+     *         where SO_REUSEPORT is not available
+     */
+    gocxx::base::Result<std::vector<std::shared_ptr<TCPListener>>> ListenShards(
+        const std::string& network,
+        const std::string& address,
+        std::size_t shards) const;
+};
+
 /**
  * @brief Listens for incoming TCP connections on the specified address
  * 
@@ -12,10 +12,16 @@
 
 #include <gocxx/net/net.h>
 #include <string>
+#include <array>
+#include <cstdint>
 #include <memory>
 
 namespace gocxx::net {
 
+namespace detail {
+class PollDesc;
+}
+
 /**
  * @brief UDP network address
  */
@@ -31,10 +37,58 @@ public:
     std::string String() const override;
 };
 
+/**
+ * @brief IP address and port held by value, like Go's netip.AddrPort
+ * 
+ * Batched reads report the sender of every datagram in one of these, so
+ * no UDPAddr is allocated per packet.
+ */
+struct AddrPort {
+    std::array<uint8_t, 16> ip{};  ///< Network byte order; an IPv4 address uses the first 4 bytes
+    std::uint16_t port = 0;
+    bool is_v6 = false;
+
+    /// The address of @p addr; the zero value if its ip is not a literal.
+    static AddrPort From(const UDPAddr& addr);
+
+    /// Whether this names an endpoint (port is set).
+    bool IsValid() const { return port != 0; }
+
+    std::shared_ptr<UDPAddr> ToUDPAddr() const;
+    std::string String() const;
+
+    bool operator==(const AddrPort& other) const {
+        return port == other.port && is_v6 == other.is_v6 && ip == other.ip;
+    }
+    bool operator!=(const AddrPort& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief One datagram for UDPConn::ReadBatch and WriteBatch, like x/net's ipv4.Message
+ * 
+ * The caller owns the buffers; a message array can be reused across
+ * batches without allocating.
+ */
+struct UDPMessage {
+    uint8_t* buffer = nullptr;  ///< Payload
+    std::size_t size = 0;       ///< ReadBatch: capacity of buffer; WriteBatch: bytes to send
+    std::size_t n = 0;          ///< Bytes received, or sent
+    AddrPort addr;              ///< ReadBatch: the sender; WriteBatch: the destination, unset on a connected socket
+
+    /**
+     * WriteBatch: when non-zero, buffer is sent as datagrams of this many
+     * bytes (the last may be shorter) with UDP_SEGMENT offload on Linux.
+     * ReadBatch: the size of the datagrams the kernel coalesced into
+     * buffer when GRO is on (see UDPConn::SetGRO); 0 for a single datagram.
+     */
+    std::size_t segment_size = 0;
+};
+
 /**
  * @brief UDP connection
  * 
- * Implements a UDP network connection for packet-based communication.
+ * Implements a UDP network connection for packet-based communication. Like
+ * TCPConn, reads park on the netpoller and honour the read deadline.
  */
 class UDPConn : public PacketConn {
 public:
@@ -108,18 +162,51 @@ public:
         std::size_t size,
         std::shared_ptr<UDPAddr> addr);
 
+    /// Messages one ReadBatch or WriteBatch system call carries; larger batches are split.
+    static constexpr std::size_t kMaxBatch = 64;
+
+    /**
+     * @brief Reads up to @p count datagrams with one recvmmsg(2) on Linux
+     * 
+     * Waits for the first datagram like ReadFromUDP, then takes whatever
+     * else is already queued, up to kMaxBatch. Fills n, addr and
+     * segment_size of each message read; elsewhere reads one datagram.
+     * 
+     * @return The number of messages filled, at least 1 on success
+     */
+    gocxx::base::Result<std::size_t> ReadBatch(UDPMessage* msgs, std::size_t count);
+
+    /**
+     * @brief Sends @p count datagrams with sendmmsg(2) on Linux, one sendto per datagram elsewhere
+     * 
+     * Sets n on each message sent.
+     * 
+     * @return The number of messages sent; fewer than @p count only with an error
+     */
+    gocxx::base::Result<std::size_t> WriteBatch(UDPMessage* msgs, std::size_t count);
+
+    /**
+     * @brief Turns UDP generic receive offload (UDP_GRO, Linux 5.0+) on or off
+     * 
+     * With GRO on, ReadBatch can return several datagrams from one sender
+     * coalesced into one buffer, with segment_size giving their length;
+     * buffers should then hold 64KB.
+     * 
+     * @return An error where the kernel does not support it
+     */
+    gocxx::base::Result<void> SetGRO(bool enable);
+
 private:
     int socket_fd_;
     std::shared_ptr<UDPAddr> local_addr_;
-    bool closed_;
-    
-    std::chrono::system_clock::time_point read_deadline_;
-    std::chrono::system_clock::time_point write_deadline_;
+    std::shared_ptr<detail::PollDesc> pd_;
 };
 
 /**
  * @brief Resolves a UDP address from a string
  * 
+ * Host names are looked up through DefaultResolver(), which caches them.
+ * 
  * @param network Network type ("udp", "udp4", "udp6")
  * @param address Address string (e.g., "localhost:8080", "192.168.1.1:80")
  * @return Result containing UDPAddr or an error
@@ -0,0 +1,195 @@
+#pragma once
+
+/**
+ * @file exec.h
+ * @brief Running external commands, like Go's os/exec
+ *
+ * A Cmd is started with posix_spawn, which glibc and macOS implement with
+ * vfork semantics: the child shares the parent's memory until it execs, so
+ * starting one costs the same from a process with a large resident set as
+ * from a small one, where fork would copy every page table.
+ *
+ * Standard streams are connected as the fields std_in, std_out and std_err
+ * say: an os::File is handed to the child as is; any other Reader or Writer
+ * is fed through a pipe by a task that copies until end of file; null means
+ * /dev/null. StdinPipe(), StdoutPipe() and StderrPipe() give the parent's
+ * end of a pipe instead, as an os::File, so io::Copy moves its data with
+ * splice when the other side is a pipe or socket.
+ *
+ * Children are reaped by one process-wide watcher thread, which waits on a
+ * pidfd per child (Linux 5.3 and later) or, elsewhere, on SIGCHLD; Wait()
+ * blocks only its caller, and no thread is parked per child.
+ *
+ * Starting the first Cmd ignores SIGPIPE if it had its default action, as
+ * Go does, so that writing to a child that has exited fails with EPIPE
+ * instead of killing this process. Children start with every signal at its
+ * default action and none blocked.
+ *
+ * @code
+ * auto cmd = exec::CommandContext(ctx, "grep", {"-c", "error"});
+ * auto out = cmd->StdoutPipe().value;
+ * cmd->std_in = logFile;        // passed to grep directly
+ * cmd->Start();
+ * io::Copy(sink, out);           // streams as grep writes
+ * auto done = cmd->Wait();       // ExitError when grep exits non-zero
+ * @endcode
+ *
+ * Not available on Windows, where Start() fails.
+ */
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <gocxx/base/result.h>
+#include <gocxx/context/context.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/io/io.h>
+#include <gocxx/os/file.h>
+#include <gocxx/os/os.h>
+
+namespace gocxx::os::exec {
+
+    /**
+     * LookPath found no executable of that name in $PATH.
+     */
+    extern std::shared_ptr<gocxx::errors::Error> ErrNotFound;
+
+    /**
+     * An unsuccessful exit: a non-zero status, or death by a signal.
+     */
+    class ExitError : public gocxx::errors::Error {
+    public:
+        explicit ExitError(std::shared_ptr<ProcessState> state) : state_(std::move(state)) {}
+
+        /// "exit status 2" or "signal: killed".
+        std::string error() const noexcept override;
+
+        /// The exit status; -1 for a process killed by a signal.
+        int ExitCode() const { return state_->exited ? state_->exitCode : -1; }
+
+        const std::shared_ptr<ProcessState>& State() const { return state_; }
+
+        /// What the child wrote to stderr, when Output() collected it.
+        std::string stderr_output;
+
+    private:
+        std::shared_ptr<ProcessState> state_;
+    };
+
+    /**
+     * Resolves @p file as the shell would: a name with a slash is used as
+     * is, any other is searched for in the directories of $PATH.
+     *
+     * @return the path of an executable regular file, or ErrNotFound
+     */
+    gocxx::base::Result<std::string> LookPath(const std::string& file);
+
+    namespace detail {
+        struct CmdState;
+    }
+
+    /**
+     * An external command, to be run once.
+     *
+     * Set the fields, then Start() and Wait(), or Run(). A Cmd is not safe
+     * for concurrent use, except that Signal() and Kill() may be called
+     * while another thread waits.
+     */
+    class Cmd {
+    public:
+        std::string path;                             ///< Program to run
+        std::vector<std::string> args;                ///< Its arguments, args[0] being its name
+        std::optional<std::vector<std::string>> env;  ///< "KEY=value" entries; unset = this process's environment
+        std::string dir;                              ///< Working directory; empty = this process's
+
+        std::shared_ptr<gocxx::io::Reader> std_in;    ///< Null = /dev/null
+        std::shared_ptr<gocxx::io::Writer> std_out;   ///< Null = /dev/null
+        std::shared_ptr<gocxx::io::Writer> std_err;   ///< Null = /dev/null; may be std_out, sharing its pipe
+
+        /// Sent when the context of CommandContext() is done before the process exits.
+        std::shared_ptr<os::Signal> cancel_signal = os::Kill;
+
+        /// Exit status, set by Wait().
+        std::shared_ptr<ProcessState> process_state;
+
+        /// A command running @p name (resolved with LookPath) with @p args.
+        explicit Cmd(const std::string& name, std::vector<std::string> args = {});
+        ~Cmd();
+
+        Cmd(const Cmd&) = delete;
+        Cmd& operator=(const Cmd&) = delete;
+
+        /**
+         * The write end of a pipe to the child's stdin; close it to send end of file.
+         * Call before Start().
+         */
+        gocxx::base::Result<std::shared_ptr<File>> StdinPipe();
+
+        /**
+         * The read end of a pipe from the child's stdout. Call before Start(),
+         * and read it to the end before Wait(), which closes it.
+         */
+        gocxx::base::Result<std::shared_ptr<File>> StdoutPipe();
+
+        /// Like StdoutPipe(), for stderr.
+        gocxx::base::Result<std::shared_ptr<File>> StderrPipe();
+
+        /**
+         * Starts the command without waiting for it.
+         *
+         * @return LookPath's error, the context's when it is already done,
+         *         or why the process could not be spawned
+         */
+        gocxx::base::Result<void> Start();
+
+        /**
+         * Waits for the process to exit and for its standard streams to be copied.
+         *
+         * @return ExitError for an unsuccessful exit, the context's error
+         *         when it was done and the process had to be killed, or the
+         *         first error copying a stream
+         */
+        gocxx::base::Result<void> Wait();
+
+        /// Start() then Wait().
+        gocxx::base::Result<void> Run();
+
+        /// Runs the command and returns its stdout; stderr is kept in a returned ExitError.
+        gocxx::base::Result<std::string> Output();
+
+        /// Runs the command and returns its stdout and stderr, interleaved.
+        gocxx::base::Result<std::string> CombinedOutput();
+
+        /// Process id once started; 0 before.
+        int Pid() const;
+
+        /// Sends @p sig, unless the process has already been reaped.
+        gocxx::base::Result<void> Signal(std::shared_ptr<os::Signal> sig);
+
+        /// Signal(os::Kill).
+        gocxx::base::Result<void> Kill();
+
+    private:
+        friend std::shared_ptr<Cmd> CommandContext(context::ContextPtr ctx, const std::string& name,
+                                                   std::vector<std::string> args);
+
+        gocxx::base::Result<std::shared_ptr<File>> pipeFor(int childFd);
+
+        std::shared_ptr<gocxx::errors::Error> lookup_err_;
+        context::ContextPtr ctx_;
+        std::shared_ptr<detail::CmdState> state_;
+    };
+
+    /**
+     * A command running @p name with @p args.
+     */
+    std::shared_ptr<Cmd> Command(const std::string& name, std::vector<std::string> args = {});
+
+    /**
+     * Like Command(), killed with cancel_signal if @p ctx is done before it exits.
+     */
+    std::shared_ptr<Cmd> CommandContext(context::ContextPtr ctx, const std::string& name,
+                                        std::vector<std::string> args = {});
+
+} // namespace gocxx::os::exec
@@ -144,13 +144,24 @@ namespace gocxx::os {
     extern std::shared_ptr<gocxx::errors::Error> ErrNoDeadline;
     extern std::shared_ptr<gocxx::errors::Error> ErrDeadlineExceeded;
 
+    // Returned by Walk and WalkParallel callbacks: SkipDir skips the current
+    // directory (or, from a file, the rest of its directory), SkipAll ends
+    // the walk without an error
+    extern std::shared_ptr<gocxx::errors::Error> SkipDir;
+    extern std::shared_ptr<gocxx::errors::Error> SkipAll;
+
     // File represents an open file descriptor
     class File : public gocxx::io::Reader, 
                  public gocxx::io::Writer, 
                  public gocxx::io::Closer,
                  public gocxx::io::ReaderAt,
                  public gocxx::io::WriterAt,
-                 public gocxx::io::Seeker {
+                 public gocxx::io::Seeker,
+                 public gocxx::io::WriterTo,
+                 public gocxx::io::ReaderFrom,
+                 public gocxx::io::BuffersWriter,
+                 public gocxx::io::BuffersReader,
+                 public gocxx::io::FileDescriptor {
     private:
         int fd;
         std::string name;
@@ -169,14 +180,28 @@ namespace gocxx::os {
         // Closer interface
         void close() override;
 
-        // ReaderAt interface
+        // ReaderAt interface: pread, leaving the file offset unchanged and
+        // safe to call from several threads; io::ErrEOF on a short read
         gocxx::base::Result<std::size_t> ReadAt(uint8_t* buffer, std::size_t size, std::size_t offset) override;
 
-        // WriterAt interface
+        // WriterAt interface: pwrite, likewise independent of the file offset
         gocxx::base::Result<std::size_t> WriteAt(const uint8_t* buffer, std::size_t size, std::size_t offset) override;
 
         // Seeker interface
         gocxx::base::Result<std::size_t> Seek(std::size_t offset, gocxx::io::whence whence) override;
+
+        // WriterTo interface: sendfile/copy_file_range/splice when w is a file, socket or pipe
+        gocxx::base::Result<std::size_t> WriteTo(std::shared_ptr<gocxx::io::Writer> w) override;
+
+        // ReaderFrom interface: the kernel path when r is a file, socket or pipe
+        gocxx::base::Result<std::size_t> ReadFrom(std::shared_ptr<gocxx::io::Reader> r) override;
+
+        // BuffersWriter interface: writev
+        gocxx::base::Result<std::size_t> WriteBuffers(const gocxx::io::Buffers& bufs) override;
+
+        // BuffersReader interface: readv; {0, nullptr} at end of file, like Read
+        gocxx::base::Result<std::size_t> ReadBuffers(const gocxx::io::MutableBuffers& bufs) override;
+
         // File-specific methods
         gocxx::base::Result<void> Chdir();
 
@@ -196,7 +221,7 @@ namespace gocxx::os {
 
         // Getters
         std::string Name() const { return name; }
-        int Fd() const { return fd; }
+        int Fd() const override { return fd; }
         bool IsClosed() const { return closed; }
     };
 
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gocxx/errors/errors.h>
+#include <gocxx/base/result.h>
+#include <gocxx/io/io.h>
+#include <gocxx/os/file.h>
+
+namespace gocxx::os {
+
+    enum class MapMode {
+        ReadOnly,   // PROT_READ, shared
+        ReadWrite,  // PROT_READ | PROT_WRITE, shared: stores reach the file
+    };
+
+    // Access pattern hints passed to madvise
+    enum class MapAdvice {
+        Normal,
+        Sequential,  // aggressive read-ahead, pages freed behind the reader
+        Random,      // no read-ahead
+        WillNeed,    // start reading the pages in now
+        DontNeed,    // the pages can be dropped
+    };
+
+    // Files at least this large are mapped by ReadFileMapped instead of read.
+    constexpr std::size_t kDefaultMapThreshold = 1 << 20;
+
+    // MappedFile is a whole file mapped into memory. Its size is fixed at the
+    // size the file had when it was mapped; the mapping stays valid after the
+    // file it came from is closed.
+    class MappedFile : public gocxx::io::ReaderAt,
+                       public gocxx::io::WriterAt {
+    public:
+        MappedFile(uint8_t* data, std::size_t size, MapMode mode, std::string name);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // ReaderAt interface: copies out of the mapping; io::ErrEOF when the
+        // range runs past the end
+        gocxx::base::Result<std::size_t> ReadAt(uint8_t* buffer, std::size_t size, std::size_t offset) override;
+
+        // WriterAt interface: ReadWrite mappings only, and never beyond Size()
+        gocxx::base::Result<std::size_t> WriteAt(const uint8_t* buffer, std::size_t size, std::size_t offset) override;
+
+        // Direct access to the mapped bytes
+        const uint8_t* Data() const { return data_; }
+        uint8_t* MutableData() { return mode_ == MapMode::ReadWrite ? data_ : nullptr; }
+        std::size_t Size() const { return size_; }
+        gocxx::io::Span Bytes() const { return {data_, size_}; }
+        std::string_view View() const { return {reinterpret_cast<const char*>(data_), size_}; }
+
+        // Advise tells the kernel how the mapping will be accessed
+        gocxx::base::Result<void> Advise(MapAdvice advice);
+        gocxx::base::Result<void> Advise(MapAdvice advice, std::size_t offset, std::size_t length);
+
+        // Sync flushes modified pages of a ReadWrite mapping to the file (msync)
+        gocxx::base::Result<void> Sync();
+
+        // Close unmaps the file; Data() is invalid afterwards
+        gocxx::base::Result<void> Close();
+
+        MapMode Mode() const { return mode_; }
+        std::string Name() const { return name_; }
+        bool IsClosed() const { return closed_; }
+
+    private:
+        uint8_t* data_;
+        std::size_t size_;
+        MapMode mode_;
+        std::string name_;
+        bool closed_ = false;
+    };
+
+    // MapFile maps the whole named file
+    gocxx::base::Result<std::shared_ptr<MappedFile>> MapFile(const std::string& name, MapMode mode = MapMode::ReadOnly);
+
+    // MapFile maps the whole of an open file; f must be open for reading, and
+    // for writing too with MapMode::ReadWrite
+    gocxx::base::Result<std::shared_ptr<MappedFile>> MapFile(File& f, MapMode mode = MapMode::ReadOnly);
+
+    // FileContents holds a whole file, either mapped or read into the heap
+    class FileContents {
+    public:
+        FileContents() = default;
+        explicit FileContents(std::vector<uint8_t> data) : heap_(std::move(data)) {}
+        explicit FileContents(std::shared_ptr<MappedFile> mapped) : mapped_(std::move(mapped)) {}
+
+        const uint8_t* Data() const { return mapped_ ? mapped_->Data() : heap_.data(); }
+        std::size_t Size() const { return mapped_ ? mapped_->Size() : heap_.size(); }
+        gocxx::io::Span Bytes() const { return {Data(), Size()}; }
+        std::string_view View() const { return {reinterpret_cast<const char*>(Data()), Size()}; }
+        bool Mapped() const { return mapped_ != nullptr; }
+
+    private:
+        std::vector<uint8_t> heap_;
+        std::shared_ptr<MappedFile> mapped_;
+    };
+
+    // ReadFileMapped returns the contents of the named file, mapped read-only
+    // with a sequential hint when it is at least threshold bytes, otherwise
+    // read with ReadFile
+    gocxx::base::Result<FileContents> ReadFileMapped(const std::string& name,
+                                                     std::size_t threshold = kDefaultMapThreshold);
+
+} // namespace gocxx::os
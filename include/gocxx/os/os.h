@@ -172,6 +172,7 @@ namespace gocxx::os {
         int pid;
         bool exited;
         int exitCode;
+        int signal = 0;  ///< Signal that killed the process when !exited
         std::chrono::system_clock::time_point userTime;
         std::chrono::system_clock::time_point systemTime;
     };
@@ -250,6 +251,9 @@ namespace gocxx::os {
 
     /**
      * Walk directory tree and call walkFn for each file/directory.
+     * Entries are visited in lexical order with Lstat information, root
+     * first; walkFn may return SkipDir or SkipAll. See WalkParallel
+     * (gocxx/os/walk.h) for large trees.
      */
     gocxx::base::Result<void> Walk(
         const std::string& root,
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <gocxx/base/result.h>
+#include <gocxx/context/context.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/os/file.h>
+
+namespace gocxx::os {
+
+    // WalkEntry is one file or directory met by WalkParallel. Its type comes
+    // from the directory listing itself (d_type), so no stat is made unless
+    // the callback asks for Info().
+    class WalkEntry {
+    public:
+        WalkEntry(std::string path, FileMode type)
+            : path_(std::move(path)), type_(type) {}
+
+        // Path is the root joined with the names leading to this entry
+        const std::string& Path() const { return path_; }
+        std::string Name() const { return path_.substr(path_.find_last_of("/\\") + 1); }
+
+        bool IsDir() const { return (type_ & ModeDir) != 0; }
+
+        // Type holds the type bits only (ModeDir, ModeSymlink, ...); 0 for a
+        // regular file
+        FileMode Type() const { return type_; }
+
+        // Info lstats the entry on first use and caches the result
+        gocxx::base::Result<FileInfo> Info() const {
+            if (!info_) info_ = Lstat(path_);
+            return *info_;
+        }
+
+    private:
+        std::string path_;
+        FileMode type_;
+        mutable std::optional<gocxx::base::Result<FileInfo>> info_;
+    };
+
+    // WalkDirFunc is called once per entry. err is set, on a second call for
+    // the same directory, when the directory could not be read; returning
+    // nil then carries on with the rest of the tree.
+    using WalkDirFunc = std::function<gocxx::base::Result<void>(const WalkEntry& entry,
+                                                                std::shared_ptr<gocxx::errors::Error> err)>;
+
+    // Directory entries requested from the kernel per getdents64 call
+    // (the listing buffer is 32 bytes per entry).
+    constexpr std::size_t kWalkBatchEntries = 2048;
+
+    // WalkParallel walks the tree rooted at root on `workers` threads (0: the
+    // number of CPUs). Each worker lists directories from its own queue,
+    // depth first, and steals from the others when it runs dry; listings are
+    // read in large getdents64 batches on Linux. Symbolic links are reported
+    // but not followed.
+    //
+    // fn runs concurrently on several threads and must be thread-safe. A
+    // directory is reported before anything inside it; beyond that there is
+    // no order. Returning SkipDir from a directory skips its contents, and
+    // from a file skips the remaining entries of its directory; SkipAll
+    // stops the walk and returns nil. Any other error stops the walk and is
+    // returned, as is ctx->Err() when ctx is cancelled first. Workers stop
+    // at the next entry once either happens.
+    gocxx::base::Result<void> WalkParallel(context::ContextPtr ctx, const std::string& root,
+                                           std::size_t workers, WalkDirFunc fn);
+
+    gocxx::base::Result<void> WalkParallel(const std::string& root, std::size_t workers, WalkDirFunc fn);
+
+} // namespace gocxx::os
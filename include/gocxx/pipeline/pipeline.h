@@ -0,0 +1,266 @@
+/**
+ * @file pipeline.h
+ * @brief Channel pipeline stages: fan-out, fan-in, parallel map and batching
+ *
+ * Each stage reads from its input channel on tasks started with gocxx::go(),
+ * closes its output once the input is closed and drained, and stops early
+ * when the Context passed to it is cancelled (the output is closed then
+ * too, possibly before everything was delivered). Stage functions are
+ * copied into every worker and must not throw.
+ *
+ * @example
+ * ```cpp
+ * using namespace gocxx;
+ * auto ctx = context::Background();
+ * base::Chan<std::string> paths = listFiles();
+ * auto sizes = pipeline::ParallelMap(ctx, paths, 8, [](std::string p) { return fileSize(p); });
+ * for (auto batch = pipeline::Batch(ctx, sizes, 100, time::Milliseconds(50)); auto b = batch.recv();) {
+ *     store(*b);
+ * }
+ * ```
+ */
+
+// gocxx/pipeline/pipeline.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <gocxx/base/chan.h>
+#include <gocxx/base/select.h>
+#include <gocxx/context/context.h>
+#include <gocxx/runtime/runtime.h>
+#include <gocxx/time/duration.h>
+#include <gocxx/time/timer.h>
+
+namespace gocxx::pipeline {
+
+    namespace detail {
+
+        /// Receive from @p in unless @p done closes first; nullopt means stop.
+        template<typename T>
+        std::optional<T> recv(base::Chan<bool>& done, base::Chan<T>& in) {
+            if (done.isClosed()) return std::nullopt;
+            std::optional<T> got;
+            base::select(base::recvCase(done, [](std::optional<bool>) {}),
+                         base::recvCase(in, [&](std::optional<T> v) { got = std::move(v); }));
+            return got;
+        }
+
+        /// Send @p value on @p out unless @p done closes first; false means stop.
+        template<typename T>
+        bool send(base::Chan<bool>& done, base::Chan<T>& out, T value) {
+            if (done.isClosed()) return false;
+            bool sent = false;
+            base::select(base::recvCase(done, [](std::optional<bool>) {}),
+                         base::sendCase(out, std::move(value), [&](bool ok) { sent = ok; }));
+            return sent;
+        }
+
+        /// Closes a shared output once the last of its writers has finished.
+        template<typename T>
+        class Closer {
+        public:
+            Closer(base::Chan<T> out, std::size_t writers)
+                : out_(std::move(out)), remaining_(writers) {}
+
+            void done() {
+                if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) out_.close();
+            }
+
+        private:
+            base::Chan<T> out_;
+            std::atomic<std::size_t> remaining_;
+        };
+
+        // n workers applying fn to values of in and sending results to out.
+        template<typename T, typename U, typename F>
+        void startWorkers(const context::ContextPtr& ctx, base::Chan<T> in, std::size_t n,
+                          F fn, base::Chan<U> out) {
+            auto closer = std::make_shared<Closer<U>>(out, n);
+            for (std::size_t i = 0; i < n; ++i) {
+                gocxx::go([ctx, in, out, fn, closer]() mutable {
+                    auto done = ctx->Done();
+                    while (auto v = detail::recv(done, in)) {
+                        if (!detail::send(done, out, U(fn(std::move(*v))))) break;
+                    }
+                    closer->done();
+                });
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Start @p n workers that each apply @p fn to values taken from @p in.
+     *
+     * Every worker sends its results to its own channel, which it closes
+     * when @p in is exhausted; combine them with Merge() if a single stream
+     * is wanted.
+     */
+    template<typename T, typename F, typename U = std::decay_t<std::invoke_result_t<F&, T>>>
+    std::vector<base::Chan<U>> FanOut(context::ContextPtr ctx, base::Chan<T> in, std::size_t n, F fn) {
+        std::vector<base::Chan<U>> outs;
+        outs.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            base::Chan<U> out(1);
+            outs.push_back(out);
+            detail::startWorkers(ctx, in, 1, fn, out);
+        }
+        return outs;
+    }
+
+    /**
+     * @brief Forward every value of @p ins onto one channel, closed when all inputs are.
+     *
+     * Values from one input keep their relative order; no order is implied
+     * between inputs.
+     */
+    template<typename T>
+    base::Chan<T> Merge(context::ContextPtr ctx, std::vector<base::Chan<T>> ins) {
+        base::Chan<T> out(ins.size());
+        if (ins.empty()) {
+            out.close();
+            return out;
+        }
+        auto closer = std::make_shared<detail::Closer<T>>(out, ins.size());
+        for (auto& in : ins) {
+            gocxx::go([ctx, in, out, closer]() mutable {
+                auto done = ctx->Done();
+                while (auto v = detail::recv(done, in)) {
+                    if (!detail::send(done, out, std::move(*v))) break;
+                }
+                closer->done();
+            });
+        }
+        return out;
+    }
+
+    /// Variadic form of Merge(): `Merge(ctx, a, b, c)`.
+    template<typename T, typename... Rest>
+    base::Chan<T> Merge(context::ContextPtr ctx, base::Chan<T> first, Rest... rest) {
+        return Merge(std::move(ctx), std::vector<base::Chan<T>>{std::move(first), std::move(rest)...});
+    }
+
+    /**
+     * @brief Apply @p fn to every value of @p in on @p workers parallel tasks.
+     *
+     * Unordered results are emitted as soon as they are ready. Ordered
+     * results are emitted in input order using a reorder window of @p window
+     * values (default: four per worker): a slow value only holds back the
+     * ones behind it once the window fills up, and memory stays bounded.
+     */
+    template<typename T, typename F, typename U = std::decay_t<std::invoke_result_t<F&, T>>>
+    base::Chan<U> ParallelMap(context::ContextPtr ctx, base::Chan<T> in, std::size_t workers, F fn,
+                              bool ordered = true, std::size_t window = 0) {
+        if (workers == 0) workers = 1;
+        base::Chan<U> out(workers);
+        if (!ordered) {
+            detail::startWorkers(ctx, in, workers, fn, out);
+            return out;
+        }
+        if (window == 0) window = 4 * workers;
+
+        using Job = std::pair<std::size_t, T>;
+        using Done = std::pair<std::size_t, U>;
+        base::Chan<Job> jobs(workers);
+        base::Chan<Done> results(workers);
+        // One token per value between dispatch and emission bounds the window.
+        base::Chan<bool> tokens(window);
+
+        gocxx::go([ctx, in, jobs, tokens]() mutable {
+            auto done = ctx->Done();
+            std::size_t seq = 0;
+            while (auto v = detail::recv(done, in)) {
+                if (!detail::send(done, tokens, true)) break;
+                if (!detail::send(done, jobs, Job(seq++, std::move(*v)))) break;
+            }
+            jobs.close();
+        });
+
+        detail::startWorkers(ctx, jobs, workers,
+                             [fn](Job job) mutable { return Done(job.first, fn(std::move(job.second))); },
+                             results);
+
+        gocxx::go([ctx, results, tokens, out, window]() mutable {
+            auto done = ctx->Done();
+            std::vector<std::optional<U>> slots(window);
+            std::size_t next = 0;
+            bool stopped = false;
+            while (!stopped) {
+                auto r = detail::recv(done, results);
+                if (!r) break;
+                slots[r->first % window].emplace(std::move(r->second));
+                for (auto* slot = &slots[next % window]; *slot; slot = &slots[next % window]) {
+                    if (!detail::send(done, out, std::move(**slot))) {
+                        stopped = true;
+                        break;
+                    }
+                    slot->reset();
+                    ++next;
+                    tokens.tryRecv();
+                }
+            }
+            out.close();
+        });
+        return out;
+    }
+
+    /**
+     * @brief Group values of @p in into vectors of at most @p size elements.
+     *
+     * A batch is emitted when it is full or @p maxDelay after its first value
+     * arrived, whichever comes first; values already buffered in @p in are
+     * taken without starting the timer. A partial batch is flushed when
+     * @p in closes, but dropped on cancellation.
+     */
+    template<typename T>
+    base::Chan<std::vector<T>> Batch(context::ContextPtr ctx, base::Chan<T> in, std::size_t size,
+                                     gocxx::time::Duration maxDelay) {
+        if (size == 0) size = 1;
+        base::Chan<std::vector<T>> out(1);
+        gocxx::go([ctx, in, out, size, maxDelay]() mutable {
+            auto done = ctx->Done();
+            bool inOpen = true;
+            bool cancelled = false;
+            while (inOpen && !cancelled) {
+                auto first = detail::recv(done, in);
+                if (!first) break;
+                std::vector<T> batch;
+                batch.reserve(size);
+                batch.push_back(std::move(*first));
+                while (batch.size() < size) {
+                    auto r = in.tryRecv();
+                    if (!r.Ok()) break;
+                    batch.push_back(std::move(r.value));
+                }
+
+                if (batch.size() < size && maxDelay.Nanoseconds() > 0) {
+                    auto timer = gocxx::time::NewTimer(maxDelay);
+                    auto fired = timer->C();
+                    bool expired = false;
+                    while (batch.size() < size && inOpen && !expired && !cancelled) {
+                        base::select(
+                            base::recvCase(done, [&](std::optional<bool>) { cancelled = true; }),
+                            base::recvCase(in, [&](std::optional<T> v) {
+                                if (v) batch.push_back(std::move(*v));
+                                else inOpen = false;
+                            }),
+                            base::recvCase(*fired, [&](std::optional<gocxx::time::Time>) { expired = true; }));
+                    }
+                    timer->Stop();
+                }
+
+                if (cancelled || !detail::send(done, out, std::move(batch))) {
+                    cancelled = true;
+                }
+            }
+            out.close();
+        });
+        return out;
+    }
+
+} // namespace gocxx::pipeline
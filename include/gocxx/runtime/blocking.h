@@ -0,0 +1,97 @@
+/**
+ * @file blocking.h
+ * @brief Hook that lets blocking primitives release their runtime worker
+ *
+ * Channels, WaitGroup, Sleep and socket calls wrap the part of their wait
+ * that actually sleeps in a BlockingRegion. When the calling thread is a
+ * runtime worker, its processor slot is handed to another worker for the
+ * duration, exactly like Go's entersyscall/exitsyscall, so a task parked on
+ * a channel never stops the remaining tasks from running. On any other
+ * thread the region only notes what the thread is waiting for.
+ *
+ * Every region also records a WaitReason and when the wait began, which
+ * runtime::Threads() reports for each thread (the equivalent of the
+ * "[chan receive, 3 minutes]" in a Go goroutine dump).
+ */
+
+// gocxx/runtime/blocking.h
+#pragma once
+#include <cstdint>
+
+namespace gocxx::runtime {
+
+    /**
+     * @brief What a thread is blocked on, as reported by Threads().
+     */
+    enum class WaitReason : std::uint8_t {
+        None,       ///< Not waiting
+        Unknown,
+        ChanSend,
+        ChanRecv,
+        Select,
+        Mutex,      ///< A contended ProfiledMutex
+        WaitGroup,  ///< WaitGroup, errgroup and joins of helper threads
+        Sleep,
+        IO,         ///< Sockets, pipes and asynchronous file I/O
+        Syscall,    ///< Other blocking system calls (getaddrinfo, sendfile)
+        Coroutine,  ///< Waiting for a coroutine task or executor
+        Idle,       ///< A runtime worker with nothing to run
+    };
+
+    /// Human-readable name of @p reason, in the register of Go's goroutine dump ("chan receive").
+    const char* WaitReasonName(WaitReason reason) noexcept;
+
+    namespace detail {
+        /// Non-null while the current thread is a runtime worker.
+        bool onWorkerThread() noexcept;
+        void enterBlocking() noexcept;
+        void exitBlocking() noexcept;
+        /// Marks the current thread as waiting for @p reason; returns the previous reason.
+        WaitReason beginWait(WaitReason reason) noexcept;
+        void endWait(WaitReason previous) noexcept;
+    } // namespace detail
+
+    /**
+     * @brief RAII note that the current thread waits for @p reason, without a handoff.
+     *
+     * For waits that are short or that the runtime need not work around,
+     * such as a contended mutex. Scopes nest; the outer reason is restored.
+     */
+    class WaitScope {
+    public:
+        explicit WaitScope(WaitReason reason) noexcept : previous_(detail::beginWait(reason)) {}
+        ~WaitScope() { detail::endWait(previous_); }
+
+        WaitScope(const WaitScope&) = delete;
+        WaitScope& operator=(const WaitScope&) = delete;
+
+    private:
+        WaitReason previous_;
+    };
+
+    /**
+     * @brief RAII marker around a wait that may sleep in the kernel.
+     *
+     * Must not be nested; it is cheap enough to construct right before a
+     * condition-variable wait or a blocking system call.
+     */
+    class BlockingRegion {
+    public:
+        explicit BlockingRegion(WaitReason reason = WaitReason::Unknown) noexcept
+            : active_(detail::onWorkerThread()), wait_(reason) {
+            if (active_) detail::enterBlocking();
+        }
+
+        ~BlockingRegion() {
+            if (active_) detail::exitBlocking();
+        }
+
+        BlockingRegion(const BlockingRegion&) = delete;
+        BlockingRegion& operator=(const BlockingRegion&) = delete;
+
+    private:
+        bool active_;
+        WaitScope wait_;
+    };
+
+} // namespace gocxx::runtime
@@ -0,0 +1,144 @@
+/**
+ * @file deque.h
+ * @brief Chase-Lev work-stealing deque
+ *
+ * The owning worker pushes and pops at the bottom without any atomic
+ * read-modify-write on the common path; thieves take from the top with a
+ * single CAS. Memory orderings follow Lê, Pop, Cohen and Zappa Nardelli,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP'13).
+ */
+
+// gocxx/runtime/deque.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <gocxx/base/detail/ring_buffer.h>
+
+namespace gocxx::runtime {
+
+    /**
+     * @brief Growable single-owner, multi-thief deque of trivially copyable items.
+     *
+     * push() and pop() may only be called by the owner; steal() may be called
+     * from any thread. Arrays replaced by a grow are kept until the deque is
+     * destroyed, because a thief may still be reading from them.
+     */
+    template<typename T>
+    class WorkStealingDeque {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "WorkStealingDeque stores items in atomics; use pointers or handles");
+
+    public:
+        explicit WorkStealingDeque(std::size_t initialCapacity = 256) {
+            std::size_t cap = 1;
+            while (cap < initialCapacity) cap <<= 1;
+            auto a = std::make_unique<Array>(cap);
+            array_.store(a.get(), std::memory_order_relaxed);
+            arrays_.push_back(std::move(a));
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        /// Owner only: push @p item at the bottom, growing if full.
+        void push(T item) {
+            std::int64_t b = bottom_.load(std::memory_order_relaxed);
+            std::int64_t t = top_.load(std::memory_order_acquire);
+            Array* a = array_.load(std::memory_order_relaxed);
+            if (b - t > static_cast<std::int64_t>(a->capacity) - 1) {
+                a = grow(a, t, b);
+            }
+            a->put(b, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+
+        /// Owner only: take the most recently pushed item.
+        bool pop(T& out) {
+            std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            Array* a = array_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t t = top_.load(std::memory_order_relaxed);
+            if (t > b) {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            out = a->get(b);
+            if (t == b) {
+                // Last item: race the thieves for it.
+                bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed);
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Any thread: take the oldest item.
+         * @return false if the deque was empty or another thread won the race
+         */
+        bool steal(T& out) {
+            std::int64_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t b = bottom_.load(std::memory_order_acquire);
+            if (t >= b) return false;
+            Array* a = array_.load(std::memory_order_acquire);
+            T item = a->get(t);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                return false;
+            }
+            out = item;
+            return true;
+        }
+
+        /// Approximate number of items (exact when quiescent).
+        std::size_t sizeApprox() const {
+            std::int64_t b = bottom_.load(std::memory_order_acquire);
+            std::int64_t t = top_.load(std::memory_order_acquire);
+            return b > t ? static_cast<std::size_t>(b - t) : 0;
+        }
+
+        bool emptyApprox() const { return sizeApprox() == 0; }
+
+    private:
+        struct Array {
+            explicit Array(std::size_t cap)
+                : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+            T get(std::int64_t i) const {
+                return slots[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed);
+            }
+            void put(std::int64_t i, T v) {
+                slots[static_cast<std::size_t>(i) & mask].store(v, std::memory_order_relaxed);
+            }
+
+            std::size_t capacity;
+            std::size_t mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+        };
+
+        Array* grow(Array* old, std::int64_t t, std::int64_t b) {
+            auto bigger = std::make_unique<Array>(old->capacity * 2);
+            for (std::int64_t i = t; i < b; ++i) {
+                bigger->put(i, old->get(i));
+            }
+            Array* raw = bigger.get();
+            arrays_.push_back(std::move(bigger));
+            array_.store(raw, std::memory_order_release);
+            return raw;
+        }
+
+        alignas(base::detail::kCacheLineSize) std::atomic<std::int64_t> top_{0};
+        alignas(base::detail::kCacheLineSize) std::atomic<std::int64_t> bottom_{0};
+        alignas(base::detail::kCacheLineSize) std::atomic<Array*> array_{nullptr};
+        std::vector<std::unique_ptr<Array>> arrays_;  // owner only
+    };
+
+} // namespace gocxx::runtime
@@ -0,0 +1,120 @@
+/**
+ * @file runtime.h
+ * @brief M:N task runtime with work-stealing workers and the go() launcher
+ *
+ * Tasks started with gocxx::go() are multiplexed onto a fixed number of
+ * processors (GOMAXPROCS, one per hardware thread by default). Each
+ * processor owns a Chase-Lev deque: a worker runs its own tasks LIFO for
+ * cache locality, falls back to a global FIFO queue, and finally steals the
+ * oldest task from a random peer before going to sleep.
+ *
+ * Tasks run to completion on the worker that picked them up. When a task
+ * blocks inside a runtime-aware primitive (channel operation, select,
+ * WaitGroup::Wait, time::Sleep, socket I/O) the worker gives its processor
+ * to a spare thread until the wait ends, so blocked tasks never starve
+ * runnable ones and only tasks that are blocked at the same moment hold an
+ * OS thread of their own.
+ *
+ * @example
+ * ```cpp
+ * gocxx::sync::WaitGroup wg;
+ * wg.Add(1000);
+ * for (int i = 0; i < 1000; ++i) {
+ *     gocxx::go([&wg] { work(); wg.Done(); });
+ * }
+ * wg.Wait();
+ * ```
+ */
+
+// gocxx/runtime/runtime.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <gocxx/runtime/blocking.h>
+
+namespace gocxx {
+
+    namespace runtime {
+
+        /**
+         * @brief Point-in-time view of the scheduler.
+         */
+        struct SchedulerStats {
+            int processors = 0;            ///< GOMAXPROCS
+            int threads = 0;               ///< Worker OS threads started and still alive
+            int idleThreads = 0;           ///< Workers parked waiting for work
+            int blockedThreads = 0;        ///< Workers inside a BlockingRegion
+            std::int64_t liveTasks = 0;    ///< Tasks queued or running
+            std::uint64_t spawned = 0;     ///< Tasks started since process start
+            std::uint64_t stolen = 0;      ///< Tasks taken from another processor's deque
+            std::uint64_t handoffs = 0;    ///< Processors handed over because of a blocking wait
+        };
+
+        /**
+         * @brief One thread seen by the runtime, as listed by Threads().
+         *
+         * Threads are tracked from the first time they run a task or wait
+         * inside a BlockingRegion or WaitScope until they exit.
+         */
+        struct ThreadInfo {
+            std::uint64_t id = 0;                 ///< Sequential, in order of first appearance
+            bool worker = false;                  ///< A runtime worker (an M)
+            std::uint64_t task = 0;               ///< Task the worker is running; 0 for none
+            WaitReason waitReason = WaitReason::None;
+            std::int64_t waitingNs = 0;           ///< How long the current wait has lasted
+        };
+
+        /**
+         * @brief Set the number of processors executing tasks simultaneously.
+         *
+         * Like Go's runtime.GOMAXPROCS: @p n < 1 only queries. The value can
+         * be changed until the first task is started; afterwards the call only
+         * reports the current setting.
+         *
+         * @return The previous setting
+         */
+        int GOMAXPROCS(int n = 0);
+
+        /// Number of tasks that are queued or running.
+        std::int64_t NumGoroutine();
+
+        /// Hint that the current task is willing to let others run.
+        void Gosched();
+
+        /// Snapshot of scheduler counters.
+        SchedulerStats Stats();
+
+        /// Every tracked thread with what it is doing right now, workers first.
+        std::vector<ThreadInfo> Threads();
+
+        namespace detail {
+            void spawn(std::function<void()> fn);
+        } // namespace detail
+
+    } // namespace runtime
+
+    /**
+     * @brief Run @p fn asynchronously on the runtime's worker pool.
+     *
+     * Exceptions escaping @p fn terminate the process, as an unrecovered
+     * panic in a goroutine would.
+     */
+    inline void go(std::function<void()> fn) {
+        runtime::detail::spawn(std::move(fn));
+    }
+
+    /// Run @p fn(args...) asynchronously; arguments are captured by value.
+    template<typename F, typename A0, typename... Args>
+    void go(F&& fn, A0&& a0, Args&&... args) {
+        runtime::detail::spawn(
+            [f = std::forward<F>(fn),
+             tup = std::make_tuple(std::forward<A0>(a0), std::forward<Args>(args)...)]() mutable {
+                std::apply(f, tup);
+            });
+    }
+
+} // namespace gocxx
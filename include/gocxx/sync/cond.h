@@ -1,8 +1,9 @@
 #pragma once
-#include <mutex>
-#include <condition_variable>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include "mutex.h"
+#include "detail/futex.h"
 
 
 namespace gocxx::sync {
@@ -11,10 +12,13 @@ namespace gocxx::sync {
  * @brief A condition variable, similar to Go's sync.Cond.
  *
  * Used for signaling between threads that a condition or state has changed.
- * Internally wraps a `std::condition_variable`.
+ * Waiting threads block on a futex sequence word; NotifyOne()/NotifyAll()
+ * are a single atomic load when nobody is waiting, which is the common case
+ * for the channel implementations that signal after every operation.
  */
 class Cond {
-    std::condition_variable cv_;
+    std::atomic<std::uint32_t> seq_{0};
+    std::atomic<std::uint32_t> waiters_{0};
 
 public:
     /**
@@ -22,25 +26,36 @@ public:
      *
      * The thread must hold a `std::unique_lock<std::mutex>` before calling this.
      * It will release the lock while waiting and re-acquire it upon wake-up.
+     * Like any condition variable it may wake spuriously; re-check the
+     * condition in a loop.
      *
      * @param lock A unique lock that is held before calling wait.
      */
     void Wait(UniqueLock& mtx) {
-        cv_.wait(mtx);
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        const std::uint32_t seq = seq_.load(std::memory_order_seq_cst);
+        mtx.unlock();
+        detail::futexWait(seq_, seq);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        mtx.lock();
     }
 
     /**
      * @brief Wakes one thread that is waiting on this condition variable.
      */
     void NotifyOne() {
-        cv_.notify_one();
+        if (waiters_.load(std::memory_order_seq_cst) == 0) return;
+        seq_.fetch_add(1, std::memory_order_seq_cst);
+        detail::futexWake(seq_, 1);
     }
 
     /**
      * @brief Wakes all threads waiting on this condition variable.
      */
     void NotifyAll() {
-        cv_.notify_all();
+        if (waiters_.load(std::memory_order_seq_cst) == 0) return;
+        seq_.fetch_add(1, std::memory_order_seq_cst);
+        detail::futexWakeAll(seq_);
     }
 };
 
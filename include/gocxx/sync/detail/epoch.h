@@ -0,0 +1,168 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gocxx::sync::detail {
+
+/**
+ * @brief Process-wide epoch-based reclamation for lock-free readers.
+ *
+ * Readers announce the current epoch in a slot only their thread writes
+ * and leave it when done; nothing shared is written on the read path.
+ * Writers retire unlinked objects into a thread-local list tagged with the
+ * epoch; an object is freed once the global epoch has moved two steps past
+ * its tag, which can only happen after every reader that might still see
+ * it has left.
+ */
+class EpochDomain {
+public:
+    using Deleter = void (*)(void*);
+
+    static EpochDomain& instance() {
+        static EpochDomain* domain = new EpochDomain();
+        return *domain;
+    }
+
+    /// Free @p ptr with @p deleter once no reader can still hold it.
+    void retire(void* ptr, Deleter deleter) {
+        ThreadRecord& rec = local();
+        rec.retired.push_back({ptr, deleter, global_.load(std::memory_order_acquire)});
+        if (rec.retired.size() >= kCollectThreshold) collect(rec);
+    }
+
+    template<typename T>
+    void retire(T* ptr) {
+        retire(static_cast<void*>(const_cast<std::remove_const_t<T>*>(ptr)),
+               [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    /// Free whatever the calling thread retired that is already safe to free.
+    void collect() { collect(local()); }
+
+private:
+    static constexpr std::size_t kCollectThreshold = 64;
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch{0};  // 0: not reading
+        std::atomic<bool> inUse{false};
+        Slot* next = nullptr;
+    };
+
+    struct Retired {
+        void* ptr;
+        Deleter deleter;
+        std::uint64_t epoch;
+    };
+
+    struct ThreadRecord {
+        Slot* slot = nullptr;
+        unsigned nesting = 0;
+        std::vector<Retired> retired;
+
+        ~ThreadRecord() {
+            EpochDomain& d = EpochDomain::instance();
+            if (!retired.empty()) {
+                std::lock_guard<std::mutex> lock(d.orphanMutex_);
+                d.orphans_.insert(d.orphans_.end(), retired.begin(), retired.end());
+                d.hasOrphans_.store(true, std::memory_order_release);
+            }
+            if (slot) slot->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    ThreadRecord& local() {
+        thread_local ThreadRecord rec;
+        if (!rec.slot) rec.slot = acquireSlot();
+        return rec;
+    }
+
+    Slot* acquireSlot() {
+        for (Slot* s = slots_.load(std::memory_order_acquire); s; s = s->next) {
+            bool expected = false;
+            if (!s->inUse.load(std::memory_order_relaxed) &&
+                s->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                return s;
+            }
+        }
+        Slot* s = new Slot();
+        s->inUse.store(true, std::memory_order_relaxed);
+        Slot* head = slots_.load(std::memory_order_relaxed);
+        do {
+            s->next = head;
+        } while (!slots_.compare_exchange_weak(head, s, std::memory_order_acq_rel));
+        return s;
+    }
+
+public:
+    /// RAII read-side critical section; nests.
+    class Guard {
+    public:
+        Guard() : rec_(EpochDomain::instance().local()) {
+            if (rec_.nesting++ == 0) {
+                auto& global = EpochDomain::instance().global_;
+                std::uint64_t e = global.load(std::memory_order_acquire);
+                for (;;) {
+                    rec_.slot->epoch.store(e, std::memory_order_seq_cst);
+                    std::uint64_t now = global.load(std::memory_order_seq_cst);
+                    if (now == e) break;
+                    e = now;
+                }
+            }
+        }
+
+        ~Guard() {
+            if (--rec_.nesting == 0) rec_.slot->epoch.store(0, std::memory_order_release);
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        ThreadRecord& rec_;
+    };
+
+private:
+    // Advance the global epoch if every active reader has seen the current one.
+    void tryAdvance() {
+        std::uint64_t e = global_.load(std::memory_order_seq_cst);
+        for (Slot* s = slots_.load(std::memory_order_acquire); s; s = s->next) {
+            std::uint64_t v = s->epoch.load(std::memory_order_seq_cst);
+            if (v != 0 && v != e) return;
+        }
+        global_.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+    }
+
+    // Deleters may retire more objects, so the list is detached while walking it.
+    static void freeEligible(std::vector<Retired>& list, std::uint64_t global) {
+        std::vector<Retired> pending;
+        pending.swap(list);
+        std::vector<Retired> kept;
+        for (auto& r : pending) {
+            if (r.epoch + 2 <= global) r.deleter(r.ptr);
+            else kept.push_back(r);
+        }
+        list.insert(list.end(), kept.begin(), kept.end());
+    }
+
+    void collect(ThreadRecord& rec) {
+        tryAdvance();
+        freeEligible(rec.retired, global_.load(std::memory_order_acquire));
+        if (hasOrphans_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(orphanMutex_);
+            freeEligible(orphans_, global_.load(std::memory_order_acquire));
+            hasOrphans_.store(!orphans_.empty(), std::memory_order_release);
+        }
+    }
+
+    alignas(64) std::atomic<std::uint64_t> global_{1};
+    std::atomic<Slot*> slots_{nullptr};
+    std::mutex orphanMutex_;
+    std::vector<Retired> orphans_;
+    std::atomic<bool> hasOrphans_{false};
+};
+
+} // namespace gocxx::sync::detail
@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace gocxx::sync::detail {
+
+/**
+ * @brief Block while @p word still holds @p expected (may wake spuriously).
+ *
+ * Backed by futex(2) on Linux and WaitOnAddress on Windows; elsewhere by a
+ * small table of mutex/condition pairs keyed by address. Callers re-check
+ * their condition in a loop.
+ */
+void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected);
+
+/// Wake up to @p count threads blocked in futexWait() on @p word.
+void futexWake(std::atomic<std::uint32_t>& word, int count);
+
+/// Wake every thread blocked in futexWait() on @p word.
+void futexWakeAll(std::atomic<std::uint32_t>& word);
+
+#if defined(__linux__)
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "futex word must be a plain 32-bit integer");
+
+inline void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected,
+            nullptr, nullptr, 0);
+}
+
+inline void futexWake(std::atomic<std::uint32_t>& word, int count) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count,
+            nullptr, nullptr, 0);
+}
+
+inline void futexWakeAll(std::atomic<std::uint32_t>& word) {
+    futexWake(word, INT_MAX);
+}
+
+#elif defined(_WIN32)
+
+#if defined(_MSC_VER)
+#pragma comment(lib, "Synchronization.lib")
+#endif
+
+inline void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+    WaitOnAddress(&word, &expected, sizeof(expected), INFINITE);
+}
+
+inline void futexWake(std::atomic<std::uint32_t>& word, int count) {
+    for (int i = 0; i < count; ++i) WakeByAddressSingle(&word);
+}
+
+inline void futexWakeAll(std::atomic<std::uint32_t>& word) {
+    WakeByAddressAll(&word);
+}
+
+#else
+
+struct ParkBucket {
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+inline ParkBucket& parkBucket(const void* addr) {
+    static ParkBucket buckets[64];
+    return buckets[(reinterpret_cast<std::uintptr_t>(addr) >> 4) % 64];
+}
+
+inline void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+    ParkBucket& b = parkBucket(&word);
+    std::unique_lock<std::mutex> lock(b.mtx);
+    if (word.load(std::memory_order_acquire) == expected) b.cv.wait(lock);
+}
+
+inline void futexWake(std::atomic<std::uint32_t>& word, int) {
+    futexWakeAll(word);
+}
+
+inline void futexWakeAll(std::atomic<std::uint32_t>& word) {
+    ParkBucket& b = parkBucket(&word);
+    { std::lock_guard<std::mutex> lock(b.mtx); }
+    b.cv.notify_all();  // buckets are shared, so wake everyone and let them re-check
+}
+
+#endif
+
+} // namespace gocxx::sync::detail
@@ -0,0 +1,154 @@
+#pragma once
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <gocxx/base/result.h>
+#include <gocxx/context/context.h>
+#include <gocxx/runtime/blocking.h>
+#include <gocxx/runtime/runtime.h>
+#include "waitgroup.h"
+
+// Not part of sync.h: chan.h includes sync.h, and this header needs context.h.
+
+namespace gocxx::sync {
+
+/**
+ * @brief Runs a group of subtasks and reports the first error, like Go's `errgroup.Group`.
+ *
+ * Subtasks run on the task runtime (`gocxx::go`), not on dedicated threads.
+ * SetLimit() caps how many run at once; Go() then blocks until a slot frees
+ * up, TryGo() returns false instead. Wait() blocks until every subtask has
+ * returned and yields the first error.
+ *
+ * A group created with WithContext() cancels its context as soon as a
+ * subtask fails and, at the latest, when Wait() returns.
+ *
+ * @code
+ * auto [group, ctx] = ErrGroup::WithContext(context::Background());
+ * group->SetLimit(8);
+ * for (auto& url : urls) {
+ *     group->Go([ctx = ctx, url] { return fetch(ctx, url); });
+ * }
+ * if (auto r = group->Wait(); r.Failed()) { ... }
+ * @endcode
+ */
+class ErrGroup {
+public:
+    ErrGroup() = default;
+
+    ~ErrGroup() = default;
+
+    ErrGroup(const ErrGroup&) = delete;
+    ErrGroup& operator=(const ErrGroup&) = delete;
+
+    /**
+     * @brief Returns a new group and a context derived from @p parent.
+     *
+     * The context is canceled the first time a subtask returns an error or
+     * the first time Wait() returns, whichever occurs first.
+     */
+    static std::pair<std::unique_ptr<ErrGroup>, context::ContextPtr> WithContext(context::ContextPtr parent) {
+        auto group = std::make_unique<ErrGroup>();
+        auto r = context::WithCancel(std::move(parent));
+        group->cancel_ = std::move(r.value.second);
+        return {std::move(group), std::move(r.value.first)};
+    }
+
+    /**
+     * @brief Limit the number of subtasks running at once to @p n.
+     *
+     * A negative value removes the limit. Changing the limit while subtasks
+     * are running throws std::logic_error, as in Go.
+     */
+    void SetLimit(int n) {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (active_ != 0) {
+            throw std::logic_error("errgroup: modify limit while " + std::to_string(active_) +
+                                   " goroutines in the group are still active");
+        }
+        limit_ = n;
+    }
+
+    /**
+     * @brief Run @p fn on the task runtime, blocking while the group is at its limit.
+     *
+     * @param fn Callable returning `base::Result<void>`.
+     */
+    template <typename F>
+    void Go(F&& fn) {
+        {
+            std::unique_lock<std::mutex> lock(mu_);
+            if (limit_ >= 0 && active_ >= limit_) {
+                runtime::BlockingRegion blocking(runtime::WaitReason::WaitGroup);
+                slotFree_.wait(lock, [this] { return limit_ < 0 || active_ < limit_; });
+            }
+            ++active_;
+        }
+        start(std::forward<F>(fn));
+    }
+
+    /**
+     * @brief Run @p fn only if the group is below its limit.
+     *
+     * @return false if no slot was free and @p fn was not started.
+     */
+    template <typename F>
+    bool TryGo(F&& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (limit_ >= 0 && active_ >= limit_) return false;
+            ++active_;
+        }
+        start(std::forward<F>(fn));
+        return true;
+    }
+
+    /**
+     * @brief Block until every subtask has returned.
+     *
+     * @return The first error returned by a subtask, or success.
+     */
+    base::Result<void> Wait() {
+        wg_.Wait();
+        std::lock_guard<std::mutex> lock(mu_);
+        if (cancel_) cancel_();
+        return base::Result<void>(err_);
+    }
+
+private:
+    template <typename F>
+    void start(F&& fn) {
+        wg_.Add(1);
+        gocxx::go([this, fn = std::forward<F>(fn)]() mutable {
+            base::Result<void> r = fn();
+            finish(r.err);
+        });
+    }
+
+    // The WaitGroup is released last: after Done() the group may be destroyed.
+    void finish(std::shared_ptr<errors::Error> err) {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (err && !err_) {
+                err_ = std::move(err);
+                if (cancel_) cancel_();
+            }
+            --active_;
+        }
+        slotFree_.notify_one();
+        wg_.Done();
+    }
+
+    WaitGroup wg_;
+    std::mutex mu_;
+    std::condition_variable slotFree_;
+    int limit_ = -1;
+    int active_ = 0;
+    std::shared_ptr<errors::Error> err_;
+    context::CancelFunc cancel_;
+};
+
+}  // namespace gocxx::sync
@@ -0,0 +1,396 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "detail/epoch.h"
+
+namespace gocxx::sync {
+
+/**
+ * @brief A concurrent map for read-mostly workloads, similar to Go's `sync.Map`.
+ *
+ * Keys found in the read-only snapshot are loaded, overwritten and deleted
+ * with atomic operations on their entry alone. New keys go to a mutex
+ * protected dirty map, which is promoted to the next read-only snapshot
+ * once enough lookups have missed the current one, so a stable key set
+ * quickly ends up entirely on the lock-free path.
+ *
+ * Readers write nothing shared: snapshots and replaced values are freed
+ * through epoch-based reclamation instead of reference counts.
+ *
+ * Best suited, as in Go, to keys written once and read many times, or to
+ * goroutines working on disjoint key sets. Values are copied out by Load().
+ *
+ * @tparam K Key type (hashable with Hash)
+ * @tparam V Value type (copyable; CompareAndSwap also needs operator==)
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class Map {
+    struct Entry {
+        explicit Entry(const V* value) : p(value) {}
+        ~Entry() {
+            const V* v = p.load(std::memory_order_relaxed);
+            if (v && v != expunged()) delete v;
+        }
+        // nullptr: deleted; expunged(): deleted and missing from the dirty map
+        std::atomic<const V*> p;
+    };
+
+    using Table = std::unordered_map<K, Entry*, Hash, KeyEqual>;
+
+    struct ReadOnly {
+        std::shared_ptr<const Table> m;
+        bool amended = false;  // dirty map holds keys missing from m
+    };
+
+    using Guard = detail::EpochDomain::Guard;
+
+public:
+    Map() : read_(new ReadOnly{std::make_shared<const Table>(), false}) {}
+
+    ~Map() {
+        std::unordered_set<Entry*> entries;
+        ReadOnly* read = read_.load(std::memory_order_relaxed);
+        for (const auto& kv : *read->m) entries.insert(kv.second);
+        if (dirty_) {
+            for (const auto& kv : *dirty_) entries.insert(kv.second);
+        }
+        for (Entry* e : entries) delete e;
+        delete read;
+    }
+
+    Map(const Map&) = delete;
+    Map& operator=(const Map&) = delete;
+
+    /**
+     * @brief Returns a copy of the value stored for @p key, if any.
+     */
+    std::optional<V> Load(const K& key) const {
+        Guard guard;
+        Entry* e = findEntry(key);
+        if (!e) return std::nullopt;
+        const V* p = e->p.load(std::memory_order_acquire);
+        if (!live(p)) return std::nullopt;
+        return *p;
+    }
+
+    /**
+     * @brief Sets the value for @p key.
+     */
+    void Store(const K& key, V value) {
+        Guard guard;
+        retireValue(swap(key, new V(std::move(value))));
+    }
+
+    /**
+     * @brief Stores @p value and returns the previous value, if any.
+     */
+    std::optional<V> Swap(const K& key, V value) {
+        Guard guard;
+        const V* old = swap(key, new V(std::move(value)));
+        if (!old) return std::nullopt;
+        std::optional<V> out(*old);
+        retireValue(old);
+        return out;
+    }
+
+    /**
+     * @brief Returns the existing value for @p key if present; otherwise stores @p value.
+     *
+     * @return The value now in the map and true if it was loaded, false if stored.
+     */
+    std::pair<V, bool> LoadOrStore(const K& key, V value) {
+        Guard guard;
+        ReadOnly* read = read_.load(std::memory_order_acquire);
+        auto it = read->m->find(key);
+        if (it != read->m->end()) {
+            if (auto r = tryLoadOrStore(it->second, value)) return std::move(*r);
+        }
+
+        std::lock_guard<std::mutex> lock(mu_);
+        read = read_.load(std::memory_order_acquire);
+        it = read->m->find(key);
+        if (it != read->m->end()) {
+            if (unexpungeLocked(it->second)) (*dirty_)[key] = it->second;
+            return std::move(*tryLoadOrStore(it->second, value));
+        }
+        if (dirty_) {
+            auto dit = dirty_->find(key);
+            if (dit != dirty_->end()) {
+                auto r = tryLoadOrStore(dit->second, value);
+                missLocked();
+                return std::move(*r);
+            }
+        }
+        addLocked(read, key, new V(value));
+        return {std::move(value), false};
+    }
+
+    /**
+     * @brief Deletes @p key, returning its previous value if it had one.
+     */
+    std::optional<V> LoadAndDelete(const K& key) {
+        Guard guard;
+        ReadOnly* read = read_.load(std::memory_order_acquire);
+        Entry* e = nullptr;
+        auto it = read->m->find(key);
+        if (it != read->m->end()) {
+            e = it->second;
+        } else if (read->amended) {
+            std::lock_guard<std::mutex> lock(mu_);
+            read = read_.load(std::memory_order_acquire);
+            it = read->m->find(key);
+            if (it != read->m->end()) {
+                e = it->second;
+            } else if (dirty_) {
+                auto dit = dirty_->find(key);
+                if (dit != dirty_->end()) {
+                    e = dit->second;
+                    dirty_->erase(dit);
+                    // Only reachable through the dirty map, so only by lock holders.
+                    detail::EpochDomain::instance().retire(e);
+                }
+            }
+            missLocked();
+        }
+        if (!e) return std::nullopt;
+
+        const V* p = e->p.load(std::memory_order_acquire);
+        while (live(p)) {
+            if (e->p.compare_exchange_weak(p, nullptr, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                std::optional<V> out(*p);
+                retireValue(p);
+                return out;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Deletes the value for @p key.
+     */
+    void Delete(const K& key) {
+        LoadAndDelete(key);
+    }
+
+    /**
+     * @brief Replaces the value for @p key with @p value if it currently equals @p old.
+     */
+    bool CompareAndSwap(const K& key, const V& old, V value) {
+        Guard guard;
+        Entry* e = findEntry(key);
+        if (!e) return false;
+        const V* p = e->p.load(std::memory_order_acquire);
+        if (!live(p) || !(*p == old)) return false;
+        const V* next = new V(std::move(value));
+        for (;;) {
+            if (e->p.compare_exchange_weak(p, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                retireValue(p);
+                return true;
+            }
+            if (!live(p) || !(*p == old)) {
+                delete next;
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Deletes @p key if its value currently equals @p old.
+     */
+    bool CompareAndDelete(const K& key, const V& old) {
+        Guard guard;
+        Entry* e = findEntry(key);
+        if (!e) return false;
+        const V* p = e->p.load(std::memory_order_acquire);
+        while (live(p) && *p == old) {
+            if (e->p.compare_exchange_weak(p, nullptr, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                retireValue(p);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Calls @p fn(key, value) for each entry until it returns false.
+     *
+     * Like Go's Range this is not a consistent snapshot: entries stored or
+     * deleted concurrently may or may not be visited, but no key is visited
+     * twice. @p fn may call other methods of the map.
+     */
+    template <typename F>
+    void Range(F&& fn) const {
+        Guard guard;
+        ReadOnly* read = read_.load(std::memory_order_acquire);
+        if (read->amended) {
+            // Promote so the walk covers every key and runs without the lock.
+            std::lock_guard<std::mutex> lock(mu_);
+            read = read_.load(std::memory_order_acquire);
+            if (read->amended) {
+                promoteLocked();
+                read = read_.load(std::memory_order_acquire);
+            }
+        }
+        for (const auto& kv : *read->m) {
+            const V* p = kv.second->p.load(std::memory_order_acquire);
+            if (!live(p)) continue;
+            if (!fn(kv.first, *p)) break;
+        }
+    }
+
+private:
+    static const V* expunged() {
+        static const unsigned char tag = 0;
+        return reinterpret_cast<const V*>(&tag);
+    }
+
+    static bool live(const V* p) { return p != nullptr && p != expunged(); }
+
+    static void retireValue(const V* p) {
+        if (live(p)) detail::EpochDomain::instance().retire(p);
+    }
+
+    // Caller holds a Guard. Looks in the snapshot, then in the dirty map.
+    Entry* findEntry(const K& key) const {
+        ReadOnly* read = read_.load(std::memory_order_acquire);
+        auto it = read->m->find(key);
+        if (it != read->m->end()) return it->second;
+        if (!read->amended) return nullptr;
+
+        std::lock_guard<std::mutex> lock(mu_);
+        read = read_.load(std::memory_order_acquire);
+        it = read->m->find(key);
+        if (it != read->m->end()) return it->second;
+        Entry* e = nullptr;
+        if (dirty_) {
+            auto dit = dirty_->find(key);
+            if (dit != dirty_->end()) e = dit->second;
+        }
+        missLocked();
+        return e;
+    }
+
+    // Caller holds a Guard; installs next and returns the value it replaced.
+    const V* swap(const K& key, const V* next) {
+        ReadOnly* read = read_.load(std::memory_order_acquire);
+        auto it = read->m->find(key);
+        if (it != read->m->end()) {
+            Entry* e = it->second;
+            const V* p = e->p.load(std::memory_order_acquire);
+            while (p != expunged()) {
+                if (e->p.compare_exchange_weak(p, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    return p;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mu_);
+        read = read_.load(std::memory_order_acquire);
+        it = read->m->find(key);
+        if (it != read->m->end()) {
+            if (unexpungeLocked(it->second)) (*dirty_)[key] = it->second;
+            return it->second->p.exchange(next, std::memory_order_acq_rel);
+        }
+        if (dirty_) {
+            auto dit = dirty_->find(key);
+            if (dit != dirty_->end()) return dit->second->p.exchange(next, std::memory_order_acq_rel);
+        }
+        addLocked(read, key, next);
+        return nullptr;
+    }
+
+    // Returns nullopt if the entry was expunged (caller must take the lock).
+    static std::optional<std::pair<V, bool>> tryLoadOrStore(Entry* e, const V& value) {
+        const V* p = e->p.load(std::memory_order_acquire);
+        if (p == expunged()) return std::nullopt;
+        if (p) return std::make_pair(*p, true);
+        const V* next = new V(value);
+        for (;;) {
+            if (e->p.compare_exchange_weak(p, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return std::make_pair(value, false);
+            }
+            if (p == expunged()) {
+                delete next;
+                return std::nullopt;
+            }
+            if (p) {
+                delete next;
+                return std::make_pair(*p, true);
+            }
+        }
+    }
+
+    static bool unexpungeLocked(Entry* e) {
+        const V* p = expunged();
+        return e->p.compare_exchange_strong(p, nullptr, std::memory_order_acq_rel);
+    }
+
+    static bool tryExpungeLocked(Entry* e) {
+        const V* p = e->p.load(std::memory_order_acquire);
+        while (p == nullptr) {
+            if (e->p.compare_exchange_weak(p, expunged(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return p == expunged();
+    }
+
+    void addLocked(ReadOnly* read, const K& key, const V* value) {
+        if (!read->amended) {
+            dirtyLocked();
+            publishLocked(new ReadOnly{read->m, true});
+        }
+        (*dirty_)[key] = new Entry(value);
+    }
+
+    // Copies the live part of the snapshot into a fresh dirty map.
+    void dirtyLocked() const {
+        if (dirty_) return;
+        ReadOnly* read = read_.load(std::memory_order_acquire);
+        dirty_ = std::make_unique<Table>();
+        dirty_->reserve(read->m->size());
+        for (const auto& kv : *read->m) {
+            if (tryExpungeLocked(kv.second)) expungedEntries_.push_back(kv.second);
+            else dirty_->emplace(kv.first, kv.second);
+        }
+    }
+
+    void missLocked() const {
+        if (!dirty_ || ++misses_ < dirty_->size()) return;
+        promoteLocked();
+    }
+
+    void promoteLocked() const {
+        publishLocked(new ReadOnly{std::make_shared<const Table>(std::move(*dirty_)), false});
+        // Entries still expunged were left out of the dirty map and are now unreachable.
+        for (Entry* e : expungedEntries_) {
+            if (e->p.load(std::memory_order_acquire) == expunged()) {
+                detail::EpochDomain::instance().retire(e);
+            }
+        }
+        expungedEntries_.clear();
+        dirty_.reset();
+        misses_ = 0;
+    }
+
+    void publishLocked(ReadOnly* next) const {
+        ReadOnly* old = read_.exchange(next, std::memory_order_acq_rel);
+        detail::EpochDomain::instance().retire(old);
+    }
+
+    mutable std::atomic<ReadOnly*> read_;
+    mutable std::mutex mu_;
+    mutable std::unique_ptr<Table> dirty_;
+    mutable std::vector<Entry*> expungedEntries_;
+    mutable std::size_t misses_ = 0;
+};
+
+}  // namespace gocxx::sync
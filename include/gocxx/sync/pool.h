@@ -1,62 +1,355 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <stack>
-#include <mutex>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace gocxx::sync {
 
+/**
+ * @brief Snapshot of one pool's counters, as listed by ListPools().
+ *
+ * Counters are kept per shard without atomic read-modify-writes, so two
+ * threads sharing a shard can lose an increment; treat them as estimates.
+ */
+struct PoolStats {
+    std::string name;           ///< Set with SetName(); empty by default
+    std::uint64_t gets = 0;     ///< Calls to Get()
+    std::uint64_t misses = 0;   ///< Get() calls that found no idle object
+    std::size_t idle = 0;       ///< Objects held right now, victim cache included
+
+    /// Fraction of Get() calls served from the pool.
+    double HitRate() const { return gets ? 1.0 - static_cast<double>(misses) / static_cast<double>(gets) : 0.0; }
+};
+
+namespace detail {
+
+/**
+ * @brief Interface the cleanup cycle and ListPools() use on every live pool.
+ */
+class PoolCleaner {
+public:
+    virtual void Trim() = 0;
+    virtual PoolStats Stats() const = 0;
+
+protected:
+    ~PoolCleaner() = default;
+};
+
+/**
+ * @brief Process-wide list of pools plus the background thread that ages them.
+ *
+ * Leaked on purpose so pools destroyed during static destruction can still
+ * unregister.
+ */
+class PoolRegistry {
+public:
+    static PoolRegistry& instance() {
+        static PoolRegistry* registry = new PoolRegistry();
+        return *registry;
+    }
+
+    void add(PoolCleaner* pool) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        pools_.push_back(pool);
+        if (!started_) {
+            started_ = true;
+            std::thread([this] { loop(); }).detach();
+        }
+    }
+
+    void remove(PoolCleaner* pool) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        pools_.erase(std::remove(pools_.begin(), pools_.end(), pool), pools_.end());
+    }
+
+    void trimAll() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto* pool : pools_) pool->Trim();
+    }
+
+    std::vector<PoolStats> list() {
+        std::vector<PoolStats> out;
+        {
+            // Pools unregister under this lock, so none can go away mid-snapshot
+            std::lock_guard<std::mutex> lock(mtx_);
+            out.reserve(pools_.size());
+            for (auto* pool : pools_) out.push_back(pool->Stats());
+        }
+        std::stable_sort(out.begin(), out.end(),
+                         [](const PoolStats& a, const PoolStats& b) { return a.name < b.name; });
+        return out;
+    }
+
+    void setInterval(std::chrono::nanoseconds interval) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            interval_ = interval;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    void loop() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        for (;;) {
+            if (interval_.count() <= 0) {
+                cv_.wait(lock, [this] { return interval_.count() > 0; });
+                continue;
+            }
+            auto interval = interval_;
+            if (cv_.wait_for(lock, interval, [&] { return interval_ != interval; })) {
+                continue;  // interval changed: restart the wait
+            }
+            for (auto* pool : pools_) pool->Trim();
+        }
+    }
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<PoolCleaner*> pools_;
+    std::chrono::nanoseconds interval_ = std::chrono::seconds(2);
+    bool started_ = false;
+};
+
+inline std::size_t poolThreadIndex() {
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace detail
+
 /**
  * @brief A thread-safe object pool, similar to Go's `sync.Pool`.
  *
  * Designed for efficient reuse of expensive-to-create objects.
- * It stores objects in a stack and reuses them across multiple threads.
+ *
+ * Idle objects live in per-thread shards: each has a single-object private
+ * slot claimed with one atomic compare-exchange, and a shared overflow list
+ * that other threads steal from when their own shard is empty. Like Go's
+ * pool, objects are aged in two generations: every cleanup cycle (see
+ * SetPoolCleanupInterval() and Trim()) demotes idle objects to a victim
+ * cache and releases whatever was still in the victim cache, so an object
+ * nobody asked for during two cycles is freed.
  *
  * @tparam T The type of objects to store.
+ * @tparam Handle Owning pointer handed out: `std::shared_ptr<T>` (Pool) or
+ *         `std::unique_ptr<T, D>` (UniquePool, no control block).
  */
-template <typename T>
-class Pool {
-    std::stack<std::shared_ptr<T>> pool_;
-    std::mutex mtx_;
-    std::function<std::shared_ptr<T>()> newFunc_;
-
+template <typename T, typename Handle = std::shared_ptr<T>>
+class BasicPool final : private detail::PoolCleaner {
 public:
     /**
      * @brief Constructs a Pool with a custom creation function.
      *
      * @param newFunc A function that creates a new object when the pool is empty.
+     *        Without one, Get() on an empty pool returns an empty handle.
      */
-    explicit Pool(std::function<std::shared_ptr<T>()> newFunc)
-        : newFunc_(std::move(newFunc)) {}
+    explicit BasicPool(std::function<Handle()> newFunc)
+        : newFunc_(std::move(newFunc)), shardCount_(shardCountFor(std::thread::hardware_concurrency())),
+          shards_(new Shard[shardCount_]) {
+        detail::PoolRegistry::instance().add(this);
+    }
+
+    ~BasicPool() {
+        detail::PoolRegistry::instance().remove(this);
+    }
+
+    BasicPool(const BasicPool&) = delete;
+    BasicPool& operator=(const BasicPool&) = delete;
 
     /**
      * @brief Retrieves an object from the pool.
      *
-     * If the pool is empty, a new object is created using `newFunc`.
+     * Tries the calling thread's shard, then steals from the others, then
+     * falls back to the victim cache; if all are empty a new object is
+     * created using `newFunc`.
      *
-     * @return A shared pointer to the object.
+     * @return An owning pointer to the object.
      */
-    std::shared_ptr<T> Get() {
-        std::lock_guard<std::mutex> lock(mtx_);
-        if (pool_.empty()) {
-            return newFunc_();
+    Handle Get() {
+        const std::size_t home = localIndex();
+        Shard& local = shards_[home];
+        bump(local.gets);
+        if (Handle h = takePrivate(local)) return h;
+        if (Handle h = takeFrom(local.mtx, local.shared, true)) return h;
+
+        for (std::size_t i = 1; i < shardCount_; ++i) {
+            Shard& other = shards_[(home + i) & (shardCount_ - 1)];
+            if (Handle h = takeFrom(other.mtx, other.shared, false)) return h;
+        }
+        for (std::size_t i = 0; i < shardCount_; ++i) {
+            Shard& s = shards_[(home + i) & (shardCount_ - 1)];
+            if (Handle h = takeFrom(s.mtx, s.victim, i == 0)) return h;
         }
-        auto obj = pool_.top();
-        pool_.pop();
-        return obj;
+        bump(local.misses);
+        return newFunc_ ? newFunc_() : Handle{};
     }
 
     /**
      * @brief Returns an object back to the pool for future reuse.
      *
-     * @param obj A shared pointer to the object to store.
+     * @param obj The object to store; empty handles are ignored.
      */
-    void Put(std::shared_ptr<T> obj) {
-        std::lock_guard<std::mutex> lock(mtx_);
-        pool_.push(std::move(obj));
+    void Put(Handle obj) {
+        if (!obj) return;
+        Shard& local = shards_[localIndex()];
+        int expected = kEmpty;
+        if (local.state.compare_exchange_strong(expected, kBusy, std::memory_order_acquire)) {
+            local.privateObj = std::move(obj);
+            local.state.store(kFull, std::memory_order_release);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(local.mtx);
+        local.shared.push_back(std::move(obj));
+    }
+
+    /// Label this pool in ListPools().
+    void SetName(std::string name) {
+        std::lock_guard<std::mutex> lock(nameMtx_);
+        name_ = std::move(name);
+    }
+
+    /// Counters and idle objects of this pool; see PoolStats.
+    PoolStats Stats() const override {
+        PoolStats st;
+        {
+            std::lock_guard<std::mutex> lock(nameMtx_);
+            st.name = name_;
+        }
+        for (std::size_t i = 0; i < shardCount_; ++i) {
+            Shard& s = shards_[i];
+            st.gets += s.gets.load(std::memory_order_relaxed);
+            st.misses += s.misses.load(std::memory_order_relaxed);
+            if (s.state.load(std::memory_order_relaxed) == kFull) ++st.idle;
+            std::lock_guard<std::mutex> lock(s.mtx);
+            st.idle += s.shared.size() + s.victim.size();
+        }
+        return st;
+    }
+
+    /**
+     * @brief Run one cleanup cycle on this pool.
+     *
+     * Frees the victim cache and demotes every other idle object into it.
+     */
+    void Trim() override {
+        for (std::size_t i = 0; i < shardCount_; ++i) {
+            Shard& s = shards_[i];
+            std::vector<Handle> released;
+            Handle priv = takePrivate(s);
+            {
+                std::lock_guard<std::mutex> lock(s.mtx);
+                released.swap(s.victim);
+                s.victim.swap(s.shared);
+                if (priv) s.victim.push_back(std::move(priv));
+            }
+            // released is destroyed here, outside the shard lock
+        }
+    }
+
+private:
+    enum : int { kEmpty, kBusy, kFull };
+
+    struct alignas(64) Shard {
+        std::atomic<int> state{kEmpty};
+        Handle privateObj{};
+        std::mutex mtx;
+        std::vector<Handle> shared;
+        std::vector<Handle> victim;
+        std::atomic<std::uint64_t> gets{0};
+        std::atomic<std::uint64_t> misses{0};
+    };
+
+    // A plain load and store: cheaper than fetch_add on this hot path, at
+    // the price of an occasional lost count when threads share a shard.
+    static void bump(std::atomic<std::uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static std::size_t shardCountFor(unsigned cpus) {
+        std::size_t n = 1;
+        while (n < cpus && n < 64) n <<= 1;
+        return n;
+    }
+
+    std::size_t localIndex() const {
+        return detail::poolThreadIndex() & (shardCount_ - 1);
     }
+
+    static Handle takePrivate(Shard& s) {
+        int expected = kFull;
+        if (!s.state.compare_exchange_strong(expected, kBusy, std::memory_order_acquire)) {
+            return Handle{};
+        }
+        Handle h = std::move(s.privateObj);
+        s.privateObj = Handle{};
+        s.state.store(kEmpty, std::memory_order_release);
+        return h;
+    }
+
+    // Foreign shards are only tried, never waited for.
+    static Handle takeFrom(std::mutex& mtx, std::vector<Handle>& list, bool wait) {
+        std::unique_lock<std::mutex> lock(mtx, std::defer_lock);
+        if (wait) lock.lock();
+        else if (!lock.try_lock()) return Handle{};
+        if (list.empty()) return Handle{};
+        Handle h = std::move(list.back());
+        list.pop_back();
+        return h;
+    }
+
+    std::function<Handle()> newFunc_;
+    mutable std::mutex nameMtx_;
+    std::string name_;
+    const std::size_t shardCount_;
+    std::unique_ptr<Shard[]> shards_;
 };
 
+/**
+ * @brief Statistics of every live pool, sorted by name.
+ */
+inline std::vector<PoolStats> ListPools() {
+    return detail::PoolRegistry::instance().list();
+}
+
+/**
+ * @brief Pool handing out `std::shared_ptr<T>`.
+ */
+template <typename T>
+using Pool = BasicPool<T, std::shared_ptr<T>>;
+
+/**
+ * @brief Pool handing out `std::unique_ptr<T, D>`; no shared_ptr control block per object.
+ */
+template <typename T, typename D = std::default_delete<T>>
+using UniquePool = BasicPool<T, std::unique_ptr<T, D>>;
+
+/**
+ * @brief Run one cleanup cycle on every live pool now.
+ */
+inline void TrimPools() {
+    detail::PoolRegistry::instance().trimAll();
+}
+
+/**
+ * @brief Set how often pools are aged in the background (default two seconds).
+ *
+ * An idle object is released after two cycles. Zero or a negative interval
+ * stops the background cycle; Trim() and TrimPools() still work.
+ */
+inline void SetPoolCleanupInterval(std::chrono::nanoseconds interval) {
+    detail::PoolRegistry::instance().setInterval(interval);
+}
 
 }  // namespace gocxx::sync
@@ -0,0 +1,364 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <gocxx/runtime/blocking.h>
+
+// Default arguments that capture the caller's location (C++17 has no
+// std::source_location).
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+#define GOCXX_CALLER_FILE __builtin_FILE()
+#define GOCXX_CALLER_LINE __builtin_LINE()
+#else
+#define GOCXX_CALLER_FILE ""
+#define GOCXX_CALLER_LINE 0
+#endif
+
+namespace gocxx::sync {
+
+/**
+ * @brief Aggregated samples for one (mutex, acquisition site) pair.
+ *
+ * Hold times are only known for exclusive locks; read locks report wait
+ * time only.
+ */
+struct MutexProfileRecord {
+    std::string mutex;          ///< Name given to the mutex, or its declaration site
+    std::string file;           ///< Acquisition site; empty when locked through lock()
+    int line = 0;
+    bool shared = false;        ///< true for RLock()/lock_shared() samples
+    std::uint64_t samples = 0;
+    std::uint64_t contentions = 0;  ///< Samples that had to wait for the lock
+    std::uint64_t waitNs = 0;
+    std::uint64_t maxWaitNs = 0;
+    std::uint64_t holdNs = 0;
+    std::uint64_t maxHoldNs = 0;
+};
+
+namespace detail {
+
+inline std::atomic<int>& mutexProfileRate() {
+    static std::atomic<int> rate{0};
+    return rate;
+}
+
+inline bool sampleMutexEvent() {
+    const int rate = mutexProfileRate().load(std::memory_order_relaxed);
+    if (rate <= 0) return false;
+    if (rate == 1) return true;
+    thread_local std::uint32_t x =
+        static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&x) >> 4) | 1u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x % static_cast<std::uint32_t>(rate) == 0;
+}
+
+inline std::uint64_t monoNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline std::string mutexLabel(const char* name, const char* file, int line) {
+    if (name && *name) return name;
+    return std::string(file ? file : "") + ":" + std::to_string(line);
+}
+
+/**
+ * @brief Process-wide sample table; only touched by sampled events.
+ */
+class MutexProfiler {
+public:
+    static MutexProfiler& instance() {
+        static MutexProfiler* profiler = new MutexProfiler();
+        return *profiler;
+    }
+
+    void record(const std::string& mutex, const char* file, int line, bool shared,
+                std::uint64_t waitNs, bool contended, std::uint64_t holdNs) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto& r = records_[Key(mutex, file ? file : "", line, shared)];
+        if (r.samples == 0) {
+            r.mutex = mutex;
+            r.file = file ? file : "";
+            r.line = line;
+            r.shared = shared;
+        }
+        ++r.samples;
+        if (contended) ++r.contentions;
+        r.waitNs += waitNs;
+        r.maxWaitNs = std::max(r.maxWaitNs, waitNs);
+        r.holdNs += holdNs;
+        r.maxHoldNs = std::max(r.maxHoldNs, holdNs);
+    }
+
+    std::vector<MutexProfileRecord> snapshot() {
+        std::vector<MutexProfileRecord> out;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            out.reserve(records_.size());
+            for (const auto& kv : records_) out.push_back(kv.second);
+        }
+        std::sort(out.begin(), out.end(), [](const MutexProfileRecord& a, const MutexProfileRecord& b) {
+            return a.waitNs > b.waitNs;
+        });
+        return out;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        records_.clear();
+    }
+
+private:
+    using Key = std::tuple<std::string, std::string, int, bool>;
+    std::mutex mtx_;
+    std::map<Key, MutexProfileRecord> records_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Sample on average one in @p rate lock acquisitions (Go's SetMutexProfileFraction).
+ *
+ * 0 turns profiling off (the default), 1 records every acquisition and a
+ * negative value only reads the current setting.
+ *
+ * @return The previous rate
+ */
+inline int SetMutexProfileFraction(int rate) {
+    if (rate < 0) return detail::mutexProfileRate().load(std::memory_order_relaxed);
+    return detail::mutexProfileRate().exchange(rate, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Samples recorded so far, most total wait time first.
+ */
+inline std::vector<MutexProfileRecord> MutexProfile() {
+    return detail::MutexProfiler::instance().snapshot();
+}
+
+/// Discard every recorded sample.
+inline void ResetMutexProfile() {
+    detail::MutexProfiler::instance().reset();
+}
+
+/**
+ * @brief Mutex that records wait and hold times for sampled acquisitions.
+ *
+ * Drop-in for `sync::Mutex` (it is Lockable, so `std::lock_guard` and
+ * `std::unique_lock` work); with profiling off an acquisition costs one
+ * extra relaxed load. Use Lock() or ProfiledUniqueLock to attribute samples
+ * to the acquiring line rather than only to the mutex.
+ *
+ * @code
+ * ProfiledMutex cacheMu("cache");
+ * SetMutexProfileFraction(100);
+ * { ProfiledUniqueLock lock(cacheMu); ... }
+ * for (auto& r : MutexProfile()) std::cout << r.mutex << " " << r.file << ":" << r.line << " " << r.waitNs;
+ * @endcode
+ */
+class ProfiledMutex {
+public:
+    /**
+     * @param name Label used in the profile; defaults to the declaration site.
+     */
+    explicit ProfiledMutex(const char* name = nullptr, const char* file = GOCXX_CALLER_FILE,
+                           int line = GOCXX_CALLER_LINE)
+        : label_(detail::mutexLabel(name, file, line)) {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() { acquire(nullptr, 0); }
+
+    bool try_lock() { return mu_.try_lock(); }
+
+    void unlock() {
+        if (!sampled_) {
+            mu_.unlock();
+            return;
+        }
+        sampled_ = false;
+        const std::uint64_t hold = detail::monoNs() - acquiredAt_;
+        const char* file = file_;
+        const int line = line_;
+        const std::uint64_t wait = waitNs_;
+        const bool contended = contended_;
+        mu_.unlock();
+        detail::MutexProfiler::instance().record(label_, file, line, false, wait, contended, hold);
+    }
+
+    /// Go-style lock that attributes samples to the calling line.
+    void Lock(const char* file = GOCXX_CALLER_FILE, int line = GOCXX_CALLER_LINE) { acquire(file, line); }
+    void Unlock() { unlock(); }
+
+    const std::string& name() const { return label_; }
+
+private:
+    void acquire(const char* file, int line) {
+        if (!detail::sampleMutexEvent()) {
+            if (!mu_.try_lock()) {
+                runtime::WaitScope waiting(runtime::WaitReason::Mutex);
+                mu_.lock();
+            }
+            return;
+        }
+        const std::uint64_t start = detail::monoNs();
+        const bool contended = !mu_.try_lock();
+        if (contended) {
+            runtime::WaitScope waiting(runtime::WaitReason::Mutex);
+            mu_.lock();
+        }
+        acquiredAt_ = detail::monoNs();
+        // Written while holding mu_ and read back by the same holder in unlock().
+        sampled_ = true;
+        file_ = file;
+        line_ = line;
+        waitNs_ = acquiredAt_ - start;
+        contended_ = contended;
+    }
+
+    std::mutex mu_;
+    std::string label_;
+    bool sampled_ = false;
+    bool contended_ = false;
+    const char* file_ = nullptr;
+    int line_ = 0;
+    std::uint64_t acquiredAt_ = 0;
+    std::uint64_t waitNs_ = 0;
+};
+
+/**
+ * @brief Read-write mutex with the same sampling as ProfiledMutex.
+ *
+ * Drop-in for `sync::RWMutex`. Writers report wait and hold time, readers
+ * report wait time.
+ */
+class ProfiledRWMutex {
+public:
+    explicit ProfiledRWMutex(const char* name = nullptr, const char* file = GOCXX_CALLER_FILE,
+                             int line = GOCXX_CALLER_LINE)
+        : label_(detail::mutexLabel(name, file, line)) {}
+
+    ProfiledRWMutex(const ProfiledRWMutex&) = delete;
+    ProfiledRWMutex& operator=(const ProfiledRWMutex&) = delete;
+
+    void lock() { acquire(nullptr, 0); }
+    bool try_lock() { return mu_.try_lock(); }
+
+    void unlock() {
+        if (!sampled_) {
+            mu_.unlock();
+            return;
+        }
+        sampled_ = false;
+        const std::uint64_t hold = detail::monoNs() - acquiredAt_;
+        const char* file = file_;
+        const int line = line_;
+        const std::uint64_t wait = waitNs_;
+        const bool contended = contended_;
+        mu_.unlock();
+        detail::MutexProfiler::instance().record(label_, file, line, false, wait, contended, hold);
+    }
+
+    void lock_shared() { acquireShared(nullptr, 0); }
+    bool try_lock_shared() { return mu_.try_lock_shared(); }
+    void unlock_shared() { mu_.unlock_shared(); }
+
+    void Lock(const char* file = GOCXX_CALLER_FILE, int line = GOCXX_CALLER_LINE) { acquire(file, line); }
+    void Unlock() { unlock(); }
+    void RLock(const char* file = GOCXX_CALLER_FILE, int line = GOCXX_CALLER_LINE) { acquireShared(file, line); }
+    void RUnlock() { unlock_shared(); }
+
+    const std::string& name() const { return label_; }
+
+private:
+    void acquire(const char* file, int line) {
+        if (!detail::sampleMutexEvent()) {
+            if (!mu_.try_lock()) {
+                runtime::WaitScope waiting(runtime::WaitReason::Mutex);
+                mu_.lock();
+            }
+            return;
+        }
+        const std::uint64_t start = detail::monoNs();
+        const bool contended = !mu_.try_lock();
+        if (contended) {
+            runtime::WaitScope waiting(runtime::WaitReason::Mutex);
+            mu_.lock();
+        }
+        acquiredAt_ = detail::monoNs();
+        sampled_ = true;
+        file_ = file;
+        line_ = line;
+        waitNs_ = acquiredAt_ - start;
+        contended_ = contended;
+    }
+
+    void acquireShared(const char* file, int line) {
+        if (!detail::sampleMutexEvent()) {
+            if (!mu_.try_lock_shared()) {
+                runtime::WaitScope waiting(runtime::WaitReason::Mutex);
+                mu_.lock_shared();
+            }
+            return;
+        }
+        const std::uint64_t start = detail::monoNs();
+        const bool contended = !mu_.try_lock_shared();
+        if (contended) {
+            runtime::WaitScope waiting(runtime::WaitReason::Mutex);
+            mu_.lock_shared();
+        }
+        detail::MutexProfiler::instance().record(label_, file, line, true, detail::monoNs() - start,
+                                                 contended, 0);
+    }
+
+    std::shared_mutex mu_;
+    std::string label_;
+    bool sampled_ = false;
+    bool contended_ = false;
+    const char* file_ = nullptr;
+    int line_ = 0;
+    std::uint64_t acquiredAt_ = 0;
+    std::uint64_t waitNs_ = 0;
+};
+
+/**
+ * @brief `UniqueLock` for ProfiledMutex that attributes samples to the line constructing it.
+ */
+class ProfiledUniqueLock : public std::unique_lock<ProfiledMutex> {
+public:
+    explicit ProfiledUniqueLock(ProfiledMutex& m, const char* file = GOCXX_CALLER_FILE,
+                                int line = GOCXX_CALLER_LINE)
+        : std::unique_lock<ProfiledMutex>((m.Lock(file, line), m), std::adopt_lock) {}
+};
+
+/**
+ * @brief `ReadLock` for ProfiledRWMutex that attributes samples to the line constructing it.
+ */
+class ProfiledReadLock : public std::shared_lock<ProfiledRWMutex> {
+public:
+    explicit ProfiledReadLock(ProfiledRWMutex& m, const char* file = GOCXX_CALLER_FILE,
+                              int line = GOCXX_CALLER_LINE)
+        : std::shared_lock<ProfiledRWMutex>((m.RLock(file, line), m), std::adopt_lock) {}
+};
+
+/**
+ * @brief `WriteLock` for ProfiledRWMutex that attributes samples to the line constructing it.
+ */
+class ProfiledWriteLock : public std::unique_lock<ProfiledRWMutex> {
+public:
+    explicit ProfiledWriteLock(ProfiledRWMutex& m, const char* file = GOCXX_CALLER_FILE,
+                               int line = GOCXX_CALLER_LINE)
+        : std::unique_lock<ProfiledRWMutex>((m.Lock(file, line), m), std::adopt_lock) {}
+};
+
+}  // namespace gocxx::sync
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <gocxx/base/chan.h>
+#include <gocxx/base/result.h>
+#include <gocxx/base/select.h>
+#include <gocxx/context/context.h>
+#include <gocxx/errors/errors.h>
+
+// Not part of sync.h: chan.h includes sync.h, and this header needs context.h.
+
+namespace gocxx::sync {
+
+/**
+ * @brief Weighted counting semaphore, like Go's `golang.org/x/sync/semaphore.Weighted`.
+ *
+ * Waiters are served strictly in FIFO order: a large request at the head of
+ * the queue is not starved by a stream of small ones. Acquire() gives up
+ * when its context is canceled.
+ *
+ * @code
+ * Semaphore sem(4);  // at most four expensive calls at once
+ * if (auto r = sem.Acquire(ctx); r.Failed()) return r;
+ * defer([&] { sem.Release(); });
+ * @endcode
+ */
+class Semaphore {
+public:
+    /**
+     * @param size Maximum combined weight held at once.
+     */
+    explicit Semaphore(std::int64_t size) : size_(size) {}
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+    /**
+     * @brief Acquire weight @p n, blocking until it is available or @p ctx is done.
+     *
+     * On failure nothing is held. A null @p ctx waits without a deadline.
+     *
+     * @return ctx->Err() if the context ended first.
+     */
+    base::Result<void> Acquire(context::ContextPtr ctx, std::int64_t n = 1) {
+        if (ctx && ctx->Err().Failed()) return ctx->Err();
+
+        std::unique_lock<std::mutex> lock(mu_);
+        if (size_ - cur_ >= n && waiters_.empty()) {
+            cur_ += n;
+            return base::Result<void>();
+        }
+        if (n > size_) {
+            // Can never succeed; Go waits for the context, so do the same.
+            lock.unlock();
+            if (!ctx) return base::Result<void>(errors::New("semaphore: acquire exceeds semaphore size"));
+            ctx->Done().recv();
+            return ctx->Err();
+        }
+
+        auto it = waiters_.insert(waiters_.end(), Waiter{n, base::Chan<bool>()});
+        base::Chan<bool> ready = it->ready;
+        lock.unlock();
+
+        if (!ctx) {
+            ready.recv();
+            return base::Result<void>();
+        }
+        bool acquired = false;
+        base::Chan<bool> done = ctx->Done();
+        base::select(base::recvCase(ready, [&](std::optional<bool>) { acquired = true; }),
+                     base::recvCase(done, [](std::optional<bool>) {}));
+        if (acquired) return base::Result<void>();
+
+        lock.lock();
+        if (ready.isClosed()) {
+            // Granted after the context ended: give the weight back.
+            cur_ -= n;
+            notifyWaitersLocked();
+        } else {
+            const bool front = it == waiters_.begin();
+            waiters_.erase(it);
+            // Removing the head may unblock the waiters queued behind it.
+            if (front && size_ > cur_) notifyWaitersLocked();
+        }
+        return ctx->Err();
+    }
+
+    /**
+     * @brief Acquire weight @p n without blocking.
+     *
+     * @return false, leaving the semaphore unchanged, if @p n is not available.
+     */
+    bool TryAcquire(std::int64_t n = 1) {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (size_ - cur_ >= n && waiters_.empty()) {
+            cur_ += n;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Release weight @p n.
+     *
+     * Throws std::logic_error when releasing more than is held.
+     */
+    void Release(std::int64_t n = 1) {
+        std::lock_guard<std::mutex> lock(mu_);
+        cur_ -= n;
+        if (cur_ < 0) {
+            cur_ += n;
+            throw std::logic_error("semaphore: released more than held");
+        }
+        notifyWaitersLocked();
+    }
+
+private:
+    struct Waiter {
+        std::int64_t n;
+        base::Chan<bool> ready;  // closed once the weight is granted
+    };
+
+    void notifyWaitersLocked() {
+        while (!waiters_.empty()) {
+            Waiter& w = waiters_.front();
+            if (size_ - cur_ < w.n) break;  // FIFO: nobody overtakes the head
+            cur_ += w.n;
+            w.ready.close();
+            waiters_.pop_front();
+        }
+    }
+
+    std::mutex mu_;
+    const std::int64_t size_;
+    std::int64_t cur_ = 0;
+    std::list<Waiter> waiters_;
+};
+
+}  // namespace gocxx::sync
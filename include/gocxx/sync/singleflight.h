@@ -0,0 +1,146 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <gocxx/base/chan.h>
+#include <gocxx/base/result.h>
+#include <gocxx/errors/errors.h>
+#include <gocxx/runtime/runtime.h>
+#include "waitgroup.h"
+
+// Not part of sync.h: chan.h includes sync.h.
+
+namespace gocxx::sync {
+
+/**
+ * @brief Outcome of a SingleFlight call, like Go's `singleflight.Result`.
+ */
+template <typename V>
+struct FlightResult {
+    V value{};
+    std::shared_ptr<errors::Error> err;
+    bool shared = false;  ///< The value was handed to more than one caller
+
+    bool Ok() const noexcept { return !err; }
+    bool Failed() const noexcept { return static_cast<bool>(err); }
+};
+
+/**
+ * @brief Suppresses duplicate concurrent calls, like Go's `golang.org/x/sync/singleflight.Group`.
+ *
+ * While a call for a key is in flight, further Do() or DoChan() calls for
+ * the same key wait for it and receive the same result instead of running
+ * the function again. Once it returns, the next call runs it afresh.
+ *
+ * @code
+ * SingleFlight<std::string, Row> fetches;
+ * auto r = fetches.Do(id, [&] { return backend.Load(id); });
+ * @endcode
+ */
+template <typename K, typename V, typename Hash = std::hash<K>>
+class SingleFlight {
+public:
+    using Func = std::function<base::Result<V>()>;
+
+    SingleFlight() = default;
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    /**
+     * @brief Run @p fn for @p key unless a call for it is already in flight.
+     *
+     * A call joined while in flight returns with `shared` set. If @p fn
+     * throws, the exception propagates to this caller and joined callers get
+     * an error.
+     */
+    FlightResult<V> Do(const K& key, Func fn) {
+        std::unique_lock<std::mutex> lock(mu_);
+        auto it = calls_.find(key);
+        if (it != calls_.end()) {
+            std::shared_ptr<Call> c = it->second;
+            ++c->dups;
+            lock.unlock();
+            c->wg.Wait();
+            return FlightResult<V>{c->result.value, c->result.err, true};
+        }
+        auto c = std::make_shared<Call>();
+        c->wg.Add(1);
+        calls_.emplace(key, c);
+        lock.unlock();
+
+        const bool shared = doCall(key, c, fn);
+        return FlightResult<V>{c->result.value, c->result.err, shared};
+    }
+
+    /**
+     * @brief Like Do(), but runs @p fn on the task runtime and delivers the result on a channel.
+     *
+     * The returned channel is buffered, so it is fine never to read it.
+     */
+    base::Chan<FlightResult<V>> DoChan(const K& key, Func fn) {
+        base::Chan<FlightResult<V>> ch(1);
+        std::unique_lock<std::mutex> lock(mu_);
+        auto it = calls_.find(key);
+        if (it != calls_.end()) {
+            ++it->second->dups;
+            it->second->chans.push_back(ch);
+            return ch;
+        }
+        auto c = std::make_shared<Call>();
+        c->wg.Add(1);
+        c->chans.push_back(ch);
+        calls_.emplace(key, c);
+        lock.unlock();
+
+        gocxx::go([this, key, c, fn = std::move(fn)] { doCall(key, c, fn); });
+        return ch;
+    }
+
+    /**
+     * @brief Stop sharing the in-flight call for @p key; the next call runs fn again.
+     */
+    void Forget(const K& key) {
+        std::lock_guard<std::mutex> lock(mu_);
+        calls_.erase(key);
+    }
+
+private:
+    struct Call {
+        WaitGroup wg;
+        base::Result<V> result;
+        int dups = 0;
+        std::vector<base::Chan<FlightResult<V>>> chans;
+    };
+
+    // Returns whether the result was shared with other callers.
+    bool doCall(const K& key, const std::shared_ptr<Call>& c, const Func& fn) {
+        try {
+            c->result = fn();
+        } catch (...) {
+            c->result = base::Result<V>(errors::New("singleflight: function threw an exception"));
+            finish(key, c);
+            throw;
+        }
+        return finish(key, c);
+    }
+
+    bool finish(const K& key, const std::shared_ptr<Call>& c) {
+        c->wg.Done();
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = calls_.find(key);
+        if (it != calls_.end() && it->second == c) calls_.erase(it);  // unless forgotten
+        const bool shared = c->dups > 0;
+        for (auto& ch : c->chans) {
+            ch.trySend(FlightResult<V>{c->result.value, c->result.err, shared});
+        }
+        return shared;
+    }
+
+    std::mutex mu_;
+    std::unordered_map<K, std::shared_ptr<Call>, Hash> calls_;
+};
+
+}  // namespace gocxx::sync
@@ -6,3 +6,5 @@
 #include "once.h"
 #include "cond.h"
 #include "pool.h"
+#include "map.h"
+#include "profiled_mutex.h"
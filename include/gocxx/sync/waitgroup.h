@@ -1,7 +1,9 @@
 #pragma once
-#include <mutex>
-#include <condition_variable>
+#include <atomic>
+#include <cstdint>
 #include <stdexcept>
+#include <gocxx/runtime/blocking.h>
+#include "detail/futex.h"
 
 namespace gocxx::sync {
 
@@ -10,11 +12,15 @@ namespace gocxx::sync {
  *
  * Inspired by Go's `sync.WaitGroup`. Use `Add()` to set the number of tasks, `Done()` when a task finishes,
  * and `Wait()` to block until all tasks are complete.
+ *
+ * As in Go, the task counter (high 32 bits) and the number of blocked
+ * waiters (low 32 bits) share one 64-bit atomic, so `Add()`/`Done()` are a
+ * single atomic add and only touch the kernel when the counter reaches zero
+ * while somebody is actually waiting.
  */
 class WaitGroup {
-    std::mutex mtx_;
-    std::condition_variable cv_;
-    int count_ = 0;
+    std::atomic<std::uint64_t> state_{0};
+    std::atomic<std::uint32_t> sema_{0};  // bumped to release waiters
 
 public:
     /**
@@ -23,14 +29,22 @@ public:
      * @param delta The number of tasks to add. Can be negative (but should be used carefully).
      */
     void Add(int delta) {
-        std::lock_guard<std::mutex> lock(mtx_);
-        count_ += delta;
-        if (count_ < 0) {
+        const std::uint64_t s = state_.fetch_add(static_cast<std::uint64_t>(static_cast<std::int64_t>(delta)) << 32,
+                                                 std::memory_order_acq_rel) +
+                                (static_cast<std::uint64_t>(static_cast<std::int64_t>(delta)) << 32);
+        const auto count = static_cast<std::int32_t>(s >> 32);
+        const auto waiters = static_cast<std::uint32_t>(s);
+        if (count < 0) {
             throw std::runtime_error("WaitGroup counter went negative");
         }
-        if (count_ == 0) {
-            cv_.notify_all();
+        if (count > 0 || waiters == 0) {
+            return;
         }
+        // Counter hit zero with waiters: nobody may Add concurrently now, so
+        // reset the waiter count and release them all.
+        state_.store(0, std::memory_order_relaxed);
+        sema_.fetch_add(1, std::memory_order_release);
+        detail::futexWakeAll(sema_);
     }
 
     /**
@@ -44,8 +58,20 @@ public:
      * @brief Blocks until the counter becomes zero.
      */
     void Wait() {
-        std::unique_lock<std::mutex> lock(mtx_);
-        cv_.wait(lock, [this] { return count_ == 0; });
+        std::uint64_t s = state_.load(std::memory_order_acquire);
+        for (;;) {
+            if ((s >> 32) == 0) return;
+            // Read the generation before registering: a release that lands
+            // after the registration is then guaranteed to change it.
+            const std::uint32_t gen = sema_.load(std::memory_order_acquire);
+            if (state_.compare_exchange_weak(s, s + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::WaitGroup);
+                while (sema_.load(std::memory_order_acquire) == gen) {
+                    detail::futexWait(sema_, gen);
+                }
+                return;
+            }
+        }
     }
 };
 
@@ -0,0 +1,111 @@
+/**
+ * @file timer_service.h
+ * @brief Process-wide timer heap shared by Timer, Ticker and TimerContext
+ *
+ * Modelled on Go's runtime timers: every deadline lives in one 4-ary
+ * min-heap served by a single thread, so arming a timer costs a heap push
+ * instead of a thread. Like Go, changes are applied lazily: Stop() and a
+ * Reset() to a later deadline only update the timer itself in O(1) and the
+ * heap entry is fixed up when it reaches the top; only a Reset() to an
+ * earlier deadline pushes a new entry. Stale entries are compacted away
+ * once they make up half of the heap.
+ *
+ * Callbacks run on the timer thread and must not block; anything heavier
+ * should be handed to the task runtime.
+ */
+
+// gocxx/time/detail/timer_service.h
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gocxx::time::detail {
+
+    /// Monotonic clock reading in nanoseconds; the time base of the timer service.
+    std::int64_t monotonicNs();
+
+    class TimerService;
+
+    /**
+     * @brief One timer registered with the TimerService.
+     *
+     * Owned through a shared_ptr by the public timer object; the heap holds
+     * another reference while an entry is queued. Scheduling state is
+     * guarded by the service mutex.
+     */
+    class TimerNode {
+    public:
+        explicit TimerNode(std::function<void()> fn) : fn_(std::move(fn)) {}
+
+    private:
+        friend class TimerService;
+
+        std::function<void()> fn_;
+        std::int64_t when_ = 0;        // deadline; 0 while stopped
+        std::int64_t period_ = 0;      // > 0 for tickers
+        std::int64_t queuedWhen_ = 0;  // deadline of the live heap entry
+        bool queued_ = false;
+    };
+
+    /**
+     * @brief The shared timer heap and the thread that fires it.
+     */
+    class TimerService {
+    public:
+        static TimerService& instance();
+
+        /**
+         * @brief Arm @p node to fire at monotonic time @p when, then every @p period ns if non-zero.
+         * @return true if the timer was already armed (the old deadline is replaced)
+         */
+        bool start(const std::shared_ptr<TimerNode>& node, std::int64_t when, std::int64_t period = 0);
+
+        /**
+         * @brief Disarm @p node in O(1).
+         * @return true if this call stopped an armed timer
+         */
+        bool stop(TimerNode& node);
+
+        /**
+         * @brief Like stop(), and also waits for a callback of @p node that is running right now.
+         *
+         * Lets an owner destroy what the callback captured. Does not wait
+         * when called from the callback itself.
+         */
+        bool stopSync(TimerNode& node);
+
+        /// Number of heap entries, stale ones included (for tests and stats).
+        std::size_t queued();
+
+    private:
+        struct Entry {
+            std::int64_t when;
+            std::shared_ptr<TimerNode> node;
+        };
+
+        TimerService() = default;
+
+        void push(std::int64_t when, const std::shared_ptr<TimerNode>& node);
+        Entry popTop();
+        void siftUp(std::size_t i);
+        void siftDown(std::size_t i);
+        void compactLocked(std::vector<Entry>& garbage);
+        void loop();
+
+        std::mutex mtx_;
+        std::condition_variable wake_;
+        std::condition_variable callbackDone_;
+        std::vector<Entry> heap_;
+        std::size_t stale_ = 0;
+        TimerNode* running_ = nullptr;  // node whose callback is executing
+        std::thread::id thread_;
+        bool started_ = false;
+    };
+
+} // namespace gocxx::time::detail
@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <gocxx/base/result.h>
+#include <gocxx/context/context.h>
+#include "duration.h"
+
+namespace gocxx::time::rate {
+
+/// Events per second.
+using Limit = double;
+
+/// No limit: every event is allowed, even when the burst is zero.
+inline constexpr Limit Inf = std::numeric_limits<double>::infinity();
+
+/// The Limit for one event every @p interval.
+inline Limit Every(Duration interval) {
+    if (interval.Nanoseconds() <= 0) return Inf;
+    return 1e9 / static_cast<double>(interval.Nanoseconds());
+}
+
+class Limiter;
+
+/**
+ * @brief Tokens taken from a Limiter ahead of time, like Go's `rate.Reservation`.
+ */
+class Reservation {
+public:
+    /// false if the request can never be granted (more tokens than the burst).
+    bool OK() const { return ok_; }
+
+    /// How long to wait before acting on the reservation; zero if not OK().
+    Duration Delay() const;
+
+    /// Return the tokens if the reservation has not been acted on yet.
+    void Cancel();
+
+private:
+    friend class Limiter;
+
+    Limiter* lim_ = nullptr;
+    bool ok_ = false;
+    std::int64_t timeToAct_ = 0;  // monotonic ns
+    std::int64_t cost_ = 0;       // ns of schedule taken
+};
+
+/**
+ * @brief Token-bucket rate limiter, like Go's `golang.org/x/time/rate.Limiter`.
+ *
+ * Implemented as GCRA (the "generic cell rate algorithm"): the whole bucket
+ * state is one atomic theoretical arrival time, so Allow() is a clock read
+ * and a compare-exchange, without a lock. The bucket refills at @p r tokens
+ * per second up to @p burst tokens and starts full.
+ *
+ * @code
+ * rate::Limiter lim(100, 10);  // 100 calls/s, bursts of 10
+ * if (!lim.Allow()) return errTooBusy;
+ * if (auto r = lim.Wait(ctx); r.Failed()) return r;
+ * @endcode
+ */
+class Limiter {
+public:
+    /**
+     * @param r Refill rate in tokens per second; Inf disables limiting, zero or
+     *          less allows nothing
+     * @param burst Bucket size: the most tokens a single call can take
+     */
+    Limiter(Limit r, int burst);
+
+    Limiter(const Limiter&) = delete;
+    Limiter& operator=(const Limiter&) = delete;
+
+    Limit GetLimit() const { return limit_.load(std::memory_order_relaxed); }
+    int Burst() const { return burst_.load(std::memory_order_relaxed); }
+
+    /// Change the refill rate; tokens already borrowed keep their schedule.
+    void SetLimit(Limit r);
+    void SetBurst(int burst);
+
+    /// Take one token if available right now.
+    bool Allow() { return AllowN(1); }
+
+    /// Take @p n tokens if all are available right now.
+    bool AllowN(int n);
+
+    Reservation Reserve() { return ReserveN(1); }
+
+    /**
+     * @brief Take @p n tokens now and report how long to wait before using them.
+     *
+     * Always succeeds unless @p n exceeds the burst; Cancel() hands the
+     * tokens back.
+     */
+    Reservation ReserveN(int n);
+
+    /// Block until one token is available or @p ctx is done.
+    base::Result<void> Wait(context::ContextPtr ctx) { return WaitN(std::move(ctx), 1); }
+
+    /**
+     * @brief Block until @p n tokens are available or @p ctx is done.
+     *
+     * Fails immediately, taking nothing, if @p n exceeds the burst or the
+     * wait would outlast the context's deadline. A null @p ctx waits
+     * without a deadline.
+     */
+    base::Result<void> WaitN(context::ContextPtr ctx, int n);
+
+private:
+    friend class Reservation;
+
+    // Schedule an arrival of n tokens; returns the new TAT or -1 if refused.
+    std::int64_t take(int n, std::int64_t now, bool mustBeReady, std::int64_t* cost);
+
+    std::atomic<std::int64_t> tat_{0};       // theoretical arrival time, monotonic ns
+    std::atomic<std::int64_t> intervalNs_;   // ns per token; 0: unlimited, < 0: nothing allowed
+    std::atomic<Limit> limit_;
+    std::atomic<int> burst_;
+};
+
+} // namespace gocxx::time::rate
@@ -1,28 +1,40 @@
 #pragma once
 #include "duration.h"
 #include "time.h"
-#include <thread>
+#include "detail/timer_service.h"
 #include <atomic>
 #include <memory>
 #include <gocxx/base/chan.h>
 
 namespace gocxx::time {
 
+/**
+ * @brief Periodic timer, like Go's `time.Ticker`.
+ *
+ * Ticks come from the shared timer service. As in Go, C() has a buffer of
+ * one and ticks are dropped for a slow receiver instead of piling up.
+ * Stop() closes the channel.
+ */
 class Ticker {
 public:
+    /// Throws std::invalid_argument if @p d is not positive.
     explicit Ticker(Duration d);
     ~Ticker();
 
+    Ticker(const Ticker&) = delete;
+    Ticker& operator=(const Ticker&) = delete;
+
     void Stop();
+
+    /// Change the period; the next tick arrives @p d from now.
+    void Reset(Duration d);
+
     std::shared_ptr<gocxx::base::Chan<Time>> C();
 
 private:
-    void run();
-
-    Duration duration_;
-    std::thread thread_;
     std::atomic<bool> stopped_;
     std::shared_ptr<gocxx::base::Chan<Time>> ch_;
+    std::shared_ptr<detail::TimerNode> node_;
 };
 
 std::unique_ptr<Ticker> NewTicker(Duration d);
@@ -6,10 +6,19 @@
 #include <chrono>
 #include "duration.h"
 #include <thread>
+#include <gocxx/runtime/blocking.h>
 
 namespace gocxx::time {
 
-// Represents a specific point in time
+/**
+ * @brief Represents a specific point in time.
+ *
+ * Like Go's time.Time, a Time returned by Now() also carries a monotonic
+ * clock reading. Sub(), Before(), After() and Equal() use it when both
+ * operands have one, so elapsed-time measurements are immune to wall-clock
+ * steps; Add() keeps it, while Truncate(), Round() and the Unix()/Date()
+ * constructors produce wall-clock-only times.
+ */
 class Time {
 public:
     Time();
@@ -47,14 +56,36 @@ public:
     int YearDay() const;
 
     bool IsZero() const;
-    
+
+    /// true if this Time carries a monotonic clock reading.
+    bool HasMonotonic() const { return mono_ != 0; }
 
 private:
     int64_t sec_;
     int32_t nsec_;
+    int64_t mono_ = 0;  // monotonic clock reading in ns; 0 when absent
+
+    friend Time CoarseNow();
 };
 
+/**
+ * @brief Current time at about 1-4ms resolution, for hot paths.
+ *
+ * Reads the kernel's coarse clocks (CLOCK_REALTIME_COARSE and
+ * CLOCK_MONOTONIC_COARSE on Linux), which cost a few nanoseconds and no
+ * system call. Falls back to Time::Now() elsewhere. The result carries a
+ * monotonic reading comparable with that of Time::Now().
+ */
+Time CoarseNow();
+
+/// Time elapsed since @p t; shorthand for Time::Now().Sub(t).
+inline Duration Since(const Time& t) { return Time::Now().Sub(t); }
+
+/// Duration until @p t; shorthand for t.Sub(Time::Now()).
+inline Duration Until(const Time& t) { return t.Sub(Time::Now()); }
+
 inline void Sleep(Duration d) {
+    gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::Sleep);
     std::this_thread::sleep_for(std::chrono::nanoseconds(d.Nanoseconds()));
 }
 
@@ -2,35 +2,72 @@
 #include <gocxx/base/chan.h>
 #include "time.h"
 #include "duration.h"
-#include <thread>
-#include <atomic>
+#include "detail/timer_service.h"
+#include <functional>
 #include <memory>
-#include <mutex>
-#include <condition_variable>
 
 namespace gocxx::time {
 
+/**
+ * @brief Single-shot timer, like Go's `time.Timer`.
+ *
+ * The deadline is registered with the shared timer service; no thread is
+ * started per timer, and Stop() and Reset() never create one. When the
+ * timer fires the current time is offered on the buffered channel C().
+ *
+ * Timers made by AfterFunc() have no channel; C() returns null.
+ */
 class Timer {
 public:
     explicit Timer(Duration d);
     ~Timer();
 
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+    /**
+     * @brief Prevent the timer from firing.
+     * @return true if the call stopped the timer, false if it had already fired or been stopped
+     */
     bool Stop();
+
+    /**
+     * @brief Restart the timer to fire after @p d.
+     *
+     * A value that is still unread from an earlier expiry is discarded, so
+     * the next receive on C() reflects the new deadline.
+     *
+     * @return true if the timer was active when reset
+     */
     bool Reset(Duration d);
+
     std::shared_ptr<gocxx::base::Chan<Time>> C();
 
 private:
-    Duration duration_;
-    std::chrono::steady_clock::time_point start_;
-    std::thread thread_;
-    std::atomic<bool> stopped_;
-    std::shared_ptr<gocxx::base::Chan<Time>> ch_;
-    std::mutex mutex_;
-    std::condition_variable cv_;
+    friend std::unique_ptr<Timer> AfterFunc(Duration d, std::function<void()> fn);
 
-    void run();
+    Timer(Duration d, std::function<void()> fn);
+
+    std::shared_ptr<gocxx::base::Chan<Time>> ch_;
+    std::shared_ptr<detail::TimerNode> node_;
 };
 
 std::unique_ptr<Timer> NewTimer(Duration d);
 
+/**
+ * @brief Run @p fn on the task runtime once @p d has elapsed, like Go's `time.AfterFunc`.
+ *
+ * No channel is allocated. The returned timer can Stop() or Reset() the
+ * call; as in Go, dropping it does not cancel the call.
+ */
+std::unique_ptr<Timer> AfterFunc(Duration d, std::function<void()> fn);
+
+/**
+ * @brief Channel that receives the current time once @p d has elapsed, like Go's `time.After`.
+ *
+ * Cannot be stopped; use NewTimer() when the wait may be abandoned early
+ * and the deadline is far away.
+ */
+std::shared_ptr<gocxx::base::Chan<Time>> After(Duration d);
+
 } // namespace gocxx::time
@@ -0,0 +1,589 @@
+#include "gocxx/aio/aio.h"
+
+#include <gocxx/runtime/blocking.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <cerrno>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace gocxx::aio {
+
+    using gocxx::base::Result;
+
+    namespace detail {
+
+        class Backend {
+        public:
+            virtual ~Backend() = default;
+            virtual void submit(const Op* ops, const Completion* done, std::size_t count) = 0;
+            virtual Result<void> registerBuffers(const io::MutableBuffers& bufs) = 0;
+            virtual Result<void> unregisterBuffers() = 0;
+            virtual Result<void> registerFiles(const std::vector<int>& fds) = 0;
+            virtual Result<void> unregisterFiles() = 0;
+            virtual bool usesIoUring() const = 0;
+        };
+
+    } // namespace detail
+
+    namespace {
+
+        const char* opName(OpKind kind) {
+            switch (kind) {
+                case OpKind::Read: return "read";
+                case OpKind::Write: return "write";
+                case OpKind::Fsync: return "fsync";
+            }
+            return "io";
+        }
+
+        // res follows the kernel convention: bytes, or -errno.
+        void complete(const Completion& done, OpKind kind, long res) {
+            if (res < 0) {
+                done->send(Result<std::size_t>(
+                    errors::New(std::string("aio ") + opName(kind) + ": " + std::strerror(static_cast<int>(-res)))));
+            } else {
+                done->send(Result<std::size_t>(static_cast<std::size_t>(res)));
+            }
+        }
+
+        Result<void> errnoResult(const char* call, int err) {
+            return Result<void>(errors::New(std::string(call) + ": " + std::strerror(err)));
+        }
+
+        // ---- Thread-pool backend ----
+
+        class PoolBackend final : public detail::Backend {
+        public:
+            explicit PoolBackend(std::size_t threads) {
+                if (threads == 0) threads = 1;
+                for (std::size_t i = 0; i < threads; ++i) {
+                    workers_.emplace_back([this] { loop(); });
+                }
+            }
+
+            ~PoolBackend() override {
+                {
+                    std::lock_guard<std::mutex> lock(mtx_);
+                    stopping_ = true;
+                }
+                cv_.notify_all();
+                for (auto& t : workers_) t.join();
+            }
+
+            void submit(const Op* ops, const Completion* done, std::size_t count) override {
+                {
+                    std::lock_guard<std::mutex> lock(mtx_);
+                    for (std::size_t i = 0; i < count; ++i) {
+                        queue_.push_back({ ops[i], done[i] });
+                    }
+                }
+                if (count == 1) cv_.notify_one();
+                else cv_.notify_all();
+            }
+
+            Result<void> registerBuffers(const io::MutableBuffers& bufs) override {
+                std::lock_guard<std::mutex> lock(mtx_);
+                buffers_ = bufs;
+                return Result<void>();
+            }
+
+            Result<void> unregisterBuffers() override {
+                std::lock_guard<std::mutex> lock(mtx_);
+                buffers_.clear();
+                return Result<void>();
+            }
+
+            Result<void> registerFiles(const std::vector<int>& fds) override {
+                std::lock_guard<std::mutex> lock(mtx_);
+                files_ = fds;
+                return Result<void>();
+            }
+
+            Result<void> unregisterFiles() override {
+                std::lock_guard<std::mutex> lock(mtx_);
+                files_.clear();
+                return Result<void>();
+            }
+
+            bool usesIoUring() const override { return false; }
+
+        private:
+            struct Task {
+                Op op;
+                Completion done;
+            };
+
+            void loop() {
+                std::unique_lock<std::mutex> lock(mtx_);
+                for (;;) {
+                    cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                    if (queue_.empty()) return;  // stopping, and everything queued has run
+                    Task task = std::move(queue_.front());
+                    queue_.pop_front();
+
+                    // Resolve registered files and buffers while holding the lock.
+                    int fd = task.op.fd;
+                    long res = 0;
+                    if (task.op.fixedFile) {
+                        fd = task.op.fd >= 0 && static_cast<std::size_t>(task.op.fd) < files_.size()
+                                 ? files_[task.op.fd] : -1;
+                        if (fd < 0) res = -EBADF;
+                    }
+                    if (res == 0 && task.op.bufIndex >= 0 && !inRegisteredBuffer(task.op)) {
+                        res = -EFAULT;
+                    }
+
+                    lock.unlock();
+                    if (res == 0) res = run(task.op, fd);
+                    complete(task.done, task.op.kind, res);
+                    lock.lock();
+                }
+            }
+
+            bool inRegisteredBuffer(const Op& op) const {
+                if (static_cast<std::size_t>(op.bufIndex) >= buffers_.size()) return false;
+                const auto& b = buffers_[op.bufIndex];
+                return op.buf >= b.data && op.len <= b.size &&
+                       static_cast<std::size_t>(op.buf - b.data) <= b.size - op.len;
+            }
+
+            static long run(const Op& op, int fd) {
+                for (;;) {
+                    long n;
+                    switch (op.kind) {
+#ifdef _WIN32
+                        case OpKind::Read:
+                            if (op.offset >= 0 && _lseeki64(fd, op.offset, SEEK_SET) < 0) return -errno;
+                            n = _read(fd, op.buf, static_cast<unsigned int>(op.len));
+                            break;
+                        case OpKind::Write:
+                            if (op.offset >= 0 && _lseeki64(fd, op.offset, SEEK_SET) < 0) return -errno;
+                            n = _write(fd, op.buf, static_cast<unsigned int>(op.len));
+                            break;
+                        case OpKind::Fsync:
+                            n = _commit(fd);
+                            break;
+#else
+                        case OpKind::Read:
+                            n = op.offset < 0 ? ::read(fd, op.buf, op.len)
+                                              : ::pread(fd, op.buf, op.len, static_cast<off_t>(op.offset));
+                            break;
+                        case OpKind::Write:
+                            n = op.offset < 0 ? ::write(fd, op.buf, op.len)
+                                              : ::pwrite(fd, op.buf, op.len, static_cast<off_t>(op.offset));
+                            break;
+                        case OpKind::Fsync:
+                            n = ::fsync(fd);
+                            break;
+#endif
+                        default:
+                            return -EINVAL;
+                    }
+                    if (n >= 0) return n;
+                    if (errno != EINTR) return -errno;
+                }
+            }
+
+            std::mutex mtx_;
+            std::condition_variable cv_;
+            std::deque<Task> queue_;
+            std::vector<std::thread> workers_;
+            io::MutableBuffers buffers_;
+            std::vector<int> files_;
+            bool stopping_ = false;
+        };
+
+#if defined(__linux__)
+
+        // ---- io_uring backend, on the raw system calls ----
+
+        int uringSetup(unsigned entries, io_uring_params* p) {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+        }
+
+        int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+        }
+
+        int uringRegister(int fd, unsigned opcode, const void* arg, unsigned nrArgs) {
+            return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+        }
+
+        // What a submission entry's user_data points to; 0 marks the wake-up NOP.
+        struct Pending {
+            Completion done;
+            OpKind kind;
+        };
+
+        template <typename T>
+        T loadAcquire(const T* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+
+        template <typename T>
+        void storeRelease(T* p, T v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+        class UringBackend final : public detail::Backend {
+        public:
+            // nullptr when the kernel refuses io_uring.
+            static std::unique_ptr<UringBackend> create(unsigned entries) {
+                std::unique_ptr<UringBackend> b(new UringBackend());
+                if (!b->init(entries)) return nullptr;
+                b->reaper_ = std::thread([raw = b.get()] { raw->reap(); });
+                return b;
+            }
+
+            ~UringBackend() override {
+                if (reaper_.joinable()) {
+                    std::unique_lock<std::mutex> lock(mtx_);
+                    space_.wait(lock, [this] { return inflight_ == 0; });
+                    stopping_ = true;
+                    // A NOP with user_data 0 wakes the reaper so it sees stopping_.
+                    if (io_uring_sqe* sqe = nextSqe()) {
+                        std::memset(sqe, 0, sizeof *sqe);
+                        sqe->opcode = IORING_OP_NOP;
+                        flush(lock);
+                    } else {
+                        sawWake_ = true;
+                    }
+                    lock.unlock();
+                    reaper_.join();
+                }
+                if (sqes_) ::munmap(sqes_, sqesLen_);
+                if (cqPtr_ && cqPtr_ != sqPtr_) ::munmap(cqPtr_, cqLen_);
+                if (sqPtr_) ::munmap(sqPtr_, sqLen_);
+                if (ringFd_ >= 0) ::close(ringFd_);
+            }
+
+            void submit(const Op* ops, const Completion* done, std::size_t count) override {
+                std::unique_lock<std::mutex> lock(mtx_);
+                for (std::size_t i = 0; i < count; ++i) {
+                    if (inflight_ >= cqEntries_) {
+                        // Keep the completion queue from overflowing.
+                        flush(lock);
+                        gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+                        space_.wait(lock, [this] { return inflight_ < cqEntries_; });
+                    }
+                    io_uring_sqe* sqe = nextSqe();
+                    if (!sqe) {
+                        flush(lock);
+                        sqe = nextSqe();
+                    }
+                    prepare(sqe, ops[i], new Pending{ done[i], ops[i].kind });
+                    ++inflight_;
+                }
+                flush(lock);
+            }
+
+            Result<void> registerBuffers(const io::MutableBuffers& bufs) override {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (buffersRegistered_) {
+                    uringRegister(ringFd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+                    buffersRegistered_ = false;
+                }
+                if (bufs.empty()) return Result<void>();
+                std::vector<iovec> iov;
+                iov.reserve(bufs.size());
+                for (const auto& b : bufs) iov.push_back({ b.data, b.size });
+                if (uringRegister(ringFd_, IORING_REGISTER_BUFFERS, iov.data(), static_cast<unsigned>(iov.size())) < 0) {
+                    return errnoResult("io_uring_register buffers", errno);
+                }
+                buffersRegistered_ = true;
+                return Result<void>();
+            }
+
+            Result<void> unregisterBuffers() override {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (!buffersRegistered_) return Result<void>();
+                buffersRegistered_ = false;
+                if (uringRegister(ringFd_, IORING_UNREGISTER_BUFFERS, nullptr, 0) < 0) {
+                    return errnoResult("io_uring_register buffers", errno);
+                }
+                return Result<void>();
+            }
+
+            Result<void> registerFiles(const std::vector<int>& fds) override {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (filesRegistered_) {
+                    uringRegister(ringFd_, IORING_UNREGISTER_FILES, nullptr, 0);
+                    filesRegistered_ = false;
+                }
+                if (fds.empty()) return Result<void>();
+                if (uringRegister(ringFd_, IORING_REGISTER_FILES, fds.data(), static_cast<unsigned>(fds.size())) < 0) {
+                    return errnoResult("io_uring_register files", errno);
+                }
+                filesRegistered_ = true;
+                return Result<void>();
+            }
+
+            Result<void> unregisterFiles() override {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (!filesRegistered_) return Result<void>();
+                filesRegistered_ = false;
+                if (uringRegister(ringFd_, IORING_UNREGISTER_FILES, nullptr, 0) < 0) {
+                    return errnoResult("io_uring_register files", errno);
+                }
+                return Result<void>();
+            }
+
+            bool usesIoUring() const override { return true; }
+
+        private:
+            UringBackend() = default;
+
+            bool init(unsigned entries) {
+                io_uring_params p;
+                std::memset(&p, 0, sizeof p);
+                ringFd_ = uringSetup(entries ? entries : 1, &p);
+                if (ringFd_ < 0) return false;
+
+                sqLen_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+                cqLen_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+                const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single) sqLen_ = cqLen_ = std::max(sqLen_, cqLen_);
+
+                sqPtr_ = ::mmap(nullptr, sqLen_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ringFd_, IORING_OFF_SQ_RING);
+                if (sqPtr_ == MAP_FAILED) {
+                    sqPtr_ = nullptr;
+                    return false;
+                }
+                if (single) {
+                    cqPtr_ = sqPtr_;
+                } else {
+                    cqPtr_ = ::mmap(nullptr, cqLen_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                    ringFd_, IORING_OFF_CQ_RING);
+                    if (cqPtr_ == MAP_FAILED) {
+                        cqPtr_ = nullptr;
+                        return false;
+                    }
+                }
+                sqesLen_ = p.sq_entries * sizeof(io_uring_sqe);
+                void* sqes = ::mmap(nullptr, sqesLen_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                    ringFd_, IORING_OFF_SQES);
+                if (sqes == MAP_FAILED) return false;
+                sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+                auto* sq = static_cast<char*>(sqPtr_);
+                sqHead_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+                sqTail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+                sqMask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+                sqArray_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+                sqEntries_ = p.sq_entries;
+
+                auto* cq = static_cast<char*>(cqPtr_);
+                cqHead_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+                cqTail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+                cqMask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+                cqEntries_ = p.cq_entries;
+
+                localTail_ = *sqTail_;
+                submittedTail_ = localTail_;
+                return true;
+            }
+
+            // Next free submission entry, or nullptr when the ring is full.
+            // Caller holds mtx_.
+            io_uring_sqe* nextSqe() {
+                if (localTail_ - loadAcquire(sqHead_) >= sqEntries_) return nullptr;
+                const unsigned idx = localTail_ & sqMask_;
+                sqArray_[idx] = idx;
+                ++localTail_;
+                return &sqes_[idx];
+            }
+
+            static void prepare(io_uring_sqe* sqe, const Op& op, Pending* user) {
+                std::memset(sqe, 0, sizeof *sqe);
+                sqe->fd = op.fd;
+                sqe->user_data = reinterpret_cast<uint64_t>(user);
+                if (op.fixedFile) sqe->flags |= IOSQE_FIXED_FILE;
+                switch (op.kind) {
+                    case OpKind::Read:
+                    case OpKind::Write: {
+                        const bool read = op.kind == OpKind::Read;
+                        if (op.bufIndex >= 0) {
+                            sqe->opcode = read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+                            sqe->buf_index = static_cast<uint16_t>(op.bufIndex);
+                        } else {
+                            sqe->opcode = read ? IORING_OP_READ : IORING_OP_WRITE;
+                        }
+                        sqe->addr = reinterpret_cast<uint64_t>(op.buf);
+                        sqe->len = static_cast<uint32_t>(std::min<std::size_t>(op.len, 0x7ffff000));
+                        sqe->off = op.offset < 0 ? static_cast<uint64_t>(-1) : static_cast<uint64_t>(op.offset);
+                        break;
+                    }
+                    case OpKind::Fsync:
+                        sqe->opcode = IORING_OP_FSYNC;
+                        break;
+                }
+            }
+
+            // Publishes prepared entries and hands them to the kernel with one
+            // io_uring_enter. Caller holds mtx_.
+            void flush(std::unique_lock<std::mutex>&) {
+                if (localTail_ == submittedTail_) return;
+                storeRelease(sqTail_, localTail_);
+                unsigned pending = localTail_ - submittedTail_;
+                while (pending > 0) {
+                    const int n = uringEnter(ringFd_, pending, 0, 0);
+                    if (n < 0) {
+                        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                            std::this_thread::yield();
+                            continue;
+                        }
+                        failUnsubmitted(errno);
+                        return;
+                    }
+                    pending -= static_cast<unsigned>(n);
+                    submittedTail_ += static_cast<unsigned>(n);
+                }
+            }
+
+            // The kernel rejected the ring itself: take back the entries it
+            // did not consume and fail their operations.
+            void failUnsubmitted(int err) {
+                const unsigned head = loadAcquire(sqHead_);
+                for (unsigned i = head; i != localTail_; ++i) {
+                    io_uring_sqe* sqe = &sqes_[sqArray_[i & sqMask_]];
+                    if (auto* pending = reinterpret_cast<Pending*>(sqe->user_data)) {
+                        complete(pending->done, pending->kind, -err);
+                        delete pending;
+                        --inflight_;
+                    }
+                }
+                localTail_ = submittedTail_ = head;
+                storeRelease(sqTail_, head);
+                space_.notify_all();
+            }
+
+            void reap() {
+                for (;;) {
+                    unsigned head = *cqHead_;
+                    const unsigned tail = loadAcquire(cqTail_);
+                    if (head == tail) {
+                        {
+                            std::lock_guard<std::mutex> lock(mtx_);
+                            if (stopping_ && inflight_ == 0 && sawWake_) return;
+                        }
+                        const int n = uringEnter(ringFd_, 0, 1, IORING_ENTER_GETEVENTS);
+                        if (n < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) return;
+                        continue;
+                    }
+
+                    std::size_t finished = 0;
+                    for (; head != tail; ++head) {
+                        const io_uring_cqe& cqe = cqes_[head & cqMask_];
+                        auto* pending = reinterpret_cast<Pending*>(cqe.user_data);
+                        if (!pending) {
+                            std::lock_guard<std::mutex> lock(mtx_);
+                            sawWake_ = true;
+                            continue;
+                        }
+                        complete(pending->done, pending->kind, cqe.res);
+                        delete pending;
+                        ++finished;
+                    }
+                    storeRelease(cqHead_, head);
+
+                    if (finished) {
+                        std::lock_guard<std::mutex> lock(mtx_);
+                        inflight_ -= finished;
+                    }
+                    space_.notify_all();
+                }
+            }
+
+            int ringFd_ = -1;
+            void* sqPtr_ = nullptr;
+            void* cqPtr_ = nullptr;
+            std::size_t sqLen_ = 0;
+            std::size_t cqLen_ = 0;
+            io_uring_sqe* sqes_ = nullptr;
+            std::size_t sqesLen_ = 0;
+
+            unsigned* sqHead_ = nullptr;
+            unsigned* sqTail_ = nullptr;
+            unsigned* sqArray_ = nullptr;
+            unsigned sqMask_ = 0;
+            unsigned sqEntries_ = 0;
+            unsigned localTail_ = 0;      // entries prepared
+            unsigned submittedTail_ = 0;  // entries handed to the kernel
+
+            unsigned* cqHead_ = nullptr;
+            unsigned* cqTail_ = nullptr;
+            io_uring_cqe* cqes_ = nullptr;
+            unsigned cqMask_ = 0;
+            unsigned cqEntries_ = 0;
+
+            std::mutex mtx_;
+            std::condition_variable space_;
+            std::size_t inflight_ = 0;
+            bool stopping_ = false;
+            bool sawWake_ = false;
+            bool buffersRegistered_ = false;
+            bool filesRegistered_ = false;
+            std::thread reaper_;
+        };
+
+#endif // __linux__
+
+    } // namespace
+
+    // ---- Engine ----
+
+    Engine::Engine(Options opts) {
+#if defined(__linux__)
+        if (!opts.forceThreadPool) impl_ = UringBackend::create(opts.entries);
+#endif
+        if (!impl_) impl_ = std::make_unique<PoolBackend>(opts.threads);
+    }
+
+    Engine::~Engine() = default;
+
+    Engine& Engine::Default() {
+        // Leaked so operations submitted during static destruction still complete.
+        static Engine* engine = new Engine();
+        return *engine;
+    }
+
+    Completion Engine::Submit(const Op& op) {
+        Completion done = base::Chan<Result<std::size_t>>::Make(1);
+        impl_->submit(&op, &done, 1);
+        return done;
+    }
+
+    std::vector<Completion> Engine::Submit(const std::vector<Op>& ops) {
+        std::vector<Completion> done;
+        done.reserve(ops.size());
+        for (std::size_t i = 0; i < ops.size(); ++i) {
+            done.push_back(base::Chan<Result<std::size_t>>::Make(1));
+        }
+        if (!ops.empty()) impl_->submit(ops.data(), done.data(), ops.size());
+        return done;
+    }
+
+    Result<void> Engine::RegisterBuffers(const io::MutableBuffers& bufs) { return impl_->registerBuffers(bufs); }
+    Result<void> Engine::UnregisterBuffers() { return impl_->unregisterBuffers(); }
+    Result<void> Engine::RegisterFiles(const std::vector<int>& fds) { return impl_->registerFiles(fds); }
+    Result<void> Engine::UnregisterFiles() { return impl_->unregisterFiles(); }
+
+    bool Engine::UsesIoUring() const { return impl_->usesIoUring(); }
+
+} // namespace gocxx::aio
@@ -0,0 +1,102 @@
+#include <gocxx/arena/arena.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+namespace gocxx::arena {
+
+    namespace {
+        constexpr std::size_t kHeaderSize =
+            (sizeof(void*) + sizeof(std::size_t) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+        char* alignUp(char* p, std::size_t alignment) {
+            const auto v = reinterpret_cast<std::uintptr_t>(p);
+            return p + ((alignment - (v & (alignment - 1))) & (alignment - 1));
+        }
+    }
+
+    Arena::Arena(std::size_t blockSize, std::pmr::memory_resource* upstream, std::size_t maxRetained)
+        : upstream_(upstream), blockSize_(blockSize), maxRetained_(maxRetained), nextSize_(blockSize) {
+        if (blockSize == 0 || !upstream) {
+            throw std::invalid_argument("arena: block size must be positive and upstream non-null");
+        }
+    }
+
+    Arena::~Arena() {
+        freeBlocks(head_);
+    }
+
+    void* Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+        if (cur_) {
+            char* p = alignUp(cur_, alignment);
+            if (p <= end_ && static_cast<std::size_t>(end_ - p) >= bytes) {
+                cur_ = p + bytes;
+                return p;
+            }
+        }
+        return grow(bytes, alignment);
+    }
+
+    void* Arena::grow(std::size_t bytes, std::size_t alignment) {
+        const std::size_t size = std::max(nextSize_, bytes + alignment);
+        nextSize_ = std::min(nextSize_ * 2, blockSize_ * 64);
+        Block* b = newBlock(size);
+        used_ += static_cast<std::size_t>(cur_ - begin_);
+        b->next = head_;
+        enter(b);
+        char* p = alignUp(cur_, alignment);
+        cur_ = p + bytes;
+        return p;
+    }
+
+    Arena::Block* Arena::newBlock(std::size_t size) {
+        void* mem = upstream_->allocate(kHeaderSize + size, alignof(std::max_align_t));
+        capacity_ += size;
+        return new (mem) Block{nullptr, size};
+    }
+
+    void Arena::freeBlocks(Block* b) {
+        while (b) {
+            Block* next = b->next;
+            capacity_ -= b->size;
+            upstream_->deallocate(b, kHeaderSize + b->size, alignof(std::max_align_t));
+            b = next;
+        }
+    }
+
+    void Arena::enter(Block* b) {
+        head_ = b;
+        begin_ = reinterpret_cast<char*>(b) + kHeaderSize;
+        cur_ = begin_;
+        end_ = begin_ + b->size;
+    }
+
+    void Arena::Reset() {
+        used_ = 0;
+        if (!head_) {
+            return;
+        }
+        if (!head_->next && head_->size <= maxRetained_) {
+            cur_ = begin_;
+            return;
+        }
+        // Several blocks (or one too large to keep): one block for all of it next time
+        const std::size_t size = std::min(capacity_, maxRetained_);
+        Release();
+        if (size >= blockSize_) {
+            enter(newBlock(size));
+            nextSize_ = std::min(size, blockSize_ * 64);
+        }
+    }
+
+    void Arena::Release() {
+        freeBlocks(head_);
+        head_ = nullptr;
+        begin_ = cur_ = end_ = nullptr;
+        used_ = 0;
+        nextSize_ = blockSize_;
+    }
+
+} // namespace gocxx::arena
@@ -0,0 +1,507 @@
+#include "gocxx/bufio/bufio.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace gocxx::bufio {
+
+    using gocxx::base::Result;
+
+    namespace {
+        constexpr std::size_t kMinReadBufferSize = 16;
+        constexpr int kMaxConsecutiveEmptyTokens = 100;
+
+        bool isEOF(const std::shared_ptr<errors::Error>& err) {
+            return errors::Is(err, io::ErrEOF);
+        }
+
+        std::string_view dropCR(std::string_view s) {
+            if (!s.empty() && s.back() == '\r') s.remove_suffix(1);
+            return s;
+        }
+
+        bool isSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+        }
+    }
+
+    // --- Reader ---
+
+    Reader::Reader(std::shared_ptr<io::Reader> rd, std::size_t size)
+        : rd_(std::move(rd)), buf_(std::max(size, kMinReadBufferSize)) {}
+
+    void Reader::Reset(std::shared_ptr<io::Reader> rd) {
+        rd_ = std::move(rd);
+        r_ = w_ = 0;
+        err_ = nullptr;
+        lastByte_ = -1;
+    }
+
+    void Reader::fill() {
+        // Slide existing data to the front to make room at the end.
+        if (r_ > 0) {
+            std::memmove(buf_.data(), buf_.data() + r_, w_ - r_);
+            w_ -= r_;
+            r_ = 0;
+        }
+        if (w_ >= buf_.size()) return;
+
+        auto res = rd_->Read(buf_.data() + w_, buf_.size() - w_);
+        w_ += std::min(res.value, buf_.size() - w_);
+        if (res.Failed()) {
+            err_ = res.err;
+        } else if (res.value == 0) {
+            err_ = io::ErrEOF;
+        }
+    }
+
+    std::shared_ptr<errors::Error> Reader::takeError() {
+        auto err = std::move(err_);
+        err_ = nullptr;
+        return err;
+    }
+
+    Result<std::size_t> Reader::Read(uint8_t* buffer, std::size_t size) {
+        if (size == 0) {
+            if (Buffered() > 0) return { 0 };
+            return { 0, takeError() };
+        }
+        if (r_ == w_) {
+            if (err_) return { 0, takeError() };
+            if (size >= buf_.size()) {
+                // Large read into an empty buffer: skip the copy.
+                auto res = rd_->Read(buffer, size);
+                if (res.value > 0) {
+                    lastByte_ = buffer[res.value - 1];
+                } else if (res.Ok()) {
+                    return { 0, io::ErrEOF };
+                }
+                return res;
+            }
+            r_ = w_ = 0;
+            fill();
+            if (r_ == w_) return { 0, takeError() };
+        }
+
+        const std::size_t n = std::min(size, w_ - r_);
+        std::memcpy(buffer, buf_.data() + r_, n);
+        r_ += n;
+        lastByte_ = buf_[r_ - 1];
+        return { n };
+    }
+
+    Result<std::size_t> Reader::ReadByte(uint8_t& outByte) {
+        while (r_ == w_) {
+            if (err_) return { 0, takeError() };
+            fill();
+        }
+        outByte = buf_[r_++];
+        lastByte_ = outByte;
+        return { 1 };
+    }
+
+    Result<void> Reader::UnreadByte() {
+        if (lastByte_ < 0 || (r_ == 0 && w_ > 0)) {
+            return Result<void>(ErrInvalidUnreadByte);
+        }
+        if (r_ > 0) {
+            --r_;
+        } else {
+            w_ = 1;  // buffer is empty: put the byte back as its only content
+        }
+        buf_[r_] = static_cast<uint8_t>(lastByte_);
+        lastByte_ = -1;
+        return Result<void>();
+    }
+
+    Result<std::string_view> Reader::Peek(std::size_t n) {
+        lastByte_ = -1;
+        while (w_ - r_ < n && w_ - r_ < buf_.size() && !err_) {
+            fill();
+        }
+        if (n > buf_.size()) {
+            return { view(r_, w_), ErrBufferFull };
+        }
+        if (w_ - r_ < n) {
+            auto err = takeError();
+            return { view(r_, w_), err ? err : ErrBufferFull };
+        }
+        return { view(r_, r_ + n) };
+    }
+
+    Result<std::string_view> Reader::ReadSlice(char delim) {
+        std::size_t searched = 0;  // bytes after r_ already known not to hold delim
+        std::string_view line;
+        std::shared_ptr<errors::Error> err;
+        for (;;) {
+            const uint8_t* begin = buf_.data() + r_ + searched;
+            const void* hit = std::memchr(begin, static_cast<unsigned char>(delim), w_ - r_ - searched);
+            if (hit) {
+                const std::size_t end = static_cast<const uint8_t*>(hit) - buf_.data() + 1;
+                line = view(r_, end);
+                r_ = end;
+                break;
+            }
+            if (err_) {
+                line = view(r_, w_);
+                r_ = w_;
+                err = takeError();
+                break;
+            }
+            if (Buffered() >= buf_.size()) {
+                line = view(r_, w_);
+                r_ = w_;
+                err = ErrBufferFull;
+                break;
+            }
+            searched = w_ - r_;
+            fill();
+        }
+        if (!line.empty()) {
+            lastByte_ = static_cast<uint8_t>(line.back());
+        }
+        return { line, err };
+    }
+
+    Result<std::string_view> Reader::ReadLine(bool* isPrefix) {
+        auto res = ReadSlice('\n');
+        if (errors::Is(res.err, ErrBufferFull)) {
+            std::string_view line = res.value;
+            // Keep a trailing '\r' back in case the '\n' comes next.
+            if (!line.empty() && line.back() == '\r' && r_ > 0) {
+                --r_;
+                line.remove_suffix(1);
+            }
+            if (isPrefix) *isPrefix = true;
+            return { line };
+        }
+        if (isPrefix) *isPrefix = false;
+        if (res.value.empty()) {
+            return { std::string_view(), res.err };
+        }
+
+        std::string_view line = res.value;
+        if (line.back() == '\n') {
+            line.remove_suffix(1);
+            line = dropCR(line);
+        }
+        return { line };
+    }
+
+    Result<std::string> Reader::ReadString(char delim) {
+        std::string out;
+        for (;;) {
+            auto res = ReadSlice(delim);
+            out.append(res.value.data(), res.value.size());
+            if (!errors::Is(res.err, ErrBufferFull)) {
+                return { std::move(out), res.err };
+            }
+        }
+    }
+
+    Result<std::size_t> Reader::WriteTo(std::shared_ptr<io::Writer> w) {
+        lastByte_ = -1;
+        std::size_t total = 0;
+        auto flushBuffer = [&]() -> std::shared_ptr<errors::Error> {
+            while (r_ < w_) {
+                auto res = w->Write(buf_.data() + r_, w_ - r_);
+                const std::size_t n = std::min(res.value, w_ - r_);
+                r_ += n;
+                total += n;
+                if (res.Failed()) return res.err;
+                if (n == 0) return io::ErrShortWrite;
+            }
+            return nullptr;
+        };
+
+        if (auto err = flushBuffer()) return { total, err };
+        if (err_) {
+            auto err = takeError();
+            return { total, isEOF(err) ? nullptr : err };
+        }
+
+        if (auto* wt = dynamic_cast<io::WriterTo*>(rd_.get())) {
+            auto res = wt->WriteTo(w);
+            return { total + res.value, res.err };
+        }
+        if (auto* rf = dynamic_cast<io::ReaderFrom*>(w.get())) {
+            auto res = rf->ReadFrom(rd_);
+            return { total + res.value, res.err };
+        }
+
+        for (;;) {
+            r_ = w_ = 0;
+            fill();
+            if (auto err = flushBuffer()) return { total, err };
+            if (err_) {
+                auto err = takeError();
+                return { total, isEOF(err) ? nullptr : err };
+            }
+        }
+    }
+
+    Result<std::size_t> Reader::Discard(std::size_t n) {
+        lastByte_ = -1;
+        std::size_t remaining = n;
+        for (;;) {
+            const std::size_t skip = std::min(Buffered(), remaining);
+            r_ += skip;
+            remaining -= skip;
+            if (remaining == 0) return { n };
+            if (err_) return { n - remaining, takeError() };
+            fill();
+        }
+    }
+
+    // --- Writer ---
+
+    Writer::Writer(std::shared_ptr<io::Writer> wr, std::size_t size)
+        : wr_(std::move(wr)), buf_(size > 0 ? size : kDefaultBufSize) {}
+
+    void Writer::Reset(std::shared_ptr<io::Writer> wr) {
+        wr_ = std::move(wr);
+        n_ = 0;
+        err_ = nullptr;
+    }
+
+    Result<void> Writer::Flush() {
+        if (err_) return Result<void>(err_);
+        if (n_ == 0) return Result<void>();
+
+        auto res = wr_->Write(buf_.data(), n_);
+        const std::size_t written = std::min(res.value, n_);
+        if (written < n_ && res.Ok()) {
+            res.err = io::ErrShortWrite;
+        }
+        if (res.Failed()) {
+            // Keep the unwritten tail buffered, as Go does.
+            std::memmove(buf_.data(), buf_.data() + written, n_ - written);
+            n_ -= written;
+            err_ = res.err;
+            return Result<void>(err_);
+        }
+        n_ = 0;
+        return Result<void>();
+    }
+
+    Result<std::size_t> Writer::Write(const uint8_t* buffer, std::size_t size) {
+        std::size_t total = 0;
+        while (size > Available() && !err_) {
+            std::size_t n;
+            if (Buffered() == 0) {
+                // Large write into an empty buffer: skip the copy.
+                auto res = wr_->Write(buffer, size);
+                n = std::min(res.value, size);
+                if (res.Failed()) {
+                    err_ = res.err;
+                } else if (n < size) {
+                    err_ = io::ErrShortWrite;
+                }
+            } else {
+                n = Available();
+                std::memcpy(buf_.data() + n_, buffer, n);
+                n_ += n;
+                Flush();
+            }
+            total += n;
+            buffer += n;
+            size -= n;
+        }
+        if (err_) return { total, err_ };
+
+        std::memcpy(buf_.data() + n_, buffer, size);
+        n_ += size;
+        return { total + size };
+    }
+
+    Result<std::size_t> Writer::WriteByte(uint8_t byte) {
+        if (err_) return { 0, err_ };
+        if (Available() == 0 && Flush().Failed()) return { 0, err_ };
+        buf_[n_++] = byte;
+        return { 1 };
+    }
+
+    Result<std::size_t> Writer::WriteString(std::string_view s) {
+        return Write(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    }
+
+    Result<std::size_t> Writer::ReadFrom(std::shared_ptr<io::Reader> src) {
+        if (err_) return { 0, err_ };
+        if (n_ == 0) {
+            if (auto* rf = dynamic_cast<io::ReaderFrom*>(wr_.get())) {
+                auto res = rf->ReadFrom(std::move(src));
+                err_ = res.err;
+                return res;
+            }
+        }
+        std::size_t total = 0;
+        for (;;) {
+            if (Available() == 0 && Flush().Failed()) {
+                return { total, err_ };
+            }
+            auto res = src->Read(buf_.data() + n_, Available());
+            const std::size_t n = std::min(res.value, Available());
+            n_ += n;
+            total += n;
+            if (res.Failed()) {
+                if (isEOF(res.err)) break;
+                return { total, res.err };
+            }
+            if (n == 0) break;
+        }
+        return { total };
+    }
+
+    // --- Split functions ---
+
+    Result<std::size_t> ScanLines(std::string_view data, bool atEOF, std::optional<std::string_view>& token) {
+        if (atEOF && data.empty()) return { 0 };
+        const std::size_t i = data.find('\n');
+        if (i != std::string_view::npos) {
+            token = dropCR(data.substr(0, i));
+            return { i + 1 };
+        }
+        if (atEOF) {
+            token = dropCR(data);
+            return { data.size() };
+        }
+        return { 0 };
+    }
+
+    Result<std::size_t> ScanBytes(std::string_view data, bool, std::optional<std::string_view>& token) {
+        if (data.empty()) return { 0 };
+        token = data.substr(0, 1);
+        return { 1 };
+    }
+
+    Result<std::size_t> ScanRunes(std::string_view data, bool atEOF, std::optional<std::string_view>& token) {
+        if (data.empty()) return { 0 };
+
+        const auto lead = static_cast<unsigned char>(data[0]);
+        std::size_t need = 1;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            need = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            need = 3;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            need = 4;
+        }
+        for (std::size_t i = 1; i < need && i < data.size(); ++i) {
+            const auto c = static_cast<unsigned char>(data[i]);
+            if (c < 0x80 || c > 0xBF) {
+                need = 1;  // invalid sequence: pass the lead byte through alone
+                break;
+            }
+        }
+        if (need > data.size()) {
+            if (!atEOF) return { 0 };  // wait for the rest of the code point
+            need = 1;
+        }
+        token = data.substr(0, need);
+        return { need };
+    }
+
+    Result<std::size_t> ScanWords(std::string_view data, bool atEOF, std::optional<std::string_view>& token) {
+        std::size_t start = 0;
+        while (start < data.size() && isSpace(data[start])) ++start;
+        for (std::size_t i = start; i < data.size(); ++i) {
+            if (isSpace(data[i])) {
+                token = data.substr(start, i - start);
+                return { i + 1 };
+            }
+        }
+        if (atEOF && data.size() > start) {
+            token = data.substr(start);
+            return { data.size() };
+        }
+        return { start };  // consume the leading spaces and ask for more
+    }
+
+    // --- Scanner ---
+
+    Scanner::Scanner(std::shared_ptr<io::Reader> rd) : rd_(std::move(rd)), split_(ScanLines) {}
+
+    void Scanner::Split(SplitFunc split) {
+        if (scanCalled_) throw std::logic_error("bufio.Scanner: Split called after Scan");
+        split_ = std::move(split);
+    }
+
+    void Scanner::Buffer(std::size_t initialSize, std::size_t maxTokenSize) {
+        if (scanCalled_) throw std::logic_error("bufio.Scanner: Buffer called after Scan");
+        buf_.assign(std::max<std::size_t>(initialSize, 1), 0);
+        maxTokenSize_ = maxTokenSize;
+    }
+
+    bool Scanner::Scan() {
+        if (done_) return false;
+        scanCalled_ = true;
+
+        for (;;) {
+            if (end_ > start_ || eof_) {
+                std::optional<std::string_view> token;
+                const std::string_view data(reinterpret_cast<const char*>(buf_.data()) + start_, end_ - start_);
+                auto res = split_(data, eof_, token);
+                if (res.Failed()) {
+                    done_ = true;
+                    if (errors::Is(res.err, ErrFinalToken)) {
+                        token_ = token.value_or(std::string_view());
+                        return token.has_value();
+                    }
+                    err_ = res.err;
+                    return false;
+                }
+                if (res.value > data.size()) {
+                    err_ = ErrAdvanceTooFar;
+                    done_ = true;
+                    return false;
+                }
+                start_ += res.value;
+                if (token) {
+                    token_ = *token;
+                    if (res.value > 0) {
+                        emptyTokens_ = 0;
+                    } else if (++emptyTokens_ > kMaxConsecutiveEmptyTokens) {
+                        err_ = io::ErrNoProgress;
+                        done_ = true;
+                        return false;
+                    }
+                    return true;
+                }
+            }
+
+            if (eof_) {
+                start_ = end_ = 0;
+                token_ = std::string_view();
+                done_ = true;
+                return false;
+            }
+
+            // Need more data: make room, growing the buffer if a token fills it.
+            if (start_ > 0 && (end_ == buf_.size() || start_ > buf_.size() / 2)) {
+                std::memmove(buf_.data(), buf_.data() + start_, end_ - start_);
+                end_ -= start_;
+                start_ = 0;
+            }
+            if (end_ == buf_.size()) {
+                if (buf_.size() >= maxTokenSize_) {
+                    err_ = ErrTooLong;
+                    done_ = true;
+                    return false;
+                }
+                const std::size_t grown = buf_.empty() ? kDefaultBufSize : buf_.size() * 2;
+                buf_.resize(std::min(grown, maxTokenSize_));
+            }
+
+            auto res = rd_->Read(buf_.data() + end_, buf_.size() - end_);
+            end_ += std::min(res.value, buf_.size() - end_);
+            if (res.Failed()) {
+                if (!isEOF(res.err)) err_ = res.err;
+                eof_ = true;
+            } else if (res.value == 0) {
+                eof_ = true;
+            }
+        }
+    }
+
+} // namespace gocxx::bufio
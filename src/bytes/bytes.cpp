@@ -0,0 +1,240 @@
+#include "gocxx/bytes/bytes.h"
+
+#include <gocxx/sync/pool.h>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace gocxx::bytes {
+
+    using gocxx::base::Result;
+
+    namespace {
+        constexpr unsigned kMinClassShift = 6;   // 64 bytes
+        constexpr unsigned kMaxClassShift = 20;  // 1 MiB
+        constexpr std::size_t kClassCount = kMaxClassShift - kMinClassShift + 1;
+
+        using Block = std::unique_ptr<uint8_t[]>;
+        using BlockPool = sync::UniquePool<uint8_t[], std::default_delete<uint8_t[]>>;
+
+        // One pool per power-of-two size; leaked so Buffers destroyed during
+        // static destruction can still hand their storage back.
+        BlockPool& poolFor(unsigned shift) {
+            static BlockPool* pools = [] {
+                auto* p = static_cast<BlockPool*>(::operator new(sizeof(BlockPool) * kClassCount));
+                for (std::size_t i = 0; i < kClassCount; ++i) new (&p[i]) BlockPool(nullptr);
+                return p;
+            }();
+            return pools[shift - kMinClassShift];
+        }
+
+        unsigned classShift(std::size_t n) {
+            unsigned shift = kMinClassShift;
+            while ((std::size_t(1) << shift) < n) ++shift;
+            return shift;
+        }
+    }
+
+    namespace detail {
+        uint8_t* allocateBlock(std::size_t n, std::size_t& cap) {
+            if (n > (std::size_t(1) << kMaxClassShift)) {
+                cap = n;
+                return new uint8_t[n];
+            }
+            const unsigned shift = classShift(n);
+            cap = std::size_t(1) << shift;
+            if (Block b = poolFor(shift).Get()) return b.release();
+            return new uint8_t[cap];
+        }
+
+        void releaseBlock(uint8_t* p, std::size_t cap) {
+            if (!p) return;
+            const bool pooled = cap <= (std::size_t(1) << kMaxClassShift) && (cap & (cap - 1)) == 0 &&
+                                cap >= (std::size_t(1) << kMinClassShift);
+            if (!pooled) {
+                delete[] p;
+                return;
+            }
+            poolFor(classShift(cap)).Put(Block(p));
+        }
+    }
+
+    Buffer::Buffer(std::string_view initial) {
+        WriteString(initial);
+    }
+
+    Buffer::~Buffer() {
+        detail::releaseBlock(buf_, cap_);
+    }
+
+    Buffer::Buffer(Buffer&& other) noexcept
+        : buf_(other.buf_), cap_(other.cap_), off_(other.off_), end_(other.end_), canUnread_(other.canUnread_) {
+        other.buf_ = nullptr;
+        other.cap_ = other.off_ = other.end_ = 0;
+        other.canUnread_ = false;
+    }
+
+    Buffer& Buffer::operator=(Buffer&& other) noexcept {
+        if (this != &other) {
+            detail::releaseBlock(buf_, cap_);
+            buf_ = other.buf_;
+            cap_ = other.cap_;
+            off_ = other.off_;
+            end_ = other.end_;
+            canUnread_ = other.canUnread_;
+            other.buf_ = nullptr;
+            other.cap_ = other.off_ = other.end_ = 0;
+            other.canUnread_ = false;
+        }
+        return *this;
+    }
+
+    void Buffer::Truncate(std::size_t n) {
+        if (n > Len()) throw std::out_of_range("bytes.Buffer: truncation out of range");
+        canUnread_ = false;
+        if (n == 0) {
+            off_ = end_ = 0;
+            return;
+        }
+        end_ = off_ + n;
+    }
+
+    void Buffer::Release() {
+        detail::releaseBlock(buf_, cap_);
+        buf_ = nullptr;
+        cap_ = off_ = end_ = 0;
+        canUnread_ = false;
+    }
+
+    uint8_t* Buffer::grow(std::size_t n) {
+        canUnread_ = false;
+        if (Len() == 0 && off_ != 0) off_ = end_ = 0;
+        if (n <= cap_ - end_) return buf_ + end_;
+
+        const std::size_t len = Len();
+        if (n > SIZE_MAX - len) throw std::length_error("bytes.Buffer: too large");
+        // Slide the unread bytes down when the result is at most half full;
+        // otherwise move to a block at least twice the size.
+        if (len + n <= cap_ / 2) {
+            std::memmove(buf_, buf_ + off_, len);
+        } else {
+            const std::size_t want = std::max(len + n, cap_ <= SIZE_MAX / 2 ? cap_ * 2 : cap_);
+            std::size_t newCap = 0;
+            uint8_t* fresh = detail::allocateBlock(want, newCap);
+            if (len) std::memcpy(fresh, buf_ + off_, len);
+            detail::releaseBlock(buf_, cap_);
+            buf_ = fresh;
+            cap_ = newCap;
+        }
+        off_ = 0;
+        end_ = len;
+        return buf_ + end_;
+    }
+
+    void Buffer::Grow(std::size_t n) {
+        grow(n);
+    }
+
+    Result<std::size_t> Buffer::Write(const uint8_t* buffer, std::size_t size) {
+        if (size == 0) {
+            canUnread_ = false;
+            return { 0 };
+        }
+        std::memcpy(grow(size), buffer, size);
+        end_ += size;
+        return { size };
+    }
+
+    Result<std::size_t> Buffer::WriteByte(uint8_t byte) {
+        *grow(1) = byte;
+        ++end_;
+        return { 1 };
+    }
+
+    Result<std::size_t> Buffer::WriteString(std::string_view s) {
+        return Write(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    }
+
+    Result<std::size_t> Buffer::Read(uint8_t* buffer, std::size_t size) {
+        canUnread_ = false;
+        if (Len() == 0) {
+            off_ = end_ = 0;
+            if (size == 0) return { 0 };
+            return { 0, io::ErrEOF };
+        }
+        const std::size_t n = std::min(size, Len());
+        std::memcpy(buffer, buf_ + off_, n);
+        off_ += n;
+        canUnread_ = n > 0;
+        return { n };
+    }
+
+    Result<std::size_t> Buffer::ReadByte(uint8_t& outByte) {
+        if (Len() == 0) {
+            off_ = end_ = 0;
+            canUnread_ = false;
+            return { 0, io::ErrEOF };
+        }
+        outByte = buf_[off_++];
+        canUnread_ = true;
+        return { 1 };
+    }
+
+    Result<void> Buffer::UnreadByte() {
+        if (!canUnread_ || off_ == 0) return Result<void>(ErrUnreadByte);
+        canUnread_ = false;
+        --off_;
+        return Result<void>();
+    }
+
+    std::string_view Buffer::Next(std::size_t n) {
+        const std::size_t take = std::min(n, Len());
+        std::string_view view(reinterpret_cast<const char*>(buf_) + off_, take);
+        off_ += take;
+        canUnread_ = take > 0;
+        return view;
+    }
+
+    Result<std::string> Buffer::ReadString(char delim) {
+        const std::string_view rest = Bytes();
+        const std::size_t pos = rest.find(delim);
+        const std::size_t take = pos == std::string_view::npos ? rest.size() : pos + 1;
+        std::string out(Next(take));
+        if (pos == std::string_view::npos) return { std::move(out), io::ErrEOF };
+        return { std::move(out) };
+    }
+
+    Result<std::size_t> Buffer::WriteTo(std::shared_ptr<io::Writer> w) {
+        canUnread_ = false;
+        std::size_t total = 0;
+        while (Len() > 0) {
+            auto res = w->Write(buf_ + off_, Len());
+            const std::size_t n = std::min(res.value, Len());
+            off_ += n;
+            total += n;
+            if (res.Failed()) return { total, res.err };
+            if (n == 0) return { total, io::ErrShortWrite };
+        }
+        off_ = end_ = 0;
+        return { total };
+    }
+
+    Result<std::size_t> Buffer::ReadFrom(std::shared_ptr<io::Reader> r) {
+        std::size_t total = 0;
+        for (;;) {
+            uint8_t* tail = grow(kMinRead);
+            auto res = r->Read(tail, cap_ - end_);
+            const std::size_t n = std::min(res.value, cap_ - end_);
+            end_ += n;
+            total += n;
+            if (res.Failed()) {
+                if (errors::Is(res.err, io::ErrEOF)) return { total };
+                return { total, res.err };
+            }
+            if (n == 0) return { total };
+        }
+    }
+
+} // namespace gocxx::bytes
@@ -7,6 +7,10 @@
 #include <gocxx/base/result.h>
 #include <gocxx/time/time.h>
 #include <gocxx/errors/errors.h>
+#include <gocxx/base/select.h>
+#include <gocxx/runtime/blocking.h>
+#include <gocxx/runtime/runtime.h>
+#include <gocxx/time/timer.h>
 #include <thread>
 #include <algorithm>
 
@@ -17,11 +21,85 @@ namespace context {
 const std::string Canceled = "context canceled";
 const std::string DeadlineExceeded = "context deadline exceeded";
 
+// Typed values
+
+namespace detail {
+
+std::size_t nextContextKeyId() {
+    static std::atomic<std::size_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+const void* ValueMap::find(std::size_t id) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), id,
+                               [](const Entry& e, std::size_t key) { return e.id < key; });
+    if (it == entries_.end() || it->id != id) {
+        return nullptr;
+    }
+    return it->value.get();
+}
+
+std::shared_ptr<const ValueMap> ValueMap::with(const std::shared_ptr<const ValueMap>& base, std::size_t id,
+                                               std::shared_ptr<const void> value) {
+    auto map = std::make_shared<ValueMap>();
+    if (base) {
+        map->entries_.reserve(base->entries_.size() + 1);
+        map->entries_.insert(map->entries_.end(), base->entries_.begin(), base->entries_.end());
+    }
+    auto it = std::lower_bound(map->entries_.begin(), map->entries_.end(), id,
+                               [](const Entry& e, std::size_t key) { return e.id < key; });
+    if (it != map->entries_.end() && it->id == id) {
+        it->value = std::move(value);  // the innermost WithValue wins, as in Go
+    } else {
+        map->entries_.insert(it, Entry{id, std::move(value)});
+    }
+    return map;
+}
+
+} // namespace detail
+
+// Context default implementation
+
+bool Context::WaitFor(gocxx::time::Duration timeout) const {
+    auto done = Done();
+    if (done.isClosed()) {
+        return true;
+    }
+    gocxx::time::Timer timer(timeout);
+    auto expired = timer.C();
+    bool canceled = false;
+    gocxx::base::select(
+        gocxx::base::recvCase(done, [&](std::optional<bool>) { canceled = true; }),
+        gocxx::base::recvCase(*expired, [](std::optional<gocxx::time::Time>) {}));
+    return canceled;
+}
+
 // CancelContext implementation
 
 CancelContext::CancelContext(ContextPtr parent)
-    : parent_(parent), canceled_(false), done_chan_(1) {
-    // Initialize done channel as unbuffered, will be closed on cancellation
+    : parent_(parent), canceled_(false) {
+    InheritValues(parent_);
+    if (CancelContext* ancestor = cancel_ancestor_) {
+        bool canceled = false;
+        std::string reason;
+        {
+            std::lock_guard<std::mutex> lock(ancestor->mutex_);
+            canceled = ancestor->canceled_;
+            if (canceled) {
+                reason = ancestor->err_;
+            } else {
+                ancestor->linkChildLocked(this);
+            }
+        }
+        if (canceled) {
+            cancel(reason, false);
+        }
+    }
+    cancel_ancestor_ = this;
+}
+
+CancelContext::~CancelContext() {
+    unlinkFromParent();
 }
 
 gocxx::base::Result<gocxx::time::Time> CancelContext::Deadline() const {
@@ -32,7 +110,18 @@ gocxx::base::Result<gocxx::time::Time> CancelContext::Deadline() const {
 }
 
 gocxx::base::Chan<bool> CancelContext::Done() const {
-    return done_chan_;
+    if (auto* done = done_.load(std::memory_order_acquire)) {
+        return *done;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!done_chan_) {
+        done_chan_ = std::make_unique<gocxx::base::Chan<bool>>(1);
+        if (canceled_) {
+            done_chan_->close();
+        }
+        done_.store(done_chan_.get(), std::memory_order_release);
+    }
+    return *done_chan_;
 }
 
 gocxx::base::Result<void> CancelContext::Err() const {
@@ -52,41 +141,137 @@ gocxx::base::Result<std::any> CancelContext::Value(const std::any& key) const {
     return gocxx::base::Result<std::any>(gocxx::errors::New("key not found"));
 }
 
-void CancelContext::Cancel(const std::string& reason) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
+bool CancelContext::WaitFor(gocxx::time::Duration timeout) const {
+    std::unique_lock<std::mutex> lock(mutex_);
     if (canceled_) {
-        return; // Already canceled
+        return true;
     }
-    
-    canceled_ = true;
-    err_ = reason;
-    
-    // Close the done channel
-    done_chan_.close();
-    
-    // Cancel all children
-    for (auto it = children_.begin(); it != children_.end();) {
-        if (auto child = it->lock()) {
-            child->Cancel(reason);
-            ++it;
-        } else {
-            // Remove expired weak_ptr
-            it = children_.erase(it);
+    gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::ChanRecv);
+    return cancel_cv_.wait_for(lock, timeout.ToStdDuration(), [this] { return canceled_.load(); });
+}
+
+void CancelContext::Cancel(const std::string& reason) {
+    cancel(reason, true);
+}
+
+void CancelContext::cancel(const std::string& reason, bool unlink) {
+    std::unordered_map<std::uint64_t, std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (canceled_) {
+            return; // Already canceled
+        }
+
+        canceled_ = true;
+        err_ = reason;
+
+        // Close the done channel and wake WaitFor() callers
+        if (done_chan_) {
+            done_chan_->close();
         }
+        cancel_cv_.notify_all();
+
+        // Cancel all children; they are detached here, so they skip unlinking.
+        // A child being destroyed waits on our mutex, so the pointers stay valid.
+        for (CancelContext* child = first_child_; child;) {
+            CancelContext* next = child->next_sibling_;
+            child->prev_sibling_ = child->next_sibling_ = nullptr;
+            child->linked_ = false;
+            child->cancel(reason, false);
+            child = next;
+        }
+        first_child_ = nullptr;
+
+        callbacks.swap(after_cancel_);
+    }
+
+    if (unlink) {
+        unlinkFromParent();
+    }
+    for (auto& entry : callbacks) {
+        gocxx::go(std::move(entry.second));
+    }
+}
+
+void CancelContext::linkChildLocked(CancelContext* child) {
+    child->link_parent_ = this;
+    child->prev_sibling_ = nullptr;
+    child->next_sibling_ = first_child_;
+    if (first_child_) {
+        first_child_->prev_sibling_ = child;
     }
+    first_child_ = child;
+    child->linked_ = true;
+}
+
+void CancelContext::unlinkFromParent() {
+    CancelContext* parent = link_parent_;
+    if (!parent) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(parent->mutex_);
+    if (!linked_) {
+        return;
+    }
+    if (prev_sibling_) {
+        prev_sibling_->next_sibling_ = next_sibling_;
+    } else {
+        parent->first_child_ = next_sibling_;
+    }
+    if (next_sibling_) {
+        next_sibling_->prev_sibling_ = prev_sibling_;
+    }
+    prev_sibling_ = next_sibling_ = nullptr;
+    linked_ = false;
 }
 
 void CancelContext::AddChild(std::shared_ptr<CancelContext> child) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (canceled_) {
-        // If already canceled, cancel the child immediately
-        child->Cancel(err_);
+    if (!child || child.get() == this || child->link_parent_) {
         return;
     }
-    
-    children_.push_back(std::weak_ptr<CancelContext>(child));
+    bool canceled = false;
+    std::string reason;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        canceled = canceled_;
+        if (canceled) {
+            // If already canceled, cancel the child immediately
+            reason = err_;
+        } else {
+            linkChildLocked(child.get());
+        }
+    }
+    if (canceled) {
+        child->Cancel(reason);
+    }
+}
+
+std::function<bool()> AfterCancel(const ContextPtr& ctx, std::function<void()> fn) {
+    CancelContext* owner = ctx ? ctx->cancel_ancestor_ : nullptr;
+    if (!owner || !fn) {
+        // Never canceled, or nothing to run: the first stop() stops it
+        return [stopped = std::make_shared<std::atomic<bool>>(false)] { return !stopped->exchange(true); };
+    }
+    std::uint64_t id = 0;
+    bool registered = false;
+    {
+        std::lock_guard<std::mutex> lock(owner->mutex_);
+        if (!owner->canceled_) {
+            id = owner->next_after_cancel_id_++;
+            owner->after_cancel_.emplace(id, std::move(fn));
+            registered = true;
+        }
+    }
+    if (!registered) {
+        gocxx::go(std::move(fn));
+        return [] { return false; };
+    }
+    // The stop function holds ctx, which keeps owner alive.
+    return [ctx, owner, id] {
+        std::lock_guard<std::mutex> lock(owner->mutex_);
+        return owner->after_cancel_.erase(id) > 0;
+    };
 }
 
 // TimerContext implementation
@@ -102,10 +287,9 @@ TimerContext::TimerContext(ContextPtr parent, gocxx::time::Duration timeout)
 }
 
 TimerContext::~TimerContext() {
-    if (timer_thread_ && timer_thread_->joinable()) {
-        Cancel("destructor called");
-        timer_thread_->join();
-    }
+    // Waits out a deadline callback that is running right now, since it uses this.
+    gocxx::time::detail::TimerService::instance().stopSync(*timer_);
+    Cancel("destructor called");
 }
 
 gocxx::base::Result<gocxx::time::Time> TimerContext::Deadline() const {
@@ -113,23 +297,21 @@ gocxx::base::Result<gocxx::time::Time> TimerContext::Deadline() const {
 }
 
 void TimerContext::StartTimer() {
-    timer_thread_ = std::make_unique<std::thread>([this]() {
-        auto now = gocxx::time::Time::Now();
-        if (deadline_.After(now)) {
-            auto duration = deadline_.Sub(now);
-            std::this_thread::sleep_for(duration.ToStdDuration());
-        }
-        
+    timer_ = std::make_shared<gocxx::time::detail::TimerNode>([this]() {
         if (!IsCanceled()) {
             Cancel(DeadlineExceeded);
         }
     });
+    auto remaining = deadline_.Sub(gocxx::time::Time::Now()).Nanoseconds();
+    gocxx::time::detail::TimerService::instance().start(
+        timer_, gocxx::time::detail::monotonicNs() + (remaining > 0 ? remaining : 0));
 }
 
 // ValueContext implementation
 
 ValueContext::ValueContext(ContextPtr parent, const std::any& key, const std::any& value)
     : parent_(parent), key_(key), value_(value) {
+    InheritValues(parent_);
 }
 
 gocxx::base::Result<gocxx::time::Time> ValueContext::Deadline() const {
@@ -155,6 +337,13 @@ gocxx::base::Result<void> ValueContext::Err() const {
     return gocxx::base::Result<void>();
 }
 
+bool ValueContext::WaitFor(gocxx::time::Duration timeout) const {
+    if (parent_) {
+        return parent_->WaitFor(timeout);
+    }
+    return BackgroundContext().WaitFor(timeout);
+}
+
 gocxx::base::Result<std::any> ValueContext::Value(const std::any& key) const {
     // Check if this is the key we're storing
     if (key_.type() == key.type()) {
@@ -191,6 +380,34 @@ gocxx::base::Result<std::any> ValueContext::Value(const std::any& key) const {
     return gocxx::base::Result<std::any>(gocxx::errors::New("key not found"));
 }
 
+// TypedValueContext implementation
+
+TypedValueContext::TypedValueContext(ContextPtr parent, std::size_t key_id, std::shared_ptr<const void> value)
+    : parent_(std::move(parent)) {
+    InheritValues(parent_);
+    typed_values_ = detail::ValueMap::with(typed_values_, key_id, std::move(value));
+}
+
+gocxx::base::Result<gocxx::time::Time> TypedValueContext::Deadline() const {
+    return parent_->Deadline();
+}
+
+gocxx::base::Chan<bool> TypedValueContext::Done() const {
+    return parent_->Done();
+}
+
+gocxx::base::Result<void> TypedValueContext::Err() const {
+    return parent_->Err();
+}
+
+gocxx::base::Result<std::any> TypedValueContext::Value(const std::any& key) const {
+    return parent_->Value(key);
+}
+
+bool TypedValueContext::WaitFor(gocxx::time::Duration timeout) const {
+    return parent_->WaitFor(timeout);
+}
+
 // BackgroundContext implementation
 
 gocxx::base::Result<gocxx::time::Time> BackgroundContext::Deadline() const {
@@ -207,6 +424,12 @@ gocxx::base::Result<void> BackgroundContext::Err() const {
     return gocxx::base::Result<void>();
 }
 
+bool BackgroundContext::WaitFor(gocxx::time::Duration timeout) const {
+    // Never done: just sleep.
+    gocxx::time::Sleep(timeout);
+    return false;
+}
+
 gocxx::base::Result<std::any> BackgroundContext::Value(const std::any& key) const {
     return gocxx::base::Result<std::any>(gocxx::errors::New("key not found"));
 }
@@ -230,11 +453,6 @@ gocxx::base::Result<std::pair<ContextPtr, CancelFunc>> WithCancel(ContextPtr par
     
     auto cancel_ctx = std::make_shared<CancelContext>(parent);
     
-    // If parent is also a CancelContext, add this as a child
-    if (auto parent_cancel_ctx = std::dynamic_pointer_cast<CancelContext>(parent)) {
-        parent_cancel_ctx->AddChild(cancel_ctx);
-    }
-    
     CancelFunc cancel_func = [cancel_ctx]() {
         cancel_ctx->Cancel();
     };
@@ -254,11 +472,6 @@ gocxx::base::Result<std::pair<ContextPtr, CancelFunc>> WithTimeout(
     
     auto timer_ctx = std::make_shared<TimerContext>(parent, timeout);
     
-    // If parent is a CancelContext, add this as a child
-    if (auto parent_cancel_ctx = std::dynamic_pointer_cast<CancelContext>(parent)) {
-        parent_cancel_ctx->AddChild(timer_ctx);
-    }
-    
     CancelFunc cancel_func = [timer_ctx]() {
         timer_ctx->Cancel();
     };
@@ -278,11 +491,6 @@ gocxx::base::Result<std::pair<ContextPtr, CancelFunc>> WithDeadline(
     
     auto timer_ctx = std::make_shared<TimerContext>(parent, deadline);
     
-    // If parent is a CancelContext, add this as a child
-    if (auto parent_cancel_ctx = std::dynamic_pointer_cast<CancelContext>(parent)) {
-        parent_cancel_ctx->AddChild(timer_ctx);
-    }
-    
     CancelFunc cancel_func = [timer_ctx]() {
         timer_ctx->Cancel();
     };
@@ -309,33 +517,13 @@ gocxx::base::Result<ContextPtr> WithValue(
 
 gocxx::base::Result<void> SleepWithContext(ContextPtr ctx, gocxx::time::Duration duration) {
     if (!ctx) {
-        std::this_thread::sleep_for(duration.ToStdDuration());
+        gocxx::time::Sleep(duration);
         return gocxx::base::Result<void>();
     }
     
-    auto start = gocxx::time::Time::Now();
-    auto end = start.Add(duration);
-    
-    while (gocxx::time::Time::Now().Before(end)) {
-        auto err_result = ctx->Err();
-        if (!err_result.Ok()) {
-            return gocxx::base::Result<void>(gocxx::errors::New("context canceled during sleep"));
-        }
-        
-        // Sleep in small increments to check cancellation
-        auto remaining = end.Sub(gocxx::time::Time::Now());
-        auto sleep_duration = std::min(remaining, gocxx::time::Milliseconds(10));
-        
-        if (sleep_duration.Nanoseconds() > 0) {
-            std::this_thread::sleep_for(sleep_duration.ToStdDuration());
-        }
-    }
-    
-    auto final_err = ctx->Err();
-    if (!final_err.Ok()) {
+    if (ctx->Err().Failed() || ctx->WaitFor(duration)) {
         return gocxx::base::Result<void>(gocxx::errors::New("context canceled during sleep"));
     }
-    
     return gocxx::base::Result<void>();
 }
 
@@ -344,20 +532,7 @@ gocxx::base::Result<bool> WaitForContext(ContextPtr ctx, gocxx::time::Duration t
         return gocxx::base::Result<bool>(gocxx::errors::New("context is nil"));
     }
     
-    auto start = gocxx::time::Time::Now();
-    auto end = start.Add(timeout);
-    
-    while (gocxx::time::Time::Now().Before(end)) {
-        auto err_result = ctx->Err();
-        if (!err_result.Ok()) {
-            return gocxx::base::Result<bool>(true); // Context was canceled
-        }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-    
-    auto final_err = ctx->Err();
-    return gocxx::base::Result<bool>(!final_err.Ok());
+    return gocxx::base::Result<bool>(ctx->WaitFor(timeout));
 }
 
 gocxx::base::Result<bool> WillBeCanceledSoon(ContextPtr ctx, gocxx::time::Duration within) {
@@ -0,0 +1,367 @@
+/**
+ * @file cpu_profile.cpp
+ * @brief SIGPROF stack sampler behind debug::StartCPUProfile
+ *
+ * setitimer(ITIMER_PROF) delivers SIGPROF to whichever thread is using CPU.
+ * The handler unwinds that thread's stack into one of two fixed buffers; a
+ * collector thread swaps them every 100ms and folds the stacks into counts,
+ * so the handler never allocates or locks. Symbolizing (dladdr) and the
+ * pprof encoding happen when the profile stops.
+ */
+
+#include <gocxx/debug/pprof.h>
+#include <gocxx/debug/detail/profile_builder.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if (defined(__linux__) && defined(__GLIBC__)) || defined(__APPLE__)
+#define GOCXX_CPU_PROFILE 1
+#include <cerrno>
+#include <csignal>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <link.h>
+#endif
+#endif
+
+namespace gocxx::debug {
+
+std::shared_ptr<gocxx::errors::Error> ErrProfilingInUse = gocxx::errors::New("debug: cpu profiling already in use");
+std::shared_ptr<gocxx::errors::Error> ErrProfilingUnsupported = gocxx::errors::New("debug: cpu profiling not supported on this platform");
+
+#if defined(GOCXX_CPU_PROFILE)
+
+namespace {
+
+constexpr int kMaxFrames = 64;
+constexpr std::size_t kSlots = 4096;  // per buffer; at 100Hz that is 40 busy threads per drain
+
+struct Sample {
+    int depth;
+    void* pcs[kMaxFrames];
+};
+
+struct SampleBuffer {
+    std::atomic<std::uint32_t> count{0};
+    std::atomic<int> writers{0};
+    std::array<Sample, kSlots> slots;
+};
+
+using Stack = std::vector<std::uintptr_t>;
+
+// Interrupted program counter, to cut the handler's own frames off the stack
+std::uintptr_t interruptedPC(void* context) {
+    auto* uc = static_cast<ucontext_t*>(context);
+#if defined(__linux__) && defined(__x86_64__)
+    return static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__linux__) && defined(__aarch64__)
+    return static_cast<std::uintptr_t>(uc->uc_mcontext.pc);
+#elif defined(__APPLE__) && defined(__x86_64__)
+    return static_cast<std::uintptr_t>(uc->uc_mcontext->__ss.__rip);
+#elif defined(__APPLE__) && defined(__aarch64__)
+    return static_cast<std::uintptr_t>(uc->uc_mcontext->__ss.__pc);
+#else
+    (void)uc;
+    return 0;
+#endif
+}
+
+class CPUProfiler {
+public:
+    static CPUProfiler& instance() {
+        // Leaked: a late SIGPROF may still arrive during static destruction.
+        static CPUProfiler* p = new CPUProfiler();
+        return *p;
+    }
+
+    gocxx::base::Result<void> start(std::shared_ptr<gocxx::io::Writer> w, int hz) {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (running_) return {ErrProfilingInUse};
+        if (hz <= 0) hz = 100;
+        if (hz > 1000) hz = 1000;
+        if (!installed_) {
+            // Stays installed for good: a SIGPROF still pending when a profile
+            // stops must not meet the default action, which kills the process.
+            struct sigaction sa {};
+            sa.sa_sigaction = &CPUProfiler::onSignal;
+            sa.sa_flags = SA_RESTART | SA_SIGINFO;
+            sigemptyset(&sa.sa_mask);
+            struct sigaction old {};
+            if (sigaction(SIGPROF, &sa, &old) != 0) return {gocxx::errors::New("debug: sigaction(SIGPROF) failed")};
+            if ((old.sa_flags & SA_SIGINFO) || (old.sa_handler != SIG_DFL && old.sa_handler != SIG_IGN)) {
+                sigaction(SIGPROF, &old, nullptr);
+                return {ErrProfilingInUse};  // someone else's profiler
+            }
+            // The first backtrace() loads the unwinder; do it outside the handler.
+            void* warm[1];
+            backtrace(warm, 1);
+            installed_ = true;
+        }
+
+        out_ = std::move(w);
+        hz_ = hz;
+        stacks_.clear();
+        lost_.store(0, std::memory_order_relaxed);
+        for (auto& b : buffers_) b.count.store(0, std::memory_order_relaxed);
+        active_.store(&buffers_[0], std::memory_order_seq_cst);
+        startWall_ = std::chrono::system_clock::now();
+        startMono_ = std::chrono::steady_clock::now();
+        stop_ = false;
+        collector_ = std::thread([this] { collect(); });
+        enabled_.store(true, std::memory_order_seq_cst);
+
+        itimerval tv{};
+        const long period = 1000000 / hz;  // microseconds; a whole second at 1 Hz, which tv_usec cannot hold
+        tv.it_interval.tv_sec = period / 1000000;
+        tv.it_interval.tv_usec = period % 1000000;
+        tv.it_value = tv.it_interval;
+        if (setitimer(ITIMER_PROF, &tv, nullptr) != 0) {
+            enabled_.store(false);
+            stopCollector();
+            out_.reset();
+            return {gocxx::errors::New("debug: setitimer(ITIMER_PROF) failed")};
+        }
+        running_ = true;
+        return {};
+    }
+
+    gocxx::base::Result<void> stop() {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (!running_) return {};
+        running_ = false;
+        itimerval off{};
+        setitimer(ITIMER_PROF, &off, nullptr);
+        enabled_.store(false, std::memory_order_seq_cst);
+        stopCollector();
+        drain();  // whatever the last swap left in the other buffer
+        drain();
+
+        const std::string data = encode(std::chrono::steady_clock::now() - startMono_);
+        auto w = std::move(out_);
+        auto n = w->Write(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        stacks_.clear();
+        if (n.Failed()) return {n.err};
+        return {};
+    }
+
+private:
+    static void onSignal(int, siginfo_t*, void* context) {
+        const int savedErrno = errno;
+        CPUProfiler& p = instance();
+        if (p.enabled_.load(std::memory_order_acquire)) p.record(context);
+        errno = savedErrno;
+    }
+
+    void record(void* context) {
+        SampleBuffer* b = active_.load(std::memory_order_seq_cst);
+        b->writers.fetch_add(1, std::memory_order_seq_cst);
+        // The collector swaps and then waits for writers, so re-check the
+        // buffer after announcing ourselves; if it moved, drop the sample.
+        if (active_.load(std::memory_order_seq_cst) != b) {
+            b->writers.fetch_sub(1, std::memory_order_release);
+            lost_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const std::uint32_t i = b->count.fetch_add(1, std::memory_order_relaxed);
+        if (i < kSlots) {
+            void* pcs[kMaxFrames + 4];
+            const int n = backtrace(pcs, kMaxFrames + 4);
+            const auto pc = reinterpret_cast<void*>(interruptedPC(context));
+            // Frames up to the interrupted one belong to this handler and the
+            // signal trampoline
+            int skip = std::min(n, 2);
+            for (int k = 0; k < n; ++k) {
+                if (pcs[k] == pc) {
+                    skip = k;
+                    break;
+                }
+            }
+            Sample& s = b->slots[i];
+            s.depth = std::min(n - skip, kMaxFrames);
+            for (int k = 0; k < s.depth; ++k) s.pcs[k] = pcs[skip + k];
+        } else {
+            lost_.fetch_add(1, std::memory_order_relaxed);
+        }
+        b->writers.fetch_sub(1, std::memory_order_release);
+    }
+
+    void collect() {
+        std::unique_lock<std::mutex> lock(collectMu_);
+        while (!stop_) {
+            collectCv_.wait_for(lock, std::chrono::milliseconds(100), [this] { return stop_; });
+            drain();
+        }
+    }
+
+    void stopCollector() {
+        {
+            std::lock_guard<std::mutex> lock(collectMu_);
+            stop_ = true;
+        }
+        collectCv_.notify_all();
+        if (collector_.joinable()) collector_.join();
+    }
+
+    // Swap buffers, wait out writers of the old one, fold its samples in.
+    // Called by the collector, or by stop() once the collector has exited.
+    void drain() {
+        SampleBuffer* old = active_.load(std::memory_order_seq_cst);
+        SampleBuffer* next = old == &buffers_[0] ? &buffers_[1] : &buffers_[0];
+        active_.store(next, std::memory_order_seq_cst);
+        while (old->writers.load(std::memory_order_seq_cst) != 0) std::this_thread::yield();
+        const std::uint32_t n = std::min<std::uint32_t>(old->count.load(std::memory_order_acquire), kSlots);
+        for (std::uint32_t i = 0; i < n; ++i) {
+            const Sample& s = old->slots[i];
+            Stack stack(s.depth);
+            for (int k = 0; k < s.depth; ++k) stack[k] = reinterpret_cast<std::uintptr_t>(s.pcs[k]);
+            ++stacks_[stack];
+        }
+        old->count.store(0, std::memory_order_relaxed);
+    }
+
+    struct Segment {
+        std::uintptr_t start, limit, offset;
+        std::string file;
+    };
+
+    static std::vector<Segment> executableSegments() {
+        std::vector<Segment> out;
+#if defined(__linux__)
+        dl_iterate_phdr([](dl_phdr_info* info, std::size_t, void* data) {
+            auto& segs = *static_cast<std::vector<Segment>*>(data);
+            std::string file = info->dlpi_name ? info->dlpi_name : "";
+            if (file.empty()) {
+                char buf[4096];
+                const ssize_t len = readlink("/proc/self/exe", buf, sizeof(buf));
+                if (len > 0) file.assign(buf, static_cast<std::size_t>(len));
+            }
+            for (int i = 0; i < info->dlpi_phnum; ++i) {
+                const auto& ph = info->dlpi_phdr[i];
+                if (ph.p_type != PT_LOAD || !(ph.p_flags & PF_X)) continue;
+                const std::uintptr_t start = info->dlpi_addr + ph.p_vaddr;
+                segs.push_back({start, start + ph.p_memsz, ph.p_offset, file});
+            }
+            return 0;
+        }, &out);
+#endif
+        return out;
+    }
+
+    static std::string symbolize(std::uintptr_t addr) {
+        Dl_info info{};
+        if (!dladdr(reinterpret_cast<void*>(addr), &info) || !info.dli_sname) return {};
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+        std::free(demangled);
+        return name;
+    }
+
+    std::string encode(std::chrono::steady_clock::duration elapsed) {
+        const std::int64_t period = 1000000000 / hz_;
+        detail::ProfileBuilder pb;
+        pb.sampleType("samples", "count");
+        pb.sampleType("cpu", "nanoseconds");
+        pb.periodType("cpu", "nanoseconds", period);
+        pb.timeNanos(std::chrono::duration_cast<std::chrono::nanoseconds>(startWall_.time_since_epoch()).count());
+        pb.durationNanos(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+        // Callers show return addresses; step back into the call instruction
+        std::map<std::uintptr_t, std::string> names;
+        for (const auto& [stack, count] : stacks_) {
+            for (std::size_t k = 0; k < stack.size(); ++k) names.emplace(k == 0 ? stack[k] : stack[k] - 1, std::string());
+        }
+        for (auto& [addr, name] : names) name = symbolize(addr);
+
+        const std::vector<Segment> segs = executableSegments();
+        std::vector<std::uint64_t> mappingIds(segs.size());
+        for (std::size_t i = 0; i < segs.size(); ++i) {
+            // pprof re-symbolizes mappings without functions from the binary
+            bool allNamed = true;
+            for (auto it = names.lower_bound(segs[i].start); it != names.end() && it->first < segs[i].limit; ++it) {
+                if (it->second.empty()) allNamed = false;
+            }
+            mappingIds[i] = pb.mapping(segs[i].start, segs[i].limit, segs[i].offset, segs[i].file, allNamed);
+        }
+        auto mappingFor = [&](std::uintptr_t addr) -> std::uint64_t {
+            for (std::size_t i = 0; i < segs.size(); ++i) {
+                if (addr >= segs[i].start && addr < segs[i].limit) return mappingIds[i];
+            }
+            return 0;
+        };
+
+        std::map<std::uintptr_t, std::uint64_t> locations;
+        for (const auto& [addr, name] : names) {
+            const std::uint64_t fn = name.empty() ? 0 : pb.function(name);
+            locations[addr] = pb.location(addr, mappingFor(addr), fn);
+        }
+        std::vector<std::uint64_t> ids;
+        for (const auto& [stack, count] : stacks_) {
+            ids.clear();
+            for (std::size_t k = 0; k < stack.size(); ++k) ids.push_back(locations[k == 0 ? stack[k] : stack[k] - 1]);
+            pb.sample(ids, {count, count * period});
+        }
+        if (const std::int64_t lost = lost_.load(std::memory_order_relaxed)) {
+            // Samples the buffers had no room for, charged to one frame as Go does
+            const std::uint64_t fn = pb.function("gocxx.debug.lostSamples");
+            pb.sample({pb.location(0, 0, fn)}, {lost, lost * period});
+        }
+        return pb.finish();
+    }
+
+    std::mutex mu_;  // start/stop
+    bool running_ = false;
+    bool installed_ = false;
+    int hz_ = 100;
+    std::shared_ptr<gocxx::io::Writer> out_;
+    std::chrono::system_clock::time_point startWall_;
+    std::chrono::steady_clock::time_point startMono_;
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<SampleBuffer*> active_{nullptr};
+    std::atomic<std::int64_t> lost_{0};
+    SampleBuffer buffers_[2];
+
+    std::mutex collectMu_;
+    std::condition_variable collectCv_;
+    bool stop_ = false;
+    std::thread collector_;
+    std::map<Stack, std::int64_t> stacks_;  // collector only, then stop()
+};
+
+} // namespace
+
+gocxx::base::Result<void> StartCPUProfile(std::shared_ptr<gocxx::io::Writer> w, int hz) {
+    return CPUProfiler::instance().start(std::move(w), hz);
+}
+
+gocxx::base::Result<void> StopCPUProfile() {
+    return CPUProfiler::instance().stop();
+}
+
+#else
+
+gocxx::base::Result<void> StartCPUProfile(std::shared_ptr<gocxx::io::Writer>, int) {
+    return {ErrProfilingUnsupported};
+}
+
+gocxx::base::Result<void> StopCPUProfile() {
+    return {};
+}
+
+#endif
+
+} // namespace gocxx::debug
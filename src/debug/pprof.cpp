@@ -0,0 +1,228 @@
+/**
+ * @file pprof.cpp
+ * @brief Text reports, the mutex profile and the /debug/pprof/ handlers
+ */
+
+#include <gocxx/debug/pprof.h>
+#include <gocxx/debug/detail/profile_builder.h>
+#include <gocxx/base/chan_stats.h>
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/net/http.h>
+#include <gocxx/runtime/runtime.h>
+#include <gocxx/sync/pool.h>
+#include <gocxx/sync/profiled_mutex.h>
+#include <gocxx/time/detail/timer_service.h>
+#include <gocxx/time/duration.h>
+#include <gocxx/time/time.h>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <string_view>
+
+namespace gocxx::debug {
+
+namespace {
+
+std::string duration(std::int64_t ns) {
+    return gocxx::time::Duration(ns).String();
+}
+
+// Value of @p key in the query string of @p url; empty if absent
+std::string queryValue(const std::string& url, std::string_view key) {
+    const auto q = url.find('?');
+    if (q == std::string::npos) return {};
+    std::string_view rest(url);
+    rest.remove_prefix(q + 1);
+    while (!rest.empty()) {
+        const auto amp = rest.find('&');
+        std::string_view pair = rest.substr(0, amp);
+        rest = amp == std::string_view::npos ? std::string_view() : rest.substr(amp + 1);
+        const auto eq = pair.find('=');
+        if (pair.substr(0, eq) == key) return eq == std::string_view::npos ? std::string() : std::string(pair.substr(eq + 1));
+    }
+    return {};
+}
+
+int queryInt(const std::string& url, std::string_view key, int fallback) {
+    const std::string v = queryValue(url, key);
+    if (v.empty()) return fallback;
+    try {
+        return std::stoi(v);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+void serveText(gocxx::net::http::ResponseWriter& w, const std::string& body) {
+    w.Header()["Content-Type"] = "text/plain; charset=utf-8";
+    w.Header()["X-Content-Type-Options"] = "nosniff";
+    w.Write(body);
+}
+
+void serveProfile(gocxx::net::http::ResponseWriter& w, const std::string& body, const char* name) {
+    w.Header()["Content-Type"] = "application/octet-stream";
+    w.Header()["Content-Disposition"] = std::string("attachment; filename=\"") + name + "\"";
+    w.Write(body);
+}
+
+void serveError(gocxx::net::http::ResponseWriter& w, int status, const std::string& msg) {
+    w.Header()["Content-Type"] = "text/plain; charset=utf-8";
+    w.WriteHeader(status);
+    w.Write(msg + "\n");
+}
+
+} // namespace
+
+std::string ThreadsReport() {
+    const auto stats = gocxx::runtime::Stats();
+    const auto threads = gocxx::runtime::Threads();
+    const auto workers = std::count_if(threads.begin(), threads.end(), [](const auto& t) { return t.worker; });
+
+    std::ostringstream out;
+    out << "threads: " << threads.size() << " (" << workers << " workers), tasks: " << stats.liveTasks
+        << " live, " << stats.spawned << " spawned\n\n";
+    for (const auto& t : threads) {
+        out << "thread " << t.id;
+        if (t.worker) {
+            out << " [worker";
+            if (t.task) out << ", task " << t.task;
+            out << "]";
+        }
+        out << ": " << gocxx::runtime::WaitReasonName(t.waitReason);
+        if (t.waitReason != gocxx::runtime::WaitReason::None) out << ", " << duration(t.waitingNs);
+        out << "\n";
+    }
+    return out.str();
+}
+
+std::string RuntimeReport() {
+    const auto s = gocxx::runtime::Stats();
+    std::ostringstream out;
+    out << "processors: " << s.processors << "\n"
+        << "threads: " << s.threads << " (idle " << s.idleThreads << ", blocked " << s.blockedThreads << ")\n"
+        << "tasks: " << s.liveTasks << " live, " << s.spawned << " spawned, " << s.stolen << " stolen\n"
+        << "handoffs: " << s.handoffs << "\n"
+        << "timers queued: " << gocxx::time::detail::TimerService::instance().queued() << "\n";
+    return out.str();
+}
+
+std::string ChannelsReport() {
+    std::ostringstream out;
+    for (const auto& c : gocxx::base::ListChannels()) {
+        out << (c.name.empty() ? "chan" : c.name) << ": cap=" << c.capacity << " len=" << c.length
+            << " high=" << c.highWater << " sends=" << c.sends << " recvs=" << c.recvs
+            << " blocked_senders=" << c.blockedSenders << " blocked_receivers=" << c.blockedReceivers
+            << " send_wait=" << duration(static_cast<std::int64_t>(c.sendBlockedNs))
+            << " recv_wait=" << duration(static_cast<std::int64_t>(c.recvBlockedNs));
+        if (c.closed) out << " closed";
+        out << "\n";
+    }
+    return out.str();
+}
+
+std::string PoolsReport() {
+    std::ostringstream out;
+    for (const auto& p : gocxx::sync::ListPools()) {
+        char rate[16];
+        std::snprintf(rate, sizeof(rate), "%.1f%%", p.HitRate() * 100);
+        out << (p.name.empty() ? "pool" : p.name) << ": gets=" << p.gets << " misses=" << p.misses
+            << " hit_rate=" << rate << " idle=" << p.idle << "\n";
+    }
+    return out.str();
+}
+
+std::string MutexReport() {
+    std::ostringstream out;
+    out << "sampling 1 in " << gocxx::sync::SetMutexProfileFraction(-1) << " acquisitions\n\n";
+    for (const auto& r : gocxx::sync::MutexProfile()) {
+        out << r.mutex;
+        if (!r.file.empty()) out << " " << r.file << ":" << r.line;
+        if (r.shared) out << " (shared)";
+        out << ": samples=" << r.samples << " contentions=" << r.contentions
+            << " wait=" << duration(static_cast<std::int64_t>(r.waitNs))
+            << " max_wait=" << duration(static_cast<std::int64_t>(r.maxWaitNs));
+        if (!r.shared) {
+            out << " hold=" << duration(static_cast<std::int64_t>(r.holdNs))
+                << " max_hold=" << duration(static_cast<std::int64_t>(r.maxHoldNs));
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+
+gocxx::base::Result<void> WriteMutexProfile(gocxx::io::Writer& w) {
+    const int rate = gocxx::sync::SetMutexProfileFraction(-1);
+    detail::ProfileBuilder pb;
+    pb.sampleType("contentions", "count");
+    pb.sampleType("delay", "nanoseconds");
+    pb.sampleType("hold", "nanoseconds");
+    pb.periodType("contentions", "count", std::max(rate, 1));
+    pb.defaultSampleType("delay");
+    pb.timeNanos(gocxx::time::Time::Now().UnixNano());
+
+    // A one-frame stack per acquisition site, under the mutex's name
+    for (const auto& r : gocxx::sync::MutexProfile()) {
+        if (r.contentions == 0) continue;
+        const std::uint64_t fn = pb.function(r.shared ? r.mutex + " (shared)" : r.mutex, r.file);
+        const std::uint64_t loc = pb.location(0, 0, fn, r.line);
+        // Scaled up by the sampling rate, like Go's mutex profile
+        const std::int64_t scale = std::max(rate, 1);
+        pb.sample({loc}, {static_cast<std::int64_t>(r.contentions) * scale,
+                          static_cast<std::int64_t>(r.waitNs) * scale,
+                          static_cast<std::int64_t>(r.holdNs) * scale});
+    }
+    const std::string data = pb.finish();
+    auto n = w.Write(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    if (n.Failed()) return {n.err};
+    return {};
+}
+
+void RegisterHandlers(gocxx::net::http::ServeMux& mux, const std::string& prefix) {
+    using gocxx::net::http::Request;
+    using gocxx::net::http::ResponseWriter;
+
+    mux.HandleFunc(prefix, [prefix](ResponseWriter& w, const Request&) {
+        serveText(w, "gocxx debug endpoints:\n\n"
+                     "  " + prefix + "threads   threads, their tasks and wait reasons\n"
+                     "  " + prefix + "runtime   scheduler and timer counters\n"
+                     "  " + prefix + "channels  channels with stats enabled\n"
+                     "  " + prefix + "pools     sync::Pool hit rates\n"
+                     "  " + prefix + "mutex     mutex contention profile (?debug=1 for text)\n"
+                     "  " + prefix + "profile   CPU profile (?seconds=30)\n");
+    });
+    mux.HandleFunc(prefix + "threads", [](ResponseWriter& w, const Request&) { serveText(w, ThreadsReport()); });
+    mux.HandleFunc(prefix + "runtime", [](ResponseWriter& w, const Request&) { serveText(w, RuntimeReport()); });
+    mux.HandleFunc(prefix + "channels", [](ResponseWriter& w, const Request&) { serveText(w, ChannelsReport()); });
+    mux.HandleFunc(prefix + "pools", [](ResponseWriter& w, const Request&) { serveText(w, PoolsReport()); });
+    mux.HandleFunc(prefix + "mutex", [](ResponseWriter& w, const Request& req) {
+        if (queryInt(req.url, "debug", 0) > 0) {
+            serveText(w, MutexReport());
+            return;
+        }
+        gocxx::bytes::Buffer buf;
+        WriteMutexProfile(buf);
+        serveProfile(w, buf.String(), "mutex");
+    });
+    mux.HandleFunc(prefix + "profile", [](ResponseWriter& w, const Request& req) {
+        const int seconds = queryInt(req.url, "seconds", 30);
+        if (seconds <= 0) {
+            serveError(w, gocxx::net::http::StatusBadRequest, "invalid seconds");
+            return;
+        }
+        auto buf = std::make_shared<gocxx::bytes::Buffer>();
+        if (auto r = StartCPUProfile(buf, queryInt(req.url, "hz", 100)); r.Failed()) {
+            serveError(w, gocxx::net::http::StatusInternalServerError,
+                       "Could not enable CPU profiling: " + r.err->error());
+            return;
+        }
+        gocxx::time::Sleep(gocxx::time::Seconds(int64_t(seconds)));
+        if (auto r = StopCPUProfile(); r.Failed()) {
+            serveError(w, gocxx::net::http::StatusInternalServerError, r.err->error());
+            return;
+        }
+        serveProfile(w, buf->String(), "profile");
+    });
+}
+
+} // namespace gocxx::debug
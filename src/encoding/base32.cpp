@@ -0,0 +1,376 @@
+/**
+ * @file base32.cpp
+ * @brief Base32 encoding and decoding, a 40-bit group at a time
+ */
+
+#include <gocxx/encoding/base32.h>
+#include <gocxx/io/io_errors.h>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace gocxx {
+namespace encoding {
+namespace base32 {
+
+namespace {
+
+std::shared_ptr<gocxx::errors::Error> corrupt(std::size_t offset) {
+    return std::make_shared<CorruptInputError>(static_cast<int64_t>(offset));
+}
+
+bool isNewline(uint8_t c) {
+    return c == '\n' || c == '\r';
+}
+
+} // namespace
+
+std::string CorruptInputError::error() const noexcept {
+    return "illegal base32 data at input byte " + std::to_string(offset_);
+}
+
+// Encoding
+
+Encoding::Encoding(std::string_view alphabet) {
+    if (alphabet.size() != 32) {
+        throw std::invalid_argument("base32: encoding alphabet is not 32 bytes long");
+    }
+    std::memset(decode_, 0xff, sizeof(decode_));
+    for (std::size_t i = 0; i < 32; ++i) {
+        const auto c = static_cast<uint8_t>(alphabet[i]);
+        if (isNewline(c)) {
+            throw std::invalid_argument("base32: encoding alphabet contains newline character");
+        }
+        if (decode_[c] != 0xff) {
+            throw std::invalid_argument("base32: encoding alphabet includes duplicate symbols");
+        }
+        encode_[i] = alphabet[i];
+        decode_[c] = static_cast<uint8_t>(i);
+    }
+}
+
+Encoding Encoding::WithPadding(int32_t padding) const {
+    if (padding == '\r' || padding == '\n' || padding > 0xff || (padding < 0 && padding != NoPadding)) {
+        throw std::invalid_argument("base32: invalid padding");
+    }
+    if (padding != NoPadding && decode_[padding] != 0xff) {
+        throw std::invalid_argument("base32: padding contained in alphabet");
+    }
+    Encoding enc = *this;
+    enc.pad_ = padding;
+    return enc;
+}
+
+std::size_t Encoding::EncodedLen(std::size_t n) const {
+    if (pad_ == NoPadding) {
+        return n / 5 * 8 + (n % 5 * 8 + 4) / 5;
+    }
+    return (n + 4) / 5 * 8;
+}
+
+std::size_t Encoding::DecodedLen(std::size_t n) const {
+    if (pad_ == NoPadding) {
+        return n / 8 * 5 + n % 8 * 5 / 8;
+    }
+    return n / 8 * 5;
+}
+
+void Encoding::Encode(uint8_t* dst, const uint8_t* src, std::size_t n) const {
+    auto quantum = [this](uint8_t* out, const uint8_t* in, std::size_t chars) {
+        const uint64_t v = uint64_t(in[0]) << 32 | uint64_t(in[1]) << 24 | uint64_t(in[2]) << 16 |
+                           uint64_t(in[3]) << 8 | in[4];
+        for (std::size_t k = 0; k < chars; ++k) {
+            out[k] = encode_[v >> (35 - 5 * k) & 0x1f];
+        }
+    };
+    std::size_t si = 0;
+    for (; si + 5 <= n; si += 5, dst += 8) {
+        quantum(dst, src + si, 8);
+    }
+    const std::size_t remain = n - si;
+    if (remain == 0) {
+        return;
+    }
+    uint8_t last[5] = {};
+    std::memcpy(last, src + si, remain);
+    const std::size_t chars = (remain * 8 + 4) / 5;
+    quantum(dst, last, chars);
+    if (pad_ != NoPadding) {
+        std::memset(dst + chars, static_cast<uint8_t>(pad_), 8 - chars);
+    }
+}
+
+std::string Encoding::EncodeToString(const uint8_t* src, std::size_t n) const {
+    std::string out(EncodedLen(n), '\0');
+    Encode(reinterpret_cast<uint8_t*>(out.data()), src, n);
+    return out;
+}
+
+void Encoding::AppendEncode(std::string& dst, std::string_view src) const {
+    const std::size_t old = dst.size();
+    dst.resize(old + EncodedLen(src.size()));
+    Encode(reinterpret_cast<uint8_t*>(dst.data()) + old, reinterpret_cast<const uint8_t*>(src.data()), src.size());
+}
+
+// Go's decode, on input without newlines; whole quanta of 8 valid
+// characters are taken in one step
+gocxx::base::Result<std::size_t> Encoding::decode(uint8_t* dst, const uint8_t* src, std::size_t n) const {
+    std::size_t si = 0;
+    std::size_t di = 0;
+    bool end = false;
+    while (si < n && !end) {
+        if (n - si >= 8) {
+            uint64_t v = 0;
+            uint8_t bad = 0;
+            for (std::size_t k = 0; k < 8; ++k) {
+                const uint8_t d = decode_[src[si + k]];
+                bad |= d;
+                v = v << 5 | (d & 0x1f);
+            }
+            if (!(bad & 0x80)) {
+                for (std::size_t k = 0; k < 5; ++k) {
+                    dst[di + k] = static_cast<uint8_t>(v >> (32 - 8 * k));
+                }
+                si += 8;
+                di += 5;
+                continue;
+            }
+        }
+        uint8_t dbuf[8] = {};
+        std::size_t dlen = 8;
+        for (std::size_t j = 0; j < 8;) {
+            if (si == n) {
+                if (pad_ != NoPadding) {
+                    return {di, corrupt(si - j)};  // missing padding
+                }
+                dlen = j;
+                end = true;
+                break;
+            }
+            const uint8_t in = src[si++];
+            const std::size_t left = n - si;
+            if (pad_ != NoPadding && in == static_cast<uint8_t>(pad_) && j >= 2 && left < 8) {
+                if (left + j < 7) {
+                    return {di, corrupt(n)};  // not enough padding
+                }
+                for (std::size_t k = 0; k < 7 - j; ++k) {
+                    if (left > k && src[si + k] != static_cast<uint8_t>(pad_)) {
+                        return {di, corrupt(si + k - 1)};
+                    }
+                }
+                dlen = j;
+                end = true;
+                // 1, 3 and 6 characters hold too few bits for another byte (RFC 4648 section 6)
+                if (dlen == 1 || dlen == 3 || dlen == 6) {
+                    return {di, corrupt(si - 1)};
+                }
+                break;
+            }
+            dbuf[j] = decode_[in];
+            if (dbuf[j] == 0xff) {
+                return {di, corrupt(si - 1)};
+            }
+            ++j;
+        }
+        // Pack 8 5-bit characters into up to 5 bytes
+        uint8_t* out = dst + di;
+        switch (dlen) {
+            case 8:
+                out[4] = static_cast<uint8_t>(dbuf[6] << 5 | dbuf[7]);
+                ++di;
+                [[fallthrough]];
+            case 7:
+                out[3] = static_cast<uint8_t>(dbuf[4] << 7 | dbuf[5] << 2 | dbuf[6] >> 3);
+                ++di;
+                [[fallthrough]];
+            case 5:
+                out[2] = static_cast<uint8_t>(dbuf[3] << 4 | dbuf[4] >> 1);
+                ++di;
+                [[fallthrough]];
+            case 4:
+                out[1] = static_cast<uint8_t>(dbuf[1] << 6 | dbuf[2] << 1 | dbuf[3] >> 4);
+                ++di;
+                [[fallthrough]];
+            case 2:
+                out[0] = static_cast<uint8_t>(dbuf[0] << 3 | dbuf[1] >> 2);
+                ++di;
+        }
+    }
+    return {di, nullptr};
+}
+
+gocxx::base::Result<std::size_t> Encoding::Decode(uint8_t* dst, const uint8_t* src, std::size_t n) const {
+    if (std::none_of(src, src + n, isNewline)) {
+        return decode(dst, src, n);
+    }
+    std::vector<uint8_t> stripped;
+    stripped.reserve(n);
+    std::copy_if(src, src + n, std::back_inserter(stripped), [](uint8_t c) { return !isNewline(c); });
+    return decode(dst, stripped.data(), stripped.size());
+}
+
+gocxx::base::Result<std::vector<uint8_t>> Encoding::DecodeString(std::string_view s) const {
+    std::vector<uint8_t> out(DecodedLen(s.size()));
+    auto n = Decode(out.data(), reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    out.resize(n.value);
+    return {std::move(out), n.err};
+}
+
+gocxx::base::Result<void> Encoding::AppendDecode(std::string& dst, std::string_view src) const {
+    const std::size_t old = dst.size();
+    dst.resize(old + DecodedLen(src.size()));
+    auto n = Decode(reinterpret_cast<uint8_t*>(dst.data()) + old, reinterpret_cast<const uint8_t*>(src.data()),
+                    src.size());
+    dst.resize(old + n.value);
+    return n.err;
+}
+
+const Encoding StdEncoding("ABCDEFGHIJKLMNOPQRSTUVWXYZ234567");
+const Encoding HexEncoding("0123456789ABCDEFGHIJKLMNOPQRSTUV");
+
+// Streams
+
+namespace {
+
+class encoder : public gocxx::io::WriteCloser {
+public:
+    encoder(const Encoding& enc, std::shared_ptr<gocxx::io::Writer> w) : enc_(enc), w_(std::move(w)) {}
+
+    gocxx::base::Result<std::size_t> Write(const uint8_t* p, std::size_t n) override {
+        if (err_) {
+            return {0, err_};
+        }
+        std::size_t used = 0;
+        if (nbuf_ > 0) {
+            while (nbuf_ < 5 && used < n) buf_[nbuf_++] = p[used++];
+            if (nbuf_ < 5) {
+                return {n, nullptr};
+            }
+            emit(buf_, 5);
+            nbuf_ = 0;
+            if (err_) {
+                return {used, err_};
+            }
+        }
+        while (n - used >= 5) {
+            const std::size_t m = std::min((n - used) / 5 * 5, kChunk);
+            emit(p + used, m);
+            if (err_) {
+                return {used, err_};
+            }
+            used += m;
+        }
+        while (used < n) buf_[nbuf_++] = p[used++];
+        return {n, nullptr};
+    }
+
+    void close() override {
+        if (!err_ && nbuf_ > 0) {
+            emit(buf_, nbuf_);
+            nbuf_ = 0;
+        }
+    }
+
+private:
+    static constexpr std::size_t kChunk = 5 * 1024;
+
+    void emit(const uint8_t* p, std::size_t n) {
+        out_.resize(enc_.EncodedLen(n));
+        enc_.Encode(out_.data(), p, n);
+        auto written = w_->Write(out_.data(), out_.size());
+        if (written.Failed()) {
+            err_ = written.err;
+        } else if (written.value != out_.size()) {
+            err_ = gocxx::io::ErrShortWrite;
+        }
+    }
+
+    const Encoding enc_;
+    std::shared_ptr<gocxx::io::Writer> w_;
+    uint8_t buf_[5] = {};
+    std::size_t nbuf_ = 0;
+    std::vector<uint8_t> out_;
+    std::shared_ptr<gocxx::errors::Error> err_;
+};
+
+class decoder : public gocxx::io::Reader {
+public:
+    decoder(const Encoding& enc, std::shared_ptr<gocxx::io::Reader> r) : enc_(enc), r_(std::move(r)) {}
+
+    gocxx::base::Result<std::size_t> Read(uint8_t* p, std::size_t n) override {
+        while (pos_ == out_.size()) {
+            if (err_) {
+                return {0, err_};
+            }
+            if (eof_) {
+                return {0, gocxx::io::ErrEOF};
+            }
+            fill();
+        }
+        const std::size_t m = std::min(n, out_.size() - pos_);
+        std::memcpy(p, out_.data() + pos_, m);
+        pos_ += m;
+        return {m, nullptr};
+    }
+
+private:
+    static constexpr std::size_t kChunk = 4096;
+
+    // Reads more and decodes every whole quantum, or everything at the end
+    void fill() {
+        const std::size_t old = in_.size();
+        in_.resize(old + kChunk);
+        auto got = r_->Read(in_.data() + old, kChunk);
+        std::shared_ptr<gocxx::errors::Error> read_err;
+        if (got.Failed()) {
+            if (gocxx::errors::Is(got.err, gocxx::io::ErrEOF)) {
+                eof_ = true;
+            } else {
+                read_err = got.err;
+            }
+            in_.resize(old);
+        } else {
+            in_.resize(old + got.value);
+            eof_ = got.value == 0;
+        }
+        // Newlines are dropped here, so in_ holds only significant characters
+        in_.erase(std::remove_if(in_.begin() + static_cast<std::ptrdiff_t>(old), in_.end(), isNewline), in_.end());
+        const std::size_t cut = eof_ ? in_.size() : in_.size() / 8 * 8;
+        out_.resize(enc_.DecodedLen(cut));
+        pos_ = 0;
+        auto n = enc_.Decode(out_.data(), in_.data(), cut);
+        out_.resize(n.value);
+        if (n.Failed()) {
+            std::shared_ptr<CorruptInputError> corrupt_err;
+            err_ = gocxx::errors::As(n.err, corrupt_err) ? corrupt(offset_ + corrupt_err->Offset()) : n.err;
+        } else if (read_err) {
+            err_ = read_err;
+        }
+        in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(cut));
+        offset_ += cut;
+    }
+
+    const Encoding enc_;
+    std::shared_ptr<gocxx::io::Reader> r_;
+    std::vector<uint8_t> in_;   // read but not yet decoded: a partial quantum
+    std::vector<uint8_t> out_;  // decoded, from pos_ not yet returned
+    std::size_t pos_ = 0;
+    std::size_t offset_ = 0;    // characters decoded before in_
+    bool eof_ = false;
+    std::shared_ptr<gocxx::errors::Error> err_;
+};
+
+} // namespace
+
+std::shared_ptr<gocxx::io::WriteCloser> NewEncoder(const Encoding& enc, std::shared_ptr<gocxx::io::Writer> w) {
+    return std::make_shared<encoder>(enc, std::move(w));
+}
+
+std::shared_ptr<gocxx::io::Reader> NewDecoder(const Encoding& enc, std::shared_ptr<gocxx::io::Reader> r) {
+    return std::make_shared<decoder>(enc, std::move(r));
+}
+
+} // namespace base32
+} // namespace encoding
+} // namespace gocxx
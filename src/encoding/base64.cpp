@@ -0,0 +1,717 @@
+/**
+ * @file base64.cpp
+ * @brief Base64 encoding and decoding, with vector kernels for whole blocks
+ *
+ * The x86 kernels are those of Muła and Lemire ("Faster Base64 Encoding
+ * and Decoding Using AVX2 Instructions"): a shuffle spreads each 3 bytes
+ * over 4 lanes, two multiplies line the 6-bit indices up, and a 16-entry
+ * table of offsets turns indices into characters. Decoding classifies each
+ * character by range instead, so any block with a byte outside the
+ * alphabet is left to the scalar code. The NEON kernels look characters up
+ * in the encoding's own tables with TBL, so they serve any alphabet.
+ */
+
+#include <gocxx/encoding/base64.h>
+#include <gocxx/io/io_errors.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+#endif
+
+namespace gocxx {
+namespace encoding {
+namespace base64 {
+
+namespace {
+
+constexpr char kStdAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr char kURLAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// How far a kernel got: input consumed and output written, both whole blocks
+struct Progress {
+    std::size_t read = 0;
+    std::size_t written = 0;
+};
+
+using EncodeFunc = std::size_t (*)(uint8_t* dst, const uint8_t* src, std::size_t n, const char* alphabet);
+using DecodeFunc = Progress (*)(uint8_t* dst, std::size_t cap, const uint8_t* src, std::size_t n,
+                                const char* alphabet, const uint8_t* decode_map);
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define GOCXX_TARGET_SSSE3 __attribute__((target("ssse3")))
+    #define GOCXX_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define GOCXX_TARGET_SSSE3
+    #define GOCXX_TARGET_AVX2
+#endif
+
+// Bytes in [lo, hi]; the compares are signed, so bytes above 0x7f are never in range
+inline __m128i inRange(__m128i x, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmplt_epi8(x, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+// 16 characters to their 6-bit values; false if any is outside the alphabet
+inline bool valuesSSE2(__m128i x, char c62, char c63, __m128i& values) {
+    const __m128i upper = inRange(x, 'A', 'Z');
+    const __m128i lower = inRange(x, 'a', 'z');
+    const __m128i digit = inRange(x, '0', '9');
+    const __m128i e62 = _mm_cmpeq_epi8(x, _mm_set1_epi8(c62));
+    const __m128i e63 = _mm_cmpeq_epi8(x, _mm_set1_epi8(c63));
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, e62), e63));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+        return false;
+    }
+    __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    shift = _mm_or_si128(shift, _mm_and_si128(e62, _mm_set1_epi8(static_cast<char>(62 - c62))));
+    shift = _mm_or_si128(shift, _mm_and_si128(e63, _mm_set1_epi8(static_cast<char>(63 - c63))));
+    values = _mm_add_epi8(x, shift);
+    return true;
+}
+
+// The offset from a 6-bit index to its character, for each class the encoders sort indices into
+inline __m128i shiftTable(const char* alphabet) {
+    const char f = '0' - 52;
+    return _mm_setr_epi8('a' - 26, f, f, f, f, f, f, f, f, f, f, static_cast<char>(alphabet[62] - 62),
+                         static_cast<char>(alphabet[63] - 63), 'A', 0, 0);
+}
+
+GOCXX_TARGET_SSSE3 inline __m128i encodeBlockSSSE3(__m128i in, __m128i shift_lut) {
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t0, t1);
+    // 0 for a-z, 1-10 for digits, 11 and 12 for the last two, 13 for A-Z
+    __m128i cls = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    cls = _mm_or_si128(cls, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, cls), indices);
+}
+
+GOCXX_TARGET_SSSE3 std::size_t encodeSSSE3(uint8_t* dst, const uint8_t* src, std::size_t n, const char* alphabet) {
+    const __m128i lut = shiftTable(alphabet);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 12, dst += 16) {  // reads 16 bytes to use 12
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), encodeBlockSSSE3(in, lut));
+    }
+    return i;
+}
+
+// 16 values, 6 bits each, packed into the first 12 bytes
+GOCXX_TARGET_SSSE3 inline __m128i packSSSE3(__m128i values) {
+    const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+GOCXX_TARGET_SSSE3 Progress decodeSSSE3(uint8_t* dst, std::size_t cap, const uint8_t* src, std::size_t n,
+                                        const char* alphabet, const uint8_t*) {
+    Progress p;
+    __m128i values;
+    while (p.read + 16 <= n && p.written + 16 <= cap &&
+           valuesSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + p.read)), alphabet[62], alphabet[63],
+                      values)) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + p.written), packSSSE3(values));
+        p.read += 16;
+        p.written += 12;
+    }
+    return p;
+}
+
+GOCXX_TARGET_AVX2 std::size_t encodeAVX2(uint8_t* dst, const uint8_t* src, std::size_t n, const char* alphabet) {
+    const __m256i lut = _mm256_broadcastsi128_si256(shiftTable(alphabet));
+    const __m256i spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    std::size_t i = 0;
+    for (; i + 28 <= n; i += 24, dst += 32) {  // 12 bytes for each lane, the second load reading 4 past them
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+        const __m256i in = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), spread);
+        const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                                              _mm256_set1_epi32(0x04000040));
+        const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                                              _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t0, t1);
+        __m256i cls = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        cls = _mm256_or_si256(cls, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices),
+                                                    _mm256_set1_epi8(13)));
+        const __m256i out = _mm256_add_epi8(_mm256_shuffle_epi8(lut, cls), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), out);
+    }
+    return i;
+}
+
+GOCXX_TARGET_AVX2 inline __m256i inRangeAVX2(__m256i x, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), x));
+}
+
+GOCXX_TARGET_AVX2 Progress decodeAVX2(uint8_t* dst, std::size_t cap, const uint8_t* src, std::size_t n,
+                                      const char* alphabet, const uint8_t*) {
+    const __m256i c62 = _mm256_set1_epi8(alphabet[62]);
+    const __m256i c63 = _mm256_set1_epi8(alphabet[63]);
+    const __m256i s62 = _mm256_set1_epi8(static_cast<char>(62 - alphabet[62]));
+    const __m256i s63 = _mm256_set1_epi8(static_cast<char>(63 - alphabet[63]));
+    const __m256i order = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                           2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    Progress p;
+    while (p.read + 32 <= n && p.written + 32 <= cap) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + p.read));
+        const __m256i upper = inRangeAVX2(x, 'A', 'Z');
+        const __m256i lower = inRangeAVX2(x, 'a', 'z');
+        const __m256i digit = inRangeAVX2(x, '0', '9');
+        const __m256i e62 = _mm256_cmpeq_epi8(x, c62);
+        const __m256i e63 = _mm256_cmpeq_epi8(x, c63);
+        const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                              _mm256_or_si256(_mm256_or_si256(digit, e62), e63));
+        if (_mm256_movemask_epi8(valid) != -1) {
+            break;
+        }
+        __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(e62, s62));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(e63, s63));
+        const __m256i values = _mm256_add_epi8(x, shift);
+        const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        // 12 bytes at the bottom of each lane; close the gap between them
+        const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(words, order),
+                                                           _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + p.written), packed);
+        p.read += 32;
+        p.written += 24;
+    }
+    return p;
+}
+
+bool haveSSSE3() {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("ssse3");
+#else
+    return true;
+#endif
+}
+
+bool haveAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return true;  // built with /arch:AVX2
+#endif
+}
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+
+inline uint8x16x4_t table64(const uint8_t* p) {
+    return {{vld1q_u8(p), vld1q_u8(p + 16), vld1q_u8(p + 32), vld1q_u8(p + 48)}};
+}
+
+std::size_t encodeNEON(uint8_t* dst, const uint8_t* src, std::size_t n, const char* alphabet) {
+    const uint8x16x4_t lut = table64(reinterpret_cast<const uint8_t*>(alphabet));
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+    std::size_t i = 0;
+    for (; i + 48 <= n; i += 48, dst += 64) {
+        const uint8x16x3_t in = vld3q_u8(src + i);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+        for (auto& v : out.val) v = vqtbl4q_u8(lut, v);
+        vst4q_u8(dst, out);
+    }
+    return i;
+}
+
+Progress decodeNEON(uint8_t* dst, std::size_t cap, const uint8_t* src, std::size_t n, const char*,
+                    const uint8_t* decode_map) {
+    const uint8x16x4_t lo = table64(decode_map);
+    const uint8x16x4_t hi = table64(decode_map + 64);
+    const uint8x16_t sixty_four = vdupq_n_u8(64);
+    Progress p;
+    while (p.read + 64 <= n && p.written + 48 <= cap) {
+        uint8x16x4_t in = vld4q_u8(src + p.read);
+        uint8x16_t bad = vdupq_n_u8(0);
+        for (auto& v : in.val) {
+            // bytes from 128 up miss both tables and come out 0, so their own high bit marks them
+            const uint8x16_t value = vqtbx4q_u8(vqtbl4q_u8(lo, v), hi, vsubq_u8(v, sixty_four));
+            bad = vorrq_u8(bad, vorrq_u8(value, v));
+            v = value;
+        }
+        if (vmaxvq_u8(bad) & 0x80) {
+            break;
+        }
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+        vst3q_u8(dst + p.written, out);
+        p.read += 64;
+        p.written += 48;
+    }
+    return p;
+}
+
+#endif
+
+struct Kernel {
+    const char* name;
+    EncodeFunc encode;  // null for the scalar code alone
+    DecodeFunc decode;
+    bool any_alphabet;  // the x86 kernels work out A-Z, a-z and 0-9 arithmetically
+    bool (*supported)();
+};
+
+bool always() { return true; }
+
+// Best first
+const Kernel kKernels[] = {
+#if defined(__x86_64__) || defined(_M_X64)
+    {"avx2", encodeAVX2, decodeAVX2, false, haveAVX2},
+    {"ssse3", encodeSSSE3, decodeSSSE3, false, haveSSSE3},
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    {"neon", encodeNEON, decodeNEON, true, always},
+#endif
+    {"scalar", nullptr, nullptr, true, always},
+};
+
+const Kernel* bestKernel() {
+    for (const Kernel& k : kKernels) {
+        if (k.supported()) {
+            return &k;
+        }
+    }
+    return &kKernels[std::size(kKernels) - 1];
+}
+
+std::atomic<const Kernel*>& currentKernel() {
+    static std::atomic<const Kernel*> kernel{bestKernel()};
+    return kernel;
+}
+
+std::shared_ptr<gocxx::errors::Error> corrupt(std::size_t offset) {
+    return std::make_shared<CorruptInputError>(static_cast<int64_t>(offset));
+}
+
+} // namespace
+
+namespace detail {
+
+const char* Base64Kernel() {
+    return currentKernel().load(std::memory_order_relaxed)->name;
+}
+
+bool SetBase64Kernel(std::string_view name) {
+    for (const Kernel& k : kKernels) {
+        if (name == k.name) {
+            if (!k.supported()) {
+                return false;
+            }
+            currentKernel().store(&k, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace detail
+
+std::string CorruptInputError::error() const noexcept {
+    return "illegal base64 data at input byte " + std::to_string(offset_);
+}
+
+// Encoding
+
+Encoding::Encoding(std::string_view alphabet) {
+    if (alphabet.size() != 64) {
+        throw std::invalid_argument("base64: encoding alphabet is not 64 bytes long");
+    }
+    std::memset(decode_, 0xff, sizeof(decode_));
+    for (std::size_t i = 0; i < 64; ++i) {
+        const auto c = static_cast<uint8_t>(alphabet[i]);
+        if (c == '\n' || c == '\r') {
+            throw std::invalid_argument("base64: encoding alphabet contains newline character");
+        }
+        if (decode_[c] != 0xff) {
+            throw std::invalid_argument("base64: encoding alphabet includes duplicate symbols");
+        }
+        encode_[i] = alphabet[i];
+        decode_[c] = static_cast<uint8_t>(i);
+    }
+    standard_ = alphabet.substr(0, 62) == std::string_view(kStdAlphabet, 62);
+}
+
+Encoding Encoding::WithPadding(int32_t padding) const {
+    if (padding == '\r' || padding == '\n' || padding > 0xff || (padding < 0 && padding != NoPadding)) {
+        throw std::invalid_argument("base64: invalid padding");
+    }
+    if (padding != NoPadding && decode_[padding] != 0xff) {
+        throw std::invalid_argument("base64: padding contained in alphabet");
+    }
+    Encoding enc = *this;
+    enc.pad_ = padding;
+    return enc;
+}
+
+Encoding Encoding::Strict() const {
+    Encoding enc = *this;
+    enc.strict_ = true;
+    return enc;
+}
+
+std::size_t Encoding::EncodedLen(std::size_t n) const {
+    if (pad_ == NoPadding) {
+        return n / 3 * 4 + (n % 3 * 8 + 5) / 6;
+    }
+    return (n + 2) / 3 * 4;
+}
+
+std::size_t Encoding::DecodedLen(std::size_t n) const {
+    if (pad_ == NoPadding) {
+        return n / 4 * 3 + n % 4 * 6 / 8;
+    }
+    return n / 4 * 3;
+}
+
+void Encoding::Encode(uint8_t* dst, const uint8_t* src, std::size_t n) const {
+    std::size_t si = 0;
+    const Kernel* kernel = currentKernel().load(std::memory_order_relaxed);
+    if (kernel->encode && (standard_ || kernel->any_alphabet)) {
+        si = kernel->encode(dst, src, n, encode_);
+        dst += si / 3 * 4;
+    }
+    for (; si + 3 <= n; si += 3, dst += 4) {
+        const uint32_t v = uint32_t(src[si]) << 16 | uint32_t(src[si + 1]) << 8 | src[si + 2];
+        dst[0] = encode_[v >> 18 & 0x3f];
+        dst[1] = encode_[v >> 12 & 0x3f];
+        dst[2] = encode_[v >> 6 & 0x3f];
+        dst[3] = encode_[v & 0x3f];
+    }
+    const std::size_t remain = n - si;
+    if (remain == 0) {
+        return;
+    }
+    uint32_t v = uint32_t(src[si]) << 16;
+    if (remain == 2) {
+        v |= uint32_t(src[si + 1]) << 8;
+    }
+    dst[0] = encode_[v >> 18 & 0x3f];
+    dst[1] = encode_[v >> 12 & 0x3f];
+    if (remain == 2) {
+        dst[2] = encode_[v >> 6 & 0x3f];
+        if (pad_ != NoPadding) dst[3] = static_cast<uint8_t>(pad_);
+    } else if (pad_ != NoPadding) {
+        dst[2] = dst[3] = static_cast<uint8_t>(pad_);
+    }
+}
+
+std::string Encoding::EncodeToString(const uint8_t* src, std::size_t n) const {
+    std::string out(EncodedLen(n), '\0');
+    Encode(reinterpret_cast<uint8_t*>(out.data()), src, n);
+    return out;
+}
+
+void Encoding::AppendEncode(std::string& dst, std::string_view src) const {
+    const std::size_t old = dst.size();
+    dst.resize(old + EncodedLen(src.size()));
+    Encode(reinterpret_cast<uint8_t*>(dst.data()) + old, reinterpret_cast<const uint8_t*>(src.data()), src.size());
+}
+
+// One quantum of up to 4 characters, skipping newlines and checking the
+// padding at the end, as Go's decodeQuantum does; returns the bytes written.
+std::size_t Encoding::decodeQuantum(uint8_t* dst, const uint8_t* src, std::size_t n, std::size_t& si,
+                                    std::shared_ptr<gocxx::errors::Error>& err) const {
+    auto skipNewlines = [&] {
+        while (si < n && (src[si] == '\n' || src[si] == '\r')) ++si;
+    };
+    uint8_t dbuf[4] = {};
+    std::size_t dlen = 4;
+    for (std::size_t j = 0; j < 4;) {
+        if (si == n) {
+            if (j == 0) {
+                return 0;
+            }
+            if (j == 1 || pad_ != NoPadding) {
+                err = corrupt(si - j);
+                return 0;
+            }
+            dlen = j;
+            break;
+        }
+        const uint8_t in = src[si++];
+        if (decode_[in] != 0xff) {
+            dbuf[j++] = decode_[in];
+            continue;
+        }
+        if (in == '\n' || in == '\r') {
+            continue;
+        }
+        if (static_cast<int32_t>(in) != pad_ || j < 2) {
+            err = corrupt(si - 1);
+            return 0;
+        }
+        if (j == 2) {
+            // "==" is expected, and the first '=' has been read
+            skipNewlines();
+            if (si == n) {
+                err = corrupt(n);
+                return 0;
+            }
+            if (static_cast<int32_t>(src[si]) != pad_) {
+                err = corrupt(si - 1);
+                return 0;
+            }
+            ++si;
+        }
+        skipNewlines();
+        if (si < n) {
+            err = corrupt(si);  // trailing garbage; what this quantum holds is still written
+        }
+        dlen = j;
+        break;
+    }
+    const uint32_t v = uint32_t(dbuf[0]) << 18 | uint32_t(dbuf[1]) << 12 | uint32_t(dbuf[2]) << 6 | dbuf[3];
+    uint8_t b0 = static_cast<uint8_t>(v >> 16), b1 = static_cast<uint8_t>(v >> 8), b2 = static_cast<uint8_t>(v);
+    switch (dlen) {
+        case 4:
+            dst[2] = b2;
+            b2 = 0;
+            [[fallthrough]];
+        case 3:
+            dst[1] = b1;
+            if (strict_ && b2 != 0) {
+                err = corrupt(si - 1);
+                return 0;
+            }
+            b1 = 0;
+            [[fallthrough]];
+        case 2:
+            dst[0] = b0;
+            if (strict_ && (b1 != 0 || b2 != 0)) {
+                err = corrupt(si - 2);
+                return 0;
+            }
+    }
+    return dlen - 1;
+}
+
+gocxx::base::Result<std::size_t> Encoding::Decode(uint8_t* dst, const uint8_t* src, std::size_t n) const {
+    const std::size_t cap = DecodedLen(n);
+    const Kernel* kernel = currentKernel().load(std::memory_order_relaxed);
+    const bool vector = kernel->decode && (standard_ || kernel->any_alphabet);
+    std::size_t si = 0;
+    std::size_t di = 0;
+    std::shared_ptr<gocxx::errors::Error> err;
+    while (si < n) {
+        if (vector) {
+            const Progress p = kernel->decode(dst + di, cap - di, src + si, n - si, encode_, decode_);
+            si += p.read;
+            di += p.written;
+        }
+        // Whole quanta, though with a kernel only a block's worth before it tries again
+        std::size_t quanta = vector ? 16 : n;
+        for (; quanta > 0 && n - si >= 4; --quanta, si += 4, di += 3) {
+            const uint8_t a = decode_[src[si]], b = decode_[src[si + 1]];
+            const uint8_t c = decode_[src[si + 2]], d = decode_[src[si + 3]];
+            if ((a | b | c | d) & 0x80) {  // 0xff marks bytes outside the alphabet
+                break;
+            }
+            const uint32_t v = uint32_t(a) << 18 | uint32_t(b) << 12 | uint32_t(c) << 6 | d;
+            dst[di] = static_cast<uint8_t>(v >> 16);
+            dst[di + 1] = static_cast<uint8_t>(v >> 8);
+            dst[di + 2] = static_cast<uint8_t>(v);
+        }
+        if (quanta == 0 || si == n) {
+            continue;
+        }
+        // A newline, padding, a bad byte or the short quantum at the end
+        di += decodeQuantum(dst + di, src, n, si, err);
+        if (err) {
+            return {di, err};
+        }
+    }
+    return {di, nullptr};
+}
+
+gocxx::base::Result<std::vector<uint8_t>> Encoding::DecodeString(std::string_view s) const {
+    std::vector<uint8_t> out(DecodedLen(s.size()));
+    auto n = Decode(out.data(), reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    out.resize(n.value);
+    return {std::move(out), n.err};
+}
+
+gocxx::base::Result<void> Encoding::AppendDecode(std::string& dst, std::string_view src) const {
+    const std::size_t old = dst.size();
+    dst.resize(old + DecodedLen(src.size()));
+    auto n = Decode(reinterpret_cast<uint8_t*>(dst.data()) + old, reinterpret_cast<const uint8_t*>(src.data()),
+                    src.size());
+    dst.resize(old + n.value);
+    return n.err;
+}
+
+const Encoding StdEncoding(kStdAlphabet);
+const Encoding URLEncoding(kURLAlphabet);
+const Encoding RawStdEncoding = StdEncoding.WithPadding(NoPadding);
+const Encoding RawURLEncoding = URLEncoding.WithPadding(NoPadding);
+
+// Streams
+
+namespace {
+
+class encoder : public gocxx::io::WriteCloser {
+public:
+    encoder(const Encoding& enc, std::shared_ptr<gocxx::io::Writer> w) : enc_(enc), w_(std::move(w)) {}
+
+    gocxx::base::Result<std::size_t> Write(const uint8_t* p, std::size_t n) override {
+        if (err_) {
+            return {0, err_};
+        }
+        std::size_t used = 0;
+        if (nbuf_ > 0) {
+            while (nbuf_ < 3 && used < n) buf_[nbuf_++] = p[used++];
+            if (nbuf_ < 3) {
+                return {n, nullptr};
+            }
+            emit(buf_, 3);
+            nbuf_ = 0;
+            if (err_) {
+                return {used, err_};
+            }
+        }
+        while (n - used >= 3) {
+            const std::size_t m = std::min((n - used) / 3 * 3, kChunk);
+            emit(p + used, m);
+            if (err_) {
+                return {used, err_};
+            }
+            used += m;
+        }
+        while (used < n) buf_[nbuf_++] = p[used++];
+        return {n, nullptr};
+    }
+
+    void close() override {
+        if (!err_ && nbuf_ > 0) {
+            emit(buf_, nbuf_);
+            nbuf_ = 0;
+        }
+    }
+
+private:
+    static constexpr std::size_t kChunk = 3 * 1024;
+
+    void emit(const uint8_t* p, std::size_t n) {
+        out_.resize(enc_.EncodedLen(n));
+        enc_.Encode(out_.data(), p, n);
+        auto written = w_->Write(out_.data(), out_.size());
+        if (written.Failed()) {
+            err_ = written.err;
+        } else if (written.value != out_.size()) {
+            err_ = gocxx::io::ErrShortWrite;
+        }
+    }
+
+    const Encoding enc_;
+    std::shared_ptr<gocxx::io::Writer> w_;
+    uint8_t buf_[3] = {};
+    std::size_t nbuf_ = 0;
+    std::vector<uint8_t> out_;
+    std::shared_ptr<gocxx::errors::Error> err_;
+};
+
+class decoder : public gocxx::io::Reader {
+public:
+    decoder(const Encoding& enc, std::shared_ptr<gocxx::io::Reader> r) : enc_(enc), r_(std::move(r)) {}
+
+    gocxx::base::Result<std::size_t> Read(uint8_t* p, std::size_t n) override {
+        while (pos_ == out_.size()) {
+            if (err_) {
+                return {0, err_};
+            }
+            if (eof_) {
+                return {0, gocxx::io::ErrEOF};
+            }
+            fill();
+        }
+        const std::size_t m = std::min(n, out_.size() - pos_);
+        std::memcpy(p, out_.data() + pos_, m);
+        pos_ += m;
+        return {m, nullptr};
+    }
+
+private:
+    static constexpr std::size_t kChunk = 4096;
+
+    // Reads more and decodes every whole quantum, or everything at the end
+    void fill() {
+        const std::size_t old = in_.size();
+        in_.resize(old + kChunk);
+        auto got = r_->Read(in_.data() + old, kChunk);
+        std::shared_ptr<gocxx::errors::Error> read_err;
+        if (got.Failed()) {
+            if (gocxx::errors::Is(got.err, gocxx::io::ErrEOF)) {
+                eof_ = true;
+            } else {
+                read_err = got.err;
+            }
+            in_.resize(old);
+        } else {
+            in_.resize(old + got.value);
+            eof_ = got.value == 0;
+        }
+        std::size_t cut = in_.size();
+        if (!eof_) {
+            cut = 0;
+            std::size_t significant = 0;
+            for (std::size_t i = 0; i < in_.size(); ++i) {
+                if (in_[i] != '\n' && in_[i] != '\r' && ++significant % 4 == 0) cut = i + 1;
+            }
+        }
+        out_.resize(enc_.DecodedLen(cut));
+        pos_ = 0;
+        auto n = enc_.Decode(out_.data(), in_.data(), cut);
+        out_.resize(n.value);
+        if (n.Failed()) {
+            std::shared_ptr<CorruptInputError> corrupt_err;
+            err_ = gocxx::errors::As(n.err, corrupt_err) ? corrupt(offset_ + corrupt_err->Offset()) : n.err;
+        } else if (read_err) {
+            err_ = read_err;
+        }
+        in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(cut));
+        offset_ += cut;
+    }
+
+    const Encoding enc_;
+    std::shared_ptr<gocxx::io::Reader> r_;
+    std::vector<uint8_t> in_;   // read but not yet decoded: a partial quantum
+    std::vector<uint8_t> out_;  // decoded, from pos_ not yet returned
+    std::size_t pos_ = 0;
+    std::size_t offset_ = 0;    // input bytes decoded before in_
+    bool eof_ = false;
+    std::shared_ptr<gocxx::errors::Error> err_;
+};
+
+} // namespace
+
+std::shared_ptr<gocxx::io::WriteCloser> NewEncoder(const Encoding& enc, std::shared_ptr<gocxx::io::Writer> w) {
+    return std::make_shared<encoder>(enc, std::move(w));
+}
+
+std::shared_ptr<gocxx::io::Reader> NewDecoder(const Encoding& enc, std::shared_ptr<gocxx::io::Reader> r) {
+    return std::make_shared<decoder>(enc, std::move(r));
+}
+
+} // namespace base64
+} // namespace encoding
+} // namespace gocxx
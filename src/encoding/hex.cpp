@@ -0,0 +1,470 @@
+/**
+ * @file hex.cpp
+ * @brief Hexadecimal encoding and decoding, with vector kernels for whole blocks
+ *
+ * Encoding splits each byte into nibbles and looks both up in a 16-entry
+ * table with one shuffle, then interleaves them. Decoding classifies each
+ * digit by range, adds the offset for its class, and joins pairs with a
+ * multiply-add; a block holding anything else goes to the scalar code.
+ */
+
+#include <gocxx/encoding/hex.h>
+#include <gocxx/io/io_errors.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+#endif
+
+namespace gocxx {
+namespace encoding {
+namespace hex {
+
+std::shared_ptr<gocxx::errors::Error> ErrLength = gocxx::errors::New("encoding/hex: odd length hex string");
+
+namespace {
+
+constexpr char kDigits[] = "0123456789abcdef";
+
+// 0xff for bytes that are not hex digits
+struct ReverseTable {
+    uint8_t value[256] = {};
+    constexpr ReverseTable() {
+        for (int c = 0; c < 256; ++c) {
+            value[c] = c >= '0' && c <= '9'   ? static_cast<uint8_t>(c - '0')
+                       : c >= 'a' && c <= 'f' ? static_cast<uint8_t>(c - 'a' + 10)
+                       : c >= 'A' && c <= 'F' ? static_cast<uint8_t>(c - 'A' + 10)
+                                              : 0xff;
+        }
+    }
+};
+
+constexpr ReverseTable kReverse;
+
+// Encode consumes whole blocks from the front of src and returns how many bytes
+// it took; Decode turns digit pairs into bytes until a block holds anything
+// else, returning the bytes written.
+using EncodeFunc = std::size_t (*)(uint8_t* dst, const uint8_t* src, std::size_t n);
+using DecodeFunc = std::size_t (*)(uint8_t* dst, const uint8_t* src, std::size_t n);
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define GOCXX_TARGET_SSSE3 __attribute__((target("ssse3")))
+    #define GOCXX_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define GOCXX_TARGET_SSSE3
+    #define GOCXX_TARGET_AVX2
+#endif
+
+// Bytes in [lo, hi]; the compares are signed, so bytes above 0x7f are never in range
+inline __m128i inRange(__m128i x, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmplt_epi8(x, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+// 16 digits to their values; false if any is not a digit
+inline bool nibblesSSE2(__m128i x, __m128i& values) {
+    const __m128i digit = inRange(x, '0', '9');
+    const __m128i lower = inRange(x, 'a', 'f');
+    const __m128i upper = inRange(x, 'A', 'F');
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(digit, lower), upper)) != 0xFFFF) {
+        return false;
+    }
+    __m128i shift = _mm_and_si128(digit, _mm_set1_epi8(-'0'));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(10 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(upper, _mm_set1_epi8(10 - 'A')));
+    values = _mm_add_epi8(x, shift);
+    return true;
+}
+
+GOCXX_TARGET_SSSE3 std::size_t encodeSSSE3(uint8_t* dst, const uint8_t* src, std::size_t n) {
+    const __m128i lut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kDigits));
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16, dst += 32) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), mask));
+        const __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(x, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+GOCXX_TARGET_SSSE3 std::size_t decodeSSSE3(uint8_t* dst, const uint8_t* src, std::size_t n) {
+    const __m128i weights = _mm_set1_epi16(0x0110);  // high digit times 16 plus low digit
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32, dst += 16) {
+        __m128i a, b;
+        if (!nibblesSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), a) ||
+            !nibblesSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)), b)) {
+            break;
+        }
+        const __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), bytes);
+    }
+    return i / 2;
+}
+
+GOCXX_TARGET_AVX2 std::size_t encodeAVX2(uint8_t* dst, const uint8_t* src, std::size_t n) {
+    const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kDigits)));
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32, dst += 64) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(x, 4), mask));
+        const __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(x, mask));
+        // The unpacks work within lanes: bytes 0-7 and 16-23, then 8-15 and 24-31
+        const __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        const __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i;
+}
+
+GOCXX_TARGET_AVX2 inline __m256i inRangeAVX2(__m256i x, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), x));
+}
+
+GOCXX_TARGET_AVX2 inline bool nibblesAVX2(__m256i x, __m256i& values) {
+    const __m256i digit = inRangeAVX2(x, '0', '9');
+    const __m256i lower = inRangeAVX2(x, 'a', 'f');
+    const __m256i upper = inRangeAVX2(x, 'A', 'F');
+    if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(digit, lower), upper)) != -1) {
+        return false;
+    }
+    __m256i shift = _mm256_and_si256(digit, _mm256_set1_epi8(-'0'));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(10 - 'a')));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(upper, _mm256_set1_epi8(10 - 'A')));
+    values = _mm256_add_epi8(x, shift);
+    return true;
+}
+
+GOCXX_TARGET_AVX2 std::size_t decodeAVX2(uint8_t* dst, const uint8_t* src, std::size_t n) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    std::size_t i = 0;
+    for (; i + 64 <= n; i += 64, dst += 32) {
+        __m256i a, b;
+        if (!nibblesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), a) ||
+            !nibblesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32)), b)) {
+            break;
+        }
+        // The pack works within lanes too, leaving the quarters in the order 0, 2, 1, 3
+        const __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute4x64_epi64(bytes, 0xD8));
+    }
+    return i / 2;
+}
+
+bool haveSSSE3() {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("ssse3");
+#else
+    return true;
+#endif
+}
+
+bool haveAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return true;  // built with /arch:AVX2
+#endif
+}
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+
+std::size_t encodeNEON(uint8_t* dst, const uint8_t* src, std::size_t n) {
+    const uint8x16_t lut = vld1q_u8(reinterpret_cast<const uint8_t*>(kDigits));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16, dst += 32) {
+        const uint8x16_t x = vld1q_u8(src + i);
+        uint8x16x2_t out;
+        out.val[0] = vqtbl1q_u8(lut, vshrq_n_u8(x, 4));
+        out.val[1] = vqtbl1q_u8(lut, vandq_u8(x, vdupq_n_u8(0x0f)));
+        vst2q_u8(dst, out);  // interleaves the two
+    }
+    return i;
+}
+
+// 16 digits to their values; false if any is not a digit
+inline bool nibblesNEON(uint8x16_t x, uint8x16_t& values) {
+    const uint8x16_t digit = vsubq_u8(x, vdupq_n_u8('0'));
+    const uint8x16_t letter = vsubq_u8(vorrq_u8(x, vdupq_n_u8(0x20)), vdupq_n_u8('a'));  // either case
+    const uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10));
+    const uint8x16_t is_letter = vcltq_u8(letter, vdupq_n_u8(6));
+    if (vminvq_u8(vorrq_u8(is_digit, is_letter)) == 0) {
+        return false;
+    }
+    values = vbslq_u8(is_digit, digit, vaddq_u8(letter, vdupq_n_u8(10)));
+    return true;
+}
+
+std::size_t decodeNEON(uint8_t* dst, const uint8_t* src, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32, dst += 16) {
+        const uint8x16x2_t in = vld2q_u8(src + i);  // high digits, then low ones
+        uint8x16_t hi, lo;
+        if (!nibblesNEON(in.val[0], hi) || !nibblesNEON(in.val[1], lo)) {
+            break;
+        }
+        vst1q_u8(dst, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    }
+    return i / 2;
+}
+
+#endif
+
+struct Kernel {
+    const char* name;
+    EncodeFunc encode;  // null for the scalar code alone
+    DecodeFunc decode;
+    bool (*supported)();
+};
+
+bool always() { return true; }
+
+// Best first
+const Kernel kKernels[] = {
+#if defined(__x86_64__) || defined(_M_X64)
+    {"avx2", encodeAVX2, decodeAVX2, haveAVX2},
+    {"ssse3", encodeSSSE3, decodeSSSE3, haveSSSE3},
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    {"neon", encodeNEON, decodeNEON, always},
+#endif
+    {"scalar", nullptr, nullptr, always},
+};
+
+const Kernel* bestKernel() {
+    for (const Kernel& k : kKernels) {
+        if (k.supported()) {
+            return &k;
+        }
+    }
+    return &kKernels[std::size(kKernels) - 1];
+}
+
+std::atomic<const Kernel*>& currentKernel() {
+    static std::atomic<const Kernel*> kernel{bestKernel()};
+    return kernel;
+}
+
+std::shared_ptr<gocxx::errors::Error> invalidByte(uint8_t b) {
+    return std::make_shared<InvalidByteError>(b);
+}
+
+} // namespace
+
+namespace detail {
+
+const char* HexKernel() {
+    return currentKernel().load(std::memory_order_relaxed)->name;
+}
+
+bool SetHexKernel(std::string_view name) {
+    for (const Kernel& k : kKernels) {
+        if (name == k.name) {
+            if (!k.supported()) {
+                return false;
+            }
+            currentKernel().store(&k, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace detail
+
+// As Go formats it with %#U: the code point, and the character if printable
+std::string InvalidByteError::error() const noexcept {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "U+%04X", byte_);
+    std::string s = std::string("encoding/hex: invalid byte: ") + buf;
+    if (byte_ >= 0x20 && byte_ < 0x7f) {
+        s += " '";
+        s += static_cast<char>(byte_);
+        s += '\'';
+    } else if (byte_ >= 0xa1 && byte_ != 0xad) {
+        s += " '";
+        s += static_cast<char>(0xc0 | byte_ >> 6);
+        s += static_cast<char>(0x80 | (byte_ & 0x3f));
+        s += '\'';
+    }
+    return s;
+}
+
+void Encode(uint8_t* dst, const uint8_t* src, std::size_t n) {
+    std::size_t i = 0;
+    const Kernel* kernel = currentKernel().load(std::memory_order_relaxed);
+    if (kernel->encode) {
+        i = kernel->encode(dst, src, n);
+    }
+    for (; i < n; ++i) {
+        dst[2 * i] = kDigits[src[i] >> 4];
+        dst[2 * i + 1] = kDigits[src[i] & 0x0f];
+    }
+}
+
+std::string EncodeToString(const uint8_t* src, std::size_t n) {
+    std::string out(EncodedLen(n), '\0');
+    Encode(reinterpret_cast<uint8_t*>(out.data()), src, n);
+    return out;
+}
+
+void AppendEncode(std::string& dst, std::string_view src) {
+    const std::size_t old = dst.size();
+    dst.resize(old + EncodedLen(src.size()));
+    Encode(reinterpret_cast<uint8_t*>(dst.data()) + old, reinterpret_cast<const uint8_t*>(src.data()), src.size());
+}
+
+gocxx::base::Result<std::size_t> Decode(uint8_t* dst, const uint8_t* src, std::size_t n) {
+    std::size_t i = 0;
+    const Kernel* kernel = currentKernel().load(std::memory_order_relaxed);
+    if (kernel->decode) {
+        i = kernel->decode(dst, src, n);
+    }
+    // The kernel stops at the block holding a bad digit, so this finds the first one
+    for (; 2 * i + 1 < n; ++i) {
+        const uint8_t hi = kReverse.value[src[2 * i]];
+        const uint8_t lo = kReverse.value[src[2 * i + 1]];
+        if (hi > 0x0f) {
+            return {i, invalidByte(src[2 * i])};
+        }
+        if (lo > 0x0f) {
+            return {i, invalidByte(src[2 * i + 1])};
+        }
+        dst[i] = static_cast<uint8_t>(hi << 4 | lo);
+    }
+    if (n % 2 == 1) {
+        // A bad last digit is the earlier problem
+        if (kReverse.value[src[n - 1]] > 0x0f) {
+            return {i, invalidByte(src[n - 1])};
+        }
+        return {i, ErrLength};
+    }
+    return {i, nullptr};
+}
+
+gocxx::base::Result<std::vector<uint8_t>> DecodeString(std::string_view s) {
+    std::vector<uint8_t> out(DecodedLen(s.size()));
+    auto n = Decode(out.data(), reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    out.resize(n.value);
+    return {std::move(out), n.err};
+}
+
+gocxx::base::Result<void> AppendDecode(std::string& dst, std::string_view src) {
+    const std::size_t old = dst.size();
+    dst.resize(old + DecodedLen(src.size()));
+    auto n = Decode(reinterpret_cast<uint8_t*>(dst.data()) + old, reinterpret_cast<const uint8_t*>(src.data()),
+                    src.size());
+    dst.resize(old + n.value);
+    return n.err;
+}
+
+// Streams
+
+namespace {
+
+class encoder : public gocxx::io::Writer {
+public:
+    explicit encoder(std::shared_ptr<gocxx::io::Writer> w) : w_(std::move(w)) {}
+
+    gocxx::base::Result<std::size_t> Write(const uint8_t* p, std::size_t n) override {
+        std::size_t done = 0;
+        while (done < n) {
+            const std::size_t m = std::min(n - done, kChunk);
+            Encode(out_, p + done, m);
+            auto written = w_->Write(out_, 2 * m);
+            if (written.Failed()) {
+                return {done + written.value / 2, written.err};
+            }
+            if (written.value != 2 * m) {
+                return {done + written.value / 2, gocxx::io::ErrShortWrite};
+            }
+            done += m;
+        }
+        return {n, nullptr};
+    }
+
+private:
+    static constexpr std::size_t kChunk = 1024;
+
+    std::shared_ptr<gocxx::io::Writer> w_;
+    uint8_t out_[2 * kChunk];
+};
+
+class decoder : public gocxx::io::Reader {
+public:
+    explicit decoder(std::shared_ptr<gocxx::io::Reader> r) : r_(std::move(r)) {}
+
+    gocxx::base::Result<std::size_t> Read(uint8_t* p, std::size_t n) override {
+        while (true) {
+            if (in_.size() >= 2 && n > 0) {
+                const std::size_t pairs = std::min(n, in_.size() / 2);
+                auto got = Decode(p, in_.data(), 2 * pairs);
+                if (got.Failed()) {
+                    err_ = got.err;  // the input after a bad digit is dropped
+                    in_.clear();
+                    if (got.value == 0) {
+                        return {0, err_};
+                    }
+                } else {
+                    in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(2 * pairs));
+                }
+                return {got.value, nullptr};
+            }
+            if (err_) {
+                return {0, err_};
+            }
+            fill();
+        }
+    }
+
+private:
+    static constexpr std::size_t kChunk = 4096;
+
+    void fill() {
+        const std::size_t old = in_.size();
+        in_.resize(old + kChunk);
+        auto got = r_->Read(in_.data() + old, kChunk);
+        in_.resize(old + (got.Ok() ? got.value : 0));
+        if (got.Failed() && !gocxx::errors::Is(got.err, gocxx::io::ErrEOF)) {
+            err_ = got.err;
+        } else if (got.Failed() || got.value == 0) {
+            if (in_.size() % 2 == 0) {
+                err_ = gocxx::io::ErrEOF;
+            } else if (kReverse.value[in_.back()] > 0x0f) {
+                err_ = invalidByte(in_.back());
+            } else {
+                err_ = gocxx::io::ErrUnexpectedEOF;
+            }
+        }
+    }
+
+    std::shared_ptr<gocxx::io::Reader> r_;
+    std::vector<uint8_t> in_;  // digits read but not yet decoded
+    std::shared_ptr<gocxx::errors::Error> err_;
+};
+
+} // namespace
+
+std::shared_ptr<gocxx::io::Writer> NewEncoder(std::shared_ptr<gocxx::io::Writer> w) {
+    return std::make_shared<encoder>(std::move(w));
+}
+
+std::shared_ptr<gocxx::io::Reader> NewDecoder(std::shared_ptr<gocxx::io::Reader> r) {
+    return std::make_shared<decoder>(std::move(r));
+}
+
+} // namespace hex
+} // namespace encoding
+} // namespace gocxx
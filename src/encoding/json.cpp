@@ -4,7 +4,11 @@
  */
 
 #include <gocxx/encoding/json.h>
+#include <gocxx/encoding/json_struct.h>
 #include <gocxx/errors/errors.h>
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/io/io_errors.h>
+#include <cstring>
 #include <sstream>
 #include <algorithm>
 
@@ -153,47 +157,50 @@ std::unique_ptr<Decoder> NewDecoder(std::shared_ptr<gocxx::io::Reader> reader) {
 Encoder::Encoder(std::shared_ptr<gocxx::io::Writer> writer)
     : writer_(writer), escape_html_(true) {}
 
-gocxx::base::Result<void> Encoder::Encode(const JsonValue& value) {
-    try {
-        std::string json_str;
-        
-        if (!indent_.empty()) {
-            int indent_size = static_cast<int>(indent_.size());
-            json_str = value.dump(indent_size);
-            
-            // Add prefix to each line if specified
-            if (!prefix_.empty()) {
-                std::istringstream iss(json_str);
-                std::ostringstream oss;
-                std::string line;
-                bool first = true;
-                while (std::getline(iss, line)) {
-                    if (!first) {
-                        oss << '\n';
-                    }
-                    oss << prefix_ << line;
-                    first = false;
-                }
-                json_str = oss.str();
-            }
-        } else {
-            json_str = value.dump();
+gocxx::base::Result<void> Encoder::encodeWith(const std::function<void(detail::WriteState&)>& write) {
+    constexpr std::size_t kChunk = detail::WriteState::kFlushAt;
+    std::shared_ptr<gocxx::errors::Error> err;
+    buf_.clear();
+    if (!prefix_.empty() || !indent_.empty()) {
+        compact_.clear();
+        detail::WriteState w(compact_);
+        w.escape_html = escape_html_;
+        write(w);
+        err = w.err;
+        if (!err) {
+            detail::AppendIndented(buf_, compact_, prefix_, indent_);
         }
-        
-        json_str += '\n'; // Go's encoder adds a newline
-        
-        std::vector<uint8_t> data(json_str.begin(), json_str.end());
-        auto write_result = writer_->Write(data);
-        if (!write_result.Ok()) {
-            return gocxx::base::Result<void>(write_result.err);
+        if (compact_.capacity() > 4 * kChunk) {
+            std::string().swap(compact_);  // a huge value should not pin its buffer
         }
-        
-        return gocxx::base::Result<void>();
-    } catch (const std::exception& e) {
-        return gocxx::base::Result<void>(
-            gocxx::errors::New("encode error: " + std::string(e.what()))
-        );
+    } else {
+        detail::WriteState w(buf_);
+        w.escape_html = escape_html_;
+        w.sink = writer_.get();  // flushes as it goes
+        write(w);
+        err = w.err;
     }
+
+    if (!err) {
+        buf_ += '\n'; // Go's encoder adds a newline
+        for (std::size_t off = 0; off < buf_.size() && !err; off += kChunk) {
+            const std::size_t n = std::min(kChunk, buf_.size() - off);
+            auto written = writer_->Write(reinterpret_cast<const uint8_t*>(buf_.data()) + off, n);
+            if (written.Failed()) {
+                err = written.err;
+            } else if (written.value != n) {
+                err = gocxx::io::ErrShortWrite;
+            }
+        }
+    }
+    if (buf_.capacity() > 4 * kChunk) {
+        std::string().swap(buf_);
+    }
+    return err ? gocxx::base::Result<void>(err) : gocxx::base::Result<void>();
+}
+
+gocxx::base::Result<void> Encoder::Encode(const JsonValue& value) {
+    return encodeWith([&value](detail::WriteState& w) { detail::WriteValue(w, value); });
 }
 
 void Encoder::SetIndent(const std::string& prefix, const std::string& indent) {
@@ -210,53 +217,334 @@ void Encoder::SetEscapeHTML(bool escape) {
 Decoder::Decoder(std::shared_ptr<gocxx::io::Reader> reader)
     : reader_(reader), use_number_(false), disable_unknown_fields_(false) {}
 
-gocxx::base::Result<void> Decoder::Decode(JsonValue& value) {
-    // Read all available data
-    std::vector<uint8_t> buffer(4096);
-    std::vector<uint8_t> data;
-    
-    while (true) {
-        auto read_result = reader_->Read(buffer);
-        if (!read_result.Ok()) {
-            if (data.empty()) {
-                return gocxx::base::Result<void>(read_result.err);
+namespace {
+
+constexpr std::size_t kDecoderMinRead = 4096;
+
+inline bool isSpace(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+std::string quoteChar(uint8_t c) {
+    char shown[8];
+    if (c >= 0x20 && c < 0x7F) {
+        std::snprintf(shown, sizeof(shown), "'%c'", c);
+    } else {
+        std::snprintf(shown, sizeof(shown), "'\\x%02x'", c);
+    }
+    return shown;
+}
+
+} // namespace
+
+// Appends the next read to the buffer, first dropping the bytes already consumed
+gocxx::base::Result<void> Decoder::refill() {
+    if (err_) {
+        return gocxx::base::Result<void>(err_);
+    }
+    if (scanp_ > 0) {
+        std::memmove(buf_.data(), buf_.data() + scanp_, len_ - scanp_);
+        dropped_ += scanp_;
+        len_ -= scanp_;
+        scanp_ = 0;
+    }
+    if (buf_.size() - len_ < kDecoderMinRead) {
+        buf_.resize(std::max(buf_.size() * 2, len_ + kDecoderMinRead));
+    }
+    auto read_result = reader_->Read(buf_.data() + len_, buf_.size() - len_);
+    if (read_result.Failed()) {
+        err_ = gocxx::errors::Is(read_result.err, gocxx::io::ErrEOF) ? gocxx::io::ErrEOF : read_result.err;
+        return gocxx::base::Result<void>(err_);
+    }
+    if (read_result.value == 0) {
+        err_ = gocxx::io::ErrEOF;
+        return gocxx::base::Result<void>(err_);
+    }
+    len_ += read_result.value;
+    return gocxx::base::Result<void>();
+}
+
+// The next byte that is not whitespace, left unread
+gocxx::base::Result<uint8_t> Decoder::peek() {
+    for (;;) {
+        for (; scanp_ < len_; ++scanp_) {
+            if (!isSpace(buf_[scanp_])) {
+                return gocxx::base::Result<uint8_t>(buf_[scanp_]);
             }
-            break; // Use what we have
         }
-        
-        if (read_result.value == 0) {
-            break; // No more data
+        auto fill_result = refill();
+        if (fill_result.Failed()) {
+            return gocxx::base::Result<uint8_t>(fill_result.err);
         }
-        
-        data.insert(data.end(), buffer.begin(), buffer.begin() + read_result.value);
-        
-        // Check if we have a complete JSON value
-        std::string json_str(data.begin(), data.end());
-        try {
-            value = JsonValue::parse(json_str);
-            return gocxx::base::Result<void>();
-        } catch (const nlohmann::json::parse_error&) {
-            // Continue reading more data
-            continue;
+    }
+}
+
+/**
+ * Finds where the value at scanp_ ends, reading until it has: the matching
+ * bracket, the closing quote, or for a number or literal the next delimiter
+ * or the end of the input. Scanning resumes where it stopped after each
+ * read, so a value is looked at once however it arrives; the grammar is
+ * left to the parser.
+ */
+gocxx::base::Result<std::size_t> Decoder::readValue() {
+    std::size_t i = 0;
+    std::size_t depth = 0;
+    bool in_string = false;
+    bool escaped = false;
+    for (;;) {
+        const uint8_t* p = buf_.data() + scanp_;
+        const std::size_t n = len_ - scanp_;
+        for (; i < n; ++i) {
+            const uint8_t c = p[i];
+            if (in_string) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    in_string = false;
+                    if (depth == 0) {
+                        return gocxx::base::Result<std::size_t>(i + 1);
+                    }
+                }
+                continue;
+            }
+            switch (c) {
+                case '"':
+                    if (depth == 0 && i > 0) {
+                        return gocxx::base::Result<std::size_t>(i);
+                    }
+                    in_string = true;
+                    break;
+                case '{':
+                case '[':
+                    if (depth == 0 && i > 0) {
+                        return gocxx::base::Result<std::size_t>(i);
+                    }
+                    ++depth;
+                    break;
+                case '}':
+                case ']':
+                    if (depth == 0) {
+                        return gocxx::base::Result<std::size_t>(i);
+                    }
+                    if (--depth == 0) {
+                        return gocxx::base::Result<std::size_t>(i + 1);
+                    }
+                    break;
+                case ',':
+                case ':':
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r':
+                    if (depth == 0) {
+                        return gocxx::base::Result<std::size_t>(i);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        auto fill_result = refill();
+        if (fill_result.Failed()) {
+            if (fill_result.err != gocxx::io::ErrEOF) {
+                return gocxx::base::Result<std::size_t>(fill_result.err);
+            }
+            if (depth == 0 && !in_string && i > 0) {
+                return gocxx::base::Result<std::size_t>(i);  // a number or literal ending the input
+            }
+            return gocxx::base::Result<std::size_t>(gocxx::io::ErrUnexpectedEOF);
         }
     }
-    
-    return Unmarshal(data, value);
+}
+
+gocxx::base::Result<void> Decoder::tokenPrepareForDecode() {
+    if (token_state_ == TokenState::ArrayComma || token_state_ == TokenState::ObjectColon) {
+        const bool comma = token_state_ == TokenState::ArrayComma;
+        auto c = peek();
+        if (c.Failed()) {
+            return gocxx::base::Result<void>(c.err);
+        }
+        if (c.value != (comma ? ',' : ':')) {
+            return gocxx::base::Result<void>(gocxx::errors::New(
+                std::string("json: expected ") + (comma ? "comma after array element" : "colon after object key") +
+                " at offset " + std::to_string(InputOffset())));
+        }
+        ++scanp_;
+        token_state_ = comma ? TokenState::ArrayValue : TokenState::ObjectValue;
+    }
+    return gocxx::base::Result<void>();
+}
+
+bool Decoder::tokenValueAllowed() const {
+    switch (token_state_) {
+        case TokenState::TopValue:
+        case TokenState::ArrayStart:
+        case TokenState::ArrayValue:
+        case TokenState::ObjectValue:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void Decoder::tokenValueEnd() {
+    switch (token_state_) {
+        case TokenState::ArrayStart:
+        case TokenState::ArrayValue:
+            token_state_ = TokenState::ArrayComma;
+            break;
+        case TokenState::ObjectValue:
+            token_state_ = TokenState::ObjectComma;
+            break;
+        default:
+            break;
+    }
+}
+
+std::shared_ptr<gocxx::errors::Error> Decoder::tokenError(uint8_t c) const {
+    const char* context;
+    switch (token_state_) {
+        case TokenState::ArrayComma: context = "after array element"; break;
+        case TokenState::ObjectKey:
+        case TokenState::ObjectStart: context = "looking for beginning of object key string"; break;
+        case TokenState::ObjectColon: context = "after object key"; break;
+        case TokenState::ObjectComma: context = "after object key:value pair"; break;
+        default: context = "looking for beginning of value"; break;
+    }
+    return gocxx::errors::New("json: invalid character " + quoteChar(c) + " " + context + " at offset " +
+                              std::to_string(InputOffset()));
+}
+
+// Reads up to the end of the next value, wherever Token() left off; the caller consumes it with valueDone()
+gocxx::base::Result<std::string_view> Decoder::nextValue() {
+    auto prepared = tokenPrepareForDecode();
+    if (prepared.Failed()) {
+        return gocxx::base::Result<std::string_view>(prepared.err);
+    }
+    if (!tokenValueAllowed()) {
+        return gocxx::base::Result<std::string_view>(
+            gocxx::errors::New("json: not at beginning of value at offset " + std::to_string(InputOffset())));
+    }
+    auto c = peek();
+    if (c.Failed()) {
+        return gocxx::base::Result<std::string_view>(c.err);
+    }
+    auto n = readValue();
+    if (n.Failed()) {
+        return gocxx::base::Result<std::string_view>(n.err);
+    }
+    if (n.value == 0) {
+        err_ = tokenError(c.value);
+        return gocxx::base::Result<std::string_view>(err_);
+    }
+    return gocxx::base::Result<std::string_view>(
+        std::string_view(reinterpret_cast<const char*>(buf_.data()) + scanp_, n.value));
+}
+
+void Decoder::valueDone(std::size_t n) {
+    scanp_ += n;
+    tokenValueEnd();
+}
+
+gocxx::base::Result<void> Decoder::Decode(JsonValue& value) {
+    auto next = nextValue();
+    if (next.Failed()) {
+        return gocxx::base::Result<void>(next.err);
+    }
+    try {
+        value = JsonValue::parse(next.value.begin(), next.value.end());
+    } catch (const std::exception& e) {
+        err_ = gocxx::errors::New("unmarshal error: " + std::string(e.what()));
+        return gocxx::base::Result<void>(err_);
+    }
+    valueDone(next.value.size());
+    return gocxx::base::Result<void>();
 }
 
 bool Decoder::More() {
-    // Simplified implementation - in real implementation would check stream
-    return false;
+    auto c = peek();
+    return c.Ok() && c.value != ']' && c.value != '}';
 }
 
-gocxx::base::Result<JsonValue> Decoder::Token() {
-    // Simplified implementation - would return individual tokens
-    JsonValue value;
-    auto result = Decode(value);
-    if (!result.Ok()) {
-        return gocxx::base::Result<JsonValue>(result.err);
+gocxx::base::Result<JsonToken> Decoder::Token() {
+    for (;;) {
+        auto c = peek();
+        if (c.Failed()) {
+            return gocxx::base::Result<JsonToken>(c.err);
+        }
+        const uint8_t ch = c.value;
+        switch (ch) {
+            case '[':
+            case '{':
+                if (!tokenValueAllowed()) {
+                    return gocxx::base::Result<JsonToken>(tokenError(ch));
+                }
+                ++scanp_;
+                token_stack_.push_back(token_state_);
+                token_state_ = ch == '[' ? TokenState::ArrayStart : TokenState::ObjectStart;
+                return gocxx::base::Result<JsonToken>(JsonToken{static_cast<char>(ch), {}});
+            case ']':
+            case '}': {
+                const bool array = ch == ']';
+                if (array ? token_state_ != TokenState::ArrayStart && token_state_ != TokenState::ArrayComma
+                          : token_state_ != TokenState::ObjectStart && token_state_ != TokenState::ObjectComma) {
+                    return gocxx::base::Result<JsonToken>(tokenError(ch));
+                }
+                ++scanp_;
+                token_state_ = token_stack_.back();
+                token_stack_.pop_back();
+                tokenValueEnd();
+                return gocxx::base::Result<JsonToken>(JsonToken{static_cast<char>(ch), {}});
+            }
+            case ':':
+                if (token_state_ != TokenState::ObjectColon) {
+                    return gocxx::base::Result<JsonToken>(tokenError(ch));
+                }
+                ++scanp_;
+                token_state_ = TokenState::ObjectValue;
+                continue;
+            case ',':
+                if (token_state_ == TokenState::ArrayComma) {
+                    ++scanp_;
+                    token_state_ = TokenState::ArrayValue;
+                    continue;
+                }
+                if (token_state_ == TokenState::ObjectComma) {
+                    ++scanp_;
+                    token_state_ = TokenState::ObjectKey;
+                    continue;
+                }
+                return gocxx::base::Result<JsonToken>(tokenError(ch));
+            case '"':
+                if (token_state_ == TokenState::ObjectStart || token_state_ == TokenState::ObjectKey) {
+                    // A key: decoded as a top-level string, then a colon is due
+                    const TokenState old = token_state_;
+                    token_state_ = TokenState::TopValue;
+                    JsonToken key;
+                    auto decoded = Decode(key.value);
+                    token_state_ = old;
+                    if (decoded.Failed()) {
+                        return gocxx::base::Result<JsonToken>(decoded.err);
+                    }
+                    token_state_ = TokenState::ObjectColon;
+                    return gocxx::base::Result<JsonToken>(std::move(key));
+                }
+                [[fallthrough]];
+            default: {
+                if (!tokenValueAllowed()) {
+                    return gocxx::base::Result<JsonToken>(tokenError(ch));
+                }
+                JsonToken token;
+                auto decoded = Decode(token.value);
+                if (decoded.Failed()) {
+                    return gocxx::base::Result<JsonToken>(decoded.err);
+                }
+                return gocxx::base::Result<JsonToken>(std::move(token));
+            }
+        }
     }
-    return gocxx::base::Result<JsonValue>(std::move(value));
 }
 
 void Decoder::UseNumber() {
@@ -0,0 +1,903 @@
+/**
+ * @file json_document.cpp
+ * @brief On-demand JSON parsing: SIMD structural indexing and lazy Element access
+ *
+ * Parse runs in two stages, as simdjson does. Stage one classifies the
+ * input 64 bytes at a time into bitmasks (quotes, backslashes, whitespace,
+ * operators), works out from them which bytes are inside strings, and
+ * writes the offset of every token to the index. Stage two walks that
+ * index once against the JSON grammar, checks literals and numbers, and
+ * records where each array and object ends.
+ */
+
+#include <gocxx/encoding/json_document.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace gocxx {
+namespace encoding {
+namespace json {
+
+std::shared_ptr<gocxx::errors::Error> ErrIncorrectType =
+    gocxx::errors::New("json: incorrect type");
+std::shared_ptr<gocxx::errors::Error> ErrNoSuchField =
+    gocxx::errors::New("json: no such field");
+std::shared_ptr<gocxx::errors::Error> ErrOutOfRange =
+    gocxx::errors::New("json: index or number out of range");
+
+namespace {
+
+// One bit per byte of a 64-byte block
+struct Masks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t ws;    // ' ', '\t', '\n', '\r'
+    uint64_t op;    // '{', '}', '[', ']', ':', ','
+    uint64_t ctrl;  // below 0x20
+    uint64_t high;  // 0x80 and above
+};
+
+using ClassifyFunc = void (*)(const uint8_t* block, Masks& m);
+
+enum : uint8_t {
+    kQuote = 1,
+    kBackslash = 2,
+    kSpace = 4,
+    kOp = 8,
+    kCtrl = 16,
+    kHigh = 32,
+};
+
+struct ByteClasses {
+    uint8_t cls[256] = {};
+    constexpr ByteClasses() {
+        for (int c = 0; c < 0x20; ++c) cls[c] = kCtrl;
+        for (int c = 0x80; c < 256; ++c) cls[c] = kHigh;
+        cls[' '] = kSpace;
+        cls['\t'] = kSpace | kCtrl;
+        cls['\n'] = kSpace | kCtrl;
+        cls['\r'] = kSpace | kCtrl;
+        cls['"'] = kQuote;
+        cls['\\'] = kBackslash;
+        cls['{'] = cls['}'] = cls['['] = cls[']'] = cls[':'] = cls[','] = kOp;
+    }
+};
+
+constexpr ByteClasses kClasses;
+
+inline bool isDelimiter(uint8_t c) {
+    return (kClasses.cls[c] & (kQuote | kSpace | kOp)) != 0;
+}
+
+inline int trailingZeros(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+void classifyScalar(const uint8_t* p, Masks& m) {
+    m = Masks{};
+    for (int i = 0; i < 64; ++i) {
+        const uint8_t c = kClasses.cls[p[i]];
+        const uint64_t bit = uint64_t{1} << i;
+        if (c & kQuote) m.quote |= bit;
+        if (c & kBackslash) m.backslash |= bit;
+        if (c & kSpace) m.ws |= bit;
+        if (c & kOp) m.op |= bit;
+        if (c & kCtrl) m.ctrl |= bit;
+        if (c & kHigh) m.high |= bit;
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+// SSE2 is part of x86-64, so this kernel needs no check
+void classifySSE2(const uint8_t* p, Masks& m) {
+    m = Masks{};
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i ctrl_max = _mm_set1_epi8(0x1F);
+    for (int k = 0; k < 4; ++k) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+        auto bits = [k](__m128i v) {
+            return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(v))) << (16 * k);
+        };
+        auto eq = [&x](char c) { return _mm_cmpeq_epi8(x, _mm_set1_epi8(c)); };
+        m.quote |= bits(_mm_cmpeq_epi8(x, quote));
+        m.backslash |= bits(_mm_cmpeq_epi8(x, backslash));
+        m.ws |= bits(_mm_or_si128(_mm_or_si128(eq(' '), eq('\t')), _mm_or_si128(eq('\n'), eq('\r'))));
+        m.op |= bits(_mm_or_si128(_mm_or_si128(_mm_or_si128(eq('{'), eq('}')), _mm_or_si128(eq('['), eq(']'))),
+                                  _mm_or_si128(eq(':'), eq(','))));
+        m.ctrl |= bits(_mm_cmpeq_epi8(_mm_min_epu8(x, ctrl_max), x));
+        m.high |= bits(x);
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__) || defined(__AVX2__)
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define GOCXX_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define GOCXX_TARGET_AVX2
+#endif
+
+GOCXX_TARGET_AVX2 inline uint64_t avx2Bits(__m256i v, int shift) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(v))) << shift;
+}
+
+GOCXX_TARGET_AVX2 void classifyAVX2(const uint8_t* p, Masks& m) {
+    m = Masks{};
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i ctrl_max = _mm256_set1_epi8(0x1F);
+    for (int k = 0; k < 2; ++k) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * k));
+        const int shift = 32 * k;
+        const __m256i sp = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t');
+        const __m256i nl = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+        const __m256i lb = _mm256_set1_epi8('{'), rb = _mm256_set1_epi8('}');
+        const __m256i ls = _mm256_set1_epi8('['), rs = _mm256_set1_epi8(']');
+        const __m256i colon = _mm256_set1_epi8(':'), comma = _mm256_set1_epi8(',');
+        const __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, sp), _mm256_cmpeq_epi8(x, tab)),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(x, nl), _mm256_cmpeq_epi8(x, cr)));
+        const __m256i op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, lb), _mm256_cmpeq_epi8(x, rb)),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(x, ls), _mm256_cmpeq_epi8(x, rs))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(x, colon), _mm256_cmpeq_epi8(x, comma)));
+        m.quote |= avx2Bits(_mm256_cmpeq_epi8(x, quote), shift);
+        m.backslash |= avx2Bits(_mm256_cmpeq_epi8(x, backslash), shift);
+        m.ws |= avx2Bits(ws, shift);
+        m.op |= avx2Bits(op, shift);
+        m.ctrl |= avx2Bits(_mm256_cmpeq_epi8(_mm256_min_epu8(x, ctrl_max), x), shift);
+        m.high |= avx2Bits(x, shift);
+    }
+}
+
+bool haveAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return true;  // built with /arch:AVX2
+#endif
+}
+
+#define GOCXX_JSON_HAVE_AVX2 1
+#endif
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+
+// One bit per lane of four comparison results, lane 0 of v0 lowest
+inline uint64_t neonBits(uint8x16_t v0, uint8x16_t v1, uint8x16_t v2, uint8x16_t v3) {
+    const uint8x16_t weight = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+                               0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+    uint8x16_t s0 = vpaddq_u8(vandq_u8(v0, weight), vandq_u8(v1, weight));
+    uint8x16_t s1 = vpaddq_u8(vandq_u8(v2, weight), vandq_u8(v3, weight));
+    s0 = vpaddq_u8(s0, s1);
+    s0 = vpaddq_u8(s0, s0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(s0), 0);
+}
+
+void classifyNEON(const uint8_t* p, Masks& m) {
+    uint8x16_t x[4];
+    for (int k = 0; k < 4; ++k) x[k] = vld1q_u8(p + 16 * k);
+    auto all = [&x](auto f) { return neonBits(f(x[0]), f(x[1]), f(x[2]), f(x[3])); };
+    auto eq = [](uint8x16_t v, uint8_t c) { return vceqq_u8(v, vdupq_n_u8(c)); };
+    m.quote = all([&](uint8x16_t v) { return eq(v, '"'); });
+    m.backslash = all([&](uint8x16_t v) { return eq(v, '\\'); });
+    m.ws = all([&](uint8x16_t v) {
+        return vorrq_u8(vorrq_u8(eq(v, ' '), eq(v, '\t')), vorrq_u8(eq(v, '\n'), eq(v, '\r')));
+    });
+    m.op = all([&](uint8x16_t v) {
+        return vorrq_u8(vorrq_u8(vorrq_u8(eq(v, '{'), eq(v, '}')), vorrq_u8(eq(v, '['), eq(v, ']'))),
+                        vorrq_u8(eq(v, ':'), eq(v, ',')));
+    });
+    m.ctrl = all([](uint8x16_t v) { return vcleq_u8(v, vdupq_n_u8(0x1F)); });
+    m.high = all([](uint8x16_t v) { return vcgeq_u8(v, vdupq_n_u8(0x80)); });
+}
+
+#endif
+
+struct Kernel {
+    const char* name;
+    ClassifyFunc classify;
+    bool (*supported)();
+};
+
+bool always() { return true; }
+
+// Best first
+const Kernel kKernels[] = {
+#if defined(GOCXX_JSON_HAVE_AVX2)
+    {"avx2", classifyAVX2, haveAVX2},
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+    {"sse2", classifySSE2, always},
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    {"neon", classifyNEON, always},
+#endif
+    {"scalar", classifyScalar, always},
+};
+
+const Kernel* bestKernel() {
+    for (const Kernel& k : kKernels) {
+        if (k.supported()) {
+            return &k;
+        }
+    }
+    return &kKernels[std::size(kKernels) - 1];
+}
+
+std::atomic<const Kernel*>& currentKernel() {
+    static std::atomic<const Kernel*> kernel{bestKernel()};
+    return kernel;
+}
+
+// Each bit set where an odd number of quotes precede it, itself included
+inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/**
+ * The characters escaped by a backslash, as simdjson finds them: a run of
+ * backslashes escapes the character after it when its length is odd.
+ * prev_escaped carries a trailing unpaired backslash into the next block.
+ */
+inline uint64_t findEscaped(uint64_t backslash, uint64_t& prev_escaped) {
+    backslash &= ~prev_escaped;
+    const uint64_t follows_escape = (backslash << 1) | prev_escaped;
+    constexpr uint64_t kEvenBits = 0x5555555555555555ULL;
+    const uint64_t odd_starts = backslash & ~kEvenBits & ~follows_escape;
+    const uint64_t sum = odd_starts + backslash;
+    prev_escaped = sum < odd_starts ? 1 : 0;
+    const uint64_t invert = sum << 1;
+    return (kEvenBits ^ invert) & follows_escape;
+}
+
+inline bool isHex(uint8_t c) {
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+}
+
+inline uint32_t hexValue(uint8_t c) {
+    return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+}
+
+uint32_t hex4(const char* p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) {
+        v = (v << 4) | hexValue(static_cast<uint8_t>(p[i]));
+    }
+    return v;
+}
+
+std::shared_ptr<gocxx::errors::Error> syntaxError(std::string_view what, uint8_t c, std::size_t offset) {
+    char shown[8];
+    if (c >= 0x20 && c < 0x7F) {
+        std::snprintf(shown, sizeof(shown), "'%c'", c);
+    } else {
+        std::snprintf(shown, sizeof(shown), "'\\x%02x'", c);
+    }
+    return gocxx::errors::New("json: " + std::string(what) + " " + shown + " at offset " +
+                              std::to_string(offset));
+}
+
+std::shared_ptr<gocxx::errors::Error> unexpectedEnd() {
+    return gocxx::errors::New("json: unexpected end of JSON input");
+}
+
+// The offset of the first invalid UTF-8 sequence at or after from, or npos
+std::size_t invalidUTF8(const uint8_t* s, std::size_t n, std::size_t from) {
+    std::size_t i = from;
+    while (i < n) {
+        if (i + 8 <= n) {
+            uint64_t w;
+            std::memcpy(&w, s + i, 8);
+            if ((w & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        const uint8_t c = s[i];
+        if (c < 0x80) {
+            ++i;
+            continue;
+        }
+        auto cont = [&](std::size_t j, uint8_t lo = 0x80, uint8_t hi = 0xBF) {
+            return j < n && s[j] >= lo && s[j] <= hi;
+        };
+        std::size_t len;
+        if (c >= 0xC2 && c <= 0xDF) {
+            len = cont(i + 1) ? 2 : 0;
+        } else if (c == 0xE0) {
+            len = cont(i + 1, 0xA0) && cont(i + 2) ? 3 : 0;
+        } else if (c == 0xED) {
+            len = cont(i + 1, 0x80, 0x9F) && cont(i + 2) ? 3 : 0;
+        } else if (c >= 0xE1 && c <= 0xEF) {
+            len = cont(i + 1) && cont(i + 2) ? 3 : 0;
+        } else if (c == 0xF0) {
+            len = cont(i + 1, 0x90) && cont(i + 2) && cont(i + 3) ? 4 : 0;
+        } else if (c >= 0xF1 && c <= 0xF3) {
+            len = cont(i + 1) && cont(i + 2) && cont(i + 3) ? 4 : 0;
+        } else if (c == 0xF4) {
+            len = cont(i + 1, 0x80, 0x8F) && cont(i + 2) && cont(i + 3) ? 4 : 0;
+        } else {
+            len = 0;
+        }
+        if (len == 0) {
+            return i;
+        }
+        i += len;
+    }
+    return std::string_view::npos;
+}
+
+// The length of the JSON number at the start of s, or 0 if there is none
+std::size_t numberLength(const char* s, std::size_t n) {
+    std::size_t i = 0;
+    auto digit = [&](std::size_t j) { return j < n && s[j] >= '0' && s[j] <= '9'; };
+    if (i < n && s[i] == '-') ++i;
+    if (!digit(i)) return 0;
+    if (s[i] == '0') {
+        ++i;
+    } else {
+        while (digit(i)) ++i;
+    }
+    if (i < n && s[i] == '.') {
+        if (!digit(++i)) return 0;
+        while (digit(i)) ++i;
+    }
+    if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+        ++i;
+        if (i < n && (s[i] == '+' || s[i] == '-')) ++i;
+        if (!digit(i)) return 0;
+        while (digit(i)) ++i;
+    }
+    return i;
+}
+
+void appendUTF8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+/**
+ * Decodes the escapes in a string's contents, which Parse validated. A
+ * surrogate half that is not part of a pair becomes U+FFFD, as in Go.
+ */
+void unescapeTo(std::string_view raw, std::string& out) {
+    out.clear();
+    out.reserve(raw.size());
+    std::size_t i = 0;
+    while (i < raw.size()) {
+        const std::size_t bs = raw.find('\\', i);
+        if (bs == std::string_view::npos) {
+            out.append(raw.data() + i, raw.size() - i);
+            break;
+        }
+        out.append(raw.data() + i, bs - i);
+        const char e = raw[bs + 1];
+        i = bs + 2;
+        switch (e) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t cp = hex4(raw.data() + i);
+                i += 4;
+                if (cp >= 0xD800 && cp < 0xDC00 && i + 6 <= raw.size() && raw[i] == '\\' && raw[i + 1] == 'u') {
+                    const uint32_t lo = hex4(raw.data() + i + 2);
+                    if (lo >= 0xDC00 && lo < 0xE000) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        i += 6;
+                    }
+                }
+                if (cp >= 0xD800 && cp < 0xE000) {
+                    cp = 0xFFFD;
+                }
+                appendUTF8(out, cp);
+                break;
+            }
+            default: out += e; break;  // '"', '\\' and '/'
+        }
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+const char* JsonKernel() {
+    return currentKernel().load(std::memory_order_relaxed)->name;
+}
+
+bool SetJsonKernel(std::string_view name) {
+    for (const Kernel& k : kKernels) {
+        if (name == k.name) {
+            if (!k.supported()) {
+                return false;
+            }
+            currentKernel().store(&k, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace detail
+
+// Document
+
+gocxx::base::Result<void> Document::Parse(std::string_view json) {
+    parsed_ = false;
+    input_ = json;
+    unescaped_.clear();
+
+    const std::size_t n = json.size();
+    if (n > std::numeric_limits<uint32_t>::max() - 64) {
+        return {gocxx::errors::New("json: input too large")};
+    }
+    const auto* data = reinterpret_cast<const uint8_t*>(json.data());
+    const ClassifyFunc classify = currentKernel().load(std::memory_order_relaxed)->classify;
+
+    // Stage 1: find every token
+    std::size_t count = 0;
+    uint64_t prev_escaped = 0, prev_in_string = 0, prev_scalar = 0;
+    std::size_t first_high = std::string_view::npos;
+    for (std::size_t off = 0; off < n; off += 64) {
+        const uint8_t* p = data + off;
+        uint8_t tail[64];
+        if (n - off < 64) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, p, n - off);
+            p = tail;
+        }
+        Masks m;
+        classify(p, m);
+
+        const uint64_t escaped = m.backslash | prev_escaped ? findEscaped(m.backslash, prev_escaped) : 0;
+        const uint64_t quotes = m.quote & ~escaped;
+        const uint64_t in_string = prefixXor(quotes) ^ prev_in_string;  // opening quotes and contents
+        prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+        if (uint64_t bad = m.ctrl & in_string) {
+            const int i = trailingZeros(bad);
+            return {syntaxError("invalid character", p[i], off + i)};
+        }
+        for (uint64_t esc = escaped & in_string; esc; esc &= esc - 1) {
+            const int i = trailingZeros(esc);
+            const uint8_t c = p[i];
+            bool ok = std::strchr("\"\\/bfnrt", c) != nullptr && c != '\0';
+            if (c == 'u') {
+                const std::size_t at = off + i + 1;
+                ok = at + 4 <= n && isHex(data[at]) && isHex(data[at + 1]) && isHex(data[at + 2]) &&
+                     isHex(data[at + 3]);
+            }
+            if (!ok) {
+                return {syntaxError("invalid escape", c, off + i)};
+            }
+        }
+        if (m.high && first_high == std::string_view::npos) {
+            first_high = off;
+        }
+
+        const uint64_t outside = ~in_string & ~quotes;
+        const uint64_t scalar = ~(m.op | m.ws) & outside;
+        const uint64_t scalar_start = scalar & ~((scalar << 1) | prev_scalar);
+        prev_scalar = scalar >> 63;
+        uint64_t tokens = (m.op & ~in_string) | (quotes & in_string) | scalar_start;
+
+        if (count + 64 > index_.size()) {
+            index_.resize(std::max(index_.size() * 2, count + 64));
+        }
+        uint32_t* out = index_.data() + count;
+        const auto base = static_cast<uint32_t>(off);
+        for (; tokens; tokens &= tokens - 1) {
+            *out++ = base + static_cast<uint32_t>(trailingZeros(tokens));
+        }
+        count = static_cast<std::size_t>(out - index_.data());
+    }
+    if (prev_in_string) {
+        return {unexpectedEnd()};
+    }
+    if (first_high != std::string_view::npos) {
+        const std::size_t at = invalidUTF8(data, n, first_high);
+        if (at != std::string_view::npos) {
+            return {syntaxError("invalid UTF-8 byte", data[at], at)};
+        }
+    }
+
+    // Stage 2: check the tokens against the grammar
+    enum class State { Value, ArrayFirst, ObjectFirst, Key, Colon, AfterValue };
+    State state = State::Value;
+    std::vector<uint32_t> open;  // indexes of the brackets not yet closed
+    ends_.resize(std::max(ends_.size(), count));  // like index_, only grows so that a reparse need not refill it
+    for (std::size_t t = 0; t < count; ++t) {
+        const uint32_t pos = index_[t];
+        const uint8_t c = data[pos];
+        switch (state) {
+            case State::ArrayFirst:
+                if (c == ']') {
+                    ends_[open.back()] = static_cast<uint32_t>(t);
+                    open.pop_back();
+                    state = State::AfterValue;
+                    break;
+                }
+                [[fallthrough]];
+            case State::Value:
+                if (c == '{' || c == '[') {
+                    if (open.size() >= kMaxDepth) {
+                        return {gocxx::errors::New("json: exceeded max depth at offset " + std::to_string(pos))};
+                    }
+                    open.push_back(static_cast<uint32_t>(t));
+                    state = c == '{' ? State::ObjectFirst : State::ArrayFirst;
+                } else if (c == '"') {
+                    state = State::AfterValue;
+                } else {
+                    std::size_t end = pos;
+                    while (end < n && !isDelimiter(data[end])) ++end;
+                    const std::string_view run = json.substr(pos, end - pos);
+                    // A structural character here leaves an empty run, which
+                    // numberLength would accept, so a number must start like one
+                    const bool ok = c == 't'   ? run == "true"
+                                    : c == 'f' ? run == "false"
+                                    : c == 'n' ? run == "null"
+                                               : (c == '-' || (c >= '0' && c <= '9')) &&
+                                                     numberLength(run.data(), run.size()) == run.size();
+                    if (!ok) {
+                        return {syntaxError("invalid character", c, pos)};
+                    }
+                    state = State::AfterValue;
+                }
+                break;
+            case State::ObjectFirst:
+                if (c == '}') {
+                    ends_[open.back()] = static_cast<uint32_t>(t);
+                    open.pop_back();
+                    state = State::AfterValue;
+                    break;
+                }
+                [[fallthrough]];
+            case State::Key:
+                if (c != '"') {
+                    return {syntaxError("invalid character", c, pos)};
+                }
+                state = State::Colon;
+                break;
+            case State::Colon:
+                if (c != ':') {
+                    return {syntaxError("invalid character", c, pos)};
+                }
+                state = State::Value;
+                break;
+            case State::AfterValue: {
+                if (open.empty()) {
+                    return {syntaxError("invalid character", c, pos)};
+                }
+                const bool in_array = data[index_[open.back()]] == '[';
+                if (c == ',') {
+                    state = in_array ? State::Value : State::Key;
+                } else if (c == (in_array ? ']' : '}')) {
+                    ends_[open.back()] = static_cast<uint32_t>(t);
+                    open.pop_back();
+                } else {
+                    return {syntaxError("invalid character", c, pos)};
+                }
+                break;
+            }
+        }
+    }
+    if (state != State::AfterValue || !open.empty()) {
+        return {unexpectedEnd()};
+    }
+    parsed_ = true;
+    return {};
+}
+
+Element Document::Root() const {
+    return parsed_ ? Element(this, 0) : Element();
+}
+
+std::string_view Document::unescape(std::size_t quote, std::size_t end) const {
+    unescaped_.emplace_back();
+    unescapeTo(input_.substr(quote + 1, end - quote - 1), unescaped_.back());
+    return unescaped_.back();
+}
+
+// Element
+
+namespace {
+
+// The offset of the quote closing the string opened at quote
+std::size_t stringEnd(std::string_view in, std::size_t quote) {
+    std::size_t q = quote;
+    for (;;) {
+        q = in.find('"', q + 1);
+        std::size_t bs = 0;
+        while (in[q - 1 - bs] == '\\') ++bs;
+        if (bs % 2 == 0) {
+            return q;
+        }
+    }
+}
+
+} // namespace
+
+Kind Element::Type() const {
+    if (!doc_) {
+        return Kind::Null;
+    }
+    switch (doc_->input_[doc_->index_[index_]]) {
+        case '{': return Kind::Object;
+        case '[': return Kind::Array;
+        case '"': return Kind::String;
+        case 't':
+        case 'f': return Kind::Bool;
+        case 'n': return Kind::Null;
+        default: return Kind::Number;
+    }
+}
+
+gocxx::base::Result<bool> Element::GetBool() const {
+    if (Type() != Kind::Bool) {
+        return {ErrIncorrectType};
+    }
+    return {doc_->input_[doc_->index_[index_]] == 't'};
+}
+
+gocxx::base::Result<int64_t> Element::GetInt() const {
+    if (Type() != Kind::Number) {
+        return {ErrIncorrectType};
+    }
+    const std::string_view raw = Raw();
+    int64_t v = 0;
+    auto [ptr, ec] = std::from_chars(raw.data(), raw.data() + raw.size(), v);
+    if (ec == std::errc::result_out_of_range) {
+        return {ErrOutOfRange};
+    }
+    if (ptr != raw.data() + raw.size()) {
+        return {ErrIncorrectType};
+    }
+    return {v};
+}
+
+gocxx::base::Result<uint64_t> Element::GetUint() const {
+    if (Type() != Kind::Number) {
+        return {ErrIncorrectType};
+    }
+    const std::string_view raw = Raw();
+    if (raw[0] == '-') {
+        return {raw.find_first_of(".eE") == std::string_view::npos ? ErrOutOfRange : ErrIncorrectType};
+    }
+    uint64_t v = 0;
+    auto [ptr, ec] = std::from_chars(raw.data(), raw.data() + raw.size(), v);
+    if (ec == std::errc::result_out_of_range) {
+        return {ErrOutOfRange};
+    }
+    if (ptr != raw.data() + raw.size()) {
+        return {ErrIncorrectType};
+    }
+    return {v};
+}
+
+gocxx::base::Result<double> Element::GetFloat() const {
+    if (Type() != Kind::Number) {
+        return {ErrIncorrectType};
+    }
+    const std::string_view raw = Raw();
+    double v = 0;
+    auto [ptr, ec] = std::from_chars(raw.data(), raw.data() + raw.size(), v);
+    if (ec == std::errc::result_out_of_range) {
+        return {ErrOutOfRange};
+    }
+    return {v};
+}
+
+gocxx::base::Result<std::string_view> Element::GetString() const {
+    if (Type() != Kind::String) {
+        return {ErrIncorrectType};
+    }
+    const std::string_view in = doc_->input_;
+    const std::size_t quote = doc_->index_[index_];
+    const std::size_t end = stringEnd(in, quote);
+    const std::string_view raw = in.substr(quote + 1, end - quote - 1);
+    if (raw.find('\\') == std::string_view::npos) {
+        return {raw};
+    }
+    return {doc_->unescape(quote, end)};
+}
+
+std::string_view Element::Raw() const {
+    if (!doc_) {
+        return {};
+    }
+    const std::string_view in = doc_->input_;
+    const std::size_t pos = doc_->index_[index_];
+    std::size_t end;
+    switch (in[pos]) {
+        case '{':
+        case '[': end = doc_->index_[doc_->ends_[index_]] + 1; break;
+        case '"': end = stringEnd(in, pos) + 1; break;
+        default:
+            end = pos;
+            while (end < in.size() && !isDelimiter(static_cast<uint8_t>(in[end]))) ++end;
+    }
+    return in.substr(pos, end - pos);
+}
+
+uint32_t Element::next() const {
+    const char c = doc_->input_[doc_->index_[index_]];
+    return c == '{' || c == '[' ? doc_->ends_[index_] + 1 : index_ + 1;
+}
+
+uint32_t Element::following() const {
+    const uint32_t n = next();
+    return doc_->input_[doc_->index_[n]] == ',' ? n + 1 : n;
+}
+
+gocxx::base::Result<Element> Element::Get(std::string_view key) const {
+    if (Type() != Kind::Object) {
+        return {ErrIncorrectType};
+    }
+    const std::string_view in = doc_->input_;
+    const uint32_t end = doc_->ends_[index_];
+    std::string scratch;
+    for (uint32_t k = index_ + 1; k != end; k = Element(doc_, k + 2).following()) {
+        const std::size_t quote = doc_->index_[k];
+        const std::size_t close = stringEnd(in, quote);
+        const std::string_view raw = in.substr(quote + 1, close - quote - 1);
+        bool match;
+        if (raw.find('\\') == std::string_view::npos) {
+            match = raw == key;
+        } else {
+            unescapeTo(raw, scratch);
+            match = scratch == key;
+        }
+        if (match) {
+            return {Element(doc_, k + 2)};
+        }
+    }
+    return {ErrNoSuchField};
+}
+
+gocxx::base::Result<Element> Element::At(std::size_t index) const {
+    if (Type() != Kind::Array) {
+        return {ErrIncorrectType};
+    }
+    for (Element e : Elements()) {
+        if (index-- == 0) {
+            return {e};
+        }
+    }
+    return {ErrOutOfRange};
+}
+
+gocxx::base::Result<std::size_t> Element::Size() const {
+    const Kind kind = Type();
+    if (kind != Kind::Array && kind != Kind::Object) {
+        return {ErrIncorrectType};
+    }
+    std::size_t n = 0;
+    if (kind == Kind::Array) {
+        for (auto it = Elements().begin(), end = Elements().end(); it != end; ++it) ++n;
+    } else {
+        for (auto it = Members().begin(), end = Members().end(); it != end; ++it) ++n;
+    }
+    return {n};
+}
+
+Element::ArrayRange Element::Elements() const {
+    if (Type() != Kind::Array) {
+        return ArrayRange(doc_, 0, 0);
+    }
+    const uint32_t end = doc_->ends_[index_];
+    return ArrayRange(doc_, index_ + 1 == end ? end : index_ + 1, end);
+}
+
+Element::ObjectRange Element::Members() const {
+    if (Type() != Kind::Object) {
+        return ObjectRange(doc_, 0, 0);
+    }
+    const uint32_t end = doc_->ends_[index_];
+    return ObjectRange(doc_, index_ + 1 == end ? end : index_ + 1, end);
+}
+
+gocxx::base::Result<JsonValue> Element::Value() const {
+    switch (Type()) {
+        case Kind::Null:
+            return {JsonValue(nullptr)};
+        case Kind::Bool:
+            return {JsonValue(GetBool().value)};
+        case Kind::String:
+            return {JsonValue(std::string(GetString().value))};
+        case Kind::Number: {
+            // As nlohmann reads numbers: unsigned, then signed, then double
+            const std::string_view raw = Raw();
+            if (raw.find_first_of(".eE") == std::string_view::npos) {
+                if (raw[0] != '-') {
+                    auto u = GetUint();
+                    if (u.Ok()) return {JsonValue(u.value)};
+                } else {
+                    auto i = GetInt();
+                    if (i.Ok()) return {JsonValue(i.value)};
+                }
+            }
+            auto f = GetFloat();
+            if (f.Failed()) return {f.err};
+            return {JsonValue(f.value)};
+        }
+        case Kind::Array: {
+            JsonValue arr = JsonValue::array();
+            for (Element e : Elements()) {
+                auto v = e.Value();
+                if (v.Failed()) return v;
+                arr.push_back(std::move(v.value));
+            }
+            return {std::move(arr)};
+        }
+        case Kind::Object: {
+            JsonValue obj = JsonValue::object();
+            for (const Member& m : Members()) {
+                auto v = m.value.Value();
+                if (v.Failed()) return v;
+                obj[std::string(m.key)] = std::move(v.value);
+            }
+            return {std::move(obj)};
+        }
+    }
+    return {ErrIncorrectType};
+}
+
+Element::ArrayRange::iterator& Element::ArrayRange::iterator::operator++() {
+    index_ = Element(doc_, index_).following();
+    return *this;
+}
+
+Member Element::ObjectRange::iterator::operator*() const {
+    return Member{Element(doc_, index_).GetString().value, Element(doc_, index_ + 2)};
+}
+
+Element::ObjectRange::iterator& Element::ObjectRange::iterator::operator++() {
+    index_ = Element(doc_, index_ + 2).following();
+    return *this;
+}
+
+} // namespace json
+} // namespace encoding
+} // namespace gocxx
@@ -0,0 +1,359 @@
+/**
+ * @file json_struct.cpp
+ * @brief The non-template parts of the struct binding and the Encoder's
+ *        serializer: strings, numbers and whole values formatted as Go
+ *        writes them, indentation, and error messages
+ */
+
+#include <gocxx/encoding/json_struct.h>
+#include <gocxx/io/io_errors.h>
+#include <cstdio>
+#include <cstring>
+
+namespace gocxx {
+namespace encoding {
+namespace json {
+namespace detail {
+
+namespace {
+
+// Bytes written as they are inside a string: printable ASCII except '"' and '\\', and with html also '<', '>' and '&'
+struct SafeBytes {
+    bool safe[256] = {};
+    constexpr SafeBytes(bool html) {
+        for (int c = 0x20; c < 0x80; ++c) {
+            safe[c] = c != '"' && c != '\\' && !(html && (c == '<' || c == '>' || c == '&'));
+        }
+    }
+};
+
+constexpr SafeBytes kSafe(false);
+constexpr SafeBytes kSafeHTML(true);
+
+constexpr uint64_t kOnes = 0x0101010101010101ULL;
+constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+inline uint64_t hasByte(uint64_t w, uint8_t b) {
+    const uint64_t v = w ^ (kOnes * b);
+    return (v - kOnes) & ~v & kHighBits;
+}
+
+// Whether any of 8 bytes is not safe: it is what lets runs of plain text go by a word at a time
+inline bool wordNeedsEscape(const unsigned char* p, bool html) {
+    uint64_t w;
+    std::memcpy(&w, p, 8);
+    uint64_t m = (w & kHighBits) | ((w - kOnes * 0x20) & ~w & kHighBits) | hasByte(w, '"') | hasByte(w, '\\');
+    if (html) {
+        m |= hasByte(w, '<') | hasByte(w, '>') | hasByte(w, '&');
+    }
+    return m != 0;
+}
+
+// The length of the UTF-8 sequence at s, or 0 if it is not valid
+std::size_t utf8Length(const unsigned char* s, std::size_t n) {
+    const unsigned char c = s[0];
+    auto cont = [&](std::size_t i, unsigned char lo = 0x80, unsigned char hi = 0xBF) {
+        return i < n && s[i] >= lo && s[i] <= hi;
+    };
+    if (c >= 0xC2 && c <= 0xDF) return cont(1) ? 2 : 0;
+    if (c == 0xE0) return cont(1, 0xA0) && cont(2) ? 3 : 0;
+    if (c == 0xED) return cont(1, 0x80, 0x9F) && cont(2) ? 3 : 0;
+    if (c >= 0xE1 && c <= 0xEF) return cont(1) && cont(2) ? 3 : 0;
+    if (c == 0xF0) return cont(1, 0x90) && cont(2) && cont(3) ? 4 : 0;
+    if (c >= 0xF1 && c <= 0xF3) return cont(1) && cont(2) && cont(3) ? 4 : 0;
+    if (c == 0xF4) return cont(1, 0x80, 0x8F) && cont(2) && cont(3) ? 4 : 0;
+    return 0;
+}
+
+template <typename F>
+bool appendFloat(std::string& out, F v, F low, F high) {
+    if (!std::isfinite(v)) {
+        return false;
+    }
+    const F abs = std::fabs(v);
+    const bool exp = abs != 0 && (abs < low || abs >= high);
+    char buf[64];
+    auto res = std::to_chars(buf, buf + sizeof(buf), v, exp ? std::chars_format::scientific : std::chars_format::fixed);
+    std::size_t n = static_cast<std::size_t>(res.ptr - buf);
+    // Go writes e-07 as e-7
+    if (exp && n >= 4 && buf[n - 4] == 'e' && buf[n - 3] == '-' && buf[n - 2] == '0') {
+        buf[n - 2] = buf[n - 1];
+        --n;
+    }
+    out.append(buf, n);
+    return true;
+}
+
+} // namespace
+
+/**
+ * Writes s as a JSON string the way Go's encoder does: quotes, backslashes
+ * and control characters are escaped, so are <, > and & with escape_html,
+ * U+2028 and U+2029 are written as \u escapes, and invalid UTF-8 becomes
+ * \ufffd.
+ */
+void AppendQuoted(std::string& out, std::string_view s, bool escape_html) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    const bool* safe = escape_html ? kSafeHTML.safe : kSafe.safe;
+    const auto* p = reinterpret_cast<const unsigned char*>(s.data());
+    const std::size_t n = s.size();
+    out.reserve(out.size() + n + 2);
+    out += '"';
+    std::size_t start = 0;
+    std::size_t i = 0;
+    while (i < n) {
+        if (i + 8 <= n && !wordNeedsEscape(p + i, escape_html)) {
+            i += 8;
+            continue;
+        }
+        const unsigned char c = p[i];
+        if (safe[c]) {
+            ++i;
+            continue;
+        }
+        if (c >= 0x80) {
+            const std::size_t len = utf8Length(p + i, n - i);
+            if (len == 3 && c == 0xE2 && p[i + 1] == 0x80 && (p[i + 2] == 0xA8 || p[i + 2] == 0xA9)) {
+                out.append(s.data() + start, i - start);
+                out += p[i + 2] == 0xA8 ? "\\u2028" : "\\u2029";
+                i += 3;
+                start = i;
+            } else if (len == 0) {
+                out.append(s.data() + start, i - start);
+                out += "\\ufffd";
+                start = ++i;
+            } else {
+                i += len;
+            }
+            continue;
+        }
+        out.append(s.data() + start, i - start);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default:
+                out += "\\u00";
+                out += kHex[c >> 4];
+                out += kHex[c & 0xF];
+        }
+        start = ++i;
+    }
+    out.append(s.data() + start, n - start);
+    out += '"';
+}
+
+// Shortest round-trip digits, in Go's choice of plain or exponent form
+bool AppendFloat(std::string& out, double v) {
+    return appendFloat(out, v, 1e-6, 1e21);
+}
+
+bool AppendFloat(std::string& out, float v) {
+    return appendFloat(out, v, 1e-6f, 1e21f);
+}
+
+bool EqualFold(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        char x = a[i], y = b[i];
+        if (x >= 'A' && x <= 'Z') x += 'a' - 'A';
+        if (y >= 'A' && y <= 'Z') y += 'a' - 'A';
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WriteState::flush() {
+    if (!sink || out.empty()) {
+        return;
+    }
+    if (!err) {
+        auto written = sink->Write(reinterpret_cast<const uint8_t*>(out.data()), out.size());
+        if (written.Failed()) {
+            err = written.err;
+        } else if (written.value != out.size()) {
+            err = gocxx::io::ErrShortWrite;
+        }
+    }
+    out.clear();  // after an error, the rest of the value is dropped
+}
+
+void WriteValue(WriteState& w, const JsonValue& v) {
+    using Type = JsonValue::value_t;
+    char buf[24];
+    switch (v.type()) {
+        case Type::null:
+            w.out += "null";
+            break;
+        case Type::boolean:
+            w.out += v.get<bool>() ? "true" : "false";
+            break;
+        case Type::number_integer:
+            w.out.append(buf, std::to_chars(buf, buf + sizeof(buf), v.get<int64_t>()).ptr);
+            break;
+        case Type::number_unsigned:
+            w.out.append(buf, std::to_chars(buf, buf + sizeof(buf), v.get<uint64_t>()).ptr);
+            break;
+        case Type::number_float: {
+            const double f = v.get<double>();
+            if (!AppendFloat(w.out, f) && !w.err) {
+                w.err = UnsupportedValueError(f);
+            }
+            break;
+        }
+        case Type::string:
+            w.quote(v.get_ref<const std::string&>());
+            break;
+        case Type::array: {
+            w.out += '[';
+            bool first = true;
+            for (const auto& item : v) {
+                if (!first) w.out += ',';
+                first = false;
+                WriteValue(w, item);
+                w.flushIfFull();
+            }
+            w.out += ']';
+            break;
+        }
+        case Type::object: {
+            w.out += '{';
+            bool first = true;
+            for (const auto& item : v.items()) {  // a std::map, so already sorted
+                if (!first) w.out += ',';
+                first = false;
+                w.quote(item.key());
+                w.out += ':';
+                WriteValue(w, item.value());
+                w.flushIfFull();
+            }
+            w.out += '}';
+            break;
+        }
+        case Type::binary:
+            w.out += v.dump();
+            break;
+        case Type::discarded:
+            if (!w.err) w.err = gocxx::errors::New("json: unsupported value: discarded");
+            break;
+    }
+}
+
+void AppendIndented(std::string& out, std::string_view compact, std::string_view prefix, std::string_view indent) {
+    auto newline = [&](std::size_t depth) {
+        out += '\n';
+        out += prefix;
+        for (std::size_t i = 0; i < depth; ++i) out += indent;
+    };
+    out += prefix;
+    std::size_t depth = 0;
+    bool need_indent = false;  // just opened a container, which may turn out empty
+    bool in_string = false;
+    bool escaped = false;
+    for (const char c : compact) {
+        if (in_string) {
+            out += c;
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                in_string = false;
+            }
+            continue;
+        }
+        if (need_indent && c != ']' && c != '}') {
+            need_indent = false;
+            newline(++depth);
+        }
+        switch (c) {
+            case '"':
+                in_string = true;
+                out += c;
+                break;
+            case '{':
+            case '[':
+                need_indent = true;
+                out += c;
+                break;
+            case ',':
+                out += c;
+                newline(depth);
+                break;
+            case ':':
+                out += ": ";
+                break;
+            case '}':
+            case ']':
+                if (need_indent) {
+                    need_indent = false;
+                } else {
+                    newline(--depth);
+                }
+                out += c;
+                break;
+            default:
+                out += c;
+        }
+    }
+}
+
+namespace {
+
+std::string fieldPath(const ReadContext& ctx) {
+    std::vector<std::string_view> names;
+    for (const ReadContext* c = &ctx; c; c = c->parent) {
+        if (!c->field.empty()) names.push_back(c->field);
+    }
+    std::string path;
+    for (auto it = names.rbegin(); it != names.rend(); ++it) {
+        if (!path.empty()) path += '.';
+        path += *it;
+    }
+    return path;
+}
+
+} // namespace
+
+std::shared_ptr<gocxx::errors::Error> TypeError(const Element& e, std::string_view want, const ReadContext& ctx) {
+    std::string got;
+    switch (e.Type()) {
+        case Kind::Null: got = "null"; break;
+        case Kind::Bool: got = "bool"; break;
+        case Kind::Number: got = "number " + std::string(e.Raw()); break;
+        case Kind::String: got = "string"; break;
+        case Kind::Array: got = "array"; break;
+        case Kind::Object: got = "object"; break;
+    }
+    const std::string path = fieldPath(ctx);
+    return gocxx::errors::New("json: cannot unmarshal " + got + " into " +
+                              (path.empty() ? std::string("value") : "field " + path) + " of type " +
+                              std::string(want));
+}
+
+std::shared_ptr<gocxx::errors::Error> UnknownFieldError(std::string_view key, const ReadContext&) {
+    return gocxx::errors::New("json: unknown field \"" + std::string(key) + "\"");
+}
+
+std::shared_ptr<gocxx::errors::Error> UnsupportedValueError(double v) {
+    return gocxx::errors::New(std::string("json: unsupported value: ") +
+                              (std::isnan(v) ? "NaN" : v > 0 ? "+Inf" : "-Inf"));
+}
+
+Document& ScratchDocument() {
+    thread_local Document doc;
+    return doc;
+}
+
+} // namespace detail
+} // namespace json
+} // namespace encoding
+} // namespace gocxx
@@ -0,0 +1,81 @@
+#include "gocxx/hash/crc32.h"
+
+namespace gocxx::hash::crc32 {
+
+    namespace {
+        struct Tables {
+            uint32_t t[8][256];
+            uint32_t x2n[32];  // x^(2^k) mod P, for Combine
+
+            explicit Tables(uint32_t poly) {
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; ++k) c = c & 1 ? (c >> 1) ^ poly : c >> 1;
+                    t[0][i] = c;
+                }
+                for (int k = 1; k < 8; ++k) {
+                    for (int i = 0; i < 256; ++i) t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+                }
+
+                x2n[0] = 1u << 30;  // x^1
+                for (int k = 1; k < 32; ++k) x2n[k] = multiply(x2n[k - 1], x2n[k - 1], poly);
+            }
+
+            // a * b mod P, both reflected
+            static uint32_t multiply(uint32_t a, uint32_t b, uint32_t poly) {
+                uint32_t m = 1u << 31;
+                uint32_t p = 0;
+                for (;;) {
+                    if (a & m) {
+                        p ^= b;
+                        if ((a & (m - 1)) == 0) break;
+                    }
+                    m >>= 1;
+                    b = b & 1 ? (b >> 1) ^ poly : b >> 1;
+                }
+                return p;
+            }
+        };
+
+        const Tables& tablesFor(Polynomial poly) {
+            static const Tables ieee(static_cast<uint32_t>(Polynomial::IEEE));
+            static const Tables castagnoli(static_cast<uint32_t>(Polynomial::Castagnoli));
+            return poly == Polynomial::Castagnoli ? castagnoli : ieee;
+        }
+
+        inline uint32_t load32(const uint8_t* p) {
+            return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+        }
+    }
+
+    uint32_t Update(uint32_t crc, const uint8_t* data, std::size_t n, Polynomial poly) {
+        const auto& t = tablesFor(poly).t;
+        crc = ~crc;
+        while (n >= 8) {
+            const uint32_t lo = load32(data) ^ crc;
+            const uint32_t hi = load32(data + 4);
+            crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+                  t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+            data += 8;
+            n -= 8;
+        }
+        while (n--) crc = t[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    uint32_t Checksum(const uint8_t* data, std::size_t n, Polynomial poly) {
+        return Update(0, data, n, poly);
+    }
+
+    uint32_t Combine(uint32_t crc1, uint32_t crc2, uint64_t len2, Polynomial poly) {
+        // Shifting crc1 past len2 zero bytes is a multiplication by x^(8*len2).
+        const Tables& tables = tablesFor(poly);
+        const uint32_t p = static_cast<uint32_t>(poly);
+        uint32_t shift = 1u << 31;  // x^0
+        for (unsigned k = 3; len2; len2 >>= 1, ++k) {
+            if (len2 & 1) shift = Tables::multiply(tables.x2n[k & 31], shift, p);
+        }
+        return Tables::multiply(shift, crc1, p) ^ crc2;
+    }
+
+} // namespace gocxx::hash::crc32
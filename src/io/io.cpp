@@ -1,10 +1,31 @@
 #include "gocxx/io/io.h"
 #include "gocxx/io/io_errors.h"
 
+#include <gocxx/runtime/blocking.h>
+
+#include <algorithm>
 #include <memory>
 #include <mutex>
-#include <deque>
 #include <condition_variable>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#if !defined(_WIN32)
+#include <climits>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <cerrno>
+#endif
 
 namespace gocxx::io {
 
@@ -12,26 +33,371 @@ namespace gocxx::io {
     using gocxx::errors::Error;
     using gocxx::base::Result;
 
-    Result<std::size_t> Copy(std::shared_ptr<Writer> dest, std::shared_ptr<Reader> source) {
-        constexpr std::size_t bufferSize = 8192;
-        std::unique_ptr<uint8_t[]> buffer(new uint8_t[bufferSize]);
-        std::size_t totalBytes = 0;
+    namespace {
+#if defined(__linux__)
+        constexpr std::size_t kMaxKernelChunk = std::size_t(1) << 30;
+        constexpr std::size_t kSpliceChunk = std::size_t(1) << 16;  // default pipe capacity
 
-        while (true) {
-            auto res = source->Read(buffer.get(), bufferSize);
-            if (!res.Ok()) {
-                if (errors::Is(res.err, ErrEOF)) break;
-                return Result<std::size_t>{ totalBytes, res.err };
+        enum class FdType { Regular, Pipe, Socket, Other };
+
+        FdType fdType(int fd) {
+            struct stat st;
+            if (::fstat(fd, &st) != 0) return FdType::Other;
+            if (S_ISREG(st.st_mode)) return FdType::Regular;
+            if (S_ISFIFO(st.st_mode)) return FdType::Pipe;
+            if (S_ISSOCK(st.st_mode)) return FdType::Socket;
+            return FdType::Other;
+        }
+
+        // sendfile and splice raise SIGPIPE on a broken socket or pipe, unlike
+        // send(MSG_NOSIGNAL). Block it for the copy and discard one it caused.
+        class SigpipeGuard {
+        public:
+            SigpipeGuard() {
+                sigemptyset(&set_);
+                sigaddset(&set_, SIGPIPE);
+                pthread_sigmask(SIG_BLOCK, &set_, &old_);
+            }
+            ~SigpipeGuard() {
+                if (broken) {
+                    struct timespec zero = {0, 0};
+                    sigtimedwait(&set_, nullptr, &zero);
+                }
+                pthread_sigmask(SIG_SETMASK, &old_, nullptr);
             }
+            bool broken = false;
 
-            if (res.value > 0) {
-                auto wres = dest->Write(buffer.get(), res.value);
-                if (!wres.Ok()) return { totalBytes, wres.err };
-                totalBytes += wres.value;
+        private:
+            sigset_t set_;
+            sigset_t old_;
+        };
+
+        // Errors meaning "this kernel path does not apply to these descriptors".
+        bool unsupported(int err) {
+            return err == EINVAL || err == ENOSYS || err == EOPNOTSUPP || err == EXDEV || err == EBADF;
+        }
+
+        // Moves up to `limit` bytes from srcFd to dstFd in the kernel. Sets
+        // `done` once the copy is finished (EOF, limit or a real error); left
+        // false, the caller continues with a user-space copy. srcDesc and
+        // dstDesc, when known, are waited on when a non-blocking side
+        // reports EAGAIN. With srcOffset, a regular source is read from
+        // there (advancing it) instead of from its file offset.
+        Result<std::size_t> kernelCopy(int dstFd, int srcFd, std::size_t limit, bool& done,
+                                       FileDescriptor* dstDesc, FileDescriptor* srcDesc,
+                                       off_t* srcOffset = nullptr) {
+            done = false;
+            const FdType src = fdType(srcFd);
+            const FdType dst = fdType(dstFd);
+            if (src == FdType::Other || (src == FdType::Socket && dst == FdType::Other) ||
+                (srcOffset && src != FdType::Regular)) {
+                return { 0 };
+            }
+
+            SigpipeGuard guard;
+            std::optional<gocxx::runtime::BlockingRegion> blocking;
+            blocking.emplace(gocxx::runtime::WaitReason::Syscall);
+            std::size_t total = 0;
+            std::shared_ptr<Error> waitErr;
+            auto fail = [&](const char* call) -> Result<std::size_t> {
+                done = true;
+                if (waitErr) return { total, waitErr };
+                const int err = errno;
+                guard.broken = err == EPIPE;
+                return { total, errors::New(std::string(call) + ": " + std::strerror(err)) };
+            };
+            // EAGAIN from a non-blocking socket: park on the side that is not
+            // ready (the source when reading from it, else the destination).
+            // false, with waitErr set, when the copy has to stop.
+            auto waitAgain = [&](bool reading) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+                FileDescriptor* desc = reading ? srcDesc : dstDesc;
+                if (!desc) return false;
+                blocking.reset();  // WaitFd parks in its own BlockingRegion
+                waitErr = desc->WaitFd(!reading);
+                blocking.emplace(gocxx::runtime::WaitReason::Syscall);
+                return waitErr == nullptr;
+            };
+
+            if (src == FdType::Regular) {
+                // copy_file_range between regular files (may reflink), else sendfile.
+                bool copyRange = dst == FdType::Regular;
+                while (total < limit) {
+                    const std::size_t chunk = std::min(limit - total, kMaxKernelChunk);
+                    ssize_t n;
+                    if (copyRange) {
+                        loff_t off = srcOffset ? *srcOffset : 0;
+                        n = ::copy_file_range(srcFd, srcOffset ? &off : nullptr, dstFd, nullptr, chunk, 0);
+                        if (n < 0 && unsupported(errno)) {
+                            copyRange = false;
+                            continue;
+                        }
+                        if (srcOffset && n > 0) *srcOffset = off;
+                    } else {
+                        n = ::sendfile(dstFd, srcFd, srcOffset, chunk);
+                    }
+                    if (n < 0) {
+                        if (errno == EINTR || (!copyRange && waitAgain(false))) continue;
+                        if (total == 0 && unsupported(errno)) return { 0 };
+                        return fail(copyRange ? "copy_file_range" : "sendfile");
+                    }
+                    if (n == 0) break;
+                    total += static_cast<std::size_t>(n);
+                }
+                done = true;
+                return { total };
+            }
+
+            if (src == FdType::Pipe || dst == FdType::Pipe) {
+                while (total < limit) {
+                    const ssize_t n = ::splice(srcFd, nullptr, dstFd, nullptr,
+                                               std::min(limit - total, kMaxKernelChunk), SPLICE_F_MOVE);
+                    if (n < 0) {
+                        if (errno == EINTR || waitAgain(src == FdType::Socket)) continue;
+                        if (total == 0 && unsupported(errno)) return { 0 };
+                        return fail("splice");
+                    }
+                    if (n == 0) break;
+                    total += static_cast<std::size_t>(n);
+                }
+                done = true;
+                return { total };
+            }
+
+            // Socket to socket or file: splice through a pipe we own.
+            int p[2];
+            if (::pipe2(p, O_CLOEXEC) != 0) return { 0 };
+            Result<std::size_t> result;
+            bool fallback = false;
+            for (;;) {
+                if (total >= limit) {
+                    result = { total };
+                    break;
+                }
+                ssize_t n = ::splice(srcFd, nullptr, p[1], nullptr,
+                                     std::min(limit - total, kSpliceChunk), SPLICE_F_MOVE);
+                if (n < 0) {
+                    if (errno == EINTR || waitAgain(true)) continue;
+                    if (total == 0 && unsupported(errno)) {
+                        fallback = true;
+                        result = { 0 };
+                        break;
+                    }
+                    result = fail("splice");
+                    break;
+                }
+                if (n == 0) {
+                    result = { total };
+                    break;
+                }
+                bool failed = false;
+                while (n > 0) {
+                    const ssize_t m = ::splice(p[0], nullptr, dstFd, nullptr, static_cast<std::size_t>(n), SPLICE_F_MOVE);
+                    if (m < 0) {
+                        if (errno == EINTR || waitAgain(false)) continue;
+                        result = fail("splice");
+                        failed = true;
+                        break;
+                    }
+                    n -= m;
+                    total += static_cast<std::size_t>(m);
+                }
+                if (failed) break;
+            }
+            ::close(p[0]);
+            ::close(p[1]);
+            if (!fallback) done = true;
+            return result;
+        }
+#else
+        Result<std::size_t> kernelCopy(int, int, std::size_t, bool& done, FileDescriptor*, FileDescriptor*,
+                                       std::int64_t* = nullptr) {
+            done = false;
+            return { 0 };
+        }
+#endif
+    }
+
+    std::shared_ptr<Error> FileDescriptor::WaitFd(bool) {
+        return ErrNoProgress;
+    }
+
+    namespace detail {
+
+        Result<std::size_t> genericCopy(Writer& dst, Reader& src) {
+            constexpr std::size_t bufferSize = 8192;
+            std::unique_ptr<uint8_t[]> buffer(new uint8_t[bufferSize]);
+            std::size_t totalBytes = 0;
+
+            while (true) {
+                auto res = src.Read(buffer.get(), bufferSize);
+                if (res.value > 0) {
+                    auto wres = dst.Write(buffer.get(), res.value);
+                    if (!wres.Ok()) return { totalBytes + wres.value, wres.err };
+                    totalBytes += wres.value;
+                    if (wres.value < res.value) return { totalBytes, ErrShortWrite };
+                }
+                if (!res.Ok()) {
+                    if (errors::Is(res.err, ErrEOF)) break;
+                    return { totalBytes, res.err };
+                }
+                if (res.value == 0) break;  // 0 = EOF
+            }
+
+            return { totalBytes, nullptr };
+        }
+
+        Result<std::size_t> fdWriteTo(int srcFd, Reader& self, std::shared_ptr<Writer> dst) {
+            if (auto* fd = dynamic_cast<FileDescriptor*>(dst.get())) {
+                bool done = false;
+                auto moved = kernelCopy(fd->Fd(), srcFd, static_cast<std::size_t>(-1), done,
+                                        fd, dynamic_cast<FileDescriptor*>(&self));
+                if (done) return moved;
+                auto rest = genericCopy(*dst, self);
+                return { moved.value + rest.value, rest.err };
+            }
+            return genericCopy(*dst, self);
+        }
+
+        Result<std::size_t> fdReadFrom(int dstFd, Writer& self, std::shared_ptr<Reader> src) {
+            Reader* inner = src.get();
+            std::size_t limit = static_cast<std::size_t>(-1);
+            auto* limited = dynamic_cast<LimitedReader*>(inner);
+            if (limited) {
+                inner = limited->r.get();
+                limit = limited->remaining;
+                if (limit == 0) return { 0 };
+            }
+            if (auto* section = dynamic_cast<SectionReader*>(inner)) {
+                auto* fd = dynamic_cast<FileDescriptor*>(section->r.get());
+                if (!fd || section->off >= section->limit) {
+                    return genericCopy(self, *src);
+                }
+                bool done = false;
+#if defined(__linux__)
+                off_t offset = static_cast<off_t>(section->off);
+#else
+                std::int64_t offset = static_cast<std::int64_t>(section->off);
+#endif
+                auto moved = kernelCopy(dstFd, fd->Fd(), section->limit - section->off, done,
+                                        dynamic_cast<FileDescriptor*>(&self), fd, &offset);
+                section->off += moved.value;
+                if (done) return moved;
+                auto rest = genericCopy(self, *src);
+                return { moved.value + rest.value, rest.err };
+            }
+            if (auto* fd = dynamic_cast<FileDescriptor*>(inner)) {
+                bool done = false;
+                auto moved = kernelCopy(dstFd, fd->Fd(), limit, done,
+                                        dynamic_cast<FileDescriptor*>(&self), fd);
+                if (limited) {
+                    limited->remaining -= moved.value;
+                    limited->totalRead += moved.value;
+                }
+                if (done) return moved;
+                auto rest = genericCopy(self, *src);
+                return { moved.value + rest.value, rest.err };
+            }
+            return genericCopy(self, *src);
+        }
+
+        std::size_t totalSize(const Buffers& bufs) {
+            std::size_t total = 0;
+            for (const auto& b : bufs) total += b.size;
+            return total;
+        }
+
+#if !defined(_WIN32)
+#if defined(IOV_MAX)
+        constexpr std::size_t kMaxIov = IOV_MAX;
+#else
+        constexpr std::size_t kMaxIov = 1024;
+#endif
+
+        std::size_t fdWriteBuffers(int fd, const Buffers& bufs, bool socket, int& err) {
+            err = 0;
+            std::vector<iovec> iov;
+            iov.reserve(std::min(bufs.size(), kMaxIov));
+            std::size_t total = 0;
+            std::size_t next = 0;  // first buffer not fully written
+            std::size_t skip = 0;  // bytes of bufs[next] already written
+
+            gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+            for (;;) {
+                iov.clear();
+                for (std::size_t i = next; i < bufs.size() && iov.size() < kMaxIov; ++i) {
+                    const std::size_t off = i == next ? skip : 0;
+                    if (bufs[i].size > off) {
+                        iov.push_back({ const_cast<uint8_t*>(bufs[i].data) + off, bufs[i].size - off });
+                    }
+                }
+                if (iov.empty()) return total;
+
+                ssize_t n;
+                if (socket) {
+                    msghdr msg{};
+                    msg.msg_iov = iov.data();
+                    msg.msg_iovlen = iov.size();
+                    n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+                } else {
+                    n = ::writev(fd, iov.data(), static_cast<int>(iov.size()));
+                }
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    err = errno;
+                    return total;
+                }
+                if (n == 0) return total;
+                total += static_cast<std::size_t>(n);
+
+                std::size_t left = static_cast<std::size_t>(n);
+                while (next < bufs.size() && left >= bufs[next].size - skip) {
+                    left -= bufs[next].size - skip;
+                    ++next;
+                    skip = 0;
+                }
+                skip += left;
             }
         }
 
-        return {totalBytes,nullptr};
+        long fdReadBuffers(int fd, const MutableBuffers& bufs, bool socket, int& err) {
+            err = 0;
+            std::vector<iovec> iov;
+            iov.reserve(std::min(bufs.size(), kMaxIov));
+            for (const auto& b : bufs) {
+                if (iov.size() == kMaxIov) break;
+                if (b.size) iov.push_back({ b.data, b.size });
+            }
+            if (iov.empty()) return 0;
+
+            gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+            for (;;) {
+                ssize_t n;
+                if (socket) {
+                    msghdr msg{};
+                    msg.msg_iov = iov.data();
+                    msg.msg_iovlen = iov.size();
+                    n = ::recvmsg(fd, &msg, 0);
+                } else {
+                    n = ::readv(fd, iov.data(), static_cast<int>(iov.size()));
+                }
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) err = errno;
+                return static_cast<long>(n);
+            }
+        }
+#endif
+
+    } // namespace detail
+
+    Result<std::size_t> Copy(std::shared_ptr<Writer> dest, std::shared_ptr<Reader> source) {
+        if (auto* wt = dynamic_cast<WriterTo*>(source.get())) {
+            return wt->WriteTo(std::move(dest));
+        }
+        if (auto* rf = dynamic_cast<ReaderFrom*>(dest.get())) {
+            return rf->ReadFrom(std::move(source));
+        }
+        return detail::genericCopy(*dest, *source);
     }
 
     Result<std::size_t> CopyBuffer(std::shared_ptr<Writer> dst, std::shared_ptr<Reader> src, uint8_t* buf, std::size_t size) {
@@ -53,46 +419,35 @@ namespace gocxx::io {
     }
 
     Result<std::size_t> CopyN(std::shared_ptr<Writer> dst, std::shared_ptr<Reader> src, std::size_t n) {
-        std::vector<uint8_t> buf(4096);
-        std::size_t total = 0;
-
-        while (total < n) {
-            std::size_t toRead = std::min(buf.size(), n - total);
-            auto rres = src->Read(buf.data(), toRead);
-
-            if (rres.value > 0) {
-                auto wres = dst->Write(buf.data(), rres.value);
-                if (!wres.Ok()) return { total, wres.err };
-                total += wres.value;
-            }
-
-            if (!rres.Ok()) {
-                if (errors::Is(rres.err, ErrEOF)) {
-                    return { total, errors::Cause(ErrUnexpectedEOF,rres.err)};
-                }
-                return { total, rres.err };
-            }
+        auto res = Copy(std::move(dst), std::make_shared<LimitedReader>(std::move(src), n));
+        if (res.value >= n) return { n };
+        if (res.Ok() || errors::Is(res.err, ErrEOF)) {
+            return { res.value, errors::Cause(ErrUnexpectedEOF, ErrEOF) };
         }
-
-        return total;
+        return res;
     }
 
     Result<std::size_t> ReadAll(std::shared_ptr<Reader> r, std::vector<uint8_t>& out) {
-        std::vector<uint8_t> buf(4096);
-        std::size_t totalRead = 0;
+        // Read straight into the tail of `out`, doubling its size whenever it
+        // fills, rather than copying 4KB chunks through a scratch buffer.
+        const std::size_t start = out.size();
+        std::size_t end = start;
+        out.resize(std::max<std::size_t>(start + 512, start * 2));
 
         while (true) {
-            auto res = r->Read(buf.data(), buf.size());
-            if (res.value > 0) {
-                out.insert(out.end(), buf.begin(), buf.begin() + res.value);
-                totalRead += res.value;
-            }
+            if (end == out.size()) out.resize(out.size() * 2);
+            auto res = r->Read(out.data() + end, out.size() - end);
+            end += std::min(res.value, out.size() - end);
             if (!res.Ok()) {
-                if (errors::Is(res.err, ErrEOF)) return totalRead;
-                return { totalRead, res.err };
+                out.resize(end);
+                if (errors::Is(res.err, ErrEOF)) return end - start;
+                return { end - start, res.err };
+            }
+            if (res.value == 0) {
+                out.resize(end);
+                return end - start;
             }
         }
-		return { totalRead, nullptr };
     }
 
     Result<std::size_t> ReadAtLeast(std::shared_ptr<Reader> r, std::vector<uint8_t>& buf, std::size_t min) {
@@ -141,6 +496,24 @@ namespace gocxx::io {
         return w->Write(reinterpret_cast<const uint8_t*>(s.data()), s.size());
     }
 
+    Result<std::size_t> WriteBuffers(std::shared_ptr<Writer> w, const Buffers& bufs) {
+        if (auto* bw = dynamic_cast<BuffersWriter*>(w.get())) {
+            return bw->WriteBuffers(bufs);
+        }
+        std::size_t total = 0;
+        for (const auto& b : bufs) {
+            std::size_t done = 0;
+            while (done < b.size) {
+                auto res = w->Write(b.data + done, b.size - done);
+                done += res.value;
+                total += res.value;
+                if (res.Failed()) return { total, res.err };
+                if (res.value == 0) return { total, ErrShortWrite };
+            }
+        }
+        return { total };
+    }
+
     LimitedReader::LimitedReader(std::shared_ptr<Reader> r, std::size_t n) : r(r), remaining(n) {}
 
 
@@ -217,62 +590,218 @@ namespace gocxx::io {
             return { newOffset - base }; // relative offset
         }
 
+        SectionReader::SectionReader(std::shared_ptr<ReaderAt> r, std::size_t off, std::size_t n)
+            : r(std::move(r)), base(off), off(off),
+              limit(n > static_cast<std::size_t>(-1) - off ? static_cast<std::size_t>(-1) : off + n) {
+        }
+
+        gocxx::base::Result<std::size_t> SectionReader::Read(uint8_t* buffer, std::size_t size) {
+            if (off >= limit) {
+                return { 0, ErrEOF };
+            }
+            size = std::min(size, limit - off);
+            auto res = r->ReadAt(buffer, size, off);
+            off += res.value;
+            return res;
+        }
+
+        gocxx::base::Result<std::size_t> SectionReader::ReadAt(uint8_t* buffer, std::size_t size, std::size_t offset) {
+            if (offset >= Size()) {
+                return { 0, ErrEOF };
+            }
+            const std::size_t at = base + offset;
+            if (size > limit - at) {
+                auto res = r->ReadAt(buffer, limit - at, at);
+                return { res.value, res.err ? res.err : ErrEOF };
+            }
+            return r->ReadAt(buffer, size, at);
+        }
+
+        gocxx::base::Result<std::size_t> SectionReader::Seek(std::size_t offset, whence whence) {
+            std::size_t newOffset = 0;
+            switch (whence) {
+            case whence::SeekStart:
+                newOffset = base + offset;
+                break;
+            case whence::SeekCurrent:
+                newOffset = off + offset;
+                break;
+            case whence::SeekEnd:
+                newOffset = limit + offset;
+                break;
+            default:
+                return { 0, errors::New("SectionReader: Invalid seek origin") };
+            }
+            if (newOffset < base) {
+                return { 0, errors::New("SectionReader: Seek before start") };
+            }
+            off = newOffset;
+            return { off - base };
+        }
+
         // --- SharedPipe ---
 
+        // Bounded ring of bytes between one or more writers and readers. With
+        // a capacity of zero there is no ring: a Write publishes its own
+        // buffer and readers copy straight out of it, as Go's io.Pipe does.
         class SharedPipe {
         public:
-            std::mutex mtx;
-            std::condition_variable cv;
-
-            std::deque<uint8_t> buffer;
-            bool closed = false;
-            std::shared_ptr<errors::Error> closeError = nullptr;
+            explicit SharedPipe(std::size_t capacity)
+                : ring(capacity ? new uint8_t[capacity] : nullptr), cap(capacity) {}
 
             gocxx::base::Result<std::size_t> Write(const uint8_t* data, std::size_t size) {
                 if (!data) return { 0, errors::New("Pipe Write: null buffer") };
 
                 std::unique_lock lock(mtx);
-                if (closed) {
-                    return { 0, errors::New("Pipe Write: closed") };
-                }
-
-                buffer.insert(buffer.end(), data, data + size);
-                cv.notify_all();
-                return { size };
+                return cap ? writeRing(lock, data, size) : writeDirect(lock, data, size);
             }
 
             gocxx::base::Result<std::size_t> Read(uint8_t* out, std::size_t size) {
                 if (!out) return { 0, errors::New("Pipe Read: null buffer") };
+                if (size == 0) return { 0 };
 
                 std::unique_lock lock(mtx);
-                while (buffer.empty() && !closed) {
-                    cv.wait(lock);
+                while (!readerClosed && available() == 0 && !writerClosed) {
+                    wait(lock, readable, readersWaiting);
+                }
+                if (readerClosed) {
+                    return { 0, ErrClosedPipe };
                 }
 
                 std::size_t n = 0;
-                while (!buffer.empty() && n < size) {
-                    out[n++] = buffer.front();
-                    buffer.pop_front();
+                if (cap) {
+                    n = std::min(size, count);
+                    const std::size_t first = std::min(n, cap - head);
+                    std::memcpy(out, ring.get() + head, first);
+                    std::memcpy(out + first, ring.get(), n - first);
+                    head = (head + n) % cap;
+                    count -= n;
+                    if (writersWaiting) writable.notify_one();
+                } else if (pendingLen) {
+                    n = std::min(size, pendingLen);
+                    std::memcpy(out, pending, n);
+                    pending += n;
+                    pendingLen -= n;
+                    if (pendingLen == 0) writable.notify_all();  // the posting writer is done
                 }
-
-                if (n > 0) return { n };
-
-                if (closed) {
-                    return { 0, closeError ? closeError : ErrEOF };
+                if (n > 0) {
+                    if (available() && readersWaiting) readable.notify_one();
+                    return { n };
                 }
+                return { 0, writerError ? writerError : ErrEOF };
+            }
 
-                return { 0, errors::New("Pipe Read: unknown error state") };
+            gocxx::base::Result<std::size_t> CloseRead(const std::shared_ptr<errors::Error>& err) {
+                std::unique_lock lock(mtx);
+                if (!readerClosed) {
+                    readerClosed = true;
+                    readerError = err;
+                    readable.notify_all();
+                    writable.notify_all();
+                }
+                return { 0 };
             }
 
-            gocxx::base::Result<std::size_t> Close(const std::shared_ptr<errors::Error>& err) {
+            gocxx::base::Result<std::size_t> CloseWrite(const std::shared_ptr<errors::Error>& err) {
                 std::unique_lock lock(mtx);
-                if (!closed) {
-                    closed = true;
-                    closeError = err;
-                    cv.notify_all();
+                if (!writerClosed) {
+                    writerClosed = true;
+                    writerError = err;
+                    readable.notify_all();
+                    writable.notify_all();
                 }
                 return { 0 };
             }
+
+        private:
+            std::size_t available() const { return cap ? count : pendingLen; }
+
+            std::shared_ptr<errors::Error> writeFailure() const {
+                if (readerClosed && readerError) return readerError;
+                return ErrClosedPipe;
+            }
+
+            static void wait(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, int& waiters) {
+                ++waiters;
+                {
+                    gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+                    cv.wait(lock);
+                }
+                --waiters;
+            }
+
+            gocxx::base::Result<std::size_t> writeRing(std::unique_lock<std::mutex>& lock,
+                                                       const uint8_t* data, std::size_t size) {
+                std::size_t written = 0;
+                while (written < size) {
+                    while (count == cap && !readerClosed && !writerClosed) {
+                        wait(lock, writable, writersWaiting);  // backpressure
+                    }
+                    if (readerClosed || writerClosed) {
+                        return { written, writeFailure() };
+                    }
+                    const std::size_t n = std::min(size - written, cap - count);
+                    const std::size_t tail = (head + count) % cap;
+                    const std::size_t first = std::min(n, cap - tail);
+                    std::memcpy(ring.get() + tail, data + written, first);
+                    std::memcpy(ring.get(), data + written + first, n - first);
+                    count += n;
+                    written += n;
+                    if (readersWaiting) readable.notify_one();
+                }
+                return { written };
+            }
+
+            gocxx::base::Result<std::size_t> writeDirect(std::unique_lock<std::mutex>& lock,
+                                                         const uint8_t* data, std::size_t size) {
+                // One writer publishes at a time so concurrent writes do not interleave.
+                while (posting && !readerClosed && !writerClosed) {
+                    wait(lock, writable, writersWaiting);
+                }
+                if (readerClosed || writerClosed) {
+                    return { 0, writeFailure() };
+                }
+                if (size == 0) return { 0 };
+
+                posting = true;
+                pending = data;
+                pendingLen = size;
+                if (readersWaiting) readable.notify_one();
+                while (pendingLen && !readerClosed && !writerClosed) {
+                    wait(lock, writable, writersWaiting);
+                }
+                const std::size_t written = size - pendingLen;
+                pending = nullptr;
+                pendingLen = 0;
+                posting = false;
+                writable.notify_all();  // let the next writer post
+                if (written < size) {
+                    return { written, writeFailure() };
+                }
+                return { written };
+            }
+
+            std::mutex mtx;
+            std::condition_variable readable;
+            std::condition_variable writable;
+            int readersWaiting = 0;
+            int writersWaiting = 0;
+
+            // Ring mode
+            std::unique_ptr<uint8_t[]> ring;
+            const std::size_t cap;
+            std::size_t head = 0;
+            std::size_t count = 0;
+
+            // Direct mode: the buffer of the Write in progress
+            const uint8_t* pending = nullptr;
+            std::size_t pendingLen = 0;
+            bool posting = false;
+
+            bool readerClosed = false;
+            bool writerClosed = false;
+            std::shared_ptr<errors::Error> readerError;
+            std::shared_ptr<errors::Error> writerError;
         };
 
         // --- PipeReaderImpl ---
@@ -286,11 +815,11 @@ namespace gocxx::io {
             }
 
             gocxx::base::Result<std::size_t> Close() override {
-                return pipe_->Close(nullptr);
+                return pipe_->CloseRead(nullptr);
             }
 
             gocxx::base::Result<std::size_t> CloseWithError(std::shared_ptr<errors::Error> err) override {
-                return pipe_->Close(std::move(err));
+                return pipe_->CloseRead(std::move(err));
             }
 
         private:
@@ -308,11 +837,11 @@ namespace gocxx::io {
             }
 
             gocxx::base::Result<std::size_t> Close() override {
-                return pipe_->Close(nullptr);
+                return pipe_->CloseWrite(nullptr);
             }
 
             gocxx::base::Result<std::size_t> CloseWithError(std::shared_ptr<errors::Error> err) override {
-                return pipe_->Close(std::move(err));
+                return pipe_->CloseWrite(std::move(err));
             }
 
         private:
@@ -322,7 +851,11 @@ namespace gocxx::io {
         // --- Pipe creation ---
 
         std::pair<std::shared_ptr<PipeReader>, std::shared_ptr<PipeWriter>> Pipe() {
-            auto pipe = std::make_shared<SharedPipe>();
+            return Pipe(kDefaultPipeBufferSize);
+        }
+
+        std::pair<std::shared_ptr<PipeReader>, std::shared_ptr<PipeWriter>> Pipe(std::size_t bufferSize) {
+            auto pipe = std::make_shared<SharedPipe>(bufferSize);
             return {
                 std::make_shared<PipeReaderImpl>(pipe),
                 std::make_shared<PipeWriterImpl>(pipe)
@@ -0,0 +1,174 @@
+#include "gocxx/io/parallel.h"
+#include "gocxx/io/io_errors.h"
+
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/runtime/blocking.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gocxx::io {
+
+    using gocxx::base::Result;
+
+    namespace {
+        // Shared by the workers of one call.
+        class ChunkRun {
+        public:
+            ChunkRun(std::size_t size, std::size_t chunk, ProgressChan progress)
+                : size_(size), chunk_(chunk), chunks_((size + chunk - 1) / chunk), progress_(std::move(progress)) {}
+
+            std::size_t chunks() const { return chunks_; }
+
+            // Next unclaimed chunk, or false once all are taken or one failed.
+            bool claim(std::size_t& index, std::size_t& offset, std::size_t& n) {
+                if (failed_.load(std::memory_order_relaxed)) return false;
+                index = next_.fetch_add(1, std::memory_order_relaxed);
+                if (index >= chunks_) return false;
+                offset = index * chunk_;
+                n = std::min(chunk_, size_ - offset);
+                return true;
+            }
+
+            void finished(std::size_t n) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                done_ += n;
+                // Reported under the lock so totals arrive in increasing order
+                if (progress_) progress_->trySend(Progress{done_, size_});
+            }
+
+            void fail(std::shared_ptr<errors::Error> err) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (!err_) err_ = std::move(err);
+                failed_.store(true, std::memory_order_relaxed);
+            }
+
+            Result<std::size_t> result() {
+                std::lock_guard<std::mutex> lock(mtx_);
+                return {done_, err_};
+            }
+
+        private:
+            const std::size_t size_;
+            const std::size_t chunk_;
+            const std::size_t chunks_;
+            ProgressChan progress_;
+            std::atomic<std::size_t> next_{0};
+            std::atomic<bool> failed_{false};
+            std::mutex mtx_;
+            std::size_t done_ = 0;
+            std::shared_ptr<errors::Error> err_;
+        };
+
+        // A chunk-sized block from the bytes pools, returned on destruction.
+        class ScratchBlock {
+        public:
+            explicit ScratchBlock(std::size_t n) : data_(bytes::detail::allocateBlock(n, cap_)) {}
+            ~ScratchBlock() { bytes::detail::releaseBlock(data_, cap_); }
+
+            ScratchBlock(const ScratchBlock&) = delete;
+            ScratchBlock& operator=(const ScratchBlock&) = delete;
+
+            uint8_t* data() const { return data_; }
+
+        private:
+            std::size_t cap_ = 0;
+            uint8_t* data_;
+        };
+
+        // Fills buf with exactly n bytes at offset, or explains why not.
+        std::shared_ptr<errors::Error> readChunk(ReaderAt& src, uint8_t* buf, std::size_t n, std::size_t offset) {
+            std::size_t got = 0;
+            while (got < n) {
+                auto res = src.ReadAt(buf + got, n - got, offset + got);
+                got += res.value;
+                if (got == n) return nullptr;
+                if (res.Failed() && res.err != ErrEOF) return res.err;
+                if (res.Failed() || res.value == 0) return ErrUnexpectedEOF;
+            }
+            return nullptr;
+        }
+
+        // Runs body(index, offset, n, buffer) for every chunk on `workers` threads.
+        template <typename Body>
+        Result<std::size_t> runChunks(std::size_t size, std::size_t chunk, std::size_t workers,
+                                      ProgressChan progress, Body body) {
+            if (chunk == 0) chunk = kDefaultParallelChunk;
+            if (workers == 0) workers = kDefaultParallelWorkers;
+            if (size == 0) return {0, nullptr};
+
+            ChunkRun run(size, chunk, std::move(progress));
+            workers = std::min(workers, run.chunks());
+
+            auto work = [&] {
+                ScratchBlock buf(chunk);
+                std::size_t index, offset, n;
+                while (run.claim(index, offset, n)) {
+                    if (auto err = body(index, offset, n, buf.data())) {
+                        run.fail(std::move(err));
+                        return;
+                    }
+                    run.finished(n);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(workers);
+            for (std::size_t i = 0; i < workers; ++i) threads.emplace_back(work);
+            {
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::WaitGroup);
+                for (auto& t : threads) t.join();
+            }
+            return run.result();
+        }
+    }
+
+    Result<std::size_t> ParallelCopy(std::shared_ptr<WriterAt> dst, std::shared_ptr<ReaderAt> src,
+                                     std::size_t size, std::size_t chunk, std::size_t workers,
+                                     ProgressChan progress) {
+        return runChunks(size, chunk, workers, std::move(progress),
+                         [&](std::size_t, std::size_t offset, std::size_t n, uint8_t* buf)
+                             -> std::shared_ptr<errors::Error> {
+                             if (auto err = readChunk(*src, buf, n, offset)) return err;
+                             auto res = dst->WriteAt(buf, n, offset);
+                             if (res.Failed()) return res.err;
+                             if (res.value != n) return ErrShortWrite;
+                             return nullptr;
+                         });
+    }
+
+    Result<std::size_t> ParallelRead(std::shared_ptr<ReaderAt> src, std::size_t size, std::size_t chunk,
+                                     std::size_t workers, const ChunkFunc& fn, ProgressChan progress) {
+        return runChunks(size, chunk, workers, std::move(progress),
+                         [&](std::size_t index, std::size_t offset, std::size_t n, uint8_t* buf)
+                             -> std::shared_ptr<errors::Error> {
+                             if (auto err = readChunk(*src, buf, n, offset)) return err;
+                             return fn(index, offset, buf, n).err;
+                         });
+    }
+
+    Result<uint32_t> ParallelCRC32(std::shared_ptr<ReaderAt> src, std::size_t size, std::size_t chunk,
+                                   std::size_t workers, ProgressChan progress, hash::crc32::Polynomial poly) {
+        if (chunk == 0) chunk = kDefaultParallelChunk;
+
+        // One checksum per chunk, folded together in order at the end
+        std::vector<uint32_t> sums((size + chunk - 1) / chunk);
+        auto res = ParallelRead(src, size, chunk, workers,
+                                [&](std::size_t index, std::size_t, const uint8_t* data, std::size_t n) {
+                                    sums[index] = hash::crc32::Checksum(data, n, poly);
+                                    return Result<void>();
+                                },
+                                std::move(progress));
+        if (res.Failed()) return {0, res.err};
+
+        uint32_t crc = 0;
+        for (std::size_t i = 0; i < sums.size(); ++i) {
+            crc = hash::crc32::Combine(crc, sums[i], std::min(chunk, size - i * chunk), poly);
+        }
+        return {crc, nullptr};
+    }
+
+} // namespace gocxx::io
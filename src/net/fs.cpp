@@ -0,0 +1,539 @@
+#include <gocxx/net/http.h>
+#include <gocxx/io/io_errors.h>
+#include <gocxx/os/file.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <list>
+#include <optional>
+
+namespace gocxx::net::http {
+
+namespace {
+
+// --- Open file and stat cache ---
+
+struct CachedFile {
+    std::shared_ptr<gocxx::os::File> file;  // null for a directory
+    gocxx::os::FileInfo info;
+    std::string etag;
+    std::string last_modified;
+    std::int64_t mtime = 0;  // seconds since the epoch
+};
+
+/**
+ * Keeps recently served files open with their stat results. An entry is
+ * trusted for `ttl` after it was last checked; after that a stat() of the
+ * path decides whether the open descriptor still shows the same file (same
+ * size and modification time) or has to be reopened. Descriptors are shared
+ * between requests, which read them at explicit offsets.
+ */
+class FileCache {
+public:
+    FileCache(std::size_t capacity, std::chrono::nanoseconds ttl) : capacity_(capacity), ttl_(ttl) {}
+
+    gocxx::base::Result<std::shared_ptr<const CachedFile>> Get(const std::string& path) {
+        const auto now = std::chrono::steady_clock::now();
+        std::shared_ptr<const CachedFile> cached;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            auto it = entries_.find(path);
+            if (it != entries_.end()) {
+                lru_.splice(lru_.begin(), lru_, it->second.lru);
+                if (now - it->second.checked < ttl_) {
+                    return {it->second.file, nullptr};
+                }
+                cached = it->second.file;
+            }
+        }
+
+        auto info = gocxx::os::Stat(path);
+        if (info.Failed()) {
+            erase(path);
+            return {nullptr, info.err};
+        }
+        if (cached && cached->info.size == info.value.size && cached->info.modTime == info.value.modTime &&
+            cached->info.isDir == info.value.isDir) {
+            std::lock_guard<std::mutex> lock(mu_);
+            auto it = entries_.find(path);
+            if (it != entries_.end() && it->second.file == cached) {
+                it->second.checked = now;
+            }
+            return {cached, nullptr};
+        }
+
+        auto entry = std::make_shared<CachedFile>();
+        entry->info = info.value;
+        if (!info.value.isDir) {
+            auto file = gocxx::os::Open(path);
+            if (file.Failed()) {
+                erase(path);
+                return {nullptr, file.err};
+            }
+            entry->file = file.value;
+            // What the descriptor shows, should the path have changed since the stat
+            auto opened = entry->file->Stat();
+            if (opened.Ok()) {
+                entry->info = opened.value;
+            }
+        }
+        entry->mtime = std::chrono::duration_cast<std::chrono::seconds>(
+            entry->info.modTime.time_since_epoch()).count();
+        char etag[48];
+        std::snprintf(etag, sizeof(etag), "\"%llx-%llx\"", static_cast<unsigned long long>(entry->mtime),
+                      static_cast<unsigned long long>(entry->info.size));
+        entry->etag = etag;
+        entry->last_modified = formatHTTPDate(entry->mtime);
+
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = entries_.find(path);
+        if (it != entries_.end()) {
+            lru_.erase(it->second.lru);
+            entries_.erase(it);
+        }
+        if (capacity_ > 0) {
+            lru_.push_front(path);
+            entries_[path] = Slot{entry, now, lru_.begin()};
+            while (entries_.size() > capacity_) {
+                entries_.erase(lru_.back());
+                lru_.pop_back();
+            }
+        }
+        return {entry, nullptr};
+    }
+
+    static std::string formatHTTPDate(std::int64_t seconds) {
+        const std::time_t t = static_cast<std::time_t>(seconds);
+        std::tm tm{};
+#ifdef _WIN32
+        gmtime_s(&tm, &t);
+#else
+        gmtime_r(&t, &tm);
+#endif
+        char buf[40];
+        const std::size_t n = std::strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+        return std::string(buf, n);
+    }
+
+private:
+    struct Slot {
+        std::shared_ptr<const CachedFile> file;
+        std::chrono::steady_clock::time_point checked;
+        std::list<std::string>::iterator lru;
+    };
+
+    void erase(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = entries_.find(path);
+        if (it != entries_.end()) {
+            lru_.erase(it->second.lru);
+            entries_.erase(it);
+        }
+    }
+
+    const std::size_t capacity_;
+    const std::chrono::nanoseconds ttl_;
+    std::mutex mu_;
+    std::unordered_map<std::string, Slot> entries_;
+    std::list<std::string> lru_;  // most recently used first
+};
+
+constexpr std::size_t kFileCacheEntries = 128;
+constexpr std::chrono::seconds kFileCacheTTL{1};
+
+// --- Request helpers ---
+
+// IMF-fixdate (RFC 9110 section 5.6.7) to seconds since the epoch
+std::optional<std::int64_t> parseHTTPDate(const std::string& value) {
+    char wday[4] = {};
+    char mon[4] = {};
+    int day = 0, year = 0, hour = 0, min = 0, sec = 0;
+    if (std::sscanf(value.c_str(), "%3[A-Za-z], %d %3s %d %d:%d:%d GMT", wday, &day, mon, &year, &hour, &min, &sec) != 7) {
+        return std::nullopt;
+    }
+    static const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    int month = 0;
+    while (month < 12 && std::strcmp(months[month], mon) != 0) ++month;
+    if (month == 12 || day < 1 || day > 31 || hour > 23 || min > 59 || sec > 60) {
+        return std::nullopt;
+    }
+    // Days from the civil date (Howard Hinnant's algorithm)
+    const int y = year - (month < 2);
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = y - era * 400;
+    const int mp = (month + 10) % 12;
+    const int doy = (153 * mp + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const std::int64_t days = static_cast<std::int64_t>(era) * 146097 + doe - 719468;
+    return days * 86400 + hour * 3600 + min * 60 + sec;
+}
+
+// Whether a comma-separated If-None-Match / If-Match list names etag; W/ prefixes are ignored when weak
+bool etagListMatches(const std::string& list, const std::string& etag, bool weak) {
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+        while (pos < list.size() && (list[pos] == ' ' || list[pos] == '\t' || list[pos] == ',')) ++pos;
+        if (pos >= list.size()) break;
+        if (list[pos] == '*') return true;
+        bool is_weak = false;
+        if (list.compare(pos, 2, "W/") == 0) {
+            is_weak = true;
+            pos += 2;
+        }
+        std::size_t end = pos < list.size() && list[pos] == '"' ? list.find('"', pos + 1) : std::string::npos;
+        end = end == std::string::npos ? list.find(',', pos) : end + 1;
+        if (end == std::string::npos) end = list.size();
+        if ((weak || !is_weak) && list.compare(pos, end - pos, etag) == 0) return true;
+        pos = end;
+    }
+    return false;
+}
+
+// One "bytes=first-last" range against size; nullopt when absent or
+// ignorable (several ranges, other units), -1 offset when unsatisfiable
+struct ByteRange {
+    std::int64_t offset;
+    std::int64_t length;
+};
+
+std::optional<ByteRange> parseRange(const std::string& value, std::int64_t size) {
+    if (value.compare(0, 6, "bytes=") != 0 || value.find(',') != std::string::npos) {
+        return std::nullopt;
+    }
+    std::string spec = value.substr(6);
+    spec.erase(std::remove(spec.begin(), spec.end(), ' '), spec.end());
+    const std::size_t dash = spec.find('-');
+    if (dash == std::string::npos) {
+        return std::nullopt;
+    }
+    const std::string first = spec.substr(0, dash);
+    const std::string last = spec.substr(dash + 1);
+    auto number = [](const std::string& s, std::int64_t& out) {
+        if (s.empty() || s.size() > 18 || !std::all_of(s.begin(), s.end(), ::isdigit)) return false;
+        out = std::stoll(s);
+        return true;
+    };
+    std::int64_t a = 0, b = 0;
+    if (first.empty()) {
+        // Suffix range: the last b bytes
+        if (!number(last, b)) return std::nullopt;
+        if (b == 0 || size == 0) return ByteRange{-1, 0};
+        b = std::min(b, size);
+        return ByteRange{size - b, b};
+    }
+    if (!number(first, a)) return std::nullopt;
+    if (a >= size) return ByteRange{-1, 0};
+    if (last.empty()) return ByteRange{a, size - a};
+    if (!number(last, b) || b < a) return std::nullopt;
+    return ByteRange{a, std::min(b, size - 1) - a + 1};
+}
+
+std::string contentTypeFor(const std::string& name) {
+    static const std::pair<const char*, const char*> types[] = {
+        {".html", "text/html; charset=utf-8"}, {".htm", "text/html; charset=utf-8"},
+        {".css", "text/css; charset=utf-8"}, {".js", "text/javascript; charset=utf-8"},
+        {".mjs", "text/javascript; charset=utf-8"}, {".json", "application/json"},
+        {".txt", "text/plain; charset=utf-8"}, {".xml", "text/xml; charset=utf-8"},
+        {".svg", "image/svg+xml"}, {".png", "image/png"}, {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"}, {".gif", "image/gif"}, {".webp", "image/webp"},
+        {".ico", "image/x-icon"}, {".wasm", "application/wasm"}, {".pdf", "application/pdf"},
+        {".woff", "font/woff"}, {".woff2", "font/woff2"}, {".gz", "application/gzip"},
+        {".tar", "application/x-tar"}, {".zip", "application/zip"}, {".mp4", "video/mp4"},
+    };
+    const std::size_t dot = name.find_last_of("./");
+    if (dot != std::string::npos && name[dot] == '.') {
+        std::string ext = name.substr(dot);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        for (const auto& [suffix, type] : types) {
+            if (ext == suffix) return type;
+        }
+    }
+    return "application/octet-stream";
+}
+
+// Percent-decodes a URL path; false on a malformed escape or a NUL
+bool unescapePath(std::string_view in, std::string& out) {
+    out.clear();
+    out.reserve(in.size());
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        if (in[i] != '%') {
+            out.push_back(in[i]);
+            continue;
+        }
+        if (i + 2 >= in.size() || !std::isxdigit(static_cast<unsigned char>(in[i + 1])) ||
+            !std::isxdigit(static_cast<unsigned char>(in[i + 2]))) {
+            return false;
+        }
+        const char c = static_cast<char>(std::stoi(std::string(in.substr(i + 1, 2)), nullptr, 16));
+        if (c == '\0') return false;
+        out.push_back(c);
+        i += 2;
+    }
+    return true;
+}
+
+// Rooted, with "." and ".." resolved and never above "/"; keeps a trailing slash
+std::string cleanPath(const std::string& path) {
+    std::vector<std::string_view> parts;
+    std::string_view rest(path);
+    while (!rest.empty()) {
+        const std::size_t slash = rest.find('/');
+        std::string_view part = rest.substr(0, slash);
+        rest = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
+        if (part.empty() || part == ".") continue;
+        if (part == "..") {
+            if (!parts.empty()) parts.pop_back();
+            continue;
+        }
+        parts.push_back(part);
+    }
+    std::string out;
+    for (auto part : parts) out.append("/").append(part.data(), part.size());
+    if (out.empty() || (path.size() > 1 && path.back() == '/')) out += "/";
+    return out;
+}
+
+std::string htmlEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&#34;"; break;
+            case '\'': out += "&#39;"; break;
+            default: out.push_back(c);
+        }
+    }
+    return out;
+}
+
+std::string urlEscape(const std::string& s) {
+    static const char* hex = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : s) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == '/') {
+            out.push_back(static_cast<char>(c));
+        } else {
+            out.push_back('%');
+            out.push_back(hex[c >> 4]);
+            out.push_back(hex[c & 15]);
+        }
+    }
+    return out;
+}
+
+void serveError(ResponseWriter& w, const std::shared_ptr<gocxx::errors::Error>& err) {
+    if (gocxx::errors::Is(err, gocxx::os::ErrNotExist)) {
+        w.WriteHeader(StatusNotFound);
+        w.Write("404 page not found\n");
+    } else if (gocxx::errors::Is(err, gocxx::os::ErrPermission)) {
+        w.WriteHeader(403);
+        w.Write("403 Forbidden\n");
+    } else {
+        w.WriteHeader(StatusInternalServerError);
+        w.Write("500 Internal Server Error\n");
+    }
+}
+
+void serveDirectory(ResponseWriter& w, const Request& req, const std::string& dir) {
+    auto entries = gocxx::os::ReadDir(dir);
+    if (entries.Failed()) {
+        serveError(w, entries.err);
+        return;
+    }
+    std::sort(entries.value.begin(), entries.value.end(),
+              [](const auto& a, const auto& b) { return a.name < b.name; });
+    w.Header()["content-type"] = "text/html; charset=utf-8";
+    if (req.method == "HEAD") {
+        return;
+    }
+    std::string body = "<!doctype html>\n<meta name=\"viewport\" content=\"width=device-width\">\n<pre>\n";
+    for (const auto& entry : entries.value) {
+        const std::string name = entry.name + (entry.isDir ? "/" : "");
+        body += "<a href=\"" + htmlEscape(urlEscape(name)) + "\">" + htmlEscape(name) + "</a>\n";
+    }
+    body += "</pre>\n";
+    w.Write(body);
+}
+
+// Headers, preconditions, range and body for one open file
+void serveContent(ResponseWriter& w, const Request& req, const CachedFile& f, const std::string& name) {
+    auto& header = w.Header();
+    header["last-modified"] = f.last_modified;
+    header["etag"] = f.etag;
+    header["accept-ranges"] = "bytes";
+
+    // Preconditions (RFC 9110 section 13.2.2): If-None-Match wins over If-Modified-Since
+    const bool get_or_head = req.method == "GET" || req.method == "HEAD";
+    const std::string if_none_match = req.Header("if-none-match");
+    bool not_modified = false;
+    if (!if_none_match.empty()) {
+        if (etagListMatches(if_none_match, f.etag, true)) {
+            if (!get_or_head) {
+                w.WriteHeader(412);
+                return;
+            }
+            not_modified = true;
+        }
+    } else if (get_or_head) {
+        auto since = parseHTTPDate(req.Header("if-modified-since"));
+        not_modified = since && f.mtime <= *since;
+    }
+    if (not_modified) {
+        w.WriteHeader(304);
+        return;
+    }
+
+    const std::int64_t size = f.info.size;
+    std::int64_t offset = 0;
+    std::int64_t length = size;
+    int status = StatusOK;
+    const std::string range = req.Header("range");
+    if (!range.empty() && req.method == "GET") {
+        // If-Range: the range only applies to the representation the client already has
+        const std::string if_range = req.Header("if-range");
+        const bool current = if_range.empty() || if_range == f.etag ||
+                             (if_range[0] != '"' && if_range == f.last_modified);
+        auto parsed = current ? parseRange(range, size) : std::nullopt;
+        if (parsed && parsed->offset < 0) {
+            header["content-range"] = "bytes */" + std::to_string(size);
+            w.WriteHeader(416);
+            w.Write("416 Range Not Satisfiable\n");
+            return;
+        }
+        if (parsed) {
+            offset = parsed->offset;
+            length = parsed->length;
+            status = 206;
+            header["content-range"] = "bytes " + std::to_string(offset) + "-" +
+                                      std::to_string(offset + length - 1) + "/" + std::to_string(size);
+        }
+    }
+
+    if (!header.count("content-type")) {
+        header["content-type"] = contentTypeFor(name);
+    }
+    header["content-length"] = std::to_string(length);
+    w.WriteHeader(status);
+    if (req.method == "HEAD" || length == 0) {
+        return;
+    }
+
+    auto section = std::make_shared<gocxx::io::SectionReader>(f.file, static_cast<std::size_t>(offset),
+                                                              static_cast<std::size_t>(length));
+    if (auto* rf = dynamic_cast<gocxx::io::ReaderFrom*>(&w)) {
+        rf->ReadFrom(section);
+        return;
+    }
+    std::string chunk(32 * 1024, '\0');
+    while (true) {
+        auto res = section->Read(reinterpret_cast<uint8_t*>(&chunk[0]), chunk.size());
+        if (res.value > 0 && w.Write(chunk.substr(0, res.value)).Failed()) return;
+        if (res.Failed() || res.value == 0) return;
+    }
+}
+
+// Serves path (cleaned, rooted, relative to root) the way FileServer and ServeFile do
+void serveFile(ResponseWriter& w, const Request& req, FileCache& cache, const std::string& root,
+               const std::string& path, bool redirect) {
+    std::string name = root + path;
+    if (name.size() > 1 && name.back() == '/') name.pop_back();
+    auto entry = cache.Get(name);
+    if (entry.Failed()) {
+        serveError(w, entry.err);
+        return;
+    }
+
+    if (entry.value->info.isDir) {
+        if (redirect && path.back() != '/') {
+            // "/dir" to "/dir/", so relative links in the listing or index.html resolve
+            const std::string& url = req.url;
+            const std::size_t query = url.find('?');
+            std::string location = url.substr(0, query);
+            location = location.substr(location.find_last_of('/') + 1) + "/";
+            if (query != std::string::npos) location += url.substr(query);
+            w.Header()["location"] = location;
+            w.WriteHeader(301);
+            return;
+        }
+        auto index = cache.Get(name + "/index.html");
+        if (index.Ok() && !index.value->info.isDir) {
+            serveContent(w, req, *index.value, "index.html");
+            return;
+        }
+        serveDirectory(w, req, name);
+        return;
+    }
+    serveContent(w, req, *entry.value, name);
+}
+
+FileCache& defaultFileCache() {
+    static FileCache cache(kFileCacheEntries, kFileCacheTTL);
+    return cache;
+}
+
+} // namespace
+
+HandlerFunc FileServer(const std::string& root) {
+    auto cache = std::make_shared<FileCache>(kFileCacheEntries, kFileCacheTTL);
+    std::string base = root.empty() ? "." : root;
+    while (base.size() > 1 && base.back() == '/') base.pop_back();
+    return [cache, base](ResponseWriter& w, const Request& req) {
+        if (req.method != "GET" && req.method != "HEAD") {
+            w.Header()["allow"] = "GET, HEAD";
+            w.WriteHeader(StatusMethodNotAllowed);
+            w.Write("405 method not allowed\n");
+            return;
+        }
+        std::string_view target(req.url);
+        target = target.substr(0, target.find('?'));
+        std::string path;
+        if (!unescapePath(target, path)) {
+            w.WriteHeader(StatusBadRequest);
+            w.Write("400 Bad Request\n");
+            return;
+        }
+        serveFile(w, req, *cache, base, cleanPath(path), true);
+    };
+}
+
+void ServeFile(ResponseWriter& w, const Request& req, const std::string& name) {
+    // Like Go, refuse request paths that climb with ".."; name itself is trusted
+    std::string_view target(req.url);
+    target = target.substr(0, target.find('?'));
+    if (target == ".." || target.find("/../") != std::string_view::npos ||
+        (target.size() >= 3 && target.substr(target.size() - 3) == "/..")) {
+        w.WriteHeader(StatusBadRequest);
+        w.Write("invalid URL path\n");
+        return;
+    }
+    auto entry = defaultFileCache().Get(name);
+    if (entry.Failed()) {
+        serveError(w, entry.err);
+        return;
+    }
+    if (entry.value->info.isDir) {
+        serveFile(w, req, defaultFileCache(), name, "/", false);
+        return;
+    }
+    serveContent(w, req, *entry.value, name);
+}
+
+HandlerFunc StripPrefix(const std::string& prefix, HandlerFunc handler) {
+    return [prefix, handler](ResponseWriter& w, const Request& req) {
+        if (req.url.compare(0, prefix.size(), prefix) != 0) {
+            w.WriteHeader(StatusNotFound);
+            w.Write("404 page not found\n");
+            return;
+        }
+        Request stripped = req;
+        stripped.url = req.url.substr(prefix.size());
+        stripped.path_names_ = nullptr;  // offsets into the old url
+        handler(w, stripped);
+    };
+}
+
+} // namespace gocxx::net::http
@@ -0,0 +1,453 @@
+#include <gocxx/net/hpack.h>
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+namespace gocxx::net::hpack {
+
+std::shared_ptr<gocxx::errors::Error> ErrDecoding = gocxx::errors::New("hpack: decoding error");
+std::shared_ptr<gocxx::errors::Error> ErrInvalidHuffman = gocxx::errors::New("hpack: invalid Huffman-encoded data");
+std::shared_ptr<gocxx::errors::Error> ErrStringLength = gocxx::errors::New("hpack: string too long");
+
+namespace {
+
+    struct StaticEntry {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    // RFC 7541 Appendix A; HPACK index i is entry i - 1
+    constexpr StaticEntry kStaticTable[61] = {
+        {":authority", ""},
+        {":method", "GET"},
+        {":method", "POST"},
+        {":path", "/"},
+        {":path", "/index.html"},
+        {":scheme", "http"},
+        {":scheme", "https"},
+        {":status", "200"},
+        {":status", "204"},
+        {":status", "206"},
+        {":status", "304"},
+        {":status", "400"},
+        {":status", "404"},
+        {":status", "500"},
+        {"accept-charset", ""},
+        {"accept-encoding", "gzip, deflate"},
+        {"accept-language", ""},
+        {"accept-ranges", ""},
+        {"accept", ""},
+        {"access-control-allow-origin", ""},
+        {"age", ""},
+        {"allow", ""},
+        {"authorization", ""},
+        {"cache-control", ""},
+        {"content-disposition", ""},
+        {"content-encoding", ""},
+        {"content-language", ""},
+        {"content-length", ""},
+        {"content-location", ""},
+        {"content-range", ""},
+        {"content-type", ""},
+        {"cookie", ""},
+        {"date", ""},
+        {"etag", ""},
+        {"expect", ""},
+        {"expires", ""},
+        {"from", ""},
+        {"host", ""},
+        {"if-match", ""},
+        {"if-modified-since", ""},
+        {"if-none-match", ""},
+        {"if-range", ""},
+        {"if-unmodified-since", ""},
+        {"last-modified", ""},
+        {"link", ""},
+        {"location", ""},
+        {"max-forwards", ""},
+        {"proxy-authenticate", ""},
+        {"proxy-authorization", ""},
+        {"range", ""},
+        {"referer", ""},
+        {"refresh", ""},
+        {"retry-after", ""},
+        {"server", ""},
+        {"set-cookie", ""},
+        {"strict-transport-security", ""},
+        {"transfer-encoding", ""},
+        {"user-agent", ""},
+        {"vary", ""},
+        {"via", ""},
+        {"www-authenticate", ""},
+    };
+    constexpr std::size_t kStaticLen = 61;
+
+    // RFC 7541 Appendix B, symbol 256 being EOS. The code is canonical:
+    // codes of one length are consecutive, in symbol order
+    constexpr std::uint32_t kHuffmanCodes[257] = {
+        0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7,
+        0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9, 0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec,
+        0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+        0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9, 0xffffffa, 0xffffffb,
+        0x14, 0x3f8, 0x3f9, 0xffa, 0x1ff9, 0x15, 0xf8, 0x7fa,
+        0x3fa, 0x3fb, 0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+        0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+        0x1e, 0x1f, 0x5c, 0xfb, 0x7ffc, 0x20, 0xffb, 0x3fc,
+        0x1ffa, 0x21, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+        0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+        0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72,
+        0xfc, 0x73, 0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+        0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+        0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2a, 0x7,
+        0x2b, 0x76, 0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+        0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd, 0x1ffd, 0xffffffc,
+        0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8, 0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9,
+        0x3fffd6, 0x7fffda, 0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+        0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1, 0x7fffe2, 0x7fffe3,
+        0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5, 0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef,
+        0x3fffda, 0x1fffdd, 0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+        0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf, 0x7fffeb, 0x7fffec,
+        0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2, 0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef,
+        0xfffea, 0x3fffe2, 0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+        0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2, 0x3fffe8, 0x1ffffec,
+        0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde, 0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed,
+        0x7fff2, 0x1fffe3, 0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+        0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3, 0x7ffffe4, 0x7ffffe5,
+        0xfffec, 0xfffff3, 0xfffed, 0x1fffe6, 0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3,
+        0x3fffea, 0x3fffeb, 0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+        0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea,
+        0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed, 0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee,
+        0x3fffffff,
+    };
+    constexpr std::uint8_t kHuffmanLengths[257] = {
+        13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+        28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+        6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+        5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+        13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+        15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+        6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+        20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+        24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+        22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+        21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+        26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+        19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+        20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+        26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+        30,
+    };
+    // Canonical decoding tables: for each code length, the first code and
+    // where its symbols start in the (length, symbol)-sorted list
+    struct HuffmanDecodeTable {
+        std::uint32_t first[31] = {};
+        std::uint32_t count[31] = {};
+        std::uint16_t offset[31] = {};
+        std::uint16_t symbols[257] = {};
+
+        HuffmanDecodeTable() {
+            for (std::uint8_t len : kHuffmanLengths) ++count[len];
+            std::uint32_t code = 0;
+            std::uint16_t at = 0;
+            for (int len = 1; len <= 30; ++len) {
+                first[len] = code;
+                offset[len] = at;
+                at = static_cast<std::uint16_t>(at + count[len]);
+                code = (code + count[len]) << 1;
+            }
+            std::uint16_t next[31];
+            std::copy(std::begin(offset), std::end(offset), next);
+            for (std::uint16_t sym = 0; sym < 257; ++sym) symbols[next[kHuffmanLengths[sym]]++] = sym;
+        }
+    };
+
+    const HuffmanDecodeTable& huffmanDecodeTable() {
+        static const HuffmanDecodeTable table;
+        return table;
+    }
+
+    // Static entries by name: the first index for that name; entries with
+    // the same name are adjacent
+    const std::unordered_map<std::string_view, std::size_t>& staticByName() {
+        static const auto byName = [] {
+            std::unordered_map<std::string_view, std::size_t> m;
+            for (std::size_t i = 0; i < kStaticLen; ++i) m.emplace(kStaticTable[i].name, i + 1);
+            return m;
+        }();
+        return byName;
+    }
+
+    // Integer with an n-bit prefix (RFC 7541 section 5.1); first holds the pattern bits
+    void appendInt(std::string& dst, std::uint8_t first, int n, std::uint64_t v) {
+        const std::uint64_t max = (1u << n) - 1;
+        if (v < max) {
+            dst.push_back(static_cast<char>(first | v));
+            return;
+        }
+        dst.push_back(static_cast<char>(first | max));
+        v -= max;
+        while (v >= 128) {
+            dst.push_back(static_cast<char>(0x80 | (v & 0x7f)));
+            v >>= 7;
+        }
+        dst.push_back(static_cast<char>(v));
+    }
+
+    bool readInt(std::string_view& in, int n, std::uint64_t& v) {
+        if (in.empty()) return false;
+        const std::uint64_t max = (1u << n) - 1;
+        v = static_cast<std::uint8_t>(in[0]) & max;
+        in.remove_prefix(1);
+        if (v < max) return true;
+        for (int shift = 0; shift <= 28; shift += 7) {  // values stay below 2^32
+            if (in.empty()) return false;
+            const auto b = static_cast<std::uint8_t>(in[0]);
+            in.remove_prefix(1);
+            v += static_cast<std::uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    void appendString(std::string& dst, std::string_view s) {
+        const std::size_t huffman = HuffmanEncodeLength(s);
+        if (huffman < s.size()) {
+            appendInt(dst, 0x80, 7, huffman);
+            AppendHuffmanString(dst, s);
+        } else {
+            appendInt(dst, 0, 7, s.size());
+            dst.append(s);
+        }
+    }
+
+    std::shared_ptr<gocxx::errors::Error> readString(std::string_view& in, std::string& out) {
+        if (in.empty()) return ErrDecoding;
+        const bool huffman = static_cast<std::uint8_t>(in[0]) & 0x80;
+        std::uint64_t len;
+        if (!readInt(in, 7, len) || len > in.size()) return ErrDecoding;
+        const std::string_view raw = in.substr(0, static_cast<std::size_t>(len));
+        in.remove_prefix(static_cast<std::size_t>(len));
+        if (!huffman) {
+            out.assign(raw);
+            return nullptr;
+        }
+        auto decoded = HuffmanDecode(raw);
+        if (decoded.Failed()) return decoded.err;
+        out = std::move(decoded.value);
+        return nullptr;
+    }
+
+} // namespace
+
+std::size_t HuffmanEncodeLength(std::string_view s) {
+    std::uint64_t bits = 0;
+    for (unsigned char c : s) bits += kHuffmanLengths[c];
+    return static_cast<std::size_t>((bits + 7) / 8);
+}
+
+void AppendHuffmanString(std::string& dst, std::string_view s) {
+    std::uint64_t acc = 0;
+    int bits = 0;
+    for (unsigned char c : s) {
+        acc = (acc << kHuffmanLengths[c]) | kHuffmanCodes[c];
+        bits += kHuffmanLengths[c];
+        while (bits >= 8) {
+            bits -= 8;
+            dst.push_back(static_cast<char>(acc >> bits));
+        }
+        acc &= (std::uint64_t(1) << bits) - 1;
+    }
+    if (bits > 0) {
+        // Padded with the most significant bits of EOS, all ones
+        dst.push_back(static_cast<char>((acc << (8 - bits)) | ((1u << (8 - bits)) - 1)));
+    }
+}
+
+gocxx::base::Result<std::string> HuffmanDecode(std::string_view s) {
+    const HuffmanDecodeTable& t = huffmanDecodeTable();
+    std::string out;
+    out.reserve(s.size() * 8 / 5);
+    std::uint64_t acc = 0;
+    int bits = 0;
+    for (unsigned char c : s) {
+        acc = (acc << 8) | c;
+        bits += 8;
+        while (bits >= 5) {
+            bool found = false;
+            for (int len = 5; len <= bits && len <= 30; ++len) {
+                const auto code = static_cast<std::uint32_t>(acc >> (bits - len)) & ((1u << len) - 1);
+                if (code - t.first[len] < t.count[len]) {
+                    const std::uint16_t sym = t.symbols[t.offset[len] + (code - t.first[len])];
+                    if (sym == 256) {
+                        return {std::string(), ErrInvalidHuffman};  // EOS must not appear in a string
+                    }
+                    out.push_back(static_cast<char>(sym));
+                    bits -= len;
+                    acc &= (std::uint64_t(1) << bits) - 1;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) break;  // a code longer than the bits at hand
+        }
+    }
+    // At most 7 bits of padding, which must be a prefix of EOS
+    if (bits > 7 || acc != (std::uint64_t(1) << bits) - 1) {
+        return {std::string(), ErrInvalidHuffman};
+    }
+    return {std::move(out), nullptr};
+}
+
+namespace detail {
+
+void DynamicTable::Add(HeaderField f) {
+    size_ += f.Size();
+    entries_.push_front(std::move(f));
+    evict();  // an entry larger than the table empties it (RFC 7541 section 4.4)
+}
+
+void DynamicTable::SetMaxSize(std::uint32_t maxSize) {
+    max_size_ = maxSize;
+    evict();
+}
+
+void DynamicTable::evict() {
+    while (size_ > max_size_ && !entries_.empty()) {
+        size_ -= entries_.back().Size();
+        entries_.pop_back();
+    }
+}
+
+} // namespace detail
+
+// Encoder implementation
+Encoder::Encoder(std::uint32_t maxTableSize)
+    : table_(maxTableSize), limit_(maxTableSize), min_size_(maxTableSize) {}
+
+void Encoder::SetMaxDynamicTableSize(std::uint32_t size) {
+    size = std::min(size, limit_);
+    if (!size_update_ || size < min_size_) {
+        min_size_ = size;
+    }
+    size_update_ = true;
+    table_.SetMaxSize(size);
+}
+
+void Encoder::SetMaxDynamicTableSizeLimit(std::uint32_t limit) {
+    limit_ = limit;
+    if (table_.MaxSize() > limit) {
+        SetMaxDynamicTableSize(limit);
+    }
+}
+
+std::size_t Encoder::search(std::string_view name, std::string_view value, bool& exact) const {
+    exact = false;
+    std::size_t nameIndex = 0;
+    const auto& byName = staticByName();
+    if (auto it = byName.find(name); it != byName.end()) {
+        nameIndex = it->second;
+        for (std::size_t i = it->second; i <= kStaticLen && kStaticTable[i - 1].name == name; ++i) {
+            if (kStaticTable[i - 1].value == value) {
+                exact = true;
+                return i;
+            }
+        }
+    }
+    for (std::size_t i = 0; i < table_.Len(); ++i) {
+        const HeaderField& f = table_.At(i);
+        if (f.name != name) continue;
+        if (f.value == value) {
+            exact = true;
+            return kStaticLen + 1 + i;
+        }
+        if (!nameIndex) nameIndex = kStaticLen + 1 + i;
+    }
+    return nameIndex;
+}
+
+void Encoder::Encode(std::string& dst, std::string_view name, std::string_view value, bool sensitive) {
+    if (size_update_) {
+        // Shrunk and regrown since the last block: the peer must see both (RFC 7541 section 4.2)
+        if (min_size_ < table_.MaxSize()) appendInt(dst, 0x20, 5, min_size_);
+        appendInt(dst, 0x20, 5, table_.MaxSize());
+        size_update_ = false;
+    }
+    bool exact;
+    const std::size_t index = search(name, value, exact);
+    if (exact && !sensitive) {
+        appendInt(dst, 0x80, 7, index);
+        return;
+    }
+    HeaderField f{std::string(name), std::string(value), sensitive};
+    const bool indexed = !sensitive && f.Size() <= table_.MaxSize();
+    // Incremental indexing, never indexed, or without indexing
+    if (indexed) appendInt(dst, 0x40, 6, index);
+    else appendInt(dst, sensitive ? 0x10 : 0x00, 4, index);
+    if (!index) appendString(dst, name);
+    appendString(dst, value);
+    if (indexed) table_.Add(std::move(f));
+}
+
+// Decoder implementation
+Decoder::Decoder(std::uint32_t maxTableSize) : table_(maxTableSize), allowed_(maxTableSize) {}
+
+std::shared_ptr<gocxx::errors::Error> Decoder::field(std::size_t index, HeaderField& out) const {
+    if (index == 0) return ErrDecoding;
+    if (index <= kStaticLen) {
+        out.name.assign(kStaticTable[index - 1].name);
+        out.value.assign(kStaticTable[index - 1].value);
+        return nullptr;
+    }
+    if (index - kStaticLen - 1 >= table_.Len()) return ErrDecoding;
+    const HeaderField& f = table_.At(index - kStaticLen - 1);
+    out.name = f.name;
+    out.value = f.value;
+    return nullptr;
+}
+
+gocxx::base::Result<std::vector<HeaderField>> Decoder::Decode(std::string_view block) {
+    std::vector<HeaderField> fields;
+    std::uint64_t listSize = 0;
+    bool first = true;
+    auto fail = [&](std::shared_ptr<gocxx::errors::Error> err) -> gocxx::base::Result<std::vector<HeaderField>> {
+        return {std::vector<HeaderField>(), std::move(err)};
+    };
+    while (!block.empty()) {
+        const auto b = static_cast<std::uint8_t>(block[0]);
+        std::uint64_t index;
+        HeaderField f;
+        if (b & 0x80) {
+            // Indexed field
+            if (!readInt(block, 7, index)) return fail(ErrDecoding);
+            if (auto err = field(static_cast<std::size_t>(index), f)) return fail(err);
+        } else if ((b & 0xe0) == 0x20) {
+            // Dynamic table size update, only before the first field
+            if (!first || !readInt(block, 5, index) || index > allowed_) return fail(ErrDecoding);
+            table_.SetMaxSize(static_cast<std::uint32_t>(index));
+            continue;
+        } else {
+            const bool incremental = b & 0x40;
+            if (!readInt(block, incremental ? 6 : 4, index)) return fail(ErrDecoding);
+            f.sensitive = (b & 0xf0) == 0x10;
+            if (index) {
+                if (auto err = field(static_cast<std::size_t>(index), f)) return fail(err);
+            } else if (auto err = readString(block, f.name)) {
+                return fail(err);
+            }
+            if (auto err = readString(block, f.value)) return fail(err);
+            if (incremental) table_.Add(f);
+        }
+        first = false;
+        // Past the limit, keep decoding so the table stays in step, but drop the fields
+        listSize += f.Size();
+        if (!max_list_ || listSize <= max_list_) fields.push_back(std::move(f));
+    }
+    if (max_list_ && listSize > max_list_) {
+        return fail(ErrStringLength);
+    }
+    return {std::move(fields), nullptr};
+}
+
+} // namespace gocxx::net::hpack
@@ -1,8 +1,25 @@
 #include <gocxx/net/http.h>
+#include <gocxx/net/http_metrics.h>
+#include <gocxx/net/http_parser.h>
+#include <gocxx/net/http2.h>
+#include <gocxx/net/detail/http_internal.h>
+#include <gocxx/runtime/runtime.h>
+#include <gocxx/arena/arena.h>
 #include <sstream>
 #include <algorithm>
 #include <thread>
 #include <cctype>
+#include <ctime>
+#include <gocxx/base/defer.h>
+#include <gocxx/base/select.h>
+#include <gocxx/bufio/bufio.h>
+#include <gocxx/io/io_errors.h>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace gocxx::net::http {
 
@@ -36,6 +53,16 @@ std::string Request::Header(const std::string& key) const {
     return "";
 }
 
+void Request::reset() {
+    method.clear();
+    url.clear();
+    proto.clear();
+    header.clear();
+    body.clear();
+    path_names_ = nullptr;
+    pattern_ = nullptr;
+}
+
 // Response implementation
 std::string Response::Header(const std::string& key) const {
     auto it = header.find(toLower(key));
@@ -45,221 +72,900 @@ std::string Response::Header(const std::string& key) const {
     return "";
 }
 
+// Case-insensitive lookup in a header map whose keys are as the handler wrote them
+static const std::string* findHeader(const HeaderMap& headers, const std::string& key) {
+    for (const auto& [name, value] : headers) {
+        if (name.size() == key.size() && toLower(name) == key) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+// Whether a comma-separated header value such as Connection lists token
+static bool hasToken(const std::string& value, const std::string& token) {
+    std::istringstream items(value);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        if (toLower(trim(item)) == token) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reason phrases (RFC 9110 section 15), and the status lines built from them once
+namespace {
+
+struct StatusTable {
+    std::string text[600];
+    std::string line[600];
+
+    StatusTable() {
+        static const std::pair<int, const char*> phrases[] = {
+            {100, "Continue"}, {101, "Switching Protocols"}, {103, "Early Hints"},
+            {200, "OK"}, {201, "Created"}, {202, "Accepted"}, {203, "Non-Authoritative Information"},
+            {204, "No Content"}, {205, "Reset Content"}, {206, "Partial Content"},
+            {300, "Multiple Choices"}, {301, "Moved Permanently"}, {302, "Found"}, {303, "See Other"},
+            {304, "Not Modified"}, {307, "Temporary Redirect"}, {308, "Permanent Redirect"},
+            {400, "Bad Request"}, {401, "Unauthorized"}, {403, "Forbidden"}, {404, "Not Found"},
+            {405, "Method Not Allowed"}, {406, "Not Acceptable"}, {408, "Request Timeout"},
+            {409, "Conflict"}, {410, "Gone"}, {411, "Length Required"}, {412, "Precondition Failed"},
+            {413, "Content Too Large"}, {414, "URI Too Long"}, {415, "Unsupported Media Type"},
+            {416, "Range Not Satisfiable"}, {417, "Expectation Failed"}, {421, "Misdirected Request"},
+            {422, "Unprocessable Content"}, {425, "Too Early"}, {426, "Upgrade Required"},
+            {428, "Precondition Required"}, {429, "Too Many Requests"},
+            {431, "Request Header Fields Too Large"},
+            {500, "Internal Server Error"}, {501, "Not Implemented"}, {502, "Bad Gateway"},
+            {503, "Service Unavailable"}, {504, "Gateway Timeout"}, {505, "HTTP Version Not Supported"},
+        };
+        for (const auto& [code, phrase] : phrases) {
+            text[code] = phrase;
+        }
+        for (int code = 100; code < 600; ++code) {
+            line[code] = "HTTP/1.1 " + std::to_string(code) + " " + text[code] + "\r\n";
+        }
+    }
+};
+
+const StatusTable& statusTable() {
+    static const StatusTable table;
+    return table;
+}
+
+} // namespace
+
+std::string_view detail::DateHeader() {
+    thread_local std::time_t cached = -1;
+    thread_local char buf[64];
+    thread_local std::size_t len = 0;
+    const std::time_t now = std::time(nullptr);
+    if (now != cached) {
+        std::tm tm{};
+#ifdef _WIN32
+        gmtime_s(&tm, &now);
+#else
+        gmtime_r(&now, &tm);
+#endif
+        len = std::strftime(buf, sizeof(buf), "date: %a, %d %b %Y %H:%M:%S GMT\r\n", &tm);
+        cached = now;
+    }
+    return std::string_view(buf, len);
+}
+
+const std::string& StatusText(int code) {
+    static const std::string unknown;
+    return code >= 100 && code < 600 ? statusTable().text[code] : unknown;
+}
+
 // ResponseWriter implementation (internal)
-class ResponseWriterImpl : public ResponseWriter {
+class ResponseWriterImpl : public ResponseWriter, public Flusher, public gocxx::io::ReaderFrom {
 public:
-    ResponseWriterImpl(std::shared_ptr<TCPConn> conn)
-        : conn_(conn), status_code_(200), headers_written_(false) {}
+    // Bodies up to this size are held back so the response can carry a
+    // Content-Length; after the header, writes are coalesced into sends of this size
+    static constexpr std::size_t kBufferSize = 4096;
+
+    // The header map and buffers are allocated from arena, which must outlive the writer
+    ResponseWriterImpl(std::shared_ptr<TCPConn> conn, std::pmr::memory_resource* arena, bool keepAlive = false,
+                       bool headRequest = false, const std::string& proto = "HTTP/1.1")
+        : conn_(conn), status_code_(200), headers_written_(false), keep_alive_(keepAlive),
+          head_request_(headRequest), http10_(proto == "HTTP/1.0"), arena_(arena), buffer_(arena), headers_(arena) {
+        buffer_.reserve(kBufferSize);
+    }
     
-    std::map<std::string, std::string>& Header() override {
+    HeaderMap& Header() override {
         return headers_;
     }
     
     gocxx::base::Result<std::size_t> Write(const std::string& data) override {
-        if (!headers_written_) {
-            WriteHeader(status_code_);
+        if (head_request_ || !bodyAllowed()) {
+            return {data.size(), nullptr};
         }
-        
-        return conn_->Write(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        if (buffer_.size() + data.size() <= kBufferSize) {
+            buffer_ += data;
+            return {data.size(), nullptr};
+        }
+        // Too long to buffer. Before the header is out this commits to
+        // chunked or close-delimited framing; the header leaves with the
+        // buffered bytes in one writev instead of several sends, which would
+        // stall on Nagle/delayed ACK. Small data starts the next buffer,
+        // larger data goes out in the same write.
+        std::pmr::string head = headers_written_ ? std::pmr::string(arena_) : buildHeader(false);
+        const bool small = data.size() < kBufferSize;
+        auto res = writeBody(head, small ? std::string_view() : std::string_view(data), false);
+        if (res.Failed()) {
+            return {0, res.err};
+        }
+        if (small) {
+            buffer_ = data;
+        }
+        return {data.size(), nullptr};
     }
     
     void WriteHeader(int statusCode) override {
-        if (headers_written_) {
+        // Sent with the first body bytes, or by finish()
+        if (headers_written_ || status_set_) {
             return;
         }
-        
         status_code_ = statusCode;
+        status_set_ = true;
+    }
+
+    /// Sends the header if not yet sent, and everything written so far.
+    void Flush() override {
+        std::pmr::string head = headers_written_ ? std::pmr::string(arena_) : buildHeader(false);
+        writeBody(head, std::string_view(), false);
+    }
+
+    /**
+     * Copies @p r into the body. With a Content-Length set and no chunked
+     * framing, the header and buffered bytes go out first and the rest is
+     * handed to the connection's ReadFrom, so files leave through sendfile.
+     */
+    gocxx::base::Result<std::size_t> ReadFrom(std::shared_ptr<gocxx::io::Reader> r) override {
+        if (head_request_ || !bodyAllowed()) {
+            return {0, nullptr};
+        }
+        if (!headers_written_ && findHeader(headers_, "content-length")) {
+            Flush();
+        }
+        if (headers_written_ && !chunked_) {
+            if (!buffer_.empty()) {
+                Flush();
+            }
+            auto res = conn_->ReadFrom(std::move(r));
+            body_sent_ += res.value;
+            if (res.Failed()) {
+                keep_alive_ = false;
+            }
+            return res;
+        }
+        // Unknown length: through the buffer, so it can still get a Content-Length or go chunked
+        std::size_t total = 0;
+        std::string chunk(32 * 1024, '\0');
+        while (true) {
+            auto res = r->Read(reinterpret_cast<uint8_t*>(&chunk[0]), chunk.size());
+            if (res.value > 0) {
+                auto w = Write(chunk.substr(0, res.value));
+                if (w.Failed()) {
+                    return {total, w.err};
+                }
+                total += res.value;
+            }
+            if (res.Failed()) {
+                return {total, gocxx::errors::Is(res.err, gocxx::io::ErrEOF) ? nullptr : res.err};
+            }
+            if (res.value == 0) {
+                return {total, nullptr};
+            }
+        }
+    }
+
+    /// Sends whatever the handler left unsent; called after the handler returns.
+    void finish() {
+        std::pmr::string head = headers_written_ ? std::pmr::string(arena_) : buildHeader(true);
+        writeBody(head, std::string_view(), true);
+        if (declared_length_ >= 0 && body_sent_ != static_cast<std::size_t>(declared_length_)) {
+            keep_alive_ = false;  // the peer cannot tell where this response ends
+        }
+    }
+
+    /// Whether the connection can carry another request after finish().
+    bool KeepAlive() const {
+        return keep_alive_;
+    }
+
+    int StatusCode() const {
+        return status_code_;
+    }
+
+    /// Body bytes sent so far, framing excluded.
+    std::size_t BodyBytes() const {
+        return body_sent_;
+    }
+
+private:
+    bool bodyAllowed() const {
+        return detail::BodyAllowed(status_code_);
+    }
+
+    // Writes prefix (the header, when not yet sent), then the buffered bytes
+    // and data with the framing chosen by buildHeader; last adds the
+    // terminating chunk. Everything goes out in one vectored write.
+    gocxx::base::Result<std::size_t> writeBody(std::string_view prefix, std::string_view data, bool last) {
+        static constexpr std::string_view kCRLF = "\r\n";
+        static constexpr std::string_view kLastChunk = "0\r\n\r\n";
+        char chunk_size[20];
+        gocxx::io::Buffers bufs;
+        if (!prefix.empty()) bufs.push_back(gocxx::io::Span(prefix));
+        const std::size_t length = buffer_.size() + data.size();
+        if (chunked_ && length > 0) {
+            // Hex length, written backwards
+            std::size_t n = length;
+            char* end = chunk_size + sizeof(chunk_size);
+            char* p = end - 2;
+            p[0] = '\r';
+            p[1] = '\n';
+            do {
+                *--p = "0123456789abcdef"[n & 0xf];
+                n >>= 4;
+            } while (n);
+            bufs.push_back(gocxx::io::Span(std::string_view(p, static_cast<std::size_t>(end - p))));
+        }
+        if (!buffer_.empty()) bufs.push_back(gocxx::io::Span(buffer_));
+        if (!data.empty()) bufs.push_back(gocxx::io::Span(data));
+        if (chunked_ && length > 0) bufs.push_back(gocxx::io::Span(kCRLF));
+        if (chunked_ && last) bufs.push_back(gocxx::io::Span(kLastChunk));
+        if (bufs.empty()) {
+            return {0, nullptr};
+        }
+
+        auto res = conn_->WriteBuffers(bufs);
+        buffer_.clear();
+        body_sent_ += length;
+        if (res.Failed()) {
+            keep_alive_ = false;
+            return {0, res.err};
+        }
+        return {prefix.size() + length, nullptr};
+    }
+
+    // complete: the whole body is buffered, so its length is known
+    std::pmr::string buildHeader(bool complete) {
         headers_written_ = true;
-        
-        // Build response
-        std::ostringstream response;
-        response << "HTTP/1.1 " << statusCode << " ";
-        
-        // Status text
-        switch (statusCode) {
-            case 200: response << "OK"; break;
-            case 201: response << "Created"; break;
-            case 400: response << "Bad Request"; break;
-            case 404: response << "Not Found"; break;
-            case 500: response << "Internal Server Error"; break;
-            default: response << "Unknown"; break;
-        }
-        response << "\r\n";
-        
-        // Headers
+
+        const std::string* content_length = findHeader(headers_, "content-length");
+        if (content_length && (!bodyAllowed() || head_request_)) {
+            // Describes the body a GET would get; none follows
+        } else if (content_length) {
+            try {
+                declared_length_ = std::stoll(*content_length);
+            } catch (...) {
+                declared_length_ = -1;
+                keep_alive_ = false;
+            }
+        } else if (!bodyAllowed() || head_request_) {
+            // No body follows
+        } else if (!complete && keep_alive_ && !http10_) {
+            chunked_ = true;
+        } else if (!complete) {
+            keep_alive_ = false;  // the body ends when the connection closes
+        }
+        const std::string* connection = findHeader(headers_, "connection");
+        if (connection && hasToken(*connection, "close")) {
+            keep_alive_ = false;
+        }
+
+        const StatusTable& table = statusTable();
+        const bool known = status_code_ >= 100 && status_code_ < 600;
+        std::pmr::string head(arena_);
+        head.reserve(256);
+        if (known) {
+            head += table.line[status_code_];
+        } else {
+            head.append("HTTP/1.1 ").append(std::to_string(status_code_)).append(" Unknown\r\n");
+        }
         for (const auto& [key, value] : headers_) {
-            response << key << ": " << value << "\r\n";
+            head.append(key).append(": ").append(value).append("\r\n");
         }
-        
-        response << "\r\n";
-        
-        std::string response_str = response.str();
-        conn_->Write(reinterpret_cast<const uint8_t*>(response_str.data()), 
-                    response_str.size());
+        if (!findHeader(headers_, "date")) {
+            head += detail::DateHeader();
+        }
+        if (!content_length && bodyAllowed() && !head_request_ && complete) {
+            head.append("content-length: ").append(std::to_string(buffer_.size())).append("\r\n");
+        }
+        if (chunked_) {
+            head += "transfer-encoding: chunked\r\n";
+        }
+        if (!keep_alive_ && !connection) {
+            head += "connection: close\r\n";
+        } else if (keep_alive_ && http10_ && !connection) {
+            head += "connection: keep-alive\r\n";
+        }
+        head += "\r\n";
+        return head;
     }
 
-private:
     std::shared_ptr<TCPConn> conn_;
     int status_code_;
     bool headers_written_;
-    std::map<std::string, std::string> headers_;
+    bool status_set_ = false;
+    bool keep_alive_;
+    bool head_request_;
+    bool http10_;
+    bool chunked_ = false;
+    long long declared_length_ = -1;
+    std::size_t body_sent_ = 0;
+    std::pmr::memory_resource* arena_;
+    std::pmr::string buffer_;
+    HeaderMap headers_;
 };
 
-// ServeMux implementation
-void ServeMux::HandleFunc(const std::string& pattern, HandlerFunc handler) {
-    handlers_[pattern] = handler;
-}
+// Server implementation
+std::shared_ptr<gocxx::errors::Error> ErrServerClosed =
+    gocxx::errors::New("http: Server closed");
 
-void ServeMux::ServeHTTP(ResponseWriter& w, const Request& req) {
-    // Simple exact match for now
-    auto it = handlers_.find(req.url);
-    if (it != handlers_.end()) {
-        it->second(w, req);
-        return;
+gocxx::base::Result<void> Server::ListenAndServe() {
+    ListenConfig config;
+    config.backlog = backlog;
+    if (pin_accept_loops) {
+        config.incoming_cpu = 0;
     }
-    
-    // Try prefix match
-    std::string longest_match;
-    HandlerFunc matched_handler;
-    
-    for (const auto& [pattern, handler] : handlers_) {
-        if (req.url.find(pattern) == 0 && pattern.length() > longest_match.length()) {
-            longest_match = pattern;
-            matched_handler = handler;
+    if (listen_shards > 1) {
+        auto shards = config.ListenShards("tcp", addr, listen_shards);
+        if (shards.Failed()) {
+            return {shards.err};
         }
+        return ServeShards(std::move(shards.value));
     }
-    
-    if (!longest_match.empty()) {
-        matched_handler(w, req);
-        return;
+    auto listener_result = config.Listen("tcp", addr);
+    if (listener_result.Failed()) {
+        return {listener_result.err};
     }
     
-    // 404 Not Found
-    w.WriteHeader(StatusNotFound);
-    w.Write("404 page not found\n");
+    return Serve(listener_result.value);
 }
 
-// Server implementation
-gocxx::base::Result<void> Server::ListenAndServe() {
-    auto listener_result = ListenTCP("tcp", addr);
-    if (listener_result.Failed()) {
-        return {listener_result.err};
+gocxx::base::Result<void> Server::Serve(std::shared_ptr<TCPListener> listener) {
+    auto cancel_result = context::WithCancel(context::Background());
+    if (cancel_result.Failed()) {
+        return {cancel_result.err};
+    }
+    context::ContextPtr accepting = cancel_result.value.first;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (shutting_down_) {
+            listener->Close();
+            return {ErrServerClosed};
+        }
+        listeners_.push_back(listener);
+        stop_accepting_.push_back(cancel_result.value.second);
+        if (max_conns > 0 && !conn_slots_) {
+            conn_slots_ = std::make_unique<gocxx::sync::Semaphore>(static_cast<std::int64_t>(max_conns));
+        }
+        if (max_handlers > 0 && !handler_slots_) {
+            handler_slots_ = std::make_unique<gocxx::sync::Semaphore>(static_cast<std::int64_t>(max_handlers));
+        }
     }
     
-    auto listener = listener_result.value;
-    
+    std::chrono::milliseconds retry_delay{0};
     while (true) {
+        // At the connection limit, leave new connections in the backlog
+        if (conn_slots_ && conn_slots_->Acquire(accepting).Failed()) {
+            return {ErrServerClosed};
+        }
+        
         auto conn_result = listener->Accept();
         if (conn_result.Failed()) {
-            // Log error but continue
+            if (conn_slots_) {
+                conn_slots_->Release();
+            }
+            if (accepting->Err().Failed()) {
+                return {ErrServerClosed};
+            }
+            if (gocxx::errors::Is(conn_result.err, ErrClosed)) {
+                return {conn_result.err};
+            }
+            // Probably out of descriptors: back off like Go, 5ms doubling to 1s
+            retry_delay = retry_delay.count() == 0 ? std::chrono::milliseconds(5)
+                                                   : std::min(retry_delay * 2, std::chrono::milliseconds(1000));
+            gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::Sleep);
+            std::this_thread::sleep_for(retry_delay);
             continue;
         }
+        retry_delay = std::chrono::milliseconds(0);
         
         auto conn = std::dynamic_pointer_cast<TCPConn>(conn_result.value);
-        if (!conn) {
+        if (!conn || !trackConn(conn)) {
+            if (conn) {
+                conn->close();
+            }
+            if (conn_slots_) {
+                conn_slots_->Release();
+            }
             continue;
         }
         
-        // Handle connection in a new thread
-        std::thread([this, conn]() {
-            handleConnection(conn);
-        }).detach();
+        // Handle the connection as a runtime task
+        gocxx::go([this, conn]() {
+            try {
+                handleConnection(conn);
+            } catch (...) {
+                // A handler threw: like a panic in Go, it costs only its connection
+            }
+        });
+    }
+}
+
+// Binds the calling thread to one CPU, counted modulo the CPUs the process may use
+static void pinToCpu(std::size_t i) {
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+        return;
+    }
+    std::size_t n = i % static_cast<std::size_t>(CPU_COUNT(&allowed));
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed) && n-- == 0) {
+            cpu_set_t one;
+            CPU_ZERO(&one);
+            CPU_SET(cpu, &one);
+            pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+            return;
+        }
+    }
+#else
+    (void)i;
+#endif
+}
+
+gocxx::base::Result<void> Server::ServeShards(std::vector<std::shared_ptr<TCPListener>> listeners) {
+    if (listeners.empty()) {
+        throw std::invalid_argument("http: ServeShards needs at least one listener");
     }
+    std::vector<gocxx::base::Result<void>> results(listeners.size());
+    std::vector<std::thread> loops;
+    loops.reserve(listeners.size());
+    for (std::size_t i = 0; i < listeners.size(); ++i) {
+        loops.emplace_back([this, i, &listeners, &results] {
+            if (pin_accept_loops) {
+                pinToCpu(i);
+            }
+            results[i] = Serve(listeners[i]);
+        });
+    }
+    for (auto& loop : loops) {
+        loop.join();
+    }
+    for (const auto& result : results) {
+        if (result.Failed() && !gocxx::errors::Is(result.err, ErrServerClosed)) {
+            return result;
+        }
+    }
+    return {ErrServerClosed};
+}
+
+gocxx::base::Result<void> Server::Shutdown(context::ContextPtr ctx) {
+    beginShutdown(false);
     
+    if (!ctx) {
+        drained_.recv();
+        return {};
+    }
+    bool drained = false;
+    gocxx::base::Chan<bool> done = ctx->Done();
+    gocxx::base::select(
+        gocxx::base::recvCase(drained_, [&](std::optional<bool>) { drained = true; }),
+        gocxx::base::recvCase(done, [](std::optional<bool>) {}));
+    if (drained) {
+        return {};
+    }
+    return ctx->Err();
+}
+
+gocxx::base::Result<void> Server::Close() {
+    beginShutdown(true);
     return {};
 }
 
-void Server::handleConnection(std::shared_ptr<TCPConn> conn) {
-    // Read request
-    const size_t BUFFER_SIZE = 4096;
-    uint8_t buffer[BUFFER_SIZE];
-    std::string raw_request;
-    
+void Server::beginShutdown(bool closeActive) {
+    std::vector<std::shared_ptr<TCPListener>> listeners;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (!shutting_down_) {
+            shutting_down_ = true;
+            listeners = std::move(listeners_);
+            for (auto& stop : stop_accepting_) {
+                stop();
+            }
+            stop_accepting_.clear();
+        }
+        // Closing wakes the connection's task, which untracks it
+        for (const auto& [conn, state] : conns_) {
+            if (state != ConnState::Active || closeActive) {
+                conn->close();
+            }
+        }
+        if (conns_.empty() && !drained_.isClosed()) {
+            drained_.close();
+        }
+    }
+    for (auto& listener : listeners) {
+        listener->Close();
+    }
+}
+
+bool Server::trackConn(const std::shared_ptr<TCPConn>& conn) {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (shutting_down_) {
+            return false;
+        }
+        conns_[conn.get()] = ConnState::New;
+    }
+    if (metrics) {
+        metrics->connOpened();
+    }
+    if (conn_state) {
+        conn_state(conn, ConnState::New);
+    }
+    return true;
+}
+
+bool Server::setState(const std::shared_ptr<TCPConn>& conn, ConnState state) {
+    ConnState prev;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (shutting_down_ && state == ConnState::Idle) {
+            return false;  // Shutdown only waits for requests already being served
+        }
+        ConnState& current = conns_[conn.get()];
+        prev = current;
+        current = state;
+    }
+    if (metrics) {
+        metrics->connStateChanged(prev, state);
+    }
+    if (conn_state) {
+        conn_state(conn, state);
+    }
+    return true;
+}
+
+// The connection stays tracked until the last use of the server: Shutdown may return, and the
+// server go away, as soon as it is erased
+void Server::untrackConn(const std::shared_ptr<TCPConn>& conn) {
+    ConnState prev = ConnState::New;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = conns_.find(conn.get());
+        if (it != conns_.end()) {
+            prev = it->second;
+        }
+    }
+    if (metrics) {
+        metrics->connStateChanged(prev, ConnState::Closed);
+    }
+    if (conn_state) {
+        conn_state(conn, ConnState::Closed);
+    }
+    if (conn_slots_) {
+        conn_slots_->Release();
+    }
+    gocxx::base::Chan<bool> drained = drained_;  // shares the channel, which outlives the server
+    bool last;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        conns_.erase(conn.get());
+        last = shutting_down_ && conns_.empty();
+    }
+    if (last && !drained.isClosed()) {
+        drained.close();
+    }
+}
+
+bool Server::shuttingDown() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return shutting_down_;
+}
+
+// Request errors answered with a status line before the connection is closed
+static std::shared_ptr<gocxx::errors::Error> errBadRequest =
+    gocxx::errors::New("http: malformed request");
+static std::shared_ptr<gocxx::errors::Error> errHeaderTooLarge =
+    gocxx::errors::New("http: request header too large");
+static std::shared_ptr<gocxx::errors::Error> errBodyTooLarge =
+    gocxx::errors::New("http: request body too large");
+
+// One header line, joined from ReadLine pieces when it is longer than the buffer
+static gocxx::base::Result<std::string> readHeaderLine(gocxx::bufio::Reader& reader, std::size_t& budget) {
+    std::string line;
+    bool more = true;
+    while (more) {
+        auto piece = reader.ReadLine(&more);
+        if (piece.Failed()) {
+            return {line, piece.err};
+        }
+        if (piece.value.size() + 2 > budget) {
+            return {line, errHeaderTooLarge};
+        }
+        budget -= piece.value.size() + (more ? 0 : 2);
+        line.append(piece.value.data(), piece.value.size());
+    }
+    return {line, nullptr};
+}
+
+// Appends exactly n body bytes to out, or errBodyTooLarge when that would take
+// it past limit (0 = none). The body grows as bytes arrive, so a length the
+// client merely claims costs nothing.
+static std::shared_ptr<gocxx::errors::Error> readBody(gocxx::bufio::Reader& reader, std::size_t n, std::string& out,
+                                                      std::size_t limit) {
+    if (limit > 0 && (n > limit || out.size() > limit - n)) {
+        return errBodyTooLarge;
+    }
+    constexpr std::size_t kStep = 64 * 1024;
+    std::size_t got = 0;
+    while (got < n) {
+        const std::size_t start = out.size();
+        out.resize(start + std::min(n - got, kStep));
+        auto res = reader.Read(reinterpret_cast<uint8_t*>(&out[start]), out.size() - start);
+        out.resize(start + res.value);
+        got += res.value;
+        if (res.value == 0) {
+            return res.err ? res.err : gocxx::io::ErrUnexpectedEOF;
+        }
+    }
+    return nullptr;
+}
+
+gocxx::base::Result<void> Server::readRequest(gocxx::bufio::Reader& reader, TCPConn& conn, Request& req) {
+    // Parse the head in place in the reader's buffer; only a head longer
+    // than the buffer is copied out, line by line so no body byte is consumed
+    RequestParser parser;
+    std::pmr::string spill(req.Arena());
     while (true) {
-        auto read_result = conn->Read(buffer, BUFFER_SIZE);
-        if (read_result.Failed() || read_result.value == 0) {
+        std::string_view head = spill.empty() ? reader.Peek(reader.Buffered()).value : std::string_view(spill);
+        auto status = parser.Parse(head);
+        if (status == RequestParser::Status::Complete) {
             break;
         }
-        
-        raw_request.append(reinterpret_cast<char*>(buffer), read_result.value);
-        
-        // Check if we have a complete request (simple check for \r\n\r\n)
-        if (raw_request.find("\r\n\r\n") != std::string::npos) {
-            break;
+        if (status == RequestParser::Status::Malformed) {
+            return {errBadRequest};
         }
-        
-        // Limit request size to prevent DoS
-        if (raw_request.size() > 1024 * 1024) {  // 1MB limit
-            break;
+        if (status == RequestParser::Status::TooManyHeaders || head.size() >= max_header_bytes) {
+            return {errHeaderTooLarge};
+        }
+        if (spill.empty() && reader.Buffered() < reader.Size()) {
+            auto more = reader.Peek(reader.Buffered() + 1);
+            if (more.Failed()) {
+                return {more.err};
+            }
+            continue;
+        }
+        if (spill.empty()) {
+            spill.assign(head.data(), head.size());
+            reader.Discard(head.size());
+        }
+        auto piece = reader.ReadSlice('\n');
+        spill.append(piece.value.data(), piece.value.size());
+        if (piece.Failed() && !gocxx::errors::Is(piece.err, gocxx::bufio::ErrBufferFull)) {
+            return {piece.err};
         }
     }
     
-    // Parse request
-    auto req_result = parseRequest(raw_request);
-    if (req_result.Failed()) {
-        conn->close();
-        return;
+    req.method.assign(parser.Method().data(), parser.Method().size());
+    req.url.assign(parser.Target().data(), parser.Target().size());
+    req.proto = parser.MinorVersion() == 0 ? "HTTP/1.0" : "HTTP/1.1";
+    for (std::size_t i = 0; i < parser.NumHeaders(); ++i) {
+        HeaderField field = parser.Field(i);
+        std::string key(field.name);
+        std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+        auto it = req.header.find(key);
+        if (it == req.header.end()) {
+            req.header.emplace(std::move(key), std::string(field.value));
+        } else {
+            it->second.append(", ").append(field.value.data(), field.value.size());  // repeated field: one comma-separated list (RFC 9110 section 5.3)
+        }
+    }
+    if (spill.empty()) {
+        reader.Discard(parser.Consumed());
     }
     
-    auto request = req_result.value;
-    request.remote_addr = conn->RemoteAddr()->String();
+    // The header deadline does not cover the body
+    conn.SetReadDeadline(std::chrono::system_clock::time_point{});
     
-    // Handle request
-    ResponseWriterImpl writer(conn);
-    if (handler) {
-        handler->ServeHTTP(writer, request);
+    // Parse body: chunked takes precedence over Content-Length (RFC 9112 section 6.3)
+    const std::string transfer_encoding = toLower(req.Header("transfer-encoding"));
+    if (!transfer_encoding.empty()) {
+        if (transfer_encoding != "chunked") {
+            return {errBadRequest};
+        }
+        while (true) {
+            std::size_t line_budget = max_header_bytes;
+            auto size_line = readHeaderLine(reader, line_budget);
+            if (size_line.Failed()) {
+                return {size_line.err};
+            }
+            std::size_t chunk_size = 0;
+            std::size_t digits = 0;
+            for (char c : size_line.value) {
+                if (c == ';' || c == ' ' || c == '\t') break;  // chunk extensions are ignored
+                int v = std::isdigit(static_cast<unsigned char>(c)) ? c - '0'
+                      : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                      : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+                if (v < 0 || ++digits > 15) {
+                    return {errBadRequest};
+                }
+                chunk_size = chunk_size * 16 + static_cast<std::size_t>(v);
+            }
+            if (digits == 0) {
+                return {errBadRequest};
+            }
+            if (chunk_size == 0) {
+                break;
+            }
+            if (auto err = readBody(reader, chunk_size, req.body, max_body_bytes)) {
+                return {err};
+            }
+            line_budget = max_header_bytes;
+            auto crlf = readHeaderLine(reader, line_budget);
+            if (crlf.Failed() || !crlf.value.empty()) {
+                return {crlf.Failed() ? crlf.err : errBadRequest};
+            }
+        }
+        // Trailer fields, up to the empty line
+        std::size_t budget = max_header_bytes;
+        while (true) {
+            auto trailer = readHeaderLine(reader, budget);
+            if (trailer.Failed()) {
+                return {trailer.err};
+            }
+            if (trailer.value.empty()) {
+                break;
+            }
+        }
+    } else if (req.header.count("content-length")) {
+        const std::string& length = req.header["content-length"];
+        if (length.empty() || length.size() > 18 ||
+            !std::all_of(length.begin(), length.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+            return {errBadRequest};
+        }
+        if (auto err = readBody(reader, static_cast<std::size_t>(std::stoull(length)), req.body, max_body_bytes)) {
+            return {err};
+        }
     }
     
-    conn->close();
+    return {};
 }
 
-gocxx::base::Result<Request> Server::parseRequest(const std::string& raw_request) {
-    Request req;
-    
-    std::istringstream stream(raw_request);
-    std::string line;
-    
-    // Parse request line
-    if (!std::getline(stream, line)) {
-        return {req, gocxx::errors::New("invalid request: no request line")};
-    }
-    
-    // Remove \r if present
-    if (!line.empty() && line.back() == '\r') {
-        line.pop_back();
+// Whether the connection opens with the HTTP/2 client preface; peeks, consuming nothing
+static bool hasH2Preface(gocxx::bufio::Reader& reader) {
+    const std::string_view preface = http2::ClientPreface;
+    while (true) {
+        const std::size_t n = std::min(reader.Buffered(), preface.size());
+        auto head = reader.Peek(n);
+        if (head.Failed() || head.value != preface.substr(0, n)) {
+            return false;
+        }
+        if (n == preface.size()) {
+            return true;
+        }
+        if (reader.Peek(n + 1).Failed()) {
+            return false;
+        }
     }
+}
+
+void Server::handleConnection(std::shared_ptr<TCPConn> conn) {
+    gocxx::bufio::Reader reader(conn);
+    std::size_t served = 0;
     
-    std::istringstream request_line(line);
-    request_line >> req.method >> req.url >> req.proto;
-    
-    if (req.method.empty() || req.url.empty()) {
-        return {req, gocxx::errors::New("invalid request line")};
-    }
+    // Everything a request needs beyond its strings comes from one arena,
+    // rewound after each response instead of freed piece by piece
+    gocxx::arena::Arena arena;
+    Request request(&arena);
+    request.remote_addr = conn->RemoteAddr()->String();
+    defer([this, &conn] {
+        conn->close();
+        untrackConn(conn);
+    });
     
-    // Parse headers
-    while (std::getline(stream, line)) {
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+    while (true) {
+        // Wait for the next request: the idle timeout between requests,
+        // the header timeout for the first one
+        auto wait = served > 0 && idle_timeout.count() > 0 ? idle_timeout : read_header_timeout;
+        auto deadline = [](std::chrono::nanoseconds d) {
+            return d.count() > 0
+                ? std::chrono::system_clock::now() + std::chrono::duration_cast<std::chrono::system_clock::duration>(d)
+                : std::chrono::system_clock::time_point{};
+        };
+        conn->SetReadDeadline(deadline(wait));
+        if (reader.Peek(1).Failed()) {
+            break;  // closed by the peer, timed out or shut down
+        }
+        if (served > 0) {
+            conn->SetReadDeadline(deadline(read_header_timeout));
+        } else if (h2c && hasH2Preface(reader)) {
+            serveH2(conn, reader);
+            break;
+        }
+        
+        request.reset();
+        arena.Reset();
+        auto req_result = readRequest(reader, *conn, request);
+        if (req_result.Failed()) {
+            const bool too_large = gocxx::errors::Is(req_result.err, errHeaderTooLarge);
+            const bool body_too_large = gocxx::errors::Is(req_result.err, errBodyTooLarge);
+            if (too_large || body_too_large || gocxx::errors::Is(req_result.err, errBadRequest)) {
+                ResponseWriterImpl writer(conn, &arena);
+                writer.WriteHeader(too_large ? 431 : body_too_large ? 413 : StatusBadRequest);
+                writer.Write(too_large ? "431 Request Header Fields Too Large"
+                             : body_too_large ? "413 Content Too Large" : "400 Bad Request");
+                writer.finish();
+            }
+            if (body_too_large) {
+                // The client may still be sending the body: closing with it
+                // unread would reset the connection and could discard the
+                // 413, so stop writing and drain for a moment first
+                conn->CloseWrite();
+                conn->SetReadDeadline(deadline(std::chrono::milliseconds(500)));
+                uint8_t sink[4096];
+                while (conn->Read(sink, sizeof(sink)).value > 0) {
+                }
+            }
+            break;
+        }
+        if (!setState(conn, ConnState::Active)) {
+            break;
         }
+        ++served;
         
-        if (line.empty()) {
-            break;  // End of headers
+        // HTTP/1.1 keeps the connection unless asked not to; HTTP/1.0 only when asked
+        const std::string connection = request.Header("connection");
+        bool keep_alive = request.proto == "HTTP/1.0" ? hasToken(connection, "keep-alive")
+                                                      : !hasToken(connection, "close");
+        if (max_requests_per_conn > 0 && served >= max_requests_per_conn) {
+            keep_alive = false;
+        }
+        if (keep_alive && shuttingDown()) {
+            keep_alive = false;
+        }
+        // Both framings: the request may have been smuggled past a proxy
+        // that read the other one, so nothing more is read from this
+        // connection (RFC 9112 section 6.3)
+        if (request.header.count("transfer-encoding") && request.header.count("content-length")) {
+            keep_alive = false;
+        }
+        
+        // Handle request
+        ResponseWriterImpl writer(conn, &arena, keep_alive, request.method == "HEAD", request.proto);
+        std::chrono::steady_clock::time_point started;
+        if (metrics) {
+            metrics->RequestStarted();
+            started = std::chrono::steady_clock::now();
+        }
+        if (handler) {
+            if (handler_slots_) {
+                handler_slots_->Acquire(nullptr);
+            }
+            defer([this] {
+                if (handler_slots_) {
+                    handler_slots_->Release();
+                }
+            });
+            handler->ServeHTTP(writer, request);
+        }
+        writer.finish();
+        if (metrics) {
+            metrics->RequestFinished(request.Pattern(), writer.StatusCode(), request.body.size(), writer.BodyBytes(),
+                                     std::chrono::steady_clock::now() - started);
         }
         
-        size_t colon_pos = line.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string key = toLower(trim(line.substr(0, colon_pos)));
-            std::string value = trim(line.substr(colon_pos + 1));
-            req.header[key] = value;
+        if (!writer.KeepAlive() || !setState(conn, ConnState::Idle)) {
+            break;
         }
     }
-    
-    // Parse body (rest of the stream)
-    std::ostringstream body_stream;
-    body_stream << stream.rdbuf();
-    req.body = body_stream.str();
-    
-    return {req, nullptr};
 }
 
 // Global default ServeMux
@@ -281,229 +987,528 @@ gocxx::base::Result<void> ListenAndServe(
     return server.ListenAndServe();
 }
 
-// HTTP client functions
-gocxx::base::Result<Response> Get(const std::string& url) {
-    Response resp;
-    
-    // Parse URL (simplified - assumes http://host:port/path format)
-    std::string address;
-    std::string path = "/";
+// HTTP client
+
+// Splits "http://host[:port]/path" into "host:port" (port 80 by default) and "/path"
+static bool parseURL(const std::string& url, std::string& address, std::string& path) {
+    if (url.find("http://") != 0) {
+        return false;
+    }
+    std::string rest = url.substr(7);  // Remove "http://"
+    size_t slash_pos = rest.find('/');
     
-    // Simple URL parsing
-    if (url.find("http://") == 0) {
-        std::string rest = url.substr(7);  // Remove "http://"
-        size_t slash_pos = rest.find('/');
-        
-        if (slash_pos != std::string::npos) {
-            address = rest.substr(0, slash_pos);
-            path = rest.substr(slash_pos);
-        } else {
-            address = rest;
-        }
+    if (slash_pos != std::string::npos) {
+        address = rest.substr(0, slash_pos);
+        path = rest.substr(slash_pos);
     } else {
-        return {resp, gocxx::errors::New("invalid URL: must start with http://")};
+        address = rest;
+        path = "/";
     }
     
+    if (address.empty()) {
+        return false;
+    }
     // Add default port if not specified
     if (address.find(':') == std::string::npos) {
         address += ":80";
     }
-    
-    // Connect
-    auto conn_result = DialTCP("tcp", address);
-    if (conn_result.Failed()) {
-        return {resp, conn_result.err};
+    return true;
+}
+
+struct Transport::Pool {
+    struct Entry {
+        std::shared_ptr<TCPConn> conn;
+        std::shared_ptr<gocxx::bufio::Reader> reader;
+        std::chrono::steady_clock::time_point idle_since;
+    };
+
+    // Most recently used first, so the rest age out under light load
+    bool get(const std::string& key, std::chrono::nanoseconds timeout, Entry& out) {
+        std::vector<Entry> expired;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            auto it = idle.find(key);
+            if (it == idle.end()) {
+                return false;
+            }
+            auto& list = it->second;
+            const auto now = std::chrono::steady_clock::now();
+            while (!list.empty() && !found) {
+                Entry entry = std::move(list.back());
+                list.pop_back();
+                if (timeout.count() > 0 && now - entry.idle_since > timeout) {
+                    expired.push_back(std::move(entry));
+                } else {
+                    out = std::move(entry);
+                    found = true;
+                }
+            }
+            if (list.empty()) {
+                idle.erase(it);
+            }
+        }
+        for (auto& entry : expired) {
+            entry.conn->close();
+        }
+        return found;
     }
-    
-    auto conn = conn_result.value;
-    
-    // Send request
-    std::ostringstream request;
-    request << "GET " << path << " HTTP/1.1\r\n";
-    request << "Host: " << address << "\r\n";
-    request << "Connection: close\r\n";
-    request << "\r\n";
-    
-    std::string request_str = request.str();
-    auto write_result = conn->Write(
-        reinterpret_cast<const uint8_t*>(request_str.data()),
-        request_str.size());
-    
-    if (write_result.Failed()) {
-        return {resp, write_result.err};
+
+    void put(const std::string& key, Entry entry, std::size_t max_idle) {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            auto& list = idle[key];
+            if (list.size() < max_idle) {
+                entry.idle_since = std::chrono::steady_clock::now();
+                list.push_back(std::move(entry));
+                return;
+            }
+        }
+        entry.conn->close();
     }
-    
-    // Read response
-    const size_t BUFFER_SIZE = 4096;
-    uint8_t buffer[BUFFER_SIZE];
-    std::string raw_response;
-    
-    while (true) {
-        auto read_result = conn->Read(buffer, BUFFER_SIZE);
-        if (read_result.Failed() || read_result.value == 0) {
-            break;
+
+    void closeAll() {
+        std::unordered_map<std::string, std::vector<Entry>> all;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            all.swap(idle);
+        }
+        for (auto& [key, list] : all) {
+            for (auto& entry : list) {
+                entry.conn->close();
+            }
         }
-        
-        raw_response.append(reinterpret_cast<char*>(buffer), read_result.value);
     }
-    
-    conn->close();
-    
-    // Parse response
-    std::istringstream stream(raw_response);
-    std::string line;
-    
-    // Parse status line
-    if (!std::getline(stream, line)) {
-        return {resp, gocxx::errors::New("invalid response: no status line")};
+
+    std::mutex mu;
+    std::unordered_map<std::string, std::vector<Entry>> idle;
+};
+
+// Response body read straight off the connection. Once it has been read to
+// its end the connection goes back to the pool; closed early, or failed,
+// the connection is closed instead.
+class ClientBody : public gocxx::io::ReadCloser {
+public:
+    enum class Framing { Length, Chunked, UntilClose };
+
+    ClientBody(std::shared_ptr<Transport::Pool> pool, std::string key, std::size_t max_idle,
+               Transport::Pool::Entry entry, Framing framing, std::size_t length, bool reusable,
+               std::function<bool()> stop_watching, context::ContextPtr ctx)
+        : pool_(std::move(pool)), key_(std::move(key)), max_idle_(max_idle), entry_(std::move(entry)),
+          framing_(framing), remaining_(length), reusable_(reusable),
+          stop_watching_(std::move(stop_watching)), ctx_(std::move(ctx)) {
+        if (framing_ == Framing::Length && remaining_ == 0) {
+            finish();
+        }
     }
-    
-    if (!line.empty() && line.back() == '\r') {
-        line.pop_back();
+
+    ~ClientBody() override {
+        close();
     }
-    
-    std::istringstream status_line(line);
-    status_line >> resp.proto >> resp.status_code;
-    std::getline(status_line, resp.status);
-    resp.status = trim(resp.status);
-    
-    // Parse headers
-    while (std::getline(stream, line)) {
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+
+    gocxx::base::Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override {
+        if (done_) {
+            return {0, gocxx::io::ErrEOF};
+        }
+        if (err_) {
+            return {0, err_};
+        }
+        if (size == 0) {
+            return {0, nullptr};
+        }
+        
+        if (framing_ == Framing::UntilClose) {
+            auto res = entry_.reader->Read(buffer, size);
+            if (res.Failed()) {
+                if (gocxx::errors::Is(res.err, gocxx::io::ErrEOF) || gocxx::errors::Is(res.err, ErrClosed)) {
+                    if (ctx_ && ctx_->Err().Failed()) {
+                        fail(ctx_->Err().err);
+                        return {res.value, err_};
+                    }
+                    finish();
+                    return {res.value, gocxx::io::ErrEOF};
+                }
+                fail(res.err);
+                return {res.value, err_};
+            }
+            return {res.value, nullptr};
         }
         
-        if (line.empty()) {
-            break;  // End of headers
+        if (framing_ == Framing::Chunked && remaining_ == 0) {
+            if (auto err = nextChunk()) {
+                fail(err);
+                return {0, err_};
+            }
+            if (done_) {
+                return {0, gocxx::io::ErrEOF};
+            }
         }
         
-        size_t colon_pos = line.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string key = toLower(trim(line.substr(0, colon_pos)));
-            std::string value = trim(line.substr(colon_pos + 1));
-            resp.header[key] = value;
+        auto res = entry_.reader->Read(buffer, std::min(size, remaining_));
+        remaining_ -= res.value;
+        if (res.value == 0) {
+            fail(res.err && !gocxx::errors::Is(res.err, gocxx::io::ErrEOF) && !gocxx::errors::Is(res.err, ErrClosed)
+                     ? res.err : gocxx::io::ErrUnexpectedEOF);
+            return {0, err_};
         }
+        if (remaining_ == 0) {
+            if (framing_ == Framing::Length) {
+                finish();
+            } else if (auto err = endChunk()) {
+                fail(err);
+                return {res.value, err_};
+            }
+        }
+        return {res.value, nullptr};
     }
-    
-    // Parse body
-    std::ostringstream body_stream;
-    body_stream << stream.rdbuf();
-    resp.body = body_stream.str();
-    
-    return {resp, nullptr};
-}
 
-gocxx::base::Result<Response> Post(
-    const std::string& url,
-    const std::string& content_type,
-    const std::string& body) {
-    
-    Response resp;
-    
-    // Parse URL
-    std::string address;
-    std::string path = "/";
-    
-    if (url.find("http://") == 0) {
-        std::string rest = url.substr(7);
-        size_t slash_pos = rest.find('/');
-        
-        if (slash_pos != std::string::npos) {
-            address = rest.substr(0, slash_pos);
-            path = rest.substr(slash_pos);
+    void close() override {
+        if (done_ || closed_) {
+            return;
+        }
+        closed_ = true;
+        if (stop_watching_) {
+            stop_watching_();
+        }
+        entry_.conn->close();
+    }
+
+private:
+    // Reads the next chunk-size line; at the last chunk also the trailers
+    std::shared_ptr<gocxx::errors::Error> nextChunk() {
+        std::size_t budget = 1 << 20;
+        auto line = readHeaderLine(*entry_.reader, budget);
+        if (line.Failed()) {
+            return line.err;
+        }
+        std::size_t chunk_size = 0;
+        std::size_t digits = 0;
+        for (char c : line.value) {
+            if (c == ';' || c == ' ' || c == '\t') break;
+            int v = std::isdigit(static_cast<unsigned char>(c)) ? c - '0'
+                  : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                  : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+            if (v < 0 || ++digits > 15) {
+                return gocxx::errors::New("http: malformed chunk size");
+            }
+            chunk_size = chunk_size * 16 + static_cast<std::size_t>(v);
+        }
+        if (digits == 0) {
+            return gocxx::errors::New("http: malformed chunk size");
+        }
+        if (chunk_size > 0) {
+            remaining_ = chunk_size;
+            return nullptr;
+        }
+        while (true) {
+            auto trailer = readHeaderLine(*entry_.reader, budget);
+            if (trailer.Failed()) {
+                return trailer.err;
+            }
+            if (trailer.value.empty()) {
+                break;
+            }
+        }
+        finish();
+        return nullptr;
+    }
+
+    // The CRLF after a chunk's data
+    std::shared_ptr<gocxx::errors::Error> endChunk() {
+        std::size_t budget = 2;
+        auto crlf = readHeaderLine(*entry_.reader, budget);
+        if (crlf.Failed()) {
+            return crlf.err;
+        }
+        return crlf.value.empty() ? nullptr : gocxx::errors::New("http: malformed chunked body");
+    }
+
+    void finish() {
+        done_ = true;
+        // A watcher that already fired may be closing the connection
+        const bool unwatched = !stop_watching_ || stop_watching_();
+        if (reusable_ && unwatched) {
+            pool_->put(key_, std::move(entry_), max_idle_);
         } else {
-            address = rest;
+            entry_.conn->close();
         }
-    } else {
-        return {resp, gocxx::errors::New("invalid URL: must start with http://")};
     }
-    
-    if (address.find(':') == std::string::npos) {
-        address += ":80";
+
+    void fail(std::shared_ptr<gocxx::errors::Error> err) {
+        err_ = ctx_ && ctx_->Err().Failed() ? ctx_->Err().err : std::move(err);
+        close();
     }
-    
-    // Connect
-    auto conn_result = DialTCP("tcp", address);
-    if (conn_result.Failed()) {
-        return {resp, conn_result.err};
+
+    std::shared_ptr<Transport::Pool> pool_;
+    std::string key_;
+    std::size_t max_idle_;
+    Transport::Pool::Entry entry_;
+    Framing framing_;
+    std::size_t remaining_;  // Length: body bytes left; Chunked: bytes left in this chunk
+    bool reusable_;
+    std::function<bool()> stop_watching_;
+    context::ContextPtr ctx_;
+    bool done_ = false;
+    bool closed_ = false;
+    std::shared_ptr<gocxx::errors::Error> err_;
+};
+
+// Transport implementation
+Transport::Transport() : pool_(std::make_shared<Pool>()), h2_pool_(detail::NewH2Pool()) {}
+
+Transport::~Transport() {
+    CloseIdleConnections();
+}
+
+void Transport::CloseIdleConnections() {
+    pool_->closeAll();
+    detail::CloseIdleH2(*h2_pool_);
+}
+
+// Sends req on entry's connection and reads the response headers.
+// nothing_read is set when the connection turned out to be dead before
+// any of the response arrived, so the request may be replayed.
+static gocxx::base::Result<Response> exchange(Transport& transport, const std::shared_ptr<Transport::Pool>& pool,
+                                              context::ContextPtr ctx, const Request& req,
+                                              const std::string& address, const std::string& path,
+                                              Transport::Pool::Entry entry, bool& nothing_read) {
+    Response resp;
+    nothing_read = false;
+    auto conn = entry.conn;
+    
+    std::function<bool()> stop_watching;
+    if (ctx) {
+        std::weak_ptr<TCPConn> watched = conn;
+        stop_watching = context::AfterCancel(ctx, [watched] {
+            if (auto c = watched.lock()) {
+                c->close();
+            }
+        });
     }
+    auto fail = [&](std::shared_ptr<gocxx::errors::Error> err) -> gocxx::base::Result<Response> {
+        if (stop_watching) {
+            stop_watching();
+        }
+        conn->close();
+        if (ctx && ctx->Err().Failed()) {
+            return {resp, ctx->Err().err};
+        }
+        return {resp, err};
+    };
     
-    auto conn = conn_result.value;
-    
-    // Send request
+    // Send request: header and body in one vectored write
+    const std::string method = req.method.empty() ? "GET" : req.method;
     std::ostringstream request;
-    request << "POST " << path << " HTTP/1.1\r\n";
-    request << "Host: " << address << "\r\n";
-    request << "Content-Type: " << content_type << "\r\n";
-    request << "Content-Length: " << body.length() << "\r\n";
-    request << "Connection: close\r\n";
+    request << method << " " << path << " HTTP/1.1\r\n";
+    if (!findHeader(req.header, "host")) {
+        request << "Host: " << address << "\r\n";
+    }
+    for (const auto& [key, value] : req.header) {
+        request << key << ": " << value << "\r\n";
+    }
+    if (!findHeader(req.header, "content-length") && !findHeader(req.header, "transfer-encoding") &&
+        (!req.body.empty() || method == "POST" || method == "PUT" || method == "PATCH")) {
+        request << "Content-Length: " << req.body.size() << "\r\n";
+    }
     request << "\r\n";
-    request << body;
     
     std::string request_str = request.str();
-    auto write_result = conn->Write(
-        reinterpret_cast<const uint8_t*>(request_str.data()),
-        request_str.size());
-    
+    auto write_result = conn->WriteBuffers({ gocxx::io::Span(request_str), gocxx::io::Span(req.body) });
     if (write_result.Failed()) {
-        return {resp, write_result.err};
+        nothing_read = true;
+        return fail(write_result.err);
     }
     
-    // Read response (same as GET)
-    const size_t BUFFER_SIZE = 4096;
-    uint8_t buffer[BUFFER_SIZE];
-    std::string raw_response;
+    if (transport.response_header_timeout.count() > 0) {
+        conn->SetReadDeadline(std::chrono::system_clock::now() +
+                              std::chrono::duration_cast<std::chrono::system_clock::duration>(transport.response_header_timeout));
+    }
     
-    while (true) {
-        auto read_result = conn->Read(buffer, BUFFER_SIZE);
-        if (read_result.Failed() || read_result.value == 0) {
-            break;
+    // Parse status line, skipping interim 1xx responses
+    std::size_t budget = 1 << 20;
+    bool first = true;
+    do {
+        auto line = readHeaderLine(*entry.reader, budget);
+        if (line.Failed()) {
+            nothing_read = first && line.value.empty() &&
+                           (gocxx::errors::Is(line.err, gocxx::io::ErrEOF) || gocxx::errors::Is(line.err, ErrClosed));
+            return fail(line.err);
+        }
+        first = false;
+        
+        std::istringstream status_line(line.value);
+        status_line >> resp.proto >> resp.status_code;
+        std::getline(status_line, resp.status);
+        resp.status = trim(resp.status);
+        if (resp.proto.compare(0, 5, "HTTP/") != 0 || resp.status_code < 100 || resp.status_code > 999) {
+            return fail(gocxx::errors::New("http: malformed status line: " + line.value));
         }
         
-        raw_response.append(reinterpret_cast<char*>(buffer), read_result.value);
+        // Parse headers
+        resp.header.clear();
+        while (true) {
+            auto header_line = readHeaderLine(*entry.reader, budget);
+            if (header_line.Failed()) {
+                return fail(header_line.err);
+            }
+            if (header_line.value.empty()) {
+                break;  // End of headers
+            }
+            size_t colon_pos = header_line.value.find(':');
+            if (colon_pos != std::string::npos) {
+                std::string key = toLower(trim(header_line.value.substr(0, colon_pos)));
+                std::string value = trim(header_line.value.substr(colon_pos + 1));
+                auto it = resp.header.find(key);
+                if (it == resp.header.end()) {
+                    resp.header[key] = value;
+                } else {
+                    it->second += ", " + value;
+                }
+            }
+        }
+    } while (resp.status_code >= 100 && resp.status_code < 200 && resp.status_code != 101);
+    
+    if (transport.response_header_timeout.count() > 0) {
+        conn->SetReadDeadline(std::chrono::system_clock::time_point{});
     }
     
-    conn->close();
+    // Body framing (RFC 9112 section 6.3)
+    ClientBody::Framing framing = ClientBody::Framing::Length;
+    std::size_t length = 0;
+    if (method == "HEAD" || resp.status_code < 200 || resp.status_code == 204 || resp.status_code == 304) {
+        // No body
+    } else if (!resp.Header("transfer-encoding").empty()) {
+        if (toLower(resp.Header("transfer-encoding")) != "chunked") {
+            return fail(gocxx::errors::New("http: unsupported transfer encoding: " + resp.Header("transfer-encoding")));
+        }
+        framing = ClientBody::Framing::Chunked;
+    } else if (resp.header.count("content-length")) {
+        const std::string& value = resp.header["content-length"];
+        if (value.empty() || value.size() > 18 ||
+            !std::all_of(value.begin(), value.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+            return fail(gocxx::errors::New("http: bad content-length: " + value));
+        }
+        length = static_cast<std::size_t>(std::stoull(value));
+    } else {
+        framing = ClientBody::Framing::UntilClose;
+    }
     
-    // Parse response (same logic as GET)
-    std::istringstream stream(raw_response);
-    std::string line;
+    const std::string connection = resp.Header("connection");
+    bool reusable = framing != ClientBody::Framing::UntilClose && transport.max_idle_conns_per_host > 0 &&
+                    !hasToken(connection, "close") &&
+                    !(findHeader(req.header, "connection") && hasToken(*findHeader(req.header, "connection"), "close")) &&
+                    resp.status_code != 101 &&
+                    (resp.proto != "HTTP/1.0" || hasToken(connection, "keep-alive"));
     
-    if (!std::getline(stream, line)) {
-        return {resp, gocxx::errors::New("invalid response: no status line")};
+    resp.body_stream = std::make_shared<ClientBody>(pool, address, transport.max_idle_conns_per_host,
+                                                    std::move(entry), framing, length, reusable,
+                                                    std::move(stop_watching), ctx);
+    return {resp, nullptr};
+}
+
+gocxx::base::Result<Response> Transport::RoundTrip(context::ContextPtr ctx, const Request& req) {
+    std::string address;
+    std::string path;
+    if (!parseURL(req.url, address, path)) {
+        return {Response(), gocxx::errors::New("invalid URL: must start with http://")};
     }
-    
-    if (!line.empty() && line.back() == '\r') {
-        line.pop_back();
+    if (ctx && ctx->Err().Failed()) {
+        return {Response(), ctx->Err().err};
+    }
+    if (h2c) {
+        return detail::RoundTripH2(*this, h2_pool_, ctx, req, address, path);
     }
     
-    std::istringstream status_line(line);
-    status_line >> resp.proto >> resp.status_code;
-    std::getline(status_line, resp.status);
-    resp.status = trim(resp.status);
+    // Safe to send twice: the server may have seen the first copy
+    const bool replayable = req.method.empty() || req.method == "GET" || req.method == "HEAD" ||
+                            req.method == "OPTIONS" || req.method == "TRACE" ||
+                            findHeader(req.header, "idempotency-key") != nullptr;
     
-    while (std::getline(stream, line)) {
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+    while (true) {
+        Pool::Entry entry;
+        const bool reused = pool_->get(address, idle_conn_timeout, entry);
+        if (!reused) {
+            Dialer dialer;
+            dialer.timeout = dial_timeout;
+            auto conn_result = dialer.DialContext(ctx, "tcp", address);
+            if (conn_result.Failed()) {
+                return {Response(), conn_result.err};
+            }
+            entry.conn = conn_result.value;
+            entry.reader = std::make_shared<gocxx::bufio::Reader>(entry.conn);
         }
         
-        if (line.empty()) {
-            break;
+        bool nothing_read = false;
+        auto result = exchange(*this, pool_, ctx, req, address, path, std::move(entry), nothing_read);
+        // A pooled connection the server closed while it sat idle
+        if (result.Failed() && reused && nothing_read && replayable && !(ctx && ctx->Err().Failed())) {
+            continue;
         }
-        
-        size_t colon_pos = line.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string key = toLower(trim(line.substr(0, colon_pos)));
-            std::string value = trim(line.substr(colon_pos + 1));
-            resp.header[key] = value;
+        return result;
+    }
+}
+
+std::shared_ptr<Transport> DefaultTransport() {
+    static auto transport = std::make_shared<Transport>();
+    return transport;
+}
+
+// Client implementation
+gocxx::base::Result<Response> Client::Do(context::ContextPtr ctx, const Request& req) {
+    auto t = transport ? transport : DefaultTransport();
+    return t->RoundTrip(std::move(ctx), req);
+}
+
+// Reads the whole streamed body into resp.body
+static gocxx::base::Result<Response> readAllBody(gocxx::base::Result<Response> result) {
+    if (result.Failed() || !result.value.body_stream) {
+        return result;
+    }
+    Response& resp = result.value;
+    auto body = std::move(resp.body_stream);
+    const size_t BUFFER_SIZE = 4096;
+    uint8_t buffer[BUFFER_SIZE];
+    while (true) {
+        auto read_result = body->Read(buffer, BUFFER_SIZE);
+        resp.body.append(reinterpret_cast<char*>(buffer), read_result.value);
+        if (read_result.Failed()) {
+            if (!gocxx::errors::Is(read_result.err, gocxx::io::ErrEOF)) {
+                return {resp, read_result.err};
+            }
+            break;
         }
     }
-    
-    std::ostringstream body_stream;
-    body_stream << stream.rdbuf();
-    resp.body = body_stream.str();
-    
     return {resp, nullptr};
 }
 
+gocxx::base::Result<Response> Client::Get(const std::string& url) {
+    Request req;
+    req.method = "GET";
+    req.url = url;
+    return readAllBody(Do(nullptr, req));
+}
+
+gocxx::base::Result<Response> Client::Post(
+    const std::string& url,
+    const std::string& content_type,
+    const std::string& body) {
+    Request req;
+    req.method = "POST";
+    req.url = url;
+    req.header["Content-Type"] = content_type;
+    req.body = body;
+    return readAllBody(Do(nullptr, req));
+}
+
+gocxx::base::Result<Response> Get(const std::string& url) {
+    return Client{}.Get(url);
+}
+
+gocxx::base::Result<Response> Post(
+    const std::string& url,
+    const std::string& content_type,
+    const std::string& body) {
+    return Client{}.Post(url, content_type, body);
+}
+
 } // namespace gocxx::net::http
@@ -0,0 +1,1774 @@
+// HTTP/2 for http::Server and http::Transport (RFC 9113), over cleartext
+// connections with prior knowledge ("h2c"): the client opens with the
+// connection preface instead of an HTTP/1.1 request.
+//
+// Server: the connection's task reads frames and dispatches each complete
+// request to a task of its own; one writer task owns the encoder and sends
+// everything, control frames first, then DATA from the ready streams in
+// weighted fair order (a stream's virtual time advances by bytes / weight).
+//
+// Client: per-host connections carrying many streams each, with a reader
+// task per connection; requests serialize only while writing their frames.
+
+#include <gocxx/net/http.h>
+#include <gocxx/net/http2.h>
+#include <gocxx/net/hpack.h>
+#include <gocxx/net/http_metrics.h>
+#include <gocxx/net/detail/http_internal.h>
+#include <gocxx/arena/arena.h>
+#include <gocxx/base/defer.h>
+#include <gocxx/bufio/bufio.h>
+#include <gocxx/io/io_errors.h>
+#include <gocxx/runtime/runtime.h>
+#include <gocxx/sync/waitgroup.h>
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+
+namespace gocxx::net::http {
+
+namespace h2 = gocxx::net::http2;
+
+namespace {
+
+constexpr std::int64_t kServerStreamWindow = 1 << 20;  // advertised per stream; a body is buffered whole, up to max_body_bytes
+constexpr std::int64_t kServerConnWindow = 1 << 20;
+constexpr std::int64_t kClientStreamWindow = 1 << 20;
+constexpr std::int64_t kClientConnWindow = 4 << 20;
+constexpr std::size_t kStreamQueueLimit = 64 * 1024;  // response bytes queued per stream before Write blocks
+constexpr std::size_t kWriteBatch = 64 * 1024;        // frames the writer buffers before it flushes
+constexpr std::uint32_t kAssumedMaxStreams = 100;     // a server's limit until its SETTINGS arrive
+constexpr std::uint32_t kClientMaxHeaderList = 1 << 20;
+constexpr int kMaxAttempts = 3;                       // a request bounced by GOAWAY or REFUSED_STREAM
+constexpr std::size_t kMaxPrematureResets = 100;      // streams reset or refused before GOAWAY(ENHANCE_YOUR_CALM)
+
+// A request the server never processed, so it may go again on another connection
+std::shared_ptr<gocxx::errors::Error> errUnprocessed =
+    gocxx::errors::New("http2: request not processed by the server (connection going away or stream refused)");
+std::shared_ptr<gocxx::errors::Error> errStreamClosed = gocxx::errors::New("http2: stream closed");
+std::shared_ptr<gocxx::errors::Error> errConnClosed = gocxx::errors::New("http2: client connection closed");
+std::shared_ptr<gocxx::errors::Error> errBodyClosed = gocxx::errors::New("http2: response body closed");
+
+std::shared_ptr<gocxx::errors::Error> connError(h2::ErrCode code, std::string reason) {
+    return std::make_shared<h2::ConnectionError>(code, std::move(reason));
+}
+
+std::shared_ptr<gocxx::errors::Error> streamError(std::uint32_t id, h2::ErrCode code) {
+    return std::make_shared<h2::StreamError>(id, code);
+}
+
+// Hop-by-hop fields, which HTTP/2 forbids (RFC 9113 section 8.2.2)
+bool connectionSpecific(std::string_view name) {
+    return name == "connection" || name == "keep-alive" || name == "proxy-connection" ||
+           name == "transfer-encoding" || name == "upgrade";
+}
+
+std::string lowerName(std::string_view s) {
+    std::string out(s);
+    for (char& c : out) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+bool hasUpper(std::string_view s) {
+    return std::any_of(s.begin(), s.end(), [](char c) { return c >= 'A' && c <= 'Z'; });
+}
+
+// A stream's share of the bandwidth: virtual time per byte sent
+std::uint64_t vcost(std::size_t n, std::uint8_t weight) {
+    return (static_cast<std::uint64_t>(n) + 1) * 256 / (static_cast<std::uint64_t>(weight) + 1);
+}
+
+std::chrono::system_clock::time_point deadlineAfter(std::chrono::nanoseconds d) {
+    return std::chrono::system_clock::now() + std::chrono::duration_cast<std::chrono::system_clock::duration>(d);
+}
+
+} // namespace
+
+// Server
+
+namespace detail {
+
+struct H2Stream {
+    explicit H2Stream(std::uint32_t id) : id(id), req(&arena) {}
+
+    const std::uint32_t id;
+    gocxx::arena::Arena arena;  // the request's headers and the handler's scratch memory
+    Request req;
+    bool too_large = false;     // header list over max_header_bytes: answered with 431
+    bool body_too_large = false;  // body over max_body_bytes: answered with 413, then reset
+
+    // Receiving; the reader only
+    bool remote_closed = false;
+    std::int64_t recv_window = kServerStreamWindow;
+    std::int64_t unacked = 0;
+
+    // Sending; under H2ServerConn::mu_
+    h2::PriorityParam priority;
+    std::int64_t send_window = 0;
+    bool headers_written = false;
+    std::string out;            // response body not yet framed, from out_off
+    std::size_t out_off = 0;
+    bool end_queued = false;    // the handler is done; END_STREAM follows out
+    bool done = false;          // END_STREAM sent, or the stream was reset
+    std::uint64_t vtime = 0;
+
+    std::size_t pending() const { return out.size() - out_off; }
+};
+
+class H2ServerConn {
+public:
+    H2ServerConn(Server& srv, std::shared_ptr<TCPConn> conn, gocxx::bufio::Reader& reader)
+        : srv_(srv), conn_(std::move(conn)), framer_(reader, *conn_) {}
+
+    void serve();
+
+    // For the response writer: queue a stream's HEADERS, or body bytes
+    // (blocking while too much of it is queued)
+    std::shared_ptr<gocxx::errors::Error> sendHeaders(const std::shared_ptr<H2Stream>& st,
+                                                      std::vector<hpack::HeaderField> fields, bool end);
+    std::shared_ptr<gocxx::errors::Error> sendData(const std::shared_ptr<H2Stream>& st, std::string_view data,
+                                                   bool end);
+
+private:
+    using Write = std::function<void(h2::Framer&)>;
+
+    std::shared_ptr<gocxx::errors::Error> process(h2::Frame& f);
+    std::shared_ptr<gocxx::errors::Error> onHeaders(h2::Frame& f);
+    std::shared_ptr<gocxx::errors::Error> onData(h2::Frame& f);
+    std::shared_ptr<gocxx::errors::Error> onSettings(const h2::Frame& f);
+    std::shared_ptr<gocxx::errors::Error> onWindowUpdate(const h2::Frame& f);
+    std::shared_ptr<gocxx::errors::Error> buildRequest(H2Stream& st, std::vector<hpack::HeaderField>& fields);
+    void dispatch(const std::shared_ptr<H2Stream>& st);
+    void runHandler(const std::shared_ptr<H2Stream>& st);
+    void writeLoop();
+    bool writeDataLocked();
+    void queueLocked(Write w);
+    void resetLocked(std::uint32_t id);
+    void goAwayLocked(h2::ErrCode code);
+    bool tooManyResetsLocked();
+    void setIdleDeadlineLocked();
+
+    Server& srv_;
+    std::shared_ptr<TCPConn> conn_;
+    std::string remote_addr_;
+    h2::Framer framer_;
+    hpack::Decoder decoder_;  // the reader only
+    hpack::Encoder encoder_;  // the writer only
+
+    std::mutex mu_;
+    std::condition_variable work_;   // the writer: frames to send
+    std::condition_variable space_;  // handlers: room in their stream's queue
+    std::deque<Write> control_;
+    std::unordered_map<std::uint32_t, std::shared_ptr<H2Stream>> streams_;
+    std::uint32_t last_stream_ = 0;  // highest stream the client opened
+    std::size_t active_ = 0;         // handlers running
+    std::size_t served_ = 0;
+    std::size_t premature_resets_ = 0;  // streams the client reset before their answer, or had refused
+    std::int64_t send_window_ = h2::kDefaultWindowSize;
+    std::int64_t peer_initial_window_ = h2::kDefaultWindowSize;
+    std::uint64_t vclock_ = 0;       // virtual time of the last DATA frame sent
+    bool going_away_ = false;        // GOAWAY sent: no new streams
+    bool drain_ = false;             // close once the streams in flight are answered
+    bool closed_ = false;            // nothing more is read; send what is queued and stop
+    bool idle_deadline_ = false;
+
+    // The reader only
+    std::int64_t recv_window_ = kServerConnWindow;
+    std::int64_t recv_unacked_ = 0;
+
+    gocxx::sync::WaitGroup tasks_;   // the writer and the handlers
+};
+
+namespace {
+
+// ResponseWriter for one stream. Like the HTTP/1 writer it holds back the
+// first 4KB so a short response carries a content-length; after the
+// header, writes go straight to the stream's queue, where the connection's
+// writer cuts them into DATA frames.
+class H2ResponseWriter : public ResponseWriter, public Flusher {
+public:
+    static constexpr std::size_t kBufferSize = 4096;
+
+    H2ResponseWriter(H2ServerConn& conn, std::shared_ptr<H2Stream> st)
+        : conn_(conn), st_(std::move(st)), head_request_(st_->req.method == "HEAD"),
+          buffer_(&st_->arena), headers_(&st_->arena) {}
+
+    HeaderMap& Header() override { return headers_; }
+
+    gocxx::base::Result<std::size_t> Write(const std::string& data) override {
+        if (head_request_ || !BodyAllowed(status_code_)) {
+            return {data.size(), nullptr};
+        }
+        if (!headers_written_ && buffer_.size() + data.size() <= kBufferSize) {
+            buffer_ += data;
+            return {data.size(), nullptr};
+        }
+        if (auto err = flush()) {
+            return {0, err};
+        }
+        if (auto err = conn_.sendData(st_, data, false)) {
+            return {0, err};
+        }
+        body_sent_ += data.size();
+        return {data.size(), nullptr};
+    }
+
+    void WriteHeader(int statusCode) override {
+        if (headers_written_ || status_set_) {
+            return;
+        }
+        status_code_ = statusCode;
+        status_set_ = true;
+    }
+
+    void Flush() override { flush(); }
+
+    // Ends the stream: the header (with the buffered body's length, when the
+    // handler set none) and whatever is buffered
+    void finish() {
+        const bool body = BodyAllowed(status_code_) && !head_request_;
+        if (!headers_written_) {
+            const bool empty = !body || buffer_.empty();
+            conn_.sendHeaders(st_, fields(body), empty);
+            if (!empty) {
+                body_sent_ += buffer_.size();
+                conn_.sendData(st_, buffer_, true);
+            }
+            return;
+        }
+        body_sent_ += buffer_.size();
+        conn_.sendData(st_, buffer_, true);
+        buffer_.clear();
+    }
+
+    int StatusCode() const { return status_code_; }
+    std::size_t BodyBytes() const { return body_sent_; }
+
+private:
+    std::shared_ptr<gocxx::errors::Error> flush() {
+        if (!headers_written_) {
+            if (auto err = conn_.sendHeaders(st_, fields(false), false)) {
+                return err;
+            }
+        }
+        if (buffer_.empty()) {
+            return nullptr;
+        }
+        body_sent_ += buffer_.size();
+        auto err = conn_.sendData(st_, buffer_, false);
+        buffer_.clear();
+        return err;
+    }
+
+    // complete: the whole body is in buffer_, so its length is known
+    std::vector<hpack::HeaderField> fields(bool complete) {
+        headers_written_ = true;
+        std::vector<hpack::HeaderField> out;
+        out.reserve(headers_.size() + 3);
+        out.push_back({":status", std::to_string(status_code_)});
+        bool has_date = false;
+        bool has_length = false;
+        for (const auto& [key, value] : headers_) {
+            std::string name = lowerName(key);
+            if (connectionSpecific(name)) {
+                continue;
+            }
+            has_date = has_date || name == "date";
+            has_length = has_length || name == "content-length";
+            out.push_back({std::move(name), value});
+        }
+        if (!has_date) {
+            std::string_view date = DateHeader();  // "date: ...\r\n"
+            out.push_back({"date", std::string(date.substr(6, date.size() - 8))});
+        }
+        if (complete && !has_length) {
+            out.push_back({"content-length", std::to_string(buffer_.size())});
+        }
+        return out;
+    }
+
+    H2ServerConn& conn_;
+    std::shared_ptr<H2Stream> st_;
+    int status_code_ = 200;
+    bool status_set_ = false;
+    bool headers_written_ = false;
+    bool head_request_;
+    std::size_t body_sent_ = 0;
+    std::pmr::string buffer_;
+    HeaderMap headers_;
+};
+
+} // namespace
+
+void H2ServerConn::serve() {
+    remote_addr_ = conn_->RemoteAddr()->String();
+    framer_.SetMaxHeaderBlockSize(srv_.max_header_bytes);
+    decoder_.SetMaxHeaderListSize(static_cast<std::uint32_t>(
+        std::min<std::size_t>(srv_.max_header_bytes, std::numeric_limits<std::uint32_t>::max())));
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        const std::uint32_t max_streams = srv_.h2_max_concurrent_streams;
+        const auto max_list = static_cast<std::uint32_t>(
+            std::min<std::size_t>(srv_.max_header_bytes, std::numeric_limits<std::uint32_t>::max()));
+        queueLocked([max_streams, max_list](h2::Framer& f) {
+            f.WriteSettings({{h2::SettingID::MaxConcurrentStreams, max_streams},
+                             {h2::SettingID::InitialWindowSize, static_cast<std::uint32_t>(kServerStreamWindow)},
+                             {h2::SettingID::MaxHeaderListSize, max_list}});
+            f.WriteWindowUpdate(0, static_cast<std::uint32_t>(kServerConnWindow - h2::kDefaultWindowSize));
+        });
+        setIdleDeadlineLocked();
+    }
+    tasks_.Add(1);
+    gocxx::go([this] {
+        writeLoop();
+        tasks_.Done();
+    });
+
+    bool first = true;
+    while (true) {
+        auto frame = framer_.ReadFrame();
+        std::shared_ptr<gocxx::errors::Error> err = frame.err;
+        if (!err) {
+            if (first && frame.value.header.type != h2::FrameType::Settings) {
+                err = connError(h2::ErrCode::Protocol, "first frame is not SETTINGS");
+            } else {
+                err = process(frame.value);
+            }
+            first = false;
+        }
+        if (!err) {
+            continue;
+        }
+        std::shared_ptr<h2::StreamError> se;
+        if (gocxx::errors::As(err, se)) {
+            std::lock_guard<std::mutex> lock(mu_);
+            const std::uint32_t id = se->StreamID();
+            const h2::ErrCode code = se->Code();
+            queueLocked([id, code](h2::Framer& f) { f.WriteRSTStream(id, code); });
+            resetLocked(id);
+            continue;
+        }
+        std::shared_ptr<h2::ConnectionError> ce;
+        if (gocxx::errors::As(err, ce)) {
+            std::lock_guard<std::mutex> lock(mu_);
+            goAwayLocked(ce->Code());
+        }
+        break;  // closed by the client, timed out, or broken
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        closed_ = true;
+        for (auto& [id, st] : streams_) {
+            st->done = true;
+        }
+        streams_.clear();
+        work_.notify_all();
+        space_.notify_all();
+    }
+    tasks_.Wait();
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ServerConn::process(h2::Frame& f) {
+    const std::uint32_t id = f.header.stream_id;
+    switch (f.header.type) {
+    case h2::FrameType::Data:
+        return onData(f);
+    case h2::FrameType::Headers:
+        return onHeaders(f);
+    case h2::FrameType::Priority: {
+        if (f.priority.stream_dep == id) {
+            return streamError(id, h2::ErrCode::Protocol);
+        }
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = streams_.find(id);
+        if (it != streams_.end()) {
+            it->second->priority = f.priority;
+        }
+        return nullptr;
+    }
+    case h2::FrameType::RSTStream: {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (id > last_stream_) {
+            return connError(h2::ErrCode::Protocol, "RST_STREAM on an idle stream");
+        }
+        const bool unanswered = streams_.count(id) != 0;
+        resetLocked(id);
+        if (unanswered && tooManyResetsLocked()) {
+            return connError(h2::ErrCode::EnhanceYourCalm, "too many streams reset");
+        }
+        return nullptr;
+    }
+    case h2::FrameType::Settings:
+        return f.header.Has(h2::FlagAck) ? nullptr : onSettings(f);
+    case h2::FrameType::PushPromise:
+        return connError(h2::ErrCode::Protocol, "PUSH_PROMISE from a client");
+    case h2::FrameType::Ping: {
+        if (f.header.Has(h2::FlagAck)) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mu_);
+        auto data = f.PingData();
+        queueLocked([data](h2::Framer& fr) { fr.WritePing(true, data); });
+        return nullptr;
+    }
+    case h2::FrameType::WindowUpdate:
+        return onWindowUpdate(f);
+    default:
+        return nullptr;  // GOAWAY from a client changes nothing here; unknown types are ignored
+    }
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ServerConn::onHeaders(h2::Frame& f) {
+    const std::uint32_t id = f.header.stream_id;
+    if ((id & 1) == 0) {
+        return connError(h2::ErrCode::Protocol, "client stream with an even id");
+    }
+    // Decoded even for a stream we refuse, to keep the table in step
+    auto decoded = decoder_.Decode(f.payload);
+    bool too_large = false;
+    if (decoded.Failed()) {
+        if (!gocxx::errors::Is(decoded.err, hpack::ErrStringLength)) {
+            return connError(h2::ErrCode::Compression, decoded.err->error());
+        }
+        too_large = true;
+    }
+
+    std::shared_ptr<H2Stream> st;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = streams_.find(id);
+        if (it != streams_.end()) {
+            st = it->second;
+        } else if (id <= last_stream_) {
+            return connError(h2::ErrCode::StreamClosed, "HEADERS on a closed stream");
+        } else {
+            last_stream_ = id;
+        }
+    }
+    if (st) {
+        // Trailers: they end the request, and are dropped
+        if (st->remote_closed) {
+            return streamError(id, h2::ErrCode::StreamClosed);
+        }
+        if (!f.header.Has(h2::FlagEndStream)) {
+            return streamError(id, h2::ErrCode::Protocol);
+        }
+        st->remote_closed = true;
+        dispatch(st);
+        return nullptr;
+    }
+    if (f.has_priority && f.priority.stream_dep == id) {
+        return streamError(id, h2::ErrCode::Protocol);
+    }
+
+    const bool shutting_down = srv_.shuttingDown();
+    st = std::make_shared<H2Stream>(id);
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (shutting_down) {
+            goAwayLocked(h2::ErrCode::NoError);
+        }
+        if (going_away_) {
+            return streamError(id, h2::ErrCode::RefusedStream);
+        }
+        // A reset stream leaves streams_ while its handler runs on, so the
+        // running handlers count as well: opening and resetting streams in a
+        // loop must not start handlers without limit
+        if (streams_.size() >= srv_.h2_max_concurrent_streams || active_ >= srv_.h2_max_concurrent_streams) {
+            if (tooManyResetsLocked()) {
+                return connError(h2::ErrCode::EnhanceYourCalm, "too many streams refused");
+            }
+            return streamError(id, h2::ErrCode::RefusedStream);
+        }
+    }
+    if (too_large) {
+        st->too_large = true;
+        st->req.method = "GET";
+    } else if (auto err = buildRequest(*st, decoded.value)) {
+        return err;
+    }
+    if (f.has_priority) {
+        st->priority = f.priority;
+    }
+    st->remote_closed = f.header.Has(h2::FlagEndStream);
+
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        st->send_window = peer_initial_window_;
+        st->vtime = vclock_;
+        streams_.emplace(id, st);
+        ++served_;
+        if (srv_.max_requests_per_conn > 0 && served_ >= srv_.max_requests_per_conn) {
+            goAwayLocked(h2::ErrCode::NoError);
+        }
+    }
+    if (st->remote_closed) {
+        dispatch(st);
+    }
+    return nullptr;
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ServerConn::buildRequest(H2Stream& st,
+                                                                 std::vector<hpack::HeaderField>& fields) {
+    Request& req = st.req;
+    req.proto = "HTTP/2.0";
+    req.remote_addr = remote_addr_;
+    std::string authority;
+    bool regular = false;
+    auto malformed = [&] { return streamError(st.id, h2::ErrCode::Protocol); };
+    for (auto& field : fields) {
+        if (!field.name.empty() && field.name[0] == ':') {
+            // Pseudo-headers come first, once each (RFC 9113 section 8.3)
+            std::string* target = field.name == ":method"      ? &req.method
+                                  : field.name == ":path"      ? &req.url
+                                  : field.name == ":authority" ? &authority
+                                  : nullptr;
+            if (regular || (!target && field.name != ":scheme") || (target && !target->empty())) {
+                return malformed();
+            }
+            if (target) {
+                *target = std::move(field.value);
+            }
+            continue;
+        }
+        regular = true;
+        if (hasUpper(field.name) || connectionSpecific(field.name) ||
+            (field.name == "te" && field.value != "trailers")) {
+            return malformed();
+        }
+        auto it = req.header.find(field.name);
+        if (it == req.header.end()) {
+            req.header.emplace(std::move(field.name), std::move(field.value));
+        } else {
+            it->second.append(field.name == "cookie" ? "; " : ", ").append(field.value);
+        }
+    }
+    if (req.method.empty() || (req.url.empty() && req.method != "CONNECT")) {
+        return malformed();
+    }
+    if (!authority.empty() && req.header.find("host") == req.header.end()) {
+        req.header.emplace("host", std::move(authority));
+    }
+    return nullptr;
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ServerConn::onData(h2::Frame& f) {
+    const std::uint32_t id = f.header.stream_id;
+    const std::int64_t len = f.header.length;  // padding included
+    recv_window_ -= len;
+    if (recv_window_ < 0) {
+        return connError(h2::ErrCode::FlowControl, "DATA beyond the connection window");
+    }
+    // The connection window is refilled as data arrives, even for a stream
+    // whose body is dropped; each stream's body is held to max_body_bytes
+    recv_unacked_ += len;
+    if (recv_unacked_ >= kServerConnWindow / 2) {
+        const auto inc = static_cast<std::uint32_t>(recv_unacked_);
+        recv_window_ += recv_unacked_;
+        recv_unacked_ = 0;
+        std::lock_guard<std::mutex> lock(mu_);
+        queueLocked([inc](h2::Framer& fr) { fr.WriteWindowUpdate(0, inc); });
+    }
+
+    std::shared_ptr<H2Stream> st;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = streams_.find(id);
+        if (it == streams_.end()) {
+            if (id > last_stream_) {
+                return connError(h2::ErrCode::Protocol, "DATA on an idle stream");
+            }
+            return streamError(id, h2::ErrCode::StreamClosed);
+        }
+        st = it->second;
+    }
+    if (st->body_too_large) {
+        return nullptr;  // being answered with 413; the rest of the body is dropped
+    }
+    if (st->remote_closed) {
+        return streamError(id, h2::ErrCode::StreamClosed);
+    }
+    st->recv_window -= len;
+    if (st->recv_window < 0) {
+        return streamError(id, h2::ErrCode::FlowControl);
+    }
+    const std::size_t limit = srv_.max_body_bytes;
+    if (limit > 0 && f.payload.size() > limit - std::min(limit, st->req.body.size())) {
+        // Answered now, and its window is no longer refilled
+        st->body_too_large = true;
+        st->req.body.clear();
+        st->req.body.shrink_to_fit();
+        dispatch(st);
+        return nullptr;
+    }
+    st->req.body.append(f.payload);
+    if (f.header.Has(h2::FlagEndStream)) {
+        st->remote_closed = true;
+        dispatch(st);
+        return nullptr;
+    }
+    st->unacked += len;
+    if (st->unacked >= kServerStreamWindow / 2) {
+        const auto inc = static_cast<std::uint32_t>(st->unacked);
+        st->recv_window += st->unacked;
+        st->unacked = 0;
+        std::lock_guard<std::mutex> lock(mu_);
+        queueLocked([id, inc](h2::Framer& fr) { fr.WriteWindowUpdate(id, inc); });
+    }
+    return nullptr;
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ServerConn::onSettings(const h2::Frame& f) {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (const auto& s : f.Settings()) {
+        switch (s.id) {
+        case h2::SettingID::HeaderTableSize: {
+            const std::uint32_t limit = s.value;
+            queueLocked([this, limit](h2::Framer&) { encoder_.SetMaxDynamicTableSizeLimit(limit); });
+            break;
+        }
+        case h2::SettingID::InitialWindowSize: {
+            const std::int64_t delta = static_cast<std::int64_t>(s.value) - peer_initial_window_;
+            for (auto& [id, st] : streams_) {
+                st->send_window += delta;
+                if (st->send_window > h2::kMaxWindowSize) {
+                    return connError(h2::ErrCode::FlowControl, "SETTINGS_INITIAL_WINDOW_SIZE overflows a window");
+                }
+            }
+            peer_initial_window_ = s.value;
+            break;
+        }
+        case h2::SettingID::MaxFrameSize:
+            framer_.SetMaxWriteFrameSize(s.value);
+            break;
+        default:
+            break;
+        }
+    }
+    queueLocked([](h2::Framer& fr) { fr.WriteSettingsAck(); });
+    return nullptr;
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ServerConn::onWindowUpdate(const h2::Frame& f) {
+    const std::uint32_t id = f.header.stream_id;
+    std::lock_guard<std::mutex> lock(mu_);
+    if (id == 0) {
+        send_window_ += f.WindowIncrement();
+        if (send_window_ > h2::kMaxWindowSize) {
+            return connError(h2::ErrCode::FlowControl, "connection window overflow");
+        }
+    } else if (auto it = streams_.find(id); it != streams_.end()) {
+        it->second->send_window += f.WindowIncrement();
+        if (it->second->send_window > h2::kMaxWindowSize) {
+            return streamError(id, h2::ErrCode::FlowControl);
+        }
+    }
+    work_.notify_one();
+    return nullptr;
+}
+
+void H2ServerConn::dispatch(const std::shared_ptr<H2Stream>& st) {
+    bool first = false;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        first = ++active_ == 1;
+        if (first && idle_deadline_) {
+            conn_->SetReadDeadline({});
+            idle_deadline_ = false;
+        }
+    }
+    if (first) {
+        srv_.setState(conn_, ConnState::Active);
+    }
+    tasks_.Add(1);
+    gocxx::go([this, st] {
+        runHandler(st);
+        tasks_.Done();
+    });
+}
+
+void H2ServerConn::runHandler(const std::shared_ptr<H2Stream>& st) {
+    H2ResponseWriter writer(*this, st);
+    std::chrono::steady_clock::time_point started;
+    if (srv_.metrics) {
+        srv_.metrics->RequestStarted();
+        started = std::chrono::steady_clock::now();
+    }
+    if (st->too_large) {
+        writer.WriteHeader(431);
+        writer.Write("431 Request Header Fields Too Large");
+    } else if (st->body_too_large) {
+        writer.WriteHeader(413);
+        writer.Write("413 Content Too Large");
+    } else if (srv_.handler) {
+        if (srv_.handler_slots_) {
+            srv_.handler_slots_->Acquire(nullptr);
+        }
+        defer([this] {
+            if (srv_.handler_slots_) {
+                srv_.handler_slots_->Release();
+            }
+        });
+        try {
+            srv_.handler->ServeHTTP(writer, st->req);
+        } catch (...) {
+            // A handler threw: like a panic in Go, it costs only its stream
+            std::lock_guard<std::mutex> lock(mu_);
+            if (!st->done) {
+                const std::uint32_t id = st->id;
+                queueLocked([id](h2::Framer& f) { f.WriteRSTStream(id, h2::ErrCode::Internal); });
+                resetLocked(id);
+            }
+        }
+    }
+    writer.finish();
+    if (srv_.metrics) {
+        srv_.metrics->RequestFinished(st->req.Pattern(), writer.StatusCode(), st->req.body.size(),
+                                      writer.BodyBytes(), std::chrono::steady_clock::now() - started);
+    }
+
+    bool idle;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        idle = --active_ == 0;
+    }
+    // Shutdown closes idle connections; this one says GOAWAY and closes once drained
+    const bool kept = !idle || srv_.setState(conn_, ConnState::Idle);
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!kept) {
+        goAwayLocked(h2::ErrCode::NoError);
+    }
+    if (active_ == 0) {
+        if (going_away_) {
+            drain_ = true;
+            work_.notify_one();
+        } else {
+            setIdleDeadlineLocked();
+        }
+    }
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ServerConn::sendHeaders(const std::shared_ptr<H2Stream>& st,
+                                                                std::vector<hpack::HeaderField> fields, bool end) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (st->done || closed_) {
+        return errStreamClosed;
+    }
+    if (end) {
+        st->end_queued = true;
+    }
+    queueLocked([this, st, fields = std::move(fields), end](h2::Framer& f) {
+        if (st->done) {
+            return;  // reset meanwhile; skipping the block leaves the encoder in step
+        }
+        std::string block;
+        for (const auto& field : fields) {
+            encoder_.Encode(block, field.name, field.value, field.sensitive);
+        }
+        f.WriteHeaders(st->id, end, block);
+        st->headers_written = true;
+        if (end) {
+            if (st->body_too_large) {
+                f.WriteRSTStream(st->id, h2::ErrCode::NoError);  // stop sending the body (RFC 9113 section 8.1)
+            }
+            st->done = true;
+            streams_.erase(st->id);
+        }
+    });
+    return nullptr;
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ServerConn::sendData(const std::shared_ptr<H2Stream>& st,
+                                                             std::string_view data, bool end) {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (!st->done && !closed_ && st->pending() >= kStreamQueueLimit) {
+        gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+        space_.wait(lock);
+    }
+    if (st->done || closed_) {
+        return errStreamClosed;
+    }
+    st->out.append(data);
+    st->end_queued = st->end_queued || end;
+    work_.notify_one();
+    return nullptr;
+}
+
+void H2ServerConn::queueLocked(Write w) {
+    control_.push_back(std::move(w));
+    work_.notify_one();
+}
+
+void H2ServerConn::resetLocked(std::uint32_t id) {
+    auto it = streams_.find(id);
+    if (it == streams_.end()) {
+        return;
+    }
+    it->second->done = true;
+    streams_.erase(it);
+    space_.notify_all();
+}
+
+void H2ServerConn::goAwayLocked(h2::ErrCode code) {
+    if (code != h2::ErrCode::NoError) {
+        closed_ = true;  // nothing more is served; the writer sends GOAWAY and closes
+    }
+    if (going_away_) {
+        return;
+    }
+    going_away_ = true;
+    const std::uint32_t last = last_stream_;
+    queueLocked([last, code](h2::Framer& f) { f.WriteGoAway(last, code); });
+    if (active_ == 0 && code == h2::ErrCode::NoError) {
+        drain_ = true;
+    }
+}
+
+// Counts one more premature reset; true once they are both many and most of
+// the streams, as when a client opens and cancels streams in a loop
+bool H2ServerConn::tooManyResetsLocked() {
+    ++premature_resets_;
+    return premature_resets_ >= kMaxPrematureResets && premature_resets_ > served_ / 2;
+}
+
+void H2ServerConn::setIdleDeadlineLocked() {
+    const auto wait = srv_.idle_timeout.count() > 0 ? srv_.idle_timeout : srv_.read_header_timeout;
+    if (wait.count() > 0) {
+        conn_->SetReadDeadline(deadlineAfter(wait));
+        idle_deadline_ = true;
+    }
+}
+
+// Picks the ready stream with the least virtual time, skipping those whose
+// parent is ready itself (RFC 7540 section 5.3), and frames one DATA from it
+bool H2ServerConn::writeDataLocked() {
+    auto ready = [this](const H2Stream& st) {
+        if (!st.headers_written || st.done) {
+            return false;
+        }
+        if (st.pending() == 0) {
+            return st.end_queued;
+        }
+        return st.send_window > 0 && send_window_ > 0;
+    };
+    H2Stream* best = nullptr;
+    for (auto& [id, sp] : streams_) {
+        H2Stream& st = *sp;
+        if (!ready(st)) {
+            continue;
+        }
+        if (st.priority.stream_dep != 0) {
+            auto parent = streams_.find(st.priority.stream_dep);
+            if (parent != streams_.end() && parent->second->priority.stream_dep != st.id && ready(*parent->second)) {
+                continue;
+            }
+        }
+        if (!best || st.vtime < best->vtime) {
+            best = &st;
+        }
+    }
+    if (!best) {
+        return false;
+    }
+    const std::size_t n = static_cast<std::size_t>(
+        std::min<std::int64_t>({static_cast<std::int64_t>(best->pending()), best->send_window, send_window_,
+                                static_cast<std::int64_t>(framer_.MaxWriteFrameSize())}));
+    const bool end = best->end_queued && n == best->pending();
+    framer_.WriteData(best->id, end, std::string_view(best->out).substr(best->out_off, n));
+    best->out_off += n;
+    best->send_window -= static_cast<std::int64_t>(n);
+    send_window_ -= static_cast<std::int64_t>(n);
+    best->vtime += vcost(n, best->priority.weight);
+    vclock_ = best->vtime;
+    if (best->out_off == best->out.size()) {
+        best->out.clear();
+        best->out_off = 0;
+    }
+    if (end) {
+        if (best->body_too_large) {
+            framer_.WriteRSTStream(best->id, h2::ErrCode::NoError);  // stop sending the body (RFC 9113 section 8.1)
+        }
+        best->done = true;
+        streams_.erase(best->id);
+    }
+    space_.notify_all();
+    return true;
+}
+
+void H2ServerConn::writeLoop() {
+    std::unique_lock<std::mutex> lock(mu_);
+    bool failed = false;
+    while (true) {
+        while (framer_.Buffered() < kWriteBatch) {
+            if (!control_.empty()) {
+                Write w = std::move(control_.front());
+                control_.pop_front();
+                w(framer_);
+            } else if (closed_ || !writeDataLocked()) {
+                break;
+            }
+        }
+        if (framer_.Buffered() > 0) {
+            lock.unlock();
+            auto res = framer_.Flush();
+            lock.lock();
+            if (res.Failed()) {
+                failed = true;
+                break;
+            }
+            continue;
+        }
+        if (closed_ || (drain_ && streams_.empty())) {
+            break;
+        }
+        gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+        work_.wait(lock);
+    }
+    const bool close = failed || going_away_ || drain_;
+    if (failed) {
+        closed_ = true;
+        for (auto& [id, st] : streams_) {
+            st->done = true;
+        }
+        streams_.clear();
+        space_.notify_all();
+    }
+    lock.unlock();
+    if (close) {
+        conn_->close();  // wakes the reader
+    }
+}
+
+} // namespace detail
+
+void Server::serveH2(const std::shared_ptr<TCPConn>& conn, gocxx::bufio::Reader& reader) {
+    // The preface was only peeked at
+    reader.Discard(http2::ClientPreface.size());
+    conn->SetReadDeadline({});
+    detail::H2ServerConn(*this, conn, reader).serve();
+}
+
+// Client
+
+namespace detail {
+
+struct H2ClientStream {
+    std::uint32_t id = 0;
+    // Under H2ClientConn::mu_
+    std::int64_t send_window = 0;
+    std::int64_t recv_window = kClientStreamWindow;
+    std::int64_t unacked = 0;
+    bool got_headers = false;
+    Response resp;
+    std::string body;           // received and not yet read, from off
+    std::size_t off = 0;
+    bool ended = false;         // END_STREAM received
+    bool upload_done = false;   // RST_STREAM(NO_ERROR) after the response: the rest of the body is not wanted
+    bool closed = false;        // no longer on the connection
+    std::shared_ptr<gocxx::errors::Error> err;
+};
+
+class H2ClientConn : public std::enable_shared_from_this<H2ClientConn> {
+public:
+    H2ClientConn(std::shared_ptr<TCPConn> conn, std::string address, std::weak_ptr<Transport::H2Pool> pool)
+        : conn_(std::move(conn)), address_(std::move(address)), pool_(std::move(pool)),
+          reader_(std::make_shared<gocxx::bufio::Reader>(conn_)), framer_(*reader_, *conn_) {}
+
+    // Sends the preface and our SETTINGS, and starts the reader
+    std::shared_ptr<gocxx::errors::Error> start();
+
+    // Takes a stream slot for a request to come, if the connection has one
+    bool reserve();
+
+    gocxx::base::Result<Response> roundTrip(const Transport& transport, context::ContextPtr ctx, const Request& req,
+                                            const std::string& address, const std::string& path);
+
+    // For the response body
+    gocxx::base::Result<std::size_t> read(const std::shared_ptr<H2ClientStream>& st, std::uint8_t* buf,
+                                          std::size_t size);
+    void cancel(const std::shared_ptr<H2ClientStream>& st, std::shared_ptr<gocxx::errors::Error> err,
+                h2::ErrCode code = h2::ErrCode::Cancel);
+
+    bool idle();
+    void close(std::shared_ptr<gocxx::errors::Error> err);
+    const std::string& address() const { return address_; }
+
+private:
+    void readLoop();
+    std::shared_ptr<gocxx::errors::Error> process(h2::Frame& f);
+    std::shared_ptr<gocxx::errors::Error> onHeaders(h2::Frame& f);
+    std::shared_ptr<gocxx::errors::Error> onData(h2::Frame& f);
+    std::shared_ptr<gocxx::errors::Error> onSettings(const h2::Frame& f);
+    std::shared_ptr<gocxx::errors::Error> sendBody(const std::shared_ptr<H2ClientStream>& st, const std::string& body);
+    void removeLocked(H2ClientStream& st, std::uint32_t& conn_credit);
+    void creditConnLocked(std::int64_t n, std::uint32_t& inc);
+    std::shared_ptr<gocxx::errors::Error> write(const std::function<void(h2::Framer&)>& fn);
+
+    std::shared_ptr<TCPConn> conn_;
+    std::string address_;
+    std::weak_ptr<Transport::H2Pool> pool_;
+    std::shared_ptr<gocxx::bufio::Reader> reader_;
+    h2::Framer framer_;
+    hpack::Decoder decoder_;  // the reader only
+
+    std::mutex wmu_;          // framer writes and encoder_; taken before mu_
+    hpack::Encoder encoder_;
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::unordered_map<std::uint32_t, std::shared_ptr<H2ClientStream>> streams_;
+    std::uint32_t next_id_ = 1;
+    std::size_t reserved_ = 0;
+    std::uint32_t max_streams_ = kAssumedMaxStreams;
+    std::uint32_t max_frame_ = h2::kDefaultMaxFrameSize;
+    std::int64_t send_window_ = h2::kDefaultWindowSize;
+    std::int64_t peer_initial_window_ = h2::kDefaultWindowSize;
+    std::int64_t recv_window_ = kClientConnWindow;
+    std::int64_t recv_unacked_ = 0;
+    bool goaway_ = false;
+    std::shared_ptr<gocxx::errors::Error> err_;  // set once the connection is dead
+};
+
+} // namespace detail
+
+struct Transport::H2Pool {
+    std::mutex mu;
+    std::unordered_map<std::string, std::vector<std::shared_ptr<detail::H2ClientConn>>> conns;
+    std::unordered_map<std::string, std::shared_ptr<std::mutex>> dialing;  // one dial per host at a time
+
+    std::shared_ptr<detail::H2ClientConn> get(const std::string& address) {
+        std::lock_guard<std::mutex> lock(mu);
+        auto it = conns.find(address);
+        if (it == conns.end()) {
+            return nullptr;
+        }
+        for (auto& c : it->second) {
+            if (c->reserve()) {
+                return c;
+            }
+        }
+        return nullptr;
+    }
+
+    void remove(const detail::H2ClientConn* conn) {
+        std::lock_guard<std::mutex> lock(mu);
+        auto it = conns.find(conn->address());
+        if (it == conns.end()) {
+            return;
+        }
+        auto& list = it->second;
+        list.erase(std::remove_if(list.begin(), list.end(), [conn](const auto& c) { return c.get() == conn; }),
+                   list.end());
+        if (list.empty()) {
+            conns.erase(it);
+        }
+    }
+};
+
+namespace detail {
+
+namespace {
+
+// Response::body_stream of an HTTP/2 response: closing it before the end resets the stream
+class H2ClientBody : public gocxx::io::ReadCloser {
+public:
+    H2ClientBody(std::shared_ptr<H2ClientConn> conn, std::shared_ptr<H2ClientStream> st,
+                 std::function<bool()> stopWatching)
+        : conn_(std::move(conn)), st_(std::move(st)), stop_watching_(std::move(stopWatching)) {}
+
+    ~H2ClientBody() override { close(); }
+
+    gocxx::base::Result<std::size_t> Read(std::uint8_t* buffer, std::size_t size) override {
+        if (size == 0) {
+            return {0, nullptr};
+        }
+        auto res = conn_->read(st_, buffer, size);
+        if (res.Failed()) {
+            stop();
+        }
+        return res;
+    }
+
+    void close() override {
+        stop();
+        conn_->cancel(st_, errBodyClosed);
+    }
+
+private:
+    void stop() {
+        if (stop_watching_) {
+            stop_watching_();
+            stop_watching_ = nullptr;
+        }
+    }
+
+    std::shared_ptr<H2ClientConn> conn_;
+    std::shared_ptr<H2ClientStream> st_;
+    std::function<bool()> stop_watching_;
+};
+
+} // namespace
+
+std::shared_ptr<gocxx::errors::Error> H2ClientConn::write(const std::function<void(h2::Framer&)>& fn) {
+    std::lock_guard<std::mutex> lock(wmu_);
+    fn(framer_);
+    auto res = framer_.Flush();
+    return res.err;
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ClientConn::start() {
+    {
+        std::lock_guard<std::mutex> lock(wmu_);
+        auto res = conn_->Write(reinterpret_cast<const std::uint8_t*>(h2::ClientPreface.data()),
+                                h2::ClientPreface.size());
+        if (res.Failed()) {
+            return res.err;
+        }
+        framer_.WriteSettings({{h2::SettingID::EnablePush, 0},
+                               {h2::SettingID::InitialWindowSize, static_cast<std::uint32_t>(kClientStreamWindow)},
+                               {h2::SettingID::MaxHeaderListSize, kClientMaxHeaderList}});
+        framer_.WriteWindowUpdate(0, static_cast<std::uint32_t>(kClientConnWindow - h2::kDefaultWindowSize));
+        if (auto flushed = framer_.Flush(); flushed.Failed()) {
+            return flushed.err;
+        }
+    }
+    decoder_.SetMaxHeaderListSize(kClientMaxHeaderList);
+    auto self = shared_from_this();
+    gocxx::go([self] { self->readLoop(); });
+    return nullptr;
+}
+
+bool H2ClientConn::reserve() {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (err_ || goaway_ || next_id_ > (1u << 31) - 2 || streams_.size() + reserved_ >= max_streams_) {
+        return false;
+    }
+    ++reserved_;
+    return true;
+}
+
+bool H2ClientConn::idle() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return streams_.empty() && reserved_ == 0;
+}
+
+gocxx::base::Result<Response> H2ClientConn::roundTrip(const Transport& transport, context::ContextPtr ctx,
+                                                      const Request& req, const std::string& address,
+                                                      const std::string& path) {
+    std::vector<hpack::HeaderField> fields;
+    fields.reserve(req.header.size() + 5);
+    fields.push_back({":method", req.method.empty() ? "GET" : req.method});
+    fields.push_back({":scheme", "http"});
+    const std::string host = req.Header("host");
+    fields.push_back({":authority", host.empty() ? address : host});
+    fields.push_back({":path", path});
+    bool has_length = false;
+    for (const auto& [key, value] : req.header) {
+        std::string name = lowerName(key);
+        if (name == "host" || connectionSpecific(name)) {
+            continue;
+        }
+        if (name == "te" && value != "trailers") {
+            continue;
+        }
+        has_length = has_length || name == "content-length";
+        const bool sensitive = name == "authorization";
+        fields.push_back({std::move(name), value, sensitive});
+    }
+    if (!req.body.empty() && !has_length) {
+        fields.push_back({"content-length", std::to_string(req.body.size())});
+    }
+
+    // Stream ids must reach the wire in order, so one is taken with the write lock held
+    auto st = std::make_shared<H2ClientStream>();
+    {
+        std::lock_guard<std::mutex> wlock(wmu_);
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            --reserved_;
+            if (err_ || goaway_) {
+                return {Response(), errUnprocessed};
+            }
+            st->id = next_id_;
+            next_id_ += 2;
+            st->send_window = peer_initial_window_;
+            streams_.emplace(st->id, st);
+        }
+        std::string block;
+        for (const auto& field : fields) {
+            encoder_.Encode(block, field.name, field.value, field.sensitive);
+        }
+        framer_.WriteHeaders(st->id, req.body.empty(), block);
+        if (auto res = framer_.Flush(); res.Failed()) {
+            conn_->close();
+            return {Response(), res.err};
+        }
+    }
+
+    std::function<bool()> stop_watching;
+    if (ctx) {
+        std::weak_ptr<H2ClientConn> weak = shared_from_this();
+        std::weak_ptr<H2ClientStream> weak_st = st;
+        std::weak_ptr<context::Context> weak_ctx = ctx;
+        stop_watching = context::AfterCancel(ctx, [weak, weak_st, weak_ctx] {
+            auto c = weak.lock();
+            auto s = weak_st.lock();
+            auto cx = weak_ctx.lock();
+            if (c && s && cx) {
+                c->cancel(s, cx->Err().err);
+            }
+        });
+    }
+    auto fail = [&](std::shared_ptr<gocxx::errors::Error> err) -> gocxx::base::Result<Response> {
+        if (stop_watching) {
+            stop_watching();
+        }
+        cancel(st, err);
+        if (ctx && ctx->Err().Failed()) {
+            return {Response(), ctx->Err().err};
+        }
+        return {Response(), err};
+    };
+
+    if (!req.body.empty()) {
+        if (auto err = sendBody(st, req.body)) {
+            return fail(err);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mu_);
+    const bool timed = transport.response_header_timeout.count() > 0;
+    const auto deadline = std::chrono::steady_clock::now() + transport.response_header_timeout;
+    while (!st->got_headers && !st->err) {
+        gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+        if (!timed) {
+            cv_.wait(lock);
+        } else if (cv_.wait_until(lock, deadline) == std::cv_status::timeout && !st->got_headers && !st->err) {
+            lock.unlock();
+            return fail(gocxx::errors::Wrap("http2: timeout awaiting response headers", ErrTimeout));
+        }
+    }
+    if (!st->got_headers) {
+        auto err = st->err;
+        lock.unlock();
+        return fail(err);
+    }
+    Response resp = std::move(st->resp);
+    lock.unlock();
+    resp.body_stream = std::make_shared<H2ClientBody>(shared_from_this(), st, std::move(stop_watching));
+    return {std::move(resp), nullptr};
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ClientConn::sendBody(const std::shared_ptr<H2ClientStream>& st,
+                                                             const std::string& body) {
+    std::size_t off = 0;
+    while (off < body.size()) {
+        std::size_t n;
+        {
+            std::unique_lock<std::mutex> lock(mu_);
+            while (!st->err && !st->closed && !st->upload_done && !(send_window_ > 0 && st->send_window > 0)) {
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+                cv_.wait(lock);
+            }
+            if (st->err) {
+                return st->err;
+            }
+            if (st->closed || st->upload_done) {
+                return nullptr;  // answered early; the rest is not wanted
+            }
+            n = static_cast<std::size_t>(std::min<std::int64_t>(
+                {static_cast<std::int64_t>(body.size() - off), send_window_, st->send_window, max_frame_}));
+            send_window_ -= static_cast<std::int64_t>(n);
+            st->send_window -= static_cast<std::int64_t>(n);
+        }
+        const bool end = off + n == body.size();
+        if (auto err = write([&](h2::Framer& f) { f.WriteData(st->id, end, std::string_view(body).substr(off, n)); })) {
+            conn_->close();
+            return err;
+        }
+        off += n;
+    }
+    return nullptr;
+}
+
+gocxx::base::Result<std::size_t> H2ClientConn::read(const std::shared_ptr<H2ClientStream>& st, std::uint8_t* buf,
+                                                     std::size_t size) {
+    std::uint32_t stream_inc = 0;
+    std::uint32_t conn_inc = 0;
+    std::size_t n = 0;
+    {
+        std::unique_lock<std::mutex> lock(mu_);
+        while (st->off == st->body.size() && !st->ended && !st->err) {
+            gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+            cv_.wait(lock);
+        }
+        if (st->off == st->body.size()) {
+            if (!st->ended) {
+                return {0, st->err};
+            }
+            removeLocked(*st, conn_inc);
+            return {0, gocxx::io::ErrEOF};
+        }
+        n = std::min(size, st->body.size() - st->off);
+        std::memcpy(buf, st->body.data() + st->off, n);
+        st->off += n;
+        if (st->off == st->body.size()) {
+            st->body.clear();
+            st->off = 0;
+        }
+        // What the application has taken, the server may send again
+        if (!st->ended) {
+            st->unacked += static_cast<std::int64_t>(n);
+            if (st->unacked >= kClientStreamWindow / 2) {
+                stream_inc = static_cast<std::uint32_t>(st->unacked);
+                st->recv_window += st->unacked;
+                st->unacked = 0;
+            }
+        }
+        creditConnLocked(static_cast<std::int64_t>(n), conn_inc);
+    }
+    if (stream_inc || conn_inc) {
+        const std::uint32_t id = st->id;
+        write([&](h2::Framer& f) {
+            if (stream_inc) {
+                f.WriteWindowUpdate(id, stream_inc);
+            }
+            if (conn_inc) {
+                f.WriteWindowUpdate(0, conn_inc);
+            }
+        });
+    }
+    return {n, nullptr};
+}
+
+void H2ClientConn::cancel(const std::shared_ptr<H2ClientStream>& st, std::shared_ptr<gocxx::errors::Error> err,
+                          h2::ErrCode code) {
+    bool reset = false;
+    std::uint32_t conn_inc = 0;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (st->closed) {
+            return;
+        }
+        reset = !st->ended && !err_;
+        if (!st->err) {
+            st->err = std::move(err);
+        }
+        removeLocked(*st, conn_inc);
+        cv_.notify_all();
+    }
+    if (reset || conn_inc) {
+        const std::uint32_t id = st->id;
+        write([&](h2::Framer& f) {
+            if (reset) {
+                f.WriteRSTStream(id, code);
+            }
+            if (conn_inc) {
+                f.WriteWindowUpdate(0, conn_inc);
+            }
+        });
+    }
+}
+
+// Unread body bytes of a stream that goes away still count against the connection window
+void H2ClientConn::removeLocked(H2ClientStream& st, std::uint32_t& conn_credit) {
+    if (st.closed) {
+        return;
+    }
+    st.closed = true;
+    streams_.erase(st.id);
+    creditConnLocked(static_cast<std::int64_t>(st.body.size() - st.off), conn_credit);
+    st.body.clear();
+    st.off = 0;
+}
+
+void H2ClientConn::creditConnLocked(std::int64_t n, std::uint32_t& inc) {
+    recv_unacked_ += n;
+    if (recv_unacked_ >= kClientConnWindow / 2) {
+        inc += static_cast<std::uint32_t>(recv_unacked_);
+        recv_window_ += recv_unacked_;
+        recv_unacked_ = 0;
+    }
+}
+
+void H2ClientConn::close(std::shared_ptr<gocxx::errors::Error> err) {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (!err_) {
+            err_ = err ? err : errConnClosed;
+        }
+        for (auto& [id, st] : streams_) {
+            if (!st->err) {
+                st->err = err_;
+            }
+            st->closed = true;
+        }
+        streams_.clear();
+        cv_.notify_all();
+    }
+    conn_->close();
+    if (auto pool = pool_.lock()) {
+        pool->remove(this);
+    }
+}
+
+void H2ClientConn::readLoop() {
+    std::shared_ptr<gocxx::errors::Error> err;
+    bool first = true;
+    while (true) {
+        auto frame = framer_.ReadFrame();
+        err = frame.err;
+        if (!err) {
+            if (first && frame.value.header.type != h2::FrameType::Settings) {
+                err = connError(h2::ErrCode::Protocol, "first frame is not SETTINGS");
+            } else {
+                err = process(frame.value);
+            }
+            first = false;
+        }
+        if (!err) {
+            continue;
+        }
+        std::shared_ptr<h2::StreamError> se;
+        if (gocxx::errors::As(err, se)) {
+            std::shared_ptr<H2ClientStream> st;
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                auto it = streams_.find(se->StreamID());
+                if (it != streams_.end()) {
+                    st = it->second;
+                }
+            }
+            if (st) {
+                cancel(st, err, se->Code());
+            } else {
+                const std::uint32_t id = se->StreamID();
+                const h2::ErrCode code = se->Code();
+                write([&](h2::Framer& f) { f.WriteRSTStream(id, code); });
+            }
+            continue;
+        }
+        std::shared_ptr<h2::ConnectionError> ce;
+        if (gocxx::errors::As(err, ce)) {
+            const h2::ErrCode code = ce->Code();
+            write([&](h2::Framer& f) { f.WriteGoAway(0, code); });  // the server opens no streams
+        }
+        break;
+    }
+    close(err);
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ClientConn::process(h2::Frame& f) {
+    const std::uint32_t id = f.header.stream_id;
+    switch (f.header.type) {
+    case h2::FrameType::Headers:
+        return onHeaders(f);
+    case h2::FrameType::Data:
+        return onData(f);
+    case h2::FrameType::Settings:
+        return f.header.Has(h2::FlagAck) ? nullptr : onSettings(f);
+    case h2::FrameType::RSTStream: {
+        std::uint32_t conn_inc = 0;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            auto it = streams_.find(id);
+            if (it == streams_.end()) {
+                return nullptr;
+            }
+            auto st = it->second;
+            // After a complete response NO_ERROR only stops the upload (RFC 9113 section 8.1);
+            // the stream leaves the connection once its body is read, and later resets, answering
+            // DATA already sent, are ignored
+            if (st->upload_done || (f.Code() == h2::ErrCode::NoError && st->ended)) {
+                st->upload_done = true;
+                cv_.notify_all();
+                return nullptr;
+            }
+            // REFUSED_STREAM guarantees the request was not processed (RFC 9113 section 8.7)
+            st->err = f.Code() == h2::ErrCode::RefusedStream && !st->got_headers
+                ? errUnprocessed
+                : streamError(id, f.Code());
+            removeLocked(*st, conn_inc);
+            cv_.notify_all();
+        }
+        if (conn_inc) {
+            write([&](h2::Framer& fr) { fr.WriteWindowUpdate(0, conn_inc); });
+        }
+        return nullptr;
+    }
+    case h2::FrameType::GoAway: {
+        // Streams above last_stream_id were never processed: they fail over to another connection
+        const std::uint32_t last = f.LastStreamID();
+        std::uint32_t conn_inc = 0;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            goaway_ = true;
+            std::vector<std::shared_ptr<H2ClientStream>> unprocessed;
+            for (auto& [sid, st] : streams_) {
+                if (sid > last) {
+                    unprocessed.push_back(st);
+                }
+            }
+            for (auto& st : unprocessed) {
+                st->err = errUnprocessed;
+                removeLocked(*st, conn_inc);
+            }
+            cv_.notify_all();
+        }
+        if (auto pool = pool_.lock()) {
+            pool->remove(this);
+        }
+        if (conn_inc) {
+            write([&](h2::Framer& fr) { fr.WriteWindowUpdate(0, conn_inc); });
+        }
+        return nullptr;
+    }
+    case h2::FrameType::Ping: {
+        if (f.header.Has(h2::FlagAck)) {
+            return nullptr;
+        }
+        auto data = f.PingData();
+        write([&](h2::Framer& fr) { fr.WritePing(true, data); });
+        return nullptr;
+    }
+    case h2::FrameType::WindowUpdate: {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (id == 0) {
+            send_window_ += f.WindowIncrement();
+            if (send_window_ > h2::kMaxWindowSize) {
+                return connError(h2::ErrCode::FlowControl, "connection window overflow");
+            }
+        } else if (auto it = streams_.find(id); it != streams_.end()) {
+            it->second->send_window += f.WindowIncrement();
+            if (it->second->send_window > h2::kMaxWindowSize) {
+                return streamError(id, h2::ErrCode::FlowControl);
+            }
+        }
+        cv_.notify_all();
+        return nullptr;
+    }
+    case h2::FrameType::PushPromise:
+        return connError(h2::ErrCode::Protocol, "PUSH_PROMISE with push disabled");
+    default:
+        return nullptr;
+    }
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ClientConn::onHeaders(h2::Frame& f) {
+    const std::uint32_t id = f.header.stream_id;
+    auto decoded = decoder_.Decode(f.payload);
+    if (decoded.Failed() && !gocxx::errors::Is(decoded.err, hpack::ErrStringLength)) {
+        return connError(h2::ErrCode::Compression, decoded.err->error());
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = streams_.find(id);
+    if (it == streams_.end()) {
+        return nullptr;  // a stream we cancelled
+    }
+    H2ClientStream& st = *it->second;
+    if (decoded.Failed()) {
+        return streamError(id, h2::ErrCode::Protocol);
+    }
+    const bool end = f.header.Has(h2::FlagEndStream);
+    if (!st.got_headers) {
+        int status = 0;
+        std::map<std::string, std::string> header;
+        for (auto& field : decoded.value) {
+            if (field.name == ":status") {
+                char* stop = nullptr;
+                status = static_cast<int>(std::strtol(field.value.c_str(), &stop, 10));
+                if (field.value.size() != 3 || *stop != '\0') {
+                    return streamError(id, h2::ErrCode::Protocol);
+                }
+            } else if (!field.name.empty() && field.name[0] != ':') {
+                auto [pos, inserted] = header.emplace(field.name, field.value);
+                if (!inserted) {
+                    pos->second.append(field.name == "cookie" ? "; " : ", ").append(field.value);
+                }
+            }
+        }
+        if (status == 0) {
+            return streamError(id, h2::ErrCode::Protocol);
+        }
+        if (status >= 100 && status < 200) {
+            // Interim response (100 Continue, 103 Early Hints): the final one follows
+            return end ? streamError(id, h2::ErrCode::Protocol) : nullptr;
+        }
+        st.resp.proto = "HTTP/2.0";
+        st.resp.status_code = status;
+        st.resp.status = StatusText(status);
+        st.resp.header = std::move(header);
+        st.got_headers = true;
+    } else if (!end) {
+        return streamError(id, h2::ErrCode::Protocol);  // trailers must end the stream
+    }
+    if (end) {
+        st.ended = true;
+    }
+    cv_.notify_all();
+    return nullptr;
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ClientConn::onData(h2::Frame& f) {
+    const std::uint32_t id = f.header.stream_id;
+    const std::int64_t len = f.header.length;  // padding included
+    std::uint32_t conn_inc = 0;
+    std::shared_ptr<gocxx::errors::Error> err;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        recv_window_ -= len;
+        if (recv_window_ < 0) {
+            return connError(h2::ErrCode::FlowControl, "DATA beyond the connection window");
+        }
+        auto it = streams_.find(id);
+        if (it == streams_.end()) {
+            // A stream we cancelled: the data is dropped, the window given back
+            creditConnLocked(len, conn_inc);
+        } else {
+            H2ClientStream& st = *it->second;
+            st.recv_window -= len;
+            if (!st.got_headers || st.ended) {
+                err = streamError(id, h2::ErrCode::Protocol);
+            } else if (st.recv_window < 0) {
+                err = streamError(id, h2::ErrCode::FlowControl);
+            } else {
+                st.body.append(f.payload);
+                // Padding is never read, so it is credited at once
+                creditConnLocked(len - static_cast<std::int64_t>(f.payload.size()), conn_inc);
+                if (f.header.Has(h2::FlagEndStream)) {
+                    st.ended = true;
+                }
+                cv_.notify_all();
+            }
+        }
+    }
+    if (conn_inc) {
+        write([&](h2::Framer& fr) { fr.WriteWindowUpdate(0, conn_inc); });
+    }
+    return err;
+}
+
+std::shared_ptr<gocxx::errors::Error> H2ClientConn::onSettings(const h2::Frame& f) {
+    std::lock_guard<std::mutex> wlock(wmu_);
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        for (const auto& s : f.Settings()) {
+            switch (s.id) {
+            case h2::SettingID::HeaderTableSize:
+                encoder_.SetMaxDynamicTableSizeLimit(s.value);
+                break;
+            case h2::SettingID::MaxConcurrentStreams:
+                max_streams_ = s.value;
+                break;
+            case h2::SettingID::InitialWindowSize: {
+                const std::int64_t delta = static_cast<std::int64_t>(s.value) - peer_initial_window_;
+                for (auto& [id, st] : streams_) {
+                    st->send_window += delta;
+                    if (st->send_window > h2::kMaxWindowSize) {
+                        return connError(h2::ErrCode::FlowControl, "SETTINGS_INITIAL_WINDOW_SIZE overflows a window");
+                    }
+                }
+                peer_initial_window_ = s.value;
+                break;
+            }
+            case h2::SettingID::MaxFrameSize:
+                max_frame_ = s.value;
+                framer_.SetMaxWriteFrameSize(s.value);
+                break;
+            default:
+                break;
+            }
+        }
+        cv_.notify_all();
+    }
+    framer_.WriteSettingsAck();
+    return framer_.Flush().err;
+}
+
+} // namespace detail
+
+namespace detail {
+
+std::shared_ptr<Transport::H2Pool> NewH2Pool() {
+    return std::make_shared<Transport::H2Pool>();
+}
+
+gocxx::base::Result<Response> RoundTripH2(const Transport& transport, const std::shared_ptr<Transport::H2Pool>& pool,
+                                          context::ContextPtr ctx, const Request& req,
+                                          const std::string& address, const std::string& path) {
+    gocxx::base::Result<Response> result{Response(), errUnprocessed};
+    for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+        auto conn = pool->get(address);
+        if (!conn) {
+            std::shared_ptr<std::mutex> dialing;
+            {
+                std::lock_guard<std::mutex> lock(pool->mu);
+                auto& slot = pool->dialing[address];
+                if (!slot) {
+                    slot = std::make_shared<std::mutex>();
+                }
+                dialing = slot;
+            }
+            // Requests racing to a new host share the first connection instead of each dialing
+            std::unique_lock<std::mutex> dial_lock(*dialing, std::try_to_lock);
+            if (!dial_lock) {
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+                dial_lock.lock();
+            }
+            conn = pool->get(address);
+            if (!conn) {
+                Dialer dialer;
+                dialer.timeout = transport.dial_timeout;
+                auto dialed = dialer.DialContext(ctx, "tcp", address);
+                if (dialed.Failed()) {
+                    return {Response(), dialed.err};
+                }
+                conn = std::make_shared<H2ClientConn>(dialed.value, address, pool);
+                if (auto err = conn->start()) {
+                    conn->close(err);
+                    return {Response(), err};
+                }
+                {
+                    std::lock_guard<std::mutex> lock(pool->mu);
+                    pool->conns[address].push_back(conn);
+                }
+                if (!conn->reserve()) {
+                    continue;  // refused or gone already
+                }
+            }
+        }
+        result = conn->roundTrip(transport, ctx, req, address, path);
+        if (!result.Failed() || !gocxx::errors::Is(result.err, errUnprocessed) || (ctx && ctx->Err().Failed())) {
+            break;
+        }
+    }
+    return result;
+}
+
+void CloseIdleH2(Transport::H2Pool& pool) {
+    std::vector<std::shared_ptr<H2ClientConn>> idle;
+    {
+        std::lock_guard<std::mutex> lock(pool.mu);
+        for (auto& [address, list] : pool.conns) {
+            for (auto& c : list) {
+                if (c->idle()) {
+                    idle.push_back(c);
+                }
+            }
+        }
+    }
+    for (auto& c : idle) {
+        c->close(nullptr);  // takes itself out of the pool
+    }
+}
+
+} // namespace detail
+
+} // namespace gocxx::net::http
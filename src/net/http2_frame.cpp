@@ -0,0 +1,341 @@
+#include <gocxx/net/http2.h>
+#include <gocxx/io/io_errors.h>
+#include <algorithm>
+
+namespace gocxx::net::http2 {
+
+namespace {
+
+std::uint32_t get32(const std::string& s, std::size_t at) {
+    return static_cast<std::uint32_t>(static_cast<std::uint8_t>(s[at])) << 24 |
+           static_cast<std::uint32_t>(static_cast<std::uint8_t>(s[at + 1])) << 16 |
+           static_cast<std::uint32_t>(static_cast<std::uint8_t>(s[at + 2])) << 8 |
+           static_cast<std::uint32_t>(static_cast<std::uint8_t>(s[at + 3]));
+}
+
+void put32(std::string& s, std::uint32_t v) {
+    s.push_back(static_cast<char>(v >> 24));
+    s.push_back(static_cast<char>(v >> 16));
+    s.push_back(static_cast<char>(v >> 8));
+    s.push_back(static_cast<char>(v));
+}
+
+std::shared_ptr<gocxx::errors::Error> connError(ErrCode code, std::string reason) {
+    return std::make_shared<ConnectionError>(code, std::move(reason));
+}
+
+// Strips the pad length byte and padding of a PADDED frame
+std::shared_ptr<gocxx::errors::Error> unpad(Frame& f) {
+    if (!f.header.Has(FlagPadded)) {
+        return nullptr;
+    }
+    if (f.payload.empty()) {
+        return connError(ErrCode::FrameSize, "padded frame without pad length");
+    }
+    const std::size_t pad = static_cast<std::uint8_t>(f.payload[0]);
+    if (pad >= f.payload.size()) {
+        return connError(ErrCode::Protocol, "padding longer than the payload");
+    }
+    f.payload.erase(f.payload.size() - pad);
+    f.payload.erase(0, 1);
+    return nullptr;
+}
+
+PriorityParam parsePriority(const std::string& s, std::size_t at) {
+    const std::uint32_t dep = get32(s, at);
+    return PriorityParam{dep & 0x7fffffff, (dep >> 31) != 0, static_cast<std::uint8_t>(s[at + 4])};
+}
+
+} // namespace
+
+const char* ErrCodeName(ErrCode code) noexcept {
+    switch (code) {
+        case ErrCode::NoError: return "NO_ERROR";
+        case ErrCode::Protocol: return "PROTOCOL_ERROR";
+        case ErrCode::Internal: return "INTERNAL_ERROR";
+        case ErrCode::FlowControl: return "FLOW_CONTROL_ERROR";
+        case ErrCode::SettingsTimeout: return "SETTINGS_TIMEOUT";
+        case ErrCode::StreamClosed: return "STREAM_CLOSED";
+        case ErrCode::FrameSize: return "FRAME_SIZE_ERROR";
+        case ErrCode::RefusedStream: return "REFUSED_STREAM";
+        case ErrCode::Cancel: return "CANCEL";
+        case ErrCode::Compression: return "COMPRESSION_ERROR";
+        case ErrCode::Connect: return "CONNECT_ERROR";
+        case ErrCode::EnhanceYourCalm: return "ENHANCE_YOUR_CALM";
+        case ErrCode::InadequateSecurity: return "INADEQUATE_SECURITY";
+        case ErrCode::HTTP11Required: return "HTTP_1_1_REQUIRED";
+    }
+    return "unknown error code";
+}
+
+std::string ConnectionError::error() const noexcept {
+    return std::string("http2: connection error: ") + ErrCodeName(code_) + ": " + reason_;
+}
+
+std::string StreamError::error() const noexcept {
+    return "http2: stream " + std::to_string(stream_id_) + " reset: " + ErrCodeName(code_);
+}
+
+// Frame accessors
+std::vector<Setting> Frame::Settings() const {
+    std::vector<Setting> out;
+    for (std::size_t at = 0; at + 6 <= payload.size(); at += 6) {
+        const auto id = static_cast<std::uint16_t>(static_cast<std::uint8_t>(payload[at]) << 8 |
+                                                   static_cast<std::uint8_t>(payload[at + 1]));
+        out.push_back({static_cast<SettingID>(id), get32(payload, at + 2)});
+    }
+    return out;
+}
+
+std::uint32_t Frame::WindowIncrement() const {
+    return get32(payload, 0) & 0x7fffffff;
+}
+
+ErrCode Frame::Code() const {
+    return static_cast<ErrCode>(get32(payload, header.type == FrameType::GoAway ? 4 : 0));
+}
+
+std::uint32_t Frame::LastStreamID() const {
+    return get32(payload, 0) & 0x7fffffff;
+}
+
+std::string_view Frame::DebugData() const {
+    return std::string_view(payload).substr(8);
+}
+
+std::array<std::uint8_t, 8> Frame::PingData() const {
+    std::array<std::uint8_t, 8> data{};
+    for (std::size_t i = 0; i < 8; ++i) data[i] = static_cast<std::uint8_t>(payload[i]);
+    return data;
+}
+
+// Reading
+std::shared_ptr<gocxx::errors::Error> Framer::readFull(char* dst, std::size_t n, std::size_t& got) {
+    got = 0;
+    while (got < n) {
+        auto res = r_.Read(reinterpret_cast<uint8_t*>(dst + got), n - got);
+        got += res.value;
+        if (res.value == 0 && got < n) {
+            return res.err && !gocxx::errors::Is(res.err, gocxx::io::ErrEOF) ? res.err : gocxx::io::ErrUnexpectedEOF;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<gocxx::errors::Error> Framer::readPayload(std::uint32_t length, std::string& out) {
+    const std::size_t start = out.size();
+    out.resize(start + length);
+    std::size_t got;
+    auto err = readFull(&out[start], length, got);
+    if (err) {
+        out.resize(start + got);
+    }
+    return err;
+}
+
+gocxx::base::Result<FrameHeader> Framer::readHeader() {
+    unsigned char raw[kFrameHeaderLen];
+    std::size_t got;
+    if (auto err = readFull(reinterpret_cast<char*>(raw), sizeof(raw), got)) {
+        // A clean end between frames is EOF, not an unexpected one
+        return {FrameHeader{}, got == 0 && gocxx::errors::Is(err, gocxx::io::ErrUnexpectedEOF) ? gocxx::io::ErrEOF : err};
+    }
+    FrameHeader h;
+    h.length = static_cast<std::uint32_t>(raw[0]) << 16 | static_cast<std::uint32_t>(raw[1]) << 8 | raw[2];
+    h.type = static_cast<FrameType>(raw[3]);
+    h.flags = raw[4];
+    h.stream_id = (static_cast<std::uint32_t>(raw[5]) << 24 | static_cast<std::uint32_t>(raw[6]) << 16 |
+                   static_cast<std::uint32_t>(raw[7]) << 8 | raw[8]) & 0x7fffffff;
+    if (h.length > max_read_) {
+        return {h, connError(ErrCode::FrameSize, "frame larger than SETTINGS_MAX_FRAME_SIZE")};
+    }
+    return {h, nullptr};
+}
+
+gocxx::base::Result<Frame> Framer::ReadFrame() {
+    Frame f;
+    auto fail = [&](std::shared_ptr<gocxx::errors::Error> err) -> gocxx::base::Result<Frame> {
+        return {std::move(f), std::move(err)};
+    };
+    auto h = readHeader();
+    if (h.Failed()) {
+        return fail(h.err);
+    }
+    f.header = h.value;
+    if (auto err = readPayload(f.header.length, f.payload)) {
+        return fail(err);
+    }
+    const std::uint32_t id = f.header.stream_id;
+    const std::size_t len = f.payload.size();
+
+    switch (f.header.type) {
+        case FrameType::Data:
+            if (id == 0) return fail(connError(ErrCode::Protocol, "DATA on stream 0"));
+            if (auto err = unpad(f)) return fail(err);
+            break;
+        case FrameType::Headers: {
+            if (id == 0) return fail(connError(ErrCode::Protocol, "HEADERS on stream 0"));
+            if (auto err = unpad(f)) return fail(err);
+            if (f.header.Has(FlagPriority)) {
+                if (f.payload.size() < 5) return fail(connError(ErrCode::FrameSize, "HEADERS too short for priority"));
+                f.has_priority = true;
+                f.priority = parsePriority(f.payload, 0);
+                f.payload.erase(0, 5);
+            }
+            // The rest of the block, in CONTINUATION frames on the same stream and nothing between
+            while (!f.header.Has(FlagEndHeaders)) {
+                auto next = readHeader();
+                if (next.Failed()) return fail(next.err);
+                if (next.value.type != FrameType::Continuation || next.value.stream_id != id) {
+                    return fail(connError(ErrCode::Protocol, "header block interrupted"));
+                }
+                if (f.payload.size() + next.value.length > max_header_block_) {
+                    return fail(connError(ErrCode::EnhanceYourCalm, "header block too large"));
+                }
+                if (auto err = readPayload(next.value.length, f.payload)) return fail(err);
+                f.header.flags |= next.value.flags & FlagEndHeaders;
+            }
+            break;
+        }
+        case FrameType::Priority:
+            if (id == 0) return fail(connError(ErrCode::Protocol, "PRIORITY on stream 0"));
+            if (len != 5) return fail(std::make_shared<StreamError>(id, ErrCode::FrameSize));
+            f.has_priority = true;
+            f.priority = parsePriority(f.payload, 0);
+            break;
+        case FrameType::RSTStream:
+            if (id == 0) return fail(connError(ErrCode::Protocol, "RST_STREAM on stream 0"));
+            if (len != 4) return fail(connError(ErrCode::FrameSize, "RST_STREAM length"));
+            break;
+        case FrameType::Settings:
+            if (id != 0) return fail(connError(ErrCode::Protocol, "SETTINGS on a stream"));
+            if (f.header.Has(FlagAck) && len != 0) return fail(connError(ErrCode::FrameSize, "SETTINGS ack with payload"));
+            if (len % 6 != 0) return fail(connError(ErrCode::FrameSize, "SETTINGS length"));
+            for (const Setting& s : f.Settings()) {
+                if (s.id == SettingID::EnablePush && s.value > 1) {
+                    return fail(connError(ErrCode::Protocol, "SETTINGS_ENABLE_PUSH out of range"));
+                }
+                if (s.id == SettingID::InitialWindowSize && s.value > kMaxWindowSize) {
+                    return fail(connError(ErrCode::FlowControl, "SETTINGS_INITIAL_WINDOW_SIZE out of range"));
+                }
+                if (s.id == SettingID::MaxFrameSize && (s.value < kDefaultMaxFrameSize || s.value > kMaxFrameSizeLimit)) {
+                    return fail(connError(ErrCode::Protocol, "SETTINGS_MAX_FRAME_SIZE out of range"));
+                }
+            }
+            break;
+        case FrameType::PushPromise:
+            if (id == 0) return fail(connError(ErrCode::Protocol, "PUSH_PROMISE on stream 0"));
+            break;
+        case FrameType::Ping:
+            if (id != 0) return fail(connError(ErrCode::Protocol, "PING on a stream"));
+            if (len != 8) return fail(connError(ErrCode::FrameSize, "PING length"));
+            break;
+        case FrameType::GoAway:
+            if (id != 0) return fail(connError(ErrCode::Protocol, "GOAWAY on a stream"));
+            if (len < 8) return fail(connError(ErrCode::FrameSize, "GOAWAY length"));
+            break;
+        case FrameType::WindowUpdate:
+            if (len != 4) return fail(connError(ErrCode::FrameSize, "WINDOW_UPDATE length"));
+            if (f.WindowIncrement() == 0) {
+                if (id == 0) return fail(connError(ErrCode::Protocol, "WINDOW_UPDATE of 0"));
+                return fail(std::make_shared<StreamError>(id, ErrCode::Protocol));
+            }
+            break;
+        case FrameType::Continuation:
+            return fail(connError(ErrCode::Protocol, "CONTINUATION without HEADERS"));
+        default:
+            break;  // unknown types are ignored by the caller (RFC 9113 section 4.1)
+    }
+    return {std::move(f), nullptr};
+}
+
+// Writing
+void Framer::header(std::uint32_t length, FrameType type, std::uint8_t flags, std::uint32_t streamID) {
+    out_.push_back(static_cast<char>(length >> 16));
+    out_.push_back(static_cast<char>(length >> 8));
+    out_.push_back(static_cast<char>(length));
+    out_.push_back(static_cast<char>(type));
+    out_.push_back(static_cast<char>(flags));
+    put32(out_, streamID & 0x7fffffff);
+}
+
+void Framer::WriteData(std::uint32_t streamID, bool endStream, std::string_view data) {
+    header(static_cast<std::uint32_t>(data.size()), FrameType::Data, endStream ? FlagEndStream : 0, streamID);
+    out_.append(data);
+}
+
+void Framer::WriteHeaders(std::uint32_t streamID, bool endStream, std::string_view block,
+                          const PriorityParam* priority) {
+    const std::size_t extra = priority ? 5 : 0;
+    std::size_t first = std::min<std::size_t>(block.size(), max_write_ - extra);
+    std::uint8_t flags = (endStream ? FlagEndStream : 0) | (first == block.size() ? FlagEndHeaders : 0) |
+                         (priority ? FlagPriority : 0);
+    header(static_cast<std::uint32_t>(first + extra), FrameType::Headers, flags, streamID);
+    if (priority) {
+        put32(out_, priority->stream_dep | (priority->exclusive ? 0x80000000u : 0));
+        out_.push_back(static_cast<char>(priority->weight));
+    }
+    out_.append(block.substr(0, first));
+    block.remove_prefix(first);
+    while (!block.empty()) {
+        const std::size_t n = std::min<std::size_t>(block.size(), max_write_);
+        header(static_cast<std::uint32_t>(n), FrameType::Continuation, n == block.size() ? FlagEndHeaders : 0, streamID);
+        out_.append(block.substr(0, n));
+        block.remove_prefix(n);
+    }
+}
+
+void Framer::WritePriority(std::uint32_t streamID, const PriorityParam& priority) {
+    header(5, FrameType::Priority, 0, streamID);
+    put32(out_, priority.stream_dep | (priority.exclusive ? 0x80000000u : 0));
+    out_.push_back(static_cast<char>(priority.weight));
+}
+
+void Framer::WriteRSTStream(std::uint32_t streamID, ErrCode code) {
+    header(4, FrameType::RSTStream, 0, streamID);
+    put32(out_, static_cast<std::uint32_t>(code));
+}
+
+void Framer::WriteSettings(const std::vector<Setting>& settings) {
+    header(static_cast<std::uint32_t>(settings.size() * 6), FrameType::Settings, 0, 0);
+    for (const Setting& s : settings) {
+        out_.push_back(static_cast<char>(static_cast<std::uint16_t>(s.id) >> 8));
+        out_.push_back(static_cast<char>(s.id));
+        put32(out_, s.value);
+    }
+}
+
+void Framer::WriteSettingsAck() {
+    header(0, FrameType::Settings, FlagAck, 0);
+}
+
+void Framer::WritePing(bool ack, const std::array<std::uint8_t, 8>& data) {
+    header(8, FrameType::Ping, ack ? FlagAck : 0, 0);
+    out_.append(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+void Framer::WriteGoAway(std::uint32_t lastStreamID, ErrCode code, std::string_view debug) {
+    header(static_cast<std::uint32_t>(8 + debug.size()), FrameType::GoAway, 0, 0);
+    put32(out_, lastStreamID & 0x7fffffff);
+    put32(out_, static_cast<std::uint32_t>(code));
+    out_.append(debug);
+}
+
+void Framer::WriteWindowUpdate(std::uint32_t streamID, std::uint32_t increment) {
+    header(4, FrameType::WindowUpdate, 0, streamID);
+    put32(out_, increment & 0x7fffffff);
+}
+
+gocxx::base::Result<void> Framer::Flush() {
+    if (out_.empty()) {
+        return {};
+    }
+    auto res = w_.Write(reinterpret_cast<const uint8_t*>(out_.data()), out_.size());
+    out_.clear();
+    if (res.Failed()) {
+        return {res.err};
+    }
+    return {};
+}
+
+} // namespace gocxx::net::http2
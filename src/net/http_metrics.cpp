@@ -0,0 +1,355 @@
+#include <gocxx/net/http_metrics.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <unordered_map>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace gocxx::net::http {
+
+namespace detail {
+
+// Written by one thread only, so an increment is a plain load and store
+// rather than a locked read-modify-write; readers on other threads see
+// each value whole.
+struct LocalCounter {
+    std::atomic<std::uint64_t> v{0};
+
+    void add(std::uint64_t n) noexcept {
+        v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    std::uint64_t load() const noexcept { return v.load(std::memory_order_relaxed); }
+};
+
+struct RouteSlot {
+    explicit RouteSlot(std::string_view r) : route(r) {}
+
+    const std::string route;
+    LocalCounter by_class[5];
+    LocalCounter request_bytes;
+    LocalCounter response_bytes;
+    LocalCounter latency_ns;
+    LocalCounter latency[LatencyHistogram::kBuckets];
+};
+
+/**
+ * One thread's share of a ServerMetrics. Only that thread records into it;
+ * it takes mu to add a route, and readers take mu to walk the table.
+ */
+struct MetricsShard {
+    std::mutex mu;
+    std::unordered_map<std::string_view, std::unique_ptr<RouteSlot>> routes;  // keys view RouteSlot::route
+    RouteSlot* last = nullptr;  // checked before the table
+    LocalCounter accepted;
+    LocalCounter started;
+    LocalCounter finished;
+    LocalCounter entered[4];  // by ConnState
+    LocalCounter left[4];
+};
+
+} // namespace detail
+
+using detail::MetricsShard;
+using detail::RouteSlot;
+
+namespace {
+
+int highestBit(std::uint64_t v) noexcept {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return static_cast<int>(i);
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+std::atomic<std::uint64_t> nextMetricsId{1};
+
+// This thread's shard of each ServerMetrics it has recorded into; ids are
+// never reused, so entries for destroyed instances are merely unreachable
+struct LocalShards {
+    std::uint64_t id = 0;
+    MetricsShard* shard = nullptr;
+    std::vector<std::pair<std::uint64_t, MetricsShard*>> others;
+};
+
+thread_local LocalShards localShards;
+
+void appendEscaped(std::string& out, std::string_view label) {
+    for (char c : label) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '"') out += "\\\"";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+}
+
+void appendNumber(std::string& out, double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", v);
+    out += buf;
+}
+
+} // namespace
+
+// LatencyHistogram
+
+std::size_t LatencyHistogram::BucketFor(std::uint64_t micros) noexcept {
+    if (micros < 2 * kSubBuckets) {
+        return static_cast<std::size_t>(micros);
+    }
+    const int msb = highestBit(micros);
+    if (msb >= 32) {
+        return kBuckets - 1;
+    }
+    const int shift = msb - 3;
+    return 2 * kSubBuckets + static_cast<std::size_t>(msb - 4) * kSubBuckets +
+           static_cast<std::size_t>((micros >> shift) - kSubBuckets);
+}
+
+std::uint64_t LatencyHistogram::UpperBound(std::size_t i) noexcept {
+    if (i < 2 * kSubBuckets) {
+        return i + 1;
+    }
+    const std::size_t octave = (i - 2 * kSubBuckets) / kSubBuckets;
+    const std::size_t sub = (i - 2 * kSubBuckets) % kSubBuckets;
+    return static_cast<std::uint64_t>(kSubBuckets + sub + 1) << (octave + 1);
+}
+
+std::uint64_t LatencyHistogram::Count() const noexcept {
+    std::uint64_t n = 0;
+    for (std::uint64_t c : counts) n += c;
+    return n;
+}
+
+std::chrono::microseconds LatencyHistogram::Quantile(double q) const noexcept {
+    const std::uint64_t total = Count();
+    if (total == 0) {
+        return std::chrono::microseconds(0);
+    }
+    const double clamped = std::min(std::max(q, 0.0), 1.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped * total)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            // The highest value the bucket holds
+            return std::chrono::microseconds(UpperBound(i) - 1);
+        }
+    }
+    return std::chrono::microseconds(UpperBound(kBuckets - 1) - 1);
+}
+
+std::uint64_t LatencyHistogram::CountBelow(std::uint64_t micros) const noexcept {
+    std::uint64_t n = 0;
+    for (std::size_t i = 0; i < kBuckets && UpperBound(i) <= micros; ++i) {
+        n += counts[i];
+    }
+    return n;
+}
+
+// ServerMetrics
+
+ServerMetrics::ServerMetrics() : id_(nextMetricsId.fetch_add(1, std::memory_order_relaxed)) {}
+
+ServerMetrics::~ServerMetrics() = default;
+
+MetricsShard& ServerMetrics::localShard() {
+    LocalShards& local = localShards;
+    if (local.id == id_) {
+        return *local.shard;
+    }
+    MetricsShard* shard = nullptr;
+    for (const auto& other : local.others) {
+        if (other.first == id_) {
+            shard = other.second;
+            break;
+        }
+    }
+    if (!shard) {
+        std::lock_guard<std::mutex> lock(mu_);
+        shards_.push_back(std::make_unique<MetricsShard>());
+        shard = shards_.back().get();
+        local.others.emplace_back(id_, shard);
+    }
+    local.id = id_;
+    local.shard = shard;
+    return *shard;
+}
+
+void ServerMetrics::connOpened() {
+    MetricsShard& shard = localShard();
+    shard.accepted.add(1);
+    shard.entered[static_cast<int>(ConnState::New)].add(1);
+}
+
+void ServerMetrics::connStateChanged(ConnState from, ConnState to) {
+    MetricsShard& shard = localShard();
+    shard.left[static_cast<int>(from)].add(1);
+    shard.entered[static_cast<int>(to)].add(1);
+}
+
+void ServerMetrics::RequestStarted() {
+    localShard().started.add(1);
+}
+
+void ServerMetrics::RequestFinished(std::string_view route, int status, std::size_t request_bytes,
+                                    std::size_t response_bytes, std::chrono::nanoseconds latency) {
+    MetricsShard& shard = localShard();
+    RouteSlot* slot = shard.last;
+    if (!slot || slot->route != route) {
+        auto it = shard.routes.find(route);
+        if (it != shard.routes.end()) {
+            slot = it->second.get();
+        } else {
+            auto created = std::make_unique<RouteSlot>(route);
+            slot = created.get();
+            std::lock_guard<std::mutex> lock(shard.mu);
+            shard.routes.emplace(std::string_view(slot->route), std::move(created));
+        }
+        shard.last = slot;
+    }
+
+    const int cls = std::min(std::max(status / 100, 1), 5) - 1;
+    slot->by_class[cls].add(1);
+    slot->request_bytes.add(request_bytes);
+    slot->response_bytes.add(response_bytes);
+    const std::uint64_t ns = latency.count() > 0 ? static_cast<std::uint64_t>(latency.count()) : 0;
+    slot->latency_ns.add(ns);
+    slot->latency[LatencyHistogram::BucketFor(ns / 1000)].add(1);
+    shard.finished.add(1);
+}
+
+ServerStats ServerMetrics::Snapshot() const {
+    std::vector<MetricsShard*> shards;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        for (const auto& shard : shards_) shards.push_back(shard.get());
+    }
+
+    ServerStats stats;
+    std::map<std::string, RouteStats> routes;
+    std::int64_t entered[4] = {};
+    std::int64_t left[4] = {};
+    for (MetricsShard* shard : shards) {
+        stats.accepted += shard->accepted.load();
+        stats.in_flight += static_cast<std::int64_t>(shard->started.load() - shard->finished.load());
+        for (int i = 0; i < 4; ++i) {
+            entered[i] += static_cast<std::int64_t>(shard->entered[i].load());
+            left[i] += static_cast<std::int64_t>(shard->left[i].load());
+        }
+        std::lock_guard<std::mutex> lock(shard->mu);
+        for (const auto& entry : shard->routes) {
+            const RouteSlot& slot = *entry.second;
+            RouteStats& r = routes[slot.route];
+            for (std::size_t c = 0; c < r.by_class.size(); ++c) {
+                const std::uint64_t n = slot.by_class[c].load();
+                r.by_class[c] += n;
+                r.requests += n;
+            }
+            r.request_bytes += slot.request_bytes.load();
+            r.response_bytes += slot.response_bytes.load();
+            r.latency_sum += std::chrono::nanoseconds(static_cast<std::int64_t>(slot.latency_ns.load()));
+            for (std::size_t b = 0; b < LatencyHistogram::kBuckets; ++b) {
+                r.latency.counts[b] += slot.latency[b].load();
+            }
+        }
+    }
+    // Shards are read one after another, so a request started on one and
+    // finished on another can briefly show as a negative count
+    stats.in_flight = std::max<std::int64_t>(stats.in_flight, 0);
+    auto open = [&](ConnState s) {
+        return std::max<std::int64_t>(entered[static_cast<int>(s)] - left[static_cast<int>(s)], 0);
+    };
+    stats.conns_new = open(ConnState::New);
+    stats.conns_active = open(ConnState::Active);
+    stats.conns_idle = open(ConnState::Idle);
+    for (auto& entry : routes) {
+        entry.second.route = entry.first;
+        stats.routes.push_back(std::move(entry.second));
+    }
+    return stats;
+}
+
+void ServerMetrics::WritePrometheus(std::string& out) const {
+    const ServerStats stats = Snapshot();
+    auto series = [&](const char* name, const RouteStats& r) {
+        out.append(name).append("{route=\"");
+        appendEscaped(out, r.route);
+        out += '"';
+    };
+
+    out += "# HELP http_server_requests_total Requests answered, by route and status class.\n"
+           "# TYPE http_server_requests_total counter\n";
+    static const char* const kClasses[] = {"1xx", "2xx", "3xx", "4xx", "5xx"};
+    for (const RouteStats& r : stats.routes) {
+        for (std::size_t c = 0; c < r.by_class.size(); ++c) {
+            if (r.by_class[c] == 0) continue;
+            series("http_server_requests_total", r);
+            out.append(",code=\"").append(kClasses[c]).append("\"} ").append(std::to_string(r.by_class[c])) += '\n';
+        }
+    }
+
+    out += "# HELP http_server_request_duration_seconds Time from reading a request to sending its response.\n"
+           "# TYPE http_server_request_duration_seconds histogram\n";
+    for (const RouteStats& r : stats.routes) {
+        // Powers of two from 16us to 2^26us (67s) are bucket edges, so these counts are exact
+        for (int k = 4; k <= 26; ++k) {
+            const std::uint64_t edge = std::uint64_t(1) << k;
+            series("http_server_request_duration_seconds_bucket", r);
+            out += ",le=\"";
+            appendNumber(out, static_cast<double>(edge) / 1e6);
+            out.append("\"} ").append(std::to_string(r.latency.CountBelow(edge))) += '\n';
+        }
+        series("http_server_request_duration_seconds_bucket", r);
+        out.append(",le=\"+Inf\"} ").append(std::to_string(r.requests)) += '\n';
+        series("http_server_request_duration_seconds_sum", r);
+        out += "} ";
+        appendNumber(out, std::chrono::duration<double>(r.latency_sum).count());
+        out += '\n';
+        series("http_server_request_duration_seconds_count", r);
+        out.append("} ").append(std::to_string(r.requests)) += '\n';
+    }
+
+    out += "# HELP http_server_request_body_bytes_total Request body bytes read, by route.\n"
+           "# TYPE http_server_request_body_bytes_total counter\n";
+    for (const RouteStats& r : stats.routes) {
+        series("http_server_request_body_bytes_total", r);
+        out.append("} ").append(std::to_string(r.request_bytes)) += '\n';
+    }
+    out += "# HELP http_server_response_body_bytes_total Response body bytes sent, by route.\n"
+           "# TYPE http_server_response_body_bytes_total counter\n";
+    for (const RouteStats& r : stats.routes) {
+        series("http_server_response_body_bytes_total", r);
+        out.append("} ").append(std::to_string(r.response_bytes)) += '\n';
+    }
+
+    out += "# HELP http_server_requests_in_flight Requests being served.\n"
+           "# TYPE http_server_requests_in_flight gauge\n"
+           "http_server_requests_in_flight " + std::to_string(stats.in_flight) + "\n"
+           "# HELP http_server_connections_accepted_total Connections accepted.\n"
+           "# TYPE http_server_connections_accepted_total counter\n"
+           "http_server_connections_accepted_total " + std::to_string(stats.accepted) + "\n"
+           "# HELP http_server_connections Open connections, by state.\n"
+           "# TYPE http_server_connections gauge\n"
+           "http_server_connections{state=\"new\"} " + std::to_string(stats.conns_new) + "\n"
+           "http_server_connections{state=\"active\"} " + std::to_string(stats.conns_active) + "\n"
+           "http_server_connections{state=\"idle\"} " + std::to_string(stats.conns_idle) + "\n";
+}
+
+HandlerFunc MetricsHandler(std::shared_ptr<const ServerMetrics> metrics) {
+    return [metrics = std::move(metrics)](ResponseWriter& w, const Request&) {
+        std::string body;
+        metrics->WritePrometheus(body);
+        w.Header()["Content-Type"] = "text/plain; version=0.0.4; charset=utf-8";
+        w.Write(body);
+    };
+}
+
+} // namespace gocxx::net::http
@@ -0,0 +1,202 @@
+#include <gocxx/net/http_parser.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GOCXX_HTTP_PARSER_SSE2 1
+#endif
+
+namespace gocxx::net::http {
+
+namespace {
+
+// tchar from RFC 9110 section 5.6.2: the characters allowed in methods and field names
+struct TokenTable {
+    bool allowed[256] = {};
+    constexpr TokenTable() {
+        for (int c = '0'; c <= '9'; ++c) allowed[c] = true;
+        for (int c = 'a'; c <= 'z'; ++c) allowed[c] = true;
+        for (int c = 'A'; c <= 'Z'; ++c) allowed[c] = true;
+        for (char c : std::string_view("!#$%&'*+-.^_`|~")) allowed[static_cast<unsigned char>(c)] = true;
+    }
+};
+constexpr TokenTable kToken;
+
+bool isToken(std::string_view s) {
+    if (s.empty()) return false;
+    for (char c : s) {
+        if (!kToken.allowed[static_cast<unsigned char>(c)]) return false;
+    }
+    return true;
+}
+
+inline char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Control characters other than HT, and DEL, are never allowed in the head; CR is left to stopAt
+inline bool isBadControl(unsigned char c) {
+    return (c < 0x20 && c != '\t' && c != '\r') || c == 0x7f;
+}
+
+// Whether the byte at i, a control character, ends the scan: LF, a bad
+// control, or CR not followed by LF. A CR in the last byte is left for the
+// next call, which sees what follows it.
+inline bool stopAt(const char* buf, std::size_t i, std::size_t size, bool& bad, std::size_t& resume) {
+    const unsigned char c = static_cast<unsigned char>(buf[i]);
+    if (c == '\n') return true;
+    if (c == '\r') {
+        if (i + 1 == size) {
+            resume = i;
+            return false;
+        }
+        bad = buf[i + 1] != '\n';
+        return bad;
+    }
+    bad = isBadControl(c);
+    return bad;
+}
+
+/**
+ * Offset of the first LF in buf[from, size), or size when there is none,
+ * with resume set to where the next call should start scanning; sets bad
+ * when a disallowed control character comes first.
+ */
+std::size_t findLineEnd(const char* buf, std::size_t from, std::size_t size, bool& bad, std::size_t& resume) {
+    resume = size;
+    std::size_t i = from;
+#ifdef GOCXX_HTTP_PARSER_SSE2
+    // Sixteen bytes at a time: only control characters (bytes <= 0x1f, and DEL) need a closer look
+    const __m128i ctl = _mm_set1_epi8(0x1f);
+    const __m128i del = _mm_set1_epi8(0x7f);
+    while (i + 16 <= size) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i));
+        const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(v, ctl), v), _mm_cmpeq_epi8(v, del));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        while (mask) {
+#if defined(__GNUC__) || defined(__clang__)
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+#else
+            unsigned bit = 0;
+            while (!(mask & (1u << bit))) ++bit;
+#endif
+            if (stopAt(buf, i + bit, size, bad, resume)) return i + bit;
+            mask &= mask - 1;  // HT, or CR before LF: keep going
+        }
+        i += 16;
+    }
+#endif
+    for (; i < size; ++i) {
+        const unsigned char c = static_cast<unsigned char>(buf[i]);
+        if ((c < 0x20 || c == 0x7f) && stopAt(buf, i, size, bad, resume)) return i;
+    }
+    return size;
+}
+
+} // namespace
+
+bool RequestParser::EqualFold(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (lower(a[i]) != lower(b[i])) return false;
+    }
+    return true;
+}
+
+const RequestParser::FieldSpan* RequestParser::find(std::string_view name) const {
+    for (std::size_t i = 0; i < num_headers_; ++i) {
+        if (EqualFold(slice(headers_[i].name), name)) return &headers_[i];
+    }
+    return nullptr;
+}
+
+std::string_view RequestParser::Header(std::string_view name) const {
+    const FieldSpan* field = find(name);
+    return field ? slice(field->value) : std::string_view();
+}
+
+bool RequestParser::HasHeader(std::string_view name) const {
+    return find(name) != nullptr;
+}
+
+RequestParser::Status RequestParser::Parse(std::string_view buf) {
+    base_ = buf.data();
+    while (stage_ != Stage::Done) {
+        bool bad = false;
+        std::size_t resume;
+        const std::size_t lf = findLineEnd(buf.data(), pos_ + scan_, buf.size(), bad, resume);
+        if (bad) return Status::Malformed;
+        if (lf == buf.size()) {
+            scan_ = resume - pos_;
+            return Status::Incomplete;
+        }
+
+        // The line without its LF, and without the CR before it
+        std::size_t end = lf;
+        if (end > pos_ && buf[end - 1] == '\r') --end;
+
+        Status status = stage_ == Stage::RequestLine ? parseRequestLine(pos_, end) : parseHeaderLine(pos_, end);
+        if (status != Status::Complete) return status;
+        pos_ = lf + 1;
+        scan_ = 0;
+    }
+    return Status::Complete;
+}
+
+// method SP request-target SP HTTP-version (RFC 9112 section 3)
+RequestParser::Status RequestParser::parseRequestLine(std::size_t begin, std::size_t end) {
+    if (begin == end) {
+        return Status::Complete;  // empty lines before the request line are ignored (section 2.2)
+    }
+    std::string_view line(base_ + begin, end - begin);
+    const std::size_t sp1 = line.find(' ');
+    if (sp1 == std::string_view::npos) return Status::Malformed;
+    const std::size_t sp2 = line.find(' ', sp1 + 1);
+    if (sp2 == std::string_view::npos) return Status::Malformed;
+
+    std::string_view method = line.substr(0, sp1);
+    std::string_view target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    std::string_view version = line.substr(sp2 + 1);
+    if (!isToken(method) || target.empty() || target.find_first_of(" \t") != std::string_view::npos) {
+        return Status::Malformed;
+    }
+    if (version.size() != 8 || version.compare(0, 7, "HTTP/1.") != 0 || (version[7] != '0' && version[7] != '1')) {
+        return Status::Malformed;
+    }
+
+    method_ = { static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(sp1) };
+    target_ = { static_cast<std::uint32_t>(begin + sp1 + 1), static_cast<std::uint32_t>(target.size()) };
+    minor_version_ = version[7] - '0';
+    stage_ = Stage::Headers;
+    return Status::Complete;
+}
+
+// field-name ":" OWS field-value OWS (RFC 9112 section 5)
+RequestParser::Status RequestParser::parseHeaderLine(std::size_t begin, std::size_t end) {
+    if (begin == end) {
+        stage_ = Stage::Done;
+        return Status::Complete;
+    }
+    if (base_[begin] == ' ' || base_[begin] == '\t') {
+        return Status::Malformed;  // obsolete line folding
+    }
+    std::string_view line(base_ + begin, end - begin);
+    const std::size_t colon = line.find(':');
+    if (colon == std::string_view::npos || !isToken(line.substr(0, colon))) {
+        return Status::Malformed;  // includes whitespace before the colon
+    }
+    if (num_headers_ == kMaxHeaders) {
+        return Status::TooManyHeaders;
+    }
+
+    std::size_t value_begin = colon + 1;
+    std::size_t value_end = line.size();
+    while (value_begin < value_end && (line[value_begin] == ' ' || line[value_begin] == '\t')) ++value_begin;
+    while (value_end > value_begin && (line[value_end - 1] == ' ' || line[value_end - 1] == '\t')) --value_end;
+
+    FieldSpan& field = headers_[num_headers_++];
+    field.name = { static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(colon) };
+    field.value = { static_cast<std::uint32_t>(begin + value_begin), static_cast<std::uint32_t>(value_end - value_begin) };
+    return Status::Complete;
+}
+
+} // namespace gocxx::net::http
@@ -4,10 +4,10 @@ namespace gocxx::net {
 
 // Common network errors
 std::shared_ptr<gocxx::errors::Error> ErrClosed = 
-    gocxx::errors::New("connection closed");
+    gocxx::errors::Sentinel("connection closed");
 std::shared_ptr<gocxx::errors::Error> ErrTimeout = 
-    gocxx::errors::New("i/o timeout");
+    gocxx::errors::Sentinel("i/o timeout");
 std::shared_ptr<gocxx::errors::Error> ErrInvalidAddr = 
-    gocxx::errors::New("invalid network address");
+    gocxx::errors::Sentinel("invalid network address");
 
 } // namespace gocxx::net
@@ -0,0 +1,355 @@
+#include <gocxx/net/detail/netpoll.h>
+#include <gocxx/net/net.h>
+
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <winsock2.h>
+#else
+    #include <fcntl.h>
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <unistd.h>
+    #if defined(__linux__)
+        #include <sys/epoll.h>
+        #define GOCXX_NETPOLL_EPOLL 1
+    #elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+        #include <sys/event.h>
+        #define GOCXX_NETPOLL_KQUEUE 1
+    #endif
+#endif
+
+namespace gocxx::net::detail {
+
+    namespace {
+        using Clock = std::chrono::system_clock;
+
+#if defined(GOCXX_NETPOLL_EPOLL) || defined(GOCXX_NETPOLL_KQUEUE)
+        /**
+         * @brief The process-wide epoll/kqueue instance and its thread.
+         *
+         * Registrations carry a token rather than a pointer; the thread looks
+         * tokens up in descs_, so a PollDesc destroyed while one of its
+         * events is in flight is simply not found. Leaked, like the timer
+         * service, so sockets closed during static destruction still work.
+         */
+        class Poller {
+        public:
+            static Poller* instance() {
+                static Poller* poller = [] {
+                    auto* p = new Poller();
+                    if (!p->init()) {
+                        delete p;
+                        return static_cast<Poller*>(nullptr);
+                    }
+                    std::thread([p] { p->loop(); }).detach();
+                    return p;
+                }();
+                return poller;
+            }
+
+            // Registers fd edge-triggered for both directions; 0 on failure.
+            std::uint64_t add(int fd, std::weak_ptr<PollDesc> pd) {
+                std::uint64_t token;
+                {
+                    std::lock_guard<std::mutex> lock(mu_);
+                    token = next_++;
+                    descs_.emplace(token, std::move(pd));
+                }
+#if defined(GOCXX_NETPOLL_EPOLL)
+                epoll_event ev{};
+                ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+                ev.data.u64 = token;
+                const bool ok = ::epoll_ctl(pfd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+#else
+                struct kevent changes[2];
+                EV_SET(&changes[0], fd, EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, reinterpret_cast<void*>(token));
+                EV_SET(&changes[1], fd, EVFILT_WRITE, EV_ADD | EV_CLEAR, 0, 0, reinterpret_cast<void*>(token));
+                const bool ok = ::kevent(pfd_, changes, 2, nullptr, 0, nullptr) == 0;
+#endif
+                if (!ok) {
+                    std::lock_guard<std::mutex> lock(mu_);
+                    descs_.erase(token);
+                    return 0;
+                }
+                return token;
+            }
+
+            // Must run while fd is still open, so a reused descriptor is never touched.
+            void remove(std::uint64_t token, int fd) {
+#if defined(GOCXX_NETPOLL_EPOLL)
+                ::epoll_ctl(pfd_, EPOLL_CTL_DEL, fd, nullptr);
+#else
+                struct kevent changes[2];
+                EV_SET(&changes[0], fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+                EV_SET(&changes[1], fd, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+                ::kevent(pfd_, changes, 2, nullptr, 0, nullptr);
+#endif
+                std::lock_guard<std::mutex> lock(mu_);
+                descs_.erase(token);
+            }
+
+        private:
+            static constexpr int kMaxEvents = 128;
+
+            bool init() {
+#if defined(GOCXX_NETPOLL_EPOLL)
+                pfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+#else
+                pfd_ = ::kqueue();
+                if (pfd_ >= 0) ::fcntl(pfd_, F_SETFD, FD_CLOEXEC);
+#endif
+                return pfd_ >= 0;
+            }
+
+            void loop() {
+                std::vector<std::shared_ptr<PollDesc>> targets(kMaxEvents);
+                bool readable[kMaxEvents];
+                bool writable[kMaxEvents];
+#if defined(GOCXX_NETPOLL_EPOLL)
+                epoll_event events[kMaxEvents];
+#else
+                struct kevent events[kMaxEvents];
+#endif
+                for (;;) {
+#if defined(GOCXX_NETPOLL_EPOLL)
+                    int n = ::epoll_wait(pfd_, events, kMaxEvents, -1);
+#else
+                    int n = ::kevent(pfd_, nullptr, 0, events, kMaxEvents, nullptr);
+#endif
+                    if (n < 0) {
+                        if (errno == EINTR) continue;
+                        return;
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(mu_);
+                        for (int i = 0; i < n; ++i) {
+#if defined(GOCXX_NETPOLL_EPOLL)
+                            const std::uint64_t token = events[i].data.u64;
+                            const uint32_t mask = events[i].events;
+                            readable[i] = (mask & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0;
+                            writable[i] = (mask & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0;
+#else
+                            const auto token = reinterpret_cast<std::uint64_t>(events[i].udata);
+                            readable[i] = events[i].filter == EVFILT_READ || (events[i].flags & (EV_EOF | EV_ERROR));
+                            writable[i] = events[i].filter == EVFILT_WRITE || (events[i].flags & (EV_EOF | EV_ERROR));
+#endif
+                            auto it = descs_.find(token);
+                            targets[i] = it == descs_.end() ? nullptr : it->second.lock();
+                        }
+                    }
+
+                    // Wake the waiters without holding the registry lock
+                    for (int i = 0; i < n; ++i) {
+                        if (targets[i]) {
+                            targets[i]->notify(readable[i], writable[i]);
+                            targets[i].reset();
+                        }
+                    }
+                }
+            }
+
+            int pfd_ = -1;
+            std::mutex mu_;
+            std::unordered_map<std::uint64_t, std::weak_ptr<PollDesc>> descs_;
+            std::uint64_t next_ = 1;
+        };
+#endif
+
+        bool noDeadline(Clock::time_point deadline) {
+            return deadline == Clock::time_point::max() || deadline == Clock::time_point{};
+        }
+
+        // SO_RCVTIMEO / SO_SNDTIMEO for sockets the poller does not handle; 0 clears.
+        void setSocketTimeout(int fd, PollDesc::Mode mode, std::chrono::milliseconds timeout) {
+            const int opt = mode == PollDesc::Read ? SO_RCVTIMEO : SO_SNDTIMEO;
+#ifdef _WIN32
+            DWORD ms = static_cast<DWORD>(timeout.count());
+            ::setsockopt(fd, SOL_SOCKET, opt, reinterpret_cast<const char*>(&ms), sizeof(ms));
+#else
+            struct timeval tv;
+            tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+            tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+            ::setsockopt(fd, SOL_SOCKET, opt, &tv, sizeof(tv));
+#endif
+        }
+    }
+
+    std::shared_ptr<PollDesc> PollDesc::Open(int fd) {
+        std::shared_ptr<PollDesc> pd(new PollDesc(fd));
+#if defined(GOCXX_NETPOLL_EPOLL) || defined(GOCXX_NETPOLL_KQUEUE)
+        const int flags = ::fcntl(fd, F_GETFL);
+        if (flags < 0) return pd;
+        Poller* poller = Poller::instance();
+        if (poller && ((flags & O_NONBLOCK) || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0)) {
+            pd->token_ = poller->add(fd, pd);
+        }
+        if (pd->token_ == 0) {
+            // Stay (or become, for an accept4 SOCK_NONBLOCK socket) a plain blocking socket
+            ::fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+        }
+#endif
+        return pd;
+    }
+
+    PollDesc::~PollDesc() {
+        auto& timers = time::detail::TimerService::instance();
+        for (auto& d : dirs_) {
+            if (d.timer) timers.stop(*d.timer);
+        }
+        // Never Close()d: nothing can be using the descriptor any more.
+        if ((refs_.load(std::memory_order_acquire) & kClosing) == 0) {
+#if defined(GOCXX_NETPOLL_EPOLL) || defined(GOCXX_NETPOLL_KQUEUE)
+            if (token_) Poller::instance()->remove(token_, fd_);
+#endif
+            closeFd();
+        }
+    }
+
+    std::shared_ptr<errors::Error> PollDesc::closedError() {
+        return ErrClosed;
+    }
+
+    std::shared_ptr<errors::Error> PollDesc::timeoutError() {
+        return ErrTimeout;
+    }
+
+    std::shared_ptr<errors::Error> PollDesc::Prepare(Mode mode) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (closing_) return ErrClosed;
+        if (dirs_[mode].expired) return ErrTimeout;
+        return nullptr;
+    }
+
+    std::shared_ptr<errors::Error> PollDesc::Wait(Mode mode) {
+        Direction& d = dirs_[mode];
+        std::unique_lock<std::mutex> lock(mtx_);
+        // Blocking socket: EAGAIN came from SO_RCVTIMEO/SO_SNDTIMEO
+        if (!Pollable()) return closing_ ? ErrClosed : ErrTimeout;
+        for (;;) {
+            if (closing_) return ErrClosed;
+            if (d.expired) return ErrTimeout;
+            if (d.ready) {
+                d.ready = false;
+                return nullptr;
+            }
+            gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+            d.cv.wait(lock);
+        }
+    }
+
+    void PollDesc::notify(bool readable, bool writable) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (readable) {
+            dirs_[Read].ready = true;
+            dirs_[Read].cv.notify_all();
+        }
+        if (writable) {
+            dirs_[Write].ready = true;
+            dirs_[Write].cv.notify_all();
+        }
+    }
+
+    void PollDesc::SetDeadline(Mode mode, Clock::time_point deadline) {
+        auto& timers = time::detail::TimerService::instance();
+        std::lock_guard<std::mutex> lock(mtx_);
+        Direction& d = dirs_[mode];
+        d.deadline = deadline;
+
+        std::chrono::nanoseconds left{0};
+        if (noDeadline(deadline)) {
+            d.when = 0;
+            d.expired = false;
+            if (d.timer) timers.stop(*d.timer);
+        } else if ((left = deadline - Clock::now()) <= std::chrono::nanoseconds::zero()) {
+            d.when = 0;
+            d.expired = true;
+            if (d.timer) timers.stop(*d.timer);
+            d.cv.notify_all();
+        } else {
+            d.expired = false;
+            d.when = time::detail::monotonicNs() + left.count();
+            if (!d.timer) {
+                std::weak_ptr<PollDesc> self = weak_from_this();
+                d.timer = std::make_shared<time::detail::TimerNode>([self, mode] {
+                    if (auto pd = self.lock()) pd->expire(mode);
+                });
+            }
+            timers.start(d.timer, d.when);
+        }
+
+        if (!Pollable()) {
+            // Round up so a short deadline does not become "no timeout"
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(left + std::chrono::milliseconds(1) -
+                                                                            std::chrono::nanoseconds(1));
+            setSocketTimeout(fd_, mode, d.when ? ms : std::chrono::milliseconds(d.expired ? 1 : 0));
+        }
+    }
+
+    void PollDesc::expire(Mode mode) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        Direction& d = dirs_[mode];
+        // A later SetDeadline may have moved or cleared it since the timer was armed
+        if (d.when != 0 && time::detail::monotonicNs() >= d.when) {
+            d.expired = true;
+            d.cv.notify_all();
+        }
+    }
+
+    bool PollDesc::Close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (closing_) return false;
+            closing_ = true;
+            auto& timers = time::detail::TimerService::instance();
+            for (auto& d : dirs_) {
+                d.cv.notify_all();
+                if (d.timer) timers.stop(*d.timer);
+            }
+        }
+        // Still open here: nothing closes it before kClosing is set below.
+#if defined(GOCXX_NETPOLL_EPOLL) || defined(GOCXX_NETPOLL_KQUEUE)
+        if (token_) Poller::instance()->remove(token_, fd_);
+#endif
+        if (!Pollable()) {
+            // Nothing to notify: shutting the socket down is what ends a blocked call
+#ifdef _WIN32
+            ::shutdown(fd_, SD_BOTH);
+#else
+            ::shutdown(fd_, SHUT_RDWR);
+#endif
+        }
+        const std::uint32_t before = refs_.fetch_or(kClosing, std::memory_order_acq_rel);
+        if ((before & ~kClosing) == 0) {
+            closeFd();
+        }
+        return true;
+    }
+
+    bool PollDesc::incRef() {
+        std::uint32_t v = refs_.load(std::memory_order_relaxed);
+        do {
+            if (v & kClosing) return false;
+        } while (!refs_.compare_exchange_weak(v, v + 1, std::memory_order_acquire, std::memory_order_relaxed));
+        return true;
+    }
+
+    void PollDesc::decRef() {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == (kClosing | 1)) {
+            closeFd();  // Close() ran while this operation was in progress
+        }
+    }
+
+    void PollDesc::closeFd() {
+#ifdef _WIN32
+        ::closesocket(fd_);
+#else
+        ::close(fd_);
+#endif
+    }
+
+} // namespace gocxx::net::detail
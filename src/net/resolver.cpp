@@ -0,0 +1,313 @@
+#include <gocxx/net/resolver.h>
+#include <gocxx/base/select.h>
+#include <gocxx/runtime/blocking.h>
+#include <gocxx/sync/singleflight.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <netdb.h>
+#endif
+
+namespace gocxx::net {
+
+namespace detail {
+
+/**
+ * What a Resolver shares with its in-flight lookups, which may outlive it:
+ * the cache, kept in least-recently-used order, and the lookups being
+ * waited on. epoch changes on Forget() and Clear(), so a lookup that
+ * started before either does not bring its answer back.
+ */
+struct ResolverState {
+    struct Entry {
+        gocxx::base::Result<std::vector<std::string>> result;
+        std::chrono::steady_clock::time_point expires;
+        bool refreshing = false;
+        std::list<std::string>::iterator lru;
+    };
+
+    std::mutex mu;
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru;  // most recently used first
+    std::uint64_t epoch = 0;
+    gocxx::sync::SingleFlight<std::string, std::vector<std::string>> flights;
+
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> shared{0};
+    std::atomic<std::uint64_t> refreshes{0};
+};
+
+} // namespace detail
+
+using detail::ResolverState;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The address as an IP literal, or empty when it is neither IPv4 nor IPv6
+std::string ipString(const sockaddr* sa) {
+    char ip[INET6_ADDRSTRLEN] = {};
+    if (sa->sa_family == AF_INET6) {
+        inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6*>(sa)->sin6_addr, ip, sizeof(ip));
+    } else if (sa->sa_family == AF_INET) {
+        inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in*>(sa)->sin_addr, ip, sizeof(ip));
+    }
+    return ip;
+}
+
+bool isIPLiteral(const std::string& host) {
+    unsigned char buf[sizeof(in6_addr)];
+    return inet_pton(AF_INET, host.c_str(), buf) == 1 || inet_pton(AF_INET6, host.c_str(), buf) == 1;
+}
+
+// getaddrinfo, in the order it gives the addresses (RFC 6724)
+gocxx::base::Result<Resolver::Answer> systemLookup(const std::string& host) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;  // one entry per address rather than one per socket type
+
+    addrinfo* result = nullptr;
+    int rc;
+    {
+        gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::Syscall);
+        rc = getaddrinfo(host.c_str(), nullptr, &hints, &result);
+    }
+    if (rc != 0) {
+        return {gocxx::errors::New("cannot resolve address: " + host)};
+    }
+
+    Resolver::Answer answer;
+    for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+        std::string ip = ipString(ai->ai_addr);
+        if (!ip.empty() && std::find(answer.addrs.begin(), answer.addrs.end(), ip) == answer.addrs.end()) {
+            answer.addrs.push_back(std::move(ip));
+        }
+    }
+    freeaddrinfo(result);
+    return {answer, nullptr};
+}
+
+void touch(ResolverState& s, ResolverState::Entry& e) {
+    s.lru.splice(s.lru.begin(), s.lru, e.lru);
+}
+
+void erase(ResolverState& s, const std::string& host) {
+    auto it = s.entries.find(host);
+    if (it != s.entries.end()) {
+        s.lru.erase(it->second.lru);
+        s.entries.erase(it);
+    }
+}
+
+/**
+ * Caches a lookup's result for keep. A failed refresh leaves the answer it
+ * meant to renew in place until that expires, rather than replace it with
+ * the failure.
+ */
+void store(ResolverState& s, const std::string& host, const gocxx::base::Result<std::vector<std::string>>& result,
+           std::chrono::nanoseconds keep, std::size_t max_entries, std::uint64_t epoch) {
+    std::lock_guard<std::mutex> lock(s.mu);
+    if (s.epoch != epoch) {
+        return;
+    }
+    auto it = s.entries.find(host);
+    if (it != s.entries.end() && result.Failed() && it->second.refreshing && it->second.result.Ok()) {
+        it->second.refreshing = false;
+        return;
+    }
+    if (keep.count() <= 0 || max_entries == 0) {
+        erase(s, host);
+        return;
+    }
+    if (it == s.entries.end()) {
+        s.lru.push_front(host);
+        it = s.entries.emplace(host, ResolverState::Entry{}).first;
+        it->second.lru = s.lru.begin();
+    } else {
+        touch(s, it->second);
+    }
+    it->second.result = result;
+    it->second.expires = Clock::now() + std::chrono::duration_cast<Clock::duration>(keep);
+    it->second.refreshing = false;
+    while (s.entries.size() > max_entries) {
+        s.entries.erase(s.lru.back());
+        s.lru.pop_back();
+    }
+}
+
+} // namespace
+
+Resolver::Resolver() : state_(std::make_shared<ResolverState>()) {}
+
+Resolver::~Resolver() = default;
+
+gocxx::base::Result<std::vector<std::string>> Resolver::LookupHost(
+    context::ContextPtr ctx, const std::string& host) {
+    if (host.empty()) {
+        return {{}, gocxx::errors::New("cannot resolve address: empty host")};
+    }
+    if (isIPLiteral(host)) {
+        return {{host}, nullptr};
+    }
+    if (ctx && ctx->Err().Failed()) {
+        return {{}, ctx->Err().err};
+    }
+
+    ResolverState& s = *state_;
+    std::uint64_t epoch;
+    bool refresh = false;
+    {
+        std::lock_guard<std::mutex> lock(s.mu);
+        epoch = s.epoch;
+        auto it = s.entries.find(host);
+        if (it != s.entries.end()) {
+            const auto now = Clock::now();
+            ResolverState::Entry& e = it->second;
+            if (now < e.expires) {
+                touch(s, e);
+                s.hits.fetch_add(1, std::memory_order_relaxed);
+                if (e.result.Ok() && !e.refreshing && refresh_ahead.count() > 0 &&
+                    e.expires - now <= std::chrono::duration_cast<Clock::duration>(refresh_ahead)) {
+                    e.refreshing = true;
+                    refresh = true;
+                }
+                if (!refresh) {
+                    return e.result;
+                }
+            } else {
+                erase(s, host);
+            }
+        }
+    }
+
+    // The lookup captures its settings and the shared state, not this
+    auto fetch = [state = state_, lookup = lookup, ttl = ttl, negative_ttl = negative_ttl,
+                  max_entries = max_entries, host, epoch]() -> gocxx::base::Result<std::vector<std::string>> {
+        auto answer = lookup ? lookup(host) : systemLookup(host);
+        gocxx::base::Result<std::vector<std::string>> result;
+        std::chrono::nanoseconds keep = negative_ttl;
+        if (answer.Failed()) {
+            result = {{}, answer.err};
+        } else if (answer.value.addrs.empty()) {
+            result = {{}, gocxx::errors::New("cannot resolve address: " + host)};
+        } else {
+            keep = answer.value.ttl.count() > 0 ? answer.value.ttl : ttl;
+            result = {std::move(answer.value.addrs), nullptr};
+        }
+        store(*state, host, result, keep, max_entries, epoch);
+        return result;
+    };
+
+    if (refresh) {
+        // Served from the cache; the renewed answer lands there for later lookups
+        s.refreshes.fetch_add(1, std::memory_order_relaxed);
+        s.flights.DoChan(host, fetch);
+        std::lock_guard<std::mutex> lock(s.mu);
+        auto it = s.entries.find(host);
+        if (it != s.entries.end()) {
+            return it->second.result;
+        }
+        // Forgotten in the meantime: wait like any miss
+    }
+
+    s.misses.fetch_add(1, std::memory_order_relaxed);
+    auto ch = s.flights.DoChan(host, std::move(fetch));
+    gocxx::sync::FlightResult<std::vector<std::string>> flight;
+    if (!ctx) {
+        flight = std::move(*ch.recv());
+    } else {
+        bool done = false;
+        auto ctx_done = ctx->Done();
+        gocxx::base::select(
+            gocxx::base::recvCase(ch, [&](std::optional<gocxx::sync::FlightResult<std::vector<std::string>>> v) {
+                flight = std::move(*v);
+                done = true;
+            }),
+            gocxx::base::recvCase(ctx_done, [](std::optional<bool>) {}));
+        if (!done) {
+            return {{}, ctx->Err().err};
+        }
+    }
+    if (flight.shared) {
+        s.shared.fetch_add(1, std::memory_order_relaxed);
+    }
+    return {flight.value, flight.err};
+}
+
+gocxx::base::Result<std::vector<std::string>> Resolver::LookupIP(
+    context::ContextPtr ctx, const std::string& network, const std::string& host) {
+    std::string base = network;
+    char family = '\0';
+    if (!base.empty() && (base.back() == '4' || base.back() == '6')) {
+        family = base.back();
+        base.pop_back();
+    }
+    if (base != "ip" && base != "tcp" && base != "udp") {
+        return {{}, gocxx::errors::New("unsupported network type: " + network)};
+    }
+    auto ips = LookupHost(std::move(ctx), host);
+    if (ips.Failed() || !family) {
+        return ips;
+    }
+    std::vector<std::string> kept;
+    for (auto& ip : ips.value) {
+        if ((ip.find(':') != std::string::npos) == (family == '6')) {
+            kept.push_back(std::move(ip));
+        }
+    }
+    if (kept.empty()) {
+        return {{}, gocxx::errors::New("no suitable address found for " + host)};
+    }
+    return {kept, nullptr};
+}
+
+void Resolver::Forget(const std::string& host) {
+    std::lock_guard<std::mutex> lock(state_->mu);
+    ++state_->epoch;
+    erase(*state_, host);
+    state_->flights.Forget(host);
+}
+
+void Resolver::Clear() {
+    std::lock_guard<std::mutex> lock(state_->mu);
+    ++state_->epoch;
+    for (const auto& e : state_->entries) {
+        state_->flights.Forget(e.first);
+    }
+    state_->entries.clear();
+    state_->lru.clear();
+}
+
+ResolverStats Resolver::Stats() const {
+    ResolverStats stats;
+    stats.hits = state_->hits.load(std::memory_order_relaxed);
+    stats.misses = state_->misses.load(std::memory_order_relaxed);
+    stats.shared = state_->shared.load(std::memory_order_relaxed);
+    stats.refreshes = state_->refreshes.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(state_->mu);
+    stats.entries = state_->entries.size();
+    return stats;
+}
+
+std::shared_ptr<Resolver> DefaultResolver() {
+    static const std::shared_ptr<Resolver> resolver = std::make_shared<Resolver>();
+    return resolver;
+}
+
+} // namespace gocxx::net
@@ -0,0 +1,315 @@
+#include <gocxx/net/http.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace gocxx::net::http {
+
+namespace detail {
+
+// A registered pattern, stored at the node where its path ends
+struct Route {
+    std::string method;              // empty: every method
+    std::vector<std::string> names;  // one per captured segment, in path order; "" for a bare trailing slash
+    HandlerFunc handler;
+    std::string pattern;
+};
+
+/**
+ * One edge of the radix tree. path is the literal bytes this node adds to
+ * its parent's, shared by everything below; children are the literal
+ * continuations, one per distinct first byte (listed in indices). param
+ * matches one segment and wildcard the rest of the path; both only hang
+ * off nodes whose path ends in '/'.
+ */
+struct RouteNode {
+    std::string path;
+    std::string indices;
+    std::vector<std::unique_ptr<RouteNode>> children;
+    std::unique_ptr<RouteNode> param;
+    std::unique_ptr<RouteNode> wildcard;
+    std::vector<Route> routes;
+};
+
+} // namespace detail
+
+using detail::Route;
+using detail::RouteNode;
+
+std::string_view Request::PathValue(std::string_view name) const {
+    if (!path_names_ || name.empty()) {
+        return {};
+    }
+    for (std::size_t i = 0; i < path_names_->size(); ++i) {
+        if ((*path_names_)[i] == name) {
+            return std::string_view(url).substr(path_values_[i].off, path_values_[i].len);
+        }
+    }
+    return {};
+}
+
+namespace {
+
+[[noreturn]] void invalidPattern(const std::string& pattern, const std::string& why) {
+    throw std::invalid_argument("http: pattern \"" + pattern + "\": " + why);
+}
+
+bool isMethodToken(std::string_view s) {
+    return !s.empty() && std::all_of(s.begin(), s.end(), [](char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+    });
+}
+
+bool isName(std::string_view s) {
+    return !s.empty() && std::all_of(s.begin(), s.end(), [](char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+    });
+}
+
+// The node reached by adding the literal s below n, splitting edges as needed
+RouteNode* insertLiteral(RouteNode* n, std::string_view s) {
+    while (!s.empty()) {
+        const std::size_t i = n->indices.find(s[0]);
+        if (i == std::string::npos) {
+            auto child = std::make_unique<RouteNode>();
+            child->path.assign(s.data(), s.size());
+            n->indices.push_back(s[0]);
+            n->children.push_back(std::move(child));
+            return n->children.back().get();
+        }
+        RouteNode* child = n->children[i].get();
+        std::size_t common = 0;
+        while (common < child->path.size() && common < s.size() && child->path[common] == s[common]) {
+            ++common;
+        }
+        if (common < child->path.size()) {
+            // Split the edge: a new node for the shared part, the old one below it
+            auto mid = std::make_unique<RouteNode>();
+            mid->path = child->path.substr(0, common);
+            auto old = std::move(n->children[i]);
+            old->path.erase(0, common);
+            mid->indices.push_back(old->path[0]);
+            mid->children.push_back(std::move(old));
+            n->children[i] = std::move(mid);
+            child = n->children[i].get();
+        }
+        n = child;
+        s.remove_prefix(common);
+    }
+    return n;
+}
+
+// The route at n serving method: an exact method, GET for HEAD, then any method
+const Route* routeFor(const RouteNode* n, std::string_view method) {
+    const Route* get = nullptr;
+    const Route* any = nullptr;
+    for (const Route& r : n->routes) {
+        if (r.method == method) return &r;
+        if (r.method.empty()) any = &r;
+        else if (r.method == "GET" && method == "HEAD") get = &r;
+    }
+    return get ? get : any;
+}
+
+// Offset and length of a captured segment in the routed path
+struct Capture {
+    std::uint32_t off;
+    std::uint32_t len;
+};
+
+struct Match {
+    std::string_view method;
+    const Route* route = nullptr;
+    const RouteNode* other_methods = nullptr;  // first node whose path matched, for 405
+    Capture values[Request::kMaxPathValues];
+    std::size_t depth = 0;
+};
+
+bool endAt(const RouteNode* n, Match& m) {
+    if (n->routes.empty()) return false;
+    if (const Route* r = routeFor(n, m.method)) {
+        m.route = r;
+        return true;
+    }
+    if (!m.other_methods) m.other_methods = n;
+    return false;
+}
+
+bool matchWildcard(const RouteNode* n, std::string_view path, std::size_t pos, Match& m) {
+    if (!n->wildcard || m.depth == Request::kMaxPathValues) return false;
+    m.values[m.depth++] = { static_cast<std::uint32_t>(pos), static_cast<std::uint32_t>(path.size() - pos) };
+    if (endAt(n->wildcard.get(), m)) return true;
+    --m.depth;
+    return false;
+}
+
+// Matches path[pos:] below n, whose own path has already been consumed
+bool matchBelow(const RouteNode* n, std::string_view path, std::size_t pos, Match& m) {
+    if (pos == path.size() && endAt(n, m)) {
+        return true;
+    }
+    if (pos < path.size()) {
+        // Literal continuation
+        const std::size_t i = n->indices.find(path[pos]);
+        if (i != std::string::npos) {
+            const RouteNode* child = n->children[i].get();
+            if (path.compare(pos, child->path.size(), child->path) == 0 &&
+                matchBelow(child, path, pos + child->path.size(), m)) {
+                return true;
+            }
+        }
+        // One segment
+        if (n->param && m.depth < Request::kMaxPathValues) {
+            std::size_t end = path.find('/', pos);
+            if (end == std::string_view::npos) end = path.size();
+            if (end > pos) {
+                m.values[m.depth++] = { static_cast<std::uint32_t>(pos), static_cast<std::uint32_t>(end - pos) };
+                if (matchBelow(n->param.get(), path, end, m)) return true;
+                --m.depth;
+            }
+        }
+    }
+    // The rest of the path, possibly empty
+    return matchWildcard(n, path, pos, m);
+}
+
+} // namespace
+
+ServeMux::ServeMux() : root_(std::make_unique<RouteNode>()) {}
+
+ServeMux::~ServeMux() = default;
+
+void ServeMux::HandleFunc(const std::string& pattern, HandlerFunc handler) {
+    std::string_view rest(pattern);
+    Route route;
+    route.pattern = pattern;
+    route.handler = std::move(handler);
+
+    const std::size_t space = rest.find_first_of(" \t");
+    if (space != std::string_view::npos) {
+        std::string_view method = rest.substr(0, space);
+        if (!isMethodToken(method)) invalidPattern(pattern, "bad method");
+        route.method.assign(method.data(), method.size());
+        rest.remove_prefix(space);
+        while (!rest.empty() && (rest[0] == ' ' || rest[0] == '\t')) rest.remove_prefix(1);
+    }
+    if (rest.empty() || rest[0] != '/') invalidPattern(pattern, "path must start with '/'");
+
+    // Walk the segments: literal runs go into the tree as they are, each
+    // {name} hangs off a param edge and {name...} or a trailing slash off a wildcard edge
+    RouteNode* n = root_.get();
+    std::size_t literal = 0;  // start of the pending literal run in rest
+    std::size_t pos = 1;
+    bool exact = false;   // {$}
+    bool subtree = false; // {name...} or a trailing slash
+    while (pos <= rest.size()) {
+        std::size_t end = rest.find('/', pos);
+        if (end == std::string_view::npos) end = rest.size();
+        std::string_view segment = rest.substr(pos, end - pos);
+        const bool last = end == rest.size();
+
+        if (!segment.empty() && segment.front() == '{') {
+            if (segment.back() != '}') invalidPattern(pattern, "bad wildcard segment");
+            std::string_view name = segment.substr(1, segment.size() - 2);
+            n = insertLiteral(n, rest.substr(literal, pos - literal));
+            if (name == "$") {
+                if (!last) invalidPattern(pattern, "{$} not at end");
+                exact = true;
+                literal = pos = end;
+                break;
+            }
+            const bool rest_of_path = name.size() > 3 && name.compare(name.size() - 3, 3, "...") == 0;
+            if (rest_of_path) name.remove_suffix(3);
+            if (!isName(name)) invalidPattern(pattern, "bad wildcard name");
+            if (std::find(route.names.begin(), route.names.end(), name) != route.names.end()) {
+                invalidPattern(pattern, "duplicate wildcard name");
+            }
+            if (route.names.size() == Request::kMaxPathValues) invalidPattern(pattern, "too many wildcards");
+            route.names.emplace_back(name);
+            if (rest_of_path) {
+                if (!last) invalidPattern(pattern, "{...} wildcard not at end");
+                if (!n->wildcard) n->wildcard = std::make_unique<RouteNode>();
+                n = n->wildcard.get();
+                subtree = true;
+                literal = pos = end;
+                break;
+            }
+            if (!n->param) n->param = std::make_unique<RouteNode>();
+            n = n->param.get();
+            literal = end;
+        } else if (segment.find_first_of("{}") != std::string_view::npos) {
+            invalidPattern(pattern, "wildcards must be whole segments");
+        }
+        pos = end + 1;
+    }
+    if (!exact && !subtree) {
+        n = insertLiteral(n, rest.substr(literal));
+        if (rest.back() == '/') {
+            // "/dir/" serves everything below it
+            if (route.names.size() == Request::kMaxPathValues) invalidPattern(pattern, "too many wildcards");
+            route.names.emplace_back();
+            if (!n->wildcard) n->wildcard = std::make_unique<RouteNode>();
+            n = n->wildcard.get();
+        }
+    }
+
+    for (const Route& existing : n->routes) {
+        if (existing.method == route.method) {
+            invalidPattern(pattern, "conflicts with \"" + existing.pattern + "\"");
+        }
+    }
+    n->routes.push_back(std::move(route));
+}
+
+void ServeMux::ServeHTTP(ResponseWriter& w, const Request& req) {
+    // Route on the path alone: drop the query and an absolute-form scheme and host
+    std::string_view path(req.url);
+    std::size_t begin = 0;
+    if (path.compare(0, 7, "http://") == 0 || path.compare(0, 8, "https://") == 0) {
+        begin = path.find('/', path.find("//") + 2);
+        if (begin == std::string_view::npos) begin = path.size();
+    }
+    std::size_t end = path.find('?', begin);
+    if (end == std::string_view::npos) end = path.size();
+    // Offsets stay relative to req.url so PathValue can slice it
+    std::string_view routed = path.substr(0, end);
+
+    Match m;
+    m.method = req.method;
+    bool found = false;
+    if (begin < routed.size() && routed[begin] == '/') {
+        found = matchBelow(root_.get(), routed, begin, m);
+    }
+
+    if (found) {
+        req.path_names_ = &m.route->names;
+        req.pattern_ = &m.route->pattern;
+        for (std::size_t i = 0; i < m.depth; ++i) {
+            req.path_values_[i] = { m.values[i].off, m.values[i].len };
+        }
+        m.route->handler(w, req);
+        req.path_names_ = nullptr;
+        return;
+    }
+
+    if (m.other_methods) {
+        std::string allow;
+        bool has_get = false;
+        bool has_head = false;
+        for (const Route& r : m.other_methods->routes) {
+            has_get |= r.method == "GET";
+            has_head |= r.method == "HEAD";
+            allow += (allow.empty() ? "" : ", ") + r.method;
+        }
+        if (has_get && !has_head) allow += ", HEAD";
+        w.Header()["Allow"] = allow;
+        w.WriteHeader(StatusMethodNotAllowed);
+        w.Write("405 method not allowed\n");
+        return;
+    }
+
+    // 404 Not Found
+    w.WriteHeader(StatusNotFound);
+    w.Write("404 page not found\n");
+}
+
+} // namespace gocxx::net::http
@@ -1,7 +1,17 @@
 #include <gocxx/net/tcp.h>
+#include <gocxx/net/resolver.h>
 #include <sstream>
 #include <cstring>
 #include <algorithm>
+#include <gocxx/net/detail/netpoll.h>
+#include <gocxx/runtime/blocking.h>
+#include <gocxx/runtime/runtime.h>
+#include <gocxx/base/select.h>
+#include <gocxx/time/timer.h>
+#include <gocxx/io/io_errors.h>
+#include <functional>
+#include <vector>
+#include <stdexcept>
 
 // Platform-specific includes
 #ifdef _WIN32
@@ -81,7 +91,7 @@ static std::shared_ptr<gocxx::errors::Error> socketErrorToError(int err_code) {
     #endif
 }
 
-// Helper to parse address into host and port
+// Helper to parse address into host and port; an IPv6 host is bracketed ("[::1]:80")
 static bool parseAddress(const std::string& address, std::string& host, int& port) {
     size_t colon_pos = address.rfind(':');
     if (colon_pos == std::string::npos) {
@@ -90,6 +100,14 @@ static bool parseAddress(const std::string& address, std::string& host, int& por
     
     host = address.substr(0, colon_pos);
     std::string port_str = address.substr(colon_pos + 1);
+    if (!host.empty() && host.front() == '[') {
+        if (host.back() != ']') {
+            return false;
+        }
+        host = host.substr(1, host.size() - 2);
+    } else if (host.find(':') != std::string::npos) {
+        return false;  // too many colons: an IPv6 literal needs brackets
+    }
     
     // Handle empty host (means listen on all interfaces)
     if (host.empty()) {
@@ -110,35 +128,100 @@ static bool parseAddress(const std::string& address, std::string& host, int& por
 
 // TCPAddr implementation
 std::string TCPAddr::String() const {
+    if (ip.find(':') != std::string::npos) {
+        return "[" + ip + "]:" + std::to_string(port);
+    }
     return ip + ":" + std::to_string(port);
 }
 
+// A socket address of either family
+struct SockAddr {
+    sockaddr_storage storage{};
+    socklen_t len = 0;
+
+    int family() const { return storage.ss_family; }
+    sockaddr* get() { return reinterpret_cast<sockaddr*>(&storage); }
+};
+
+// Fills out from an IP literal; false if ip is not one
+static bool toSockAddr(const std::string& ip, int port, SockAddr& out) {
+    out = SockAddr();
+    if (ip.find(':') != std::string::npos) {
+        auto* in6 = reinterpret_cast<sockaddr_in6*>(&out.storage);
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(static_cast<uint16_t>(port));
+        out.len = sizeof(sockaddr_in6);
+        return inet_pton(AF_INET6, ip.c_str(), &in6->sin6_addr) == 1;
+    }
+    auto* in4 = reinterpret_cast<sockaddr_in*>(&out.storage);
+    in4->sin_family = AF_INET;
+    in4->sin_port = htons(static_cast<uint16_t>(port));
+    out.len = sizeof(sockaddr_in);
+    return inet_pton(AF_INET, ip.c_str(), &in4->sin_addr) == 1;
+}
+
+static std::shared_ptr<TCPAddr> fromSockAddr(sockaddr_storage& ss) {
+    char ip[INET6_ADDRSTRLEN] = {};
+    if (ss.ss_family == AF_INET6) {
+        auto* in6 = reinterpret_cast<sockaddr_in6*>(&ss);
+        inet_ntop(AF_INET6, &in6->sin6_addr, ip, sizeof(ip));
+        return std::make_shared<TCPAddr>(ip, ntohs(in6->sin6_port));
+    }
+    auto* in4 = reinterpret_cast<sockaddr_in*>(&ss);
+    inet_ntop(AF_INET, &in4->sin_addr, ip, sizeof(ip));
+    return std::make_shared<TCPAddr>(ip, ntohs(in4->sin_port));
+}
+
+// Whether an IP literal suits network: "tcp4" only IPv4, "tcp6" only IPv6
+static bool familyAllowed(const std::string& network, const std::string& ip) {
+    const bool v6 = ip.find(':') != std::string::npos;
+    return network == "tcp" || (network == "tcp4" && !v6) || (network == "tcp6" && v6);
+}
+
+// The host's addresses as IP literals in order of preference, through the caching DefaultResolver
+static gocxx::base::Result<std::vector<std::string>> lookupHost(
+    const std::string& network, const std::string& host, context::ContextPtr ctx = nullptr) {
+    return DefaultResolver()->LookupIP(std::move(ctx), network, host);
+}
+
+// Drops the first n bytes of bufs, after a partial vectored write
+static void consumeBuffers(gocxx::io::Buffers& bufs, std::size_t n) {
+    std::size_t done = 0;
+    while (done < bufs.size() && n >= bufs[done].size) {
+        n -= bufs[done].size;
+        ++done;
+    }
+    bufs.erase(bufs.begin(), bufs.begin() + static_cast<std::ptrdiff_t>(done));
+    if (n > 0) {
+        bufs.front().data += n;
+        bufs.front().size -= n;
+    }
+}
+
 // TCPConn implementation
 TCPConn::TCPConn(int socket_fd, std::shared_ptr<TCPAddr> local, std::shared_ptr<TCPAddr> remote)
-    : socket_fd_(socket_fd), local_addr_(local), remote_addr_(remote), closed_(false) {
-    read_deadline_ = std::chrono::system_clock::time_point::max();
-    write_deadline_ = std::chrono::system_clock::time_point::max();
-}
+    : TCPConn(detail::PollDesc::Open(socket_fd), std::move(local), std::move(remote)) {}
+
+TCPConn::TCPConn(std::shared_ptr<detail::PollDesc> pd, std::shared_ptr<TCPAddr> local, std::shared_ptr<TCPAddr> remote)
+    : socket_fd_(pd->Fd()), local_addr_(std::move(local)), remote_addr_(std::move(remote)), pd_(std::move(pd)) {}
 
 TCPConn::~TCPConn() {
-    if (!closed_) {
-        close();
-    }
+    close();
 }
 
 gocxx::base::Result<std::size_t> TCPConn::Read(uint8_t* buffer, std::size_t size) {
-    if (closed_) {
-        return {0, ErrClosed};
-    }
-    
-    // TODO: Handle read deadline with select/poll
-    
-    #ifdef _WIN32
-    int result = recv(socket_fd_, reinterpret_cast<char*>(buffer), static_cast<int>(size), 0);
-    #else
-    ssize_t result = recv(socket_fd_, buffer, size, 0);
-    #endif
+    std::shared_ptr<gocxx::errors::Error> err;
+    long result = pd_->Io(detail::PollDesc::Read, [&]() -> long {
+        #ifdef _WIN32
+        return recv(socket_fd_, reinterpret_cast<char*>(buffer), static_cast<int>(size), 0);
+        #else
+        return static_cast<long>(recv(socket_fd_, buffer, size, 0));
+        #endif
+    }, err);
     
+    if (err) {
+        return {0, err};
+    }
     if (result < 0) {
         return {0, socketErrorToError(SOCKET_ERROR_CODE)};
     }
@@ -152,30 +235,180 @@ gocxx::base::Result<std::size_t> TCPConn::Read(uint8_t* buffer, std::size_t size
 }
 
 gocxx::base::Result<std::size_t> TCPConn::Write(const uint8_t* buffer, std::size_t size) {
-    if (closed_) {
+    // Like Go, keep sending until all of buffer is written or an error occurs
+    std::size_t total = 0;
+    do {
+        std::shared_ptr<gocxx::errors::Error> err;
+        long result = pd_->Io(detail::PollDesc::Write, [&]() -> long {
+            #ifdef _WIN32
+            return send(socket_fd_, reinterpret_cast<const char*>(buffer + total), static_cast<int>(size - total), 0);
+            #else
+            return static_cast<long>(send(socket_fd_, buffer + total, size - total, MSG_NOSIGNAL));
+            #endif
+        }, err);
+        
+        if (err) {
+            return {total, err};
+        }
+        if (result < 0) {
+            return {total, socketErrorToError(SOCKET_ERROR_CODE)};
+        }
+        if (result == 0) {
+            break;
+        }
+        total += static_cast<std::size_t>(result);
+    } while (total < size);
+    
+    if (total < size) {
+        return {total, gocxx::io::ErrShortWrite};
+    }
+    return {total, nullptr};
+}
+
+gocxx::base::Result<std::size_t> TCPConn::WriteBuffers(const gocxx::io::Buffers& bufs) {
+    detail::PollDesc::Op op(*pd_);
+    if (!op) {
         return {0, ErrClosed};
     }
-    
-    // TODO: Handle write deadline with select/poll
-    
+
     #ifdef _WIN32
-    int result = send(socket_fd_, reinterpret_cast<const char*>(buffer), static_cast<int>(size), 0);
+    std::vector<WSABUF> wsabufs;
+    wsabufs.reserve(bufs.size());
+    for (const auto& b : bufs) {
+        if (b.size != 0) {
+            wsabufs.push_back({static_cast<ULONG>(b.size), reinterpret_cast<CHAR*>(const_cast<uint8_t*>(b.data))});
+        }
+    }
+    if (wsabufs.empty()) {
+        return {0, nullptr};
+    }
+    if (auto err = pd_->Prepare(detail::PollDesc::Write)) {
+        return {0, err};
+    }
+    gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+    DWORD sent = 0;
+    if (WSASend(socket_fd_, wsabufs.data(), static_cast<DWORD>(wsabufs.size()), &sent, 0, nullptr, nullptr) != 0) {
+        return {0, socketErrorToError(SOCKET_ERROR_CODE)};
+    }
+    std::size_t total = sent;
     #else
-    ssize_t result = send(socket_fd_, buffer, size, MSG_NOSIGNAL);
+    gocxx::io::Buffers rest = bufs;
+    std::size_t total = 0;
+    for (;;) {
+        if (auto err = pd_->Prepare(detail::PollDesc::Write)) {
+            return {total, err};
+        }
+        int errnum = 0;
+        const std::size_t sent = gocxx::io::detail::fdWriteBuffers(socket_fd_, rest, true, errnum);
+        total += sent;
+        if (errnum == 0) {
+            break;
+        }
+        if (errnum != EAGAIN && errnum != EWOULDBLOCK) {
+            return {total, socketErrorToError(errnum)};
+        }
+        // Socket buffer full: wait for room, then send what is left
+        consumeBuffers(rest, sent);
+        if (auto err = pd_->Wait(detail::PollDesc::Write)) {
+            return {total, err};
+        }
+    }
     #endif
-    
+
+    if (total < gocxx::io::detail::totalSize(bufs)) {
+        return {total, gocxx::io::ErrShortWrite};
+    }
+    return {total, nullptr};
+}
+
+gocxx::base::Result<std::size_t> TCPConn::ReadBuffers(const gocxx::io::MutableBuffers& bufs) {
+    #ifdef _WIN32
+    std::vector<WSABUF> wsabufs;
+    wsabufs.reserve(bufs.size());
+    for (const auto& b : bufs) {
+        if (b.size != 0) {
+            wsabufs.push_back({static_cast<ULONG>(b.size), reinterpret_cast<CHAR*>(b.data)});
+        }
+    }
+    if (wsabufs.empty()) {
+        return {0, nullptr};
+    }
+    std::shared_ptr<gocxx::errors::Error> err;
+    long result = pd_->Io(detail::PollDesc::Read, [&]() -> long {
+        DWORD received = 0;
+        DWORD flags = 0;
+        if (WSARecv(socket_fd_, wsabufs.data(), static_cast<DWORD>(wsabufs.size()), &received, &flags, nullptr, nullptr) != 0) {
+            return -1;
+        }
+        return static_cast<long>(received);
+    }, err);
+    if (err) {
+        return {0, err};
+    }
     if (result < 0) {
         return {0, socketErrorToError(SOCKET_ERROR_CODE)};
     }
-    
+    #else
+    bool any = false;
+    for (const auto& b : bufs) {
+        any = any || b.size != 0;
+    }
+    if (!any) {
+        return {0, nullptr};
+    }
+    int errnum = 0;
+    std::shared_ptr<gocxx::errors::Error> err;
+    long result = pd_->Io(detail::PollDesc::Read, [&]() -> long {
+        long n = gocxx::io::detail::fdReadBuffers(socket_fd_, bufs, true, errnum);
+        if (n < 0) {
+            errno = errnum;
+        }
+        return n;
+    }, err);
+    if (err) {
+        return {0, err};
+    }
+    if (result < 0) {
+        return {0, socketErrorToError(errnum)};
+    }
+    #endif
+
+    if (result == 0) {
+        // Connection closed by peer
+        return {0, ErrClosed};
+    }
     return {static_cast<std::size_t>(result), nullptr};
 }
 
-void TCPConn::close() {
-    if (!closed_) {
-        SOCKET_CLOSE(socket_fd_);
-        closed_ = true;
+gocxx::base::Result<std::size_t> TCPConn::WriteTo(std::shared_ptr<gocxx::io::Writer> w) {
+    // Held for the whole copy; EAGAIN inside it parks through WaitFd
+    detail::PollDesc::Op op(*pd_);
+    if (!op) {
+        return {0, ErrClosed};
+    }
+    if (auto err = pd_->Prepare(detail::PollDesc::Read)) {
+        return {0, err};
     }
+    return gocxx::io::detail::fdWriteTo(socket_fd_, *this, std::move(w));
+}
+
+gocxx::base::Result<std::size_t> TCPConn::ReadFrom(std::shared_ptr<gocxx::io::Reader> r) {
+    detail::PollDesc::Op op(*pd_);
+    if (!op) {
+        return {0, ErrClosed};
+    }
+    if (auto err = pd_->Prepare(detail::PollDesc::Write)) {
+        return {0, err};
+    }
+    return gocxx::io::detail::fdReadFrom(socket_fd_, *this, std::move(r));
+}
+
+std::shared_ptr<gocxx::errors::Error> TCPConn::WaitFd(bool write) {
+    return pd_->Wait(write ? detail::PollDesc::Write : detail::PollDesc::Read);
+}
+
+void TCPConn::close() {
+    pd_->Close();
 }
 
 std::shared_ptr<Addr> TCPConn::LocalAddr() {
@@ -187,26 +420,24 @@ std::shared_ptr<Addr> TCPConn::RemoteAddr() {
 }
 
 gocxx::base::Result<void> TCPConn::SetReadDeadline(std::chrono::system_clock::time_point deadline) {
-    read_deadline_ = deadline;
-    // TODO: Implement actual deadline setting with socket options
+    pd_->SetDeadline(detail::PollDesc::Read, deadline);
     return {};
 }
 
 gocxx::base::Result<void> TCPConn::SetWriteDeadline(std::chrono::system_clock::time_point deadline) {
-    write_deadline_ = deadline;
-    // TODO: Implement actual deadline setting with socket options
+    pd_->SetDeadline(detail::PollDesc::Write, deadline);
     return {};
 }
 
 gocxx::base::Result<void> TCPConn::SetDeadline(std::chrono::system_clock::time_point deadline) {
-    read_deadline_ = deadline;
-    write_deadline_ = deadline;
-    // TODO: Implement actual deadline setting with socket options
+    pd_->SetDeadline(detail::PollDesc::Read, deadline);
+    pd_->SetDeadline(detail::PollDesc::Write, deadline);
     return {};
 }
 
 gocxx::base::Result<void> TCPConn::CloseRead() {
-    if (closed_) {
+    detail::PollDesc::Op op(*pd_);
+    if (!op) {
         return {ErrClosed};
     }
     
@@ -222,7 +453,8 @@ gocxx::base::Result<void> TCPConn::CloseRead() {
 }
 
 gocxx::base::Result<void> TCPConn::CloseWrite() {
-    if (closed_) {
+    detail::PollDesc::Op op(*pd_);
+    if (!op) {
         return {ErrClosed};
     }
     
@@ -239,52 +471,61 @@ gocxx::base::Result<void> TCPConn::CloseWrite() {
 
 // TCPListener implementation
 TCPListener::TCPListener(int socket_fd, std::shared_ptr<TCPAddr> local_addr)
-    : socket_fd_(socket_fd), local_addr_(local_addr), closed_(false) {}
+    : socket_fd_(socket_fd), local_addr_(local_addr), pd_(detail::PollDesc::Open(socket_fd)) {}
 
 TCPListener::~TCPListener() {
-    if (!closed_) {
-        Close();
-    }
+    pd_->Close();
 }
 
 gocxx::base::Result<std::shared_ptr<Conn>> TCPListener::Accept() {
-    if (closed_) {
-        return {nullptr, ErrClosed};
-    }
-    
-    sockaddr_in client_addr;
+    sockaddr_storage client_addr;
     #ifdef _WIN32
     int client_addr_len = sizeof(client_addr);
     #else
     socklen_t client_addr_len = sizeof(client_addr);
     #endif
     
-    int client_socket = accept(socket_fd_, 
-                               reinterpret_cast<sockaddr*>(&client_addr),
-                               &client_addr_len);
+    std::shared_ptr<gocxx::errors::Error> err;
+    long client_socket = pd_->Io(detail::PollDesc::Read, [&]() -> long {
+        client_addr_len = sizeof(client_addr);
+        #if defined(__linux__)
+        // Born non-blocking and close-on-exec: no fcntl round trips per connection
+        return ::accept4(socket_fd_, reinterpret_cast<sockaddr*>(&client_addr),
+                         &client_addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        #else
+        return static_cast<long>(accept(socket_fd_,
+                                        reinterpret_cast<sockaddr*>(&client_addr),
+                                        &client_addr_len));
+        #endif
+    }, err);
     
-    if (client_socket == INVALID_SOCKET) {
+    if (err) {
+        return {nullptr, err};
+    }
+    if (client_socket < 0) {
         return {nullptr, socketErrorToError(SOCKET_ERROR_CODE)};
     }
     
-    // Get client address info
-    char client_ip[INET_ADDRSTRLEN];
-    inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
-    int client_port = ntohs(client_addr.sin_port);
+    // Like Go, every TCP connection starts with Nagle's algorithm off
+    int no_delay = 1;
+    setsockopt(static_cast<int>(client_socket), IPPROTO_TCP, TCP_NODELAY,
+               reinterpret_cast<const char*>(&no_delay), sizeof(no_delay));
     
-    auto remote_addr = std::make_shared<TCPAddr>(client_ip, client_port);
-    auto conn = std::make_shared<TCPConn>(client_socket, local_addr_, remote_addr);
+    auto remote_addr = fromSockAddr(client_addr);
+    auto conn = std::make_shared<TCPConn>(static_cast<int>(client_socket), local_addr_, remote_addr);
     
     return {conn, nullptr};
 }
 
 gocxx::base::Result<void> TCPListener::Close() {
-    if (closed_) {
+    if (!pd_->Close()) {
         return {ErrClosed};
     }
-    
-    SOCKET_CLOSE(socket_fd_);
-    closed_ = true;
+    return {};
+}
+
+gocxx::base::Result<void> TCPListener::SetDeadline(std::chrono::system_clock::time_point deadline) {
+    pd_->SetDeadline(detail::PollDesc::Read, deadline);
     return {};
 }
 
@@ -308,24 +549,24 @@ gocxx::base::Result<std::shared_ptr<TCPAddr>> ResolveTCPAddr(
         return {nullptr, ErrInvalidAddr};
     }
     
-    // Simple resolution - just use the IP as-is or resolve hostname
-    struct addrinfo hints, *result;
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_INET;  // IPv4
-    hints.ai_socktype = SOCK_STREAM;
-    
-    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0) {
-        return {nullptr, gocxx::errors::New("cannot resolve address: " + host)};
+    auto ips = lookupHost(network, host);
+    if (ips.Failed()) {
+        return {nullptr, ips.err};
+    }
+    // Like Go, prefer an IPv4 address when the network allows either
+    std::string ip_str;
+    for (const auto& ip : ips.value) {
+        const bool better = ip_str.empty() || (ip_str.find(':') != std::string::npos && ip.find(':') == std::string::npos);
+        if (familyAllowed(network, ip) && better) {
+            ip_str = ip;
+        }
+    }
+    if (ip_str.empty()) {
+        return {nullptr, gocxx::errors::New("no suitable address found for " + host)};
     }
-    
-    char ip_str[INET_ADDRSTRLEN];
-    sockaddr_in* addr_in = reinterpret_cast<sockaddr_in*>(result->ai_addr);
-    inet_ntop(AF_INET, &addr_in->sin_addr, ip_str, INET_ADDRSTRLEN);
     
     auto tcp_addr = std::make_shared<TCPAddr>(ip_str, port);
     
-    freeaddrinfo(result);
-    
     return {tcp_addr, nullptr};
 }
 
@@ -333,82 +574,356 @@ gocxx::base::Result<std::shared_ptr<TCPAddr>> ResolveTCPAddr(
 gocxx::base::Result<std::shared_ptr<TCPConn>> DialTCP(
     const std::string& network,
     const std::string& address) {
-    
-    auto addr_result = ResolveTCPAddr(network, address);
-    if (addr_result.Failed()) {
-        return {nullptr, addr_result.err};
+    return Dialer{}.DialContext(nullptr, network, address);
+}
+
+// Dialer implementation
+namespace {
+
+using Clock = std::chrono::system_clock;
+
+// One address to try, with the per-family network name handed to Control
+struct DialTarget {
+    SockAddr sockaddr;
+    std::shared_ptr<TCPAddr> addr;
+    std::string network;
+};
+
+// Options the Dialer sets on a socket before connecting
+std::shared_ptr<gocxx::errors::Error> applyOptions(const Dialer& d, int sock) {
+    auto set = [sock](int level, int name, int value) {
+        return setsockopt(sock, level, name, reinterpret_cast<const char*>(&value), sizeof(value)) == 0;
+    };
+    if (d.no_delay && !set(IPPROTO_TCP, TCP_NODELAY, 1)) {
+        return socketErrorToError(SOCKET_ERROR_CODE);
     }
-    
-    auto remote_addr = addr_result.value;
-    
+    if (d.send_buffer > 0 && !set(SOL_SOCKET, SO_SNDBUF, d.send_buffer)) {
+        return socketErrorToError(SOCKET_ERROR_CODE);
+    }
+    if (d.recv_buffer > 0 && !set(SOL_SOCKET, SO_RCVBUF, d.recv_buffer)) {
+        return socketErrorToError(SOCKET_ERROR_CODE);
+    }
+    if (d.keep_alive.count() >= 0) {
+        // Probe an idle connection every keep_alive, idle time and interval alike, as Go does
+        const auto period = d.keep_alive.count() == 0 ? std::chrono::seconds(15) : d.keep_alive;
+        const int secs = static_cast<int>(std::max<std::int64_t>(
+            1, std::chrono::duration_cast<std::chrono::seconds>(period + std::chrono::milliseconds(999)).count()));
+        set(SOL_SOCKET, SO_KEEPALIVE, 1);
+        #if defined(TCP_KEEPIDLE)
+        set(IPPROTO_TCP, TCP_KEEPIDLE, secs);
+        #elif defined(TCP_KEEPALIVE)
+        set(IPPROTO_TCP, TCP_KEEPALIVE, secs);
+        #endif
+        #if defined(TCP_KEEPINTVL)
+        set(IPPROTO_TCP, TCP_KEEPINTVL, secs);
+        #endif
+        (void)secs;
+    }
+    if (d.fast_open) {
+        #if defined(TCP_FASTOPEN_CONNECT)
+        // Best effort: kernels without client TFO just do the usual handshake
+        set(IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1);
+        #endif
+    }
+    return nullptr;
+}
+
+// Connects to one address; deadline already folds in the timeout and ctx's deadline
+gocxx::base::Result<std::shared_ptr<TCPConn>> dialOne(
+    const Dialer& d, const context::ContextPtr& ctx, DialTarget& target, Clock::time_point deadline) {
+
     // Create socket
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    int sock = socket(target.sockaddr.family(), SOCK_STREAM, 0);
     if (sock == INVALID_SOCKET) {
         return {nullptr, socketErrorToError(SOCKET_ERROR_CODE)};
     }
-    
-    // Connect to remote
-    sockaddr_in server_addr;
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(remote_addr->port);
-    inet_pton(AF_INET, remote_addr->ip.c_str(), &server_addr.sin_addr);
-    
-    if (connect(sock, reinterpret_cast<sockaddr*>(&server_addr), sizeof(server_addr)) != 0) {
+    auto err = applyOptions(d, sock);
+    if (!err && d.control) {
+        err = d.control(target.network, target.addr->String(), sock);
+    }
+    if (err) {
         SOCKET_CLOSE(sock);
-        return {nullptr, socketErrorToError(SOCKET_ERROR_CODE)};
+        return {nullptr, err};
     }
-    
+
+    // The descriptor owns sock from here on and closes it on every error path
+    auto pd = detail::PollDesc::Open(sock);
+
+    // Cancelling the context expires the connect's deadline at once
+    std::function<bool()> stop_watching;
+    if (ctx) {
+        std::weak_ptr<detail::PollDesc> watched = pd;
+        stop_watching = context::AfterCancel(ctx, [watched] {
+            if (auto p = watched.lock()) {
+                p->SetDeadline(detail::PollDesc::Write, Clock::time_point(Clock::duration(1)));
+            }
+        });
+    }
+    pd->SetDeadline(detail::PollDesc::Write, deadline);
+    auto connected = [&]() {
+        if (stop_watching) {
+            stop_watching();
+        }
+        pd->SetDeadline(detail::PollDesc::Write, Clock::time_point::max());
+    };
+
+    if (connect(sock, target.sockaddr.get(), target.sockaddr.len) != 0) {
+        int err_code = SOCKET_ERROR_CODE;
+        #ifndef _WIN32
+        // Non-blocking connect: wait for writability, then read the outcome.
+        // A fresh socket can report writable before the handshake is done,
+        // so "no error" only counts once the socket has a peer.
+        while (pd->Pollable() && (err_code == EINPROGRESS || err_code == EALREADY || err_code == EINTR)) {
+            if (auto wait_err = pd->Wait(detail::PollDesc::Write)) {
+                connected();
+                if (ctx && ctx->Err().Failed()) {
+                    return {nullptr, ctx->Err().err};
+                }
+                return {nullptr, wait_err};
+            }
+            socklen_t len = sizeof(err_code);
+            if (getsockopt(sock, SOL_SOCKET, SO_ERROR, &err_code, &len) != 0) {
+                err_code = errno;
+            } else if (err_code == 0) {
+                sockaddr_storage peer;
+                socklen_t peer_len = sizeof(peer);
+                if (getpeername(sock, reinterpret_cast<sockaddr*>(&peer), &peer_len) != 0) {
+                    err_code = EINPROGRESS;
+                }
+            }
+        }
+        #endif
+        if (err_code != 0) {
+            connected();
+            return {nullptr, socketErrorToError(err_code)};
+        }
+    }
+    connected();
+
     // Get local address
-    sockaddr_in local_addr;
-    #ifdef _WIN32
-    int local_addr_len = sizeof(local_addr);
-    #else
+    sockaddr_storage local_addr;
     socklen_t local_addr_len = sizeof(local_addr);
-    #endif
-    
     if (getsockname(sock, reinterpret_cast<sockaddr*>(&local_addr), &local_addr_len) != 0) {
-        SOCKET_CLOSE(sock);
         return {nullptr, socketErrorToError(SOCKET_ERROR_CODE)};
     }
-    
-    char local_ip[INET_ADDRSTRLEN];
-    inet_ntop(AF_INET, &local_addr.sin_addr, local_ip, INET_ADDRSTRLEN);
-    int local_port = ntohs(local_addr.sin_port);
-    
-    auto local_tcp_addr = std::make_shared<TCPAddr>(local_ip, local_port);
-    auto conn = std::make_shared<TCPConn>(sock, local_tcp_addr, remote_addr);
-    
+
+    auto conn = std::make_shared<TCPConn>(std::move(pd), fromSockAddr(local_addr), target.addr);
     return {conn, nullptr};
 }
 
-// Dial implementation
-gocxx::base::Result<std::shared_ptr<Conn>> Dial(const std::string& address) {
-    auto result = DialTCP("tcp", address);
-    if (result.Failed()) {
-        return {nullptr, result.err};
+// Tries each address in turn (Go's dialSerial); with a deadline, each
+// attempt gets an equal share of the time left, but at least two seconds
+gocxx::base::Result<std::shared_ptr<TCPConn>> dialSerial(
+    const Dialer& d, const context::ContextPtr& ctx, std::vector<DialTarget>& targets, Clock::time_point deadline) {
+
+    std::shared_ptr<gocxx::errors::Error> first_err;
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        if (ctx && ctx->Err().Failed()) {
+            return {nullptr, ctx->Err().err};
+        }
+        auto attempt_deadline = deadline;
+        if (deadline != Clock::time_point::max()) {
+            const auto now = Clock::now();
+            if (now >= deadline) {
+                return {nullptr, first_err ? first_err : ErrTimeout};
+            }
+            const auto share = std::max<Clock::duration>((deadline - now) / static_cast<int>(targets.size() - i),
+                                                         std::chrono::seconds(2));
+            attempt_deadline = std::min(deadline, now + share);
+        }
+        auto result = dialOne(d, ctx, targets[i], attempt_deadline);
+        if (result.Ok()) {
+            return result;
+        }
+        if (!first_err) {
+            first_err = result.err;
+        }
     }
-    return {result.value, nullptr};
+    return {nullptr, first_err};
 }
 
-// ListenTCP implementation
-gocxx::base::Result<std::shared_ptr<TCPListener>> ListenTCP(
+struct DialAttempt {
+    std::shared_ptr<TCPConn> conn;
+    std::shared_ptr<gocxx::errors::Error> err;
+    bool primary = false;
+};
+
+/**
+ * Happy Eyeballs (RFC 8305), as Go's dialParallel does it: the addresses
+ * of the family the resolver listed first are dialled at once, the others
+ * once fallback_delay passes without a connection (or as soon as every
+ * primary has failed). The first connection wins and the other race is
+ * cancelled; with both failing, the primary error is returned.
+ */
+gocxx::base::Result<std::shared_ptr<TCPConn>> dialParallel(
+    const Dialer& d, const context::ContextPtr& ctx, std::vector<DialTarget> primaries,
+    std::vector<DialTarget> fallbacks, Clock::time_point deadline) {
+
+    auto parent = ctx ? ctx : context::Background();
+    auto primary_ctx = context::WithCancel(parent);
+    auto fallback_ctx = context::WithCancel(parent);
+    if (primary_ctx.Failed() || fallback_ctx.Failed()) {
+        return {nullptr, primary_ctx.Failed() ? primary_ctx.err : fallback_ctx.err};
+    }
+    auto cancel_all = [&] {
+        primary_ctx.value.second();
+        fallback_ctx.value.second();
+    };
+
+    // Both racers can always deliver, so one that loses never blocks
+    gocxx::base::Chan<DialAttempt> results(2);
+    auto race = [&](bool primary) {
+        context::ContextPtr race_ctx = primary ? primary_ctx.value.first : fallback_ctx.value.first;
+        gocxx::go([dialer = d, race_ctx, targets = primary ? std::move(primaries) : std::move(fallbacks),
+                   deadline, results, primary]() mutable {
+            auto result = dialSerial(dialer, race_ctx, targets, deadline);
+            if (result.Ok() && race_ctx->Err().Failed()) {
+                result.value->close();  // connected just as the other race won
+                result = {nullptr, race_ctx->Err().err};
+            }
+            results.send(DialAttempt{result.value, result.err, primary});
+        });
+    };
+
+    race(true);
+    auto fallback_timer = gocxx::time::NewTimer(gocxx::time::Nanoseconds(
+        d.fallback_delay.count() == 0 ? std::chrono::nanoseconds(std::chrono::milliseconds(300)).count()
+                                      : d.fallback_delay.count()));
+    bool fallback_started = false;
+    int pending = 1;
+    std::shared_ptr<gocxx::errors::Error> primary_err;
+    std::shared_ptr<gocxx::errors::Error> fallback_err;
+    while (true) {
+        DialAttempt attempt;
+        bool received = true;
+        if (!fallback_started) {
+            auto timer_ch = fallback_timer->C();
+            received = false;
+            gocxx::base::select(
+                gocxx::base::recvCase(results, [&](std::optional<DialAttempt> v) {
+                    attempt = std::move(*v);
+                    received = true;
+                }),
+                gocxx::base::recvCase(*timer_ch, [](std::optional<gocxx::time::Time>) {}));
+        } else {
+            attempt = std::move(*results.recv());
+        }
+
+        if (!received) {
+            // The primaries are slow: race the other family too
+            fallback_started = true;
+            ++pending;
+            race(false);
+            continue;
+        }
+        --pending;
+        if (attempt.conn) {
+            cancel_all();
+            return {attempt.conn, nullptr};
+        }
+        (attempt.primary ? primary_err : fallback_err) = attempt.err;
+        if (attempt.primary && !fallback_started) {
+            fallback_timer->Stop();
+            fallback_started = true;
+            ++pending;
+            race(false);
+            continue;
+        }
+        if (pending == 0) {
+            cancel_all();
+            return {nullptr, primary_err ? primary_err : fallback_err};
+        }
+    }
+}
+
+} // namespace
+
+gocxx::base::Result<std::shared_ptr<TCPConn>> Dialer::DialContext(
+    context::ContextPtr ctx,
     const std::string& network,
-    const std::string& address) {
-    
+    const std::string& address) const {
+
+    if (ctx && ctx->Err().Failed()) {
+        return {nullptr, ctx->Err().err};
+    }
     if (network != "tcp" && network != "tcp4" && network != "tcp6") {
         return {nullptr, gocxx::errors::New("unsupported network type: " + network)};
     }
-    
+
     std::string host;
     int port;
-    
     if (!parseAddress(address, host, port)) {
         return {nullptr, ErrInvalidAddr};
     }
+
+    auto ips = resolver ? resolver(ctx, network, host) : lookupHost(network, host, ctx);
+    if (ips.Failed()) {
+        return {nullptr, ips.err};
+    }
+
+    // Split by family: the one listed first is preferred
+    std::vector<DialTarget> primaries;
+    std::vector<DialTarget> fallbacks;
+    for (const auto& ip : ips.value) {
+        DialTarget target;
+        if (!familyAllowed(network, ip) || !toSockAddr(ip, port, target.sockaddr)) {
+            continue;
+        }
+        target.addr = std::make_shared<TCPAddr>(ip, port);
+        target.network = target.sockaddr.family() == AF_INET6 ? "tcp6" : "tcp4";
+        const bool primary = primaries.empty() || primaries.front().sockaddr.family() == target.sockaddr.family();
+        (primary ? primaries : fallbacks).push_back(std::move(target));
+    }
+    if (primaries.empty()) {
+        return {nullptr, gocxx::errors::New("no suitable address found for " + host)};
+    }
+
+    // The earlier of the timeout and the context's deadline bounds every attempt
+    auto deadline = Clock::time_point::max();
+    if (timeout.count() > 0) {
+        deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    }
+    if (ctx) {
+        auto ctx_deadline = ctx->Deadline();
+        if (ctx_deadline.Ok()) {
+            deadline = std::min(deadline, Clock::time_point(std::chrono::duration_cast<Clock::duration>(
+                std::chrono::nanoseconds(ctx_deadline.value.UnixNano()))));
+        }
+    }
+
+    if (fallbacks.empty() || fallback_delay.count() < 0) {
+        primaries.insert(primaries.end(), std::make_move_iterator(fallbacks.begin()),
+                         std::make_move_iterator(fallbacks.end()));
+        return dialSerial(*this, ctx, primaries, deadline);
+    }
+    return dialParallel(*this, ctx, std::move(primaries), std::move(fallbacks), deadline);
+}
+
+// Dial implementation
+gocxx::base::Result<std::shared_ptr<Conn>> Dial(const std::string& address) {
+    auto result = DialTCP("tcp", address);
+    if (result.Failed()) {
+        return {nullptr, result.err};
+    }
+    return {result.value, nullptr};
+}
+
+// ListenConfig implementation
+// Opens one listening socket; incomingCpu < 0 leaves SO_INCOMING_CPU alone
+static gocxx::base::Result<std::shared_ptr<TCPListener>> listenSocket(
+    const std::string& host, int port, int backlog, bool reusePort, int incomingCpu) {
+    // A host name listens on its first address
+    SockAddr server_addr;
+    if (!toSockAddr(host, port, server_addr)) {
+        auto ips = lookupHost("tcp", host);
+        if (ips.Failed()) {
+            return {nullptr, ips.err};
+        }
+        toSockAddr(ips.value.front(), port, server_addr);
+    }
     
     // Create socket
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    int sock = socket(server_addr.family(), SOCK_STREAM, 0);
     if (sock == INVALID_SOCKET) {
         return {nullptr, socketErrorToError(SOCKET_ERROR_CODE)};
     }
@@ -417,36 +932,113 @@ gocxx::base::Result<std::shared_ptr<TCPListener>> ListenTCP(
     int reuse = 1;
     setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, 
                reinterpret_cast<const char*>(&reuse), sizeof(reuse));
-    
-    // Bind to address
-    sockaddr_in server_addr;
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    
-    if (host == "0.0.0.0") {
-        server_addr.sin_addr.s_addr = INADDR_ANY;
-    } else {
-        inet_pton(AF_INET, host.c_str(), &server_addr.sin_addr);
+    if (reusePort) {
+        #ifdef SO_REUSEPORT
+        if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) != 0) {
+            SOCKET_CLOSE(sock);
+            return {nullptr, socketErrorToError(SOCKET_ERROR_CODE)};
+        }
+        #else
+        SOCKET_CLOSE(sock);
+        return {nullptr, gocxx::errors::New("net: SO_REUSEPORT is not supported on this platform")};
+        #endif
     }
+    #ifdef SO_INCOMING_CPU
+    if (incomingCpu >= 0) {
+        // Only a hint: the kernel prefers this socket for connections whose packets it handles on that CPU
+        setsockopt(sock, SOL_SOCKET, SO_INCOMING_CPU, &incomingCpu, sizeof(incomingCpu));
+    }
+    #else
+    (void)incomingCpu;
+    #endif
     
-    if (bind(sock, reinterpret_cast<sockaddr*>(&server_addr), sizeof(server_addr)) != 0) {
+    // Bind to address
+    if (bind(sock, server_addr.get(), server_addr.len) != 0) {
         SOCKET_CLOSE(sock);
         return {nullptr, socketErrorToError(SOCKET_ERROR_CODE)};
     }
     
     // Listen
-    if (listen(sock, 128) != 0) {  // 128 is a common backlog size
+    if (listen(sock, backlog) != 0) {
         SOCKET_CLOSE(sock);
         return {nullptr, socketErrorToError(SOCKET_ERROR_CODE)};
     }
     
+    // Report the port the kernel picked for ":0"
+    sockaddr_storage bound_addr;
+    socklen_t bound_addr_len = sizeof(bound_addr);
+    if (port == 0 && getsockname(sock, reinterpret_cast<sockaddr*>(&bound_addr), &bound_addr_len) == 0) {
+        port = fromSockAddr(bound_addr)->port;
+    }
+    
     auto local_addr = std::make_shared<TCPAddr>(host, port);
     auto listener = std::make_shared<TCPListener>(sock, local_addr);
     
     return {listener, nullptr};
 }
 
+gocxx::base::Result<std::shared_ptr<TCPListener>> ListenConfig::Listen(
+    const std::string& network,
+    const std::string& address) const {
+    
+    if (network != "tcp" && network != "tcp4" && network != "tcp6") {
+        return {nullptr, gocxx::errors::New("unsupported network type: " + network)};
+    }
+    
+    std::string host;
+    int port;
+    
+    if (!parseAddress(address, host, port)) {
+        return {nullptr, ErrInvalidAddr};
+    }
+    
+    return listenSocket(host, port, backlog, reuse_port, incoming_cpu);
+}
+
+gocxx::base::Result<std::vector<std::shared_ptr<TCPListener>>> ListenConfig::ListenShards(
+    const std::string& network,
+    const std::string& address,
+    std::size_t shards) const {
+    
+    if (shards == 0) {
+        throw std::invalid_argument("net: ListenShards needs at least one shard");
+    }
+    if (network != "tcp" && network != "tcp4" && network != "tcp6") {
+        return {{}, gocxx::errors::New("unsupported network type: " + network)};
+    }
+    
+    std::string host;
+    int port;
+    
+    if (!parseAddress(address, host, port)) {
+        return {{}, ErrInvalidAddr};
+    }
+    
+    std::vector<std::shared_ptr<TCPListener>> listeners;
+    listeners.reserve(shards);
+    for (std::size_t i = 0; i < shards; ++i) {
+        const int cpu = incoming_cpu >= 0 ? incoming_cpu + static_cast<int>(i) : -1;
+        auto result = listenSocket(host, port, backlog, true, cpu);
+        if (result.Failed()) {
+            for (auto& l : listeners) {
+                l->Close();
+            }
+            return {{}, result.err};
+        }
+        // ":0" picks the port once; the other shards join the first one's group
+        port = std::static_pointer_cast<TCPAddr>(result.value->Address())->port;
+        listeners.push_back(result.value);
+    }
+    return {listeners, nullptr};
+}
+
+// ListenTCP implementation
+gocxx::base::Result<std::shared_ptr<TCPListener>> ListenTCP(
+    const std::string& network,
+    const std::string& address) {
+    return ListenConfig{}.Listen(network, address);
+}
+
 // Listen implementation
 gocxx::base::Result<std::shared_ptr<Listener>> Listen(const std::string& address) {
     auto result = ListenTCP("tcp", address);
@@ -1,5 +1,9 @@
 #include <gocxx/net/udp.h>
+#include <gocxx/net/resolver.h>
+#include <algorithm>
 #include <cstring>
+#include <gocxx/net/detail/netpoll.h>
+#include <gocxx/runtime/blocking.h>
 
 // Platform-specific includes
 #ifdef _WIN32
@@ -30,6 +34,21 @@
     #include <netdb.h>
     #include <unistd.h>
     #include <errno.h>
+    #include <sys/uio.h>
+    #if defined(__linux__)
+        #include <netinet/udp.h>
+        #define GOCXX_UDP_MMSG 1
+        // Older C libraries lack the offload options the kernel has had since 4.18 and 5.0
+        #ifndef SOL_UDP
+        #define SOL_UDP 17
+        #endif
+        #ifndef UDP_SEGMENT
+        #define UDP_SEGMENT 103
+        #endif
+        #ifndef UDP_GRO
+        #define UDP_GRO 104
+        #endif
+    #endif
     #define SOCKET_ERROR_CODE errno
     #define INVALID_SOCKET -1
     #define SOCKET_CLOSE ::close
@@ -97,17 +116,79 @@ std::string UDPAddr::String() const {
     return ip + ":" + std::to_string(port);
 }
 
+// AddrPort implementation
+AddrPort AddrPort::From(const UDPAddr& addr) {
+    AddrPort out;
+    out.port = static_cast<std::uint16_t>(addr.port);
+    if (addr.ip.find(':') != std::string::npos) {
+        out.is_v6 = inet_pton(AF_INET6, addr.ip.c_str(), out.ip.data()) == 1;
+        if (!out.is_v6) {
+            return AddrPort();
+        }
+    } else if (inet_pton(AF_INET, addr.ip.c_str(), out.ip.data()) != 1) {
+        return AddrPort();
+    }
+    return out;
+}
+
+std::string AddrPort::String() const {
+    char ip_str[INET6_ADDRSTRLEN] = {};
+    std::array<uint8_t, 16> copy = ip;  // inet_ntop takes a non-const source on some platforms
+    inet_ntop(is_v6 ? AF_INET6 : AF_INET, copy.data(), ip_str, sizeof(ip_str));
+    if (is_v6) {
+        return "[" + std::string(ip_str) + "]:" + std::to_string(port);
+    }
+    return std::string(ip_str) + ":" + std::to_string(port);
+}
+
+std::shared_ptr<UDPAddr> AddrPort::ToUDPAddr() const {
+    char ip_str[INET6_ADDRSTRLEN] = {};
+    std::array<uint8_t, 16> copy = ip;
+    inet_ntop(is_v6 ? AF_INET6 : AF_INET, copy.data(), ip_str, sizeof(ip_str));
+    return std::make_shared<UDPAddr>(ip_str, port);
+}
+
+static AddrPort addrPortFrom(const sockaddr_storage& ss) {
+    AddrPort out;
+    if (ss.ss_family == AF_INET6) {
+        const auto* in6 = reinterpret_cast<const sockaddr_in6*>(&ss);
+        memcpy(out.ip.data(), &in6->sin6_addr, 16);
+        out.port = ntohs(in6->sin6_port);
+        out.is_v6 = true;
+    } else if (ss.ss_family == AF_INET) {
+        const auto* in4 = reinterpret_cast<const sockaddr_in*>(&ss);
+        memcpy(out.ip.data(), &in4->sin_addr, 4);
+        out.port = ntohs(in4->sin_port);
+    }
+    return out;
+}
+
+// The sockaddr for addr; 0 when it is unset (a connected socket's peer)
+static socklen_t toSockaddr(const AddrPort& addr, sockaddr_storage& ss) {
+    if (!addr.IsValid()) {
+        return 0;
+    }
+    memset(&ss, 0, sizeof(ss));
+    if (addr.is_v6) {
+        auto* in6 = reinterpret_cast<sockaddr_in6*>(&ss);
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(addr.port);
+        memcpy(&in6->sin6_addr, addr.ip.data(), 16);
+        return sizeof(sockaddr_in6);
+    }
+    auto* in4 = reinterpret_cast<sockaddr_in*>(&ss);
+    in4->sin_family = AF_INET;
+    in4->sin_port = htons(addr.port);
+    memcpy(&in4->sin_addr, addr.ip.data(), 4);
+    return sizeof(sockaddr_in);
+}
+
 // UDPConn implementation
 UDPConn::UDPConn(int socket_fd, std::shared_ptr<UDPAddr> local_addr)
-    : socket_fd_(socket_fd), local_addr_(local_addr), closed_(false) {
-    read_deadline_ = std::chrono::system_clock::time_point::max();
-    write_deadline_ = std::chrono::system_clock::time_point::max();
-}
+    : socket_fd_(socket_fd), local_addr_(local_addr), pd_(detail::PollDesc::Open(socket_fd)) {}
 
 UDPConn::~UDPConn() {
-    if (!closed_) {
-        close();
-    }
+    close();
 }
 
 gocxx::base::Result<std::size_t> UDPConn::ReadFrom(
@@ -115,10 +196,6 @@ gocxx::base::Result<std::size_t> UDPConn::ReadFrom(
     std::size_t size,
     std::shared_ptr<Addr>& addr) {
     
-    if (closed_) {
-        return {0, ErrClosed};
-    }
-    
     sockaddr_in sender_addr;
     #ifdef _WIN32
     int sender_addr_len = sizeof(sender_addr);
@@ -126,15 +203,22 @@ gocxx::base::Result<std::size_t> UDPConn::ReadFrom(
     socklen_t sender_addr_len = sizeof(sender_addr);
     #endif
     
-    #ifdef _WIN32
-    int result = recvfrom(socket_fd_, reinterpret_cast<char*>(buffer), 
-                         static_cast<int>(size), 0,
-                         reinterpret_cast<sockaddr*>(&sender_addr), &sender_addr_len);
-    #else
-    ssize_t result = recvfrom(socket_fd_, buffer, size, 0,
-                             reinterpret_cast<sockaddr*>(&sender_addr), &sender_addr_len);
-    #endif
-    
+    std::shared_ptr<gocxx::errors::Error> err;
+    long result = pd_->Io(detail::PollDesc::Read, [&]() -> long {
+        sender_addr_len = sizeof(sender_addr);
+        #ifdef _WIN32
+        return recvfrom(socket_fd_, reinterpret_cast<char*>(buffer), 
+                        static_cast<int>(size), 0,
+                        reinterpret_cast<sockaddr*>(&sender_addr), &sender_addr_len);
+        #else
+        return static_cast<long>(recvfrom(socket_fd_, buffer, size, 0,
+                                          reinterpret_cast<sockaddr*>(&sender_addr), &sender_addr_len));
+        #endif
+    }, err);
+    
+    if (err) {
+        return {0, err};
+    }
     if (result < 0) {
         return {0, socketErrorToError(SOCKET_ERROR_CODE)};
     }
@@ -154,10 +238,6 @@ gocxx::base::Result<std::size_t> UDPConn::WriteTo(
     std::size_t size,
     std::shared_ptr<Addr> addr) {
     
-    if (closed_) {
-        return {0, ErrClosed};
-    }
-    
     // Cast to UDPAddr
     auto udp_addr = std::dynamic_pointer_cast<UDPAddr>(addr);
     if (!udp_addr) {
@@ -172,42 +252,38 @@ std::shared_ptr<Addr> UDPConn::LocalAddr() {
 }
 
 gocxx::base::Result<void> UDPConn::SetReadDeadline(std::chrono::system_clock::time_point deadline) {
-    read_deadline_ = deadline;
-    // TODO: Implement actual deadline setting
+    pd_->SetDeadline(detail::PollDesc::Read, deadline);
     return {};
 }
 
 gocxx::base::Result<void> UDPConn::SetWriteDeadline(std::chrono::system_clock::time_point deadline) {
-    write_deadline_ = deadline;
-    // TODO: Implement actual deadline setting
+    pd_->SetDeadline(detail::PollDesc::Write, deadline);
     return {};
 }
 
 gocxx::base::Result<void> UDPConn::SetDeadline(std::chrono::system_clock::time_point deadline) {
-    read_deadline_ = deadline;
-    write_deadline_ = deadline;
-    // TODO: Implement actual deadline setting
+    pd_->SetDeadline(detail::PollDesc::Read, deadline);
+    pd_->SetDeadline(detail::PollDesc::Write, deadline);
     return {};
 }
 
 void UDPConn::close() {
-    if (!closed_) {
-        SOCKET_CLOSE(socket_fd_);
-        closed_ = true;
-    }
+    pd_->Close();
 }
 
 gocxx::base::Result<std::size_t> UDPConn::Read(uint8_t* buffer, std::size_t size) {
-    if (closed_) {
-        return {0, ErrClosed};
+    std::shared_ptr<gocxx::errors::Error> err;
+    long result = pd_->Io(detail::PollDesc::Read, [&]() -> long {
+        #ifdef _WIN32
+        return recv(socket_fd_, reinterpret_cast<char*>(buffer), static_cast<int>(size), 0);
+        #else
+        return static_cast<long>(recv(socket_fd_, buffer, size, 0));
+        #endif
+    }, err);
+    
+    if (err) {
+        return {0, err};
     }
-    
-    #ifdef _WIN32
-    int result = recv(socket_fd_, reinterpret_cast<char*>(buffer), static_cast<int>(size), 0);
-    #else
-    ssize_t result = recv(socket_fd_, buffer, size, 0);
-    #endif
-    
     if (result < 0) {
         return {0, socketErrorToError(SOCKET_ERROR_CODE)};
     }
@@ -216,16 +292,18 @@ gocxx::base::Result<std::size_t> UDPConn::Read(uint8_t* buffer, std::size_t size
 }
 
 gocxx::base::Result<std::size_t> UDPConn::Write(const uint8_t* buffer, std::size_t size) {
-    if (closed_) {
-        return {0, ErrClosed};
+    std::shared_ptr<gocxx::errors::Error> err;
+    long result = pd_->Io(detail::PollDesc::Write, [&]() -> long {
+        #ifdef _WIN32
+        return send(socket_fd_, reinterpret_cast<const char*>(buffer), static_cast<int>(size), 0);
+        #else
+        return static_cast<long>(send(socket_fd_, buffer, size, 0));
+        #endif
+    }, err);
+    
+    if (err) {
+        return {0, err};
     }
-    
-    #ifdef _WIN32
-    int result = send(socket_fd_, reinterpret_cast<const char*>(buffer), static_cast<int>(size), 0);
-    #else
-    ssize_t result = send(socket_fd_, buffer, size, 0);
-    #endif
-    
     if (result < 0) {
         return {0, socketErrorToError(SOCKET_ERROR_CODE)};
     }
@@ -253,25 +331,27 @@ gocxx::base::Result<std::size_t> UDPConn::WriteToUDP(
     std::size_t size,
     std::shared_ptr<UDPAddr> addr) {
     
-    if (closed_) {
-        return {0, ErrClosed};
-    }
-    
     sockaddr_in dest_addr;
     memset(&dest_addr, 0, sizeof(dest_addr));
     dest_addr.sin_family = AF_INET;
     dest_addr.sin_port = htons(addr->port);
     inet_pton(AF_INET, addr->ip.c_str(), &dest_addr.sin_addr);
     
-    #ifdef _WIN32
-    int result = sendto(socket_fd_, reinterpret_cast<const char*>(buffer),
-                       static_cast<int>(size), 0,
-                       reinterpret_cast<sockaddr*>(&dest_addr), sizeof(dest_addr));
-    #else
-    ssize_t result = sendto(socket_fd_, buffer, size, 0,
-                           reinterpret_cast<sockaddr*>(&dest_addr), sizeof(dest_addr));
-    #endif
-    
+    std::shared_ptr<gocxx::errors::Error> err;
+    long result = pd_->Io(detail::PollDesc::Write, [&]() -> long {
+        #ifdef _WIN32
+        return sendto(socket_fd_, reinterpret_cast<const char*>(buffer),
+                      static_cast<int>(size), 0,
+                      reinterpret_cast<sockaddr*>(&dest_addr), sizeof(dest_addr));
+        #else
+        return static_cast<long>(sendto(socket_fd_, buffer, size, 0,
+                                        reinterpret_cast<sockaddr*>(&dest_addr), sizeof(dest_addr)));
+        #endif
+    }, err);
+    
+    if (err) {
+        return {0, err};
+    }
     if (result < 0) {
         return {0, socketErrorToError(SOCKET_ERROR_CODE)};
     }
@@ -279,6 +359,197 @@ gocxx::base::Result<std::size_t> UDPConn::WriteToUDP(
     return {static_cast<std::size_t>(result), nullptr};
 }
 
+#if defined(GOCXX_UDP_MMSG)
+
+gocxx::base::Result<std::size_t> UDPConn::ReadBatch(UDPMessage* msgs, std::size_t count) {
+    count = std::min(count, kMaxBatch);
+    if (count == 0) {
+        return {0, nullptr};
+    }
+    // Everything recvmmsg needs lives on the stack: nothing is allocated per call
+    mmsghdr hdrs[kMaxBatch];
+    iovec iovs[kMaxBatch];
+    sockaddr_storage names[kMaxBatch];
+    union Control {
+        char buf[CMSG_SPACE(sizeof(int))];
+        cmsghdr align;
+    } control[kMaxBatch];
+
+    std::shared_ptr<gocxx::errors::Error> err;
+    long result = pd_->Io(detail::PollDesc::Read, [&]() -> long {
+        memset(hdrs, 0, sizeof(mmsghdr) * count);
+        for (std::size_t i = 0; i < count; ++i) {
+            iovs[i].iov_base = msgs[i].buffer;
+            iovs[i].iov_len = msgs[i].size;
+            hdrs[i].msg_hdr.msg_name = &names[i];
+            hdrs[i].msg_hdr.msg_namelen = sizeof(names[i]);
+            hdrs[i].msg_hdr.msg_iov = &iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen = 1;
+            hdrs[i].msg_hdr.msg_control = control[i].buf;
+            hdrs[i].msg_hdr.msg_controllen = sizeof(control[i].buf);
+        }
+        return static_cast<long>(recvmmsg(socket_fd_, hdrs, static_cast<unsigned>(count), 0, nullptr));
+    }, err);
+
+    if (err) {
+        return {0, err};
+    }
+    if (result < 0) {
+        return {0, socketErrorToError(SOCKET_ERROR_CODE)};
+    }
+
+    for (long i = 0; i < result; ++i) {
+        UDPMessage& msg = msgs[i];
+        msg.n = hdrs[i].msg_len;
+        msg.addr = addrPortFrom(names[i]);
+        msg.segment_size = 0;
+        for (cmsghdr* c = CMSG_FIRSTHDR(&hdrs[i].msg_hdr); c; c = CMSG_NXTHDR(&hdrs[i].msg_hdr, c)) {
+            if (c->cmsg_level == SOL_UDP && c->cmsg_type == UDP_GRO) {
+                int segment = 0;
+                memcpy(&segment, CMSG_DATA(c), sizeof(segment));
+                msg.segment_size = segment > 0 && static_cast<std::size_t>(segment) < msg.n
+                                       ? static_cast<std::size_t>(segment) : 0;
+            }
+        }
+    }
+    return {static_cast<std::size_t>(result), nullptr};
+}
+
+gocxx::base::Result<std::size_t> UDPConn::WriteBatch(UDPMessage* msgs, std::size_t count) {
+    mmsghdr hdrs[kMaxBatch];
+    iovec iovs[kMaxBatch];
+    sockaddr_storage names[kMaxBatch];
+    union Control {
+        char buf[CMSG_SPACE(sizeof(std::uint16_t))];
+        cmsghdr align;
+    } control[kMaxBatch];
+
+    std::size_t sent = 0;
+    while (sent < count) {
+        const std::size_t batch = std::min(count - sent, kMaxBatch);
+        memset(hdrs, 0, sizeof(mmsghdr) * batch);
+        for (std::size_t i = 0; i < batch; ++i) {
+            const UDPMessage& msg = msgs[sent + i];
+            iovs[i].iov_base = msg.buffer;
+            iovs[i].iov_len = msg.size;
+            msghdr& h = hdrs[i].msg_hdr;
+            h.msg_iov = &iovs[i];
+            h.msg_iovlen = 1;
+            h.msg_namelen = toSockaddr(msg.addr, names[i]);
+            h.msg_name = h.msg_namelen ? &names[i] : nullptr;
+            if (msg.segment_size > 0 && msg.segment_size < msg.size) {
+                // One buffer, cut into datagrams by the kernel or the NIC
+                memset(control[i].buf, 0, sizeof(control[i].buf));
+                h.msg_control = control[i].buf;
+                h.msg_controllen = sizeof(control[i].buf);
+                cmsghdr* c = CMSG_FIRSTHDR(&h);
+                c->cmsg_level = SOL_UDP;
+                c->cmsg_type = UDP_SEGMENT;
+                c->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+                const auto segment = static_cast<std::uint16_t>(msg.segment_size);
+                memcpy(CMSG_DATA(c), &segment, sizeof(segment));
+            }
+        }
+
+        std::shared_ptr<gocxx::errors::Error> err;
+        long result = pd_->Io(detail::PollDesc::Write, [&]() -> long {
+            return static_cast<long>(sendmmsg(socket_fd_, hdrs, static_cast<unsigned>(batch), 0));
+        }, err);
+        if (err) {
+            return {sent, err};
+        }
+        if (result < 0) {
+            return {sent, socketErrorToError(SOCKET_ERROR_CODE)};
+        }
+        for (long i = 0; i < result; ++i) {
+            msgs[sent + i].n = hdrs[i].msg_len;
+        }
+        sent += static_cast<std::size_t>(result);
+    }
+    return {sent, nullptr};
+}
+
+gocxx::base::Result<void> UDPConn::SetGRO(bool enable) {
+    int value = enable ? 1 : 0;
+    if (setsockopt(socket_fd_, SOL_UDP, UDP_GRO, &value, sizeof(value)) != 0) {
+        return {socketErrorToError(SOCKET_ERROR_CODE)};
+    }
+    return {};
+}
+
+#else
+
+// One datagram per system call
+gocxx::base::Result<std::size_t> UDPConn::ReadBatch(UDPMessage* msgs, std::size_t count) {
+    if (count == 0) {
+        return {0, nullptr};
+    }
+    sockaddr_storage sender;
+    socklen_t sender_len = sizeof(sender);
+    std::shared_ptr<gocxx::errors::Error> err;
+    long result = pd_->Io(detail::PollDesc::Read, [&]() -> long {
+        sender_len = sizeof(sender);
+        #ifdef _WIN32
+        return recvfrom(socket_fd_, reinterpret_cast<char*>(msgs[0].buffer), static_cast<int>(msgs[0].size), 0,
+                        reinterpret_cast<sockaddr*>(&sender), &sender_len);
+        #else
+        return static_cast<long>(recvfrom(socket_fd_, msgs[0].buffer, msgs[0].size, 0,
+                                          reinterpret_cast<sockaddr*>(&sender), &sender_len));
+        #endif
+    }, err);
+    if (err) {
+        return {0, err};
+    }
+    if (result < 0) {
+        return {0, socketErrorToError(SOCKET_ERROR_CODE)};
+    }
+    msgs[0].n = static_cast<std::size_t>(result);
+    msgs[0].addr = addrPortFrom(sender);
+    msgs[0].segment_size = 0;
+    return {1, nullptr};
+}
+
+gocxx::base::Result<std::size_t> UDPConn::WriteBatch(UDPMessage* msgs, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        UDPMessage& msg = msgs[i];
+        sockaddr_storage dest;
+        const socklen_t dest_len = toSockaddr(msg.addr, dest);
+        const std::size_t segment = msg.segment_size > 0 ? msg.segment_size : msg.size;
+        msg.n = 0;
+        // Without segmentation offload, each segment is a sendto of its own
+        for (std::size_t off = 0; off < msg.size || (off == 0 && msg.size == 0); off += segment) {
+            const std::size_t len = std::min(segment, msg.size - off);
+            std::shared_ptr<gocxx::errors::Error> err;
+            long result = pd_->Io(detail::PollDesc::Write, [&]() -> long {
+                #ifdef _WIN32
+                return sendto(socket_fd_, reinterpret_cast<const char*>(msg.buffer + off), static_cast<int>(len), 0,
+                              dest_len ? reinterpret_cast<sockaddr*>(&dest) : nullptr, dest_len);
+                #else
+                return static_cast<long>(sendto(socket_fd_, msg.buffer + off, len, 0,
+                                                dest_len ? reinterpret_cast<sockaddr*>(&dest) : nullptr, dest_len));
+                #endif
+            }, err);
+            if (err) {
+                return {i, err};
+            }
+            if (result < 0) {
+                return {i, socketErrorToError(SOCKET_ERROR_CODE)};
+            }
+            msg.n += static_cast<std::size_t>(result);
+            if (msg.size == 0) {
+                break;
+            }
+        }
+    }
+    return {count, nullptr};
+}
+
+gocxx::base::Result<void> UDPConn::SetGRO(bool) {
+    return {gocxx::errors::New("net: UDP_GRO is not supported on this platform")};
+}
+
+#endif
+
 // ResolveUDPAddr implementation
 gocxx::base::Result<std::shared_ptr<UDPAddr>> ResolveUDPAddr(
     const std::string& network,
@@ -295,22 +566,13 @@ gocxx::base::Result<std::shared_ptr<UDPAddr>> ResolveUDPAddr(
         return {nullptr, ErrInvalidAddr};
     }
     
-    struct addrinfo hints, *result;
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_INET;
-    hints.ai_socktype = SOCK_DGRAM;
-    
-    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0) {
-        return {nullptr, gocxx::errors::New("cannot resolve address: " + host)};
+    // UDP sockets here are IPv4, so only IPv4 addresses will do
+    auto ips = DefaultResolver()->LookupIP(nullptr, "udp4", host);
+    if (ips.Failed()) {
+        return {nullptr, ips.err};
     }
     
-    char ip_str[INET_ADDRSTRLEN];
-    sockaddr_in* addr_in = reinterpret_cast<sockaddr_in*>(result->ai_addr);
-    inet_ntop(AF_INET, &addr_in->sin_addr, ip_str, INET_ADDRSTRLEN);
-    
-    auto udp_addr = std::make_shared<UDPAddr>(ip_str, port);
-    
-    freeaddrinfo(result);
+    auto udp_addr = std::make_shared<UDPAddr>(ips.value.front(), port);
     
     return {udp_addr, nullptr};
 }
@@ -0,0 +1,721 @@
+#include "gocxx/os/exec.h"
+
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/io/io_errors.h>
+#include <gocxx/runtime/runtime.h>
+#include <gocxx/sync/waitgroup.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cctype>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#endif
+
+extern char** environ;
+
+// posix_spawn_file_actions_addchdir_np: glibc 2.29, macOS 10.15.
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 29)
+#define GOCXX_SPAWN_CHDIR 1
+#endif
+#elif defined(__APPLE__)
+#define GOCXX_SPAWN_CHDIR 1
+#endif
+#endif
+
+namespace gocxx::os::exec {
+
+    std::shared_ptr<gocxx::errors::Error> ErrNotFound = gocxx::errors::New("executable file not found in $PATH");
+
+    namespace {
+        std::shared_ptr<gocxx::errors::Error> errAlreadyStarted = gocxx::errors::New("exec: already started");
+        std::shared_ptr<gocxx::errors::Error> errNotStarted = gocxx::errors::New("exec: not started");
+        std::shared_ptr<gocxx::errors::Error> errWaitCalled = gocxx::errors::New("exec: Wait was already called");
+        std::shared_ptr<gocxx::errors::Error> errFinished = gocxx::errors::New("os: process already finished");
+    }
+
+    std::string ExitError::error() const noexcept {
+        if (state_->exited) {
+            return "exit status " + std::to_string(state_->exitCode);
+        }
+#ifndef _WIN32
+        std::string name = ::strsignal(state_->signal);
+        if (!name.empty()) {
+            name[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[0])));
+        }
+        return "signal: " + name;
+#else
+        return "signal: " + std::to_string(state_->signal);
+#endif
+    }
+
+    namespace detail {
+
+        // A started process, shared by its Cmd, the reaper and the context
+        // watch. The reaper sets reaped under mu, and signals are only sent
+        // under mu while it is false, so a pid is never signalled after the
+        // kernel may have handed it to another process.
+        struct Child {
+            int pid = 0;
+            int pidfd = -1;
+            std::mutex mu;
+            std::condition_variable cv;
+            bool reaped = false;
+            int status = 0;     // from waitpid
+            int wait_errno = 0; // waitpid failed: someone else reaped it
+        };
+
+        struct CmdState {
+            std::shared_ptr<Child> child;
+            int child_fds[3] = {-1, -1, -1};             // set by the pipe methods
+            std::vector<int> close_after_start;          // the child's ends, /dev/null
+            std::vector<std::shared_ptr<File>> close_after_wait;
+            std::vector<std::function<std::shared_ptr<gocxx::errors::Error>()>> copiers;
+            gocxx::sync::WaitGroup copying;
+            std::mutex err_mu;
+            std::shared_ptr<gocxx::errors::Error> copy_err;
+            std::function<bool()> stop_watching;
+            std::atomic<bool> cancelled{false};
+            bool started = false;
+            bool waited = false;
+
+            ~CmdState() {
+#ifndef _WIN32
+                for (int fd : close_after_start) ::close(fd);
+#endif
+            }
+        };
+
+    } // namespace detail
+
+    namespace {
+
+        std::shared_ptr<gocxx::errors::Error> syscallError(const std::string& call, int err) {
+            return gocxx::errors::New(call + ": " + std::strerror(err));
+        }
+
+#ifndef _WIN32
+        // Pipe ends closed across exec, so one child never inherits another's.
+        std::shared_ptr<gocxx::errors::Error> cloexecPipe(int fds[2]) {
+#ifdef __linux__
+            if (::pipe2(fds, O_CLOEXEC) != 0) return syscallError("pipe2", errno);
+#else
+            if (::pipe(fds) != 0) return syscallError("pipe", errno);
+            ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+            ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+            return nullptr;
+        }
+
+        int sigchldWake = -1;
+        struct sigaction prevSigchld;
+
+        // Wakes the reaper and chains to whatever handler was installed before.
+        void onSigchld(int sig, siginfo_t* info, void* uctx) {
+            const int saved = errno;
+            const char b = 0;
+            (void)!::write(sigchldWake, &b, 1);
+            if (prevSigchld.sa_flags & SA_SIGINFO) {
+                if (prevSigchld.sa_sigaction) prevSigchld.sa_sigaction(sig, info, uctx);
+            } else if (prevSigchld.sa_handler != SIG_DFL && prevSigchld.sa_handler != SIG_IGN) {
+                prevSigchld.sa_handler(sig);
+            }
+            errno = saved;
+        }
+
+        /**
+         * @brief The process-wide thread that reaps every child a Cmd starts.
+         *
+         * With pidfds it sleeps in epoll on one per child and reaps exactly
+         * the child that exited. Without them it wakes on SIGCHLD, through a
+         * self-pipe, and polls its own children with WNOHANG, leaving any
+         * other children of the process to whoever waits for them. Leaked,
+         * like the net poller.
+         */
+        class Reaper {
+        public:
+            static Reaper& instance() {
+                static Reaper* reaper = [] {
+                    auto* r = new Reaper();
+                    std::thread([r] { r->loop(); }).detach();
+                    return r;
+                }();
+                return *reaper;
+            }
+
+            void watch(const std::shared_ptr<detail::Child>& child) {
+                {
+                    std::lock_guard<std::mutex> lock(mu_);
+                    children_[child->pid] = child;
+                }
+#ifdef __linux__
+                if (epfd_ >= 0) {
+                    std::lock_guard<std::mutex> lock(child->mu);
+                    const int fd = static_cast<int>(::syscall(SYS_pidfd_open, child->pid, 0));
+                    if (fd >= 0) {
+                        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+                        epoll_event ev{};
+                        ev.events = EPOLLIN;
+                        ev.data.u64 = static_cast<std::uint64_t>(child->pid);
+                        if (::epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) == 0) {
+                            child->pidfd = fd;
+                            return;
+                        }
+                        ::close(fd);
+                    }
+                }
+#endif
+                std::call_once(sigchld_once_, [this] { installSigchld(); });
+                wake();  // it may have exited before it was registered
+            }
+
+        private:
+            Reaper() {
+                // Writing to a child that has exited should fail with EPIPE,
+                // not kill us; children get the default back at spawn.
+                struct sigaction pipeAction;
+                if (::sigaction(SIGPIPE, nullptr, &pipeAction) == 0 && !(pipeAction.sa_flags & SA_SIGINFO) &&
+                    pipeAction.sa_handler == SIG_DFL) {
+                    ::signal(SIGPIPE, SIG_IGN);
+                }
+
+                if (cloexecPipe(wake_) == nullptr) {
+                    ::fcntl(wake_[0], F_SETFL, ::fcntl(wake_[0], F_GETFL) | O_NONBLOCK);
+                    ::fcntl(wake_[1], F_SETFL, ::fcntl(wake_[1], F_GETFL) | O_NONBLOCK);
+                }
+#ifdef __linux__
+                const int probe = static_cast<int>(::syscall(SYS_pidfd_open, ::getpid(), 0));
+                if (probe >= 0) {
+                    ::close(probe);
+                    epfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+                    epoll_event ev{};
+                    ev.events = EPOLLIN;
+                    ev.data.u64 = 0;
+                    if (epfd_ >= 0 && ::epoll_ctl(epfd_, EPOLL_CTL_ADD, wake_[0], &ev) != 0) {
+                        ::close(epfd_);
+                        epfd_ = -1;
+                    }
+                }
+#endif
+            }
+
+            void installSigchld() {
+                sigchldWake = wake_[1];
+                struct sigaction sa {};
+                sa.sa_sigaction = onSigchld;
+                sa.sa_flags = SA_SIGINFO | SA_RESTART | SA_NOCLDSTOP;
+                sigemptyset(&sa.sa_mask);
+                ::sigaction(SIGCHLD, &sa, &prevSigchld);
+            }
+
+            void wake() {
+                const char b = 0;
+                (void)!::write(wake_[1], &b, 1);
+            }
+
+            void drain() {
+                char buf[64];
+                while (::read(wake_[0], buf, sizeof(buf)) > 0) {
+                }
+            }
+
+            void loop() {
+                for (;;) {
+#ifdef __linux__
+                    if (epfd_ >= 0) {
+                        epoll_event events[64];
+                        const int n = ::epoll_wait(epfd_, events, 64, -1);
+                        for (int i = 0; i < n; ++i) {
+                            const auto pid = static_cast<int>(events[i].data.u64);
+                            if (pid == 0) {
+                                drain();
+                                scan();  // children watched through SIGCHLD instead
+                            } else {
+                                reapPid(pid);
+                            }
+                        }
+                        continue;
+                    }
+#endif
+                    pollfd p{wake_[0], POLLIN, 0};
+                    if (::poll(&p, 1, -1) > 0) {
+                        drain();
+                        scan();
+                    }
+                }
+            }
+
+            void scan() {
+                std::vector<std::shared_ptr<detail::Child>> children;
+                {
+                    std::lock_guard<std::mutex> lock(mu_);
+                    children.reserve(children_.size());
+                    for (auto& [pid, child] : children_) children.push_back(child);
+                }
+                for (auto& child : children) reap(child);
+            }
+
+            void reapPid(int pid) {
+                std::shared_ptr<detail::Child> child;
+                {
+                    std::lock_guard<std::mutex> lock(mu_);
+                    auto it = children_.find(pid);
+                    if (it == children_.end()) return;
+                    child = it->second;
+                }
+                reap(child);
+            }
+
+            void reap(const std::shared_ptr<detail::Child>& child) {
+                {
+                    std::lock_guard<std::mutex> lock(child->mu);
+                    if (child->reaped) return;
+                    int status = 0;
+                    pid_t r;
+                    do {
+                        r = ::waitpid(child->pid, &status, WNOHANG);
+                    } while (r < 0 && errno == EINTR);
+                    if (r == 0) return;  // still running
+                    child->reaped = true;
+                    child->status = status;
+                    child->wait_errno = r < 0 ? errno : 0;
+#ifdef __linux__
+                    if (child->pidfd >= 0) {
+                        ::epoll_ctl(epfd_, EPOLL_CTL_DEL, child->pidfd, nullptr);
+                        ::close(child->pidfd);
+                        child->pidfd = -1;
+                    }
+#endif
+                    child->cv.notify_all();
+                }
+                // The pid may already belong to a child started since the waitpid
+                std::lock_guard<std::mutex> lock(mu_);
+                auto it = children_.find(child->pid);
+                if (it != children_.end() && it->second == child) children_.erase(it);
+            }
+
+            int wake_[2] = {-1, -1};
+            int epfd_ = -1;
+            std::once_flag sigchld_once_;
+            std::mutex mu_;
+            std::unordered_map<int, std::shared_ptr<detail::Child>> children_;
+        };
+
+        gocxx::base::Result<void> signalChild(detail::Child& child, int sig) {
+            std::lock_guard<std::mutex> lock(child.mu);
+            if (child.reaped) return {errFinished};
+            if (::kill(child.pid, sig) != 0) return {syscallError("kill", errno)};
+            return {};
+        }
+#endif
+
+        constexpr std::size_t kCopyBuffer = 32 * 1024;
+
+        // The copiers run as tasks and so park only in their own reads and
+        // writes of the pipe, never in the caller's Reader or Writer, which
+        // may hold BlockingRegions of their own.
+
+        // The child's stdout or stderr into a Writer.
+        std::shared_ptr<gocxx::errors::Error> copyFromChild(gocxx::io::Writer& dst, File& src) {
+            std::vector<std::uint8_t> buf(kCopyBuffer);
+            for (;;) {
+                gocxx::base::Result<std::size_t> r;
+                {
+                    gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+                    r = src.Read(buf.data(), buf.size());
+                }
+                std::size_t off = 0;
+                while (off < r.value) {
+                    auto w = dst.Write(buf.data() + off, r.value - off);
+                    if (w.Failed()) return w.err;
+                    if (w.value == 0) return gocxx::io::ErrShortWrite;
+                    off += w.value;
+                }
+                if (r.Failed()) return gocxx::errors::Is(r.err, gocxx::io::ErrEOF) ? nullptr : r.err;
+                if (r.value == 0) return nullptr;
+            }
+        }
+
+#ifndef _WIN32
+        // A Reader into the child's stdin. A child that exits without reading
+        // it all is not an error.
+        std::shared_ptr<gocxx::errors::Error> copyToChild(File& dst, gocxx::io::Reader& src) {
+            std::vector<std::uint8_t> buf(kCopyBuffer);
+            for (;;) {
+                auto r = src.Read(buf.data(), buf.size());
+                std::size_t off = 0;
+                {
+                    gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::IO);
+                    while (off < r.value) {
+                        const ssize_t n = ::write(dst.Fd(), buf.data() + off, r.value - off);
+                        if (n < 0) {
+                            if (errno == EINTR) continue;
+                            return errno == EPIPE ? nullptr : syscallError("write", errno);
+                        }
+                        off += static_cast<std::size_t>(n);
+                    }
+                }
+                if (r.Failed()) return gocxx::errors::Is(r.err, gocxx::io::ErrEOF) ? nullptr : r.err;
+                if (r.value == 0) return nullptr;
+            }
+        }
+#endif
+
+        bool isExecutable(const std::string& path) {
+#ifdef _WIN32
+            return false;
+#else
+            struct stat st;
+            return ::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode) && ::access(path.c_str(), X_OK) == 0;
+#endif
+        }
+
+    } // namespace
+
+    gocxx::base::Result<std::string> LookPath(const std::string& file) {
+        if (file.find('/') != std::string::npos) {
+            if (isExecutable(file)) return {file};
+            return {"", gocxx::errors::New("exec: \"" + file + "\": " + std::strerror(errno ? errno : ENOENT))};
+        }
+        const char* env = std::getenv("PATH");
+        const std::string path = env ? env : "";
+        std::size_t start = 0;
+        for (;;) {
+            const std::size_t end = path.find(':', start);
+            std::string dir = path.substr(start, end == std::string::npos ? std::string::npos : end - start);
+            if (dir.empty()) dir = ".";  // an empty entry is the current directory
+            const std::string candidate = dir + "/" + file;
+            if (isExecutable(candidate)) return {candidate};
+            if (end == std::string::npos) break;
+            start = end + 1;
+        }
+        return {"", gocxx::errors::Wrap("exec: \"" + file + "\"", ErrNotFound)};
+    }
+
+    Cmd::Cmd(const std::string& name, std::vector<std::string> args)
+        : path(name), state_(std::make_shared<detail::CmdState>()) {
+        this->args.reserve(args.size() + 1);
+        this->args.push_back(name);
+        for (auto& a : args) this->args.push_back(std::move(a));
+        if (name.find('/') == std::string::npos) {
+            auto found = LookPath(name);
+            if (found.Failed()) {
+                lookup_err_ = found.err;
+            } else {
+                path = found.value;
+            }
+        }
+    }
+
+    // A started child is still reaped by the watcher; its copiers hold the state.
+    Cmd::~Cmd() = default;
+
+    gocxx::base::Result<std::shared_ptr<File>> Cmd::pipeFor(int childFd) {
+        static const char* const names[] = {"Stdin", "Stdout", "Stderr"};
+        const std::string name = names[childFd];
+        if (state_->started) {
+            return {nullptr, gocxx::errors::New("exec: " + name + "Pipe after process started")};
+        }
+        const bool set = childFd == 0 ? std_in != nullptr : childFd == 1 ? std_out != nullptr : std_err != nullptr;
+        if (set || state_->child_fds[childFd] >= 0) {
+            return {nullptr, gocxx::errors::New("exec: " + name + " already set")};
+        }
+#ifdef _WIN32
+        return {nullptr, gocxx::errors::New("exec: not supported on Windows")};
+#else
+        int fds[2];
+        if (auto err = cloexecPipe(fds)) return {nullptr, err};
+        const int childEnd = childFd == 0 ? fds[0] : fds[1];
+        const int parentEnd = childFd == 0 ? fds[1] : fds[0];
+        state_->child_fds[childFd] = childEnd;
+        state_->close_after_start.push_back(childEnd);
+        auto file = std::make_shared<File>(parentEnd, "|" + std::to_string(childFd));
+        state_->close_after_wait.push_back(file);
+        return {file};
+#endif
+    }
+
+    gocxx::base::Result<std::shared_ptr<File>> Cmd::StdinPipe() { return pipeFor(0); }
+    gocxx::base::Result<std::shared_ptr<File>> Cmd::StdoutPipe() { return pipeFor(1); }
+    gocxx::base::Result<std::shared_ptr<File>> Cmd::StderrPipe() { return pipeFor(2); }
+
+    gocxx::base::Result<void> Cmd::Start() {
+        if (state_->started) return {errAlreadyStarted};
+        if (lookup_err_) return {lookup_err_};
+        if (ctx_ && ctx_->Err().Failed()) return ctx_->Err();
+#ifdef _WIN32
+        return {gocxx::errors::New("exec: not supported on Windows")};
+#else
+        auto& st = *state_;
+        int fds[3] = {st.child_fds[0], st.child_fds[1], st.child_fds[2]};
+        std::vector<std::shared_ptr<File>> parentEnds;  // of the copiers' pipes
+
+        auto fail = [&](std::shared_ptr<gocxx::errors::Error> err) -> gocxx::base::Result<void> {
+            st.copiers.clear();
+            for (auto& f : parentEnds) f->close();
+            for (auto& f : st.close_after_wait) f->close();
+            return {std::move(err)};
+        };
+        auto devNull = [&](int flags) {
+            const int fd = ::open("/dev/null", flags | O_CLOEXEC);
+            if (fd >= 0) st.close_after_start.push_back(fd);
+            return fd;
+        };
+
+        for (int i = 0; i < 3; ++i) {
+            if (fds[i] >= 0) continue;
+            if (i == 0) {
+                if (!std_in) {
+                    if ((fds[0] = devNull(O_RDONLY)) < 0) return fail(syscallError("open /dev/null", errno));
+                } else if (auto file = std::dynamic_pointer_cast<File>(std_in)) {
+                    fds[0] = file->Fd();
+                } else {
+                    int p[2];
+                    if (auto err = cloexecPipe(p)) return fail(err);
+                    fds[0] = p[0];
+                    st.close_after_start.push_back(p[0]);
+                    auto w = std::make_shared<File>(p[1], "|0");
+                    parentEnds.push_back(w);
+                    st.copiers.push_back([w, src = std_in] {
+                        auto err = copyToChild(*w, *src);
+                        w->close();
+                        return err;
+                    });
+                }
+                continue;
+            }
+            auto& dst = i == 1 ? std_out : std_err;
+            if (i == 2 && std_err && std_err == std_out) {
+                fds[2] = fds[1];  // one pipe, so the two streams interleave as written
+            } else if (!dst) {
+                if ((fds[i] = devNull(O_WRONLY)) < 0) return fail(syscallError("open /dev/null", errno));
+            } else if (auto file = std::dynamic_pointer_cast<File>(dst)) {
+                fds[i] = file->Fd();
+            } else {
+                int p[2];
+                if (auto err = cloexecPipe(p)) return fail(err);
+                fds[i] = p[1];
+                st.close_after_start.push_back(p[1]);
+                auto r = std::make_shared<File>(p[0], "|" + std::to_string(i));
+                parentEnds.push_back(r);
+                st.copiers.push_back([r, dst] {
+                    auto err = copyFromChild(*dst, *r);
+                    r->close();
+                    return err;
+                });
+            }
+        }
+
+        // dup2 onto 0-2 from a descriptor already among them could clobber
+        // another stream, and dup2 of a descriptor onto itself would leave it
+        // close-on-exec, so move those out of the way first.
+        for (int i = 0; i < 3; ++i) {
+            if (fds[i] > 2) continue;
+            const int moved = ::fcntl(fds[i], F_DUPFD_CLOEXEC, 3);
+            if (moved < 0) return fail(syscallError("fcntl", errno));
+            st.close_after_start.push_back(moved);
+            for (int j = i + 1; j < 3; ++j) {
+                if (fds[j] == fds[i]) fds[j] = moved;
+            }
+            fds[i] = moved;
+        }
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        for (int i = 0; i < 3; ++i) posix_spawn_file_actions_adddup2(&actions, fds[i], i);
+        if (!dir.empty()) {
+#ifdef GOCXX_SPAWN_CHDIR
+            posix_spawn_file_actions_addchdir_np(&actions, dir.c_str());
+#else
+            posix_spawn_file_actions_destroy(&actions);
+            return fail(gocxx::errors::New("exec: dir is not supported by this C library's posix_spawn"));
+#endif
+        }
+
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        sigset_t none, all;
+        sigemptyset(&none);
+        sigfillset(&all);
+        sigdelset(&all, SIGKILL);
+        sigdelset(&all, SIGSTOP);
+        posix_spawnattr_setsigmask(&attr, &none);
+        posix_spawnattr_setsigdefault(&attr, &all);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+        std::vector<char*> argv;
+        argv.reserve(args.size() + 2);
+        if (args.empty()) argv.push_back(const_cast<char*>(path.c_str()));
+        for (auto& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+        argv.push_back(nullptr);
+        std::vector<char*> envp;
+        if (env) {
+            envp.reserve(env->size() + 1);
+            for (auto& e : *env) envp.push_back(const_cast<char*>(e.c_str()));
+            envp.push_back(nullptr);
+        }
+
+        pid_t pid = 0;
+        const int rc = ::posix_spawn(&pid, path.c_str(), &actions, &attr, argv.data(), env ? envp.data() : environ);
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attr);
+        for (int fd : st.close_after_start) ::close(fd);
+        st.close_after_start.clear();
+        if (rc != 0) {
+            return fail(gocxx::errors::New("fork/exec " + path + ": " + std::strerror(rc)));
+        }
+
+        st.started = true;
+        st.child = std::make_shared<detail::Child>();
+        st.child->pid = pid;
+        Reaper::instance().watch(st.child);
+
+        for (auto& copier : st.copiers) {
+            st.copying.Add(1);
+            gocxx::go([state = state_, copier = std::move(copier)] {
+                auto err = copier();
+                if (err) {
+                    std::lock_guard<std::mutex> lock(state->err_mu);
+                    if (!state->copy_err) state->copy_err = err;
+                }
+                state->copying.Done();
+            });
+        }
+        st.copiers.clear();
+
+        if (ctx_) {
+            st.stop_watching = context::AfterCancel(ctx_, [child = st.child, state = std::weak_ptr<detail::CmdState>(state_),
+                                                           sig = cancel_signal] {
+                if (auto s = state.lock()) s->cancelled = true;
+                if (sig) (void)signalChild(*child, sig->Code());
+            });
+        }
+        return {};
+#endif
+    }
+
+    gocxx::base::Result<void> Cmd::Wait() {
+        auto& st = *state_;
+        if (!st.started) return {errNotStarted};
+        if (st.waited) return {errWaitCalled};
+        st.waited = true;
+#ifdef _WIN32
+        return {errNotStarted};
+#else
+        int status, waitErrno;
+        {
+            std::unique_lock<std::mutex> lock(st.child->mu);
+            if (!st.child->reaped) {
+                gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::Syscall);
+                st.child->cv.wait(lock, [&] { return st.child->reaped; });
+            }
+            status = st.child->status;
+            waitErrno = st.child->wait_errno;
+        }
+        if (st.stop_watching) st.stop_watching();
+        st.copying.Wait();
+        for (auto& f : st.close_after_wait) f->close();
+        st.close_after_wait.clear();
+
+        if (waitErrno != 0) return {syscallError("waitpid", waitErrno)};
+
+        auto ps = std::make_shared<ProcessState>();
+        ps->pid = st.child->pid;
+        ps->exited = WIFEXITED(status);
+        ps->exitCode = ps->exited ? WEXITSTATUS(status) : -1;
+        ps->signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+        ps->userTime = std::chrono::system_clock::now();
+        ps->systemTime = ps->userTime;
+        process_state = ps;
+
+        if (!ps->exited || ps->exitCode != 0) {
+            if (st.cancelled && ctx_ && ctx_->Err().Failed()) return ctx_->Err();
+            return {std::make_shared<ExitError>(ps)};
+        }
+        std::lock_guard<std::mutex> lock(st.err_mu);
+        return {st.copy_err};
+#endif
+    }
+
+    gocxx::base::Result<void> Cmd::Run() {
+        auto started = Start();
+        if (started.Failed()) return started;
+        return Wait();
+    }
+
+    gocxx::base::Result<std::string> Cmd::Output() {
+        if (std_out) return {"", gocxx::errors::New("exec: Stdout already set")};
+        auto out = std::make_shared<gocxx::bytes::Buffer>();
+        std::shared_ptr<gocxx::bytes::Buffer> errOut;
+        std_out = out;
+        if (!std_err && state_->child_fds[2] < 0) {
+            errOut = std::make_shared<gocxx::bytes::Buffer>();
+            std_err = errOut;
+        }
+        auto done = Run();
+        std::shared_ptr<ExitError> exitErr;
+        if (errOut && done.Failed() && gocxx::errors::As(done.err, exitErr)) {
+            exitErr->stderr_output = errOut->String();
+        }
+        return {out->String(), done.err};
+    }
+
+    gocxx::base::Result<std::string> Cmd::CombinedOutput() {
+        if (std_out) return {"", gocxx::errors::New("exec: Stdout already set")};
+        if (std_err) return {"", gocxx::errors::New("exec: Stderr already set")};
+        auto out = std::make_shared<gocxx::bytes::Buffer>();
+        std_out = out;
+        std_err = out;
+        auto done = Run();
+        return {out->String(), done.err};
+    }
+
+    int Cmd::Pid() const {
+        return state_->child ? state_->child->pid : 0;
+    }
+
+    gocxx::base::Result<void> Cmd::Signal(std::shared_ptr<os::Signal> sig) {
+        if (!state_->child) return {errNotStarted};
+#ifdef _WIN32
+        return {errNotStarted};
+#else
+        return signalChild(*state_->child, sig->Code());
+#endif
+    }
+
+    gocxx::base::Result<void> Cmd::Kill() {
+        return Signal(os::Kill);
+    }
+
+    std::shared_ptr<Cmd> Command(const std::string& name, std::vector<std::string> args) {
+        return std::make_shared<Cmd>(name, std::move(args));
+    }
+
+    std::shared_ptr<Cmd> CommandContext(context::ContextPtr ctx, const std::string& name,
+                                        std::vector<std::string> args) {
+        if (!ctx) throw std::invalid_argument("exec: nil Context");
+        auto cmd = std::make_shared<Cmd>(name, std::move(args));
+        cmd->ctx_ = std::move(ctx);
+        return cmd;
+    }
+
+} // namespace gocxx::os::exec
@@ -1,4 +1,5 @@
 #include "gocxx/os/file.h"
+#include "gocxx/io/io_errors.h"
 #include <errno.h>
 #include <cstring>
 #include <random>
@@ -54,6 +55,8 @@ namespace gocxx::os {
     std::shared_ptr<gocxx::errors::Error> ErrClosed = gocxx::errors::New("file already closed");
     std::shared_ptr<gocxx::errors::Error> ErrNoDeadline = gocxx::errors::New("file type does not support deadline");
     std::shared_ptr<gocxx::errors::Error> ErrDeadlineExceeded = gocxx::errors::New("deadline exceeded");
+    std::shared_ptr<gocxx::errors::Error> SkipDir = gocxx::errors::New("skip this directory");
+    std::shared_ptr<gocxx::errors::Error> SkipAll = gocxx::errors::New("skip everything and stop the walk");
 
     // Standard file descriptors
 #ifdef _WIN32
@@ -153,6 +156,77 @@ namespace gocxx::os {
         return {static_cast<std::size_t>(result), nullptr};
     }
 
+    gocxx::base::Result<std::size_t> File::WriteBuffers(const gocxx::io::Buffers& bufs) {
+        if (closed) {
+            return {0, ErrClosed};
+        }
+
+#ifdef _WIN32
+        std::size_t total = 0;
+        for (const auto& b : bufs) {
+            std::size_t done = 0;
+            while (done < b.size) {
+                int result = _write(fd, b.data + done, static_cast<unsigned int>(b.size - done));
+                if (result < 0) {
+                    return {total, std::make_shared<PathError>("write", name, errnoToError(errno))};
+                }
+                if (result == 0) {
+                    return {total, gocxx::io::ErrShortWrite};
+                }
+                done += static_cast<std::size_t>(result);
+                total += static_cast<std::size_t>(result);
+            }
+        }
+        return {total, nullptr};
+#else
+        int errnum = 0;
+        std::size_t total = gocxx::io::detail::fdWriteBuffers(fd, bufs, false, errnum);
+        if (errnum != 0) {
+            return {total, std::make_shared<PathError>("writev", name, errnoToError(errnum))};
+        }
+        if (total < gocxx::io::detail::totalSize(bufs)) {
+            return {total, gocxx::io::ErrShortWrite};
+        }
+        return {total, nullptr};
+#endif
+    }
+
+    gocxx::base::Result<std::size_t> File::ReadBuffers(const gocxx::io::MutableBuffers& bufs) {
+        if (closed) {
+            return {0, ErrClosed};
+        }
+
+#ifdef _WIN32
+        for (const auto& b : bufs) {
+            if (b.size != 0) {
+                return Read(b.data, b.size);
+            }
+        }
+        return {0, nullptr};
+#else
+        int errnum = 0;
+        long result = gocxx::io::detail::fdReadBuffers(fd, bufs, false, errnum);
+        if (result < 0) {
+            return {0, std::make_shared<PathError>("readv", name, errnoToError(errnum))};
+        }
+        return {static_cast<std::size_t>(result), nullptr};
+#endif
+    }
+
+    gocxx::base::Result<std::size_t> File::WriteTo(std::shared_ptr<gocxx::io::Writer> w) {
+        if (closed) {
+            return {0, ErrClosed};
+        }
+        return gocxx::io::detail::fdWriteTo(fd, *this, std::move(w));
+    }
+
+    gocxx::base::Result<std::size_t> File::ReadFrom(std::shared_ptr<gocxx::io::Reader> r) {
+        if (closed) {
+            return {0, ErrClosed};
+        }
+        return gocxx::io::detail::fdReadFrom(fd, *this, std::move(r));
+    }
+
     void File::close() {
         if (!closed && fd >= 0) {
 #ifdef _WIN32
@@ -171,33 +245,58 @@ namespace gocxx::os {
 
 #ifdef _WIN32
         auto seekRes = _lseek(fd, static_cast<long>(offset), SEEK_SET);
-#else
-        auto seekRes = lseek(fd, static_cast<off_t>(offset), SEEK_SET);
-#endif
         if (seekRes < 0) {
             auto err = std::make_shared<PathError>("readAt-lseek", name, errnoToError(errno));
             return {0, err};
         }
 
         return Read(buffer, size);
+#else
+        // pread leaves the file offset alone, so concurrent ReadAt calls on
+        // one File do not race. Like Go, a short read means end of file.
+        std::size_t total = 0;
+        while (total < size) {
+            ssize_t n = ::pread(fd, buffer + total, size - total, static_cast<off_t>(offset + total));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                auto err = std::make_shared<PathError>("readAt", name, errnoToError(errno));
+                return {total, err};
+            }
+            if (n == 0) {
+                return {total, gocxx::io::ErrEOF};
+            }
+            total += static_cast<std::size_t>(n);
+        }
+        return {total, nullptr};
+#endif
     }
 
     gocxx::base::Result<std::size_t> File::WriteAt(const uint8_t* buffer, std::size_t size, std::size_t offset) {
         if (closed) {
             return {0, ErrClosed};
         }
-        
+
 #ifdef _WIN32
         auto seekRes = _lseek(fd, static_cast<long>(offset), SEEK_SET);
-#else
-        auto seekRes = lseek(fd, static_cast<off_t>(offset), SEEK_SET);
-#endif
         if (seekRes < 0) {
             auto err = std::make_shared<PathError>("writeAt-lseek", name, errnoToError(errno));
             return {0, err};
         }
-        
+
         return Write(buffer, size);
+#else
+        std::size_t total = 0;
+        while (total < size) {
+            ssize_t n = ::pwrite(fd, buffer + total, size - total, static_cast<off_t>(offset + total));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                auto err = std::make_shared<PathError>("writeAt", name, errnoToError(errno));
+                return {total, err};
+            }
+            total += static_cast<std::size_t>(n);
+        }
+        return {total, nullptr};
+#endif
     }
 
     gocxx::base::Result<std::size_t> File::Seek(std::size_t offset, gocxx::io::whence whence) {
@@ -599,15 +698,28 @@ namespace gocxx::os {
             return {std::vector<uint8_t>(), statResult.err};
         }
         
+        // Stat is only a hint: files in /proc report 0 and others may change
+        // size while being read, so read until EOF and grow as needed.
         auto info = statResult.value;
-        std::vector<uint8_t> data(info.size);
+        std::size_t capacity = info.size > 0 ? static_cast<std::size_t>(info.size) + 1 : 512;
+        std::vector<uint8_t> data(capacity);
+        std::size_t total = 0;
         
-        auto readResult = file->Read(data.data(), data.size());
-        if (readResult.Failed()) {
-            return {std::vector<uint8_t>(), readResult.err};
+        while (true) {
+            if (total == data.size()) {
+                data.resize(data.size() * 2);
+            }
+            auto readResult = file->Read(data.data() + total, data.size() - total);
+            if (readResult.Failed()) {
+                return {std::vector<uint8_t>(), readResult.err};
+            }
+            if (readResult.value == 0) {
+                break;
+            }
+            total += readResult.value;
         }
         
-        data.resize(readResult.value); 
+        data.resize(total);
         return {data, nullptr};
     }
 
@@ -0,0 +1,223 @@
+#include "gocxx/os/mmap.h"
+#include "gocxx/io/io_errors.h"
+#include <errno.h>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gocxx::os {
+
+    // Defined in file.cpp
+    std::shared_ptr<gocxx::errors::Error> errnoToError(int errnum);
+
+    // ========== MAPPEDFILE CLASS IMPLEMENTATION ==========
+
+    MappedFile::MappedFile(uint8_t* data, std::size_t size, MapMode mode, std::string name)
+        : data_(data), size_(size), mode_(mode), name_(std::move(name)) {}
+
+    MappedFile::~MappedFile() {
+        if (!closed_) {
+            Close();
+        }
+    }
+
+    gocxx::base::Result<std::size_t> MappedFile::ReadAt(uint8_t* buffer, std::size_t size, std::size_t offset) {
+        if (closed_) {
+            return {0, ErrClosed};
+        }
+        if (offset >= size_) {
+            return {0, gocxx::io::ErrEOF};
+        }
+
+        std::size_t n = std::min(size, size_ - offset);
+        std::memcpy(buffer, data_ + offset, n);
+        if (n < size) {
+            return {n, gocxx::io::ErrEOF};
+        }
+        return {n, nullptr};
+    }
+
+    gocxx::base::Result<std::size_t> MappedFile::WriteAt(const uint8_t* buffer, std::size_t size, std::size_t offset) {
+        if (closed_) {
+            return {0, ErrClosed};
+        }
+        if (mode_ != MapMode::ReadWrite) {
+            return {0, std::make_shared<PathError>("write", name_, ErrPermission)};
+        }
+        if (offset > size_ || size > size_ - offset) {
+            return {0, std::make_shared<PathError>("write", name_, gocxx::io::ErrShortWrite)};
+        }
+
+        std::memcpy(data_ + offset, buffer, size);
+        return {size, nullptr};
+    }
+
+    gocxx::base::Result<void> MappedFile::Advise(MapAdvice advice) {
+        return Advise(advice, 0, size_);
+    }
+
+    gocxx::base::Result<void> MappedFile::Advise(MapAdvice advice, std::size_t offset, std::size_t length) {
+        if (closed_) {
+            return {ErrClosed};
+        }
+        if (offset > size_ || length > size_ - offset) {
+            return {std::make_shared<PathError>("madvise", name_, ErrInvalid)};
+        }
+        if (length == 0) {
+            return {};
+        }
+
+#ifdef _WIN32
+        // No madvise equivalent that fits; the hints are optional anyway.
+        (void)advice;
+        return {};
+#else
+        int native = MADV_NORMAL;
+        switch (advice) {
+            case MapAdvice::Normal:     native = MADV_NORMAL; break;
+            case MapAdvice::Sequential: native = MADV_SEQUENTIAL; break;
+            case MapAdvice::Random:     native = MADV_RANDOM; break;
+            case MapAdvice::WillNeed:   native = MADV_WILLNEED; break;
+            case MapAdvice::DontNeed:   native = MADV_DONTNEED; break;
+        }
+
+        // madvise wants a page-aligned start
+        static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        std::size_t aligned = offset - offset % pageSize;
+        if (::madvise(data_ + aligned, length + (offset - aligned), native) != 0) {
+            return {std::make_shared<PathError>("madvise", name_, errnoToError(errno))};
+        }
+        return {};
+#endif
+    }
+
+    gocxx::base::Result<void> MappedFile::Sync() {
+        if (closed_) {
+            return {ErrClosed};
+        }
+        if (mode_ != MapMode::ReadWrite || size_ == 0) {
+            return {};
+        }
+
+#ifdef _WIN32
+        if (!FlushViewOfFile(data_, 0)) {
+            return {std::make_shared<PathError>("msync", name_, gocxx::errors::New("FlushViewOfFile failed"))};
+        }
+#else
+        if (::msync(data_, size_, MS_SYNC) != 0) {
+            return {std::make_shared<PathError>("msync", name_, errnoToError(errno))};
+        }
+#endif
+        return {};
+    }
+
+    gocxx::base::Result<void> MappedFile::Close() {
+        if (closed_) {
+            return {ErrClosed};
+        }
+        closed_ = true;
+        if (size_ == 0) {
+            return {};
+        }
+
+#ifdef _WIN32
+        if (!UnmapViewOfFile(data_)) {
+            return {std::make_shared<PathError>("munmap", name_, gocxx::errors::New("UnmapViewOfFile failed"))};
+        }
+#else
+        if (::munmap(data_, size_) != 0) {
+            return {std::make_shared<PathError>("munmap", name_, errnoToError(errno))};
+        }
+#endif
+        data_ = nullptr;
+        return {};
+    }
+
+    // ========== MAPPING FUNCTIONS ==========
+
+    gocxx::base::Result<std::shared_ptr<MappedFile>> MapFile(File& f, MapMode mode) {
+        if (f.IsClosed()) {
+            return {nullptr, ErrClosed};
+        }
+
+        auto statResult = f.Stat();
+        if (statResult.Failed()) {
+            return {nullptr, statResult.err};
+        }
+        if (statResult.value.size < 0 ||
+            static_cast<uint64_t>(statResult.value.size) > static_cast<uint64_t>(SIZE_MAX)) {
+            return {nullptr, std::make_shared<PathError>("mmap", f.Name(), ErrInvalid)};
+        }
+
+        std::size_t size = static_cast<std::size_t>(statResult.value.size);
+        if (size == 0) {
+            // Zero-length mappings are not allowed; an empty view needs none.
+            return {std::make_shared<MappedFile>(nullptr, 0, mode, f.Name()), nullptr};
+        }
+
+#ifdef _WIN32
+        HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(f.Fd()));
+        DWORD protect = mode == MapMode::ReadWrite ? PAGE_READWRITE : PAGE_READONLY;
+        HANDLE mapping = CreateFileMappingA(file, nullptr, protect, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            return {nullptr, std::make_shared<PathError>("mmap", f.Name(), gocxx::errors::New("CreateFileMapping failed"))};
+        }
+        DWORD access = mode == MapMode::ReadWrite ? FILE_MAP_WRITE : FILE_MAP_READ;
+        void* addr = MapViewOfFile(mapping, access, 0, 0, size);
+        CloseHandle(mapping);  // the view keeps the mapping alive
+        if (addr == nullptr) {
+            return {nullptr, std::make_shared<PathError>("mmap", f.Name(), gocxx::errors::New("MapViewOfFile failed"))};
+        }
+#else
+        int prot = mode == MapMode::ReadWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* addr = ::mmap(nullptr, size, prot, MAP_SHARED, f.Fd(), 0);
+        if (addr == MAP_FAILED) {
+            return {nullptr, std::make_shared<PathError>("mmap", f.Name(), errnoToError(errno))};
+        }
+#endif
+
+        return {std::make_shared<MappedFile>(static_cast<uint8_t*>(addr), size, mode, f.Name()), nullptr};
+    }
+
+    gocxx::base::Result<std::shared_ptr<MappedFile>> MapFile(const std::string& name, MapMode mode) {
+        int flag = mode == MapMode::ReadWrite ? static_cast<int>(OpenFlag::RDWR) : static_cast<int>(OpenFlag::RDONLY);
+        auto fileResult = OpenFile(name, flag, 0);
+        if (fileResult.Failed()) {
+            return {nullptr, fileResult.err};
+        }
+        // The mapping outlives the descriptor, which closes here.
+        return MapFile(*fileResult.value, mode);
+    }
+
+    gocxx::base::Result<FileContents> ReadFileMapped(const std::string& name, std::size_t threshold) {
+        auto statResult = Stat(name);
+        if (statResult.Failed()) {
+            return {FileContents{}, statResult.err};
+        }
+
+        const auto& info = statResult.value;
+        if (!info.IsRegular() || info.size < 0 || static_cast<uint64_t>(info.size) < threshold) {
+            auto readResult = ReadFile(name);
+            if (readResult.Failed()) {
+                return {FileContents{}, readResult.err};
+            }
+            return {FileContents(std::move(readResult.value)), nullptr};
+        }
+
+        auto mapResult = MapFile(name, MapMode::ReadOnly);
+        if (mapResult.Failed()) {
+            return {FileContents{}, mapResult.err};
+        }
+        mapResult.value->Advise(MapAdvice::Sequential);
+        return {FileContents(std::move(mapResult.value)), nullptr};
+    }
+
+} // namespace gocxx::os
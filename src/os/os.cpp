@@ -481,6 +481,7 @@ namespace gocxx::os {
         state->pid = pid_;
         state->exited = WIFEXITED(status);
         state->exitCode = WEXITSTATUS(status);
+        state->signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
         state->userTime = std::chrono::system_clock::now();
         state->systemTime = std::chrono::system_clock::now();
         
@@ -583,4 +584,17 @@ namespace gocxx::os {
         return {fullPath, nullptr};
     }
 
+    gocxx::base::Result<std::pair<std::shared_ptr<File>, std::shared_ptr<File>>> Pipe() {
+        using PipeFiles = std::pair<std::shared_ptr<File>, std::shared_ptr<File>>;
+        int fds[2];
+#ifdef _WIN32
+        if (_pipe(fds, 65536, _O_BINARY) != 0) {
+#else
+        if (::pipe(fds) != 0) {
+#endif
+            return {PipeFiles(), gocxx::errors::New(std::string("pipe: ") + std::strerror(errno))};
+        }
+        return {PipeFiles(std::make_shared<File>(fds[0], "|0"), std::make_shared<File>(fds[1], "|1")), nullptr};
+    }
+
 } // namespace gocxx::os
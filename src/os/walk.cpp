@@ -0,0 +1,383 @@
+#include "gocxx/os/walk.h"
+#include "gocxx/os/os.h"
+
+#include <gocxx/runtime/blocking.h>
+#include <gocxx/runtime/deque.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace gocxx::os {
+
+    // Defined in file.cpp
+    std::shared_ptr<gocxx::errors::Error> errnoToError(int errnum);
+
+    namespace {
+        std::string joinPath(const std::string& dir, const char* name) {
+            std::string path;
+            path.reserve(dir.size() + 1 + std::strlen(name));
+            path = dir;
+            if (path.empty() || (path.back() != '/' && path.back() != '\\')) path.push_back('/');
+            path += name;
+            return path;
+        }
+
+#ifndef _WIN32
+        FileMode typeFromStatMode(mode_t m) {
+            if (S_ISREG(m)) return 0;
+            if (S_ISDIR(m)) return ModeDir;
+            if (S_ISLNK(m)) return ModeSymlink;
+            if (S_ISFIFO(m)) return ModeNamedPipe;
+            if (S_ISSOCK(m)) return ModeSocket;
+            if (S_ISBLK(m)) return ModeDevice;
+            if (S_ISCHR(m)) return ModeDevice | ModeCharDevice;
+            return ModeIrregular;
+        }
+
+        // Type bits straight from the listing; false when the filesystem
+        // left them out (DT_UNKNOWN) and a stat is needed after all
+        bool typeFromDirent(unsigned char t, FileMode& type) {
+            switch (t) {
+                case DT_REG:  type = 0; return true;
+                case DT_DIR:  type = ModeDir; return true;
+                case DT_LNK:  type = ModeSymlink; return true;
+                case DT_FIFO: type = ModeNamedPipe; return true;
+                case DT_SOCK: type = ModeSocket; return true;
+                case DT_BLK:  type = ModeDevice; return true;
+                case DT_CHR:  type = ModeDevice | ModeCharDevice; return true;
+                default:      return false;
+            }
+        }
+#endif
+
+        std::shared_ptr<gocxx::errors::Error> lstatType(const std::string& path, FileMode& type) {
+#ifdef _WIN32
+            DWORD attrs = GetFileAttributesA(path.c_str());
+            if (attrs == INVALID_FILE_ATTRIBUTES) {
+                return std::make_shared<PathError>("lstat", path, ErrNotExist);
+            }
+            type = (attrs & FILE_ATTRIBUTE_REPARSE_POINT) ? ModeSymlink
+                 : (attrs & FILE_ATTRIBUTE_DIRECTORY)     ? ModeDir
+                                                          : 0;
+#else
+            struct stat st;
+            if (::lstat(path.c_str(), &st) != 0) {
+                return std::make_shared<PathError>("lstat", path, errnoToError(errno));
+            }
+            type = typeFromStatMode(st.st_mode);
+#endif
+            return nullptr;
+        }
+
+        // Lists dir, calling visit(name, type) per entry until it returns
+        // false. buf is scratch space for the getdents64 batches.
+        template <typename Visit>
+        std::shared_ptr<gocxx::errors::Error> listDir(const std::string& dir, char* buf, std::size_t bufSize, Visit visit) {
+#ifdef _WIN32
+            (void)buf;
+            (void)bufSize;
+            WIN32_FIND_DATAA data;
+            HANDLE h = FindFirstFileA((dir + "\\*").c_str(), &data);
+            if (h == INVALID_HANDLE_VALUE) {
+                return std::make_shared<PathError>("FindFirstFile", dir, gocxx::errors::New("cannot list directory"));
+            }
+            do {
+                const char* name = data.cFileName;
+                if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0) continue;
+                FileMode type = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) ? ModeSymlink
+                              : (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)     ? ModeDir
+                                                                                       : 0;
+                if (!visit(name, type)) break;
+            } while (FindNextFileA(h, &data));
+            FindClose(h);
+            return nullptr;
+#elif defined(__linux__)
+            int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0) {
+                return std::make_shared<PathError>("open", dir, errnoToError(errno));
+            }
+
+            struct linuxDirent64 {
+                uint64_t d_ino;
+                int64_t d_off;
+                unsigned short d_reclen;
+                unsigned char d_type;
+                char d_name[1];
+            };
+
+            std::shared_ptr<gocxx::errors::Error> err;
+            for (bool more = true; more;) {
+                long n = ::syscall(SYS_getdents64, fd, buf, bufSize);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    err = std::make_shared<PathError>("getdents64", dir, errnoToError(errno));
+                    break;
+                }
+                if (n == 0) break;
+
+                for (long off = 0; off < n && more;) {
+                    auto* d = reinterpret_cast<linuxDirent64*>(buf + off);
+                    off += d->d_reclen;
+                    const char* name = d->d_name;
+                    if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+                    FileMode type = 0;
+                    if (!typeFromDirent(d->d_type, type) && lstatType(joinPath(dir, name), type)) {
+                        continue;  // vanished since the listing
+                    }
+                    more = visit(name, type);
+                }
+            }
+            ::close(fd);
+            return err;
+#else
+            (void)buf;
+            (void)bufSize;
+            DIR* d = ::opendir(dir.c_str());
+            if (!d) {
+                return std::make_shared<PathError>("opendir", dir, errnoToError(errno));
+            }
+            while (struct dirent* e = ::readdir(d)) {
+                const char* name = e->d_name;
+                if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0) continue;
+
+                FileMode type = 0;
+                if (!typeFromDirent(e->d_type, type) && lstatType(joinPath(dir, name), type)) {
+                    continue;
+                }
+                if (!visit(name, type)) break;
+            }
+            ::closedir(d);
+            return nullptr;
+#endif
+        }
+
+        class ParallelWalker {
+        public:
+            ParallelWalker(context::ContextPtr ctx, std::size_t workers, const WalkDirFunc& fn)
+                : ctx_(std::move(ctx)), fn_(fn) {
+                for (std::size_t i = 0; i < workers; ++i) {
+                    queues_.push_back(std::make_unique<runtime::WorkStealingDeque<std::string*>>());
+                }
+            }
+
+            ~ParallelWalker() {
+                // Directories left behind by a stopped walk
+                std::string* dir;
+                for (auto& q : queues_) {
+                    while (q->pop(dir)) delete dir;
+                }
+            }
+
+            // Queues dir on worker w's deque; only worker w (or the caller
+            // before the workers start) may do this.
+            void push(std::size_t w, std::string dir) {
+                pending_.fetch_add(1, std::memory_order_relaxed);
+                queues_[w]->push(new std::string(std::move(dir)));
+                if (sleepers_.load(std::memory_order_relaxed) > 0) cv_.notify_one();
+            }
+
+            gocxx::base::Result<void> run() {
+                std::vector<std::thread> threads;
+                threads.reserve(queues_.size());
+                for (std::size_t w = 0; w < queues_.size(); ++w) {
+                    threads.emplace_back([this, w] { work(w); });
+                }
+                {
+                    gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::WaitGroup);
+                    for (auto& t : threads) t.join();
+                }
+                return {err_};
+            }
+
+        private:
+            void work(std::size_t w) {
+                std::vector<char> buf(kWalkBatchEntries * 32);
+                uint32_t seed = static_cast<uint32_t>(w) * 2654435761u + 1;
+
+                while (!stop_.load(std::memory_order_relaxed)) {
+                    std::string* dir = nullptr;
+                    if (queues_[w]->pop(dir) || steal(w, seed, dir)) {
+                        visitDir(w, *dir, buf);
+                        delete dir;
+                        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                            std::lock_guard<std::mutex> lock(mtx_);
+                            cv_.notify_all();
+                        }
+                        continue;
+                    }
+                    if (pending_.load(std::memory_order_acquire) == 0) break;
+
+                    // Everything queued is being listed elsewhere; wait for
+                    // more (the timeout covers a push racing the check)
+                    std::unique_lock<std::mutex> lock(mtx_);
+                    sleepers_.fetch_add(1, std::memory_order_relaxed);
+                    {
+                        gocxx::runtime::BlockingRegion blocking(gocxx::runtime::WaitReason::WaitGroup);
+                        cv_.wait_for(lock, std::chrono::milliseconds(1));
+                    }
+                    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+
+            bool steal(std::size_t w, uint32_t& seed, std::string*& out) {
+                const std::size_t n = queues_.size();
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                const std::size_t start = seed % n;
+                for (std::size_t i = 0; i < n; ++i) {
+                    const std::size_t victim = (start + i) % n;
+                    if (victim != w && queues_[victim]->steal(out)) return true;
+                }
+                return false;
+            }
+
+            void visitDir(std::size_t w, const std::string& dir, std::vector<char>& buf) {
+                if (cancelled()) return;
+
+                auto err = listDir(dir, buf.data(), buf.size(), [&](const char* name, FileMode type) {
+                    if (stop_.load(std::memory_order_relaxed)) return false;
+
+                    WalkEntry entry(joinPath(dir, name), type);
+                    auto res = fn_(entry, nullptr);
+                    if (res.Failed()) {
+                        if (gocxx::errors::Is(res.err, SkipDir)) return entry.IsDir();  // a file skips its siblings
+                        finish(gocxx::errors::Is(res.err, SkipAll) ? nullptr : res.err);
+                        return false;
+                    }
+                    if (entry.IsDir()) push(w, entry.Path());
+                    return true;
+                });
+
+                if (err && !stop_.load(std::memory_order_relaxed)) {
+                    // Second call for the directory, as in Go's WalkDir
+                    auto res = fn_(WalkEntry(dir, ModeDir), err);
+                    if (res.Failed() && !gocxx::errors::Is(res.err, SkipDir)) {
+                        finish(gocxx::errors::Is(res.err, SkipAll) ? nullptr : res.err);
+                    }
+                }
+            }
+
+            bool cancelled() {
+                if (!ctx_) return false;
+                auto res = ctx_->Err();
+                if (res.Ok()) return false;
+                finish(res.err);
+                return true;
+            }
+
+            // Stops every worker; the first error wins.
+            void finish(std::shared_ptr<gocxx::errors::Error> err) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (!stop_.load(std::memory_order_relaxed)) err_ = std::move(err);
+                stop_.store(true, std::memory_order_relaxed);
+                cv_.notify_all();
+            }
+
+            context::ContextPtr ctx_;
+            const WalkDirFunc& fn_;
+            std::vector<std::unique_ptr<runtime::WorkStealingDeque<std::string*>>> queues_;
+            std::atomic<std::size_t> pending_{0};  // directories queued or being listed
+            std::atomic<bool> stop_{false};
+            std::atomic<std::size_t> sleepers_{0};
+            std::mutex mtx_;
+            std::condition_variable cv_;
+            std::shared_ptr<gocxx::errors::Error> err_;
+        };
+
+        gocxx::base::Result<void> walk(const std::string& path, const FileInfo& info,
+                                       const std::function<gocxx::base::Result<void>(const std::string&, const FileInfo&)>& walkFn) {
+            auto res = walkFn(path, info);
+            if (res.Failed() || !info.IsDir()) {
+                return res;
+            }
+
+            auto entries = ReadDir(path);
+            if (entries.Failed()) {
+                return {entries.err};
+            }
+            std::sort(entries.value.begin(), entries.value.end(),
+                      [](const DirEntry& a, const DirEntry& b) { return a.name < b.name; });
+
+            for (const auto& e : entries.value) {
+                std::string child = joinPath(path, e.name.c_str());
+                auto childInfo = Lstat(child);
+                if (childInfo.Failed()) {
+                    if (gocxx::errors::Is(childInfo.err, ErrNotExist)) continue;  // removed meanwhile
+                    return {childInfo.err};
+                }
+                res = walk(child, childInfo.value, walkFn);
+                if (res.Failed()) {
+                    // SkipDir from a directory only skips that directory
+                    if (!childInfo.value.IsDir() || !gocxx::errors::Is(res.err, SkipDir)) return res;
+                }
+            }
+            return {};
+        }
+    }
+
+    gocxx::base::Result<void> Walk(
+        const std::string& root,
+        std::function<gocxx::base::Result<void>(const std::string& path, const FileInfo& info)> walkFn) {
+        auto info = Lstat(root);
+        if (info.Failed()) {
+            return {info.err};
+        }
+        auto res = walk(root, info.value, walkFn);
+        if (res.Failed() && (gocxx::errors::Is(res.err, SkipDir) || gocxx::errors::Is(res.err, SkipAll))) {
+            return {};
+        }
+        return res;
+    }
+
+    gocxx::base::Result<void> WalkParallel(context::ContextPtr ctx, const std::string& root,
+                                           std::size_t workers, WalkDirFunc fn) {
+        if (workers == 0) {
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        FileMode type = 0;
+        if (auto err = lstatType(root, type)) {
+            auto res = fn(WalkEntry(root, 0), err);
+            return gocxx::errors::Is(res.err, SkipDir) || gocxx::errors::Is(res.err, SkipAll) ? gocxx::base::Result<void>() : res;
+        }
+
+        WalkEntry rootEntry(root, type);
+        auto res = fn(rootEntry, nullptr);
+        if (res.Failed()) {
+            return gocxx::errors::Is(res.err, SkipDir) || gocxx::errors::Is(res.err, SkipAll) ? gocxx::base::Result<void>() : res;
+        }
+        if (!rootEntry.IsDir()) {
+            return {};
+        }
+
+        ParallelWalker walker(std::move(ctx), workers, fn);
+        walker.push(0, root);
+        return walker.run();
+    }
+
+    gocxx::base::Result<void> WalkParallel(const std::string& root, std::size_t workers, WalkDirFunc fn) {
+        return WalkParallel(nullptr, root, workers, std::move(fn));
+    }
+
+} // namespace gocxx::os
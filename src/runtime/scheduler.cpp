@@ -0,0 +1,545 @@
+/**
+ * @file scheduler.cpp
+ * @brief Work-stealing scheduler behind gocxx::go()
+ *
+ * Terminology follows the Go runtime: a Processor (P) is the right to run
+ * tasks and owns a local run queue; a Machine (M) is an OS thread. An M
+ * needs a P to pick up tasks. Ms are started lazily, up to one per idle P,
+ * and an M that enters a BlockingRegion gives its P away so another M can
+ * keep that P's queue moving.
+ */
+
+#include <gocxx/runtime/runtime.h>
+#include <gocxx/runtime/deque.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace gocxx::runtime {
+
+namespace {
+
+struct Task {
+    Task(std::function<void()> f, std::uint64_t i) : fn(std::move(f)), id(i) {}
+    std::function<void()> fn;
+    std::uint64_t id;
+    Task* next = nullptr;
+};
+
+struct Processor {
+    explicit Processor(int i) : id(i) {}
+    int id;
+    WorkStealingDeque<Task*> runq;
+    std::uint32_t schedTick = 0;
+};
+
+struct Machine {
+    Processor* p = nullptr;
+    bool blocked = false;
+    std::uint64_t rng = 0;
+};
+
+thread_local Machine* tlsMachine = nullptr;
+
+std::int64_t monoNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// What one thread is doing, written by the thread itself with relaxed
+// stores and read by Threads().
+struct ThreadRecord {
+    std::uint64_t id = 0;
+    std::atomic<bool> worker{false};
+    std::atomic<std::uint64_t> task{0};
+    std::atomic<WaitReason> reason{WaitReason::None};
+    std::atomic<std::int64_t> waitSince{0};
+};
+
+// Leaked on purpose, like the Scheduler: thread_local destructors of
+// detached threads may run after static destruction.
+class ThreadRegistry {
+public:
+    static ThreadRegistry& instance() {
+        static ThreadRegistry* r = new ThreadRegistry();
+        return *r;
+    }
+
+    ThreadRecord* add() {
+        auto* rec = new ThreadRecord();
+        std::lock_guard<std::mutex> lock(mu_);
+        rec->id = ++nextId_;
+        threads_.push_back(rec);
+        return rec;
+    }
+
+    void remove(ThreadRecord* rec) {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            threads_.erase(std::remove(threads_.begin(), threads_.end(), rec), threads_.end());
+        }
+        delete rec;
+    }
+
+    std::vector<ThreadInfo> snapshot() {
+        const std::int64_t now = monoNs();
+        std::vector<ThreadInfo> out;
+        std::lock_guard<std::mutex> lock(mu_);
+        out.reserve(threads_.size());
+        for (const ThreadRecord* rec : threads_) {
+            ThreadInfo info;
+            info.id = rec->id;
+            info.worker = rec->worker.load(std::memory_order_relaxed);
+            info.task = rec->task.load(std::memory_order_relaxed);
+            info.waitReason = rec->reason.load(std::memory_order_relaxed);
+            if (info.waitReason != WaitReason::None) {
+                info.waitingNs = std::max<std::int64_t>(0, now - rec->waitSince.load(std::memory_order_relaxed));
+            }
+            out.push_back(info);
+        }
+        return out;
+    }
+
+private:
+    std::mutex mu_;
+    std::vector<ThreadRecord*> threads_;
+    std::uint64_t nextId_ = 0;
+};
+
+// Registers the thread on first use and unregisters it at thread exit.
+struct ThreadSlot {
+    ThreadRecord* rec = nullptr;
+    bool exited = false;
+
+    ~ThreadSlot() {
+        exited = true;
+        if (rec) ThreadRegistry::instance().remove(rec);
+        rec = nullptr;
+    }
+};
+
+thread_local ThreadSlot tlsThread;
+
+// Null once the thread's thread_locals are being destroyed.
+ThreadRecord* currentThread() {
+    ThreadSlot& slot = tlsThread;
+    if (!slot.rec && !slot.exited) slot.rec = ThreadRegistry::instance().add();
+    return slot.rec;
+}
+
+int defaultProcs() {
+    if (const char* env = std::getenv("GOMAXPROCS")) {
+        int n = std::atoi(env);
+        if (n > 0) return n;
+    }
+    unsigned hc = std::thread::hardware_concurrency();
+    return hc ? static_cast<int>(hc) : 1;
+}
+
+std::atomic<int>& maxProcs() {
+    static std::atomic<int> value{defaultProcs()};
+    return value;
+}
+
+std::atomic<bool> started{false};
+
+// Go's scheduler checks the global queue every 61 local tasks so that a
+// pair of tasks respawning each other cannot starve it.
+constexpr std::uint32_t kGlobalQueueInterval = 61;
+
+// Upper bound on tasks moved from the global queue in one grab.
+constexpr std::size_t kGlobalBatch = 32;
+
+class Scheduler {
+public:
+    static Scheduler& instance() {
+        // Leaked on purpose: detached workers may still be running while
+        // static destructors execute at exit.
+        static Scheduler* s = new Scheduler(maxProcs().load());
+        return *s;
+    }
+
+    explicit Scheduler(int nprocs) {
+        started.store(true);
+        procs_.reserve(static_cast<std::size_t>(nprocs));
+        for (int i = 0; i < nprocs; ++i) {
+            procs_.push_back(std::make_unique<Processor>(i));
+        }
+        for (auto it = procs_.rbegin(); it != procs_.rend(); ++it) {
+            idleProcs_.push_back(it->get());
+        }
+        idleCount_.store(nprocs, std::memory_order_relaxed);
+    }
+
+    void spawn(std::function<void()> fn) {
+        Task* t = new Task(std::move(fn), spawned_.fetch_add(1, std::memory_order_relaxed) + 1);
+        live_.fetch_add(1, std::memory_order_relaxed);
+
+        Machine* m = tlsMachine;
+        if (m && m->p) {
+            m->p->runq.push(t);
+            wakeup();
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mu_);
+        pushGlobalLocked(t);
+        startMachineLocked();
+    }
+
+    void enterBlocking() {
+        Machine* m = tlsMachine;
+        if (!m || !m->p || m->blocked) return;
+        int saved = errno;
+        m->blocked = true;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            ++blocked_;
+            ++handoffs_;
+            releaseProcLocked(m->p);
+            m->p = nullptr;
+            if (hasWorkLocked()) startMachineLocked();
+        }
+        errno = saved;
+    }
+
+    void exitBlocking() {
+        Machine* m = tlsMachine;
+        if (!m || !m->blocked) return;
+        int saved = errno;
+        m->blocked = false;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            --blocked_;
+            // Take a P back only if none of the Ms already woken for it
+            // would be left empty-handed; otherwise finish the current task
+            // without one and queue up for a P afterwards.
+            if (idleProcs_.size() > pendingWakes_) {
+                m->p = popIdleProcLocked();
+            }
+        }
+        errno = saved;
+    }
+
+    SchedulerStats stats() {
+        SchedulerStats s;
+        std::lock_guard<std::mutex> lock(mu_);
+        s.processors = static_cast<int>(procs_.size());
+        s.threads = threads_;
+        s.idleThreads = idleMachines_;
+        s.blockedThreads = blocked_;
+        s.liveTasks = live_.load(std::memory_order_relaxed);
+        s.spawned = spawned_.load(std::memory_order_relaxed);
+        s.stolen = stolen_.load(std::memory_order_relaxed);
+        s.handoffs = handoffs_;
+        return s;
+    }
+
+    std::int64_t live() const { return live_.load(std::memory_order_relaxed); }
+
+private:
+    void workerMain(Processor* p) {
+        Machine m;
+        m.p = p;
+        m.rng = reinterpret_cast<std::uintptr_t>(&m) | 1;
+        tlsMachine = &m;
+        ThreadRecord* self = currentThread();
+        self->worker.store(true, std::memory_order_relaxed);
+
+        for (;;) {
+            if (!m.p && !acquireProc(m)) break;
+            Task* t = findRunnable(m);
+            if (!t) {
+                if (!park(m)) break;
+                continue;
+            }
+            self->task.store(t->id, std::memory_order_relaxed);
+            t->fn();
+            self->task.store(0, std::memory_order_relaxed);
+            delete t;
+            live_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        tlsMachine = nullptr;
+    }
+
+    Task* findRunnable(Machine& m) {
+        Processor* p = m.p;
+        Task* t = nullptr;
+        if (++p->schedTick % kGlobalQueueInterval == 0 &&
+            globalSize_.load(std::memory_order_relaxed) > 0) {
+            if ((t = popGlobal(p))) return t;
+        }
+        if (p->runq.pop(t)) return t;
+        if (globalSize_.load(std::memory_order_relaxed) > 0) {
+            if ((t = popGlobal(p))) return t;
+        }
+
+        const std::size_t n = procs_.size();
+        if (n < 2) return nullptr;
+        // xorshift64 to pick where the victim scan starts.
+        m.rng ^= m.rng << 13;
+        m.rng ^= m.rng >> 7;
+        m.rng ^= m.rng << 17;
+        const std::size_t start = static_cast<std::size_t>(m.rng % n);
+        // A failed CAS is not proof of emptiness, so make a second pass.
+        for (int pass = 0; pass < 2; ++pass) {
+            for (std::size_t i = 0; i < n; ++i) {
+                Processor* victim = procs_[(start + i) % n].get();
+                if (victim == p) continue;
+                if (victim->runq.steal(t)) {
+                    stolen_.fetch_add(1, std::memory_order_relaxed);
+                    return t;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    /// Take one task from the global queue and move a fair share into @p p.
+    Task* popGlobal(Processor* p) {
+        std::lock_guard<std::mutex> lock(mu_);
+        Task* first = popGlobalLocked();
+        if (!first) return nullptr;
+        std::size_t share = std::min(kGlobalBatch, globalCount_ / procs_.size());
+        for (std::size_t i = 0; i < share; ++i) {
+            p->runq.push(popGlobalLocked());
+        }
+        return first;
+    }
+
+    /// Out of work: give up the P and sleep until there is some.
+    bool park(Machine& m) {
+        std::unique_lock<std::mutex> lock(mu_);
+        releaseProcLocked(m.p);
+        m.p = nullptr;
+        // Pairs with the fence in wakeup(): either the spawner sees our P in
+        // the idle list, or we see its task here.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (hasWorkLocked()) {
+            m.p = popIdleProcLocked();
+            return true;
+        }
+        return waitForProcLocked(lock, m);
+    }
+
+    /// Get a P for an M that has none (after a blocking wait).
+    bool acquireProc(Machine& m) {
+        std::unique_lock<std::mutex> lock(mu_);
+        if (idleProcs_.size() > pendingWakes_) {
+            m.p = popIdleProcLocked();
+            return true;
+        }
+        return waitForProcLocked(lock, m);
+    }
+
+    bool waitForProcLocked(std::unique_lock<std::mutex>& lock, Machine& m) {
+        for (;;) {
+            // Keep at most one spare M per P; the rest exit.
+            if (idleMachines_ >= static_cast<int>(procs_.size())) {
+                --threads_;
+                return false;
+            }
+            ++idleMachines_;
+            {
+                WaitScope idle(WaitReason::Idle);
+                wakeCv_.wait(lock, [this] { return pendingWakes_ > 0; });
+            }
+            --pendingWakes_;
+            --idleMachines_;
+            if (!idleProcs_.empty()) {
+                m.p = popIdleProcLocked();
+                return true;
+            }
+        }
+    }
+
+    /// New work is runnable: make sure some M will look at it.
+    void wakeup() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (idleCount_.load(std::memory_order_relaxed) == 0) return;
+        std::lock_guard<std::mutex> lock(mu_);
+        startMachineLocked();
+    }
+
+    void startMachineLocked() {
+        if (idleProcs_.size() <= pendingWakes_) return;
+        if (idleMachines_ > static_cast<int>(pendingWakes_)) {
+            ++pendingWakes_;
+            wakeCv_.notify_one();
+            return;
+        }
+        Processor* p = popIdleProcLocked();
+        ++threads_;
+        try {
+            std::thread(&Scheduler::workerMain, this, p).detach();
+        } catch (const std::system_error&) {
+            // Out of threads: the P stays idle and the existing Ms pick
+            // the work up once they are free.
+            --threads_;
+            releaseProcLocked(p);
+        }
+    }
+
+    bool hasWorkLocked() const {
+        if (globalHead_) return true;
+        for (const auto& p : procs_) {
+            if (!p->runq.emptyApprox()) return true;
+        }
+        return false;
+    }
+
+    void releaseProcLocked(Processor* p) {
+        idleProcs_.push_back(p);
+        idleCount_.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    Processor* popIdleProcLocked() {
+        Processor* p = idleProcs_.back();
+        idleProcs_.pop_back();
+        idleCount_.fetch_sub(1, std::memory_order_relaxed);
+        return p;
+    }
+
+    void pushGlobalLocked(Task* t) {
+        if (globalTail_) globalTail_->next = t;
+        else globalHead_ = t;
+        globalTail_ = t;
+        ++globalCount_;
+        globalSize_.store(globalCount_, std::memory_order_relaxed);
+    }
+
+    Task* popGlobalLocked() {
+        Task* t = globalHead_;
+        if (!t) return nullptr;
+        globalHead_ = t->next;
+        if (!globalHead_) globalTail_ = nullptr;
+        t->next = nullptr;
+        --globalCount_;
+        globalSize_.store(globalCount_, std::memory_order_relaxed);
+        return t;
+    }
+
+    std::vector<std::unique_ptr<Processor>> procs_;
+
+    std::mutex mu_;
+    std::condition_variable wakeCv_;
+    std::vector<Processor*> idleProcs_;   // guarded by mu_
+    std::atomic<int> idleCount_{0};       // idleProcs_.size(), readable without mu_
+    std::size_t pendingWakes_ = 0;        // notified Ms that have not taken a P yet
+    int idleMachines_ = 0;
+    int threads_ = 0;
+    int blocked_ = 0;
+    std::uint64_t handoffs_ = 0;
+
+    Task* globalHead_ = nullptr;          // guarded by mu_
+    Task* globalTail_ = nullptr;
+    std::size_t globalCount_ = 0;
+    std::atomic<std::size_t> globalSize_{0};
+
+    std::atomic<std::int64_t> live_{0};
+    std::atomic<std::uint64_t> spawned_{0};
+    std::atomic<std::uint64_t> stolen_{0};
+};
+
+} // namespace
+
+int GOMAXPROCS(int n) {
+    int prev = maxProcs().load();
+    if (n > 0 && !started.load()) {
+        maxProcs().store(n);
+    }
+    return prev;
+}
+
+std::int64_t NumGoroutine() {
+    return started.load() ? Scheduler::instance().live() : 0;
+}
+
+void Gosched() {
+    // Tasks have no stack of their own to switch away from, so the best
+    // available hint is yielding the OS thread.
+    std::this_thread::yield();
+}
+
+std::vector<ThreadInfo> Threads() {
+    std::vector<ThreadInfo> out = ThreadRegistry::instance().snapshot();
+    std::stable_sort(out.begin(), out.end(), [](const ThreadInfo& a, const ThreadInfo& b) {
+        return a.worker > b.worker;
+    });
+    return out;
+}
+
+const char* WaitReasonName(WaitReason reason) noexcept {
+    switch (reason) {
+        case WaitReason::None: return "running";
+        case WaitReason::Unknown: return "blocked";
+        case WaitReason::ChanSend: return "chan send";
+        case WaitReason::ChanRecv: return "chan receive";
+        case WaitReason::Select: return "select";
+        case WaitReason::Mutex: return "sync.Mutex.Lock";
+        case WaitReason::WaitGroup: return "sync.WaitGroup.Wait";
+        case WaitReason::Sleep: return "sleep";
+        case WaitReason::IO: return "IO wait";
+        case WaitReason::Syscall: return "syscall";
+        case WaitReason::Coroutine: return "coroutine wait";
+        case WaitReason::Idle: return "idle";
+    }
+    return "blocked";
+}
+
+SchedulerStats Stats() {
+    if (!started.load()) {
+        SchedulerStats s;
+        s.processors = maxProcs().load();
+        return s;
+    }
+    return Scheduler::instance().stats();
+}
+
+namespace detail {
+
+void spawn(std::function<void()> fn) {
+    Scheduler::instance().spawn(std::move(fn));
+}
+
+bool onWorkerThread() noexcept {
+    return tlsMachine != nullptr;
+}
+
+void enterBlocking() noexcept {
+    Scheduler::instance().enterBlocking();
+}
+
+void exitBlocking() noexcept {
+    Scheduler::instance().exitBlocking();
+}
+
+WaitReason beginWait(WaitReason reason) noexcept {
+    ThreadRecord* rec;
+    try {
+        rec = currentThread();
+    } catch (...) {
+        return WaitReason::None;  // out of memory: leave the thread untracked
+    }
+    if (!rec) return WaitReason::None;
+    const WaitReason previous = rec->reason.load(std::memory_order_relaxed);
+    // A nested wait keeps the outer start time so the whole wait is reported
+    if (previous == WaitReason::None) rec->waitSince.store(monoNs(), std::memory_order_relaxed);
+    rec->reason.store(reason, std::memory_order_relaxed);
+    return previous;
+}
+
+void endWait(WaitReason previous) noexcept {
+    if (ThreadRecord* rec = tlsThread.rec) rec->reason.store(previous, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+} // namespace gocxx::runtime
@@ -0,0 +1,131 @@
+#include "gocxx/time/rate.h"
+#include <gocxx/base/select.h>
+#include <gocxx/errors/errors.h>
+#include "gocxx/time/detail/timer_service.h"
+#include "gocxx/time/time.h"
+#include "gocxx/time/timer.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace gocxx::time::rate {
+
+namespace {
+    std::int64_t intervalFor(Limit r) {
+        if (std::isinf(r) && r > 0) return 0;
+        if (!(r > 0)) return -1;
+        return std::max<std::int64_t>(1, std::llround(1e9 / r));
+    }
+}
+
+Duration Reservation::Delay() const {
+    if (!ok_) return Duration(0);
+    const std::int64_t d = timeToAct_ - detail::monotonicNs();
+    return Duration(d > 0 ? d : 0);
+}
+
+void Reservation::Cancel() {
+    if (!ok_ || cost_ == 0) return;
+    const std::int64_t now = detail::monotonicNs();
+    if (timeToAct_ <= now) return;  // already due: the tokens are considered used
+    std::int64_t tat = lim_->tat_.load(std::memory_order_relaxed);
+    std::int64_t next;
+    do {
+        next = std::max(tat - cost_, now);
+    } while (!lim_->tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed));
+    cost_ = 0;
+}
+
+Limiter::Limiter(Limit r, int burst)
+    : intervalNs_(intervalFor(r)), limit_(r), burst_(burst) {}
+
+void Limiter::SetLimit(Limit r) {
+    limit_.store(r, std::memory_order_relaxed);
+    intervalNs_.store(intervalFor(r), std::memory_order_relaxed);
+}
+
+void Limiter::SetBurst(int burst) {
+    burst_.store(burst, std::memory_order_relaxed);
+}
+
+std::int64_t Limiter::take(int n, std::int64_t now, bool mustBeReady, std::int64_t* cost) {
+    *cost = 0;
+    const std::int64_t interval = intervalNs_.load(std::memory_order_relaxed);
+    if (interval == 0 || n <= 0) return now;
+    const int burst = burst_.load(std::memory_order_relaxed);
+    if (interval < 0 || n > burst) return -1;
+
+    const std::int64_t need = interval * n;
+    const std::int64_t tau = interval * burst;  // how far the schedule may run ahead of now
+    std::int64_t tat = tat_.load(std::memory_order_relaxed);
+    for (;;) {
+        const std::int64_t next = std::max(tat, now) + need;
+        if (mustBeReady && next - now > tau) return -1;
+        if (tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+            *cost = need;
+            return next;
+        }
+    }
+}
+
+bool Limiter::AllowN(int n) {
+    std::int64_t cost;
+    return take(n, detail::monotonicNs(), true, &cost) >= 0;
+}
+
+Reservation Limiter::ReserveN(int n) {
+    Reservation r;
+    r.lim_ = this;
+    const std::int64_t now = detail::monotonicNs();
+    const std::int64_t tat = take(n, now, false, &r.cost_);
+    if (tat < 0) return r;
+    r.ok_ = true;
+    const std::int64_t interval = intervalNs_.load(std::memory_order_relaxed);
+    const std::int64_t tau = interval > 0 ? interval * burst_.load(std::memory_order_relaxed) : 0;
+    r.timeToAct_ = std::max(now, tat - tau);
+    return r;
+}
+
+base::Result<void> Limiter::WaitN(context::ContextPtr ctx, int n) {
+    if (ctx) {
+        auto err = ctx->Err();
+        if (err.Failed()) return err;
+    }
+    const int burst = burst_.load(std::memory_order_relaxed);
+    if (n > burst && intervalNs_.load(std::memory_order_relaxed) != 0) {
+        return base::Result<void>(errors::New("rate: Wait(n=" + std::to_string(n) +
+                                              ") exceeds limiter's burst " + std::to_string(burst)));
+    }
+
+    Reservation r = ReserveN(n);
+    if (!r.OK()) {
+        return base::Result<void>(errors::New("rate: Wait(n=" + std::to_string(n) + ") is never allowed"));
+    }
+    const Duration delay = r.Delay();
+    if (delay.Nanoseconds() == 0) return base::Result<void>();
+
+    if (ctx) {
+        auto deadline = ctx->Deadline();
+        if (deadline.Ok() && deadline.value.Before(Time::Now().Add(delay))) {
+            r.Cancel();
+            return base::Result<void>(errors::New("rate: Wait(n=" + std::to_string(n) +
+                                                  ") would exceed context deadline"));
+        }
+    }
+
+    Timer timer(delay);
+    auto tick = timer.C();
+    if (!ctx) {
+        tick->recv();
+        return base::Result<void>();
+    }
+    bool ready = false;
+    auto done = ctx->Done();
+    base::select(base::recvCase(*tick, [&](std::optional<Time>) { ready = true; }),
+                 base::recvCase(done, [](std::optional<bool>) {}));
+    if (ready) return base::Result<void>();
+    r.Cancel();
+    return ctx->Err();
+}
+
+} // namespace gocxx::time::rate
@@ -1,50 +1,39 @@
 #include "gocxx/time/ticker.h"
 #include "gocxx/time/time.h"
-#include <chrono>
-#include <thread>
+#include <stdexcept>
 
 namespace gocxx::time {
 
 Ticker::Ticker(Duration d)
-    : duration_(d), stopped_(false)
-{
-    ch_ = gocxx::base::Chan<Time>::Make(0); // Unbuffered channel
-    thread_ = std::thread(&Ticker::run, this);
+    : stopped_(false), ch_(gocxx::base::Chan<Time>::Make(1)) {
+    if (d.Nanoseconds() <= 0) {
+        throw std::invalid_argument("non-positive interval for NewTicker");
+    }
+    node_ = std::make_shared<detail::TimerNode>([ch = ch_] { ch->trySend(Time::Now()); });
+    detail::TimerService::instance().start(node_, detail::monotonicNs() + d.Nanoseconds(), d.Nanoseconds());
 }
 
 Ticker::~Ticker() {
     Stop();
-    if (thread_.joinable()) {
-        thread_.join();
-    }
 }
 
 void Ticker::Stop() {
     if (!stopped_.exchange(true)) {
+        detail::TimerService::instance().stopSync(*node_);
         ch_->close();
-        if (thread_.joinable()) {
-            thread_.join();
-        }
     }
 }
 
-std::shared_ptr<gocxx::base::Chan<Time>> Ticker::C() {
-    return ch_;
+void Ticker::Reset(Duration d) {
+    if (d.Nanoseconds() <= 0) {
+        throw std::invalid_argument("non-positive interval for Ticker.Reset");
+    }
+    if (stopped_) return;
+    detail::TimerService::instance().start(node_, detail::monotonicNs() + d.Nanoseconds(), d.Nanoseconds());
 }
 
-void Ticker::run() {
-    while (!stopped_) {
-        Sleep(duration_);
-        if (stopped_) break;
-        
-        try {
-            auto t = Time::Now();
-            ch_->send(std::move(t));
-        } catch (const std::exception&) {
-            // Channel might be closed, exit
-            break;
-        }
-    }
+std::shared_ptr<gocxx::base::Chan<Time>> Ticker::C() {
+    return ch_;
 }
 
 std::unique_ptr<Ticker> NewTicker(Duration d) {
@@ -4,6 +4,9 @@
 #include <iomanip>
 #include <thread>
 #include <ctime>
+#if defined(__linux__)
+#include <time.h>
+#endif
 
 namespace gocxx::time {
 
@@ -18,7 +21,24 @@ namespace gocxx::time {
         auto since_epoch = now.time_since_epoch();
         int64_t sec = duration_cast<seconds>(since_epoch).count();
         int32_t nsec = static_cast<int32_t>(duration_cast<nanoseconds>(since_epoch).count() % 1'000'000'000);
-        return Time(sec, nsec);
+        Time t(sec, nsec);
+        t.mono_ = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        return t;
+    }
+
+    Time CoarseNow() {
+#if defined(__linux__) && defined(CLOCK_REALTIME_COARSE) && defined(CLOCK_MONOTONIC_COARSE)
+        timespec wall{};
+        timespec mono{};
+        clock_gettime(CLOCK_REALTIME_COARSE, &wall);
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &mono);
+        // steady_clock is CLOCK_MONOTONIC here, so readings compare with Time::Now().
+        Time t(static_cast<int64_t>(wall.tv_sec), static_cast<int32_t>(wall.tv_nsec));
+        t.mono_ = static_cast<int64_t>(mono.tv_sec) * 1'000'000'000LL + mono.tv_nsec;
+        return t;
+#else
+        return Time::Now();
+#endif
     }
 
     Time Time::Unix(int64_t sec, int64_t nsec) {
@@ -90,23 +110,31 @@ namespace gocxx::time {
     }
 
     Duration Time::Sub(const Time& other) const {
+        if (mono_ != 0 && other.mono_ != 0) {
+            return Duration(mono_ - other.mono_);
+        }
         return Duration(UnixNano() - other.UnixNano());
     }
 
     Time Time::Add(Duration d) const {
         int64_t ns = UnixNano() + d.Nanoseconds();
-        return Time(ns / 1'000'000'000, ns % 1'000'000'000);
+        Time t(ns / 1'000'000'000, ns % 1'000'000'000);
+        if (mono_ != 0) t.mono_ = mono_ + d.Nanoseconds();
+        return t;
     }
 
     bool Time::Before(const Time& other) const {
+        if (mono_ != 0 && other.mono_ != 0) return mono_ < other.mono_;
         return UnixNano() < other.UnixNano();
     }
 
     bool Time::After(const Time& other) const {
+        if (mono_ != 0 && other.mono_ != 0) return mono_ > other.mono_;
         return UnixNano() > other.UnixNano();
     }
 
     bool Time::Equal(const Time& other) const {
+        if (mono_ != 0 && other.mono_ != 0) return mono_ == other.mono_;
         return UnixNano() == other.UnixNano();
     }
 
@@ -1,71 +1,58 @@
 #include "gocxx/time/timer.h"
-#include <chrono>
-#include <thread>
+#include <gocxx/runtime/runtime.h>
 
 namespace gocxx::time {
 
 Timer::Timer(Duration d)
-    : duration_(d), stopped_(false) {
-    ch_ = gocxx::base::Chan<Time>::Make(1);
-    start_ = std::chrono::steady_clock::now();
-    thread_ = std::thread(&Timer::run, this);
+    : ch_(gocxx::base::Chan<Time>::Make(1)) {
+    node_ = std::make_shared<detail::TimerNode>([ch = ch_] {
+        // Buffered: a receiver that has not drained the last value just misses this one.
+        ch->trySend(Time::Now());
+    });
+    detail::TimerService::instance().start(node_, detail::monotonicNs() + d.Nanoseconds());
+}
+
+Timer::Timer(Duration d, std::function<void()> fn) {
+    // The timer thread only hands the call to the runtime, so fn may block.
+    node_ = std::make_shared<detail::TimerNode>([fn = std::move(fn)] { gocxx::go(fn); });
+    detail::TimerService::instance().start(node_, detail::monotonicNs() + d.Nanoseconds());
 }
 
 Timer::~Timer() {
-    Stop();
-    if (thread_.joinable()) thread_.join();
+    // Nobody could receive from the channel any more; AfterFunc calls still run.
+    if (ch_) detail::TimerService::instance().stop(*node_);
 }
 
 bool Timer::Stop() {
-    bool was_stopped = stopped_.exchange(true);
-    if (!was_stopped) {
-        cv_.notify_all(); // Wake up the waiting thread
-    }
-    return !was_stopped; // returns true if it was running
+    return detail::TimerService::instance().stop(*node_);
 }
 
 bool Timer::Reset(Duration d) {
-    // Stop and wait for the old thread to finish
-    Stop();
-    if (thread_.joinable()) thread_.join();
-    
-    // Reset state for new timer
-    stopped_ = false;
-    duration_ = d;
-    ch_ = gocxx::base::Chan<Time>::Make(1);
-    start_ = std::chrono::steady_clock::now();
-    
-    // Start new thread
-    thread_ = std::thread(&Timer::run, this);
-    return true;
+    auto& service = detail::TimerService::instance();
+    const bool wasActive = service.stopSync(*node_);
+    if (ch_) ch_->tryRecv();  // drop a stale expiry
+    service.start(node_, detail::monotonicNs() + d.Nanoseconds());
+    return wasActive;
 }
 
 std::shared_ptr<gocxx::base::Chan<Time>> Timer::C() {
     return ch_;
 }
 
-void Timer::run() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    auto deadline = start_ + std::chrono::nanoseconds(duration_.Nanoseconds());
-    
-    // Wait until the deadline or until stopped
-    if (cv_.wait_until(lock, deadline, [this] { return stopped_.load(); })) {
-        // We were stopped before the timer expired
-        return;
-    }
+std::unique_ptr<Timer> NewTimer(Duration d) {
+    return std::make_unique<Timer>(d);
+}
 
-    // Timer expired normally, send the time
-    if (!stopped_) {
-        try {
-            ch_->send(Time::Now()); // send current time
-        } catch (const std::exception&) {
-            // Channel might be closed, ignore
-        }
-    }
+std::unique_ptr<Timer> AfterFunc(Duration d, std::function<void()> fn) {
+    return std::unique_ptr<Timer>(new Timer(d, std::move(fn)));
 }
 
-std::unique_ptr<Timer> NewTimer(Duration d) {
-    return std::make_unique<Timer>(d);
+std::shared_ptr<gocxx::base::Chan<Time>> After(Duration d) {
+    auto ch = gocxx::base::Chan<Time>::Make(1);
+    // The heap entry keeps the node alive until it fires.
+    auto node = std::make_shared<detail::TimerNode>([ch] { ch->trySend(Time::Now()); });
+    detail::TimerService::instance().start(node, detail::monotonicNs() + d.Nanoseconds());
+    return ch;
 }
 
 } // namespace gocxx::time
@@ -0,0 +1,197 @@
+#include "gocxx/time/detail/timer_service.h"
+#include <chrono>
+#include <utility>
+
+namespace gocxx::time::detail {
+
+namespace {
+    constexpr std::size_t kArity = 4;
+    constexpr std::size_t kCompactMinSize = 64;
+}
+
+std::int64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TimerService& TimerService::instance() {
+    // Leaked: timers may be stopped from static destructors.
+    static TimerService* service = new TimerService();
+    return *service;
+}
+
+bool TimerService::start(const std::shared_ptr<TimerNode>& node, std::int64_t when, std::int64_t period) {
+    std::vector<Entry> garbage;  // destroyed after the lock is released
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!started_) {
+        started_ = true;
+        std::thread t([this] { loop(); });
+        thread_ = t.get_id();
+        t.detach();
+    }
+
+    TimerNode& n = *node;
+    const bool wasActive = n.when_ != 0;
+    n.when_ = when;
+    n.period_ = period;
+    if (n.queued_ && when >= n.queuedWhen_) {
+        // Later (or equal) deadline: the queued entry is re-pushed when it surfaces.
+        if (!wasActive && stale_ > 0) --stale_;
+        return wasActive;
+    }
+    if (n.queued_ && wasActive) ++stale_;  // superseded by the earlier entry
+    push(when, node);
+    if (heap_.size() >= kCompactMinSize && stale_ * 2 > heap_.size()) {
+        compactLocked(garbage);
+    }
+    return wasActive;
+}
+
+bool TimerService::stop(TimerNode& node) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    const bool wasActive = node.when_ != 0;
+    node.when_ = 0;
+    if (wasActive && node.queued_) ++stale_;
+    return wasActive;
+}
+
+bool TimerService::stopSync(TimerNode& node) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    const bool wasActive = node.when_ != 0;
+    node.when_ = 0;
+    if (wasActive && node.queued_) ++stale_;
+    if (std::this_thread::get_id() != thread_) {
+        callbackDone_.wait(lock, [&] { return running_ != &node; });
+    }
+    return wasActive;
+}
+
+std::size_t TimerService::queued() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return heap_.size();
+}
+
+void TimerService::push(std::int64_t when, const std::shared_ptr<TimerNode>& node) {
+    node->queued_ = true;
+    node->queuedWhen_ = when;
+    heap_.push_back(Entry{when, node});
+    siftUp(heap_.size() - 1);
+    if (heap_.front().node == node) wake_.notify_one();  // new earliest deadline
+}
+
+TimerService::Entry TimerService::popTop() {
+    Entry top = std::move(heap_.front());
+    if (heap_.size() > 1) heap_.front() = std::move(heap_.back());
+    heap_.pop_back();
+    if (!heap_.empty()) siftDown(0);
+    return top;
+}
+
+void TimerService::siftUp(std::size_t i) {
+    Entry e = std::move(heap_[i]);
+    while (i > 0) {
+        const std::size_t parent = (i - 1) / kArity;
+        if (heap_[parent].when <= e.when) break;
+        heap_[i] = std::move(heap_[parent]);
+        i = parent;
+    }
+    heap_[i] = std::move(e);
+}
+
+void TimerService::siftDown(std::size_t i) {
+    const std::size_t n = heap_.size();
+    Entry e = std::move(heap_[i]);
+    for (;;) {
+        const std::size_t first = i * kArity + 1;
+        if (first >= n) break;
+        std::size_t best = first;
+        const std::size_t last = first + kArity < n ? first + kArity : n;
+        for (std::size_t c = first + 1; c < last; ++c) {
+            if (heap_[c].when < heap_[best].when) best = c;
+        }
+        if (e.when <= heap_[best].when) break;
+        heap_[i] = std::move(heap_[best]);
+        i = best;
+    }
+    heap_[i] = std::move(e);
+}
+
+void TimerService::compactLocked(std::vector<Entry>& garbage) {
+    std::vector<Entry> live;
+    live.reserve(heap_.size() > stale_ ? heap_.size() - stale_ : 0);
+    for (auto& e : heap_) {
+        TimerNode& n = *e.node;
+        const bool current = n.queued_ && e.when == n.queuedWhen_;
+        if (current && n.when_ != 0) {
+            live.push_back(std::move(e));
+            continue;
+        }
+        if (current) n.queued_ = false;
+        garbage.push_back(std::move(e));
+    }
+    heap_.swap(live);
+    stale_ = 0;
+    if (heap_.size() > 1) {
+        for (std::size_t i = (heap_.size() - 2) / kArity + 1; i-- > 0;) siftDown(i);
+    }
+}
+
+void TimerService::loop() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    std::vector<std::shared_ptr<TimerNode>> garbage;
+    for (;;) {
+        if (!garbage.empty()) {
+            // Dropping the last reference runs the callback's destructors; not under the lock.
+            lock.unlock();
+            garbage.clear();
+            lock.lock();
+        }
+        if (heap_.empty()) {
+            wake_.wait(lock);
+            continue;
+        }
+        const std::int64_t now = monotonicNs();
+        const std::int64_t next = heap_.front().when;
+        if (next > now) {
+            wake_.wait_for(lock, std::chrono::nanoseconds(next - now));
+            continue;
+        }
+
+        Entry e = popTop();
+        TimerNode& n = *e.node;
+        if (!n.queued_ || e.when != n.queuedWhen_) {
+            // Superseded by an earlier Reset().
+            if (stale_ > 0) --stale_;
+            garbage.push_back(std::move(e.node));
+            continue;
+        }
+        n.queued_ = false;
+        if (n.when_ == 0) {
+            if (stale_ > 0) --stale_;
+            garbage.push_back(std::move(e.node));
+            continue;
+        }
+        if (n.when_ > now) {
+            push(n.when_, e.node);  // moved to a later deadline while queued
+            continue;
+        }
+        if (n.period_ > 0) {
+            // Like Go's Ticker, a late tick does not cause a burst of catch-up ticks.
+            n.when_ += n.period_;
+            if (n.when_ <= now) n.when_ = now + n.period_;
+            push(n.when_, e.node);
+        } else {
+            n.when_ = 0;
+        }
+
+        running_ = &n;
+        lock.unlock();
+        n.fn_();
+        lock.lock();
+        running_ = nullptr;
+        callbackDone_.notify_all();
+        garbage.push_back(std::move(e.node));
+    }
+}
+
+} // namespace gocxx::time::detail
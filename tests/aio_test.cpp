@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <gocxx/aio/aio.h>
+#include <gocxx/os/os.h>
+#include <gocxx/os/file.h>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace gocxx;
+
+namespace {
+
+// Runs each test on io_uring (where the kernel allows it) and on the thread pool.
+class AioTest : public ::testing::TestWithParam<bool> {
+protected:
+    aio::Options options() const {
+        aio::Options opts;
+        opts.entries = 8;  // small rings exercise the full-queue paths
+        opts.forceThreadPool = GetParam();
+        return opts;
+    }
+
+    static std::size_t wait(const aio::Completion& done) {
+        auto res = done->recv();
+        EXPECT_TRUE(res.has_value());
+        EXPECT_TRUE(res->Ok()) << (res->err ? res->err->error() : "");
+        return res->value;
+    }
+};
+
+} // namespace
+
+TEST_P(AioTest, BatchedWritesReadBackAtOffsets) {
+    aio::Engine engine(options());
+    if (GetParam()) {
+        EXPECT_FALSE(engine.UsesIoUring());
+    }
+
+    const std::string name = os::TempDir() + "/gocxx_aio.bin";
+    auto file = os::OpenFile(name, static_cast<int>(os::OpenFlag::RDWR | os::OpenFlag::CREATE | os::OpenFlag::TRUNC), 0644).value;
+    ASSERT_NE(file, nullptr);
+
+    // More operations than the ring holds, submitted as one batch
+    std::vector<std::string> blocks;
+    std::vector<aio::Op> writes;
+    for (int i = 0; i < 40; ++i) blocks.push_back(std::string(100, static_cast<char>('a' + i % 26)));
+    for (int i = 0; i < 40; ++i) {
+        writes.push_back(aio::Op::Write(file->Fd(), reinterpret_cast<const uint8_t*>(blocks[i].data()), 100, i * 100));
+    }
+    for (auto& done : engine.Submit(writes)) EXPECT_EQ(wait(done), 100u);
+    EXPECT_EQ(wait(engine.Fsync(file->Fd())), 0u);
+
+    std::vector<uint8_t> buf(4000);
+    EXPECT_EQ(wait(engine.Read(file->Fd(), buf.data(), buf.size(), 0)), 4000u);
+    for (int i = 0; i < 40; ++i) {
+        EXPECT_EQ(std::string(buf.begin() + i * 100, buf.begin() + (i + 1) * 100), blocks[i]);
+    }
+    EXPECT_EQ(wait(engine.Read(file->Fd(), buf.data(), buf.size(), 4000)), 0u);  // end of file
+
+    auto bad = engine.Read(-1, buf.data(), buf.size(), 0)->recv();
+    ASSERT_TRUE(bad.has_value());
+    EXPECT_TRUE(bad->Failed());
+
+    file->close();
+    os::Remove(name);
+}
+
+#ifndef _WIN32
+TEST_P(AioTest, RegisteredBuffersAndFixedFilesOnAPipe) {
+    aio::Engine engine(options());
+    int p[2];
+    ASSERT_EQ(::pipe(p), 0);
+
+    std::vector<uint8_t> out(64, 'x'), in(64, 0);
+    ASSERT_TRUE(engine.RegisterBuffers({ out, in }).Ok());
+    ASSERT_TRUE(engine.RegisterFiles({ p[0], p[1] }).Ok());
+
+    auto wrote = engine.Submit(aio::Op::Write(1, out.data(), out.size()).Fixed(1).Registered(0));
+    EXPECT_EQ(wait(wrote), 64u);
+    auto read = engine.Submit(aio::Op::Read(0, in.data(), in.size()).Fixed(0).Registered(1));
+    EXPECT_EQ(wait(read), 64u);
+    EXPECT_EQ(in, out);
+
+    EXPECT_TRUE(engine.UnregisterFiles().Ok());
+    EXPECT_TRUE(engine.UnregisterBuffers().Ok());
+    ::close(p[0]);
+    ::close(p[1]);
+}
+#endif
+
+INSTANTIATE_TEST_SUITE_P(Backends, AioTest, ::testing::Values(false, true),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                             return info.param ? "ThreadPool" : "Native";
+                         });
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <gocxx/arena/arena.h>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace gocxx;
+
+namespace {
+
+// Counts what reaches the upstream resource
+class CountingResource : public std::pmr::memory_resource {
+public:
+    int allocations = 0;
+    int live = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        ++live;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        --live;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+} // namespace
+
+TEST(ArenaTest, BumpAllocatesAlignedAndResetsWithoutUpstreamCalls) {
+    CountingResource upstream;
+    {
+        arena::Arena a(1024, &upstream);
+        EXPECT_EQ(a.Capacity(), 0u);  // nothing until the first allocation
+
+        void* p = a.allocate(3, 1);
+        void* q = a.allocate(8, 64);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(q) % 64, 0u);
+        EXPECT_GT(static_cast<char*>(q), static_cast<char*>(p));
+        EXPECT_EQ(upstream.allocations, 1);
+
+        // Spilling past the first block: the next cycle gets one block for all of it
+        for (int i = 0; i < 10; ++i) EXPECT_NE(a.allocate(512, 8), nullptr);
+        EXPECT_GT(upstream.allocations, 1);
+        const std::size_t used = a.Used();
+        a.Reset();
+        EXPECT_EQ(a.Used(), 0u);
+        EXPECT_GE(a.Capacity(), used - 64);
+
+        const int before = upstream.allocations;
+        for (int cycle = 0; cycle < 100; ++cycle) {
+            std::pmr::vector<std::pmr::string> v(&a);
+            for (int i = 0; i < 8; ++i) v.emplace_back(32, 'x');
+            v.clear();
+            a.Reset();
+        }
+        EXPECT_EQ(upstream.allocations, before);
+        EXPECT_EQ(upstream.live, 1);
+
+        a.Release();
+        EXPECT_EQ(upstream.live, 0);
+        EXPECT_EQ(a.Capacity(), 0u);
+    }
+    EXPECT_EQ(upstream.live, 0);
+}
+
+TEST(ArenaTest, ResetReturnsMemoryBeyondTheRetainLimit) {
+    CountingResource upstream;
+    arena::Arena a(1024, &upstream, 8 * 1024);
+    EXPECT_NE(a.allocate(100 * 1024, 16), nullptr);
+    EXPECT_GE(a.Capacity(), 100u * 1024);
+    a.Reset();
+    EXPECT_LE(a.Capacity(), 8u * 1024);
+
+    EXPECT_THROW(arena::Arena(0), std::invalid_argument);
+}
@@ -11,6 +11,7 @@
 #include <atomic>
 #include <future>
 #include <random>
+#include <list>
 
 using namespace gocxx::base;
 using namespace gocxx::errors;
@@ -397,7 +398,324 @@ TEST_F(ChanTest, ConcurrentCloseAndOperations) {
    EXPECT_TRUE(exception_caught);
 }
 
+TEST_F(ChanTest, RingBackendsPreserveOrder) {
+   for (auto backend : {ChanBackend::SPSC, ChanBackend::MPMC, ChanBackend::Locked}) {
+       Chan<int> ch(8, backend);
+       std::thread producer([&]() {
+           for (int i = 0; i < 1000; ++i) ch << i;
+           ch.close();
+       });
+
+       int expected = 0;
+       while (auto v = ch.recv()) {
+           EXPECT_EQ(*v, expected++);
+       }
+       producer.join();
+       EXPECT_EQ(expected, 1000);
+   }
+}
+
+TEST_F(ChanTest, SendBatchAndRecvBatch) {
+   for (auto backend : {ChanBackend::Locked, ChanBackend::MPMC, ChanBackend::SPSC}) {
+       Chan<int> ch(4, backend);
+       std::vector<int> items(100);
+       for (int i = 0; i < 100; ++i) items[i] = i;
+
+       std::thread producer([&]() {
+           ch.sendBatch(items.begin(), items.end());
+           ch.close();
+       });
+
+       std::vector<int> got;
+       while (ch.recvBatch(got, 16) > 0) {}
+       producer.join();
+
+       ASSERT_EQ(got.size(), 100u);
+       for (int i = 0; i < 100; ++i) EXPECT_EQ(got[i], i);
+   }
+}
+
+TEST_F(ChanTest, RecvBatchRespectsMaxAndDrainIsNonBlocking) {
+   Chan<std::string> ch(8);
+   std::vector<std::string> none;
+   EXPECT_EQ(ch.drain(none), 0u);
+
+   ch.sendBatch(std::vector<std::string>{"a", "b", "c", "d", "e"});
+
+   std::vector<std::string> out;
+   EXPECT_EQ(ch.recvBatch(out, 2), 2u);
+   EXPECT_EQ(out, (std::vector<std::string>{"a", "b"}));
+   EXPECT_EQ(ch.drain(out), 3u);
+   EXPECT_EQ(out.back(), "e");
+
+   ch.close();
+   EXPECT_EQ(ch.recvBatch(out, 4), 0u);
+   EXPECT_THROW(ch.sendBatch(std::vector<std::string>{"x"}), std::runtime_error);
+}
+
+TEST_F(ChanTest, SendBatchOnUnbufferedChannel) {
+   Chan<int> ch;
+   std::list<int> values{1, 2, 3};
+
+   std::thread producer([&]() { ch.sendBatch(values.begin(), values.end()); });
+
+   std::vector<int> got;
+   while (got.size() < 3) {
+       EXPECT_EQ(ch.recvBatch(got, 10), 1u);
+   }
+   producer.join();
+   EXPECT_EQ(got, (std::vector<int>{1, 2, 3}));
+}
+
+TEST_F(ChanTest, ParkPolicyNeverSpins) {
+   Chan<int> ch;
+   ch.setWaitPolicy(WaitPolicy::Park());
+   ResetWaitCounters();
+
+   std::thread receiver([&]() {
+       for (int i = 0; i < 50; ++i) EXPECT_EQ(*ch.recv(), i);
+   });
+   for (int i = 0; i < 50; ++i) ch << i;
+   receiver.join();
+
+   auto c = GetWaitCounters();
+   EXPECT_EQ(c.spinResolved, 0u);
+   EXPECT_EQ(c.yieldResolved, 0u);
+   EXPECT_GT(c.parked, 0u);
+}
+
+TEST_F(ChanTest, AdaptivePolicyResolvesWaitsWithoutParking) {
+   Chan<int> ping, pong;
+   WaitPolicy eager{2000, 200};
+   ping.setWaitPolicy(eager);
+   pong.setWaitPolicy(eager);
+   ResetWaitCounters();
+
+   std::thread echo([&]() {
+       while (auto v = ping.recv()) pong << *v;
+       pong.close();
+   });
+   for (int i = 0; i < 200; ++i) {
+       ping << i;
+       EXPECT_EQ(*pong.recv(), i);
+   }
+   ping.close();
+   echo.join();
+
+   auto c = GetWaitCounters();
+   EXPECT_GT(c.spinResolved + c.yieldResolved, 0u);
+}
+
+TEST(WaitPolicyTest, DefaultPolicyIsGlobal) {
+   WaitPolicy saved = DefaultWaitPolicy();
+   SetDefaultWaitPolicy(WaitPolicy{10, 1});
+   EXPECT_EQ(DefaultWaitPolicy(), (WaitPolicy{10, 1}));
+
+   Chan<int> ch(4);
+   ch << 1;
+   EXPECT_EQ(*ch.recv(), 1);
+
+   SetDefaultWaitPolicy(saved);
+   EXPECT_EQ(DefaultWaitPolicy(), saved);
+}
+
+TEST_F(ChanTest, MpmcRingManyProducersConsumers) {
+   Chan<int> ch(16, ChanBackend::MPMC);
+   constexpr int producers = 4, perProducer = 2000;
+   std::atomic<long> sum{0};
+   std::atomic<int> received{0};
+
+   std::vector<std::thread> threads;
+   for (int p = 0; p < producers; ++p) {
+       threads.emplace_back([&, p]() {
+           for (int i = 1; i <= perProducer; ++i) ch.send(p * perProducer + i);
+       });
+   }
+   std::vector<std::thread> consumers;
+   for (int c = 0; c < 3; ++c) {
+       consumers.emplace_back([&]() {
+           while (auto v = ch.recv()) {
+               sum += *v;
+               ++received;
+           }
+       });
+   }
+
+   for (auto& t : threads) t.join();
+   ch.close();
+   for (auto& t : consumers) t.join();
+
+   const long n = producers * perProducer;
+   EXPECT_EQ(received.load(), n);
+   EXPECT_EQ(sum.load(), n * (n + 1) / 2);
+}
+
+TEST_F(ChanTest, RingBackendTryOperationsAndClose) {
+   Chan<std::unique_ptr<int>> ch(2, ChanBackend::MPMC);
+   EXPECT_TRUE(ch.trySend(std::make_unique<int>(1)).Ok());
+   EXPECT_TRUE(ch.trySend(std::make_unique<int>(2)).Ok());
+   EXPECT_FALSE(ch.canSend());
+   EXPECT_EQ(ch.trySend(std::make_unique<int>(3)).err->error(), "buffer full");
+
+   ch.close();
+   EXPECT_TRUE(ch.isClosed());
+   EXPECT_THROW(ch.send(std::make_unique<int>(4)), std::runtime_error);
+
+   auto first = ch.tryRecv();
+   ASSERT_TRUE(first.Ok());
+   EXPECT_EQ(*first.value, 1);
+   auto second = ch.recv();
+   ASSERT_TRUE(second.has_value());
+   EXPECT_EQ(**second, 2);
+   EXPECT_FALSE(ch.recv().has_value());
+   EXPECT_EQ(ch.tryRecv().err->error(), "channel closed");
+}
+
+TEST_F(ChanTest, TryOperationsReturnSentinelErrors) {
+   for (auto backend : {ChanBackend::Locked, ChanBackend::MPMC, ChanBackend::SPSC}) {
+       Chan<int> ch(1, backend);
+       auto empty = ch.tryRecv();
+       EXPECT_TRUE(gocxx::errors::Is(empty.err, ErrChanEmpty));
+       // A sentinel has no control block, so failing polls allocate nothing
+       EXPECT_EQ(empty.err.get(), ErrChanEmpty.get());
+       EXPECT_EQ(empty.err.use_count(), 0);
+
+       EXPECT_TRUE(ch.trySend(1).Ok());
+       EXPECT_TRUE(gocxx::errors::Is(ch.trySend(2).err, ErrChanFull));
+
+       ch.close();
+       EXPECT_TRUE(gocxx::errors::Is(ch.trySend(3).err, ErrChanClosed));
+       EXPECT_TRUE(ch.tryRecv().Ok());
+       EXPECT_TRUE(gocxx::errors::Is(ch.tryRecv().err, ErrChanClosed));
+   }
+
+   Chan<int> unbuffered;
+   EXPECT_TRUE(gocxx::errors::Is(unbuffered.tryRecv().err, ErrChanEmpty));
+   EXPECT_TRUE(unbuffered.trySend(1).Ok());
+   EXPECT_TRUE(gocxx::errors::Is(unbuffered.trySend(2).err, ErrChanFull));
+}
+
+TEST_F(ChanTest, RingBackendWakesParkedSender) {
+   Chan<int> ch(2, ChanBackend::SPSC);
+   ch << 1 << 2;
+   std::atomic<bool> sent{false};
+
+   std::thread sender([&]() {
+       ch << 3;
+       sent = true;
+   });
+
+   std::this_thread::sleep_for(50ms);
+   EXPECT_FALSE(sent);
+   EXPECT_EQ(*ch.recv(), 1);
+   sender.join();
+   EXPECT_TRUE(sent);
+   EXPECT_EQ(*ch.recv(), 2);
+   EXPECT_EQ(*ch.recv(), 3);
+}
+
+
+
+TEST(ChanStatsTest, DisabledByDefault) {
+   Chan<int> ch(4);
+   ch << 1;
+   auto s = ch.stats();
+   EXPECT_EQ(s.capacity, 4u);
+   EXPECT_EQ(s.sends, 0u);
+   EXPECT_TRUE(s.name.empty());
+}
+
+TEST(ChanStatsTest, CountsTrafficOnEveryBackend) {
+   for (auto backend : {ChanBackend::Locked, ChanBackend::SPSC, ChanBackend::MPMC}) {
+       Chan<int> ch(8, backend);
+       ch.enableStats("traffic");
+       for (int i = 0; i < 5; ++i) ch << i;
+       EXPECT_TRUE(ch.trySend(5).Ok());
+       EXPECT_EQ(*ch.recv(), 0);
+       EXPECT_TRUE(ch.tryRecv().Ok());
+       std::vector<int> out;
+       EXPECT_EQ(ch.recvBatch(out, 2), 2u);
+       ch.close();
+
+       auto s = ch.stats();
+       EXPECT_EQ(s.name, "traffic");
+       EXPECT_EQ(s.capacity, 8u);
+       EXPECT_EQ(s.sends, 6u);
+       EXPECT_EQ(s.recvs, 4u);
+       EXPECT_EQ(s.length, 2u);
+       EXPECT_EQ(s.highWater, 6u);
+       EXPECT_TRUE(s.closed);
+       EXPECT_EQ(s.sendBlocks + s.recvBlocks, 0u);
+   }
+}
+
+TEST(ChanStatsTest, RecordsBlockedReceiverAndWaitTime) {
+   for (auto backend : {ChanBackend::Locked, ChanBackend::MPMC}) {
+       Chan<int> ch(2, backend);
+       ch.setWaitPolicy(WaitPolicy::Park());
+       ch.enableStats("blocking");
+       std::thread receiver([&] { ch.recv(); });
+
+       auto deadline = std::chrono::steady_clock::now() + 5s;
+       while (ch.stats().blockedReceivers == 0 && std::chrono::steady_clock::now() < deadline) {
+           std::this_thread::sleep_for(1ms);
+       }
+       EXPECT_EQ(ch.stats().blockedReceivers, 1);
+       std::this_thread::sleep_for(20ms);
+       ch << 1;
+       receiver.join();
+
+       auto s = ch.stats();
+       EXPECT_EQ(s.blockedReceivers, 0);
+       EXPECT_EQ(s.recvBlocks, 1u);
+       EXPECT_GE(s.recvBlockedNs, 15'000'000u);
+       std::uint64_t total = 0;
+       std::size_t bucket = 0;
+       for (std::size_t i = 0; i < s.blockHistogram.size(); ++i) {
+           total += s.blockHistogram[i];
+           if (s.blockHistogram[i]) bucket = i;
+       }
+       EXPECT_EQ(total, 1u);
+       EXPECT_GE(ChanStats::bucketUpperBoundNs(bucket), 15'000'000u);
+   }
+}
 
+TEST(ChanStatsTest, UnbufferedSendCountsAsBlocked) {
+   Chan<int> ch;
+   ch.enableStats("rendezvous");
+   std::thread sender([&] { ch << 7; });
+   EXPECT_EQ(*ch.recv(), 7);
+   sender.join();
+   auto s = ch.stats();
+   EXPECT_EQ(s.sends, 1u);
+   EXPECT_EQ(s.recvs, 1u);
+   EXPECT_EQ(s.length, 0u);
+   EXPECT_EQ(s.sendBlocks, 1u);
+}
+
+TEST(ChanStatsTest, RegistryListsLiveChannelsByName) {
+   auto count = [](const std::string& name) {
+       int n = 0;
+       for (const auto& s : ListChannels()) n += s.name == name;
+       return n;
+   };
+   {
+       Chan<int> jobs(4);
+       Chan<std::string> results(4);
+       jobs.enableStats("registry.jobs");
+       results.enableStats("registry.tmp");
+       results.enableStats("registry.results");  // renames, does not add
+       EXPECT_EQ(count("registry.jobs"), 1);
+       EXPECT_EQ(count("registry.results"), 1);
+       EXPECT_EQ(count("registry.tmp"), 0);
+
+       auto copy = jobs;
+       copy << 1;
+       EXPECT_EQ(jobs.stats().sends, 1u);
+   }
+   EXPECT_EQ(count("registry.jobs"), 0);
+   EXPECT_EQ(count("registry.results"), 0);
+}
 
 TEST(SelectTest, ReceivesFromFirstReadyChannel) {
     Chan<int> ch1(1);
@@ -493,6 +811,172 @@ TEST(SelectTest, RandomAmongReadyCases) {
     EXPECT_GT(count2, 0);
 }
 
+TEST(SelectTest, WakesOnRingBackedChannel) {
+    Chan<int> ch(4, ChanBackend::MPMC);
+    int got = 0;
+
+    std::thread t([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        ch << 7;
+        });
+
+    select(
+        recv<int>(ch, [&](std::optional<int> val) { got = val.value_or(-1); })
+        );
+
+    t.join();
+    EXPECT_EQ(got, 7);
+}
+
+TEST(StaticSelectTest, ReceivesReadyValue) {
+    Chan<int> ch1(1), ch2(1);
+    ch2 << 5;
+    int got = 0;
+
+    select(
+        recvCase(ch1, [&](std::optional<int>) { got = -1; }),
+        recvCase(ch2, [&](std::optional<int> v) { got = *v; })
+        );
+
+    EXPECT_EQ(got, 5);
+}
+
+TEST(StaticSelectTest, DefaultWhenNothingReady) {
+    Chan<int> ch;
+    Chan<std::string> out(1);
+    out << "full";
+    bool hitDefault = false;
+
+    select(
+        recvCase(ch, [&](std::optional<int>) {}),
+        sendCase(out, "x", [&](bool) {}),
+        defaultCase([&] { hitDefault = true; })
+        );
+
+    EXPECT_TRUE(hitDefault);
+}
+
+TEST(StaticSelectTest, BlocksUntilSenderArrives) {
+    Chan<int> ch;
+    int got = 0;
+
+    std::thread t([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        ch << 9;
+        });
+
+    select(recvCase(ch, [&](std::optional<int> v) { got = v.value_or(-1); }));
+
+    t.join();
+    EXPECT_EQ(got, 9);
+}
+
+TEST(StaticSelectTest, SendCaseDeliversValue) {
+    Chan<int> ch(1);
+    bool ok = false;
+
+    select(sendCase(ch, 3, [&](bool sent) { ok = sent; }));
+
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(*ch.recv(), 3);
+}
+
+TEST(StaticSelectTest, FairAmongReadyCases) {
+    Chan<int> ch1(1), ch2(1), ch3(1);
+    int counts[3] = {0, 0, 0};
+
+    for (int i = 0; i < 300; ++i) {
+        ch1.trySend(i);
+        ch2.trySend(i);
+        ch3.trySend(i);
+        select(
+            recvCase(ch1, [&](std::optional<int>) { ++counts[0]; }),
+            recvCase(ch2, [&](std::optional<int>) { ++counts[1]; }),
+            recvCase(ch3, [&](std::optional<int>) { ++counts[2]; })
+            );
+    }
+
+    EXPECT_EQ(counts[0] + counts[1] + counts[2], 300);
+    for (int c : counts) EXPECT_GT(c, 30);
+}
+
+TEST(StaticSelectTest, ClosedChannelsWakeBothCaseKinds) {
+    Chan<int> in, out;
+    bool recvClosed = false;
+
+    std::thread t([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        in.close();
+        });
+
+    select(recvCase(in, [&](std::optional<int> v) { recvClosed = !v; }));
+    t.join();
+    EXPECT_TRUE(recvClosed);
+
+    out.close();
+    bool sent = true;
+    select(sendCase(out, 1, [&](bool ok) { sent = ok; }));
+    EXPECT_FALSE(sent);
+}
+
+TEST(SelectTest, ManySelectorsOnSharedChannelEachGetOneValue) {
+    for (auto backend : {ChanBackend::Locked, ChanBackend::MPMC}) {
+        Chan<int> jobs(4, backend);
+        Chan<int> quit;
+        constexpr int workers = 64;
+        std::atomic<int> handled{0};
+        std::atomic<long> sum{0};
+
+        std::vector<std::thread> pool;
+        for (int w = 0; w < workers; ++w) {
+            pool.emplace_back([&] {
+                bool done = false;
+                while (!done) {
+                    select(
+                        recvCase(jobs, [&](std::optional<int> v) {
+                            if (!v) { done = true; return; }
+                            sum += *v;
+                            ++handled;
+                        }),
+                        recvCase(quit, [&](std::optional<int>) { done = true; })
+                        );
+                }
+            });
+        }
+
+        for (int i = 1; i <= 500; ++i) jobs << i;
+        while (handled < 500) std::this_thread::sleep_for(1ms);
+        jobs.close();
+        for (auto& t : pool) t.join();
+
+        EXPECT_EQ(handled.load(), 500);
+        EXPECT_EQ(sum.load(), 500L * 501 / 2);
+    }
+}
+
+TEST(SelectTest, UnusedWakeupIsPassedOn) {
+    // Two selects wait on the same channel; one value arrives. Whichever
+    // select is woken but then takes another case must hand the wakeup on.
+    Chan<int> shared(1), other(1);
+    std::atomic<int> fromShared{0}, fromOther{0};
+
+    auto worker = [&] {
+        select(
+            recv<int>(shared, [&](std::optional<int>) { ++fromShared; }),
+            recv<int>(other, [&](std::optional<int>) { ++fromOther; })
+            );
+    };
+    std::thread a(worker), b(worker);
+    std::this_thread::sleep_for(50ms);
+    other << 1;
+    shared << 2;
+    a.join();
+    b.join();
+
+    EXPECT_EQ(fromShared.load(), 1);
+    EXPECT_EQ(fromOther.load(), 1);
+}
+
 TEST(SelectTest, CloseChannelSelectsRecvWithNullopt) {
     Chan<int> ch;
     std::atomic<bool> gotClosed = false;
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <gocxx/bufio/bufio.h>
+#include <gocxx/io/io_errors.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace gocxx;
+using gocxx::base::Result;
+
+namespace {
+
+// Hands out at most `chunk` bytes per Read and reports the end like os::File: a zero-byte read.
+class ChunkReader : public io::Reader {
+public:
+    ChunkReader(std::string data, std::size_t chunk) : data_(std::move(data)), chunk_(chunk) {}
+
+    Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override {
+        const std::size_t n = std::min({size, chunk_, data_.size() - pos_});
+        std::memcpy(buffer, data_.data() + pos_, n);
+        pos_ += n;
+        ++reads;
+        return { n };
+    }
+
+    int reads = 0;
+
+private:
+    std::string data_;
+    std::size_t chunk_;
+    std::size_t pos_ = 0;
+};
+
+class StringWriter : public io::Writer {
+public:
+    Result<std::size_t> Write(const uint8_t* buffer, std::size_t size) override {
+        out.append(reinterpret_cast<const char*>(buffer), size);
+        ++writes;
+        return { size };
+    }
+
+    std::string out;
+    int writes = 0;
+};
+
+} // namespace
+
+TEST(BufioTest, ReaderPeekReadLineAndReadString) {
+    bufio::Reader br(std::make_shared<ChunkReader>("GET / HTTP/1.1\r\nHost: x\n\nrest;tail", 3), 16);
+
+    auto peek = br.Peek(3);
+    ASSERT_TRUE(peek.Ok());
+    EXPECT_EQ(peek.value, "GET");
+
+    bool prefix = true;
+    auto line = br.ReadLine(&prefix);
+    ASSERT_TRUE(line.Ok());
+    EXPECT_EQ(line.value, "GET / HTTP/1.1");
+    EXPECT_FALSE(prefix);
+    EXPECT_EQ(br.ReadLine().value, "Host: x");
+    EXPECT_EQ(br.ReadLine().value, "");
+
+    EXPECT_EQ(br.ReadString(';').value, "rest;");
+    auto last = br.ReadString(';');
+    EXPECT_EQ(last.value, "tail");
+    EXPECT_TRUE(errors::Is(last.err, io::ErrEOF));
+}
+
+TEST(BufioTest, ReaderLongLinesComeInPieces) {
+    const std::string longLine(40, 'a');
+    bufio::Reader br(std::make_shared<ChunkReader>(longLine + "\nb\n", 64), 16);
+
+    std::string assembled;
+    bool prefix = true;
+    while (prefix) {
+        auto piece = br.ReadLine(&prefix);
+        ASSERT_TRUE(piece.Ok());
+        assembled.append(piece.value);
+    }
+    EXPECT_EQ(assembled, longLine);
+    EXPECT_EQ(br.ReadLine().value, "b");
+
+    auto slice = bufio::Reader(std::make_shared<ChunkReader>(longLine, 64), 16).ReadSlice('\n');
+    EXPECT_TRUE(errors::Is(slice.err, bufio::ErrBufferFull));
+    EXPECT_EQ(slice.value.size(), 16u);
+}
+
+TEST(BufioTest, ReaderByteOpsAndDiscard) {
+    bufio::Reader br(std::make_shared<ChunkReader>("abcdef", 2));
+    uint8_t b = 0;
+    ASSERT_TRUE(br.ReadByte(b).Ok());
+    EXPECT_EQ(b, 'a');
+    EXPECT_TRUE(br.UnreadByte().Ok());
+    EXPECT_TRUE(br.UnreadByte().Failed());
+    EXPECT_EQ(br.Discard(3).value, 3u);
+    ASSERT_TRUE(br.ReadByte(b).Ok());
+    EXPECT_EQ(b, 'd');
+
+    std::vector<uint8_t> buf(10);
+    std::string rest;
+    for (;;) {
+        auto res = br.Read(buf.data(), buf.size());
+        if (res.Failed()) {
+            EXPECT_TRUE(errors::Is(res.err, io::ErrEOF));
+            break;
+        }
+        rest.append(buf.begin(), buf.begin() + res.value);
+    }
+    EXPECT_EQ(rest, "ef");
+}
+
+TEST(BufioTest, WriterCoalescesWritesAndReadsFrom) {
+    auto sink = std::make_shared<StringWriter>();
+    bufio::Writer bw(sink, 16);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(bw.WriteString("ab").Ok());
+    }
+    EXPECT_EQ(sink->writes, 1);  // the 16-byte buffer filled once
+    EXPECT_EQ(bw.Buffered(), 4u);
+    EXPECT_EQ(bw.Available(), 12u);
+    ASSERT_TRUE(bw.WriteByte('!').Ok());
+
+    auto src = std::make_shared<ChunkReader>(std::string(50, 'z'), 7);
+    auto copied = bw.ReadFrom(src);
+    ASSERT_TRUE(copied.Ok());
+    EXPECT_EQ(copied.value, 50u);
+    ASSERT_TRUE(bw.Flush().Ok());
+    EXPECT_EQ(sink->out, "abababababababababab!" + std::string(50, 'z'));
+    EXPECT_EQ(bw.Buffered(), 0u);
+}
+
+TEST(BufioTest, ScannerSplitFunctions) {
+    bufio::Scanner lines(std::make_shared<ChunkReader>("one\r\ntwo\n\nthree", 4));
+    std::vector<std::string> got;
+    while (lines.Scan()) got.push_back(lines.Text());
+    EXPECT_EQ(lines.Err(), nullptr);
+    EXPECT_EQ(got, (std::vector<std::string>{"one", "two", "", "three"}));
+
+    bufio::Scanner words(std::make_shared<ChunkReader>("  alpha beta\t\tgamma \n", 3));
+    words.Split(bufio::ScanWords);
+    got.clear();
+    while (words.Scan()) got.push_back(words.Text());
+    EXPECT_EQ(got, (std::vector<std::string>{"alpha", "beta", "gamma"}));
+
+    bufio::Scanner runes(std::make_shared<ChunkReader>("a\xc3\xa9\xe2\x82\xac", 1));
+    runes.Split(bufio::ScanRunes);
+    got.clear();
+    while (runes.Scan()) got.push_back(runes.Text());
+    EXPECT_EQ(got, (std::vector<std::string>{"a", "\xc3\xa9", "\xe2\x82\xac"}));
+}
+
+TEST(BufioTest, ScannerRejectsTokensOverTheLimit) {
+    bufio::Scanner sc(std::make_shared<ChunkReader>(std::string(100, 'x') + "\n", 10));
+    sc.Buffer(8, 32);
+    EXPECT_FALSE(sc.Scan());
+    EXPECT_TRUE(errors::Is(sc.Err(), bufio::ErrTooLong));
+}
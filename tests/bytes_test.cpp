@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/encoding/json.h>
+#include <gocxx/io/io_errors.h>
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace gocxx;
+using gocxx::base::Result;
+
+namespace {
+
+// Hands out at most `chunk` bytes per Read and ends with a zero-byte read, like os::File.
+class ChunkReader : public io::Reader {
+public:
+    ChunkReader(std::string data, std::size_t chunk) : data_(std::move(data)), chunk_(chunk) {}
+
+    Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override {
+        const std::size_t n = std::min({size, chunk_, data_.size() - pos_});
+        std::memcpy(buffer, data_.data() + pos_, n);
+        pos_ += n;
+        return { n };
+    }
+
+private:
+    std::string data_;
+    std::size_t chunk_;
+    std::size_t pos_ = 0;
+};
+
+} // namespace
+
+TEST(BytesTest, WriteReadAndNext) {
+    bytes::Buffer buf("hello");
+    buf.WriteString(", ");
+    buf.WriteByte('w');
+    const std::string tail = "orld\nnext";
+    buf.Write(reinterpret_cast<const uint8_t*>(tail.data()), tail.size());
+    EXPECT_EQ(buf.Len(), 17u);
+    EXPECT_EQ(buf.Bytes(), "hello, world\nnext");
+
+    EXPECT_EQ(buf.Next(5), "hello");
+    uint8_t b = 0;
+    ASSERT_TRUE(buf.ReadByte(b).Ok());
+    EXPECT_EQ(b, ',');
+    EXPECT_TRUE(buf.UnreadByte().Ok());
+    EXPECT_TRUE(buf.UnreadByte().Failed());
+
+    EXPECT_EQ(buf.ReadString('\n').value, ", world\n");
+    auto rest = buf.ReadString('\n');
+    EXPECT_EQ(rest.value, "next");
+    EXPECT_TRUE(errors::Is(rest.err, io::ErrEOF));
+
+    uint8_t scratch[4];
+    auto eof = buf.Read(scratch, sizeof scratch);
+    EXPECT_EQ(eof.value, 0u);
+    EXPECT_TRUE(errors::Is(eof.err, io::ErrEOF));
+}
+
+TEST(BytesTest, GrowResetAndTruncateKeepCapacity) {
+    bytes::Buffer buf;
+    buf.Grow(1000);
+    const std::size_t cap = buf.Cap();
+    EXPECT_GE(cap, 1000u);
+    EXPECT_GE(buf.Available(), 1000u);
+
+    buf.WriteString(std::string(900, 'x'));
+    buf.Truncate(10);
+    EXPECT_EQ(buf.String(), std::string(10, 'x'));
+    EXPECT_THROW(buf.Truncate(11), std::out_of_range);
+
+    buf.Reset();
+    EXPECT_EQ(buf.Len(), 0u);
+    EXPECT_EQ(buf.Cap(), cap);
+    buf.WriteString(std::string(cap, 'y'));
+    EXPECT_EQ(buf.Cap(), cap);
+
+    // Reading from the front frees room that later writes reuse.
+    buf.Next(cap - 8);
+    buf.WriteString("12345678");
+    EXPECT_EQ(buf.Cap(), cap);
+    EXPECT_EQ(buf.String(), "yyyyyyyy12345678");
+
+    bytes::Buffer moved(std::move(buf));
+    EXPECT_EQ(moved.Len(), 16u);
+    EXPECT_EQ(buf.Cap(), 0u);
+    moved.Release();
+    EXPECT_EQ(moved.Cap(), 0u);
+}
+
+TEST(BytesTest, ReadFromWriteToAndCopy) {
+    const std::string payload(20000, 'p');
+    auto buf = std::make_shared<bytes::Buffer>();
+    auto n = buf->ReadFrom(std::make_shared<ChunkReader>(payload, 3000));
+    ASSERT_TRUE(n.Ok());
+    EXPECT_EQ(n.value, payload.size());
+
+    auto sink = std::make_shared<bytes::Buffer>();
+    auto copied = io::Copy(sink, buf);
+    ASSERT_TRUE(copied.Ok());
+    EXPECT_EQ(copied.value, payload.size());
+    EXPECT_EQ(buf->Len(), 0u);
+    EXPECT_EQ(sink->Bytes(), payload);
+
+    std::vector<uint8_t> all;
+    auto read = io::ReadAll(std::make_shared<ChunkReader>(payload, 777), all);
+    ASSERT_TRUE(read.Ok());
+    EXPECT_EQ(std::string(all.begin(), all.end()), payload);
+}
+
+TEST(BytesTest, JsonEncoderWritesIntoBuffer) {
+    auto buf = std::make_shared<bytes::Buffer>();
+    auto enc = encoding::json::NewEncoder(buf);
+    enc->SetIndent("> ", "  ");
+    ASSERT_TRUE(enc->Encode(encoding::json::JsonValue{{"a", 1}}).Ok());
+    EXPECT_EQ(buf->String(), "> {\n>   \"a\": 1\n> }\n");
+}
@@ -8,6 +8,8 @@
 #include <gocxx/time/time.h>
 #include <thread>
 #include <chrono>
+#include <vector>
+#include <atomic>
 
 using namespace gocxx::context;
 using namespace gocxx::time;
@@ -81,6 +83,92 @@ TEST_F(ContextTest, WithCancel) {
     EXPECT_EQ(err.err->error(), Canceled);
 }
 
+// Many short-lived timeouts share the timer service instead of a thread each
+TEST_F(ContextTest, ManyTimeoutsCanceledEarly) {
+    auto parent = Background();
+    for (int i = 0; i < 2000; ++i) {
+        auto result = WithTimeout(parent, Seconds(int64_t(30)));
+        ASSERT_TRUE(result.Ok());
+        result.value.second();
+        EXPECT_EQ(result.value.first->Err().err->error(), Canceled);
+    }
+
+    std::vector<ContextPtr> live;
+    for (int i = 0; i < 50; ++i) {
+        live.push_back(WithTimeout(parent, Milliseconds(10 + i % 5)).value.first);
+    }
+    for (auto& ctx : live) {
+        ctx->Done().recv();
+        EXPECT_EQ(ctx->Err().err->error(), DeadlineExceeded);
+    }
+}
+
+// Sleeping and waiting wake on cancellation instead of polling
+TEST_F(ContextTest, SleepAndWaitWakeOnCancel) {
+    auto result = WithCancel(Background());
+    ASSERT_TRUE(result.Ok());
+    auto [ctx, cancel] = result.value;
+    auto valueCtx = WithValue(ctx, std::string("k"), 1).value;
+
+    std::thread canceler([cancel = cancel] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        cancel();
+    });
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(SleepWithContext(valueCtx, Seconds(int64_t(10))).Ok());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    canceler.join();
+
+    auto waited = WaitForContext(ctx, Seconds(int64_t(10)));
+    ASSERT_TRUE(waited.Ok());
+    EXPECT_TRUE(waited.value);
+
+    // Not canceled: the full timeout elapses and the result is false.
+    auto live = WithCancel(Background()).value;
+    start = std::chrono::steady_clock::now();
+    auto timedOut = WaitForContext(live.first, Milliseconds(30));
+    ASSERT_TRUE(timedOut.Ok());
+    EXPECT_FALSE(timedOut.value);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(25));
+    EXPECT_TRUE(SleepWithContext(Background(), Milliseconds(5)).Ok());
+    live.second();
+}
+
+// Typed keys are found in constant time through any derived context
+TEST_F(ContextTest, TypedValuesPropagateThroughDerivedContexts) {
+    static const ContextKey<std::string> requestID("request-id");
+    static const ContextKey<int> userID("user-id");
+    static const ContextKey<int> otherInt("other");
+
+    auto ctx = WithValue(Background(), requestID, "req-1").value;
+    ctx = WithValue(ctx, userID, 42).value;
+    for (int i = 0; i < 10; ++i) {
+        ctx = WithValue(ctx, std::string("layer"), i).value;  // untyped layers in between
+    }
+    auto [cancelCtx, cancel] = WithCancel(ctx).value;
+    auto timed = WithTimeout(cancelCtx, Seconds(int64_t(5))).value.first;
+
+    const std::string* rid = Value(timed, requestID);
+    ASSERT_NE(rid, nullptr);
+    EXPECT_EQ(*rid, "req-1");
+    ASSERT_NE(Value(timed, userID), nullptr);
+    EXPECT_EQ(*Value(timed, userID), 42);
+    EXPECT_EQ(Value(timed, otherInt), nullptr);
+    EXPECT_EQ(Value(Background(), requestID), nullptr);
+    EXPECT_EQ(rid, Value(cancelCtx, requestID));  // shared, not copied
+
+    // Shadowing in a child does not affect the parent.
+    auto shadow = WithValue(timed, userID, 7).value;
+    EXPECT_EQ(*Value(shadow, userID), 7);
+    EXPECT_EQ(*Value(timed, userID), 42);
+    EXPECT_TRUE(WithValue(nullptr, userID, 1).Failed());
+
+    // The typed layer still forwards cancellation and untyped values.
+    cancel();
+    EXPECT_FALSE(shadow->Err().Ok());
+    EXPECT_TRUE(shadow->Value(std::string("layer")).Ok());
+}
+
 // Test WithTimeout - exact Go behavior
 TEST_F(ContextTest, WithTimeout) {
     auto parent = Background();
@@ -258,3 +346,72 @@ TEST_F(ContextTest, UtilityFunctions) {
     EXPECT_TRUE(wait_result.Ok());
     EXPECT_TRUE(wait_result.value); // Should return true (context was canceled)
 }
+
+TEST_F(ContextTest, CancelReachesChildrenThroughValueContexts) {
+    auto [root, cancelRoot] = WithCancel(Background()).value;
+    // Short-lived children unlink themselves from root when they go away
+    for (int i = 0; i < 1000; ++i) {
+        auto [child, cancelChild] = WithCancel(root).value;
+        if (i % 2 == 0) cancelChild();
+    }
+    auto valued = WithValue(root, std::any(std::string("k")), std::any(1)).value;
+    auto [leaf, cancelLeaf] = WithTimeout(valued, Seconds(int64_t(60))).value;
+
+    cancelRoot();
+    EXPECT_TRUE(leaf->Err().Failed());
+    // Done() is created lazily and is already closed after cancellation
+    EXPECT_TRUE(leaf->Done().isClosed());
+    cancelLeaf();
+}
+
+TEST_F(ContextTest, CancelReachesChildrenThroughTypedValueContexts) {
+    static const ContextKey<int> attempt("attempt");
+    auto [root, cancelRoot] = WithCancel(Background()).value;
+    auto valued = WithValue(root, attempt, 3).value;
+    auto [leaf, cancelLeaf] = WithCancel(valued).value;
+    std::atomic<bool> ran{false};
+    AfterCancel(valued, [&] { ran = true; });
+
+    cancelRoot();
+    EXPECT_TRUE(valued->Err().Failed());
+    EXPECT_TRUE(leaf->Err().Failed());
+    EXPECT_TRUE(leaf->Done().isClosed());
+    for (int i = 0; i < 200 && !ran.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(ran.load());
+    EXPECT_EQ(*Value(leaf, attempt), 3);
+    cancelLeaf();
+}
+
+TEST_F(ContextTest, AfterCancel) {
+    auto [ctx, cancel] = WithCancel(Background()).value;
+    std::atomic<int> ran{0};
+    auto stopFirst = AfterCancel(ctx, [&] { ran += 1; });
+    auto stopSecond = AfterCancel(ctx, [&] { ran += 10; });
+    EXPECT_TRUE(stopSecond());
+    EXPECT_FALSE(stopSecond());
+
+    cancel();
+    for (int i = 0; i < 200 && ran.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(ran.load(), 1);
+    EXPECT_FALSE(stopFirst());
+
+    // Already canceled: runs right away; never for Background
+    AfterCancel(ctx, [&] { ran += 100; });
+    for (int i = 0; i < 200 && ran.load() == 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(ran.load(), 101);
+    EXPECT_TRUE(AfterCancel(Background(), [] {})());
+
+    // Nothing to run, canceled or not
+    auto [live, stopLive] = WithCancel(Background()).value;
+    auto stopEmpty = AfterCancel(live, nullptr);
+    stopLive();
+    EXPECT_TRUE(stopEmpty());
+    EXPECT_FALSE(stopEmpty());
+    EXPECT_TRUE(AfterCancel(ctx, nullptr)());
+}
@@ -0,0 +1,221 @@
+// Coroutine awaitables are only built with -DGOCXX_ENABLE_COROUTINES=ON.
+#if defined(GOCXX_HAS_COROUTINES)
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <gocxx/coro/coro.h>
+#include <gocxx/base/chan.h>
+#include <gocxx/base/select.h>
+#include <gocxx/context/context.h>
+#include <gocxx/time/timer.h>
+
+using namespace gocxx;
+using namespace gocxx::coro;
+
+namespace {
+
+Task<int> sumUntilClosed(base::Chan<int> ch) {
+    int total = 0;
+    while (auto v = co_await ch.recvAsync()) {
+        total += *v;
+    }
+    co_return total;
+}
+
+Task<int> addOne(int x) {
+    co_return x + 1;
+}
+
+Task<int> chain(int depth) {
+    int v = 0;
+    for (int i = 0; i < depth; ++i) {
+        v = co_await addOne(v);
+    }
+    co_return v;
+}
+
+Task<void> fails() {
+    throw std::runtime_error("boom");
+    co_return;
+}
+
+} // namespace
+
+TEST(CoroTest, TaskChainsAndReturnsValue) {
+    EXPECT_EQ(SyncWait(chain(10000)), 10000);
+}
+
+TEST(CoroTest, ExceptionsPropagateToAwaiter) {
+    EXPECT_THROW(SyncWait(fails()), std::runtime_error);
+}
+
+TEST(CoroTest, RecvAsyncReadyValueDoesNotSuspend) {
+    base::Chan<int> ch(2);
+    ch << 5;
+    ManualExecutor ex;
+    bool done = false;
+    int got = 0;
+    Spawn([](base::Chan<int> c, int& out, bool& flag) -> Task<void> {
+        auto v = co_await c.recvAsync();
+        out = *v;
+        flag = true;
+    }(ch, got, done), ex);
+    ex.runPending();
+    EXPECT_TRUE(done);
+    EXPECT_EQ(got, 5);
+}
+
+TEST(CoroTest, ParkedCoroutineResumesWhenThreadSends) {
+    base::Chan<int> ch;
+    ManualExecutor ex;
+    std::atomic<bool> done{false};
+    int got = 0;
+    Spawn([](base::Chan<int> c, int& out, std::atomic<bool>& flag) -> Task<void> {
+        auto v = co_await c;
+        out = *v;
+        flag = true;
+    }(ch, got, done), ex);
+    ex.runPending();
+    EXPECT_FALSE(done.load());  // parked, holding no thread
+
+    std::thread sender([ch]() mutable { ch << 42; });
+    ex.runUntil([&] { return done.load(); });
+    sender.join();
+    EXPECT_EQ(got, 42);
+}
+
+TEST(CoroTest, SumUntilClosedOnRuntime) {
+    base::Chan<int> ch(4);
+    std::thread producer([ch]() mutable {
+        for (int i = 1; i <= 100; ++i) ch << i;
+        ch.close();
+    });
+    EXPECT_EQ(SyncWait(sumUntilClosed(ch)), 5050);
+    producer.join();
+}
+
+TEST(CoroTest, PingPongBetweenCoroutines) {
+    base::Chan<int> ping;
+    base::Chan<int> pong;
+    constexpr int kRounds = 500;
+
+    Spawn([](base::Chan<int> in, base::Chan<int> out) -> Task<void> {
+        while (auto v = co_await in.recvAsync()) {
+            co_await out.sendAsync(*v + 1);
+        }
+        out.close();
+    }(ping, pong));
+
+    auto driver = [](base::Chan<int> out, base::Chan<int> in) -> Task<int> {
+        int v = 0;
+        for (int i = 0; i < kRounds; ++i) {
+            co_await out.sendAsync(v);
+            v = *co_await in.recvAsync();
+        }
+        out.close();
+        co_return v;
+    };
+    EXPECT_EQ(SyncWait(driver(ping, pong)), kRounds);
+}
+
+TEST(CoroTest, SendAsyncWaitsForSpace) {
+    base::Chan<int> ch(2);
+    ch << 1;
+    ch << 2;
+    ManualExecutor ex;
+    std::atomic<bool> sent{false};
+    Spawn([](base::Chan<int> c, std::atomic<bool>& flag) -> Task<void> {
+        co_await c.sendAsync(3);
+        flag = true;
+    }(ch, sent), ex);
+    ex.runPending();
+    EXPECT_FALSE(sent.load());
+
+    EXPECT_EQ(ch.recv().value(), 1);
+    ex.runUntil([&] { return sent.load(); });
+    EXPECT_EQ(ch.recv().value(), 2);
+    EXPECT_EQ(ch.recv().value(), 3);
+}
+
+TEST(CoroTest, SendAsyncOnClosedChannelThrows) {
+    base::Chan<int> ch(1);
+    ch.close();
+    auto body = [](base::Chan<int> c) -> Task<void> { co_await c.sendAsync(1); };
+    EXPECT_THROW(SyncWait(body(ch)), std::runtime_error);
+}
+
+TEST(CoroTest, AwaitSelectPicksReadyCase) {
+    base::Chan<int> a;
+    base::Chan<std::string> b;
+    ManualExecutor ex;
+    std::atomic<bool> done{false};
+    std::string which;
+
+    Spawn([](base::Chan<int> ca, base::Chan<std::string> cb, std::string& out,
+             std::atomic<bool>& flag) -> Task<void> {
+        base::Select sel;
+        sel.addCase(base::recv<int>(ca, [&](std::optional<int>) { out = "a"; }));
+        sel.addCase(base::recv<std::string>(cb, [&](std::optional<std::string> v) { out = *v; }));
+        co_await sel;
+        flag = true;
+    }(a, b, which, done), ex);
+    ex.runPending();
+    EXPECT_FALSE(done.load());
+
+    std::thread sender([b]() mutable { b << std::string("b"); });
+    ex.runUntil([&] { return done.load(); });
+    sender.join();
+    EXPECT_EQ(which, "b");
+}
+
+TEST(CoroTest, AwaitTimerChannel) {
+    auto timer = time::NewTimer(time::Duration(20 * time::Duration::Millisecond));
+    auto start = std::chrono::steady_clock::now();
+    auto body = [](time::Timer& t) -> Task<void> { co_await t.C(); };
+    SyncWait(body(*timer));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(15));
+}
+
+TEST(CoroTest, AwaitContextDone) {
+    auto res = context::WithCancel(context::Background());
+    ASSERT_TRUE(res.Ok());
+    auto ctx = res.value.first;
+    auto cancel = res.value.second;
+
+    ManualExecutor ex;
+    std::atomic<bool> done{false};
+    Spawn([](context::ContextPtr c, std::atomic<bool>& flag) -> Task<void> {
+        co_await c->DoneAsync();
+        flag = true;
+    }(ctx, done), ex);
+    ex.runPending();
+    EXPECT_FALSE(done.load());
+
+    cancel();
+    ex.runUntil([&] { return done.load(); });
+    EXPECT_TRUE(ctx->Err().Failed());
+}
+
+TEST(CoroTest, ThousandsOfParkedCoroutinesShareOneThread) {
+    constexpr int kWaiters = 5000;
+    base::Chan<int> gate;
+    ManualExecutor ex;
+    std::atomic<int> woke{0};
+    for (int i = 0; i < kWaiters; ++i) {
+        Spawn([](base::Chan<int> g, std::atomic<int>& n) -> Task<void> {
+            co_await g.recvAsync();
+            n.fetch_add(1);
+        }(gate, woke), ex);
+    }
+    ex.runPending();
+    EXPECT_EQ(woke.load(), 0);
+    gate.close();
+    ex.runUntil([&] { return woke.load() == kWaiters; });
+    EXPECT_EQ(woke.load(), kWaiters);
+}
+
+#endif // GOCXX_HAS_COROUTINES
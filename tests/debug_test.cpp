@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <gocxx/base/chan.h>
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/debug/pprof.h>
+#include <gocxx/net/http.h>
+#include <gocxx/sync/pool.h>
+#include <gocxx/sync/profiled_mutex.h>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace gocxx;
+using namespace gocxx::net::http;
+
+namespace {
+
+class RecordingWriter : public ResponseWriter {
+public:
+    HeaderMap& Header() override { return header; }
+    base::Result<std::size_t> Write(const std::string& data) override {
+        body += data;
+        return {data.size(), nullptr};
+    }
+    void WriteHeader(int statusCode) override { status = statusCode; }
+
+    HeaderMap header;
+    std::string body;
+    int status = StatusOK;
+};
+
+RecordingWriter get(ServeMux& mux, const std::string& url) {
+    Request req;
+    req.method = "GET";
+    req.url = url;
+    req.proto = "HTTP/1.1";
+    RecordingWriter w;
+    mux.ServeHTTP(w, req);
+    return w;
+}
+
+// Number of top-level fields numbered @p field in a protobuf message
+int topLevelFields(const std::string& msg, uint64_t field) {
+    std::size_t i = 0;
+    auto varint = [&]() {
+        uint64_t v = 0;
+        for (int shift = 0; i < msg.size(); shift += 7) {
+            const auto b = static_cast<uint8_t>(msg[i++]);
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) break;
+        }
+        return v;
+    };
+    int n = 0;
+    while (i < msg.size()) {
+        const uint64_t key = varint();
+        if ((key >> 3) == field) ++n;
+        if ((key & 7) == 2) i += varint();
+        else varint();
+    }
+    return n;
+}
+
+} // namespace
+
+TEST(DebugTest, HandlersServeTextReports) {
+    ServeMux mux;
+    debug::RegisterHandlers(mux);
+
+    base::Chan<int> ch(4);
+    ch.enableStats("debug.test.chan");
+    ch.send(1);
+    sync::Pool<int> pool([] { return std::make_shared<int>(0); });
+    pool.SetName("debug.test.pool");
+    pool.Put(pool.Get());
+
+    EXPECT_NE(get(mux, "/debug/pprof/").body.find("/debug/pprof/profile"), std::string::npos);
+    EXPECT_NE(get(mux, "/debug/pprof/threads").body.find("threads: "), std::string::npos);
+    EXPECT_NE(get(mux, "/debug/pprof/runtime").body.find("timers queued: "), std::string::npos);
+    EXPECT_NE(get(mux, "/debug/pprof/channels").body.find("debug.test.chan: cap=4 len=1"), std::string::npos);
+    EXPECT_NE(get(mux, "/debug/pprof/pools").body.find("debug.test.pool: gets=1 misses=1"), std::string::npos);
+    EXPECT_NE(get(mux, "/debug/pprof/mutex?debug=1").body.find("sampling 1 in"), std::string::npos);
+    EXPECT_EQ(get(mux, "/debug/pprof/profile?seconds=0").status, StatusBadRequest);
+}
+
+TEST(DebugTest, MutexProfileIsPprofProtobuf) {
+    sync::SetMutexProfileFraction(1);
+    sync::ResetMutexProfile();
+    sync::ProfiledMutex mu("debug.test.mutex");
+    mu.lock();
+    std::thread waiter([&] {
+        mu.lock();
+        mu.unlock();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mu.unlock();
+    waiter.join();
+    sync::SetMutexProfileFraction(0);
+
+    bytes::Buffer out;
+    ASSERT_TRUE(debug::WriteMutexProfile(out).Ok());
+    const std::string data = out.String();
+    ASSERT_FALSE(data.empty());
+    EXPECT_EQ(static_cast<uint8_t>(data[0]), 0x0a);  // field 1 (sample_type), length-delimited
+    EXPECT_NE(data.find("contentions"), std::string::npos);
+    EXPECT_NE(data.find("debug.test.mutex"), std::string::npos);
+    sync::ResetMutexProfile();
+}
+
+TEST(DebugTest, CPUProfileSamplesBusyThreads) {
+    auto out = std::make_shared<bytes::Buffer>();
+    auto started = debug::StartCPUProfile(out, 1000);
+    if (errors::Is(started.err, debug::ErrProfilingUnsupported)) GTEST_SKIP() << "no SIGPROF here";
+    ASSERT_TRUE(started.Ok()) << started.err->error();
+    EXPECT_TRUE(errors::Is(debug::StartCPUProfile(out).err, debug::ErrProfilingInUse));
+
+    volatile double sink = 0;
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+    while (std::chrono::steady_clock::now() < end) {
+        for (int i = 0; i < 10000; ++i) sink = sink + std::sqrt(static_cast<double>(i));
+    }
+    ASSERT_TRUE(debug::StopCPUProfile().Ok());
+
+    const std::string data = out->String();
+    ASSERT_FALSE(data.empty());
+    EXPECT_EQ(static_cast<uint8_t>(data[0]), 0x0a);
+    EXPECT_NE(data.find("nanoseconds"), std::string::npos);
+    EXPECT_GT(topLevelFields(data, 2), 0) << "no samples recorded";
+
+    // A second profile can start once the first has stopped
+    ASSERT_TRUE(debug::StartCPUProfile(std::make_shared<bytes::Buffer>()).Ok());
+    ASSERT_TRUE(debug::StopCPUProfile().Ok());
+
+    // Down to one sample a second
+    auto slow = debug::StartCPUProfile(std::make_shared<bytes::Buffer>(), 1);
+    ASSERT_TRUE(slow.Ok()) << slow.err->error();
+    ASSERT_TRUE(debug::StopCPUProfile().Ok());
+}
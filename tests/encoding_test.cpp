@@ -0,0 +1,383 @@
+#include <gtest/gtest.h>
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/encoding/base32.h>
+#include <gocxx/encoding/base64.h>
+#include <gocxx/encoding/hex.h>
+#include <gocxx/io/io.h>
+#include <gocxx/io/io_errors.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace gocxx::encoding;
+
+namespace {
+
+std::string str(const std::vector<uint8_t>& v) {
+    return std::string(v.begin(), v.end());
+}
+
+std::string randomBytes(std::mt19937& rng, std::size_t n) {
+    std::string s(n, '\0');
+    for (auto& c : s) c = static_cast<char>(rng());
+    return s;
+}
+
+// Runs f once under each vector kernel this CPU has, then under the scalar code
+void forEachKernel(const char* (*current)(), bool (*set)(std::string_view), const std::function<void()>& f) {
+    const std::string before = current();
+    for (const char* k : {"avx2", "ssse3", "neon", "scalar"}) {
+        if (set(k)) {
+            SCOPED_TRACE(k);
+            f();
+        }
+    }
+    set(before);
+}
+
+// The offset of a base64 or base32 decode error, or -1 for none
+template <typename CorruptError>
+int64_t errorOffset(const std::shared_ptr<gocxx::errors::Error>& err) {
+    if (!err) return -1;
+    std::shared_ptr<CorruptError> corrupt;
+    return gocxx::errors::As(err, corrupt) ? corrupt->Offset() : -2;
+}
+
+// Hands out its data a few bytes at a time
+class ChunkedReader : public gocxx::io::Reader {
+    std::string data_;
+    std::size_t pos_ = 0;
+    std::size_t chunk_;
+
+public:
+    ChunkedReader(std::string data, std::size_t chunk) : data_(std::move(data)), chunk_(chunk) {}
+
+    gocxx::base::Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override {
+        const std::size_t n = std::min({size, chunk_, data_.size() - pos_});
+        if (n == 0) return {0, gocxx::io::ErrEOF};
+        std::memcpy(buffer, data_.data() + pos_, n);
+        pos_ += n;
+        return {n, nullptr};
+    }
+};
+
+// Reads r to the end, a few bytes at a time
+gocxx::base::Result<std::string> readAll(gocxx::io::Reader& r, std::size_t chunk) {
+    std::string out;
+    std::vector<uint8_t> buf(chunk);
+    while (true) {
+        auto n = r.Read(buf.data(), buf.size());
+        out.append(reinterpret_cast<const char*>(buf.data()), n.value);
+        if (n.Failed()) {
+            return {out, gocxx::errors::Is(n.err, gocxx::io::ErrEOF) ? nullptr : n.err};
+        }
+    }
+}
+
+} // namespace
+
+// Test the RFC 4648 vectors in each of the four standard encodings
+TEST(Base64Test, StandardVectors) {
+    const std::vector<std::pair<std::string, std::string>> pairs = {
+        {"", ""},           {"f", "Zg=="},       {"fo", "Zm8="},         {"foo", "Zm9v"},
+        {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+        {"sure.", "c3VyZS4="}, {"\xfb\xff\xbf", "+/+/"},
+    };
+    forEachKernel(base64::detail::Base64Kernel, base64::detail::SetBase64Kernel, [&] {
+        for (const auto& [plain, encoded] : pairs) {
+            std::string url = encoded, raw = encoded;
+            std::replace(url.begin(), url.end(), '+', '-');
+            std::replace(url.begin(), url.end(), '/', '_');
+            raw.erase(std::remove(raw.begin(), raw.end(), '='), raw.end());
+            std::string raw_url = url;
+            raw_url.erase(std::remove(raw_url.begin(), raw_url.end(), '='), raw_url.end());
+
+            EXPECT_EQ(base64::StdEncoding.EncodeToString(plain), encoded);
+            EXPECT_EQ(base64::URLEncoding.EncodeToString(plain), url);
+            EXPECT_EQ(base64::RawStdEncoding.EncodeToString(plain), raw);
+            EXPECT_EQ(base64::RawURLEncoding.EncodeToString(plain), raw_url);
+            EXPECT_EQ(base64::StdEncoding.EncodedLen(plain.size()), encoded.size());
+            EXPECT_EQ(base64::RawStdEncoding.EncodedLen(plain.size()), raw.size());
+
+            auto d = base64::StdEncoding.DecodeString(encoded);
+            ASSERT_TRUE(d.Ok()) << encoded;
+            EXPECT_EQ(str(d.value), plain);
+            EXPECT_EQ(str(base64::URLEncoding.DecodeString(url).value), plain);
+            EXPECT_EQ(str(base64::RawStdEncoding.DecodeString(raw).value), plain);
+            EXPECT_EQ(str(base64::RawURLEncoding.DecodeString(raw_url).value), plain);
+        }
+    });
+
+    std::string appended = "x=";
+    base64::StdEncoding.AppendEncode(appended, "foo");
+    EXPECT_EQ(appended, "x=Zm9v");
+    EXPECT_TRUE(base64::StdEncoding.AppendDecode(appended, "YmFy").Ok());
+    EXPECT_EQ(appended, "x=Zm9vbar");
+}
+
+// Test that the vector kernels agree with the scalar code on every length,
+// with newlines in the input and with a custom alphabet
+TEST(Base64Test, KernelsMatchScalar) {
+    std::mt19937 rng(49);
+    const auto custom = base64::NewEncoding("ZYXWVUTSRQPONMLKJIHGFEDCBAzyxwvutsrqponmlkjihgfedcba9876543210.,")
+                            .WithPadding('*');
+    const base64::Encoding* encodings[] = {&base64::StdEncoding, &base64::URLEncoding, &base64::RawStdEncoding,
+                                           &base64::RawURLEncoding, &custom};
+    std::vector<std::string> inputs;
+    for (std::size_t n = 0; n < 200; ++n) inputs.push_back(randomBytes(rng, n));
+    inputs.push_back(randomBytes(rng, 100000));
+
+    for (const auto* enc : encodings) {
+        base64::detail::SetBase64Kernel("scalar");
+        std::vector<std::string> expected;
+        for (const auto& in : inputs) expected.push_back(enc->EncodeToString(in));
+        forEachKernel(base64::detail::Base64Kernel, base64::detail::SetBase64Kernel, [&] {
+            for (std::size_t i = 0; i < inputs.size(); ++i) {
+                ASSERT_EQ(enc->EncodeToString(inputs[i]), expected[i]) << "length " << inputs[i].size();
+                auto d = enc->DecodeString(expected[i]);
+                ASSERT_TRUE(d.Ok()) << "length " << inputs[i].size();
+                ASSERT_EQ(str(d.value), inputs[i]);
+
+                // MIME-style lines, and a stray \r\n mid-quantum
+                std::string wrapped;
+                for (std::size_t j = 0; j < expected[i].size(); j += 76) {
+                    wrapped += expected[i].substr(j, 76) + "\r\n";
+                }
+                wrapped.insert(wrapped.size() / 3, "\r\n");
+                d = enc->DecodeString(wrapped);
+                ASSERT_TRUE(d.Ok()) << "length " << inputs[i].size();
+                ASSERT_EQ(str(d.value), inputs[i]);
+            }
+        });
+    }
+}
+
+// Test Go's corrupt-input cases, and that a bad byte deep in a long input
+// is reported at the same offset by every kernel
+TEST(Base64Test, CorruptInput) {
+    const std::vector<std::pair<std::string, int64_t>> cases = {
+        {"", -1},         {"\n", -1},       {"AAA=\n", -1},   {"AAAA\n", -1},   {"!!!!", 0},
+        {"====", 0},      {"x===", 1},      {"=AAA", 0},      {"A=AA", 1},      {"AA=A", 2},
+        {"AA==A", 4},     {"AAA=AAAA", 4},  {"AAAAA", 4},     {"AAAAAA", 4},    {"A=", 1},
+        {"A==", 1},       {"AA=", 3},       {"AA==", -1},     {"AAA=", -1},     {"AAAA", -1},
+        {"AAAAAA=", 7},   {"YWJjZA=====", 8}, {"A!\n", 1},    {"A=\n", 1},
+    };
+    forEachKernel(base64::detail::Base64Kernel, base64::detail::SetBase64Kernel, [&] {
+        for (const auto& [input, offset] : cases) {
+            EXPECT_EQ(errorOffset<base64::CorruptInputError>(base64::StdEncoding.DecodeString(input).err), offset)
+                << "\"" << input << "\"";
+        }
+    });
+
+    std::mt19937 rng(7);
+    const std::string good = base64::StdEncoding.EncodeToString(randomBytes(rng, 3000));
+    for (std::size_t at : {std::size_t(0), std::size_t(17), std::size_t(1000), std::size_t(3999)}) {
+        std::string bad = good;
+        bad[at] = '*';
+        forEachKernel(base64::detail::Base64Kernel, base64::detail::SetBase64Kernel, [&] {
+            auto d = base64::StdEncoding.DecodeString(bad);
+            EXPECT_EQ(errorOffset<base64::CorruptInputError>(d.err), static_cast<int64_t>(at));
+            EXPECT_EQ(d.value.size(), at / 4 * 3);  // the quanta before it
+        });
+    }
+
+    auto err = base64::StdEncoding.DecodeString("Zg=!").err;
+    ASSERT_TRUE(err);
+    EXPECT_EQ(err->error(), "illegal base64 data at input byte 2");
+
+    // Strict rejects padding bits that are not zero
+    EXPECT_TRUE(base64::StdEncoding.DecodeString("Zh==").Ok());
+    EXPECT_EQ(errorOffset<base64::CorruptInputError>(base64::StdEncoding.Strict().DecodeString("Zh==").err), 2);
+    EXPECT_TRUE(base64::StdEncoding.Strict().DecodeString("Zg==").Ok());
+
+    EXPECT_THROW(base64::NewEncoding("abc"), std::invalid_argument);
+    EXPECT_THROW(base64::StdEncoding.WithPadding('A'), std::invalid_argument);
+    EXPECT_THROW(base64::StdEncoding.WithPadding('\n'), std::invalid_argument);
+}
+
+// Test the stream encoder and decoder with writes and reads of every size
+TEST(Base64Test, Streams) {
+    std::mt19937 rng(3);
+    const std::string data = randomBytes(rng, 10000);
+    const std::string encoded = base64::StdEncoding.EncodeToString(data);
+
+    for (std::size_t chunk : {1, 2, 3, 5, 4096, 20000}) {
+        auto buf = std::make_shared<gocxx::bytes::Buffer>();
+        auto w = base64::NewEncoder(base64::StdEncoding, buf);
+        for (std::size_t i = 0; i < data.size(); i += chunk) {
+            const std::size_t n = std::min(chunk, data.size() - i);
+            auto r = w->Write(reinterpret_cast<const uint8_t*>(data.data()) + i, n);
+            ASSERT_TRUE(r.Ok());
+            EXPECT_EQ(r.value, n);
+        }
+        w->close();
+        EXPECT_EQ(buf->String(), encoded) << "chunk " << chunk;
+
+        std::string wrapped;
+        for (std::size_t j = 0; j < encoded.size(); j += 64) wrapped += encoded.substr(j, 64) + "\n";
+        auto r = base64::NewDecoder(base64::StdEncoding, std::make_shared<ChunkedReader>(wrapped, chunk));
+        auto got = readAll(*r, chunk);
+        ASSERT_TRUE(got.Ok()) << got.err->error();
+        EXPECT_EQ(got.value, data) << "chunk " << chunk;
+    }
+
+    // The error offset counts from the start of the stream
+    auto r = base64::NewDecoder(base64::StdEncoding, std::make_shared<ChunkedReader>("Zm9vYmFy\nZm9v!mFy", 3));
+    auto got = readAll(*r, 2);
+    EXPECT_EQ(got.value, "foobarfoo");
+    EXPECT_EQ(errorOffset<base64::CorruptInputError>(got.err), 13);
+}
+
+TEST(HexTest, EncodeAndDecode) {
+    EXPECT_EQ(hex::EncodeToString("Hello Gopher!"), "48656c6c6f20476f7068657221");
+    EXPECT_EQ(str(hex::DecodeString("48656C6c6F20476f7068657221").value), "Hello Gopher!");
+    EXPECT_EQ(hex::EncodeToString(std::string("\x00\x01\xfe\xff", 4)), "0001feff");
+
+    std::mt19937 rng(11);
+    for (std::size_t n : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000, 65537}) {
+        const std::string data = randomBytes(rng, n);
+        hex::detail::SetHexKernel("scalar");
+        const std::string expected = hex::EncodeToString(data);
+        std::string upper = expected;
+        for (auto& c : upper) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        forEachKernel(hex::detail::HexKernel, hex::detail::SetHexKernel, [&] {
+            ASSERT_EQ(hex::EncodeToString(data), expected) << "length " << n;
+            ASSERT_EQ(str(hex::DecodeString(expected).value), data);
+            ASSERT_EQ(str(hex::DecodeString(upper).value), data);
+        });
+    }
+}
+
+// Test Go's error cases, and that every kernel stops at the first bad digit
+TEST(HexTest, Errors) {
+    struct Case {
+        std::string in;
+        std::string out;
+        std::string err;
+    };
+    const std::vector<Case> cases = {
+        {"0", "", "encoding/hex: odd length hex string"},
+        {"zd4aa", "", "encoding/hex: invalid byte: U+007A 'z'"},
+        {"d4aaz", "\xd4\xaa", "encoding/hex: invalid byte: U+007A 'z'"},
+        {"30313", "01", "encoding/hex: odd length hex string"},
+        {"0g", "", "encoding/hex: invalid byte: U+0067 'g'"},
+        {"00gg", std::string("\x00", 1), "encoding/hex: invalid byte: U+0067 'g'"},
+        {"0\x01", "", "encoding/hex: invalid byte: U+0001"},
+        {"ffeed", "\xff\xee", "encoding/hex: odd length hex string"},
+        {"\xe9" "0", "", "encoding/hex: invalid byte: U+00E9 '\xc3\xa9'"},
+    };
+    forEachKernel(hex::detail::HexKernel, hex::detail::SetHexKernel, [&] {
+        for (const auto& c : cases) {
+            auto d = hex::DecodeString(c.in);
+            ASSERT_TRUE(d.Failed()) << c.in;
+            EXPECT_EQ(str(d.value), c.out);
+            EXPECT_EQ(d.err->error(), c.err);
+        }
+        std::string digits(300, 'a');
+        digits[201] = 'x';
+        auto d = hex::DecodeString(digits);
+        EXPECT_EQ(d.value.size(), 100u);
+        std::shared_ptr<hex::InvalidByteError> bad;
+        ASSERT_TRUE(gocxx::errors::As(d.err, bad));
+        EXPECT_EQ(bad->Byte(), 'x');
+    });
+    EXPECT_TRUE(gocxx::errors::Is(hex::DecodeString("abc").err, hex::ErrLength));
+}
+
+TEST(HexTest, Streams) {
+    std::mt19937 rng(5);
+    const std::string data = randomBytes(rng, 5000);
+    for (std::size_t chunk : {1, 3, 4096}) {
+        auto buf = std::make_shared<gocxx::bytes::Buffer>();
+        auto w = hex::NewEncoder(buf);
+        for (std::size_t i = 0; i < data.size(); i += chunk) {
+            ASSERT_TRUE(w->Write(reinterpret_cast<const uint8_t*>(data.data()) + i,
+                                 std::min(chunk, data.size() - i)).Ok());
+        }
+        EXPECT_EQ(buf->String(), hex::EncodeToString(data));
+
+        auto r = hex::NewDecoder(std::make_shared<ChunkedReader>(buf->String(), chunk));
+        auto got = readAll(*r, chunk);
+        ASSERT_TRUE(got.Ok());
+        EXPECT_EQ(got.value, data);
+    }
+
+    auto r = hex::NewDecoder(std::make_shared<ChunkedReader>("6869a", 2));
+    auto got = readAll(*r, 8);
+    EXPECT_EQ(got.value, "hi");
+    EXPECT_TRUE(gocxx::errors::Is(got.err, gocxx::io::ErrUnexpectedEOF));
+}
+
+TEST(Base32Test, StandardVectors) {
+    const std::vector<std::pair<std::string, std::string>> pairs = {
+        {"", ""},
+        {"f", "MY======"},
+        {"fo", "MZXQ===="},
+        {"foo", "MZXW6==="},
+        {"foob", "MZXW6YQ="},
+        {"fooba", "MZXW6YTB"},
+        {"foobar", "MZXW6YTBOI======"},
+        {"sure.", "ON2XEZJO"},
+        {"leasure.", "NRSWC43VOJSS4==="},
+    };
+    for (const auto& [plain, encoded] : pairs) {
+        EXPECT_EQ(base32::StdEncoding.EncodeToString(plain), encoded);
+        auto d = base32::StdEncoding.DecodeString(encoded);
+        ASSERT_TRUE(d.Ok()) << encoded;
+        EXPECT_EQ(str(d.value), plain);
+
+        std::string raw = encoded;
+        raw.erase(std::remove(raw.begin(), raw.end(), '='), raw.end());
+        const auto nopad = base32::StdEncoding.WithPadding(base32::NoPadding);
+        EXPECT_EQ(nopad.EncodeToString(plain), raw);
+        EXPECT_EQ(nopad.EncodedLen(plain.size()), raw.size());
+        EXPECT_EQ(str(nopad.DecodeString(raw).value), plain);
+    }
+    EXPECT_EQ(base32::HexEncoding.EncodeToString("foobar"), "CPNMUOJ1E8======");
+    EXPECT_EQ(str(base32::StdEncoding.DecodeString("MZXW\r\n6YTB\nOI======").value), "foobar");
+
+    std::mt19937 rng(32);
+    for (std::size_t n = 0; n < 100; ++n) {
+        const std::string data = randomBytes(rng, n);
+        EXPECT_EQ(str(base32::HexEncoding.DecodeString(base32::HexEncoding.EncodeToString(data)).value), data);
+    }
+}
+
+TEST(Base32Test, CorruptInput) {
+    const std::vector<std::pair<std::string, int64_t>> cases = {
+        {"", -1},          {"!!!!", 0},       {"x===", 0},       {"AA=A====", 2},   {"AAA=AAAA", 3},
+        {"MMMMMMMMM", 8},  {"MMMMMM", 0},     {"A=", 1},         {"AA=", 3},        {"AA==", 4},
+        {"AA===", 5},      {"AAAA=", 5},      {"AAAA==", 6},     {"AAAAA=", 6},     {"AAAAA==", 7},
+        {"A=======", 1},   {"AA======", -1},  {"AAA=====", 3},   {"AAAA====", -1},  {"AAAAA===", -1},
+        {"AAAAAA==", 6},   {"AAAAAAA=", -1},  {"AAAAAAAA", -1},
+    };
+    for (const auto& [input, offset] : cases) {
+        EXPECT_EQ(errorOffset<base32::CorruptInputError>(base32::StdEncoding.DecodeString(input).err), offset)
+            << "\"" << input << "\"";
+    }
+    EXPECT_EQ(base32::StdEncoding.DecodeString("!!!!").err->error(), "illegal base32 data at input byte 0");
+}
+
+TEST(Base32Test, Streams) {
+    std::mt19937 rng(8);
+    const std::string data = randomBytes(rng, 3000);
+    const std::string encoded = base32::StdEncoding.EncodeToString(data);
+    for (std::size_t chunk : {1, 4, 7, 4096}) {
+        auto buf = std::make_shared<gocxx::bytes::Buffer>();
+        auto w = base32::NewEncoder(base32::StdEncoding, buf);
+        for (std::size_t i = 0; i < data.size(); i += chunk) {
+            ASSERT_TRUE(w->Write(reinterpret_cast<const uint8_t*>(data.data()) + i,
+                                 std::min(chunk, data.size() - i)).Ok());
+        }
+        w->close();
+        EXPECT_EQ(buf->String(), encoded);
+
+        auto r = base32::NewDecoder(base32::StdEncoding, std::make_shared<ChunkedReader>(encoded, chunk));
+        auto got = readAll(*r, chunk);
+        ASSERT_TRUE(got.Ok());
+        EXPECT_EQ(got.value, data);
+    }
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include <gocxx/hash/crc32.h>
+#include <string>
+
+using namespace gocxx::hash;
+
+TEST(Crc32Test, KnownVectors) {
+    EXPECT_EQ(crc32::Checksum(""), 0u);
+    EXPECT_EQ(crc32::Checksum("123456789"), 0xCBF43926u);
+    EXPECT_EQ(crc32::Checksum("123456789", crc32::Polynomial::Castagnoli), 0xE3069283u);
+    EXPECT_EQ(crc32::Checksum("The quick brown fox jumps over the lazy dog"), 0x414FA339u);
+}
+
+TEST(Crc32Test, UpdateHashAndCombineAgreeWithOneShot) {
+    std::string data;
+    for (int i = 0; i < 5000; ++i) data.push_back(static_cast<char>(i * 7 + i / 13));
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+
+    for (auto poly : { crc32::Polynomial::IEEE, crc32::Polynomial::Castagnoli }) {
+        const uint32_t whole = crc32::Checksum(bytes, data.size(), poly);
+
+        crc32::Hash h(poly);
+        h.Write(bytes, 1);
+        h.Write(bytes + 1, 2998);
+        h.Write(bytes + 2999, data.size() - 2999);
+        EXPECT_EQ(h.Sum32(), whole);
+
+        for (std::size_t split : { std::size_t(0), std::size_t(1), std::size_t(8), std::size_t(4321), data.size() }) {
+            uint32_t a = crc32::Checksum(bytes, split, poly);
+            uint32_t b = crc32::Checksum(bytes + split, data.size() - split, poly);
+            EXPECT_EQ(crc32::Combine(a, b, data.size() - split, poly), whole) << split;
+        }
+    }
+}
@@ -0,0 +1,435 @@
+#include <gtest/gtest.h>
+#include <gocxx/net/hpack.h>
+#include <gocxx/net/http.h>
+#include <gocxx/net/http2.h>
+#include <gocxx/net/tcp.h>
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/io/io_errors.h>
+#include <gocxx/time/time.h>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+using namespace gocxx::net;
+using namespace gocxx::net::http;
+
+namespace {
+
+std::string unhex(std::string_view hex) {
+    std::string out;
+    for (std::size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back(static_cast<char>(std::stoi(std::string(hex.substr(i, 2)), nullptr, 16)));
+    }
+    return out;
+}
+
+std::shared_ptr<TCPListener> listenLocal(std::string& url) {
+    auto listener = ListenTCP("tcp", "127.0.0.1:0").value;
+    if (listener) {
+        url = "http://" + listener->Address()->String();
+    }
+    return listener;
+}
+
+std::string readBody(gocxx::io::ReadCloser& body) {
+    std::string out;
+    std::uint8_t buf[16384];
+    for (;;) {
+        auto res = body.Read(buf, sizeof(buf));
+        out.append(reinterpret_cast<char*>(buf), res.value);
+        if (res.Failed()) {
+            EXPECT_TRUE(gocxx::errors::Is(res.err, gocxx::io::ErrEOF)) << res.err->error();
+            return out;
+        }
+    }
+}
+
+} // namespace
+
+TEST(HTTP2Test, HpackMatchesRFC7541Examples) {
+    // C.4.1: Huffman coding of a literal
+    std::string huff;
+    hpack::AppendHuffmanString(huff, "www.example.com");
+    EXPECT_EQ(huff, unhex("f1e3c2e5f23a6ba0ab90f4ff"));
+    EXPECT_EQ(hpack::HuffmanEncodeLength("www.example.com"), 12u);
+    EXPECT_EQ(hpack::HuffmanDecode(huff).value, "www.example.com");
+    EXPECT_TRUE(gocxx::errors::Is(hpack::HuffmanDecode(unhex("ff")).err, hpack::ErrInvalidHuffman));
+
+    // C.4: three requests on one connection, the dynamic table carrying over
+    const std::vector<std::vector<std::pair<std::string, std::string>>> requests = {
+        {{":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"}},
+        {{":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"},
+         {"cache-control", "no-cache"}},
+        {{":method", "GET"}, {":scheme", "https"}, {":path", "/index.html"}, {":authority", "www.example.com"},
+         {"custom-key", "custom-value"}},
+    };
+    const std::vector<std::string> wire = {
+        unhex("828684418cf1e3c2e5f23a6ba0ab90f4ff"),
+        unhex("828684be5886a8eb10649cbf"),
+        unhex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"),
+    };
+    const std::uint32_t table_sizes[] = {57, 110, 164};
+    hpack::Encoder enc;
+    hpack::Decoder dec;
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        std::string block;
+        for (const auto& [name, value] : requests[i]) {
+            enc.Encode(block, name, value);
+        }
+        EXPECT_EQ(block, wire[i]) << "request " << i + 1;
+        auto fields = dec.Decode(wire[i]);
+        ASSERT_TRUE(fields.Ok());
+        ASSERT_EQ(fields.value.size(), requests[i].size());
+        for (std::size_t j = 0; j < requests[i].size(); ++j) {
+            EXPECT_EQ(fields.value[j].name, requests[i][j].first);
+            EXPECT_EQ(fields.value[j].value, requests[i][j].second);
+        }
+        EXPECT_EQ(dec.DynamicTableSize(), table_sizes[i]);
+    }
+
+    // Sensitive fields are never indexed; a smaller table is announced first
+    std::string block;
+    enc.SetMaxDynamicTableSize(0);
+    enc.Encode(block, "authorization", "secret", true);
+    EXPECT_EQ(static_cast<std::uint8_t>(block[0]), 0x20);    // dynamic table size update to 0
+    EXPECT_EQ(static_cast<std::uint8_t>(block[1]) & 0xf0, 0x10);  // never indexed
+    auto fields = dec.Decode(block);
+    ASSERT_TRUE(fields.Ok());
+    ASSERT_EQ(fields.value.size(), 1u);
+    EXPECT_TRUE(fields.value[0].sensitive);
+    EXPECT_EQ(dec.DynamicTableSize(), 0u);
+
+    // Truncated input and lists over the limit
+    EXPECT_TRUE(dec.Decode(unhex("418cf1e3")).Failed());
+    hpack::Decoder limited;
+    limited.SetMaxHeaderListSize(40);
+    auto over = limited.Decode(wire[0]);
+    EXPECT_TRUE(gocxx::errors::Is(over.err, hpack::ErrStringLength));
+}
+
+TEST(HTTP2Test, FramerRoundTripsAndValidatesFrames) {
+    auto wire = std::make_shared<gocxx::bytes::Buffer>();
+    http2::Framer writer(*wire, *wire);
+    writer.WriteSettings({{http2::SettingID::MaxFrameSize, 20000}, {http2::SettingID::EnablePush, 0}});
+    const std::string block(40000, 'h');
+    writer.WriteHeaders(1, false, block);  // split into HEADERS + 2 CONTINUATION
+    writer.WriteData(1, true, "body");
+    writer.WritePing(false, {1, 2, 3, 4, 5, 6, 7, 8});
+    writer.WriteWindowUpdate(0, 1000);
+    writer.WriteGoAway(1, http2::ErrCode::EnhanceYourCalm, "bye");
+    EXPECT_GT(writer.Buffered(), block.size());
+    ASSERT_TRUE(writer.Flush().Ok());
+    EXPECT_EQ(writer.Buffered(), 0u);
+
+    http2::Framer reader(*wire, *wire);
+    auto settings = reader.ReadFrame();
+    ASSERT_TRUE(settings.Ok());
+    ASSERT_EQ(settings.value.Settings().size(), 2u);
+    EXPECT_EQ(settings.value.Settings()[0].value, 20000u);
+    auto headers = reader.ReadFrame();
+    ASSERT_TRUE(headers.Ok());
+    EXPECT_EQ(headers.value.header.type, http2::FrameType::Headers);
+    EXPECT_TRUE(headers.value.header.Has(http2::FlagEndHeaders));
+    EXPECT_EQ(headers.value.payload, block);
+    auto data = reader.ReadFrame();
+    ASSERT_TRUE(data.Ok());
+    EXPECT_EQ(data.value.payload, "body");
+    EXPECT_TRUE(data.value.header.Has(http2::FlagEndStream));
+    auto ping = reader.ReadFrame();
+    ASSERT_TRUE(ping.Ok());
+    EXPECT_EQ(ping.value.PingData()[7], 8);
+    EXPECT_EQ(reader.ReadFrame().value.WindowIncrement(), 1000u);
+    auto goaway = reader.ReadFrame();
+    ASSERT_TRUE(goaway.Ok());
+    EXPECT_EQ(goaway.value.Code(), http2::ErrCode::EnhanceYourCalm);
+    EXPECT_EQ(goaway.value.LastStreamID(), 1u);
+    EXPECT_EQ(goaway.value.DebugData(), "bye");
+    EXPECT_TRUE(reader.ReadFrame().Failed());  // drained
+
+    // DATA on stream 0 ends the connection; an oversized frame too
+    writer.WriteData(0, false, "x");
+    writer.Flush();
+    std::shared_ptr<http2::ConnectionError> ce;
+    ASSERT_TRUE(gocxx::errors::As(reader.ReadFrame().err, ce));
+    EXPECT_EQ(ce->Code(), http2::ErrCode::Protocol);
+    writer.WriteData(3, false, std::string(http2::kDefaultMaxFrameSize + 1, 'x'));
+    writer.Flush();
+    ASSERT_TRUE(gocxx::errors::As(reader.ReadFrame().err, ce));
+    EXPECT_EQ(ce->Code(), http2::ErrCode::FrameSize);
+}
+
+TEST(HTTP2Test, H2cServerAndTransportMultiplexStreams) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/slow", [](ResponseWriter& w, const Request& req) {
+        gocxx::time::Sleep(gocxx::time::Milliseconds(100));
+        w.Header()["X-Proto"] = req.proto;
+        w.Write(req.remote_addr);
+    });
+    mux->HandleFunc("/big", [](ResponseWriter& w, const Request&) {
+        for (int i = 0; i < 48; ++i) {
+            w.Write(std::string(64 * 1024, static_cast<char>('a' + i % 26)));
+        }
+    });
+    mux->HandleFunc("POST /echo", [](ResponseWriter& w, const Request& req) {
+        w.Header()["Content-Type"] = "application/octet-stream";
+        w.Write(req.body);
+    });
+    Server server("", mux);
+    server.h2c = true;
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+
+    Client client;
+    client.transport = std::make_shared<Transport>();
+    client.transport->h2c = true;
+
+    // Concurrent requests share one connection and are served in parallel
+    std::mutex mu;
+    std::set<std::string> peers;
+    std::atomic<int> ok{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 8; ++i) {
+        clients.emplace_back([&] {
+            auto resp = client.Get(url + "/slow");
+            if (resp.Ok() && resp.value.status_code == 200 && resp.value.proto == "HTTP/2.0" &&
+                resp.value.Header("x-proto") == "HTTP/2.0") {
+                ++ok;
+                std::lock_guard<std::mutex> lock(mu);
+                peers.insert(resp.value.body);
+            }
+        });
+    }
+    for (auto& c : clients) c.join();
+    EXPECT_EQ(ok.load(), 8);
+    EXPECT_EQ(peers.size(), 1u);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(700));
+
+    // Bodies larger than every flow-control window, both ways
+    auto big = client.Get(url + "/big");
+    ASSERT_TRUE(big.Ok());
+    ASSERT_EQ(big.value.body.size(), 48u * 64 * 1024);
+    EXPECT_EQ(big.value.body[47 * 64 * 1024], 'a' + 47 % 26);
+    const std::string payload(3 << 20, 'p');
+    auto echoed = client.Post(url + "/echo", "application/octet-stream", payload);
+    ASSERT_TRUE(echoed.Ok());
+    EXPECT_EQ(echoed.value.body.size(), payload.size());
+    EXPECT_EQ(echoed.value.Header("content-type"), "application/octet-stream");
+
+    // A body closed halfway resets its stream; the connection carries on
+    Request req;
+    req.method = "GET";
+    req.url = url + "/big";
+    auto partial = client.Do(nullptr, req);
+    ASSERT_TRUE(partial.Ok());
+    std::uint8_t buf[1000];
+    ASSERT_TRUE(partial.value.body_stream->Read(buf, sizeof(buf)).Ok());
+    partial.value.body_stream->close();
+    auto after = client.Get(url + "/slow");
+    ASSERT_TRUE(after.Ok());
+    EXPECT_EQ(after.value.body, *peers.begin());
+
+    // The same server still speaks HTTP/1.1 to everyone else
+    auto h1 = Get(url + "/slow");
+    ASSERT_TRUE(h1.Ok());
+    EXPECT_EQ(h1.value.proto, "HTTP/1.1");
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(HTTP2Test, H2cConnectionLimitsGoAwayAndRetry) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/addr", [](ResponseWriter& w, const Request& req) { w.Write(req.remote_addr); });
+    mux->HandleFunc("/stream", [](ResponseWriter& w, const Request&) {
+        w.Write("first");
+        if (auto* f = dynamic_cast<Flusher*>(&w)) f->Flush();
+        gocxx::time::Sleep(gocxx::time::Milliseconds(200));
+        w.Write("second");
+    });
+    mux->HandleFunc("/slow", [](ResponseWriter& w, const Request&) {
+        gocxx::time::Sleep(gocxx::time::Milliseconds(150));
+        w.Write("late");
+    });
+    Server server("", mux);
+    server.h2c = true;
+    server.max_requests_per_conn = 2;
+    server.h2_max_concurrent_streams = 2;
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+
+    auto transport = std::make_shared<Transport>();
+    transport->h2c = true;
+    Client client;
+    client.transport = transport;
+
+    // After two streams the server says GOAWAY; later requests go to a new connection
+    std::set<std::string> peers;
+    for (int i = 0; i < 6; ++i) {
+        auto resp = client.Get(url + "/addr");
+        ASSERT_TRUE(resp.Ok()) << resp.err->error();
+        peers.insert(resp.value.body);
+    }
+    EXPECT_GE(peers.size(), 3u);
+
+    // A flushed response arrives before the handler returns
+    Request req;
+    req.method = "GET";
+    req.url = url + "/stream";
+    auto start = std::chrono::steady_clock::now();
+    auto streamed = client.Do(nullptr, req);
+    ASSERT_TRUE(streamed.Ok());
+    std::uint8_t buf[64];
+    auto first = streamed.value.body_stream->Read(buf, sizeof(buf));
+    ASSERT_TRUE(first.Ok());
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(buf), first.value), "first");
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(150));
+    EXPECT_EQ(readBody(*streamed.value.body_stream), "second");
+
+    // Timeouts and cancellation end just the stream
+    transport->response_header_timeout = std::chrono::milliseconds(30);
+    auto timed_out = client.Get(url + "/slow");
+    EXPECT_TRUE(gocxx::errors::Is(timed_out.err, ErrTimeout));
+    transport->response_header_timeout = std::chrono::nanoseconds(0);
+    auto cancel = gocxx::context::WithCancel(gocxx::context::Background()).value;
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        cancel.second();
+    });
+    req.url = url + "/slow";
+    auto cancelled = client.Do(cancel.first, req);
+    canceller.join();
+    EXPECT_TRUE(cancelled.Failed());
+    EXPECT_TRUE(client.Get(url + "/addr").Ok());
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(HTTP2Test, H2cServerLimitsRequestBodies) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/upload", [](ResponseWriter& w, const Request& req) { w.Write(std::to_string(req.body.size())); });
+    Server server("", mux);
+    server.h2c = true;
+    server.max_body_bytes = 64 * 1024;
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+
+    auto transport = std::make_shared<Transport>();
+    transport->h2c = true;
+    Client client;
+    client.transport = transport;
+
+    // Answered with 413 as soon as the limit is passed; the connection goes on
+    auto big = client.Post(url + "/upload", "application/octet-stream", std::string(1 << 20, 'x'));
+    ASSERT_TRUE(big.Ok()) << big.err->error();
+    EXPECT_EQ(big.value.status_code, 413);
+    auto fits = client.Post(url + "/upload", "application/octet-stream", std::string(64 * 1024, 'y'));
+    ASSERT_TRUE(fits.Ok()) << fits.err->error();
+    EXPECT_EQ(fits.value.status_code, 200);
+    EXPECT_EQ(fits.value.body, "65536");
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(HTTP2Test, H2cServerResetsStreamsOfThrowingHandlers) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/throw", [](ResponseWriter&, const Request&) { throw std::runtime_error("handler failed"); });
+    mux->HandleFunc("/ok", [](ResponseWriter& w, const Request&) { w.Write("ok"); });
+    Server server("", mux);
+    server.h2c = true;
+    server.max_handlers = 1;
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+
+    auto transport = std::make_shared<Transport>();
+    transport->h2c = true;
+    Client client;
+    client.transport = transport;
+
+    // Each throw resets its stream and gives its handler slot back; the connection goes on
+    for (int i = 0; i < 3; ++i) {
+        auto thrown = client.Get(url + "/throw");
+        ASSERT_TRUE(thrown.Failed());
+        EXPECT_NE(thrown.err->error().find("INTERNAL_ERROR"), std::string::npos) << thrown.err->error();
+    }
+    auto ok = client.Get(url + "/ok");
+    ASSERT_TRUE(ok.Ok()) << ok.err->error();
+    EXPECT_EQ(ok.value.body, "ok");
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(HTTP2Test, H2cServerStopsRapidReset) {
+    std::atomic<int> started{0};
+    std::atomic<int> running{0};
+    std::atomic<int> most{0};
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/slow", [&](ResponseWriter& w, const Request&) {
+        ++started;
+        const int now = ++running;
+        for (int seen = most.load(); now > seen && !most.compare_exchange_weak(seen, now);) {
+        }
+        gocxx::time::Sleep(gocxx::time::Milliseconds(300));
+        --running;
+        w.Write("late");
+    });
+    Server server("", mux);
+    server.h2c = true;
+    server.h2_max_concurrent_streams = 4;
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+
+    // Open a stream and cancel it at once, over and over
+    auto conn = DialTCP("tcp", listener->Address()->String()).value;
+    ASSERT_NE(conn, nullptr);
+    conn->Write(reinterpret_cast<const std::uint8_t*>(http2::ClientPreface.data()), http2::ClientPreface.size());
+    http2::Framer framer(*conn, *conn);
+    framer.WriteSettings({});
+    hpack::Encoder encoder;
+    for (std::uint32_t id = 1; id < 600; id += 2) {
+        std::string block;
+        encoder.Encode(block, ":method", "GET");
+        encoder.Encode(block, ":scheme", "http");
+        encoder.Encode(block, ":path", "/slow");
+        encoder.Encode(block, ":authority", "x");
+        framer.WriteHeaders(id, true, block);
+        framer.WriteRSTStream(id, http2::ErrCode::Cancel);
+    }
+    framer.Flush();
+
+    conn->SetReadDeadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+    bool calm = false;
+    for (;;) {
+        auto frame = framer.ReadFrame();
+        if (frame.Failed()) {
+            break;
+        }
+        if (frame.value.header.type == http2::FrameType::GoAway) {
+            calm = frame.value.Code() == http2::ErrCode::EnhanceYourCalm;
+            break;
+        }
+    }
+    EXPECT_TRUE(calm);
+    EXPECT_LE(most.load(), 4);
+    EXPECT_LE(started.load(), 4);
+    conn->close();
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
@@ -1,12 +1,15 @@
 #include <gtest/gtest.h>
 #include <gocxx/io/io.h>
 #include <gocxx/io/io_errors.h>
+#include <gocxx/io/parallel.h>
+#include <gocxx/hash/crc32.h>
 #include <gocxx/errors/errors.h>
 #include <memory>
 #include <string>
 #include <vector>
 #include <thread>
 #include <cstring>
+#include <chrono>
 
 using namespace gocxx::io;
 using gocxx::base::Result;
@@ -105,6 +108,49 @@ TEST(IOTest, PipeTransfersData) {
     writerThread.join();
 }
 
+TEST(IOTest, PipeAppliesBackpressureAndKeepsOrder) {
+    for (std::size_t bufferSize : {std::size_t(16), std::size_t(0)}) {
+        auto [r, w] = Pipe(bufferSize);
+        std::vector<uint8_t> payload(100000);
+        for (std::size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<uint8_t>(i * 7);
+
+        std::thread writerThread([w = w, &payload] {
+            auto res = w->Write(payload.data(), payload.size());
+            EXPECT_TRUE(res.Ok());
+            EXPECT_EQ(res.value, payload.size());
+            w->Close();
+        });
+
+        std::vector<uint8_t> got;
+        std::vector<uint8_t> buf(777);
+        for (;;) {
+            auto res = r->Read(buf.data(), buf.size());
+            if (!res.Ok()) {
+                EXPECT_TRUE(Is(res.err, ErrEOF));
+                break;
+            }
+            EXPECT_LE(res.value, bufferSize ? bufferSize : buf.size());
+            got.insert(got.end(), buf.begin(), buf.begin() + res.value);
+        }
+        writerThread.join();
+        EXPECT_EQ(got, payload);
+    }
+}
+
+TEST(IOTest, PipeWriteFailsOnceReaderCloses) {
+    auto [r, w] = Pipe(8);
+    std::thread closer([r = r] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        r->Close();
+    });
+    std::vector<uint8_t> data(64, 'x');
+    auto res = w->Write(data.data(), data.size());  // blocks on the full ring until the close
+    closer.join();
+    EXPECT_FALSE(res.Ok());
+    EXPECT_EQ(res.value, 8u);
+    EXPECT_TRUE(Is(res.err, ErrClosedPipe));
+}
+
 TEST(IOTest, LimitedReaderStopsAtLimit) {
     auto baseReader = std::make_shared<StringReader>("HelloWorld");
     LimitedReader limited(baseReader, 5);
@@ -190,3 +236,73 @@ TEST(IOTest, ReadFullFailsOnEOF) {
     EXPECT_LT(res.value, buf.size());
     EXPECT_EQ(std::string(buf.begin(), buf.begin() + res.value), "123");
 }
+
+namespace {
+    // Fixed-size in-memory file; disjoint ranges may be accessed concurrently.
+    class MemoryFile : public ReaderAt, public WriterAt {
+    public:
+        explicit MemoryFile(std::size_t size) : data(size) {}
+
+        Result<std::size_t> ReadAt(uint8_t* buffer, std::size_t size, std::size_t offset) override {
+            if (offset >= data.size()) return { 0, ErrEOF };
+            // Short reads make the callers loop
+            std::size_t n = std::min({ size, data.size() - offset, std::size_t(3000) });
+            std::memcpy(buffer, data.data() + offset, n);
+            return { n, nullptr };
+        }
+
+        Result<std::size_t> WriteAt(const uint8_t* buffer, std::size_t size, std::size_t offset) override {
+            if (offset + size > data.size()) return { 0, ErrShortWrite };
+            std::memcpy(data.data() + offset, buffer, size);
+            return { size, nullptr };
+        }
+
+        std::vector<uint8_t> data;
+    };
+}
+
+TEST(IOTest, ParallelCopyAndCRC32MatchSequential) {
+    const std::size_t size = 1000003;  // not a multiple of the chunk size
+    auto src = std::make_shared<MemoryFile>(size);
+    for (std::size_t i = 0; i < size; ++i) src->data[i] = static_cast<uint8_t>(i * 131 + i / 977);
+    auto dst = std::make_shared<MemoryFile>(size);
+
+    auto progress = gocxx::base::Chan<Progress>::Make(1000);
+    auto copied = ParallelCopy(dst, src, size, 64 * 1024, 4, progress);
+    ASSERT_TRUE(copied.Ok());
+    EXPECT_EQ(copied.value, size);
+    EXPECT_EQ(dst->data, src->data);
+
+    // Running totals, increasing, ending at the full size
+    progress->close();
+    std::size_t last = 0;
+    while (auto p = progress->recv()) {
+        EXPECT_GT(p->done, last);
+        EXPECT_EQ(p->total, size);
+        last = p->done;
+    }
+    EXPECT_EQ(last, size);
+
+    const uint32_t want = gocxx::hash::crc32::Checksum(src->data.data(), size);
+    for (std::size_t workers : { 1, 3, 8 }) {
+        auto crc = ParallelCRC32(src, size, 10000, workers);
+        ASSERT_TRUE(crc.Ok());
+        EXPECT_EQ(crc.value, want) << workers << " workers";
+    }
+}
+
+TEST(IOTest, ParallelCopyFailsOnShortSource) {
+    auto src = std::make_shared<MemoryFile>(100000);
+    auto dst = std::make_shared<MemoryFile>(200000);
+
+    auto res = ParallelCopy(dst, src, 200000, 4096, 4);
+    EXPECT_TRUE(res.Failed());
+    EXPECT_TRUE(Is(res.err, ErrUnexpectedEOF));
+    EXPECT_LE(res.value, 100000u);
+
+    auto fromFn = ParallelRead(src, 100000, 4096, 2, [](std::size_t index, std::size_t, const uint8_t*, std::size_t) {
+        return index == 5 ? Result<void>(gocxx::errors::New("stop")) : Result<void>();
+    });
+    EXPECT_TRUE(fromFn.Failed());
+    EXPECT_EQ(fromFn.err->error(), "stop");
+}
@@ -5,7 +5,14 @@
 
 #include <gtest/gtest.h>
 #include <gocxx/encoding/json.h>
+#include <gocxx/encoding/json_document.h>
+#include <gocxx/encoding/json_struct.h>
 #include <gocxx/io/io.h>
+#include <gocxx/io/io_errors.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
 #include <sstream>
 
 using namespace gocxx::encoding::json;
@@ -23,6 +30,37 @@ protected:
     }
 };
 
+namespace bind {
+
+struct Address {
+    std::string city;
+    std::optional<int> zip;
+};
+GOCXX_JSON_FIELDS(Address, city, zip)
+
+struct User {
+    int64_t id = 0;
+    std::string name;
+    bool admin = false;
+    double score = 0;
+    uint8_t level = 0;
+    std::vector<std::string> tags;
+    std::vector<Address> addresses;
+    std::map<std::string, int> counts;
+    std::unordered_map<std::string, float> weights;
+    JsonValue extra;
+};
+GOCXX_JSON_FIELDS(User, id, name, admin, score, level, tags, addresses, counts, weights, extra)
+
+struct Renamed {
+    int64_t id = 0;
+};
+constexpr auto gocxxJsonFields(const Renamed*) {
+    return std::make_tuple(Field("user_id", &Renamed::id));
+}
+
+} // namespace bind
+
 // Test JsonValue construction and type checking
 TEST_F(JsonTest, JsonValueConstruction) {
     // Test null
@@ -293,6 +331,70 @@ TEST_F(JsonTest, EncoderIndentTest) {
     EXPECT_TRUE(output.find("  ") != std::string::npos); // Should contain indentation
 }
 
+// Records the size of each Write
+class CountingWriter : public gocxx::io::Writer {
+public:
+    std::string data;
+    std::vector<std::size_t> writes;
+
+    gocxx::base::Result<std::size_t> Write(const uint8_t* buffer, std::size_t size) override {
+        data.append(reinterpret_cast<const char*>(buffer), size);
+        writes.push_back(size);
+        return gocxx::base::Result<std::size_t>(size);
+    }
+};
+
+// Test the Encoder's output format: Go's escaping, numbers and indentation
+TEST_F(JsonTest, EncoderFormatsLikeGo) {
+    auto writer = std::make_shared<CountingWriter>();
+    Encoder encoder(writer);
+    JsonValue v = {{"html", "<a href=\"x\">&</a>"}, {"f", {0.1, 2.0, 1e21, 1e-7, -0.0}}, {"n", -3},
+                   {"u", 18446744073709551615ull}, {"s", "tab\there\x01"}};
+    ASSERT_TRUE(encoder.Encode(v).Ok());
+    EXPECT_EQ(writer->data,
+              R"({"f":[0.1,2,1e+21,1e-7,-0],"html":"\u003ca href=\"x\"\u003e\u0026\u003c/a\u003e","n":-3,)"
+              R"("s":"tab\there\u0001","u":18446744073709551615})"
+              "\n");
+    EXPECT_EQ(writer->writes.size(), 1u);
+
+    writer->data.clear();
+    encoder.SetEscapeHTML(false);
+    ASSERT_TRUE(encoder.Encode(JsonValue("<&>")).Ok());
+    EXPECT_EQ(writer->data, "\"<&>\"\n");
+
+    writer->data.clear();
+    encoder.SetIndent("", "\t");
+    ASSERT_TRUE(encoder.Encode(JsonValue{{"a", JsonValue::array()}, {"b", JsonValue::object()}, {"c", {1, "x,:{"}}}).Ok());
+    EXPECT_EQ(writer->data, "{\n\t\"a\": [],\n\t\"b\": {},\n\t\"c\": [\n\t\t1,\n\t\t\"x,:{\"\n\t]\n}\n");
+
+    EXPECT_TRUE(encoder.Encode(JsonValue(std::nan(""))).Failed());
+
+    writer->data.clear();
+    encoder.SetIndent("", "");
+    bind::Address address{"Oslo", std::nullopt};
+    ASSERT_TRUE(encoder.Encode(address).Ok());
+    EXPECT_EQ(writer->data, "{\"city\":\"Oslo\",\"zip\":null}\n");
+}
+
+// Test that a large value goes to the writer in chunks rather than whole
+TEST_F(JsonTest, EncoderFlushesInChunks) {
+    JsonValue big = JsonValue::array();
+    for (int i = 0; i < 20000; ++i) {
+        big.push_back({{"id", i}, {"name", "item " + std::to_string(i)}});
+    }
+    auto writer = std::make_shared<CountingWriter>();
+    Encoder encoder(writer);
+    ASSERT_TRUE(encoder.Encode(big).Ok());
+    EXPECT_GT(writer->writes.size(), 5u);
+    for (std::size_t n : writer->writes) {
+        EXPECT_LE(n, 33u * 1024);
+    }
+    JsonValue back;
+    ASSERT_TRUE(UnmarshalString(writer->data, back).Ok());
+    EXPECT_EQ(back, big);
+    EXPECT_EQ(writer->data, big.dump() + "\n");
+}
+
 // Mock Reader for testing Decoder
 class MockReader : public gocxx::io::Reader {
 private:
@@ -327,6 +429,100 @@ TEST_F(JsonTest, DecoderTest) {
     EXPECT_EQ(GetInt(value["value"]), 42);
 }
 
+// Hands out its data a few bytes per Read, the way a socket might
+class ChunkedReader : public Reader {
+    std::string data_;
+    std::size_t pos_ = 0;
+    std::size_t chunk_;
+
+public:
+    ChunkedReader(std::string data, std::size_t chunk) : data_(std::move(data)), chunk_(chunk) {}
+
+    gocxx::base::Result<std::size_t> Read(uint8_t* buffer, std::size_t size) override {
+        const std::size_t n = std::min({size, chunk_, data_.size() - pos_});
+        std::memcpy(buffer, data_.data() + pos_, n);
+        pos_ += n;
+        return gocxx::base::Result<std::size_t>(n);
+    }
+};
+
+// Test a stream of several values, delivered in pieces that split them anywhere
+TEST_F(JsonTest, DecoderStreamsValues) {
+    const std::string ndjson = "{\"a\":1}\n[1, \"x]\\\"\"]\n\"str\" 42 true null -1.5e3\n{\"b\":{\"c\":[]}}";
+    for (std::size_t chunk : {1, 2, 3, 7, 4096}) {
+        Decoder decoder(std::make_shared<ChunkedReader>(ndjson, chunk));
+        std::vector<JsonValue> values;
+        JsonValue value;
+        while (decoder.Decode(value).Ok()) {
+            values.push_back(value);
+        }
+        ASSERT_EQ(values.size(), 8u) << chunk;
+        EXPECT_EQ(values[0]["a"], 1);
+        EXPECT_EQ(values[1][1], "x]\"");
+        EXPECT_EQ(values[2], "str");
+        EXPECT_EQ(values[3], 42);
+        EXPECT_EQ(values[4], true);
+        EXPECT_TRUE(values[5].is_null());
+        EXPECT_DOUBLE_EQ(values[6].get<double>(), -1500.0);
+        EXPECT_TRUE(values[7]["b"]["c"].is_array());
+        EXPECT_EQ(decoder.Decode(value).err, ErrEOF);
+        EXPECT_EQ(decoder.InputOffset(), ndjson.size());
+    }
+
+    Decoder truncated(std::make_shared<ChunkedReader>("[1, 2", 2));
+    JsonValue value;
+    EXPECT_EQ(truncated.Decode(value).err, ErrUnexpectedEOF);
+
+    Decoder invalid(std::make_shared<ChunkedReader>("{\"a\" 1} {}", 3));
+    EXPECT_TRUE(invalid.Decode(value).Failed());
+    EXPECT_TRUE(invalid.Decode(value).Failed());  // errors are sticky
+}
+
+// Test walking a large array element by element with Token, More and Decode
+TEST_F(JsonTest, DecoderTokens) {
+    std::string big = "{\"items\": [";
+    for (int i = 0; i < 5000; ++i) {
+        big += (i ? "," : "") + std::string("{\"id\":") + std::to_string(i) + ",\"pad\":\"" + std::string(100, 'x') + "\"}";
+    }
+    big += "], \"done\": true}";
+
+    Decoder decoder(std::make_shared<ChunkedReader>(big, 1000));
+    auto tok = decoder.Token();
+    ASSERT_TRUE(tok.Ok());
+    EXPECT_EQ(tok.value.delim, '{');
+    tok = decoder.Token();
+    ASSERT_TRUE(tok.Ok());
+    EXPECT_FALSE(tok.value.IsDelim());
+    EXPECT_EQ(tok.value.value, "items");
+    EXPECT_EQ(decoder.Token().value.delim, '[');
+
+    int count = 0;
+    while (decoder.More()) {
+        JsonValue item;
+        ASSERT_TRUE(decoder.Decode(item).Ok());
+        ASSERT_EQ(item["id"], count);
+        ++count;
+    }
+    EXPECT_EQ(count, 5000);
+    EXPECT_EQ(decoder.Token().value.delim, ']');
+    EXPECT_EQ(decoder.Token().value.value, "done");
+    EXPECT_EQ(decoder.Token().value.value, true);
+    EXPECT_EQ(decoder.Token().value.delim, '}');
+    EXPECT_EQ(decoder.Token().err, ErrEOF);
+
+    // Tokens out of place
+    Decoder bad(std::make_shared<ChunkedReader>("[1 2]", 8));
+    EXPECT_EQ(bad.Token().value.delim, '[');
+    EXPECT_EQ(bad.Token().value.value, 1);
+    EXPECT_TRUE(bad.Token().Failed());
+
+    Decoder key(std::make_shared<ChunkedReader>("{\"k\" \"v\"}", 8));
+    EXPECT_EQ(key.Token().value.delim, '{');
+    EXPECT_EQ(key.Token().value.value, "k");
+    JsonValue value;
+    EXPECT_TRUE(key.Decode(value).Failed());  // the colon is missing
+}
+
 // Test utility functions
 TEST_F(JsonTest, UtilityFunctions) {
     JsonValue null_val = MakeNull();
@@ -424,3 +620,229 @@ TEST_F(JsonTest, BasicPerformance) {
     duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
     EXPECT_LT(duration.count(), 1000); // Should complete in less than 1 second
 }
+
+// Test the on-demand Document: lazy access, views into the input and escapes
+TEST_F(JsonTest, DocumentAccess) {
+    const std::string text = R"({"user": {"id": 42, "name": "Ada", "tags": ["a", "b\u00e9", "c\"d"]},
+        "score": -1.5e2, "big": 18446744073709551615, "ok": true, "none": null, "empty": [], "dup": 1, "dup": 2})";
+    Document doc;
+    ASSERT_TRUE(doc.Parse(text).Ok());
+    Element root = doc.Root();
+    EXPECT_EQ(root.Type(), Kind::Object);
+    EXPECT_EQ(root.Size().value, 8u);
+
+    Element user = root.Get("user").value;
+    EXPECT_EQ(user.Get("id").value.GetInt().value, 42);
+    auto name = user.Get("name").value.GetString();
+    ASSERT_TRUE(name.Ok());
+    EXPECT_EQ(name.value, "Ada");
+    EXPECT_GE(name.value.data(), text.data());  // no copy when there are no escapes
+    EXPECT_LT(name.value.data(), text.data() + text.size());
+
+    Element tags = user.Get("tags").value;
+    std::vector<std::string> got;
+    for (Element e : tags.Elements()) {
+        got.emplace_back(e.GetString().value);
+    }
+    EXPECT_EQ(got, (std::vector<std::string>{"a", "b\xc3\xa9", "c\"d"}));
+    EXPECT_EQ(tags.At(2).value.GetString().value, "c\"d");
+    EXPECT_EQ(tags.At(3).err, ErrOutOfRange);
+    EXPECT_EQ(tags.Raw(), R"(["a", "b\u00e9", "c\"d"])");
+
+    EXPECT_DOUBLE_EQ(root.Get("score").value.GetFloat().value, -150.0);
+    EXPECT_EQ(root.Get("score").value.GetInt().err, ErrIncorrectType);
+    EXPECT_EQ(root.Get("big").value.GetUint().value, 18446744073709551615ull);
+    EXPECT_EQ(root.Get("big").value.GetInt().err, ErrOutOfRange);
+    EXPECT_TRUE(root.Get("ok").value.GetBool().value);
+    EXPECT_TRUE(root.Get("none").value.IsNull());
+    EXPECT_EQ(root.Get("empty").value.Size().value, 0u);
+    EXPECT_EQ(root.Get("dup").value.GetInt().value, 1);
+    EXPECT_EQ(root.Get("missing").err, ErrNoSuchField);
+    EXPECT_EQ(root.Get("ok").value.GetString().err, ErrIncorrectType);
+
+    std::vector<std::string> keys;
+    for (const Member& m : user.Members()) {
+        keys.emplace_back(m.key);
+    }
+    EXPECT_EQ(keys, (std::vector<std::string>{"id", "name", "tags"}));
+
+    JsonValue expected;
+    ASSERT_TRUE(UnmarshalString(text, expected).Ok());
+    EXPECT_EQ(root.Value().value, expected);
+}
+
+// Test that every kernel agrees with nlohmann on random documents, and rejects what it rejects
+TEST_F(JsonTest, DocumentMatchesUnmarshal) {
+    std::mt19937 rng(7);
+    const std::vector<std::string> pieces = {"a", "\\\\", "\\\"", "\\n", "\\u00e9", "\\ud83d\\ude00",
+                                             "\xc3\xa9", "\xe2\x82\xac", "{", "]", ",", ":", " ", "\\/"};
+    std::function<std::string(int)> value = [&](int depth) -> std::string {
+        switch (rng() % (depth > 4 ? 4 : 6)) {
+            case 0: {
+                std::string s = "\"";
+                for (int i = rng() % 40; i > 0; --i) s += pieces[rng() % pieces.size()];
+                return s + "\"";
+            }
+            case 1: return std::to_string(static_cast<int>(rng() % 2000000) - 1000000);
+            case 2: return rng() % 2 ? "-12.5e-3" : "0.25";
+            case 3: return rng() % 3 == 0 ? "null" : rng() % 2 ? "true" : "false";
+            case 4: {
+                std::string s = "[";
+                for (int i = rng() % 6; i > 0; --i) s += value(depth + 1) + (i > 1 ? ", " : "");
+                return s + "]";
+            }
+            default: {
+                std::string s = "{\n";
+                for (int i = rng() % 6; i > 0; --i) {
+                    s += "\"k" + std::to_string(i) + "\":" + value(depth + 1) + (i > 1 ? "," : "");
+                }
+                return s + "}";
+            }
+        }
+    };
+
+    for (const char* kernel : {"avx2", "sse2", "neon", "scalar"}) {
+        if (!gocxx::encoding::json::detail::SetJsonKernel(kernel)) {
+            continue;
+        }
+        std::mt19937 mutate(11);
+        for (int round = 0; round < 300; ++round) {
+            std::string text = value(0);
+            // nlohmann rejects a lone surrogate escape, which Document reads as U+FFFD like Go
+            if (round % 3 == 2 && text.find("\\ud") == std::string::npos) {
+                text[mutate() % text.size()] = "\"\\{}[],:x0 \x01"[mutate() % 12];
+            }
+            JsonValue expected;
+            const bool valid = UnmarshalString(text, expected).Ok();
+            Document doc;
+            auto parsed = doc.Parse(text);
+            ASSERT_EQ(parsed.Ok(), valid) << kernel << ": " << text;
+            if (valid) {
+                EXPECT_EQ(doc.Root().Value().value, expected) << kernel << ": " << text;
+            }
+        }
+    }
+    gocxx::encoding::json::detail::SetJsonKernel("scalar");
+    const std::string name = gocxx::encoding::json::detail::JsonKernel();
+    EXPECT_EQ(name, "scalar");
+    EXPECT_FALSE(gocxx::encoding::json::detail::SetJsonKernel("mmx"));
+    for (const char* kernel : {"avx2", "sse2", "neon"}) {
+        gocxx::encoding::json::detail::SetJsonKernel(kernel);
+    }
+}
+
+// Test that malformed input is rejected with an offset
+TEST_F(JsonTest, DocumentErrors) {
+    for (const char* bad : {"", "  ", "{", "[1,]", "{\"a\" 1}", "{\"a\":1,}", "[1 2]", "tru", "nul",
+                            "01", "1.", "-", "1e", "\"abc", "\"\\x\"", "\"\\u12\"", "\"a\x01\"",
+                            "\"\xff\"", "\"\xc3\"", "[1]]", "{}{}", "[\"a\":1]", "{1:2}", "truex",
+                            // a structural character where a value belongs
+                            "]", "}", ",", ":", "[ } , 2 ]", "{\"a\":]}", "{\"a\":}", "[,1]", "[1,,2]",
+                            "{\"a\":,\"b\":1}", "[:]", "{\"a\"::1}"}) {
+        Document doc;
+        EXPECT_TRUE(doc.Parse(bad).Failed()) << bad;
+        EXPECT_EQ(doc.Root().Type(), Kind::Null);
+    }
+    Document doc;
+    auto result = doc.Parse("[1, 2, @]");
+    ASSERT_TRUE(result.Failed());
+    EXPECT_NE(result.err->error().find("offset 7"), std::string::npos) << result.err->error();
+
+    std::string deep(Document::kMaxDepth + 1, '[');
+    deep += std::string(Document::kMaxDepth + 1, ']');
+    EXPECT_TRUE(doc.Parse(deep).Failed());
+    EXPECT_TRUE(doc.Parse(deep.substr(1, deep.size() - 2)).Ok());
+
+    // A scalar root and one reused Document
+    ASSERT_TRUE(doc.Parse(" 3.5 ").Ok());
+    EXPECT_DOUBLE_EQ(doc.Root().GetFloat().value, 3.5);
+    EXPECT_EQ(doc.Root().Raw(), "3.5");
+
+    // A lone surrogate half reads as U+FFFD, as in Go
+    ASSERT_TRUE(doc.Parse(R"("\ud800x")").Ok());
+    EXPECT_EQ(doc.Root().GetString().value, "\xef\xbf\xbdx");
+}
+
+// Test binding structs with GOCXX_JSON_FIELDS, both ways
+TEST_F(JsonTest, StructBinding) {
+    const std::string text = R"({"ID": 7, "name": "Ada \"L\"", "admin": true, "score": 1e-7, "level": 3,
+        "tags": ["x", "y"], "addresses": [{"city": "Paris", "zip": 75001}, {"city": "Oslo", "zip": null}],
+        "counts": {"b": 2, "a": 1}, "weights": {"w": 0.5}, "extra": {"any": [1, "two"]}, "ignored": {"deep": [1]}})";
+    bind::User u;
+    u.level = 9;
+    ASSERT_TRUE(UnmarshalString(text, u).Ok());
+    EXPECT_EQ(u.id, 7);  // keys match ignoring case, as in Go
+    EXPECT_EQ(u.name, "Ada \"L\"");
+    EXPECT_TRUE(u.admin);
+    EXPECT_DOUBLE_EQ(u.score, 1e-7);
+    EXPECT_EQ(u.level, 3);
+    EXPECT_EQ(u.tags, (std::vector<std::string>{"x", "y"}));
+    ASSERT_EQ(u.addresses.size(), 2u);
+    EXPECT_EQ(u.addresses[0].zip, 75001);
+    EXPECT_FALSE(u.addresses[1].zip.has_value());
+    EXPECT_EQ(u.counts["a"], 1);
+    EXPECT_FLOAT_EQ(u.weights["w"], 0.5f);
+    EXPECT_EQ(u.extra["any"][1], "two");
+
+    auto out = MarshalString(u);
+    ASSERT_TRUE(out.Ok());
+    EXPECT_EQ(out.value,
+              R"({"id":7,"name":"Ada \"L\"","admin":true,"score":1e-7,"level":3,"tags":["x","y"],)"
+              R"("addresses":[{"city":"Paris","zip":75001},{"city":"Oslo","zip":null}],)"
+              R"("counts":{"a":1,"b":2},"weights":{"w":0.5},"extra":{"any":[1,"two"]}})");
+
+    // The output reads back to the same struct, and agrees with the DOM path
+    bind::User again;
+    ASSERT_TRUE(Unmarshal(Marshal(u).value, again).Ok());
+    EXPECT_EQ(MarshalString(again).value, out.value);
+    JsonValue dom;
+    ASSERT_TRUE(UnmarshalString(out.value, dom).Ok());
+    EXPECT_EQ(dom["addresses"][0]["city"], "Paris");
+
+    bind::Renamed r;
+    ASSERT_TRUE(UnmarshalString(R"({"user_id": 12})", r).Ok());
+    EXPECT_EQ(r.id, 12);
+    EXPECT_EQ(MarshalString(r).value, R"({"user_id":12})");
+
+    // Go's number and string formatting
+    bind::Address a{"line\n\x01\xff\xe2\x80\xa8", 1};
+    EXPECT_EQ(MarshalString(a).value, R"({"city":"line\n\u0001\ufffd\u2028","zip":1})");
+    u.score = 1e21;
+    EXPECT_NE(MarshalString(u).value.find(R"("score":1e+21)"), std::string::npos);
+    u.score = 100.0;
+    EXPECT_NE(MarshalString(u).value.find(R"("score":100,)"), std::string::npos);
+    u.score = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_TRUE(MarshalString(u).Failed());
+}
+
+// Test type errors and DisallowUnknownFields
+TEST_F(JsonTest, StructBindingErrors) {
+    bind::User u;
+    auto r = UnmarshalString(R"({"level": 300})", u);
+    ASSERT_TRUE(r.Failed());
+    EXPECT_EQ(r.err->error(), "json: cannot unmarshal number 300 into field level of type uint8");
+    r = UnmarshalString(R"({"addresses": [{"city": 5}]})", u);
+    ASSERT_TRUE(r.Failed());
+    EXPECT_EQ(r.err->error(), "json: cannot unmarshal number 5 into field addresses.city of type string");
+    EXPECT_TRUE(UnmarshalString(R"({"id": 1.5})", u).Failed());
+    EXPECT_TRUE(UnmarshalString(R"({"id": 1)", u).Failed());
+    EXPECT_TRUE(UnmarshalString(R"([])", u).Failed());
+
+    const std::string stream = R"({"city": "A"} {"city": "B", "country": "C"} {"city": 3} {"city": "D"})";
+    Decoder lenient(std::make_shared<ChunkedReader>(stream, 5));
+    bind::Address a;
+    ASSERT_TRUE(lenient.Decode(a).Ok());
+    EXPECT_EQ(a.city, "A");
+    ASSERT_TRUE(lenient.Decode(a).Ok());
+    EXPECT_EQ(a.city, "B");
+
+    Decoder strict(std::make_shared<ChunkedReader>(stream, 5));
+    strict.DisallowUnknownFields();
+    ASSERT_TRUE(strict.Decode(a).Ok());
+    r = strict.Decode(a);
+    ASSERT_TRUE(r.Failed());
+    EXPECT_EQ(r.err->error(), "json: unknown field \"country\"");
+    EXPECT_TRUE(strict.Decode(a).Failed());  // a type error consumes the value
+    ASSERT_TRUE(strict.Decode(a).Ok());
+    EXPECT_EQ(a.city, "D");
+}
@@ -2,10 +2,29 @@
 #include <gocxx/net/net.h>
 #include <gocxx/net/tcp.h>
 #include <gocxx/net/udp.h>
+#include <gocxx/net/resolver.h>
 #include <gocxx/net/http.h>
+#include <gocxx/net/http_metrics.h>
+#include <gocxx/net/http_parser.h>
+#include <gocxx/os/os.h>
+#include <gocxx/os/file.h>
+#include <gocxx/io/io_errors.h>
+#include <algorithm>
+#include <atomic>
+#include <memory_resource>
+#include <stdexcept>
 #include <thread>
 #include <chrono>
 
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
 using namespace gocxx::net;
 using namespace gocxx::net::http;
 
@@ -275,3 +294,1266 @@ TEST(NetTest, ConcurrentConnections) {
     server_thread.join();
     EXPECT_EQ(connections_handled, NUM_CLIENTS);
 }
+
+TEST(NetTest, CopyBetweenFileAndTCPConn) {
+    std::string payload(1 << 20, '\0');
+    for (std::size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<char>(i * 31);
+    const std::string srcName = gocxx::os::TempDir() + "/gocxx_sendfile_src.bin";
+    const std::string dstName = gocxx::os::TempDir() + "/gocxx_sendfile_dst.bin";
+    ASSERT_TRUE(gocxx::os::WriteFile(srcName, payload, 0644).Ok());
+
+    auto listener = ListenTCP("tcp", "127.0.0.1:9097").value;
+    ASSERT_NE(listener, nullptr);
+    std::thread sender([&] {
+        auto conn = listener->Accept().value;
+        auto file = gocxx::os::Open(srcName).value;
+        auto sent = gocxx::io::Copy(conn, file);  // sendfile
+        EXPECT_TRUE(sent.Ok());
+        EXPECT_EQ(sent.value, payload.size());
+        conn->close();
+    });
+
+    auto conn = DialTCP("tcp", "127.0.0.1:9097").value;
+    ASSERT_NE(conn, nullptr);
+    {
+        auto out = gocxx::os::Create(dstName).value;
+        auto received = gocxx::io::Copy(out, conn);  // splice through a pipe
+        EXPECT_TRUE(received.Ok());
+        EXPECT_EQ(received.value, payload.size());
+    }
+    sender.join();
+    listener->Close();
+
+    auto got = gocxx::os::ReadFile(dstName).value;
+    EXPECT_EQ(got.size(), payload.size());
+    EXPECT_TRUE(std::equal(got.begin(), got.end(), payload.begin(), payload.end(),
+                           [](uint8_t a, char b) { return a == static_cast<uint8_t>(b); }));
+    gocxx::os::Remove(srcName);
+    gocxx::os::Remove(dstName);
+}
+
+TEST(NetTest, TCPConnWriteBuffersSendsInOneCall) {
+    auto listener = ListenTCP("tcp", "127.0.0.1:9098").value;
+    ASSERT_NE(listener, nullptr);
+    const std::string header = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\n";
+    std::thread server([&] {
+        auto conn = std::dynamic_pointer_cast<TCPConn>(listener->Accept().value);
+        ASSERT_NE(conn, nullptr);
+        auto sent = gocxx::io::WriteBuffers(conn, { header, std::string_view("hello") });
+        EXPECT_TRUE(sent.Ok());
+        EXPECT_EQ(sent.value, header.size() + 5);
+        conn->close();
+    });
+
+    auto conn = DialTCP("tcp", "127.0.0.1:9098").value;
+    ASSERT_NE(conn, nullptr);
+    std::string got;
+    std::vector<uint8_t> a(16), b(64);
+    for (;;) {
+        auto res = conn->ReadBuffers({ a, b });
+        if (res.Failed() || res.value == 0) break;
+        const std::size_t fromA = std::min(res.value, a.size());
+        got.append(a.begin(), a.begin() + fromA);
+        got.append(b.begin(), b.begin() + (res.value - fromA));
+    }
+    server.join();
+    listener->Close();
+    EXPECT_EQ(got, header + "hello");
+}
+
+TEST(NetTest, TCPReadDeadlineTimesOutAndCanBeCleared) {
+    auto listener = ListenTCP("tcp", "127.0.0.1:9099").value;
+    ASSERT_NE(listener, nullptr);
+    std::shared_ptr<Conn> peer;
+    std::thread server([&] { peer = listener->Accept().value; });
+    auto conn = DialTCP("tcp", "127.0.0.1:9099").value;
+    ASSERT_NE(conn, nullptr);
+    server.join();
+    ASSERT_NE(peer, nullptr);
+
+    uint8_t buf[16];
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(conn->SetReadDeadline(std::chrono::system_clock::now() + std::chrono::milliseconds(50)).Ok());
+    auto res = conn->Read(buf, sizeof(buf));
+    EXPECT_TRUE(gocxx::errors::Is(res.err, ErrTimeout));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(40));
+
+    // Still expired until the deadline is moved; clearing it lets the read wait again
+    EXPECT_TRUE(gocxx::errors::Is(conn->Read(buf, sizeof(buf)).err, ErrTimeout));
+    conn->SetReadDeadline(std::chrono::system_clock::time_point{});
+    std::thread writer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        peer->Write(reinterpret_cast<const uint8_t*>("x"), 1);
+    });
+    res = conn->Read(buf, sizeof(buf));
+    writer.join();
+    EXPECT_TRUE(res.Ok());
+    EXPECT_EQ(res.value, 1u);
+
+    peer->close();
+    listener->Close();
+}
+
+TEST(NetTest, CloseUnblocksAcceptAndRead) {
+    auto listener = ListenTCP("tcp", "127.0.0.1:9100").value;
+    ASSERT_NE(listener, nullptr);
+    std::shared_ptr<Conn> peer;
+    std::thread server([&] { peer = listener->Accept().value; });
+    auto conn = DialTCP("tcp", "127.0.0.1:9100").value;
+    ASSERT_NE(conn, nullptr);
+    server.join();
+
+    // Write blocks once the socket buffers fill, then completes as the peer drains it
+    std::string payload(8 << 20, 'p');
+    std::thread reader([&] {
+        std::vector<uint8_t> buf(64 << 10);
+        std::size_t total = 0;
+        while (total < payload.size()) {
+            auto got = peer->Read(buf.data(), buf.size());
+            if (got.Failed()) break;
+            total += got.value;
+        }
+        EXPECT_EQ(total, payload.size());
+    });
+    auto sent = conn->Write(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+    reader.join();
+    EXPECT_TRUE(sent.Ok());
+    EXPECT_EQ(sent.value, payload.size());
+
+    std::shared_ptr<gocxx::errors::Error> readErr, acceptErr;
+    std::thread blockedRead([&] {
+        uint8_t buf[16];
+        readErr = conn->Read(buf, sizeof(buf)).err;
+    });
+    std::thread blockedAccept([&] { acceptErr = listener->Accept().err; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    conn->close();
+    listener->Close();
+    blockedRead.join();
+    blockedAccept.join();
+    EXPECT_TRUE(gocxx::errors::Is(readErr, ErrClosed));
+    EXPECT_TRUE(gocxx::errors::Is(acceptErr, ErrClosed));
+    peer->close();
+}
+
+TEST(NetTest, UDPReadDeadline) {
+    auto conn = ListenUDPSimple("127.0.0.1:9101").value;
+    ASSERT_NE(conn, nullptr);
+    conn->SetReadDeadline(std::chrono::system_clock::now() + std::chrono::milliseconds(30));
+    uint8_t buf[16];
+    std::shared_ptr<Addr> from;
+    EXPECT_TRUE(gocxx::errors::Is(conn->ReadFrom(buf, sizeof(buf), from).err, ErrTimeout));
+    conn->close();
+}
+
+namespace {
+
+std::shared_ptr<TCPListener> listenLocal(std::string& url) {
+    auto listener = ListenTCP("tcp", "127.0.0.1:0").value;
+    if (listener) {
+        url = "http://" + listener->Address()->String();
+    }
+    return listener;
+}
+
+} // namespace
+
+TEST(NetTest, HTTPServerBoundsConcurrentHandlers) {
+    auto mux = std::make_shared<ServeMux>();
+    std::atomic<int> running{0}, peak{0};
+    mux->HandleFunc("/slow", [&](ResponseWriter& w, const Request&) {
+        int now = ++running;
+        for (int seen = peak.load(); now > seen && !peak.compare_exchange_weak(seen, now);) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        --running;
+        w.Write("done");
+    });
+    Server server("", mux);
+    server.max_conns = 4;
+    server.max_handlers = 2;
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    gocxx::base::Result<void> served;
+    std::thread serving([&] { served = server.Serve(listener); });
+
+    std::vector<std::thread> clients;
+    std::atomic<int> ok{0};
+    for (int i = 0; i < 8; ++i) {
+        clients.emplace_back([&] {
+            auto resp = gocxx::net::http::Get(url + "/slow");
+            if (resp.Ok() && resp.value.status_code == 200 && resp.value.body == "done") ++ok;
+        });
+    }
+    for (auto& c : clients) c.join();
+    EXPECT_EQ(ok.load(), 8);
+    EXPECT_LE(peak.load(), 2);
+
+    EXPECT_TRUE(server.Shutdown(nullptr).Ok());
+    serving.join();
+    EXPECT_TRUE(gocxx::errors::Is(served.err, ErrServerClosed));
+}
+
+TEST(NetTest, HTTPServerShutdownDrainsInFlightRequests) {
+    auto mux = std::make_shared<ServeMux>();
+    std::atomic<bool> entered{false}, release{false};
+    mux->HandleFunc("/wait", [&](ResponseWriter& w, const Request&) {
+        entered = true;
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        w.Write("drained");
+    });
+    Server server("", mux);
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+
+    gocxx::base::Result<Response> resp;
+    std::thread client([&] { resp = gocxx::net::http::Get(url + "/wait"); });
+    while (!entered) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // An idle connection is closed at once rather than waited for
+    auto idle = DialTCP("tcp", listener->Address()->String()).value;
+    ASSERT_NE(idle, nullptr);
+
+    // A deadline that passes while the handler is still running
+    auto timeout = gocxx::context::WithTimeout(gocxx::context::Background(), gocxx::time::Milliseconds(20)).value;
+    EXPECT_TRUE(server.Shutdown(timeout.first).Failed());
+    timeout.second();
+
+    std::atomic<bool> shut{false};
+    std::thread shutdown([&] {
+        EXPECT_TRUE(server.Shutdown(nullptr).Ok());
+        shut = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(shut.load());
+    release = true;
+    client.join();
+    shutdown.join();
+    serving.join();
+    ASSERT_TRUE(resp.Ok());
+    EXPECT_EQ(resp.value.body, "drained");
+
+    uint8_t buf[8];
+    EXPECT_TRUE(idle->Read(buf, sizeof(buf)).Failed());
+}
+
+namespace {
+
+// Sends raw bytes and collects everything the server returns until it closes
+std::string rawExchange(const std::string& address, const std::string& raw) {
+    auto conn = DialTCP("tcp", address).value;
+    if (!conn) return "";
+    conn->Write(reinterpret_cast<const uint8_t*>(raw.data()), raw.size());
+    std::string out;
+    uint8_t buf[4096];
+    for (;;) {
+        auto res = conn->Read(buf, sizeof(buf));
+        if (res.Failed() || res.value == 0) break;
+        out.append(reinterpret_cast<char*>(buf), res.value);
+    }
+    conn->close();
+    return out;
+}
+
+std::size_t count(const std::string& haystack, const std::string& needle) {
+    std::size_t n = 0;
+    for (auto pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+} // namespace
+
+TEST(NetTest, HTTPServerKeepAliveAndPipelining) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/echo", [](ResponseWriter& w, const Request& req) { w.Write("[" + req.body + "]"); });
+    mux->HandleFunc("/big", [](ResponseWriter& w, const Request&) {
+        for (int i = 0; i < 3; ++i) w.Write(std::string(3000, 'a' + i));
+    });
+    Server server("", mux);
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+    const std::string address = listener->Address()->String();
+
+    // Three requests in one write: Content-Length body, chunked body, then close
+    std::string out = rawExchange(address,
+        "POST /echo HTTP/1.1\r\nHost: x\r\nContent-Length: 5\r\n\r\nhello"
+        "POST /echo HTTP/1.1\r\nHost: x\r\nTransfer-Encoding: chunked\r\n\r\n3;ext=1\r\nabc\r\n2\r\nde\r\n0\r\nX-Trailer: y\r\n\r\n"
+        "GET /echo HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n");
+    EXPECT_EQ(count(out, "HTTP/1.1 200 OK"), 3u);
+    auto first = out.find("[hello]"), second = out.find("[abcde]"), third = out.find("[]");
+    EXPECT_NE(first, std::string::npos);
+    EXPECT_NE(second, std::string::npos);
+    EXPECT_NE(third, std::string::npos);
+    EXPECT_LT(first, second);
+    EXPECT_LT(second, third);
+    EXPECT_EQ(count(out, "content-length: 7"), 2u);
+    EXPECT_EQ(count(out, "connection: close"), 1u);
+
+    // A body too long to buffer goes out chunked on a kept-alive connection
+    out = rawExchange(address, "GET /big HTTP/1.1\r\n\r\nGET /echo HTTP/1.0\r\n\r\n");
+    EXPECT_NE(out.find("transfer-encoding: chunked"), std::string::npos);
+    EXPECT_NE(out.find("\r\n0\r\n\r\nHTTP/1.1 200 OK"), std::string::npos);
+    EXPECT_EQ(count(out, std::string(3000, 'c')), 1u);
+
+    // Malformed requests get a 400 and the connection is closed
+    out = rawExchange(address, "POST /echo HTTP/1.1\r\nContent-Length: abc\r\n\r\n");
+    EXPECT_EQ(out.rfind("HTTP/1.1 400 Bad Request", 0), 0u);
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(NetTest, HTTPServerLimitsRequestBodies) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/echo", [](ResponseWriter& w, const Request& req) { w.Write("[" + req.body + "]"); });
+    Server server("", mux);
+    server.max_body_bytes = 1024;
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+    const std::string address = listener->Address()->String();
+
+    // A claimed length is checked before anything is allocated for it
+    std::string out = rawExchange(address, "POST /echo HTTP/1.1\r\nContent-Length: 99999999999999999\r\n\r\nabc");
+    EXPECT_EQ(out.rfind("HTTP/1.1 413 Content Too Large", 0), 0u);
+    out = rawExchange(address, "POST /echo HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nfffffffffffffff\r\nabc");
+    EXPECT_EQ(out.rfind("HTTP/1.1 413 Content Too Large", 0), 0u);
+
+    // So is the total of a chunked body, and the connection goes
+    std::string chunks;
+    for (int i = 0; i < 3; ++i) chunks += "200\r\n" + std::string(512, 'x') + "\r\n";
+    out = rawExchange(address, "POST /echo HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n" + chunks + "0\r\n\r\n"
+                               "GET /echo HTTP/1.1\r\nConnection: close\r\n\r\n");
+    EXPECT_EQ(out.rfind("HTTP/1.1 413 Content Too Large", 0), 0u);
+    EXPECT_EQ(count(out, "HTTP/1.1"), 1u);
+
+    // Up to the limit is fine
+    out = rawExchange(address, "POST /echo HTTP/1.1\r\nConnection: close\r\nContent-Length: 1024\r\n\r\n" +
+                               std::string(1024, 'y'));
+    EXPECT_EQ(out.rfind("HTTP/1.1 200 OK", 0), 0u);
+    EXPECT_NE(out.find("[" + std::string(1024, 'y') + "]"), std::string::npos);
+
+    // Transfer-Encoding and Content-Length together: answered, then closed
+    out = rawExchange(address,
+        "POST /echo HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 4\r\n\r\n3\r\nabc\r\n0\r\n\r\n"
+        "GET /echo HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(count(out, "HTTP/1.1 200 OK"), 1u);
+    EXPECT_NE(out.find("[abc]"), std::string::npos);
+    EXPECT_NE(out.find("connection: close"), std::string::npos);
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(NetTest, HTTPServerSurvivesThrowingHandlers) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/throw", [](ResponseWriter&, const Request&) { throw std::runtime_error("handler failed"); });
+    mux->HandleFunc("/ok", [](ResponseWriter& w, const Request&) { w.Write("ok"); });
+    Server server("", mux);
+    server.max_handlers = 1;
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+    const std::string address = listener->Address()->String();
+
+    // Each throw drops its connection and gives its handler slot back
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(rawExchange(address, "GET /throw HTTP/1.1\r\n\r\n"), "");
+    }
+    std::string out = rawExchange(address, "GET /ok HTTP/1.1\r\nConnection: close\r\n\r\n");
+    EXPECT_EQ(out.rfind("HTTP/1.1 200 OK", 0), 0u);
+
+    // Shutdown does not wait for the dropped connections
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(NetTest, HTTPServerAllocatesRequestsFromAConnectionArena) {
+    auto mux = std::make_shared<ServeMux>();
+    std::vector<std::pmr::memory_resource*> arenas;
+    mux->HandleFunc("/", [&](ResponseWriter& w, const Request& req) {
+        arenas.push_back(req.Arena());
+        EXPECT_EQ(req.header.get_allocator().resource(), req.Arena());
+        EXPECT_EQ(w.Header().get_allocator().resource(), req.Arena());
+        std::pmr::string reply(req.Arena());
+        reply.append("scratch:").append(req.Header("x-n"));
+        w.Write(std::string(reply));
+    });
+    Server server("", mux);
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+
+    std::string out = rawExchange(listener->Address()->String(),
+        "GET / HTTP/1.1\r\nX-N: 1\r\n\r\n"
+        "GET / HTTP/1.1\r\nX-N: 2\r\nConnection: close\r\n\r\n");
+    EXPECT_NE(out.find("scratch:1"), std::string::npos);
+    EXPECT_NE(out.find("scratch:2"), std::string::npos);
+    ASSERT_EQ(arenas.size(), 2u);
+    EXPECT_NE(arenas[0], std::pmr::get_default_resource());
+    EXPECT_EQ(arenas[0], arenas[1]);  // one arena per connection, reused
+
+    // Outside a server the arena is the default resource, and copies leave it
+    Request req;
+    EXPECT_EQ(req.Arena(), std::pmr::get_default_resource());
+    std::pmr::monotonic_buffer_resource scratch;
+    Request pooled(&scratch);
+    pooled.header["k"] = "v";
+    Request copy = pooled;
+    EXPECT_EQ(copy.header.get_allocator().resource(), std::pmr::get_default_resource());
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(NetTest, HTTPServerConnectionLimits) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/", [](ResponseWriter& w, const Request&) { w.Write("ok"); });
+    Server server("", mux);
+    server.max_requests_per_conn = 2;
+    server.idle_timeout = std::chrono::milliseconds(50);
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+    const std::string address = listener->Address()->String();
+
+    std::string out = rawExchange(address, "GET / HTTP/1.1\r\n\r\nGET / HTTP/1.1\r\n\r\nGET / HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(count(out, "HTTP/1.1 200 OK"), 2u);
+    EXPECT_EQ(count(out, "connection: close"), 1u);
+
+    // An idle kept-alive connection is closed after idle_timeout
+    auto start = std::chrono::steady_clock::now();
+    out = rawExchange(address, "GET / HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(count(out, "HTTP/1.1 200 OK"), 1u);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(40));
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(NetTest, HTTPClientReusesPooledConnections) {
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/addr", [](ResponseWriter& w, const Request& req) { w.Write(req.remote_addr); });
+    mux->HandleFunc("/stream", [](ResponseWriter& w, const Request&) {
+        for (int i = 0; i < 4; ++i) w.Write(std::string(3000, 'a' + i));
+    });
+    mux->HandleFunc("/slow", [](ResponseWriter& w, const Request&) {
+        gocxx::time::Sleep(gocxx::time::Milliseconds(200));
+        w.Write("late");
+    });
+    Server server("", mux);
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+
+    Client client;
+    client.transport = std::make_shared<Transport>();
+
+    // Sequential requests share one kept-alive connection
+    auto first = client.Get(url + "/addr");
+    ASSERT_TRUE(first.Ok());
+    EXPECT_EQ(first.value.status_code, 200);
+    for (int i = 0; i < 3; ++i) {
+        auto again = client.Post(url + "/addr", "text/plain", "x");
+        ASSERT_TRUE(again.Ok());
+        EXPECT_EQ(again.value.body, first.value.body);
+    }
+
+    // A chunked body streams through body_stream, then the connection goes back to the pool
+    Request req;
+    req.method = "GET";
+    req.url = url + "/stream";
+    auto streamed = client.Do(nullptr, req);
+    ASSERT_TRUE(streamed.Ok());
+    ASSERT_NE(streamed.value.body_stream, nullptr);
+    EXPECT_TRUE(streamed.value.body.empty());
+    std::string body;
+    uint8_t buf[1000];
+    for (;;) {
+        auto res = streamed.value.body_stream->Read(buf, sizeof(buf));
+        body.append(reinterpret_cast<char*>(buf), res.value);
+        if (res.Failed()) {
+            EXPECT_TRUE(gocxx::errors::Is(res.err, gocxx::io::ErrEOF));
+            break;
+        }
+    }
+    EXPECT_EQ(body.size(), 12000u);
+    EXPECT_EQ(body.substr(9000), std::string(3000, 'd'));
+    auto after = client.Get(url + "/addr");
+    ASSERT_TRUE(after.Ok());
+    EXPECT_EQ(after.value.body, first.value.body);
+
+    // A stale pooled connection is replaced transparently
+    client.transport->CloseIdleConnections();
+    auto fresh = client.Get(url + "/addr");
+    ASSERT_TRUE(fresh.Ok());
+    EXPECT_NE(fresh.value.body, first.value.body);
+
+    // response_header_timeout and a cancelled context both abort a slow exchange
+    client.transport->response_header_timeout = std::chrono::milliseconds(30);
+    auto timed_out = client.Get(url + "/slow");
+    EXPECT_TRUE(timed_out.Failed());
+    EXPECT_TRUE(gocxx::errors::Is(timed_out.err, ErrTimeout));
+
+    client.transport->response_header_timeout = std::chrono::nanoseconds(0);
+    auto cancel = gocxx::context::WithCancel(gocxx::context::Background()).value;
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        cancel.second();
+    });
+    req.url = url + "/slow";
+    auto start = std::chrono::steady_clock::now();
+    auto cancelled = client.Do(cancel.first, req);
+    canceller.join();
+    EXPECT_TRUE(cancelled.Failed());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(180));
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(NetTest, HTTPRequestParserIncremental) {
+    const std::string raw =
+        "\r\nPOST /items?id=7 HTTP/1.1\r\nHost: example.com\r\nX-Empty:\r\n"
+        "Content-Type:  text/plain \t\r\nCONTENT-LENGTH: 5\nAccept: a, b\r\n\r\nhello";
+
+    // Fed one byte at a time, into a buffer that moves as it grows
+    RequestParser parser;
+    RequestParser::Status status = RequestParser::Status::Incomplete;
+    std::string buf;
+    std::size_t fed = 0;
+    while (status == RequestParser::Status::Incomplete && fed < raw.size()) {
+        buf.push_back(raw[fed++]);
+        buf.shrink_to_fit();
+        status = parser.Parse(buf);
+    }
+    ASSERT_EQ(status, RequestParser::Status::Complete);
+    EXPECT_EQ(parser.Consumed(), raw.size() - 5);
+    EXPECT_EQ(fed, raw.size() - 5);
+    EXPECT_EQ(parser.Method(), "POST");
+    EXPECT_EQ(parser.Target(), "/items?id=7");
+    EXPECT_EQ(parser.MinorVersion(), 1);
+    ASSERT_EQ(parser.NumHeaders(), 5u);
+    EXPECT_EQ(parser.Field(0).name, "Host");
+    EXPECT_EQ(parser.Field(1).value, "");
+    EXPECT_EQ(parser.Header("content-type"), "text/plain");
+    EXPECT_EQ(parser.Header("Content-Length"), "5");
+    EXPECT_TRUE(parser.HasHeader("x-empty"));
+    EXPECT_FALSE(parser.HasHeader("x-missing"));
+    // Views point into the caller's buffer
+    EXPECT_GE(parser.Method().data(), buf.data());
+    EXPECT_LT(parser.Method().data(), buf.data() + buf.size());
+
+    auto parse = [](const std::string& head) {
+        RequestParser p;
+        return p.Parse(head);
+    };
+    EXPECT_EQ(parse("GET / HTTP/1.0\r\n\r\n"), RequestParser::Status::Complete);
+    EXPECT_EQ(parse("GET / HTTP/1.1\r\nHost: x\r"), RequestParser::Status::Incomplete);
+    EXPECT_EQ(parse("GET /\r\n\r\n"), RequestParser::Status::Malformed);
+    EXPECT_EQ(parse("GET / HTTP/2.0\r\n\r\n"), RequestParser::Status::Malformed);
+    EXPECT_EQ(parse("G(T / HTTP/1.1\r\n\r\n"), RequestParser::Status::Malformed);
+    EXPECT_EQ(parse("GET / HTTP/1.1\r\nHost : x\r\n\r\n"), RequestParser::Status::Malformed);
+    EXPECT_EQ(parse("GET / HTTP/1.1\r\nA: b\r\n c\r\n\r\n"), RequestParser::Status::Malformed);
+    EXPECT_EQ(parse("GET / HTTP/1.1\r\nA: b\rc\r\n\r\n"), RequestParser::Status::Malformed);
+    // A control character is rejected before the line is complete
+    EXPECT_EQ(parse("GET / HTTP/1.1\r\nA: b\x01"), RequestParser::Status::Malformed);
+    EXPECT_EQ(parse("GET / HTTP/1.1\r\nA: " + std::string(40, 'b') + "\x7f"), RequestParser::Status::Malformed);
+
+    std::string many = "GET / HTTP/1.1\r\n";
+    for (std::size_t i = 0; i <= RequestParser::kMaxHeaders; ++i) many += "X-" + std::to_string(i) + ": v\r\n";
+    EXPECT_EQ(parse(many + "\r\n"), RequestParser::Status::TooManyHeaders);
+
+    // A head longer than the server's read buffer, followed by a pipelined request
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/", [](ResponseWriter& w, const Request& req) {
+        w.Write(std::to_string(req.Header("x-big").size()) + "|" + req.body);
+    });
+    Server server("", mux);
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+    std::string out = rawExchange(listener->Address()->String(),
+        "POST / HTTP/1.1\r\nX-Big: " + std::string(10000, 'z') + "\r\nContent-Length: 2\r\n\r\nok"
+        "GET / HTTP/1.1\r\nConnection: close\r\n\r\n");
+    EXPECT_NE(out.find("10000|ok"), std::string::npos);
+    EXPECT_NE(out.find("\r\n\r\n0|"), std::string::npos);
+    EXPECT_EQ(count(out, "HTTP/1.1 200 OK"), 2u);
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+namespace {
+
+// Captures what a handler writes, for driving ServeMux without a connection
+class RecordingWriter : public ResponseWriter {
+public:
+    HeaderMap& Header() override { return header; }
+    gocxx::base::Result<std::size_t> Write(const std::string& data) override {
+        body += data;
+        return {data.size(), nullptr};
+    }
+    void WriteHeader(int statusCode) override { status = statusCode; }
+
+    HeaderMap header;
+    std::string body;
+    int status = StatusOK;
+};
+
+RecordingWriter route(ServeMux& mux, const std::string& method, const std::string& url) {
+    Request req;
+    req.method = method;
+    req.url = url;
+    req.proto = "HTTP/1.1";
+    RecordingWriter w;
+    mux.ServeHTTP(w, req);
+    return w;
+}
+
+} // namespace
+
+TEST(NetTest, ServeMuxRadixRouting) {
+    ServeMux mux;
+    auto reply = [](const std::string& tag, std::vector<std::string> names) {
+        return [tag, names](ResponseWriter& w, const Request& req) {
+            std::string out = tag;
+            for (const auto& name : names) out += " " + name + "=" + std::string(req.PathValue(name));
+            w.Write(out);
+        };
+    };
+    mux.HandleFunc("GET /users/{id}", reply("get", {"id"}));
+    mux.HandleFunc("POST /users/{id}", reply("post", {"id"}));
+    mux.HandleFunc("/users/new", reply("new", {}));
+    mux.HandleFunc("/users/{id}/posts/{post}", reply("posts", {"id", "post"}));
+    mux.HandleFunc("/static/", reply("static", {}));
+    mux.HandleFunc("GET /files/{path...}", reply("files", {"path"}));
+    mux.HandleFunc("/{$}", reply("root", {}));
+
+    EXPECT_EQ(route(mux, "GET", "/users/42").body, "get id=42");
+    EXPECT_EQ(route(mux, "HEAD", "/users/42").body, "get id=42");
+    EXPECT_EQ(route(mux, "POST", "/users/42?x=1").body, "post id=42");
+    EXPECT_EQ(route(mux, "GET", "/users/new").body, "new");
+    EXPECT_EQ(route(mux, "GET", "/users/newer").body, "get id=newer");
+    EXPECT_EQ(route(mux, "PUT", "/users/7/posts/9").body, "posts id=7 post=9");
+    EXPECT_EQ(route(mux, "GET", "/static/css/site.css").body, "static");
+    EXPECT_EQ(route(mux, "GET", "/static/").body, "static");
+    EXPECT_EQ(route(mux, "GET", "/files/a/b/c.txt").body, "files path=a/b/c.txt");
+    EXPECT_EQ(route(mux, "GET", "/files/").body, "files path=");
+    EXPECT_EQ(route(mux, "GET", "http://example.com/users/5").body, "get id=5");
+    EXPECT_EQ(route(mux, "GET", "/").body, "root");
+
+    EXPECT_EQ(route(mux, "GET", "/static").status, StatusNotFound);
+    EXPECT_EQ(route(mux, "GET", "/users/").status, StatusNotFound);
+    EXPECT_EQ(route(mux, "GET", "/nothing").status, StatusNotFound);
+    auto not_allowed = route(mux, "DELETE", "/users/42");
+    EXPECT_EQ(not_allowed.status, StatusMethodNotAllowed);
+    EXPECT_EQ(not_allowed.header["Allow"], "GET, POST, HEAD");
+    EXPECT_EQ(route(mux, "POST", "/files/x").status, StatusMethodNotAllowed);
+
+    // Malformed and conflicting patterns are rejected
+    EXPECT_THROW(mux.HandleFunc("GET /users/{uid}", reply("", {})), std::invalid_argument);
+    EXPECT_THROW(mux.HandleFunc("/static/", reply("", {})), std::invalid_argument);
+    EXPECT_THROW(mux.HandleFunc("users", reply("", {})), std::invalid_argument);
+    EXPECT_THROW(mux.HandleFunc("/a/{b", reply("", {})), std::invalid_argument);
+    EXPECT_THROW(mux.HandleFunc("/a{b}", reply("", {})), std::invalid_argument);
+    EXPECT_THROW(mux.HandleFunc("/{x...}/y", reply("", {})), std::invalid_argument);
+    EXPECT_THROW(mux.HandleFunc("/{x}/{x}", reply("", {})), std::invalid_argument);
+    EXPECT_NO_THROW(mux.HandleFunc("DELETE /users/{uid}", reply("delete", {"uid"})));
+    EXPECT_EQ(route(mux, "DELETE", "/users/42").body, "delete uid=42");
+
+    // Many routes sharing prefixes, plus the "/" catch-all
+    ServeMux big;
+    big.HandleFunc("/", reply("fallback", {}));
+    for (int i = 0; i < 400; ++i) {
+        const std::string n = std::to_string(i);
+        big.HandleFunc("GET /api/v1/service" + n + "/items/{id}", reply("svc" + n, {"id"}));
+    }
+    EXPECT_EQ(route(big, "GET", "/api/v1/service0/items/1").body, "svc0 id=1");
+    EXPECT_EQ(route(big, "GET", "/api/v1/service137/items/abc").body, "svc137 id=abc");
+    EXPECT_EQ(route(big, "GET", "/api/v1/service399/items/z").body, "svc399 id=z");
+    EXPECT_EQ(route(big, "GET", "/api/v1/service400/items/z").body, "fallback");
+    EXPECT_EQ(route(big, "GET", "/api/v1/service13/items").body, "fallback");
+}
+
+TEST(NetTest, HTTPResponseWriterCoalescesAndFlushes) {
+    gocxx::base::Chan<bool> release(1);
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/small-writes", [](ResponseWriter& w, const Request&) {
+        for (int i = 0; i < 10000; ++i) w.Write("x");
+    });
+    mux->HandleFunc("/events", [release](ResponseWriter& w, const Request&) mutable {
+        auto* flusher = dynamic_cast<Flusher*>(&w);
+        ASSERT_NE(flusher, nullptr);
+        w.Header()["content-type"] = "text/event-stream";
+        w.Write("data: 1\n\n");
+        flusher->Flush();
+        release.recv();  // the client must see the first event before this returns
+        w.Write("data: 2\n\n");
+    });
+    Server server("", mux);
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+    const std::string address = listener->Address()->String();
+
+    // Ten thousand one-byte writes leave as three chunks: 4096, 4096 and the rest
+    std::string out = rawExchange(address,
+        "GET /small-writes HTTP/1.1\r\n\r\nGET /missing HTTP/1.1\r\nConnection: close\r\n\r\n");
+    EXPECT_EQ(out.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+    EXPECT_NE(out.find("\r\ndate: "), std::string::npos);
+    EXPECT_NE(out.find("transfer-encoding: chunked"), std::string::npos);
+    EXPECT_NE(out.find("\r\n\r\n1000\r\n"), std::string::npos);
+    EXPECT_EQ(count(out, "\r\n1000\r\n"), 2u);
+    EXPECT_NE(out.find("\r\n710\r\n"), std::string::npos);
+    EXPECT_EQ(count(out, "x"), 10000u);
+    EXPECT_NE(out.find("x\r\n0\r\n\r\nHTTP/1.1 404 Not Found\r\n"), std::string::npos);
+
+    // A flushed event reaches the client while the handler is still running
+    Client client;
+    client.transport = std::make_shared<Transport>();
+    Request req;
+    req.method = "GET";
+    req.url = url + "/events";
+    auto resp = client.Do(nullptr, req);
+    ASSERT_TRUE(resp.Ok());
+    EXPECT_EQ(resp.value.Header("transfer-encoding"), "chunked");
+    uint8_t buf[64];
+    auto first = resp.value.body_stream->Read(buf, sizeof(buf));
+    ASSERT_TRUE(first.Ok());
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(buf), first.value), "data: 1\n\n");
+    release.send(true);
+    auto second = resp.value.body_stream->Read(buf, sizeof(buf));
+    ASSERT_TRUE(second.Ok());
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(buf), second.value), "data: 2\n\n");
+
+    EXPECT_EQ(StatusText(404), "Not Found");
+    EXPECT_EQ(StatusText(799), "");
+
+    server.Shutdown(nullptr);
+    serving.join();
+}
+
+TEST(NetTest, SectionReaderReadsAtOffsetsWithoutSharedPosition) {
+    const std::string name = gocxx::os::TempDir() + "/gocxx_section.txt";
+    ASSERT_TRUE(gocxx::os::WriteFile(name, "0123456789abcdef", 0644).Ok());
+    std::shared_ptr<gocxx::io::ReaderAt> file = gocxx::os::Open(name).value;
+    ASSERT_NE(file, nullptr);
+
+    gocxx::io::SectionReader section(file, 4, 8);
+    EXPECT_EQ(section.Size(), 8u);
+    uint8_t buf[16];
+    auto res = section.Read(buf, 5);
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(buf), res.value), "45678");
+    res = section.Read(buf, sizeof(buf));
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(buf), res.value), "9ab");
+    EXPECT_TRUE(gocxx::errors::Is(section.Read(buf, sizeof(buf)).err, gocxx::io::ErrEOF));
+    res = section.ReadAt(buf, 2, 6);
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(buf), res.value), "ab");
+    EXPECT_EQ(section.Seek(-3, gocxx::io::SeekEnd).value, 5);
+    gocxx::os::Remove(name);
+}
+
+TEST(NetTest, FileServerServesRangesAndConditionalRequests) {
+    const std::string root = gocxx::os::TempDir() + "/gocxx_fileserver";
+    gocxx::os::RemoveAll(root);
+    ASSERT_TRUE(gocxx::os::MkdirAll(root + "/docs", 0755).Ok());
+    ASSERT_TRUE(gocxx::os::MkdirAll(root + "/site", 0755).Ok());
+    std::string payload(100000, '\0');
+    for (std::size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<char>('a' + i % 26);
+    ASSERT_TRUE(gocxx::os::WriteFile(root + "/data.bin", payload, 0644).Ok());
+    ASSERT_TRUE(gocxx::os::WriteFile(root + "/docs/a&b.txt", "note", 0644).Ok());
+    ASSERT_TRUE(gocxx::os::WriteFile(root + "/site/index.html", "<h1>home</h1>", 0644).Ok());
+    ASSERT_TRUE(gocxx::os::WriteFile(gocxx::os::TempDir() + "/gocxx_fileserver_secret", "secret", 0644).Ok());
+
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/static/", StripPrefix("/static", FileServer(root)));
+    mux->HandleFunc("/one", [root](ResponseWriter& w, const Request& req) { ServeFile(w, req, root + "/docs/a&b.txt"); });
+    Server server("", mux);
+    std::string url;
+    auto listener = listenLocal(url);
+    ASSERT_NE(listener, nullptr);
+    std::thread serving([&] { server.Serve(listener); });
+    const std::string address = listener->Address()->String();
+
+    Client client;
+    client.transport = std::make_shared<Transport>();
+    auto full = client.Get(url + "/static/data.bin");
+    ASSERT_TRUE(full.Ok());
+    EXPECT_EQ(full.value.status_code, StatusOK);
+    EXPECT_EQ(full.value.Header("content-length"), "100000");
+    EXPECT_EQ(full.value.Header("accept-ranges"), "bytes");
+    EXPECT_EQ(full.value.Header("content-type"), "application/octet-stream");
+    EXPECT_EQ(full.value.body, payload);
+    const std::string etag = full.value.Header("etag");
+    const std::string modified = full.value.Header("last-modified");
+    EXPECT_EQ(etag.front(), '"');
+    EXPECT_NE(modified.find(" GMT"), std::string::npos);
+
+    // Do() streams the body; read it all as Get() does
+    auto fetch = [&client](const Request& req) {
+        auto resp = client.Do(nullptr, req);
+        if (resp.Ok() && resp.value.body_stream) {
+            uint8_t buf[4096];
+            for (;;) {
+                auto res = resp.value.body_stream->Read(buf, sizeof(buf));
+                resp.value.body.append(reinterpret_cast<char*>(buf), res.value);
+                if (res.Failed() || res.value == 0) break;
+            }
+        }
+        return resp;
+    };
+    Request req;
+    req.method = "GET";
+    req.url = url + "/static/data.bin";
+    req.header["range"] = "bytes=26-51";
+    auto part = fetch(req);
+    ASSERT_TRUE(part.Ok());
+    EXPECT_EQ(part.value.status_code, 206);
+    EXPECT_EQ(part.value.Header("content-range"), "bytes 26-51/100000");
+    EXPECT_EQ(part.value.body, payload.substr(26, 26));
+
+    req.header["range"] = "bytes=-10";
+    part = fetch(req);
+    EXPECT_EQ(part.value.Header("content-range"), "bytes 99990-99999/100000");
+    EXPECT_EQ(part.value.body, payload.substr(99990));
+
+    req.header["if-range"] = "\"stale\"";  // an old representation: the whole file
+    part = fetch(req);
+    EXPECT_EQ(part.value.status_code, StatusOK);
+    EXPECT_EQ(part.value.body.size(), payload.size());
+    req.header.erase("if-range");
+
+    req.header["range"] = "bytes=100000-";
+    part = fetch(req);
+    EXPECT_EQ(part.value.status_code, 416);
+    EXPECT_EQ(part.value.Header("content-range"), "bytes */100000");
+    req.header.erase("range");
+
+    req.header["if-none-match"] = "W/\"other\", " + etag;
+    auto cached = fetch(req);
+    EXPECT_EQ(cached.value.status_code, 304);
+    EXPECT_TRUE(cached.value.body.empty());
+    req.header.erase("if-none-match");
+    req.header["if-modified-since"] = modified;
+    cached = fetch(req);
+    EXPECT_EQ(cached.value.status_code, 304);
+    req.header["if-modified-since"] = "Thu, 01 Jan 1970 00:00:00 GMT";
+    cached = fetch(req);
+    EXPECT_EQ(cached.value.status_code, StatusOK);
+
+    // Directories: redirect to the slash form, then index.html or a listing
+    std::string out = rawExchange(address,
+        "GET /static/site?x=1 HTTP/1.1\r\n\r\n"
+        "GET /static/site/ HTTP/1.1\r\n\r\n"
+        "GET /static/docs/ HTTP/1.1\r\n\r\n"
+        "HEAD /static/data.bin HTTP/1.1\r\n\r\n"
+        "GET /static/../gocxx_fileserver_secret HTTP/1.1\r\n\r\n"
+        "GET /static/%2e%2e/gocxx_fileserver_secret HTTP/1.1\r\n\r\n"
+        "GET /static/%zz HTTP/1.1\r\n\r\n"
+        "GET /one HTTP/1.1\r\nConnection: close\r\n\r\n");
+    EXPECT_EQ(out.rfind("HTTP/1.1 301 Moved Permanently\r\n", 0), 0u);
+    EXPECT_NE(out.find("location: site/?x=1\r\n"), std::string::npos);
+    EXPECT_NE(out.find("<h1>home</h1>"), std::string::npos);
+    EXPECT_NE(out.find("<a href=\"a%26b.txt\">a&amp;b.txt</a>"), std::string::npos);
+    EXPECT_NE(out.find("content-length: 100000\r\n"), std::string::npos);
+    EXPECT_EQ(count(out, "HTTP/1.1 404 Not Found\r\n"), 2u);
+    EXPECT_EQ(out.find("secret"), std::string::npos);
+    EXPECT_NE(out.find("HTTP/1.1 400 Bad Request\r\n"), std::string::npos);
+    EXPECT_NE(out.find("content-type: text/plain; charset=utf-8\r\n"), std::string::npos);
+    EXPECT_EQ(out.substr(out.size() - 4), "note");
+
+    // A rewritten file is picked up once the cached stat is a second old
+    ASSERT_TRUE(gocxx::os::WriteFile(root + "/data.bin", "short", 0644).Ok());
+    gocxx::time::Sleep(gocxx::time::Milliseconds(1100));
+    auto fresh = client.Get(url + "/static/data.bin");
+    ASSERT_TRUE(fresh.Ok());
+    EXPECT_EQ(fresh.value.body, "short");
+
+    server.Shutdown(nullptr);
+    serving.join();
+    gocxx::os::RemoveAll(root);
+    gocxx::os::Remove(gocxx::os::TempDir() + "/gocxx_fileserver_secret");
+}
+
+TEST(NetTest, ReusePortShardsServeOneAddress) {
+    // Without SO_REUSEPORT a second socket cannot bind the port
+    auto first = ListenConfig{}.Listen("tcp", "127.0.0.1:0");
+    ASSERT_TRUE(first.Ok());
+    const std::string taken = first.value->Address()->String();
+    EXPECT_TRUE(ListenConfig{}.Listen("tcp", taken).Failed());
+    first.value->Close();
+
+    ListenConfig config;
+    config.incoming_cpu = 0;
+    auto shards = config.ListenShards("tcp", "127.0.0.1:0", 4);
+    ASSERT_TRUE(shards.Ok()) << shards.err->error();
+    ASSERT_EQ(shards.value.size(), 4u);
+    const std::string address = shards.value[0]->Address()->String();
+    for (const auto& shard : shards.value) {
+        EXPECT_EQ(shard->Address()->String(), address);
+    }
+    EXPECT_THROW(config.ListenShards("tcp", "127.0.0.1:0", 0), std::invalid_argument);
+
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("/", [](ResponseWriter& w, const Request&) { w.Write("ok"); });
+    Server server("", mux);
+    server.pin_accept_loops = true;
+    gocxx::base::Result<void> served;
+    std::thread serving([&] { served = server.ServeShards(shards.value); });
+
+    // A fresh connection per request, so they spread across the shards
+    Client client;
+    client.transport = std::make_shared<Transport>();
+    client.transport->max_idle_conns_per_host = 0;
+    for (int i = 0; i < 32; ++i) {
+        auto resp = client.Get("http://" + address + "/");
+        ASSERT_TRUE(resp.Ok());
+        EXPECT_EQ(resp.value.body, "ok");
+    }
+
+    server.Shutdown(nullptr);
+    serving.join();
+    EXPECT_TRUE(gocxx::errors::Is(served.err, ErrServerClosed));
+    EXPECT_TRUE(DialTCP("tcp", address).Failed());
+}
+
+TEST(NetTest, DialerTunesSocketsAndRacesAddressFamilies) {
+    // Socket options reach the socket before connect, and Control can veto it
+    auto listener = ListenConfig{}.Listen("tcp", "127.0.0.1:0").value;
+    ASSERT_NE(listener, nullptr);
+    Dialer tuned;
+    tuned.recv_buffer = 256 * 1024;
+    std::string seen_network;
+    int no_delay = 0;
+    int rcvbuf = 0;
+    tuned.control = [&](const std::string& network, const std::string&, int fd) {
+        seen_network = network;
+        socklen_t len = sizeof(no_delay);
+        getsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char*>(&no_delay), &len);
+        len = sizeof(rcvbuf);
+        getsockopt(fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char*>(&rcvbuf), &len);
+        return std::shared_ptr<gocxx::errors::Error>();
+    };
+    auto conn = tuned.DialContext(nullptr, "tcp", listener->Address()->String());
+    ASSERT_TRUE(conn.Ok());
+    EXPECT_EQ(seen_network, "tcp4");
+    EXPECT_EQ(no_delay, 1);
+    EXPECT_GE(rcvbuf, 256 * 1024);
+    auto vetoed = gocxx::errors::New("vetoed");
+    tuned.control = [&](const std::string&, const std::string&, int) { return vetoed; };
+    EXPECT_EQ(tuned.DialContext(nullptr, "tcp", listener->Address()->String()).err, vetoed);
+    conn.value->close();
+    listener->Close();
+
+    // IPv6 literals are bracketed in addresses
+    auto v6 = ListenConfig{}.Listen("tcp", "[::1]:0");
+    ASSERT_TRUE(v6.Ok());
+    EXPECT_EQ(v6.value->Address()->String().rfind("[::1]:", 0), 0u);
+    EXPECT_TRUE(ResolveTCPAddr("tcp", "::1:80").Failed());
+    EXPECT_TRUE(ResolveTCPAddr("tcp4", "[::1]:80").Failed());
+    v6.value->Close();
+
+    // A listener with a full accept queue drops SYNs: connects to it hang
+    auto stalled = ListenConfig{0}.Listen("tcp", "127.0.0.1:0").value;
+    ASSERT_NE(stalled, nullptr);
+    const int shared_port = std::static_pointer_cast<TCPAddr>(stalled->Address())->port;
+    auto filler = DialTCP("tcp", stalled->Address()->String());
+    ASSERT_TRUE(filler.Ok());
+    auto served = ListenConfig{}.Listen("tcp", "[::1]:" + std::to_string(shared_port));
+    ASSERT_TRUE(served.Ok());
+    std::thread accepting([&] { served.value->Accept(); });
+
+    Dialer racing;
+    racing.fallback_delay = std::chrono::milliseconds(50);
+    racing.resolver = [](gocxx::context::ContextPtr, const std::string&, const std::string& host) {
+        EXPECT_EQ(host, "dual.example");
+        return gocxx::base::Result<std::vector<std::string>>{{"127.0.0.1", "::1"}, nullptr};
+    };
+    const std::string dual = "dual.example:" + std::to_string(shared_port);
+    auto start = std::chrono::steady_clock::now();
+    auto raced = racing.DialContext(nullptr, "tcp", dual);
+    ASSERT_TRUE(raced.Ok());
+    EXPECT_EQ(std::static_pointer_cast<TCPAddr>(raced.value->RemoteAddr())->ip, "::1");
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    accepting.join();
+    raced.value->close();
+
+    // Without the race the addresses are tried in order, and the timeout covers them all
+    racing.fallback_delay = std::chrono::milliseconds(-1);
+    racing.timeout = std::chrono::milliseconds(200);
+    auto serial = racing.DialContext(nullptr, "tcp", dual);
+    EXPECT_TRUE(gocxx::errors::Is(serial.err, ErrTimeout));
+
+    filler.value->close();
+    stalled->Close();
+    served.value->Close();
+}
+
+TEST(NetTest, UDPBatchedReadsAndWrites) {
+    auto receiver = ListenUDPSimple("127.0.0.1:0").value;
+    auto sender = ListenUDPSimple("127.0.0.1:0").value;
+    ASSERT_NE(receiver, nullptr);
+    ASSERT_NE(sender, nullptr);
+    const AddrPort to = AddrPort::From(*std::static_pointer_cast<UDPAddr>(receiver->LocalAddr()));
+    const AddrPort from = AddrPort::From(*std::static_pointer_cast<UDPAddr>(sender->LocalAddr()));
+    EXPECT_TRUE(to.IsValid());
+    EXPECT_EQ(to.String(), receiver->LocalAddr()->String());
+    EXPECT_EQ(to.ToUDPAddr()->String(), receiver->LocalAddr()->String());
+
+    // More datagrams than one system call carries
+    const std::size_t total = UDPConn::kMaxBatch + 16;
+    std::vector<std::string> payloads;
+    for (std::size_t i = 0; i < total; ++i) {
+        payloads.push_back("datagram-" + std::to_string(i) + std::string(i, '.'));
+    }
+    std::vector<UDPMessage> out(total);
+    for (std::size_t i = 0; i < total; ++i) {
+        out[i].buffer = reinterpret_cast<uint8_t*>(&payloads[i][0]);
+        out[i].size = payloads[i].size();
+        out[i].addr = to;
+    }
+    auto written = sender->WriteBatch(out.data(), out.size());
+    ASSERT_TRUE(written.Ok());
+    EXPECT_EQ(written.value, total);
+    EXPECT_EQ(out[total - 1].n, payloads[total - 1].size());
+
+    std::vector<std::vector<uint8_t>> storage(UDPConn::kMaxBatch, std::vector<uint8_t>(2048));
+    std::vector<UDPMessage> in(UDPConn::kMaxBatch);
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        in[i].buffer = storage[i].data();
+        in[i].size = storage[i].size();
+    }
+    receiver->SetReadDeadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+    std::vector<std::string> received;
+    while (received.size() < total) {
+        auto got = receiver->ReadBatch(in.data(), in.size());
+        ASSERT_TRUE(got.Ok());
+        ASSERT_GE(got.value, 1u);
+        for (std::size_t i = 0; i < got.value; ++i) {
+            EXPECT_EQ(in[i].addr, from);
+            received.emplace_back(reinterpret_cast<char*>(in[i].buffer), in[i].n);
+        }
+    }
+    EXPECT_EQ(received, payloads);
+
+    // Segmentation offload: one buffer leaves as several datagrams, where the kernel supports it
+    std::string big(2500, 'g');
+    UDPMessage segmented;
+    segmented.buffer = reinterpret_cast<uint8_t*>(&big[0]);
+    segmented.size = big.size();
+    segmented.addr = to;
+    segmented.segment_size = 1000;
+    if (sender->WriteBatch(&segmented, 1).Ok()) {
+        std::vector<std::size_t> sizes;
+        while (sizes.size() < 3) {
+            auto got = receiver->ReadBatch(in.data(), in.size());
+            ASSERT_TRUE(got.Ok());
+            for (std::size_t i = 0; i < got.value; ++i) sizes.push_back(in[i].n);
+        }
+        EXPECT_EQ(sizes, (std::vector<std::size_t>{1000, 1000, 500}));
+    }
+
+    receiver->close();
+    sender->close();
+}
+
+TEST(NetTest, ResolverCachesSharesAndRefreshesLookups) {
+    std::atomic<int> lookups{0};
+    gocxx::base::Chan<bool> release;
+    Resolver resolver;
+    resolver.ttl = std::chrono::milliseconds(600);
+    resolver.negative_ttl = std::chrono::milliseconds(600);
+    resolver.refresh_ahead = std::chrono::milliseconds(200);
+    resolver.lookup = [&](const std::string& host) -> gocxx::base::Result<Resolver::Answer> {
+        ++lookups;
+        release.recv();
+        if (host == "missing.test") {
+            return {gocxx::errors::New("no such host")};
+        }
+        return {Resolver::Answer{{"10.0.0.1", "fd00::1"}, std::chrono::nanoseconds(0)}, nullptr};
+    };
+
+    // Concurrent misses for one name share a single lookup
+    std::vector<std::thread> callers;
+    std::vector<gocxx::base::Result<std::vector<std::string>>> results(4);
+    for (auto& r : results) {
+        callers.emplace_back([&] { r = resolver.LookupHost(nullptr, "svc.test"); });
+    }
+    while (resolver.Stats().misses < 4) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    release.close();
+    for (auto& t : callers) t.join();
+    EXPECT_EQ(lookups.load(), 1);
+    for (auto& r : results) {
+        ASSERT_TRUE(r.Ok());
+        EXPECT_EQ(r.value, (std::vector<std::string>{"10.0.0.1", "fd00::1"}));
+    }
+    EXPECT_EQ(resolver.Stats().shared, 4u);
+
+    // Hits, family filtering and literals need no lookup
+    EXPECT_EQ(resolver.LookupIP(nullptr, "ip6", "svc.test").value, std::vector<std::string>{"fd00::1"});
+    EXPECT_EQ(resolver.LookupIP(nullptr, "tcp4", "svc.test").value, std::vector<std::string>{"10.0.0.1"});
+    EXPECT_EQ(resolver.LookupHost(nullptr, "192.0.2.7").value, std::vector<std::string>{"192.0.2.7"});
+    EXPECT_EQ(lookups.load(), 1);
+
+    // Failures are cached too
+    EXPECT_TRUE(resolver.LookupHost(nullptr, "missing.test").Failed());
+    EXPECT_TRUE(resolver.LookupHost(nullptr, "missing.test").Failed());
+    EXPECT_EQ(lookups.load(), 2);
+
+    // A hit close to expiry is answered at once and renewed in the background
+    gocxx::time::Sleep(gocxx::time::Milliseconds(450));
+    EXPECT_TRUE(resolver.LookupHost(nullptr, "svc.test").Ok());
+    for (int i = 0; i < 1000 && lookups.load() < 3; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(lookups.load(), 3);
+    EXPECT_EQ(resolver.Stats().refreshes, 1u);
+    gocxx::time::Sleep(gocxx::time::Milliseconds(250));
+    EXPECT_TRUE(resolver.LookupHost(nullptr, "svc.test").Ok());  // past the first answer's expiry
+    EXPECT_EQ(lookups.load(), 3);
+
+    // A caller gives up when its context ends; the lookup still fills the cache
+    gocxx::base::Chan<bool> slow;
+    resolver.lookup = [&](const std::string&) -> gocxx::base::Result<Resolver::Answer> {
+        ++lookups;
+        slow.recv();
+        return {Resolver::Answer{{"10.0.0.2"}, std::chrono::seconds(10)}, nullptr};
+    };
+    auto ctx = gocxx::context::WithCancel(gocxx::context::Background()).value;
+    std::thread cancel([&] {
+        gocxx::time::Sleep(gocxx::time::Milliseconds(20));
+        ctx.second();
+    });
+    auto cancelled = resolver.LookupHost(ctx.first, "slow.test");
+    cancel.join();
+    EXPECT_TRUE(cancelled.Failed());
+    slow.close();
+    for (int i = 0; i < 1000 && resolver.Stats().entries < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(resolver.LookupHost(nullptr, "slow.test").value, std::vector<std::string>{"10.0.0.2"});
+    EXPECT_EQ(lookups.load(), 4);
+
+    resolver.Forget("slow.test");
+    EXPECT_TRUE(resolver.LookupHost(nullptr, "slow.test").Ok());
+    EXPECT_EQ(lookups.load(), 5);
+
+    // The default resolver serves ResolveTCPAddr
+    auto addr = ResolveTCPAddr("tcp", "localhost:80");
+    ASSERT_TRUE(addr.Ok());
+    EXPECT_EQ(addr.value->ip, "127.0.0.1");
+    EXPECT_GE(DefaultResolver()->Stats().entries, 1u);
+}
+
+TEST(NetTest, LatencyHistogramBucketsWithinAnEighth) {
+    for (std::uint64_t v : {0ull, 1ull, 15ull, 16ull, 17ull, 100ull, 1000ull, 123456ull, (1ull << 32) - 1}) {
+        const std::size_t i = LatencyHistogram::BucketFor(v);
+        ASSERT_LT(i, LatencyHistogram::kBuckets);
+        EXPECT_LT(v, LatencyHistogram::UpperBound(i)) << v;
+        EXPECT_TRUE(i == 0 || LatencyHistogram::UpperBound(i - 1) <= v) << v;
+        EXPECT_LE(LatencyHistogram::UpperBound(i) - (i == 0 ? 0 : LatencyHistogram::UpperBound(i - 1)),
+                  std::max<std::uint64_t>(1, v / 8 + 1)) << v;
+    }
+    EXPECT_EQ(LatencyHistogram::BucketFor(1ull << 40), LatencyHistogram::kBuckets - 1);
+
+    LatencyHistogram h;
+    for (int ms = 1; ms <= 100; ++ms) h.Record(std::chrono::milliseconds(ms));
+    EXPECT_EQ(h.Count(), 100u);
+    const auto p50 = h.Quantile(0.5).count();
+    const auto p99 = h.Quantile(0.99).count();
+    EXPECT_GE(p50, 50000);
+    EXPECT_LE(p50, 50000 * 9 / 8);
+    EXPECT_GE(p99, 99000);
+    EXPECT_LE(p99, 99000 * 9 / 8);
+    EXPECT_EQ(h.CountBelow(1 << 14), 16u);  // 16384us: 1ms through 16ms
+}
+
+TEST(NetTest, ServerMetricsRecordRoutesAndConnectionStates) {
+    auto metrics = std::make_shared<ServerMetrics>();
+    auto mux = std::make_shared<ServeMux>();
+    mux->HandleFunc("GET /items/{id}", [](ResponseWriter& w, const Request& req) {
+        EXPECT_EQ(req.Pattern(), "GET /items/{id}");
+        w.Write("item " + std::string(req.PathValue("id")));
+    });
+    mux->HandleFunc("POST /items", [](ResponseWriter& w, const Request&) {
+        w.WriteHeader(StatusCreated);
+    });
+    mux->HandleFunc("GET /metrics", MetricsHandler(metrics));
+
+    std::mutex states_mu;
+    std::vector<ConnState> states;
+    Server server("", mux);
+    server.metrics = metrics;
+    server.conn_state = [&](const std::shared_ptr<TCPConn>&, ConnState state) {
+        std::lock_guard<std::mutex> lock(states_mu);
+        states.push_back(state);
+    };
+    auto listener = ListenConfig{}.Listen("tcp", "127.0.0.1:0").value;
+    const std::string url = "http://" + listener->Address()->String();
+    std::thread serving([&] { server.Serve(listener); });
+
+    // One kept-alive connection
+    Client client;
+    client.transport = std::make_shared<Transport>();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(client.Get(url + "/items/" + std::to_string(i)).value.body, "item " + std::to_string(i));
+    }
+    EXPECT_EQ(client.Post(url + "/items", "text/plain", "hello").value.status_code, StatusCreated);
+    EXPECT_EQ(client.Get(url + "/nowhere").value.status_code, StatusNotFound);
+
+    // Each request is recorded just after its response goes out
+    auto stats = metrics->Snapshot();
+    for (int i = 0; i < 1000 && (stats.routes.size() < 3 || stats.conns_active > 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        stats = metrics->Snapshot();
+    }
+    ASSERT_EQ(stats.routes.size(), 3u);
+    EXPECT_EQ(stats.routes[0].route, "");
+    EXPECT_EQ(stats.routes[0].by_class[3], 1u);
+    EXPECT_EQ(stats.routes[1].route, "GET /items/{id}");
+    EXPECT_EQ(stats.routes[1].requests, 3u);
+    EXPECT_EQ(stats.routes[1].by_class[1], 3u);
+    EXPECT_EQ(stats.routes[1].response_bytes, 3u * 6);
+    EXPECT_EQ(stats.routes[1].latency.Count(), 3u);
+    EXPECT_EQ(stats.routes[2].route, "POST /items");
+    EXPECT_EQ(stats.routes[2].request_bytes, 5u);
+    EXPECT_EQ(stats.accepted, 1u);
+    EXPECT_EQ(stats.conns_idle, 1);
+    EXPECT_EQ(stats.conns_active, 0);
+    EXPECT_EQ(stats.in_flight, 0);
+
+    auto exported = client.Get(url + "/metrics");
+    ASSERT_TRUE(exported.Ok());
+    EXPECT_EQ(exported.value.Header("content-type"), "text/plain; version=0.0.4; charset=utf-8");
+    const std::string& text = exported.value.body;
+    EXPECT_NE(text.find("http_server_requests_total{route=\"GET /items/{id}\",code=\"2xx\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("http_server_requests_total{route=\"\",code=\"4xx\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("http_server_request_duration_seconds_bucket{route=\"POST /items\",le=\"+Inf\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("http_server_request_duration_seconds_bucket{route=\"POST /items\",le=\"67.108864\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("http_server_request_body_bytes_total{route=\"POST /items\"} 5\n"), std::string::npos);
+    EXPECT_NE(text.find("http_server_requests_in_flight 1\n"), std::string::npos);  // the export itself
+    EXPECT_NE(text.find("http_server_connections{state=\"active\"} 1\n"), std::string::npos);
+
+    client.transport->CloseIdleConnections();
+    server.Shutdown(nullptr);
+    serving.join();
+    std::lock_guard<std::mutex> lock(states_mu);
+    ASSERT_GE(states.size(), 3u);
+    EXPECT_EQ(states.front(), ConnState::New);
+    EXPECT_EQ(states[1], ConnState::Active);
+    EXPECT_EQ(states[2], ConnState::Idle);
+    EXPECT_EQ(states.back(), ConnState::Closed);
+    EXPECT_EQ(std::count(states.begin(), states.end(), ConnState::Active), 6);
+    EXPECT_EQ(metrics->Snapshot().conns_idle, 0);
+}
@@ -1,7 +1,18 @@
 #include <gtest/gtest.h>
 #include <gocxx/os/os.h>
 #include <gocxx/os/file.h>
+#include <gocxx/os/mmap.h>
+#include <gocxx/os/walk.h>
+#include <gocxx/os/exec.h>
+#include <gocxx/bytes/bytes.h>
+#include <gocxx/context/context.h>
+#include <gocxx/io/io.h>
+#include <gocxx/io/io_errors.h>
+#include <gocxx/io/parallel.h>
+#include <atomic>
 #include <thread>
+#include <mutex>
+#include <set>
 #include <chrono>
 
 using namespace gocxx::os;
@@ -215,3 +226,361 @@ TEST_F(OsTest, ProcessManagement) {
         EXPECT_EQ(process->Pid(), current_pid);
     }
 }
+
+// WalkParallel sees the same tree as Walk, and honours SkipDir, SkipAll and cancellation
+TEST_F(OsTest, WalkParallelMatchesWalk) {
+    const std::string root = TempDir() + "/gocxx_walk";
+    RemoveAll(root);
+    for (int a = 0; a < 6; ++a) {
+        for (int b = 0; b < 5; ++b) {
+            const std::string dir = root + "/d" + std::to_string(a) + "/e" + std::to_string(b);
+            ASSERT_TRUE(MkdirAll(dir, 0755).Ok());
+            for (int f = 0; f < 7; ++f) {
+                ASSERT_TRUE(WriteFile(dir + "/f" + std::to_string(f), std::string(f, 'x'), 0644).Ok());
+            }
+        }
+    }
+
+    std::set<std::string> sequential;
+    ASSERT_TRUE(Walk(root, [&](const std::string& path, const FileInfo&) {
+        sequential.insert(path);
+        return gocxx::base::Result<void>();
+    }).Ok());
+    EXPECT_EQ(sequential.size(), 1u + 6 + 6 * 5 + 6 * 5 * 7);
+
+    std::mutex mu;
+    std::set<std::string> parallel;
+    int64_t bytes = 0;
+    auto res = WalkParallel(root, 4, [&](const WalkEntry& e, std::shared_ptr<gocxx::errors::Error> err) {
+        EXPECT_EQ(err, nullptr);
+        int64_t size = e.IsDir() ? 0 : e.Info().value.size;  // only files are stat'ed
+        std::lock_guard<std::mutex> lock(mu);
+        if (!e.IsDir()) {
+            EXPECT_EQ(e.Type(), 0u);
+        }
+        parallel.insert(e.Path());
+        bytes += size;
+        return gocxx::base::Result<void>();
+    });
+    ASSERT_TRUE(res.Ok());
+    EXPECT_EQ(parallel, sequential);
+    EXPECT_EQ(bytes, 6 * 5 * (0 + 1 + 2 + 3 + 4 + 5 + 6));
+
+    // Skipping d0 drops everything underneath it
+    parallel.clear();
+    ASSERT_TRUE(WalkParallel(root, 3, [&](const WalkEntry& e, std::shared_ptr<gocxx::errors::Error>) {
+        if (e.Name() == "d0") return gocxx::base::Result<void>(SkipDir);
+        std::lock_guard<std::mutex> lock(mu);
+        parallel.insert(e.Path());
+        return gocxx::base::Result<void>();
+    }).Ok());
+    for (const auto& p : parallel) EXPECT_EQ(p.find(root + "/d0"), std::string::npos) << p;
+    EXPECT_EQ(parallel.size(), sequential.size() - (1 + 5 + 5 * 7));
+
+    // SkipAll ends the walk early without an error
+    std::atomic<int> seen{0};
+    ASSERT_TRUE(WalkParallel(root, 4, [&](const WalkEntry&, std::shared_ptr<gocxx::errors::Error>) {
+        return ++seen >= 10 ? gocxx::base::Result<void>(SkipAll) : gocxx::base::Result<void>();
+    }).Ok());
+    EXPECT_LT(seen.load(), static_cast<int>(sequential.size()));
+
+    // A cancelled context stops it with the context's error
+    auto withCancel = gocxx::context::WithCancel(gocxx::context::Background()).value;
+    auto ctx = withCancel.first;
+    auto cancel = withCancel.second;
+    res = WalkParallel(ctx, root, 2, [&](const WalkEntry&, std::shared_ptr<gocxx::errors::Error>) {
+        cancel();
+        return gocxx::base::Result<void>();
+    });
+    EXPECT_TRUE(res.Failed());
+
+    // A missing root is reported to the callback
+    res = WalkParallel(root + "/missing", 2, [](const WalkEntry&, std::shared_ptr<gocxx::errors::Error> err) {
+        return gocxx::base::Result<void>(err);
+    });
+    EXPECT_TRUE(gocxx::errors::Is(res.err, ErrNotExist));
+
+    RemoveAll(root);
+}
+
+// ReadAt/WriteAt use pread/pwrite, so workers share one File safely
+TEST_F(OsTest, ParallelCopyBetweenFiles) {
+    std::string payload(700001, '\0');
+    for (std::size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<char>(i % 251);
+    const std::string srcName = TempDir() + "/gocxx_pcopy_src.bin";
+    const std::string dstName = TempDir() + "/gocxx_pcopy_dst.bin";
+    ASSERT_TRUE(WriteFile(srcName, payload, 0644).Ok());
+
+    {
+        auto src = Open(srcName).value;
+        auto dst = Create(dstName).value;
+        auto copied = gocxx::io::ParallelCopy(dst, src, payload.size(), 32 * 1024, 4);
+        ASSERT_TRUE(copied.Ok());
+        EXPECT_EQ(copied.value, payload.size());
+
+        // The file offset never moved
+        uint8_t first = 1;
+        ASSERT_TRUE(src->Read(&first, 1).Ok());
+        EXPECT_EQ(first, 0);
+
+        // Reading past the end reports EOF with the bytes that were there
+        uint8_t tail[8];
+        auto res = src->ReadAt(tail, sizeof tail, payload.size() - 3);
+        EXPECT_EQ(res.value, 3u);
+        EXPECT_TRUE(gocxx::errors::Is(res.err, gocxx::io::ErrEOF));
+    }
+    auto out = ReadFile(dstName).value;
+    EXPECT_EQ(std::string(out.begin(), out.end()), payload);
+
+    auto src = Open(srcName).value;
+    auto crc = gocxx::io::ParallelCRC32(src, payload.size(), 50000, 3);
+    ASSERT_TRUE(crc.Ok());
+    EXPECT_EQ(crc.value, gocxx::hash::crc32::Checksum(payload));
+
+    Remove(srcName);
+    Remove(dstName);
+}
+
+// io::Copy between files and pipes goes through File::WriteTo/ReadFrom
+TEST_F(OsTest, CopyUsesFileFastPaths) {
+    std::string payload(300000, '\0');
+    for (std::size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<char>('a' + i % 26);
+    const std::string srcName = TempDir() + "/gocxx_copy_src.bin";
+    const std::string dstName = TempDir() + "/gocxx_copy_dst.bin";
+    ASSERT_TRUE(WriteFile(srcName, payload, 0644).Ok());
+
+    {
+        auto src = Open(srcName).value;
+        auto dst = Create(dstName).value;
+        auto copied = gocxx::io::Copy(dst, src);
+        ASSERT_TRUE(copied.Ok());
+        EXPECT_EQ(copied.value, payload.size());
+    }
+    auto out = ReadFile(dstName).value;
+    EXPECT_EQ(std::string(out.begin(), out.end()), payload);
+
+    // CopyN stops at the limit and leaves the source positioned after it
+    {
+        auto src = Open(srcName).value;
+        auto dst = Create(dstName).value;
+        auto copied = gocxx::io::CopyN(dst, src, 1000);
+        ASSERT_TRUE(copied.Ok());
+        EXPECT_EQ(copied.value, 1000u);
+        uint8_t next = 0;
+        ASSERT_TRUE(src->Read(&next, 1).Ok());
+        EXPECT_EQ(next, static_cast<uint8_t>(payload[1000]));
+    }
+    EXPECT_EQ(FileSize(dstName).value, 1000);
+
+    // File -> pipe -> file
+    auto pipe = Pipe();
+    ASSERT_TRUE(pipe.Ok());
+    auto [pr, pw] = pipe.value;
+    std::thread feeder([pw = pw, srcName] {
+        auto src = Open(srcName).value;
+        EXPECT_TRUE(gocxx::io::Copy(pw, src).Ok());
+        pw->close();
+    });
+    {
+        auto dst = Create(dstName).value;
+        auto copied = gocxx::io::Copy(dst, pr);
+        ASSERT_TRUE(copied.Ok());
+        EXPECT_EQ(copied.value, payload.size());
+    }
+    feeder.join();
+    out = ReadFile(dstName).value;
+    EXPECT_EQ(std::string(out.begin(), out.end()), payload);
+
+    Remove(srcName);
+    Remove(dstName);
+}
+
+TEST_F(OsTest, WriteBuffersAndReadBuffers) {
+    const std::string name = TempDir() + "/gocxx_writev.bin";
+    // More regions than one writev takes (IOV_MAX), with empty ones mixed in.
+    std::vector<std::string> parts;
+    std::string expected;
+    for (int i = 0; i < 3000; ++i) {
+        parts.push_back(i % 7 == 0 ? std::string() : std::to_string(i) + ",");
+        expected += parts.back();
+    }
+    gocxx::io::Buffers bufs(parts.begin(), parts.end());
+    {
+        auto f = Create(name).value;
+        auto written = f->WriteBuffers(bufs);
+        ASSERT_TRUE(written.Ok());
+        EXPECT_EQ(written.value, expected.size());
+    }
+
+    auto f = Open(name).value;
+    std::vector<uint8_t> head(5), tail(expected.size() - 5);
+    auto read = f->ReadBuffers({ head, tail });
+    ASSERT_TRUE(read.Ok());
+    EXPECT_EQ(read.value, expected.size());
+    EXPECT_EQ(std::string(head.begin(), head.end()) + std::string(tail.begin(), tail.end()), expected);
+    EXPECT_EQ(f->ReadBuffers({ head }).value, 0u);  // end of file
+    f->close();
+    EXPECT_TRUE(f->WriteBuffers(bufs).Failed());
+    Remove(name);
+}
+
+TEST_F(OsTest, MappedFileReadWriteAndReadFileMapped) {
+    const std::string name = TempDir() + "/gocxx_mmap.bin";
+    std::string payload(10000, '\0');
+    for (std::size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<char>('A' + i % 23);
+    ASSERT_TRUE(WriteFile(name, payload, 0644).Ok());
+
+    {
+        auto mapped = MapFile(name);
+        ASSERT_TRUE(mapped.Ok());
+        auto m = mapped.value;
+        EXPECT_EQ(m->Size(), payload.size());
+        EXPECT_EQ(m->View(), payload);
+        EXPECT_TRUE(m->Advise(MapAdvice::Random).Ok());
+        EXPECT_TRUE(m->Advise(MapAdvice::WillNeed, 5000, 100).Ok());
+
+        uint8_t buf[8];
+        auto tail = m->ReadAt(buf, sizeof buf, payload.size() - 3);
+        EXPECT_EQ(tail.value, 3u);
+        EXPECT_TRUE(gocxx::errors::Is(tail.err, gocxx::io::ErrEOF));
+        EXPECT_TRUE(m->WriteAt(buf, 1, 0).Failed());  // read-only
+        EXPECT_TRUE(m->Close().Ok());
+        EXPECT_TRUE(m->ReadAt(buf, 1, 0).Failed());
+    }
+
+    {
+        auto m = MapFile(name, MapMode::ReadWrite).value;
+        ASSERT_NE(m, nullptr);
+        const std::string patch = "patched";
+        ASSERT_TRUE(m->WriteAt(reinterpret_cast<const uint8_t*>(patch.data()), patch.size(), 100).Ok());
+        EXPECT_TRUE(m->WriteAt(reinterpret_cast<const uint8_t*>(patch.data()), patch.size(), payload.size() - 2).Failed());
+        m->MutableData()[0] = 'z';
+        EXPECT_TRUE(m->Sync().Ok());
+    }
+    payload.replace(100, 7, "patched");
+    payload[0] = 'z';
+
+    auto heap = ReadFileMapped(name, payload.size() + 1);
+    ASSERT_TRUE(heap.Ok());
+    EXPECT_FALSE(heap.value.Mapped());
+    EXPECT_EQ(heap.value.View(), payload);
+
+    auto viaMap = ReadFileMapped(name, 4096);
+    ASSERT_TRUE(viaMap.Ok());
+    EXPECT_TRUE(viaMap.value.Mapped());
+    EXPECT_EQ(viaMap.value.View(), payload);
+
+    // ReadFile keeps reading past what Stat reported
+    auto proc = ReadFile("/proc/self/status");
+    if (proc.Ok()) {
+        EXPECT_GT(proc.value.size(), 0u);
+    }
+
+    Remove(name);
+}
+
+TEST(ExecTest, OutputAndExitStatus) {
+    auto out = exec::Command("echo", {"hello", "world"})->Output();
+    ASSERT_TRUE(out.Ok()) << out.err->error();
+    EXPECT_EQ(out.value, "hello world\n");
+
+    auto both = exec::Command("sh", {"-c", "echo out; echo err >&2"})->CombinedOutput();
+    ASSERT_TRUE(both.Ok());
+    EXPECT_EQ(both.value, "out\nerr\n");
+
+    auto cmd = exec::Command("sh", {"-c", "echo oops >&2; exit 3"});
+    auto failed = cmd->Output();
+    std::shared_ptr<exec::ExitError> exitErr;
+    ASSERT_TRUE(gocxx::errors::As(failed.err, exitErr));
+    EXPECT_EQ(exitErr->ExitCode(), 3);
+    EXPECT_EQ(exitErr->error(), "exit status 3");
+    EXPECT_EQ(exitErr->stderr_output, "oops\n");
+    EXPECT_EQ(cmd->process_state->exitCode, 3);
+
+    auto missing = exec::Command("gocxx-no-such-program")->Run();
+    EXPECT_TRUE(gocxx::errors::Is(missing.err, exec::ErrNotFound));
+    EXPECT_TRUE(exec::LookPath("sh").Ok());
+}
+
+TEST(ExecTest, StreamsThroughPipes) {
+    // stdin from a Reader, stdout read from the pipe as the child writes
+    auto cmd = exec::Command("tr", {"a-z", "A-Z"});
+    cmd->std_in = std::make_shared<gocxx::bytes::Buffer>(std::string(100000, 'x'));
+    auto stdoutPipe = cmd->StdoutPipe();
+    ASSERT_TRUE(stdoutPipe.Ok());
+    EXPECT_TRUE(cmd->StdoutPipe().Failed());
+    ASSERT_TRUE(cmd->Start().Ok());
+    EXPECT_GT(cmd->Pid(), 0);
+    EXPECT_TRUE(cmd->Start().Failed());
+
+    auto sink = std::make_shared<gocxx::bytes::Buffer>();
+    auto copied = gocxx::io::Copy(sink, stdoutPipe.value);
+    ASSERT_TRUE(copied.Ok());
+    EXPECT_EQ(copied.value, 100000u);
+    EXPECT_EQ(sink->String(), std::string(100000, 'X'));
+    EXPECT_TRUE(cmd->Wait().Ok());
+    EXPECT_TRUE(cmd->Wait().Failed());
+
+    // stdin written through its pipe, stdout straight into a File
+    const std::string name = TempDir() + "/gocxx_exec_out.txt";
+    auto created = Create(name);
+    ASSERT_TRUE(created.Ok());
+    auto cat = exec::Command("cat");
+    cat->std_out = created.value;
+    auto in = cat->StdinPipe().value;
+    ASSERT_TRUE(cat->Start().Ok());
+    const std::string text = "through a pipe\n";
+    ASSERT_TRUE(in->Write(reinterpret_cast<const uint8_t*>(text.data()), text.size()).Ok());
+    in->close();
+    ASSERT_TRUE(cat->Wait().Ok());
+    created.value->close();
+    auto written = ReadFile(name).value;
+    EXPECT_EQ(std::string(written.begin(), written.end()), text);
+    Remove(name);
+}
+
+TEST(ExecTest, ContextKillsAndManyChildrenAreReaped) {
+    auto timed = gocxx::context::WithTimeout(gocxx::context::Background(), gocxx::time::Milliseconds(100));
+    auto ctx = timed.value.first;
+    auto cmd = exec::CommandContext(ctx, "sleep", {"10"});
+    const auto start = std::chrono::steady_clock::now();
+    auto done = cmd->Run();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+    ASSERT_TRUE(done.Failed());
+    EXPECT_EQ(done.err->error(), gocxx::context::DeadlineExceeded);
+    EXPECT_FALSE(cmd->process_state->exited);
+    EXPECT_EQ(cmd->process_state->signal, SIGKILL);
+    EXPECT_TRUE(cmd->Kill().Failed());  // already reaped
+    timed.value.second();
+
+    std::vector<std::shared_ptr<exec::Cmd>> cmds;
+    for (int i = 0; i < 20; ++i) {
+        cmds.push_back(exec::Command("sh", {"-c", "exit " + std::to_string(i % 2)}));
+        ASSERT_TRUE(cmds.back()->Start().Ok());
+    }
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(cmds[i]->Wait().Ok(), i % 2 == 0);
+        EXPECT_EQ(cmds[i]->process_state->exitCode, i % 2);
+    }
+}
+
+
+TEST(ExecTest, ReusedPidsStayWatched) {
+    // A reaped child's pid may go straight to the next child; every Wait still returns
+    std::vector<std::thread> spawners;
+    std::atomic<int> waited{0};
+    for (int t = 0; t < 4; ++t) {
+        spawners.emplace_back([&] {
+            for (int i = 0; i < 25; ++i) {
+                auto cmd = exec::Command("true");
+                if (cmd->Start().Ok() && cmd->Wait().Ok()) {
+                    ++waited;
+                }
+            }
+        });
+    }
+    for (auto& spawner : spawners) {
+        spawner.join();
+    }
+    EXPECT_EQ(waited.load(), 100);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gocxx/pipeline/pipeline.h>
+
+using namespace gocxx;
+
+namespace {
+
+base::Chan<int> numbers(int n) {
+    base::Chan<int> ch(16);
+    gocxx::go([ch, n]() mutable {
+        for (int i = 0; i < n; ++i) ch << i;
+        ch.close();
+    });
+    return ch;
+}
+
+template<typename T>
+std::vector<T> collect(base::Chan<T> ch) {
+    std::vector<T> out;
+    while (auto v = ch.recv()) out.push_back(std::move(*v));
+    return out;
+}
+
+} // namespace
+
+TEST(PipelineTest, FanOutAndMergeDeliverEveryValue) {
+    auto ctx = context::Background();
+    auto outs = pipeline::FanOut(ctx, numbers(1000), 4, [](int v) { return v * 2; });
+    ASSERT_EQ(outs.size(), 4u);
+    auto got = collect(pipeline::Merge(ctx, outs));
+    std::sort(got.begin(), got.end());
+    ASSERT_EQ(got.size(), 1000u);
+    for (int i = 0; i < 1000; ++i) EXPECT_EQ(got[i], i * 2);
+}
+
+TEST(PipelineTest, VariadicMergeClosesWhenAllInputsClose) {
+    auto ctx = context::Background();
+    base::Chan<std::string> a(2), b(2);
+    a << std::string("a1");
+    b << std::string("b1") << std::string("b2");
+    a.close();
+    b.close();
+    auto got = collect(pipeline::Merge(ctx, a, b));
+    std::sort(got.begin(), got.end());
+    EXPECT_EQ(got, (std::vector<std::string>{"a1", "b1", "b2"}));
+}
+
+TEST(PipelineTest, OrderedParallelMapKeepsInputOrder) {
+    auto ctx = context::Background();
+    auto out = pipeline::ParallelMap(ctx, numbers(500), 8, [](int v) {
+        if (v % 50 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return std::to_string(v);
+    });
+    auto got = collect(out);
+    ASSERT_EQ(got.size(), 500u);
+    for (int i = 0; i < 500; ++i) EXPECT_EQ(got[i], std::to_string(i));
+}
+
+TEST(PipelineTest, OrderedWindowLetsFastItemsPassSlowOne) {
+    auto ctx = context::Background();
+    std::atomic<int> started{0};
+    base::Chan<bool> release;
+    // Item 0 is stuck until the others have been handed to workers, which
+    // only happens if the window lets dispatch run ahead of emission.
+    auto out = pipeline::ParallelMap(ctx, numbers(20), 4, [&](int v) {
+        started.fetch_add(1);
+        if (v == 0) release.recv();  // blocking hands the worker's processor on
+        return v;
+    }, true, 16);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (started.load() < 16 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_GE(started.load(), 16);
+    release.close();
+    auto got = collect(out);
+    std::vector<int> want(20);
+    std::iota(want.begin(), want.end(), 0);
+    EXPECT_EQ(got, want);
+}
+
+TEST(PipelineTest, UnorderedParallelMapDeliversEverything) {
+    auto ctx = context::Background();
+    auto got = collect(pipeline::ParallelMap(ctx, numbers(300), 3, [](int v) { return v + 1; }, false));
+    std::sort(got.begin(), got.end());
+    ASSERT_EQ(got.size(), 300u);
+    EXPECT_EQ(got.front(), 1);
+    EXPECT_EQ(got.back(), 300);
+}
+
+TEST(PipelineTest, CancellationStopsStagesAndClosesOutput) {
+    auto res = context::WithCancel(context::Background());
+    ASSERT_TRUE(res.Ok());
+    auto ctx = res.value.first;
+    auto cancel = res.value.second;
+
+    base::Chan<int> endless;  // never closed
+    auto out = pipeline::ParallelMap(ctx, endless, 2, [](int v) { return v; });
+    cancel();
+    auto done = std::async(std::launch::async, [out]() mutable { return collect(out); });
+    EXPECT_EQ(done.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+}
+
+TEST(PipelineTest, BatchFlushesOnSizeAndOnDelay) {
+    auto ctx = context::Background();
+    base::Chan<int> in(16);
+    auto batches = pipeline::Batch(ctx, in, 3, time::Milliseconds(30));
+
+    for (int i = 0; i < 4; ++i) in << i;
+    auto first = batches.recv();
+    ASSERT_TRUE(first);
+    EXPECT_EQ(*first, (std::vector<int>{0, 1, 2}));
+
+    auto start = std::chrono::steady_clock::now();
+    auto partial = batches.recv();  // only one value left: flushed by the timer
+    ASSERT_TRUE(partial);
+    EXPECT_EQ(*partial, (std::vector<int>{3}));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(15));
+
+    in << 9;
+    in.close();
+    auto last = batches.recv();
+    ASSERT_TRUE(last);
+    EXPECT_EQ(*last, (std::vector<int>{9}));
+    EXPECT_FALSE(batches.recv());
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+#include <gocxx/base/chan.h>
+#include <gocxx/runtime/deque.h>
+#include <gocxx/runtime/runtime.h>
+#include <gocxx/sync/waitgroup.h>
+#include <gocxx/time/time.h>
+
+using namespace gocxx;
+
+namespace {
+
+// Poll instead of blocking so a scheduler bug fails the test instead of hanging it.
+template<typename Pred>
+bool eventually(Pred pred, std::chrono::milliseconds timeout = std::chrono::seconds(10)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(WorkStealingDequeTest, OwnerIsLifoThiefIsFifo) {
+    runtime::WorkStealingDeque<int*> dq(2);
+    int items[5];
+    for (auto& i : items) dq.push(&i);  // forces two grows
+    EXPECT_EQ(dq.sizeApprox(), 5u);
+
+    int* out = nullptr;
+    ASSERT_TRUE(dq.steal(out));
+    EXPECT_EQ(out, &items[0]);
+    ASSERT_TRUE(dq.pop(out));
+    EXPECT_EQ(out, &items[4]);
+    EXPECT_EQ(dq.sizeApprox(), 3u);
+
+    while (dq.pop(out)) {}
+    EXPECT_TRUE(dq.emptyApprox());
+    EXPECT_FALSE(dq.steal(out));
+}
+
+TEST(WorkStealingDequeTest, EveryItemTakenExactlyOnce) {
+    constexpr int kItems = 20000;
+    std::vector<int> values(kItems);
+    runtime::WorkStealingDeque<int*> dq(64);
+    std::atomic<bool> done{false};
+    std::atomic<int> taken{0};
+    std::vector<std::atomic<int>> seen(kItems);
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&] {
+            int* p = nullptr;
+            while (!done.load() || !dq.emptyApprox()) {
+                if (dq.steal(p)) {
+                    seen[p - values.data()].fetch_add(1);
+                    taken.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    int* p = nullptr;
+    for (int i = 0; i < kItems; ++i) {
+        dq.push(&values[i]);
+        if (i % 3 == 0 && dq.pop(p)) {
+            seen[p - values.data()].fetch_add(1);
+            taken.fetch_add(1);
+        }
+    }
+    while (dq.pop(p)) {
+        seen[p - values.data()].fetch_add(1);
+        taken.fetch_add(1);
+    }
+    done.store(true);
+    for (auto& t : thieves) t.join();
+
+    EXPECT_EQ(taken.load(), kItems);
+    for (auto& s : seen) EXPECT_EQ(s.load(), 1);
+}
+
+TEST(RuntimeTest, GoRunsTasksAndWaitGroupWaits) {
+    sync::WaitGroup wg;
+    std::atomic<int> sum{0};
+    wg.Add(100);
+    for (int i = 1; i <= 100; ++i) {
+        go([&, i] {
+            sum.fetch_add(i);
+            wg.Done();
+        });
+    }
+    wg.Wait();
+    EXPECT_EQ(sum.load(), 5050);
+}
+
+TEST(RuntimeTest, GoForwardsArguments) {
+    base::Chan<int> results(1);
+    go([](base::Chan<int> out, int a, int b) { out << a * b; }, results, 6, 7);
+    int v = 0;
+    results >> v;
+    EXPECT_EQ(v, 42);
+}
+
+TEST(RuntimeTest, HundredThousandTasksUseFewThreads) {
+    constexpr int kTasks = 100000;
+    std::atomic<int> ran{0};
+    for (int i = 0; i < kTasks; ++i) {
+        go([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+    }
+    ASSERT_TRUE(eventually([&] { return ran.load() == kTasks; }));
+
+    auto stats = runtime::Stats();
+    EXPECT_LE(stats.threads, 2 * stats.processors + stats.blockedThreads);
+    EXPECT_GE(stats.spawned, static_cast<std::uint64_t>(kTasks));
+}
+
+TEST(RuntimeTest, NestedSpawnsComplete) {
+    std::atomic<int> leaves{0};
+    for (int i = 0; i < 8; ++i) {
+        go([&] {
+            for (int j = 0; j < 64; ++j) {
+                go([&] { leaves.fetch_add(1); });
+            }
+        });
+    }
+    ASSERT_TRUE(eventually([&] { return leaves.load() == 8 * 64; }));
+}
+
+TEST(RuntimeTest, BlockedChannelReceiversDoNotPinWorkers) {
+    // More blocked receivers than processors: the sender can only run if
+    // each receiver handed its processor on while parked.
+    const int receivers = runtime::GOMAXPROCS() + 4;
+    base::Chan<int> ch;
+    std::atomic<int> got{0};
+    for (int i = 0; i < receivers; ++i) {
+        go([&, ch]() mutable {
+            int v = 0;
+            ch >> v;
+            got.fetch_add(v);
+        });
+    }
+    go([&, ch]() mutable {
+        for (int i = 0; i < receivers; ++i) ch << 1;
+    });
+    ASSERT_TRUE(eventually([&] { return got.load() == receivers; }));
+    EXPECT_GT(runtime::Stats().handoffs, 0u);
+}
+
+TEST(RuntimeTest, SleepingTasksDoNotStarveOthers) {
+    const int sleepers = runtime::GOMAXPROCS() + 2;
+    std::atomic<int> woke{0};
+    std::atomic<bool> quickRan{false};
+    for (int i = 0; i < sleepers; ++i) {
+        go([&] {
+            time::Sleep(time::Duration(50 * time::Duration::Millisecond));
+            woke.fetch_add(1);
+        });
+    }
+    go([&] { quickRan.store(true); });
+    ASSERT_TRUE(eventually([&] { return quickRan.load(); }, std::chrono::milliseconds(40)));
+    ASSERT_TRUE(eventually([&] { return woke.load() == sleepers; }));
+}
+
+TEST(RuntimeTest, NumGoroutineDropsToZero) {
+    base::Chan<bool> release;
+    for (int i = 0; i < 4; ++i) {
+        go([release]() mutable { release.recv(); });
+    }
+    EXPECT_GE(runtime::NumGoroutine(), 1);
+    release.close();
+    EXPECT_TRUE(eventually([] { return runtime::NumGoroutine() == 0; }));
+}
+
+TEST(RuntimeTest, ThreadsReportWhatEachThreadWaitsFor) {
+    base::Chan<int> never;
+    std::thread receiver([&] { never.recv(); });
+    sync::WaitGroup wg;
+    wg.Add(1);
+    base::Chan<bool> release;
+    go([&] {
+        release.recv();
+        wg.Done();
+    });
+
+    auto waitingOn = [](runtime::WaitReason reason, bool worker) {
+        for (const auto& t : runtime::Threads()) {
+            if (t.waitReason == reason && t.worker == worker) return true;
+        }
+        return false;
+    };
+    EXPECT_TRUE(eventually([&] { return waitingOn(runtime::WaitReason::ChanRecv, false); }));
+    EXPECT_TRUE(eventually([&] {
+        for (const auto& t : runtime::Threads()) {
+            if (t.worker && t.task != 0 && t.waitReason == runtime::WaitReason::ChanRecv) return true;
+        }
+        return false;
+    }));
+    EXPECT_STREQ(runtime::WaitReasonName(runtime::WaitReason::ChanRecv), "chan receive");
+
+    never.close();
+    receiver.join();
+    release.close();
+    wg.Wait();
+}
@@ -1,11 +1,19 @@
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <thread>
 #include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
 #include "gocxx/sync/sync.h"
+#include "gocxx/sync/errgroup.h"
+#include "gocxx/sync/semaphore.h"
+#include "gocxx/sync/singleflight.h"
+#include "gocxx/time/time.h"
 
 using namespace gocxx::sync;
 
@@ -248,4 +256,550 @@ TEST(WaitGroupTest, ParallelTasksComplete) {
     }
     
     EXPECT_EQ(shared.load(), 5);
-}
\ No newline at end of file
+}
+
+TEST(WaitGroupTest, ManyWaitersReleasedTogether) {
+    WaitGroup wg;
+    wg.Add(1);
+    std::atomic<int> released{0};
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 8; ++i) {
+        waiters.emplace_back([&] {
+            wg.Wait();
+            released++;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(released.load(), 0);
+    wg.Done();
+    for (auto& t : waiters) t.join();
+    EXPECT_EQ(released.load(), 8);
+}
+
+TEST(WaitGroupTest, ReusableAndRejectsNegativeCounter) {
+    WaitGroup wg;
+    wg.Wait();  // zero: returns immediately
+    for (int round = 0; round < 200; ++round) {
+        wg.Add(4);
+        std::vector<std::thread> workers;
+        for (int i = 0; i < 4; ++i) workers.emplace_back([&] { wg.Done(); });
+        wg.Wait();
+        for (auto& t : workers) t.join();
+    }
+    EXPECT_THROW(wg.Done(), std::runtime_error);
+}
+
+TEST(CondTest, ProducerConsumerHandoffsAreNotLost) {
+    Cond cond;
+    Mutex mtx;
+    int items = 0;
+    int consumed = 0;
+    constexpr int kItems = 20000;
+
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 3; ++i) {
+        consumers.emplace_back([&] {
+            UniqueLock lock(mtx);
+            for (;;) {
+                while (items == 0 && consumed < kItems) cond.Wait(lock);
+                if (consumed == kItems) return;
+                --items;
+                ++consumed;
+                if (consumed == kItems) cond.NotifyAll();
+            }
+        });
+    }
+    for (int i = 0; i < kItems; ++i) {
+        {
+            Lock lock(mtx);
+            ++items;
+        }
+        cond.NotifyOne();
+    }
+    for (auto& t : consumers) t.join();
+    EXPECT_EQ(consumed, kItems);
+}
+
+TEST(PoolTest, IdleObjectsAreReleasedAfterTwoCycles) {
+    SetPoolCleanupInterval(std::chrono::nanoseconds(0));  // only the explicit cycles below
+    std::atomic<int> created{0};
+    Pool<Dummy> pool([&] {
+        created++;
+        return std::make_shared<Dummy>();
+    });
+
+    auto d = pool.Get();
+    std::weak_ptr<Dummy> watch = d;
+    pool.Put(std::move(d));
+
+    pool.Trim();  // moved to the victim cache, still reusable
+    EXPECT_FALSE(watch.expired());
+    auto again = pool.Get();
+    EXPECT_EQ(created, 1);
+    pool.Put(std::move(again));
+
+    pool.Trim();
+    pool.Trim();
+    EXPECT_TRUE(watch.expired());
+    pool.Get();
+    EXPECT_EQ(created, 2);
+    SetPoolCleanupInterval(std::chrono::seconds(2));
+}
+
+TEST(PoolTest, StatsCountHitsAndMisses) {
+    Pool<Dummy> pool([] { return std::make_shared<Dummy>(); });
+    pool.SetName("test.dummies");
+
+    auto a = pool.Get();  // miss
+    pool.Put(std::move(a));
+    auto b = pool.Get();  // hit
+    pool.Put(std::move(b));
+
+    PoolStats st = pool.Stats();
+    EXPECT_EQ(st.name, "test.dummies");
+    EXPECT_EQ(st.gets, 2u);
+    EXPECT_EQ(st.misses, 1u);
+    EXPECT_EQ(st.idle, 1u);
+    EXPECT_DOUBLE_EQ(st.HitRate(), 0.5);
+
+    auto listed = ListPools();
+    EXPECT_TRUE(std::any_of(listed.begin(), listed.end(),
+                            [](const PoolStats& p) { return p.name == "test.dummies" && p.gets == 2; }));
+}
+
+TEST(PoolTest, UniquePoolReusesWithoutSharedOwnership) {
+    int created = 0;
+    UniquePool<Dummy> pool([&] {
+        created++;
+        return std::make_unique<Dummy>();
+    });
+
+    auto d = pool.Get();
+    Dummy* raw = d.get();
+    d->value = 7;
+    pool.Put(std::move(d));
+    auto e = pool.Get();
+    EXPECT_EQ(e.get(), raw);
+    EXPECT_EQ(e->value, 7);
+    EXPECT_EQ(created, 1);
+}
+
+TEST(PoolTest, GetStealsObjectsPutByOtherThreads) {
+    std::atomic<int> created{0};
+    UniquePool<Dummy> pool([&] {
+        created++;
+        return std::make_unique<Dummy>();
+    });
+
+    std::thread producer([&] {
+        std::vector<std::unique_ptr<Dummy>> items;
+        for (int i = 0; i < 8; ++i) items.push_back(pool.Get());
+        for (auto& item : items) pool.Put(std::move(item));
+    });
+    producer.join();
+    EXPECT_EQ(created, 8);
+
+    std::vector<std::unique_ptr<Dummy>> taken;
+    for (int i = 0; i < 8; ++i) taken.push_back(pool.Get());
+    // Everything but the producer's private slot is stealable.
+    EXPECT_LE(created, 9);
+}
+
+TEST(PoolTest, EmptyPoolWithoutNewReturnsNull) {
+    Pool<Dummy> pool(nullptr);
+    EXPECT_EQ(pool.Get(), nullptr);
+    pool.Put(nullptr);
+    EXPECT_EQ(pool.Get(), nullptr);
+}
+
+TEST(PoolTest, ConcurrentGetPutAndTrim) {
+    std::atomic<int> created{0};
+    std::atomic<int> destroyed{0};
+    struct Counted {
+        explicit Counted(std::atomic<int>* d) : destroyed(d) {}
+        ~Counted() { destroyed->fetch_add(1); }
+        std::atomic<int>* destroyed;
+    };
+    {
+        UniquePool<Counted> pool([&] {
+            created++;
+            return std::make_unique<Counted>(&destroyed);
+        });
+        std::atomic<bool> stop{false};
+        std::thread trimmer([&] {
+            while (!stop) {
+                TrimPools();
+                std::this_thread::yield();
+            }
+        });
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([&] {
+                for (int j = 0; j < 2000; ++j) {
+                    auto a = pool.Get();
+                    auto b = pool.Get();
+                    pool.Put(std::move(a));
+                    pool.Put(std::move(b));
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        stop = true;
+        trimmer.join();
+    }
+    EXPECT_EQ(created.load(), destroyed.load());
+}
+
+TEST(ProfiledMutexTest, RecordsContentionPerCallSite) {
+    ResetMutexProfile();
+    int previous = SetMutexProfileFraction(1);
+    ProfiledMutex mu("profiled.mu");
+    std::atomic<bool> held{false};
+
+    std::thread holder([&] {
+        ProfiledUniqueLock lock(mu);
+        held = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    });
+    while (!held) std::this_thread::yield();
+    int waitLine = __LINE__ + 1;
+    { ProfiledUniqueLock lock(mu); }
+    holder.join();
+    SetMutexProfileFraction(previous);
+
+    bool foundWaiter = false;
+    bool foundHolder = false;
+    for (const auto& r : MutexProfile()) {
+        if (r.mutex != "profiled.mu") continue;
+        if (r.line == waitLine) {
+            foundWaiter = true;
+            EXPECT_EQ(r.contentions, 1u);
+            EXPECT_GE(r.waitNs, 10'000'000u);
+        } else {
+            foundHolder = true;
+            EXPECT_GE(r.holdNs, 20'000'000u);
+        }
+        EXPECT_NE(r.file.find("sync_test.cpp"), std::string::npos);
+    }
+    EXPECT_TRUE(foundWaiter);
+    EXPECT_TRUE(foundHolder);
+}
+
+TEST(ProfiledMutexTest, DisabledProfilingRecordsNothing) {
+    ResetMutexProfile();
+    SetMutexProfileFraction(0);
+    ProfiledRWMutex rw("profiled.rw");
+    {
+        ProfiledWriteLock w(rw);
+    }
+    {
+        ProfiledReadLock r1(rw);
+        ProfiledReadLock r2(rw);
+    }
+    std::lock_guard<ProfiledRWMutex> plain(rw);
+    EXPECT_TRUE(MutexProfile().empty());
+}
+
+TEST(ProfiledMutexTest, ReadLocksAndSampling) {
+    ResetMutexProfile();
+    int previous = SetMutexProfileFraction(4);
+    EXPECT_EQ(SetMutexProfileFraction(-1), 4);
+    ProfiledRWMutex rw("profiled.sampled");
+    for (int i = 0; i < 4000; ++i) {
+        rw.RLock();
+        rw.RUnlock();
+    }
+    SetMutexProfileFraction(previous);
+
+    std::uint64_t samples = 0;
+    for (const auto& r : MutexProfile()) {
+        if (r.mutex == "profiled.sampled") {
+            EXPECT_TRUE(r.shared);
+            samples += r.samples;
+        }
+    }
+    EXPECT_GT(samples, 500u);
+    EXPECT_LT(samples, 1500u);
+}
+
+TEST(MapTest, LoadStoreDeleteAndSwap) {
+    Map<std::string, int> m;
+    EXPECT_FALSE(m.Load("a").has_value());
+    m.Store("a", 1);
+    ASSERT_TRUE(m.Load("a").has_value());
+    EXPECT_EQ(*m.Load("a"), 1);
+
+    auto prev = m.Swap("a", 2);
+    ASSERT_TRUE(prev.has_value());
+    EXPECT_EQ(*prev, 1);
+    EXPECT_FALSE(m.Swap("b", 7).has_value());
+
+    auto deleted = m.LoadAndDelete("a");
+    ASSERT_TRUE(deleted.has_value());
+    EXPECT_EQ(*deleted, 2);
+    EXPECT_FALSE(m.Load("a").has_value());
+    m.Delete("b");
+    m.Delete("missing");
+    EXPECT_FALSE(m.Load("b").has_value());
+}
+
+TEST(MapTest, LoadOrStoreAndCompareOperations) {
+    Map<int, std::string> m;
+    auto first = m.LoadOrStore(1, "one");
+    EXPECT_EQ(first.first, "one");
+    EXPECT_FALSE(first.second);
+    auto second = m.LoadOrStore(1, "uno");
+    EXPECT_EQ(second.first, "one");
+    EXPECT_TRUE(second.second);
+
+    EXPECT_FALSE(m.CompareAndSwap(1, "uno", "eins"));
+    EXPECT_TRUE(m.CompareAndSwap(1, "one", "eins"));
+    EXPECT_EQ(*m.Load(1), "eins");
+    EXPECT_FALSE(m.CompareAndSwap(2, "", "x"));
+
+    EXPECT_FALSE(m.CompareAndDelete(1, "one"));
+    EXPECT_TRUE(m.CompareAndDelete(1, "eins"));
+    EXPECT_FALSE(m.Load(1).has_value());
+}
+
+TEST(MapTest, KeysSurviveRepeatedPromotion) {
+    Map<int, int> m;
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 200; ++i) m.Store(round * 1000 + i, i);
+        // Misses against the snapshot promote the dirty map.
+        for (int j = 0; j < 400; ++j) m.Load(-1 - j);
+        for (int i = 0; i < 200; i += 2) m.Delete(round * 1000 + i);
+    }
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 200; ++i) {
+            auto v = m.Load(round * 1000 + i);
+            if (i % 2 == 0) {
+                EXPECT_FALSE(v.has_value());
+            } else {
+                ASSERT_TRUE(v.has_value());
+                EXPECT_EQ(*v, i);
+            }
+        }
+    }
+    // A deleted key written again after the snapshot expunged it comes back.
+    m.Store(0, 42);
+    EXPECT_EQ(*m.Load(0), 42);
+}
+
+TEST(MapTest, RangeVisitsEveryKeyOnceAndStopsEarly) {
+    Map<int, int> m;
+    for (int i = 0; i < 100; ++i) m.Store(i, i * i);
+    std::vector<int> seen(100, 0);
+    m.Range([&](const int& k, const int& v) {
+        EXPECT_EQ(v, k * k);
+        ++seen[k];
+        return true;
+    });
+    for (int c : seen) EXPECT_EQ(c, 1);
+
+    int visited = 0;
+    m.Range([&](const int&, const int&) { return ++visited < 10; });
+    EXPECT_EQ(visited, 10);
+}
+
+TEST(MapTest, ConcurrentReadersAndWriters) {
+    Map<int, int> m;
+    constexpr int kKeys = 64;
+    for (int i = 0; i < kKeys; ++i) m.Store(i, i);
+
+    std::atomic<bool> stop{false};
+    std::atomic<bool> bad{false};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                for (int i = 0; i < kKeys; ++i) {
+                    auto v = m.Load(i);
+                    if (v && (*v < 0 || *v % kKeys != i % kKeys)) bad = true;
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w) {
+        writers.emplace_back([&, w] {
+            for (int n = 1; n <= 2000; ++n) {
+                int key = (n * 7 + w) % kKeys;
+                m.Store(key, key + kKeys * n);
+                if (n % 5 == 0) m.Delete(key);
+                if (n % 11 == 0) m.LoadOrStore(kKeys + n % 32, kKeys + n % 32);
+            }
+        });
+    }
+    for (auto& t : writers) t.join();
+    stop = true;
+    for (auto& t : readers) t.join();
+    EXPECT_FALSE(bad.load());
+
+    int count = 0;
+    m.Range([&](const int&, const int&) { return ++count, true; });
+    EXPECT_GT(count, 0);
+}
+
+TEST(ErrGroupTest, WaitReturnsFirstErrorAndCancelsContext) {
+    auto [group, ctx] = ErrGroup::WithContext(gocxx::context::Background());
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 8; ++i) {
+        group->Go([&ran, i] {
+            ++ran;
+            if (i == 3) return gocxx::base::Result<void>(gocxx::errors::New("task 3 failed"));
+            return gocxx::base::Result<void>();
+        });
+    }
+    auto r = group->Wait();
+    ASSERT_TRUE(r.Failed());
+    EXPECT_STREQ(r.err->what(), "task 3 failed");
+    EXPECT_EQ(ran.load(), 8);
+    EXPECT_TRUE(ctx->Err().Failed());
+}
+
+TEST(ErrGroupTest, LimitBoundsConcurrencyAndTryGo) {
+    ErrGroup group;
+    group.SetLimit(2);
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    gocxx::base::Chan<bool> release;
+    for (int i = 0; i < 2; ++i) {
+        group.Go([&] {
+            int now = ++running;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            release.recv();
+            --running;
+            return gocxx::base::Result<void>();
+        });
+    }
+    EXPECT_FALSE(group.TryGo([] { return gocxx::base::Result<void>(); }));
+    EXPECT_THROW(group.SetLimit(4), std::logic_error);
+    release.close();
+
+    for (int i = 0; i < 6; ++i) {
+        group.Go([&] {
+            int now = ++running;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            gocxx::time::Sleep(gocxx::time::Milliseconds(1));
+            --running;
+            return gocxx::base::Result<void>();
+        });
+    }
+    EXPECT_TRUE(group.Wait().Ok());
+    EXPECT_LE(peak.load(), 2);
+    EXPECT_TRUE(group.TryGo([] { return gocxx::base::Result<void>(); }));
+    EXPECT_TRUE(group.Wait().Ok());
+}
+
+TEST(SemaphoreTest, WeightedAcquireServesWaitersInOrder) {
+    Semaphore sem(4);
+    EXPECT_TRUE(sem.Acquire(nullptr, 3).Ok());
+    EXPECT_FALSE(sem.TryAcquire(2));
+
+    gocxx::base::Chan<int> order(3);
+    WaitGroup wg;
+    wg.Add(2);
+    std::thread big([&] {
+        EXPECT_TRUE(sem.Acquire(nullptr, 4).Ok());
+        order.send(4);
+        sem.Release(4);
+        wg.Done();
+    });
+    // Once big is queued even a weight-1 TryAcquire fails.
+    while (sem.TryAcquire(1)) {
+        sem.Release(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::thread small([&] {
+        // Fits right now, but must not overtake the queued weight-4 request.
+        EXPECT_TRUE(sem.Acquire(nullptr, 1).Ok());
+        order.send(1);
+        sem.Release(1);
+        wg.Done();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sem.Release(3);
+    wg.Wait();
+    big.join();
+    small.join();
+    EXPECT_EQ(*order.recv(), 4);
+    EXPECT_EQ(*order.recv(), 1);
+    EXPECT_THROW(sem.Release(1), std::logic_error);
+}
+
+TEST(SemaphoreTest, AcquireGivesUpWhenContextIsCanceled) {
+    Semaphore sem(1);
+    ASSERT_TRUE(sem.TryAcquire());
+    auto r = gocxx::context::WithCancel(gocxx::context::Background());
+    auto ctx = r.value.first;
+    std::thread canceler([cancel = r.value.second] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        cancel();
+    });
+    EXPECT_TRUE(sem.Acquire(ctx).Failed());
+    canceler.join();
+    EXPECT_TRUE(sem.Acquire(ctx).Failed());  // already done: fails fast
+    sem.Release();
+    EXPECT_TRUE(sem.TryAcquire());
+}
+
+TEST(SingleFlightTest, DuplicateCallsShareOneExecution) {
+    SingleFlight<std::string, int> group;
+    std::atomic<int> calls{0};
+    gocxx::base::Chan<bool> release;
+    gocxx::base::Chan<bool> started(1);
+
+    auto first = group.DoChan("k", [&] {
+        ++calls;
+        started.send(true);
+        release.recv();
+        return gocxx::base::Result<int>(42);
+    });
+    started.recv();
+    std::vector<gocxx::base::Chan<FlightResult<int>>> joined;
+    for (int i = 0; i < 5; ++i) {
+        joined.push_back(group.DoChan("k", [&] { ++calls; return gocxx::base::Result<int>(0); }));
+    }
+    release.close();
+
+    auto r = first.recv();
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->value, 42);
+    EXPECT_TRUE(r->shared);
+    for (auto& ch : joined) {
+        auto j = ch.recv();
+        ASSERT_TRUE(j.has_value());
+        EXPECT_EQ(j->value, 42);
+    }
+    EXPECT_EQ(calls.load(), 1);
+
+    // The call is over, so the next one runs again.
+    auto again = group.Do("k", [&] { ++calls; return gocxx::base::Result<int>(7); });
+    EXPECT_EQ(again.value, 7);
+    EXPECT_FALSE(again.shared);
+    EXPECT_EQ(calls.load(), 2);
+}
+
+TEST(SingleFlightTest, ErrorsAreSharedAndForgetStartsFresh) {
+    SingleFlight<int, int> group;
+    gocxx::base::Chan<bool> release;
+    gocxx::base::Chan<bool> started(1);
+    auto first = group.DoChan(1, [&] {
+        started.send(true);
+        release.recv();
+        return gocxx::base::Result<int>(gocxx::errors::New("backend down"));
+    });
+    started.recv();
+    group.Forget(1);
+    auto fresh = group.Do(1, [] { return gocxx::base::Result<int>(5); });
+    EXPECT_TRUE(fresh.Ok());
+    EXPECT_EQ(fresh.value, 5);
+    release.close();
+    auto r = first.recv();
+    ASSERT_TRUE(r.has_value());
+    EXPECT_TRUE(r->Failed());
+    EXPECT_STREQ(r->err->what(), "backend down");
+}
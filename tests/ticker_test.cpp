@@ -4,6 +4,9 @@
 #include "gocxx/time/time.h"
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
 
 using namespace gocxx::time;
 using namespace std::chrono;
@@ -151,3 +154,87 @@ TEST_F(DurationTest, Comparisons) {
     EXPECT_TRUE(d1 == d3);
     EXPECT_TRUE(d1 != d2);
 }
+
+TEST(TimerTest, ManyTimersFireInDeadlineOrder) {
+    constexpr int kTimers = 200;
+    std::vector<std::unique_ptr<Timer>> timers;
+    for (int i = kTimers - 1; i >= 0; --i) {
+        timers.push_back(NewTimer(Duration((i % 20) * Duration::Millisecond)));
+    }
+    // Every other timer is stopped; those stopped in time must never fire.
+    std::vector<bool> stopped(kTimers, false);
+    for (int i = 0; i < kTimers; i += 2) stopped[i] = timers[i]->Stop();
+    EXPECT_GT(std::count(stopped.begin(), stopped.end(), true), 0);
+    for (int i = 1; i < kTimers; i += 2) {
+        ASSERT_TRUE(timers[i]->C()->recv().has_value());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    for (int i = 0; i < kTimers; i += 2) {
+        if (stopped[i]) {
+            EXPECT_FALSE(timers[i]->C()->tryRecv().Ok());
+        }
+    }
+}
+
+TEST(TimerTest, ResetKeepsChannelAndDropsStaleExpiry) {
+    auto timer = NewTimer(Duration(Duration::Millisecond));
+    auto ch = timer->C();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(timer->Stop());  // already fired, value still buffered
+
+    auto start = Time::Now();
+    EXPECT_FALSE(timer->Reset(Duration(50 * Duration::Millisecond)));
+    EXPECT_EQ(timer->C(), ch);
+    ASSERT_TRUE(ch->recv().has_value());
+    EXPECT_GE(Time::Now().Sub(start).Milliseconds(), 40);
+
+    EXPECT_FALSE(timer->Reset(Duration(Duration::Second)));
+    EXPECT_TRUE(timer->Reset(Duration(10 * Duration::Millisecond)));  // moved earlier
+    ASSERT_TRUE(ch->recv().has_value());
+    EXPECT_LE(Time::Now().Sub(start).Milliseconds(), 500);
+}
+
+TEST(TickerTest, SlowReceiverDropsTicksAndResetChangesPeriod) {
+    auto ticker = NewTicker(Duration(5 * Duration::Millisecond));
+    auto ch = ticker->C();
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    ASSERT_TRUE(ch->tryRecv().Ok());
+    EXPECT_FALSE(ch->tryRecv().Ok());  // only one tick was buffered
+
+    ticker->Reset(Duration(200 * Duration::Millisecond));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));  // let an in-flight tick land
+    ch->tryRecv();
+    auto start = Time::Now();
+    ASSERT_TRUE(ch->recv().has_value());
+    EXPECT_GE(Time::Now().Sub(start).Milliseconds(), 100);
+    ticker->Stop();
+    EXPECT_THROW(NewTicker(Duration(0)), std::invalid_argument);
+}
+
+TEST(TimerTest, AfterFuncRunsOnRuntimeAndCanBeStopped) {
+    auto done = gocxx::base::Chan<int>::Make(2);
+    auto start = Time::Now();
+    AfterFunc(Duration(20 * Duration::Millisecond), [done] { done->send(1); });  // handle dropped
+    auto stopped = AfterFunc(Duration(10 * Duration::Millisecond), [done] { done->send(2); });
+    EXPECT_EQ(stopped->C(), nullptr);
+    EXPECT_TRUE(stopped->Stop());
+
+    auto fired = done->recv();
+    ASSERT_TRUE(fired.has_value());
+    EXPECT_EQ(*fired, 1);
+    EXPECT_GE(Time::Now().Sub(start).Milliseconds(), 15);
+
+    EXPECT_FALSE(stopped->Reset(Duration(Duration::Millisecond)));
+    fired = done->recv();
+    ASSERT_TRUE(fired.has_value());
+    EXPECT_EQ(*fired, 2);
+}
+
+TEST(TimerTest, AfterDeliversOnce) {
+    auto start = Time::Now();
+    auto ch = After(Duration(15 * Duration::Millisecond));
+    ASSERT_TRUE(ch->recv().has_value());
+    EXPECT_GE(Time::Now().Sub(start).Milliseconds(), 10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(ch->tryRecv().Ok());
+}
@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 #include <gocxx/time/time.h>
 #include <gocxx/time/duration.h>
+#include <gocxx/time/rate.h>
+#include <gocxx/context/context.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 TEST(TimeTest, NowIsNotZero) {
     gocxx::time::Time now = gocxx::time::Time::Now();
@@ -100,4 +105,105 @@ TEST(TimeTest, RoundRoundsNearest) {
 
     EXPECT_EQ(rounded.Unix(), 1236);
     EXPECT_EQ(rounded.Nanosecond(), 0);
-}
\ No newline at end of file
+}
+TEST(RateLimiterTest, AllowHonorsBurstAndRefill) {
+    using namespace gocxx::time;
+    rate::Limiter lim(100, 5);  // one token every 10ms
+    for (int i = 0; i < 5; ++i) EXPECT_TRUE(lim.Allow());
+    EXPECT_FALSE(lim.Allow());
+    EXPECT_FALSE(lim.AllowN(6));  // more than the burst, never
+
+    Sleep(Milliseconds(25));
+    EXPECT_TRUE(lim.Allow());
+    EXPECT_TRUE(lim.Allow());
+    EXPECT_FALSE(lim.Allow());
+
+    lim.SetLimit(rate::Inf);
+    for (int i = 0; i < 100; ++i) EXPECT_TRUE(lim.Allow());
+    lim.SetLimit(0);
+    EXPECT_FALSE(lim.Allow());
+}
+
+TEST(RateLimiterTest, ConcurrentAllowNeverExceedsBurst) {
+    gocxx::time::rate::Limiter lim(gocxx::time::rate::Every(gocxx::time::Duration::Hour), 100);
+    std::atomic<int> granted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) {
+                if (lim.Allow()) ++granted;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(granted.load(), 100);
+}
+
+TEST(RateLimiterTest, ReserveAndWait) {
+    using namespace gocxx::time;
+    rate::Limiter lim(50, 1);  // one token every 20ms
+    EXPECT_TRUE(lim.Allow());
+
+    auto r = lim.Reserve();
+    ASSERT_TRUE(r.OK());
+    EXPECT_GT(r.Delay().Milliseconds(), 5);
+    r.Cancel();  // hand the token back
+    EXPECT_FALSE(lim.ReserveN(2).OK());
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(lim.Wait(gocxx::context::Background()).Ok());
+    EXPECT_TRUE(lim.Wait(nullptr).Ok());
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    EXPECT_GE(elapsed.count(), 30);  // two more tokens, 20ms apart
+    EXPECT_TRUE(lim.WaitN(nullptr, 2).Failed());
+}
+
+TEST(RateLimiterTest, WaitRespectsContext) {
+    using namespace gocxx::time;
+    rate::Limiter lim(1, 1);
+    EXPECT_TRUE(lim.Allow());
+
+    auto timeout = gocxx::context::WithTimeout(gocxx::context::Background(), Milliseconds(50));
+    EXPECT_TRUE(lim.Wait(timeout.value.first).Failed());  // needs ~1s, deadline in 50ms
+    timeout.value.second();
+
+    auto cancelable = gocxx::context::WithCancel(gocxx::context::Background());
+    std::thread canceler([cancel = cancelable.value.second] {
+        Sleep(Milliseconds(20));
+        cancel();
+    });
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(lim.Wait(cancelable.value.first).Failed());
+    canceler.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+}
+
+TEST(TimeTest, MonotonicReadingDrivesElapsedTime) {
+    using namespace gocxx::time;
+    Time start = Time::Now();
+    EXPECT_TRUE(start.HasMonotonic());
+    Sleep(Milliseconds(10));
+    EXPECT_GE(Since(start).Milliseconds(), 9);
+    EXPECT_TRUE(start.Before(Time::Now()));
+
+    Time later = start.Add(Milliseconds(500));
+    EXPECT_TRUE(later.HasMonotonic());
+    EXPECT_EQ(later.Sub(start).Milliseconds(), 500);
+    EXPECT_GT(Until(later).Milliseconds(), 400);
+
+    // Wall-clock-only values still compare by wall clock.
+    Time wall = Time::Unix(start.Unix(), start.Nanosecond());
+    EXPECT_FALSE(wall.HasMonotonic());
+    EXPECT_FALSE(start.Round(Duration(1)).HasMonotonic());
+    EXPECT_TRUE(wall.Equal(Time::Unix(start.Unix(), start.Nanosecond())));
+    EXPECT_LT(std::abs(start.Sub(wall).Milliseconds()), 1);
+}
+
+TEST(TimeTest, CoarseNowTracksNow) {
+    using namespace gocxx::time;
+    Time coarse = CoarseNow();
+    Time precise = Time::Now();
+    EXPECT_TRUE(coarse.HasMonotonic());
+    EXPECT_LT(std::abs(precise.Sub(coarse).Milliseconds()), 50);
+    EXPECT_LE(std::abs(precise.Unix() - coarse.Unix()), 1);
+}